@@ -27,11 +27,18 @@
 /* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
 /*************************************************************************/
-
 #include "json.h"
 
 #include "core/string/print_string.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define JSON_SSE2
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define JSON_NEON
+#include <arm_neon.h>
+#endif
+
 const char *JSON::tk_name[TK_MAX] = {
 	"'{'",
 	"'}'",
@@ -45,42 +52,209 @@ const char *JSON::tk_name[TK_MAX] = {
 	"EOF",
 };
 
-String JSON::_make_indent(const String &p_indent, int p_size) {
-	String indent_text = "";
-	if (!p_indent.is_empty()) {
-		for (int i = 0; i < p_size; i++) {
-			indent_text += p_indent;
+static _FORCE_INLINE_ uint8_t _peek(const uint8_t *p_str, int p_index, int p_len) {
+	return p_index < p_len ? p_str[p_index] : 0;
+}
+
+static _FORCE_INLINE_ void _append(LocalVector<uint8_t> &r_buffer, const char *p_str, int p_len) {
+	if (p_len == 0) {
+		return;
+	}
+	uint32_t from = r_buffer.size();
+	r_buffer.resize(from + p_len);
+	memcpy(r_buffer.ptr() + from, p_str, p_len);
+}
+
+static _FORCE_INLINE_ void _append(LocalVector<uint8_t> &r_buffer, const char *p_str) {
+	_append(r_buffer, p_str, strlen(p_str));
+}
+
+static void _append_ascii(LocalVector<uint8_t> &r_buffer, const String &p_ascii) {
+	uint32_t from = r_buffer.size();
+	r_buffer.resize(from + p_ascii.length());
+	uint8_t *dst = r_buffer.ptr() + from;
+	const char32_t *src = p_ascii.ptr();
+	for (int i = 0; i < p_ascii.length(); i++) {
+		dst[i] = src[i];
+	}
+}
+
+static void _append_utf8(LocalVector<uint8_t> &r_buffer, char32_t p_char) {
+	if (p_char <= 0x7f) {
+		r_buffer.push_back(p_char);
+	} else if (p_char <= 0x7ff) {
+		r_buffer.push_back(0xc0 | (p_char >> 6));
+		r_buffer.push_back(0x80 | (p_char & 0x3f));
+	} else if (p_char <= 0xffff) {
+		if (p_char >= 0xd800 && p_char <= 0xdfff) {
+			p_char = 0xfffd; // Surrogates can't be encoded, use the replacement character.
 		}
+		r_buffer.push_back(0xe0 | (p_char >> 12));
+		r_buffer.push_back(0x80 | ((p_char >> 6) & 0x3f));
+		r_buffer.push_back(0x80 | (p_char & 0x3f));
+	} else if (p_char <= 0x10ffff) {
+		r_buffer.push_back(0xf0 | (p_char >> 18));
+		r_buffer.push_back(0x80 | ((p_char >> 12) & 0x3f));
+		r_buffer.push_back(0x80 | ((p_char >> 6) & 0x3f));
+		r_buffer.push_back(0x80 | (p_char & 0x3f));
+	} else {
+		_append_utf8(r_buffer, 0xfffd);
 	}
-	return indent_text;
 }
 
-String JSON::_stringify(const Variant &p_var, const String &p_indent, int p_cur_indent, bool p_sort_keys, Set<const void *> &p_markers, bool p_full_precision) {
-	String colon = ":";
-	String end_statement = "";
+static void _append_int(LocalVector<uint8_t> &r_buffer, int64_t p_num) {
+	char digits[20];
+	int count = 0;
+	uint64_t num = p_num < 0 ? -uint64_t(p_num) : uint64_t(p_num);
+	do {
+		digits[count++] = '0' + (num % 10);
+		num /= 10;
+	} while (num);
+
+	if (p_num < 0) {
+		r_buffer.push_back('-');
+	}
+	while (count) {
+		r_buffer.push_back(digits[--count]);
+	}
+}
 
-	if (!p_indent.is_empty()) {
-		colon += " ";
-		end_statement += "\n";
+static void _append_indent(LocalVector<uint8_t> &r_buffer, const CharString &p_indent, int p_size) {
+	for (int i = 0; i < p_size; i++) {
+		_append(r_buffer, p_indent.get_data(), p_indent.length());
+	}
+}
+
+// Returns the index of the first byte in a string needing attention: a quote, a backslash, a
+// line break or a null byte. Returns p_len if there is none.
+static _FORCE_INLINE_ int _find_string_special(const uint8_t *p_str, int p_index, int p_len) {
+	int i = p_index;
+#if defined(JSON_SSE2)
+	const __m128i quote = _mm_set1_epi8('"');
+	const __m128i backslash = _mm_set1_epi8('\\');
+	const __m128i line_break = _mm_set1_epi8('\n');
+	const __m128i zero = _mm_setzero_si128();
+	for (; i + 16 <= p_len; i += 16) {
+		__m128i bytes = _mm_loadu_si128((const __m128i *)(p_str + i));
+		__m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(bytes, quote), _mm_cmpeq_epi8(bytes, backslash)), _mm_or_si128(_mm_cmpeq_epi8(bytes, line_break), _mm_cmpeq_epi8(bytes, zero)));
+		if (_mm_movemask_epi8(special)) {
+			break;
+		}
+	}
+#elif defined(JSON_NEON)
+	const uint8x16_t quote = vdupq_n_u8('"');
+	const uint8x16_t backslash = vdupq_n_u8('\\');
+	const uint8x16_t line_break = vdupq_n_u8('\n');
+	for (; i + 16 <= p_len; i += 16) {
+		uint8x16_t bytes = vld1q_u8(p_str + i);
+		uint8x16_t special = vorrq_u8(vorrq_u8(vceqq_u8(bytes, quote), vceqq_u8(bytes, backslash)), vorrq_u8(vceqq_u8(bytes, line_break), vceqzq_u8(bytes)));
+		if (vmaxvq_u8(special)) {
+			break;
+		}
+	}
+#endif
+	for (; i < p_len; i++) {
+		uint8_t c = p_str[i];
+		if (c == '"' || c == '\\' || c == '\n' || c == 0) {
+			break;
+		}
+	}
+	return i;
+}
+
+static Error _parse_hex4(const uint8_t *p_str, int p_index, int p_len, char32_t &r_value, String &r_err_str) {
+	r_value = 0;
+	for (int j = 0; j < 4; j++) {
+		uint8_t c = _peek(p_str, p_index + j, p_len);
+		if (c == 0) {
+			r_err_str = "Unterminated String";
+			return ERR_PARSE_ERROR;
+		}
+		char32_t v;
+		if (c >= '0' && c <= '9') {
+			v = c - '0';
+		} else if (c >= 'a' && c <= 'f') {
+			v = c - 'a' + 10;
+		} else if (c >= 'A' && c <= 'F') {
+			v = c - 'A' + 10;
+		} else {
+			r_err_str = "Malformed hex constant in string";
+			return ERR_PARSE_ERROR;
+		}
+		r_value = (r_value << 4) | v;
+	}
+	return OK;
+}
+
+void JSON::_stringify_string(LocalVector<uint8_t> &r_buffer, const String &p_string) {
+	r_buffer.push_back('"');
+	const char32_t *str = p_string.ptr();
+	for (int i = 0; i < p_string.length(); i++) {
+		char32_t c = str[i];
+		switch (c) {
+			case '\\':
+				_append(r_buffer, "\\\\", 2);
+				break;
+			case '\b':
+				_append(r_buffer, "\\b", 2);
+				break;
+			case '\f':
+				_append(r_buffer, "\\f", 2);
+				break;
+			case '\n':
+				_append(r_buffer, "\\n", 2);
+				break;
+			case '\r':
+				_append(r_buffer, "\\r", 2);
+				break;
+			case '\t':
+				_append(r_buffer, "\\t", 2);
+				break;
+			case '\v':
+				_append(r_buffer, "\\v", 2);
+				break;
+			case '"':
+				_append(r_buffer, "\\\"", 2);
+				break;
+			default:
+				if (c <= 0x7f) {
+					r_buffer.push_back(c);
+				} else {
+					_append_utf8(r_buffer, c);
+				}
+		}
 	}
+	r_buffer.push_back('"');
+}
+
+void JSON::_stringify(LocalVector<uint8_t> &r_buffer, const Variant &p_var, const CharString &p_indent, int p_cur_indent, bool p_sort_keys, Set<const void *> &p_markers, bool p_full_precision) {
+	const bool pretty = p_indent.length() > 0;
 
 	switch (p_var.get_type()) {
 		case Variant::NIL:
-			return "null";
+			_append(r_buffer, "null", 4);
+			return;
 		case Variant::BOOL:
-			return p_var.operator bool() ? "true" : "false";
+			if (p_var.operator bool()) {
+				_append(r_buffer, "true", 4);
+			} else {
+				_append(r_buffer, "false", 5);
+			}
+			return;
 		case Variant::INT:
-			return itos(p_var);
+			_append_int(r_buffer, p_var);
+			return;
 		case Variant::FLOAT: {
 			double num = p_var;
 			if (p_full_precision) {
 				// Store unreliable digits (17) instead of just reliable
 				// digits (14) so that the value can be decoded exactly.
-				return String::num(num, 17 - (int)floor(log10(num)));
+				_append_ascii(r_buffer, String::num(num, 17 - (int)floor(log10(num))));
 			} else {
 				// Store only reliable digits (14) by default.
-				return String::num(num, 14 - (int)floor(log10(num)));
+				_append_ascii(r_buffer, String::num(num, 14 - (int)floor(log10(num))));
 			}
+			return;
 		}
 		case Variant::PACKED_INT32_ARRAY:
 		case Variant::PACKED_INT64_ARRAY:
@@ -88,30 +262,44 @@ String JSON::_stringify(const Variant &p_var, const String &p_indent, int p_cur_
 		case Variant::PACKED_FLOAT64_ARRAY:
 		case Variant::PACKED_STRING_ARRAY:
 		case Variant::ARRAY: {
-			String s = "[";
-			s += end_statement;
 			Array a = p_var;
 
-			ERR_FAIL_COND_V_MSG(p_markers.has(a.id()), "\"[...]\"", "Converting circular structure to JSON.");
+			if (p_markers.has(a.id())) {
+				_append(r_buffer, "\"[...]\"");
+				ERR_FAIL_MSG("Converting circular structure to JSON.");
+			}
 			p_markers.insert(a.id());
 
+			r_buffer.push_back('[');
+			if (pretty) {
+				r_buffer.push_back('\n');
+			}
 			for (int i = 0; i < a.size(); i++) {
 				if (i > 0) {
-					s += ",";
-					s += end_statement;
+					r_buffer.push_back(',');
+					if (pretty) {
+						r_buffer.push_back('\n');
+					}
 				}
-				s += _make_indent(p_indent, p_cur_indent + 1) + _stringify(a[i], p_indent, p_cur_indent + 1, p_sort_keys, p_markers);
+				_append_indent(r_buffer, p_indent, p_cur_indent + 1);
+				_stringify(r_buffer, a[i], p_indent, p_cur_indent + 1, p_sort_keys, p_markers, p_full_precision);
 			}
-			s += end_statement + _make_indent(p_indent, p_cur_indent) + "]";
+			if (pretty) {
+				r_buffer.push_back('\n');
+			}
+			_append_indent(r_buffer, p_indent, p_cur_indent);
+			r_buffer.push_back(']');
+
 			p_markers.erase(a.id());
-			return s;
+			return;
 		}
 		case Variant::DICTIONARY: {
-			String s = "{";
-			s += end_statement;
 			Dictionary d = p_var;
 
-			ERR_FAIL_COND_V_MSG(p_markers.has(d.id()), "\"{...}\"", "Converting circular structure to JSON.");
+			if (p_markers.has(d.id())) {
+				_append(r_buffer, "\"{...}\"");
+				ERR_FAIL_MSG("Converting circular structure to JSON.");
+			}
 			p_markers.insert(d.id());
 
 			List<Variant> keys;
@@ -121,27 +309,156 @@ String JSON::_stringify(const Variant &p_var, const String &p_indent, int p_cur_
 				keys.sort();
 			}
 
+			r_buffer.push_back('{');
+			if (pretty) {
+				r_buffer.push_back('\n');
+			}
 			for (List<Variant>::Element *E = keys.front(); E; E = E->next()) {
 				if (E != keys.front()) {
-					s += ",";
-					s += end_statement;
+					r_buffer.push_back(',');
+					if (pretty) {
+						r_buffer.push_back('\n');
+					}
+				}
+				_append_indent(r_buffer, p_indent, p_cur_indent + 1);
+				_stringify_string(r_buffer, E->get());
+				r_buffer.push_back(':');
+				if (pretty) {
+					r_buffer.push_back(' ');
 				}
-				s += _make_indent(p_indent, p_cur_indent + 1) + _stringify(String(E->get()), p_indent, p_cur_indent + 1, p_sort_keys, p_markers);
-				s += colon;
-				s += _stringify(d[E->get()], p_indent, p_cur_indent + 1, p_sort_keys, p_markers);
+				_stringify(r_buffer, d[E->get()], p_indent, p_cur_indent + 1, p_sort_keys, p_markers, p_full_precision);
 			}
+			if (pretty) {
+				r_buffer.push_back('\n');
+			}
+			_append_indent(r_buffer, p_indent, p_cur_indent);
+			r_buffer.push_back('}');
 
-			s += end_statement + _make_indent(p_indent, p_cur_indent) + "}";
 			p_markers.erase(d.id());
-			return s;
+			return;
 		}
 		default:
-			return "\"" + String(p_var).json_escape() + "\"";
+			_stringify_string(r_buffer, p_var);
 	}
 }
 
-Error JSON::_get_token(const char32_t *p_str, int &index, int p_len, Token &r_token, int &line, String &r_err_str) {
-	while (p_len > 0) {
+Error JSON::_get_string_token(const uint8_t *p_str, int &index, int p_len, Token &r_token, int &line, String &r_err_str) {
+	// Most strings have no escapes and fit in one line, decode them straight from the input.
+	const int start = index;
+	index = _find_string_special(p_str, index, p_len);
+	if (index < p_len && p_str[index] == '"') {
+		String str;
+		if (str.parse_utf8((const char *)p_str + start, index - start)) {
+			r_err_str = "Invalid UTF-8 in string";
+			return ERR_PARSE_ERROR;
+		}
+		index++;
+		r_token.type = TK_STRING;
+		r_token.value = str;
+		return OK;
+	}
+
+	LocalVector<uint8_t> bytes;
+	_append(bytes, (const char *)p_str + start, index - start);
+
+	while (true) {
+		uint8_t c = _peek(p_str, index, p_len);
+		if (c == 0) {
+			r_err_str = "Unterminated String";
+			return ERR_PARSE_ERROR;
+		} else if (c == '"') {
+			index++;
+			break;
+		} else if (c == '\\') {
+			//escaped characters...
+			index++;
+			uint8_t next = _peek(p_str, index, p_len);
+			if (next == 0) {
+				r_err_str = "Unterminated String";
+				return ERR_PARSE_ERROR;
+			}
+			char32_t res = 0;
+
+			switch (next) {
+				case 'b':
+					res = 8;
+					break;
+				case 't':
+					res = 9;
+					break;
+				case 'n':
+					res = 10;
+					break;
+				case 'f':
+					res = 12;
+					break;
+				case 'r':
+					res = 13;
+					break;
+				case 'u': {
+					// hex number
+					Error err = _parse_hex4(p_str, index + 1, p_len, res, r_err_str);
+					if (err) {
+						return err;
+					}
+					index += 4; //will add at the end anyway
+
+					if ((res & 0xfffffc00) == 0xd800) {
+						if (_peek(p_str, index + 1, p_len) != '\\' || _peek(p_str, index + 2, p_len) != 'u') {
+							r_err_str = "Invalid UTF-16 sequence in string, unpaired lead surrogate";
+							return ERR_PARSE_ERROR;
+						}
+						index += 2;
+						char32_t trail = 0;
+						err = _parse_hex4(p_str, index + 1, p_len, trail, r_err_str);
+						if (err) {
+							return err;
+						}
+						if ((trail & 0xfffffc00) == 0xdc00) {
+							res = (res << 10UL) + trail - ((0xd800 << 10UL) + 0xdc00 - 0x10000);
+							index += 4; //will add at the end anyway
+						} else {
+							r_err_str = "Invalid UTF-16 sequence in string, unpaired lead surrogate";
+							return ERR_PARSE_ERROR;
+						}
+					} else if ((res & 0xfffffc00) == 0xdc00) {
+						r_err_str = "Invalid UTF-16 sequence in string, unpaired trail surrogate";
+						return ERR_PARSE_ERROR;
+					}
+
+				} break;
+				default: {
+					res = next;
+				} break;
+			}
+
+			if (res != 0) {
+				_append_utf8(bytes, res);
+			}
+			index++;
+		} else if (c == '\n') {
+			line++;
+			bytes.push_back(c);
+			index++;
+		} else {
+			int end = _find_string_special(p_str, index, p_len);
+			_append(bytes, (const char *)p_str + index, end - index);
+			index = end;
+		}
+	}
+
+	String str;
+	if (str.parse_utf8((const char *)bytes.ptr(), bytes.size())) {
+		r_err_str = "Invalid UTF-8 in string";
+		return ERR_PARSE_ERROR;
+	}
+	r_token.type = TK_STRING;
+	r_token.value = str;
+	return OK;
+}
+
+Error JSON::_get_token(const uint8_t *p_str, int &index, int p_len, Token &r_token, int &line, String &r_err_str) {
+	while (index < p_len) {
 		switch (p_str[index]) {
 			case '\n': {
 				line++;
@@ -184,138 +501,7 @@ Error JSON::_get_token(const char32_t *p_str, int &index, int p_len, Token &r_to
 			}
 			case '"': {
 				index++;
-				String str;
-				while (true) {
-					if (p_str[index] == 0) {
-						r_err_str = "Unterminated String";
-						return ERR_PARSE_ERROR;
-					} else if (p_str[index] == '"') {
-						index++;
-						break;
-					} else if (p_str[index] == '\\') {
-						//escaped characters...
-						index++;
-						char32_t next = p_str[index];
-						if (next == 0) {
-							r_err_str = "Unterminated String";
-							return ERR_PARSE_ERROR;
-						}
-						char32_t res = 0;
-
-						switch (next) {
-							case 'b':
-								res = 8;
-								break;
-							case 't':
-								res = 9;
-								break;
-							case 'n':
-								res = 10;
-								break;
-							case 'f':
-								res = 12;
-								break;
-							case 'r':
-								res = 13;
-								break;
-							case 'u': {
-								// hex number
-								for (int j = 0; j < 4; j++) {
-									char32_t c = p_str[index + j + 1];
-									if (c == 0) {
-										r_err_str = "Unterminated String";
-										return ERR_PARSE_ERROR;
-									}
-									if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F'))) {
-										r_err_str = "Malformed hex constant in string";
-										return ERR_PARSE_ERROR;
-									}
-									char32_t v;
-									if (c >= '0' && c <= '9') {
-										v = c - '0';
-									} else if (c >= 'a' && c <= 'f') {
-										v = c - 'a';
-										v += 10;
-									} else if (c >= 'A' && c <= 'F') {
-										v = c - 'A';
-										v += 10;
-									} else {
-										ERR_PRINT("Bug parsing hex constant.");
-										v = 0;
-									}
-
-									res <<= 4;
-									res |= v;
-								}
-								index += 4; //will add at the end anyway
-
-								if ((res & 0xfffffc00) == 0xd800) {
-									if (p_str[index + 1] != '\\' || p_str[index + 2] != 'u') {
-										r_err_str = "Invalid UTF-16 sequence in string, unpaired lead surrogate";
-										return ERR_PARSE_ERROR;
-									}
-									index += 2;
-									char32_t trail = 0;
-									for (int j = 0; j < 4; j++) {
-										char32_t c = p_str[index + j + 1];
-										if (c == 0) {
-											r_err_str = "Unterminated String";
-											return ERR_PARSE_ERROR;
-										}
-										if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F'))) {
-											r_err_str = "Malformed hex constant in string";
-											return ERR_PARSE_ERROR;
-										}
-										char32_t v;
-										if (c >= '0' && c <= '9') {
-											v = c - '0';
-										} else if (c >= 'a' && c <= 'f') {
-											v = c - 'a';
-											v += 10;
-										} else if (c >= 'A' && c <= 'F') {
-											v = c - 'A';
-											v += 10;
-										} else {
-											ERR_PRINT("Bug parsing hex constant.");
-											v = 0;
-										}
-
-										trail <<= 4;
-										trail |= v;
-									}
-									if ((trail & 0xfffffc00) == 0xdc00) {
-										res = (res << 10UL) + trail - ((0xd800 << 10UL) + 0xdc00 - 0x10000);
-										index += 4; //will add at the end anyway
-									} else {
-										r_err_str = "Invalid UTF-16 sequence in string, unpaired lead surrogate";
-										return ERR_PARSE_ERROR;
-									}
-								} else if ((res & 0xfffffc00) == 0xdc00) {
-									r_err_str = "Invalid UTF-16 sequence in string, unpaired trail surrogate";
-									return ERR_PARSE_ERROR;
-								}
-
-							} break;
-							default: {
-								res = next;
-							} break;
-						}
-
-						str += res;
-
-					} else {
-						if (p_str[index] == '\n') {
-							line++;
-						}
-						str += p_str[index];
-					}
-					index++;
-				}
-
-				r_token.type = TK_STRING;
-				r_token.value = str;
-				return OK;
-
+				return _get_string_token(p_str, index, p_len, r_token, line, r_err_str);
 			} break;
 			default: {
 				if (p_str[index] <= 32) {
@@ -325,23 +511,56 @@ Error JSON::_get_token(const char32_t *p_str, int &index, int p_len, Token &r_to
 
 				if (p_str[index] == '-' || (p_str[index] >= '0' && p_str[index] <= '9')) {
 					//a number
-					const char32_t *rptr;
-					double number = String::to_float(&p_str[index], &rptr);
-					index += (rptr - &p_str[index]);
+					const int start = index;
+					bool integer = true;
+					index++;
+					while (index < p_len) {
+						uint8_t c = p_str[index];
+						if (c >= '0' && c <= '9') {
+						} else if (c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-') {
+							integer = false;
+						} else {
+							break;
+						}
+						index++;
+					}
+
+					double number;
+					// Integers with up to 15 digits are exact in a double, skip the general conversion.
+					const int digits = index - start - (p_str[start] == '-' ? 1 : 0);
+					if (integer && digits > 0 && digits <= 15) {
+						int64_t value = 0;
+						for (int i = index - digits; i < index; i++) {
+							value = value * 10 + (p_str[i] - '0');
+						}
+						number = p_str[start] == '-' ? -double(value) : double(value);
+					} else {
+						char buffer[64];
+						const int len = index - start;
+						if (len < (int)sizeof(buffer)) {
+							memcpy(buffer, p_str + start, len);
+							buffer[len] = 0;
+							number = String::to_float(buffer);
+						} else {
+							CharString text;
+							text.resize(len + 1);
+							memcpy(text.ptrw(), p_str + start, len);
+							text.ptrw()[len] = 0;
+							number = String::to_float(text.get_data());
+						}
+					}
 					r_token.type = TK_NUMBER;
 					r_token.value = number;
 					return OK;
 
 				} else if ((p_str[index] >= 'A' && p_str[index] <= 'Z') || (p_str[index] >= 'a' && p_str[index] <= 'z')) {
-					String id;
-
-					while ((p_str[index] >= 'A' && p_str[index] <= 'Z') || (p_str[index] >= 'a' && p_str[index] <= 'z')) {
-						id += p_str[index];
+					const int start = index;
+					while (index < p_len && ((p_str[index] >= 'A' && p_str[index] <= 'Z') || (p_str[index] >= 'a' && p_str[index] <= 'z'))) {
 						index++;
 					}
 
 					r_token.type = TK_IDENTIFIER;
-					r_token.value = id;
+					r_token.value = String((const char *)p_str + start, index - start);
 					return OK;
 				} else {
 					r_err_str = "Unexpected character.";
@@ -351,10 +570,11 @@ Error JSON::_get_token(const char32_t *p_str, int &index, int p_len, Token &r_to
 		}
 	}
 
-	return ERR_PARSE_ERROR;
+	r_token.type = TK_EOF;
+	return OK;
 }
 
-Error JSON::_parse_value(Variant &value, Token &token, const char32_t *p_str, int &index, int p_len, int &line, String &r_err_str) {
+Error JSON::_parse_value(Variant &value, Token &token, const uint8_t *p_str, int &index, int p_len, int &line, String &r_err_str) {
 	if (token.type == TK_CURLY_BRACKET_OPEN) {
 		Dictionary d;
 		Error err = _parse_object(d, p_str, index, p_len, line, r_err_str);
@@ -393,7 +613,7 @@ Error JSON::_parse_value(Variant &value, Token &token, const char32_t *p_str, in
 	return OK;
 }
 
-Error JSON::_parse_array(Array &array, const char32_t *p_str, int &index, int p_len, int &line, String &r_err_str) {
+Error JSON::_parse_array(Array &array, const uint8_t *p_str, int &index, int p_len, int &line, String &r_err_str) {
 	Token token;
 	bool need_comma = false;
 
@@ -431,7 +651,7 @@ Error JSON::_parse_array(Array &array, const char32_t *p_str, int &index, int p_
 	return ERR_PARSE_ERROR;
 }
 
-Error JSON::_parse_object(Dictionary &object, const char32_t *p_str, int &index, int p_len, int &line, String &r_err_str) {
+Error JSON::_parse_object(Dictionary &object, const uint8_t *p_str, int &index, int p_len, int &line, String &r_err_str) {
 	bool at_key = true;
 	String key;
 	Token token;
@@ -494,25 +714,27 @@ Error JSON::_parse_object(Dictionary &object, const char32_t *p_str, int &index,
 	return ERR_PARSE_ERROR;
 }
 
-Error JSON::_parse_string(const String &p_json, Variant &r_ret, String &r_err_str, int &r_err_line) {
-	const char32_t *str = p_json.ptr();
+Error JSON::_parse_bytes(const uint8_t *p_json, int p_len, Variant &r_ret, String &r_err_str, int &r_err_line) {
 	int idx = 0;
-	int len = p_json.length();
 	Token token;
 	r_err_line = 0;
-	String aux_key;
 
-	Error err = _get_token(str, idx, len, token, r_err_line, r_err_str);
+	// Skip the byte order mark, it has no meaning in UTF-8.
+	if (p_len >= 3 && p_json[0] == 0xef && p_json[1] == 0xbb && p_json[2] == 0xbf) {
+		idx = 3;
+	}
+
+	Error err = _get_token(p_json, idx, p_len, token, r_err_line, r_err_str);
 	if (err) {
 		return err;
 	}
 
-	err = _parse_value(r_ret, token, str, idx, len, r_err_line, r_err_str);
+	err = _parse_value(r_ret, token, p_json, idx, p_len, r_err_line, r_err_str);
 
 	// Check if EOF is reached
 	// or it's a type of the next token.
-	if (err == OK && idx < len) {
-		err = _get_token(str, idx, len, token, r_err_line, r_err_str);
+	if (err == OK && idx < p_len) {
+		err = _get_token(p_json, idx, p_len, token, r_err_line, r_err_str);
 
 		if (err || token.type != TK_EOF) {
 			r_err_str = "Expected 'EOF'";
@@ -527,20 +749,157 @@ Error JSON::_parse_string(const String &p_json, Variant &r_ret, String &r_err_st
 
 String JSON::stringify(const Variant &p_var, const String &p_indent, bool p_sort_keys, bool p_full_precision) {
 	Set<const void *> markers;
-	return _stringify(p_var, p_indent, 0, p_sort_keys, markers, p_full_precision);
+	LocalVector<uint8_t> buffer;
+	_stringify(buffer, p_var, p_indent.utf8(), 0, p_sort_keys, markers, p_full_precision);
+
+	String ret;
+	ret.parse_utf8((const char *)buffer.ptr(), buffer.size());
+	return ret;
+}
+
+PackedByteArray JSON::stringify_utf8(const Variant &p_var, const String &p_indent, bool p_sort_keys, bool p_full_precision) {
+	Set<const void *> markers;
+	LocalVector<uint8_t> buffer;
+	_stringify(buffer, p_var, p_indent.utf8(), 0, p_sort_keys, markers, p_full_precision);
+
+	PackedByteArray ret;
+	ret.resize(buffer.size());
+	if (buffer.size()) {
+		memcpy(ret.ptrw(), buffer.ptr(), buffer.size());
+	}
+	return ret;
 }
 
 Error JSON::parse(const String &p_json_string) {
-	Error err = _parse_string(p_json_string, data, err_str, err_line);
+	CharString utf8 = p_json_string.utf8();
+	Error err = _parse_bytes((const uint8_t *)utf8.get_data(), utf8.length(), data, err_str, err_line);
+	if (err == Error::OK) {
+		err_line = 0;
+	}
+	return err;
+}
+
+Error JSON::parse_utf8(const PackedByteArray &p_json) {
+	Error err = _parse_bytes(p_json.ptr(), p_json.size(), data, err_str, err_line);
 	if (err == Error::OK) {
 		err_line = 0;
 	}
 	return err;
 }
 
+Error JSON::feed(const PackedByteArray &p_chunk) {
+	const int from = stream_buffer.size();
+	stream_buffer.resize(from + p_chunk.size());
+	if (p_chunk.size()) {
+		memcpy(stream_buffer.ptr() + from, p_chunk.ptr(), p_chunk.size());
+	}
+
+	// Only look for the end of each top level value here, its contents are parsed once complete.
+	// The scan resumes where the previous chunk left it.
+	const uint8_t *bytes = stream_buffer.ptr();
+	const int len = stream_buffer.size();
+	int value_start = 0;
+	for (int i = stream_scanned; i < len; i++) {
+		const uint8_t c = bytes[i];
+		int value_end = -1;
+
+		if (stream_in_string) {
+			if (stream_in_escape) {
+				stream_in_escape = false;
+			} else if (c == '\\') {
+				stream_in_escape = true;
+			} else if (c == '"') {
+				stream_in_string = false;
+				if (stream_depth == 0) {
+					value_end = i + 1;
+				}
+			}
+		} else if (stream_in_scalar) {
+			if (c <= 32 || c == ',') {
+				stream_in_scalar = false;
+				value_end = i;
+			}
+		} else if (c == '"') {
+			stream_in_string = true;
+		} else if (c == '{' || c == '[') {
+			stream_depth++;
+		} else if (c == '}' || c == ']') {
+			stream_depth--;
+			if (stream_depth < 0) {
+				reset_stream();
+				err_str = "Unexpected '" + String::chr(c) + "'";
+				err_line = 0;
+				return ERR_PARSE_ERROR;
+			}
+			if (stream_depth == 0) {
+				value_end = i + 1;
+			}
+		} else if (stream_depth == 0 && c > 32 && c != ',') {
+			stream_in_scalar = true;
+		}
+
+		if (value_end == -1) {
+			continue;
+		}
+
+		// Values may be separated by whitespace or commas.
+		while (value_start < value_end && (bytes[value_start] <= 32 || bytes[value_start] == ',')) {
+			value_start++;
+		}
+
+		Variant value;
+		Error err = _parse_bytes(bytes + value_start, value_end - value_start, value, err_str, err_line);
+		if (err != OK) {
+			reset_stream();
+			return err;
+		}
+		stream_values.push_back(value);
+		value_start = value_end;
+	}
+
+	// Keep the incomplete value for the next chunk.
+	if (value_start > 0) {
+		memmove(stream_buffer.ptr(), stream_buffer.ptr() + value_start, len - value_start);
+		stream_buffer.resize(len - value_start);
+	}
+	stream_scanned = stream_buffer.size();
+
+	err_str = "";
+	err_line = 0;
+	return OK;
+}
+
+bool JSON::has_value() const {
+	return !stream_values.is_empty();
+}
+
+Variant JSON::take_value() {
+	ERR_FAIL_COND_V_MSG(stream_values.is_empty(), Variant(), "No complete value has been fed.");
+	Variant value = stream_values.front()->get();
+	stream_values.pop_front();
+	return value;
+}
+
+void JSON::reset_stream() {
+	stream_buffer.reset();
+	stream_scanned = 0;
+	stream_depth = 0;
+	stream_in_string = false;
+	stream_in_escape = false;
+	stream_in_scalar = false;
+	stream_values.clear();
+}
+
 void JSON::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("stringify", "data", "indent", "sort_keys", "full_precision"), &JSON::stringify, DEFVAL(""), DEFVAL(true), DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("stringify_utf8", "data", "indent", "sort_keys", "full_precision"), &JSON::stringify_utf8, DEFVAL(""), DEFVAL(true), DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("parse", "json_string"), &JSON::parse);
+	ClassDB::bind_method(D_METHOD("parse_utf8", "json"), &JSON::parse_utf8);
+
+	ClassDB::bind_method(D_METHOD("feed", "chunk"), &JSON::feed);
+	ClassDB::bind_method(D_METHOD("has_value"), &JSON::has_value);
+	ClassDB::bind_method(D_METHOD("take_value"), &JSON::take_value);
+	ClassDB::bind_method(D_METHOD("reset_stream"), &JSON::reset_stream);
 
 	ClassDB::bind_method(D_METHOD("get_data"), &JSON::get_data);
 	ClassDB::bind_method(D_METHOD("get_error_line"), &JSON::get_error_line);
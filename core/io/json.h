@@ -32,6 +32,8 @@
 #define JSON_H
 
 #include "core/object/ref_counted.h"
+#include "core/templates/list.h"
+#include "core/templates/local_vector.h"
 #include "core/variant/variant.h"
 
 class JSON : public RefCounted {
@@ -67,22 +69,40 @@ class JSON : public RefCounted {
 	String err_str;
 	int err_line = 0;
 
+	// Input of feed() that doesn't form a complete value yet, and the values that did.
+	LocalVector<uint8_t> stream_buffer;
+	int stream_scanned = 0;
+	int stream_depth = 0;
+	bool stream_in_string = false;
+	bool stream_in_escape = false;
+	bool stream_in_scalar = false;
+	List<Variant> stream_values;
+
 	static const char *tk_name[];
 
-	static String _make_indent(const String &p_indent, int p_size);
-	static String _stringify(const Variant &p_var, const String &p_indent, int p_cur_indent, bool p_sort_keys, Set<const void *> &p_markers, bool p_full_precision = false);
-	static Error _get_token(const char32_t *p_str, int &index, int p_len, Token &r_token, int &line, String &r_err_str);
-	static Error _parse_value(Variant &value, Token &token, const char32_t *p_str, int &index, int p_len, int &line, String &r_err_str);
-	static Error _parse_array(Array &array, const char32_t *p_str, int &index, int p_len, int &line, String &r_err_str);
-	static Error _parse_object(Dictionary &object, const char32_t *p_str, int &index, int p_len, int &line, String &r_err_str);
-	static Error _parse_string(const String &p_json, Variant &r_ret, String &r_err_str, int &r_err_line);
+	// Both parsing and stringifying work on UTF-8 bytes, strings are only converted once complete.
+	static void _stringify(LocalVector<uint8_t> &r_buffer, const Variant &p_var, const CharString &p_indent, int p_cur_indent, bool p_sort_keys, Set<const void *> &p_markers, bool p_full_precision);
+	static void _stringify_string(LocalVector<uint8_t> &r_buffer, const String &p_string);
+	static Error _get_token(const uint8_t *p_str, int &index, int p_len, Token &r_token, int &line, String &r_err_str);
+	static Error _get_string_token(const uint8_t *p_str, int &index, int p_len, Token &r_token, int &line, String &r_err_str);
+	static Error _parse_value(Variant &value, Token &token, const uint8_t *p_str, int &index, int p_len, int &line, String &r_err_str);
+	static Error _parse_array(Array &array, const uint8_t *p_str, int &index, int p_len, int &line, String &r_err_str);
+	static Error _parse_object(Dictionary &object, const uint8_t *p_str, int &index, int p_len, int &line, String &r_err_str);
+	static Error _parse_bytes(const uint8_t *p_json, int p_len, Variant &r_ret, String &r_err_str, int &r_err_line);
 
 protected:
 	static void _bind_methods();
 
 public:
 	String stringify(const Variant &p_var, const String &p_indent = "", bool p_sort_keys = true, bool p_full_precision = false);
+	PackedByteArray stringify_utf8(const Variant &p_var, const String &p_indent = "", bool p_sort_keys = true, bool p_full_precision = false);
 	Error parse(const String &p_json_string);
+	Error parse_utf8(const PackedByteArray &p_json);
+
+	Error feed(const PackedByteArray &p_chunk);
+	bool has_value() const;
+	Variant take_value();
+	void reset_stream();
 
 	inline Variant get_data() const { return data; }
 	inline int get_error_line() const { return err_line; }
@@ -34,6 +34,11 @@
 #include "core/object/script_language.h"
 #include "scene/scene_string_names.h"
 
+static bool _has_script_costs(const Object *p_object) {
+	ScriptInstance *script_instance = p_object->get_script_instance();
+	return script_instance && (script_instance->has_method(SceneStringNames::get_singleton()->_estimate_cost) || script_instance->has_method(SceneStringNames::get_singleton()->_compute_cost));
+}
+
 int AStar::get_available_point_id() const {
 	if (points.is_empty()) {
 		return 1;
@@ -73,6 +78,7 @@ void AStar::add_point(int p_id, const Vector3 &p_pos, real_t p_weight_scale) {
 		found_pt->pos = p_pos;
 		found_pt->weight_scale = p_weight_scale;
 	}
+	graph_dirty = true;
 }
 
 Vector3 AStar::get_point_position(int p_id) const {
@@ -89,6 +95,7 @@ void AStar::set_point_position(int p_id, const Vector3 &p_pos) {
 	ERR_FAIL_COND(!p_exists);
 
 	p->pos = p_pos;
+	graph_dirty = true;
 }
 
 real_t AStar::get_point_weight_scale(int p_id) const {
@@ -106,6 +113,14 @@ void AStar::set_point_weight_scale(int p_id, real_t p_weight_scale) {
 	ERR_FAIL_COND(p_weight_scale < 1);
 
 	p->weight_scale = p_weight_scale;
+
+	graph_lock.write_lock();
+	if (!graph_dirty) {
+		uint32_t index = 0;
+		graph.indices.lookup(p_id, index);
+		graph.weight_scales[index] = p_weight_scale;
+	}
+	graph_lock.write_unlock();
 }
 
 void AStar::remove_point(int p_id) {
@@ -132,6 +147,7 @@ void AStar::remove_point(int p_id) {
 	memdelete(p);
 	points.remove(p_id);
 	last_free_id = p_id;
+	graph_dirty = true;
 }
 
 void AStar::connect_points(int p_id, int p_with_id, bool bidirectional) {
@@ -170,6 +186,7 @@ void AStar::connect_points(int p_id, int p_with_id, bool bidirectional) {
 	}
 
 	segments.insert(s);
+	graph_dirty = true;
 }
 
 void AStar::disconnect_points(int p_id, int p_with_id, bool bidirectional) {
@@ -209,6 +226,7 @@ void AStar::disconnect_points(int p_id, int p_with_id, bool bidirectional) {
 		if (s.direction != Segment::NONE) {
 			segments.insert(s);
 		}
+		graph_dirty = true;
 	}
 }
 
@@ -255,6 +273,7 @@ void AStar::clear() {
 	}
 	segments.clear();
 	points.clear();
+	graph_dirty = true;
 }
 
 int AStar::get_point_count() const {
@@ -387,6 +406,181 @@ bool AStar::_solve(Point *begin_point, Point *end_point) {
 	return found_route;
 }
 
+void AStar::_update_graph() {
+	const uint32_t point_count = points.get_num_elements();
+	graph.ids.resize(point_count);
+	graph.positions.resize(point_count);
+	graph.weight_scales.resize(point_count);
+	graph.enabled.resize(point_count);
+	graph.edge_offsets.resize(point_count + 1);
+	graph.edge_targets.clear();
+	graph.edge_costs.clear();
+	graph.indices.clear();
+
+	uint32_t index = 0;
+	for (OAHashMap<int, Point *>::Iterator it = points.iter(); it.valid; it = points.next_iter(it)) {
+		graph.ids[index] = *(it.key);
+		graph.positions[index] = (*it.value)->pos;
+		graph.weight_scales[index] = (*it.value)->weight_scale;
+		graph.enabled[index] = (*it.value)->enabled;
+		graph.indices.set(*(it.key), index);
+		index++;
+	}
+
+	for (index = 0; index < point_count; index++) {
+		Point *p = nullptr;
+		points.lookup(graph.ids[index], p);
+		graph.edge_offsets[index] = graph.edge_targets.size();
+
+		for (OAHashMap<int, Point *>::Iterator it = p->neighbours.iter(); it.valid; it = p->neighbours.next_iter(it)) {
+			Point *e = *(it.value);
+			uint32_t target = 0;
+			graph.indices.lookup(e->id, target);
+			graph.edge_targets.push_back(target);
+			graph.edge_costs.push_back(_compute_cost(p->id, e->id));
+		}
+	}
+	graph.edge_offsets[point_count] = graph.edge_targets.size();
+}
+
+bool AStar::_solve_graph(SolveState &r_state, uint32_t p_begin_index, uint32_t p_end_index) const {
+	const uint32_t point_count = graph.ids.size();
+	if (r_state.g_score.size() != point_count) {
+		r_state.g_score.resize(point_count);
+		r_state.prev_index.resize(point_count);
+		r_state.open_pass.resize(point_count);
+		r_state.closed_pass.resize(point_count);
+		for (uint32_t i = 0; i < point_count; i++) {
+			r_state.open_pass[i] = 0;
+			r_state.closed_pass[i] = 0;
+		}
+		r_state.pass = 0;
+	}
+
+	if (!graph.enabled[p_end_index]) {
+		return false;
+	}
+
+	r_state.pass++;
+	const uint32_t state_pass = r_state.pass;
+	const Vector3 end_position = graph.positions[p_end_index];
+	LocalVector<OpenEntry> &open_list = r_state.open_list;
+	open_list.clear();
+	SortArray<OpenEntry, SortOpenEntries> sorter;
+
+	r_state.g_score[p_begin_index] = 0;
+	r_state.open_pass[p_begin_index] = state_pass;
+
+	OpenEntry begin_entry;
+	begin_entry.f_score = graph.positions[p_begin_index].distance_to(end_position);
+	begin_entry.index = p_begin_index;
+	open_list.push_back(begin_entry);
+
+	while (!open_list.is_empty()) {
+		sorter.pop_heap(0, open_list.size(), open_list.ptr()); // Remove the current point from the open list.
+		const OpenEntry entry = open_list[open_list.size() - 1];
+		open_list.resize(open_list.size() - 1);
+
+		// Entries are not updated in place, so skip the ones superseded by a cheaper route.
+		if (r_state.closed_pass[entry.index] == state_pass || entry.g_score > r_state.g_score[entry.index]) {
+			continue;
+		}
+		if (entry.index == p_end_index) {
+			return true;
+		}
+		r_state.closed_pass[entry.index] = state_pass;
+
+		for (uint32_t i = graph.edge_offsets[entry.index]; i < graph.edge_offsets[entry.index + 1]; i++) {
+			const uint32_t e = graph.edge_targets[i]; // The neighbour point.
+			if (!graph.enabled[e] || r_state.closed_pass[e] == state_pass) {
+				continue;
+			}
+
+			const real_t tentative_g_score = entry.g_score + graph.edge_costs[i] * graph.weight_scales[e];
+			if (r_state.open_pass[e] == state_pass && tentative_g_score >= r_state.g_score[e]) {
+				continue; // The new path is worse than the previous.
+			}
+
+			r_state.open_pass[e] = state_pass;
+			r_state.g_score[e] = tentative_g_score;
+			r_state.prev_index[e] = entry.index;
+
+			OpenEntry next_entry;
+			next_entry.f_score = tentative_g_score + graph.positions[e].distance_to(end_position);
+			next_entry.g_score = tentative_g_score;
+			next_entry.index = e;
+			open_list.push_back(next_entry);
+			sorter.push_heap(0, open_list.size() - 1, 0, next_entry, open_list.ptr());
+		}
+	}
+
+	return false;
+}
+
+bool AStar::_get_graph_path(int p_from_id, int p_to_id, LocalVector<int> *r_ids, LocalVector<Vector3> *r_positions) {
+	// The read lock is held until the path is copied out, so a rebuild
+	// can't happen while this query reads the graph.
+	graph_lock.read_lock();
+	while (graph_dirty) {
+		graph_lock.read_unlock();
+		graph_lock.write_lock();
+		if (graph_dirty) {
+			_update_graph();
+			graph_dirty = false;
+		}
+		graph_lock.write_unlock();
+		graph_lock.read_lock();
+	}
+
+	uint32_t begin_index = 0;
+	uint32_t end_index = 0;
+	graph.indices.lookup(p_from_id, begin_index);
+	graph.indices.lookup(p_to_id, end_index);
+
+	// Every query needs its own scratch memory, reuse it across queries.
+	SolveState *state = nullptr;
+	solve_states_mutex.lock();
+	if (solve_states.size()) {
+		state = solve_states[solve_states.size() - 1];
+		solve_states.resize(solve_states.size() - 1);
+	}
+	solve_states_mutex.unlock();
+	if (!state) {
+		state = memnew(SolveState);
+	}
+
+	bool found_route = _solve_graph(*state, begin_index, end_index);
+	if (found_route) {
+		uint32_t count = 1;
+		for (uint32_t index = end_index; index != begin_index; index = state->prev_index[index]) {
+			count++;
+		}
+		if (r_ids) {
+			r_ids->resize(count);
+		}
+		if (r_positions) {
+			r_positions->resize(count);
+		}
+		uint32_t index = end_index;
+		for (uint32_t i = count; i > 0; i--) {
+			if (r_ids) {
+				(*r_ids)[i - 1] = graph.ids[index];
+			}
+			if (r_positions) {
+				(*r_positions)[i - 1] = graph.positions[index];
+			}
+			index = state->prev_index[index];
+		}
+	}
+	graph_lock.read_unlock();
+
+	solve_states_mutex.lock();
+	solve_states.push_back(state);
+	solve_states_mutex.unlock();
+
+	return found_route;
+}
+
 real_t AStar::_estimate_cost(int p_from_id, int p_to_id) {
 	if (get_script_instance() && get_script_instance()->has_method(SceneStringNames::get_singleton()->_estimate_cost)) {
 		return get_script_instance()->call(SceneStringNames::get_singleton()->_estimate_cost, p_from_id, p_to_id);
@@ -434,6 +628,21 @@ Vector<Vector3> AStar::get_point_path(int p_from_id, int p_to_id) {
 		return ret;
 	}
 
+	if (!_has_script_costs(this)) {
+		LocalVector<Vector3> positions;
+		if (!_get_graph_path(p_from_id, p_to_id, nullptr, &positions)) {
+			return Vector<Vector3>();
+		}
+
+		Vector<Vector3> path;
+		path.resize(positions.size());
+		Vector3 *w = path.ptrw();
+		for (uint32_t i = 0; i < positions.size(); i++) {
+			w[i] = positions[i];
+		}
+		return path;
+	}
+
 	Point *begin_point = a;
 	Point *end_point = b;
 
@@ -483,6 +692,21 @@ Vector<int> AStar::get_id_path(int p_from_id, int p_to_id) {
 		return ret;
 	}
 
+	if (!_has_script_costs(this)) {
+		LocalVector<int> ids;
+		if (!_get_graph_path(p_from_id, p_to_id, &ids, nullptr)) {
+			return Vector<int>();
+		}
+
+		Vector<int> path;
+		path.resize(ids.size());
+		int *w = path.ptrw();
+		for (uint32_t i = 0; i < ids.size(); i++) {
+			w[i] = ids[i];
+		}
+		return path;
+	}
+
 	Point *begin_point = a;
 	Point *end_point = b;
 
@@ -523,6 +747,14 @@ void AStar::set_point_disabled(int p_id, bool p_disabled) {
 	ERR_FAIL_COND(!p_exists);
 
 	p->enabled = !p_disabled;
+
+	graph_lock.write_lock();
+	if (!graph_dirty) {
+		uint32_t index = 0;
+		graph.indices.lookup(p_id, index);
+		graph.enabled[index] = !p_disabled;
+	}
+	graph_lock.write_unlock();
 }
 
 bool AStar::is_point_disabled(int p_id) const {
@@ -569,6 +801,9 @@ void AStar::_bind_methods() {
 
 AStar::~AStar() {
 	clear();
+	for (uint32_t i = 0; i < solve_states.size(); i++) {
+		memdelete(solve_states[i]);
+	}
 }
 
 /////////////////////////////////////////////////////////////
@@ -706,6 +941,21 @@ Vector<Vector2> AStar2D::get_point_path(int p_from_id, int p_to_id) {
 		return ret;
 	}
 
+	if (!_has_script_costs(this)) {
+		LocalVector<Vector3> positions;
+		if (!astar._get_graph_path(p_from_id, p_to_id, nullptr, &positions)) {
+			return Vector<Vector2>();
+		}
+
+		Vector<Vector2> path;
+		path.resize(positions.size());
+		Vector2 *w = path.ptrw();
+		for (uint32_t i = 0; i < positions.size(); i++) {
+			w[i] = Vector2(positions[i].x, positions[i].y);
+		}
+		return path;
+	}
+
 	AStar::Point *begin_point = a;
 	AStar::Point *end_point = b;
 
@@ -755,6 +1005,21 @@ Vector<int> AStar2D::get_id_path(int p_from_id, int p_to_id) {
 		return ret;
 	}
 
+	if (!_has_script_costs(this)) {
+		LocalVector<int> ids;
+		if (!astar._get_graph_path(p_from_id, p_to_id, &ids, nullptr)) {
+			return Vector<int>();
+		}
+
+		Vector<int> path;
+		path.resize(ids.size());
+		int *w = path.ptrw();
+		for (uint32_t i = 0; i < ids.size(); i++) {
+			w[i] = ids[i];
+		}
+		return path;
+	}
+
 	AStar::Point *begin_point = a;
 	AStar::Point *end_point = b;
 
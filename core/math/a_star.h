@@ -32,6 +32,9 @@
 #define A_STAR_H
 
 #include "core/object/ref_counted.h"
+#include "core/os/mutex.h"
+#include "core/os/rw_lock.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/oa_hash_map.h"
 
 /**
@@ -108,14 +111,68 @@ class AStar : public RefCounted {
 		}
 	};
 
+	// Compact copy of the points and connections, in compressed sparse row layout.
+	// Used when the costs aren't overridden by a script, so queries read
+	// contiguous memory and don't write to the graph. Point weights and the
+	// disabled state are applied at query time, so changing them doesn't
+	// need a rebuild.
+	struct Graph {
+		LocalVector<int> ids;
+		LocalVector<Vector3> positions;
+		LocalVector<real_t> weight_scales;
+		LocalVector<uint8_t> enabled;
+		LocalVector<uint32_t> edge_offsets; // Edges of the point i are in [edge_offsets[i], edge_offsets[i + 1]).
+		LocalVector<uint32_t> edge_targets;
+		LocalVector<real_t> edge_costs; // Not scaled by the weight of the target point.
+		OAHashMap<int, uint32_t> indices;
+	};
+
+	struct OpenEntry {
+		real_t f_score = 0;
+		real_t g_score = 0;
+		uint32_t index = 0;
+	};
+
+	struct SortOpenEntries {
+		_FORCE_INLINE_ bool operator()(const OpenEntry &A, const OpenEntry &B) const { // Returns true when the entry A is worse than entry B.
+			if (A.f_score > B.f_score) {
+				return true;
+			} else if (A.f_score < B.f_score) {
+				return false;
+			} else {
+				return A.g_score < B.g_score; // If the f_costs are the same then prioritize the points that are further away from the start.
+			}
+		}
+	};
+
+	// Scratch memory of a query on the graph, each thread takes its own.
+	struct SolveState {
+		LocalVector<real_t> g_score;
+		LocalVector<uint32_t> prev_index;
+		LocalVector<uint32_t> open_pass;
+		LocalVector<uint32_t> closed_pass;
+		uint32_t pass = 0;
+		LocalVector<OpenEntry> open_list;
+	};
+
 	int last_free_id = 0;
 	uint64_t pass = 1;
 
 	OAHashMap<int, Point *> points;
 	Set<Segment> segments;
 
+	Graph graph;
+	bool graph_dirty = true; // Set when points or connections are added, removed or moved.
+	RWLock graph_lock; // Queries read the graph, rebuilding it takes the write lock.
+	Mutex solve_states_mutex;
+	LocalVector<SolveState *> solve_states;
+
 	bool _solve(Point *begin_point, Point *end_point);
 
+	void _update_graph();
+	bool _solve_graph(SolveState &r_state, uint32_t p_begin_index, uint32_t p_end_index) const;
+	bool _get_graph_path(int p_from_id, int p_to_id, LocalVector<int> *r_ids, LocalVector<Vector3> *r_positions);
+
 protected:
 	static void _bind_methods();
 
@@ -0,0 +1,1100 @@
+/*************************************************************************/
+/*  a_star_grid_2d.cpp                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "a_star_grid_2d.h"
+
+#include "core/os/os.h"
+#include "core/templates/sort_array.h"
+
+Mutex AStarGrid2D::batch_mutex;
+ThreadWorkPool *AStarGrid2D::batch_work_pool = nullptr;
+
+static _FORCE_INLINE_ int _sign(int p_value) {
+	return (p_value > 0) - (p_value < 0);
+}
+
+void AStarGrid2D::set_size(const Vector2i &p_size) {
+	ERR_FAIL_COND(p_size.x < 0 || p_size.y < 0);
+	if (p_size == size) {
+		return;
+	}
+
+	size = p_size;
+	const uint32_t cell_count = size.x * size.y;
+	solid.resize(cell_count);
+	weight_scale.resize(cell_count);
+	for (uint32_t i = 0; i < cell_count; i++) {
+		solid[i] = 0;
+		weight_scale[i] = 1.0;
+	}
+	weighted_count = 0;
+	abstract_graph_dirty = true;
+
+	// Invalidate the scratch memory, it is sized again on the next query.
+	state.g_score.clear();
+	MutexLock lock(batch_states_mutex);
+	for (uint32_t i = 0; i < batch_states.size(); i++) {
+		batch_states[i]->g_score.clear();
+	}
+}
+
+Vector2i AStarGrid2D::get_size() const {
+	return size;
+}
+
+void AStarGrid2D::set_offset(const Vector2 &p_offset) {
+	offset = p_offset;
+}
+
+Vector2 AStarGrid2D::get_offset() const {
+	return offset;
+}
+
+void AStarGrid2D::set_cell_size(const Vector2 &p_cell_size) {
+	ERR_FAIL_COND(p_cell_size.x <= 0 || p_cell_size.y <= 0);
+	cell_size = p_cell_size;
+	abstract_graph_dirty = true;
+}
+
+Vector2 AStarGrid2D::get_cell_size() const {
+	return cell_size;
+}
+
+void AStarGrid2D::set_diagonal_mode(DiagonalMode p_diagonal_mode) {
+	ERR_FAIL_INDEX((int)p_diagonal_mode, (int)DIAGONAL_MODE_MAX);
+	diagonal_mode = p_diagonal_mode;
+	abstract_graph_dirty = true;
+}
+
+AStarGrid2D::DiagonalMode AStarGrid2D::get_diagonal_mode() const {
+	return diagonal_mode;
+}
+
+void AStarGrid2D::set_jumping_enabled(bool p_enabled) {
+	jumping_enabled = p_enabled;
+}
+
+bool AStarGrid2D::is_jumping_enabled() const {
+	return jumping_enabled;
+}
+
+void AStarGrid2D::set_cluster_size(int p_cluster_size) {
+	ERR_FAIL_COND(p_cluster_size < 0);
+	cluster_size = p_cluster_size;
+	abstract_graph_dirty = true;
+}
+
+int AStarGrid2D::get_cluster_size() const {
+	return cluster_size;
+}
+
+bool AStarGrid2D::is_in_bounds(const Vector2i &p_id) const {
+	return p_id.x >= 0 && p_id.y >= 0 && p_id.x < size.x && p_id.y < size.y;
+}
+
+void AStarGrid2D::set_point_solid(const Vector2i &p_id, bool p_solid) {
+	ERR_FAIL_COND_MSG(!is_in_bounds(p_id), vformat("Can't set if point is solid. Point out of bounds (%s/%s, %s/%s).", p_id.x, size.x, p_id.y, size.y));
+	solid[p_id.y * size.x + p_id.x] = p_solid;
+	abstract_graph_dirty = true;
+}
+
+bool AStarGrid2D::is_point_solid(const Vector2i &p_id) const {
+	ERR_FAIL_COND_V_MSG(!is_in_bounds(p_id), false, vformat("Can't get if point is solid. Point out of bounds (%s/%s, %s/%s).", p_id.x, size.x, p_id.y, size.y));
+	return solid[p_id.y * size.x + p_id.x];
+}
+
+void AStarGrid2D::set_point_weight_scale(const Vector2i &p_id, real_t p_weight_scale) {
+	ERR_FAIL_COND_MSG(!is_in_bounds(p_id), vformat("Can't set point's weight scale. Point out of bounds (%s/%s, %s/%s).", p_id.x, size.x, p_id.y, size.y));
+	ERR_FAIL_COND(p_weight_scale < 1);
+
+	real_t &scale = weight_scale[p_id.y * size.x + p_id.x];
+	weighted_count += (p_weight_scale != 1.0) - (scale != 1.0);
+	scale = p_weight_scale;
+	abstract_graph_dirty = true;
+}
+
+real_t AStarGrid2D::get_point_weight_scale(const Vector2i &p_id) const {
+	ERR_FAIL_COND_V_MSG(!is_in_bounds(p_id), 0, vformat("Can't get point's weight scale. Point out of bounds (%s/%s, %s/%s).", p_id.x, size.x, p_id.y, size.y));
+	return weight_scale[p_id.y * size.x + p_id.x];
+}
+
+void AStarGrid2D::fill_solid_region(const Rect2i &p_region, bool p_solid) {
+	const Rect2i region = p_region.intersection(Rect2i(Vector2i(), size));
+	for (int y = region.position.y; y < region.position.y + region.size.y; y++) {
+		uint8_t *row = solid.ptr() + y * size.x;
+		for (int x = region.position.x; x < region.position.x + region.size.x; x++) {
+			row[x] = p_solid;
+		}
+	}
+	abstract_graph_dirty = true;
+}
+
+void AStarGrid2D::fill_weight_scale_region(const Rect2i &p_region, real_t p_weight_scale) {
+	ERR_FAIL_COND(p_weight_scale < 1);
+
+	const Rect2i region = p_region.intersection(Rect2i(Vector2i(), size));
+	for (int y = region.position.y; y < region.position.y + region.size.y; y++) {
+		real_t *row = weight_scale.ptr() + y * size.x;
+		for (int x = region.position.x; x < region.position.x + region.size.x; x++) {
+			weighted_count += (p_weight_scale != 1.0) - (row[x] != 1.0);
+			row[x] = p_weight_scale;
+		}
+	}
+	abstract_graph_dirty = true;
+}
+
+Vector2 AStarGrid2D::get_point_position(const Vector2i &p_id) const {
+	ERR_FAIL_COND_V_MSG(!is_in_bounds(p_id), Vector2(), vformat("Can't get point's position. Point out of bounds (%s/%s, %s/%s).", p_id.x, size.x, p_id.y, size.y));
+	return offset + Vector2(p_id) * cell_size;
+}
+
+void AStarGrid2D::clear() {
+	set_size(Vector2i());
+}
+
+bool AStarGrid2D::_is_diagonal_allowed(int p_x, int p_y, int p_dx, int p_dy) const {
+	switch (diagonal_mode) {
+		case DIAGONAL_MODE_ALWAYS:
+			return true;
+		case DIAGONAL_MODE_AT_LEAST_ONE_WALKABLE:
+			return _is_walkable(p_x + p_dx, p_y) || _is_walkable(p_x, p_y + p_dy);
+		case DIAGONAL_MODE_ONLY_IF_NO_OBSTACLES:
+			return _is_walkable(p_x + p_dx, p_y) && _is_walkable(p_x, p_y + p_dy);
+		default:
+			return false;
+	}
+}
+
+real_t AStarGrid2D::_get_step_cost(int p_dx, int p_dy) const {
+	if (p_dx && p_dy) {
+		return cell_size.length();
+	}
+	return p_dx ? cell_size.x : cell_size.y;
+}
+
+real_t AStarGrid2D::_estimate_cost(int p_from_x, int p_from_y, int p_to_x, int p_to_y) const {
+	const int dx = ABS(p_to_x - p_from_x);
+	const int dy = ABS(p_to_y - p_from_y);
+	if (diagonal_mode == DIAGONAL_MODE_NEVER) {
+		return dx * cell_size.x + dy * cell_size.y;
+	}
+
+	// Octile distance: move diagonally as long as possible, then straight.
+	const int diagonal = MIN(dx, dy);
+	return diagonal * cell_size.length() + (dx - diagonal) * cell_size.x + (dy - diagonal) * cell_size.y;
+}
+
+int AStarGrid2D::_get_directions(int p_x, int p_y, int p_prev_index, bool p_jumping, int r_directions[8][2]) const {
+	int count = 0;
+#define PUSH_DIRECTION(m_dx, m_dy)        \
+	{                                     \
+		r_directions[count][0] = (m_dx); \
+		r_directions[count][1] = (m_dy); \
+		count++;                          \
+	}
+
+	if (!p_jumping || p_prev_index < 0) {
+		for (int dy = -1; dy <= 1; dy++) {
+			for (int dx = -1; dx <= 1; dx++) {
+				if ((!dx && !dy) || !_is_walkable(p_x + dx, p_y + dy)) {
+					continue;
+				}
+				if (dx && dy && !_is_diagonal_allowed(p_x, p_y, dx, dy)) {
+					continue;
+				}
+				PUSH_DIRECTION(dx, dy);
+			}
+		}
+		return count;
+	}
+
+	// Jump Point Search: only keep the natural and forced neighbors of the direction we came from.
+	const int dx = _sign(p_x - int(p_prev_index % size.x));
+	const int dy = _sign(p_y - int(p_prev_index / size.x));
+
+	switch (diagonal_mode) {
+		case DIAGONAL_MODE_ALWAYS: {
+			if (dx && dy) {
+				if (_is_walkable(p_x, p_y + dy)) {
+					PUSH_DIRECTION(0, dy);
+				}
+				if (_is_walkable(p_x + dx, p_y)) {
+					PUSH_DIRECTION(dx, 0);
+				}
+				if (_is_walkable(p_x + dx, p_y + dy)) {
+					PUSH_DIRECTION(dx, dy);
+				}
+				if (!_is_walkable(p_x - dx, p_y)) {
+					PUSH_DIRECTION(-dx, dy);
+				}
+				if (!_is_walkable(p_x, p_y - dy)) {
+					PUSH_DIRECTION(dx, -dy);
+				}
+			} else if (dx) {
+				if (_is_walkable(p_x + dx, p_y)) {
+					PUSH_DIRECTION(dx, 0);
+				}
+				if (!_is_walkable(p_x, p_y + 1)) {
+					PUSH_DIRECTION(dx, 1);
+				}
+				if (!_is_walkable(p_x, p_y - 1)) {
+					PUSH_DIRECTION(dx, -1);
+				}
+			} else {
+				if (_is_walkable(p_x, p_y + dy)) {
+					PUSH_DIRECTION(0, dy);
+				}
+				if (!_is_walkable(p_x + 1, p_y)) {
+					PUSH_DIRECTION(1, dy);
+				}
+				if (!_is_walkable(p_x - 1, p_y)) {
+					PUSH_DIRECTION(-1, dy);
+				}
+			}
+		} break;
+		case DIAGONAL_MODE_AT_LEAST_ONE_WALKABLE: {
+			if (dx && dy) {
+				const bool next_y = _is_walkable(p_x, p_y + dy);
+				const bool next_x = _is_walkable(p_x + dx, p_y);
+				if (next_y) {
+					PUSH_DIRECTION(0, dy);
+				}
+				if (next_x) {
+					PUSH_DIRECTION(dx, 0);
+				}
+				if (next_y || next_x) {
+					PUSH_DIRECTION(dx, dy);
+				}
+				if (next_y && !_is_walkable(p_x - dx, p_y)) {
+					PUSH_DIRECTION(-dx, dy);
+				}
+				if (next_x && !_is_walkable(p_x, p_y - dy)) {
+					PUSH_DIRECTION(dx, -dy);
+				}
+			} else if (dx) {
+				if (_is_walkable(p_x + dx, p_y)) {
+					PUSH_DIRECTION(dx, 0);
+					if (!_is_walkable(p_x, p_y + 1)) {
+						PUSH_DIRECTION(dx, 1);
+					}
+					if (!_is_walkable(p_x, p_y - 1)) {
+						PUSH_DIRECTION(dx, -1);
+					}
+				}
+			} else {
+				if (_is_walkable(p_x, p_y + dy)) {
+					PUSH_DIRECTION(0, dy);
+					if (!_is_walkable(p_x + 1, p_y)) {
+						PUSH_DIRECTION(1, dy);
+					}
+					if (!_is_walkable(p_x - 1, p_y)) {
+						PUSH_DIRECTION(-1, dy);
+					}
+				}
+			}
+		} break;
+		case DIAGONAL_MODE_ONLY_IF_NO_OBSTACLES: {
+			if (dx && dy) {
+				const bool next_y = _is_walkable(p_x, p_y + dy);
+				const bool next_x = _is_walkable(p_x + dx, p_y);
+				if (next_y) {
+					PUSH_DIRECTION(0, dy);
+				}
+				if (next_x) {
+					PUSH_DIRECTION(dx, 0);
+				}
+				if (next_y && next_x) {
+					PUSH_DIRECTION(dx, dy);
+				}
+			} else if (dx) {
+				const bool next = _is_walkable(p_x + dx, p_y);
+				const bool top = _is_walkable(p_x, p_y + 1);
+				const bool bottom = _is_walkable(p_x, p_y - 1);
+				if (next) {
+					PUSH_DIRECTION(dx, 0);
+					if (top) {
+						PUSH_DIRECTION(dx, 1);
+					}
+					if (bottom) {
+						PUSH_DIRECTION(dx, -1);
+					}
+				}
+				if (top) {
+					PUSH_DIRECTION(0, 1);
+				}
+				if (bottom) {
+					PUSH_DIRECTION(0, -1);
+				}
+			} else {
+				const bool next = _is_walkable(p_x, p_y + dy);
+				const bool right = _is_walkable(p_x + 1, p_y);
+				const bool left = _is_walkable(p_x - 1, p_y);
+				if (next) {
+					PUSH_DIRECTION(0, dy);
+					if (right) {
+						PUSH_DIRECTION(1, dy);
+					}
+					if (left) {
+						PUSH_DIRECTION(-1, dy);
+					}
+				}
+				if (right) {
+					PUSH_DIRECTION(1, 0);
+				}
+				if (left) {
+					PUSH_DIRECTION(-1, 0);
+				}
+			}
+		} break;
+		default: {
+			if (dx) {
+				if (_is_walkable(p_x, p_y - 1)) {
+					PUSH_DIRECTION(0, -1);
+				}
+				if (_is_walkable(p_x, p_y + 1)) {
+					PUSH_DIRECTION(0, 1);
+				}
+				if (_is_walkable(p_x + dx, p_y)) {
+					PUSH_DIRECTION(dx, 0);
+				}
+			} else {
+				if (_is_walkable(p_x - 1, p_y)) {
+					PUSH_DIRECTION(-1, 0);
+				}
+				if (_is_walkable(p_x + 1, p_y)) {
+					PUSH_DIRECTION(1, 0);
+				}
+				if (_is_walkable(p_x, p_y + dy)) {
+					PUSH_DIRECTION(0, dy);
+				}
+			}
+		} break;
+	}
+
+#undef PUSH_DIRECTION
+	return count;
+}
+
+int AStarGrid2D::_jump(int p_x, int p_y, int p_dx, int p_dy, int p_end_index) const {
+	int x = p_x;
+	int y = p_y;
+	while (true) {
+		if (!_is_walkable(x, y)) {
+			return -1;
+		}
+		const int index = y * size.x + x;
+		if (index == p_end_index) {
+			return index;
+		}
+
+		// Stop at cells with a forced neighbor, or from which a straight jump finds one.
+		switch (diagonal_mode) {
+			case DIAGONAL_MODE_ALWAYS:
+			case DIAGONAL_MODE_AT_LEAST_ONE_WALKABLE: {
+				if (p_dx && p_dy) {
+					if ((_is_walkable(x - p_dx, y + p_dy) && !_is_walkable(x - p_dx, y)) || (_is_walkable(x + p_dx, y - p_dy) && !_is_walkable(x, y - p_dy))) {
+						return index;
+					}
+					if (_jump(x + p_dx, y, p_dx, 0, p_end_index) != -1 || _jump(x, y + p_dy, 0, p_dy, p_end_index) != -1) {
+						return index;
+					}
+					if (diagonal_mode == DIAGONAL_MODE_AT_LEAST_ONE_WALKABLE && !_is_walkable(x + p_dx, y) && !_is_walkable(x, y + p_dy)) {
+						return -1;
+					}
+				} else if (p_dx) {
+					if ((_is_walkable(x + p_dx, y + 1) && !_is_walkable(x, y + 1)) || (_is_walkable(x + p_dx, y - 1) && !_is_walkable(x, y - 1))) {
+						return index;
+					}
+				} else {
+					if ((_is_walkable(x + 1, y + p_dy) && !_is_walkable(x + 1, y)) || (_is_walkable(x - 1, y + p_dy) && !_is_walkable(x - 1, y))) {
+						return index;
+					}
+				}
+			} break;
+			case DIAGONAL_MODE_ONLY_IF_NO_OBSTACLES: {
+				if (p_dx && p_dy) {
+					if (_jump(x + p_dx, y, p_dx, 0, p_end_index) != -1 || _jump(x, y + p_dy, 0, p_dy, p_end_index) != -1) {
+						return index;
+					}
+					if (!_is_walkable(x + p_dx, y) || !_is_walkable(x, y + p_dy)) {
+						return -1;
+					}
+				} else if (p_dx) {
+					if ((_is_walkable(x, y - 1) && !_is_walkable(x - p_dx, y - 1)) || (_is_walkable(x, y + 1) && !_is_walkable(x - p_dx, y + 1))) {
+						return index;
+					}
+				} else {
+					if ((_is_walkable(x - 1, y) && !_is_walkable(x - 1, y - p_dy)) || (_is_walkable(x + 1, y) && !_is_walkable(x + 1, y - p_dy))) {
+						return index;
+					}
+				}
+			} break;
+			default: {
+				if (p_dx) {
+					if ((_is_walkable(x, y - 1) && !_is_walkable(x - p_dx, y - 1)) || (_is_walkable(x, y + 1) && !_is_walkable(x - p_dx, y + 1))) {
+						return index;
+					}
+				} else {
+					if ((_is_walkable(x - 1, y) && !_is_walkable(x - 1, y - p_dy)) || (_is_walkable(x + 1, y) && !_is_walkable(x + 1, y - p_dy))) {
+						return index;
+					}
+					if (_jump(x + 1, y, 1, 0, p_end_index) != -1 || _jump(x - 1, y, -1, 0, p_end_index) != -1) {
+						return index;
+					}
+				}
+			} break;
+		}
+
+		x += p_dx;
+		y += p_dy;
+	}
+}
+
+// Without an end, every cell reachable from the beginning is visited (and closed).
+// With bounds, cells outside of them are never visited.
+bool AStarGrid2D::_solve(SolveState &r_state, int p_begin_index, int p_end_index, const Rect2i *p_bounds) const {
+	const uint32_t cell_count = size.x * size.y;
+	if (r_state.g_score.size() != cell_count) {
+		r_state.g_score.resize(cell_count);
+		r_state.prev_index.resize(cell_count);
+		r_state.open_pass.resize(cell_count);
+		r_state.closed_pass.resize(cell_count);
+		for (uint32_t i = 0; i < cell_count; i++) {
+			r_state.open_pass[i] = 0;
+			r_state.closed_pass[i] = 0;
+		}
+		r_state.pass = 0;
+	}
+
+	r_state.pass++;
+	const uint32_t pass = r_state.pass;
+	LocalVector<OpenEntry> &open_list = r_state.open_list;
+	open_list.clear();
+
+	if (solid[p_begin_index] || (p_end_index >= 0 && solid[p_end_index])) {
+		return false;
+	}
+
+	// Jumping skips over cells, so it is only valid if all of them cost the same (and it can't stop at bounds).
+	const bool jumping = jumping_enabled && weighted_count == 0 && !p_bounds;
+	const bool has_end = p_end_index >= 0;
+	const int end_x = has_end ? p_end_index % size.x : 0;
+	const int end_y = has_end ? p_end_index / size.x : 0;
+	SortArray<OpenEntry, SortOpenEntries> sorter;
+
+	r_state.g_score[p_begin_index] = 0;
+	r_state.prev_index[p_begin_index] = -1;
+	r_state.open_pass[p_begin_index] = pass;
+
+	OpenEntry begin_entry;
+	begin_entry.f_score = has_end ? _estimate_cost(p_begin_index % size.x, p_begin_index / size.x, end_x, end_y) : 0;
+	begin_entry.index = p_begin_index;
+	open_list.push_back(begin_entry);
+
+	while (!open_list.is_empty()) {
+		sorter.pop_heap(0, open_list.size(), open_list.ptr()); // Remove the current point from the open list.
+		const OpenEntry entry = open_list[open_list.size() - 1];
+		open_list.resize(open_list.size() - 1);
+
+		// Entries are not updated in place, so skip the ones superseded by a cheaper route.
+		if (r_state.closed_pass[entry.index] == pass || entry.g_score > r_state.g_score[entry.index]) {
+			continue;
+		}
+		if (entry.index == p_end_index) {
+			return true;
+		}
+		r_state.closed_pass[entry.index] = pass;
+
+		const int x = entry.index % size.x;
+		const int y = entry.index / size.x;
+		int directions[8][2];
+		const int direction_count = _get_directions(x, y, r_state.prev_index[entry.index], jumping, directions);
+
+		for (int i = 0; i < direction_count; i++) {
+			const int dx = directions[i][0];
+			const int dy = directions[i][1];
+			int next_index;
+			real_t cost;
+			if (jumping) {
+				next_index = _jump(x + dx, y + dy, dx, dy, p_end_index);
+				if (next_index < 0) {
+					continue;
+				}
+				const int steps = MAX(ABS(next_index % size.x - x), ABS(next_index / size.x - y));
+				cost = steps * _get_step_cost(dx, dy);
+			} else {
+				if (p_bounds && !p_bounds->has_point(Vector2i(x + dx, y + dy))) {
+					continue;
+				}
+				next_index = (y + dy) * size.x + x + dx;
+				cost = _get_step_cost(dx, dy) * weight_scale[next_index];
+			}
+
+			if (r_state.closed_pass[next_index] == pass) {
+				continue;
+			}
+			const real_t g_score = entry.g_score + cost;
+			if (r_state.open_pass[next_index] == pass && g_score >= r_state.g_score[next_index]) {
+				continue;
+			}
+
+			r_state.open_pass[next_index] = pass;
+			r_state.g_score[next_index] = g_score;
+			r_state.prev_index[next_index] = entry.index;
+
+			OpenEntry next_entry;
+			next_entry.f_score = g_score + (has_end ? _estimate_cost(next_index % size.x, next_index / size.x, end_x, end_y) : 0);
+			next_entry.g_score = g_score;
+			next_entry.index = next_index;
+			open_list.push_back(next_entry);
+			sorter.push_heap(0, open_list.size() - 1, 0, next_entry, open_list.ptr());
+		}
+	}
+
+	return !has_end;
+}
+
+void AStarGrid2D::_get_path(const SolveState &p_state, int p_end_index, LocalVector<int32_t> &r_path) const {
+	r_path.clear();
+	r_path.push_back(p_end_index);
+
+	// Jump points can be several cells apart, walk back through every cell in between.
+	int index = p_end_index;
+	while (p_state.prev_index[index] >= 0) {
+		const int prev = p_state.prev_index[index];
+		const int dx = _sign(prev % size.x - index % size.x);
+		const int dy = _sign(prev / size.x - index / size.x);
+		int x = index % size.x;
+		int y = index / size.x;
+		do {
+			x += dx;
+			y += dy;
+			r_path.push_back(y * size.x + x);
+		} while (y * size.x + x != prev);
+		index = prev;
+	}
+
+	r_path.invert();
+}
+
+Rect2i AStarGrid2D::_get_cluster_rect(int p_cluster) const {
+	const Vector2i position = Vector2i(p_cluster % cluster_count.x, p_cluster / cluster_count.x) * cluster_size;
+	return Rect2i(position, Vector2i(cluster_size, cluster_size)).intersection(Rect2i(Vector2i(), size));
+}
+
+int32_t AStarGrid2D::_get_abstract_node(int p_index) {
+	if (cell_abstract_node[p_index] < 0) {
+		cell_abstract_node[p_index] = abstract_node_cell.size();
+		abstract_node_cell.push_back(p_index);
+		abstract_edges.resize(abstract_node_cell.size());
+		cluster_nodes[_get_cluster(p_index)].push_back(cell_abstract_node[p_index]);
+	}
+	return cell_abstract_node[p_index];
+}
+
+void AStarGrid2D::_add_transition(const Vector2i &p_cell, const Vector2i &p_across) {
+	const int index_a = p_cell.y * size.x + p_cell.x;
+	const int index_b = index_a + p_across.y * size.x + p_across.x;
+	const real_t step_cost = _get_step_cost(p_across.x, p_across.y);
+	const int32_t node_a = _get_abstract_node(index_a);
+	const int32_t node_b = _get_abstract_node(index_b);
+
+	AbstractEdge edge;
+	edge.to = node_b;
+	edge.cost = step_cost * weight_scale[index_b];
+	abstract_edges[node_a].push_back(edge);
+	edge.to = node_a;
+	edge.cost = step_cost * weight_scale[index_a];
+	abstract_edges[node_b].push_back(edge);
+}
+
+void AStarGrid2D::_add_entrances(const Vector2i &p_first, const Vector2i &p_step, const Vector2i &p_across, int p_length) {
+	int run_begin = -1;
+	for (int i = 0; i <= p_length; i++) {
+		const Vector2i cell = p_first + p_step * i;
+		if (i < p_length && _is_walkable(cell.x, cell.y) && _is_walkable(cell.x + p_across.x, cell.y + p_across.y)) {
+			if (run_begin < 0) {
+				run_begin = i;
+			}
+			continue;
+		}
+		if (run_begin < 0) {
+			continue;
+		}
+
+		// Wide entrances get a transition at each end, narrow ones a single one in the middle.
+		const int run_end = i - 1;
+		if (run_end - run_begin >= 5) {
+			_add_transition(p_first + p_step * run_begin, p_across);
+			_add_transition(p_first + p_step * run_end, p_across);
+		} else {
+			_add_transition(p_first + p_step * ((run_begin + run_end) / 2), p_across);
+		}
+		run_begin = -1;
+	}
+}
+
+void AStarGrid2D::_update_abstract_graph() {
+	if (!abstract_graph_dirty) {
+		return;
+	}
+	abstract_graph_dirty = false;
+
+	cell_abstract_node.clear();
+	abstract_node_cell.clear();
+	abstract_edges.clear();
+	cluster_nodes.clear();
+	if (cluster_size <= 0 || size.x == 0 || size.y == 0) {
+		return;
+	}
+
+	cluster_count = Vector2i((size.x + cluster_size - 1) / cluster_size, (size.y + cluster_size - 1) / cluster_size);
+	cluster_nodes.resize(cluster_count.x * cluster_count.y);
+	const uint32_t cell_count = size.x * size.y;
+	cell_abstract_node.resize(cell_count);
+	for (uint32_t i = 0; i < cell_count; i++) {
+		cell_abstract_node[i] = -1;
+	}
+
+	// Only straight steps cross between clusters, the refined path keeps to one cluster at a time.
+	for (int x = cluster_size; x < size.x; x += cluster_size) {
+		for (int y = 0; y < size.y; y += cluster_size) {
+			_add_entrances(Vector2i(x - 1, y), Vector2i(0, 1), Vector2i(1, 0), MIN(cluster_size, size.y - y));
+		}
+	}
+	for (int y = cluster_size; y < size.y; y += cluster_size) {
+		for (int x = 0; x < size.x; x += cluster_size) {
+			_add_entrances(Vector2i(x, y - 1), Vector2i(1, 0), Vector2i(0, 1), MIN(cluster_size, size.x - x));
+		}
+	}
+
+	// Clusters only add edges to their own entrances, so they can be linked in parallel.
+	const uint32_t cluster_total = cluster_nodes.size();
+	if (cluster_total > 1 && OS::get_singleton()->get_processor_count() > 1 && batch_mutex.try_lock() == OK) {
+		_get_batch_work_pool()->do_work(cluster_total, this, &AStarGrid2D::_link_cluster_entrances, (void *)nullptr);
+		batch_mutex.unlock();
+	} else {
+		for (uint32_t i = 0; i < cluster_total; i++) {
+			_link_cluster_entrances(i, nullptr);
+		}
+	}
+}
+
+// Links the entrances of a cluster by the cost of the shortest path inside of it.
+void AStarGrid2D::_link_cluster_entrances(uint32_t p_cluster, void *p_userdata) {
+	const Rect2i bounds = _get_cluster_rect(p_cluster);
+	const LocalVector<int32_t> &nodes = cluster_nodes[p_cluster];
+	SolveState *solve_state = _pop_batch_state();
+	for (uint32_t i = 0; i < nodes.size(); i++) {
+		_solve(*solve_state, abstract_node_cell[nodes[i]], -1, &bounds);
+		for (uint32_t j = 0; j < nodes.size(); j++) {
+			const int cell = abstract_node_cell[nodes[j]];
+			if (i != j && solve_state->closed_pass[cell] == solve_state->pass) {
+				AbstractEdge edge;
+				edge.to = nodes[j];
+				edge.cost = solve_state->g_score[cell];
+				abstract_edges[nodes[i]].push_back(edge);
+			}
+		}
+	}
+	_push_batch_state(solve_state);
+}
+
+bool AStarGrid2D::_solve_hierarchical(SolveState &r_state, int p_begin_index, int p_end_index, LocalVector<int32_t> &r_path) const {
+	if (solid[p_begin_index] || solid[p_end_index]) {
+		return false;
+	}
+
+	const int begin_cluster = _get_cluster(p_begin_index);
+	const int end_cluster = _get_cluster(p_end_index);
+	const LocalVector<int32_t> &begin_nodes = cluster_nodes[begin_cluster];
+	const LocalVector<int32_t> &end_nodes = cluster_nodes[end_cluster];
+
+	// Link the beginning to the entrances of its cluster, and the entrances of the end cluster to the end.
+	const Rect2i begin_bounds = _get_cluster_rect(begin_cluster);
+	_solve(r_state, p_begin_index, -1, &begin_bounds);
+	r_state.start_edges.clear();
+	for (uint32_t i = 0; i < begin_nodes.size(); i++) {
+		const int cell = abstract_node_cell[begin_nodes[i]];
+		if (r_state.closed_pass[cell] == r_state.pass) {
+			AbstractEdge edge;
+			edge.to = begin_nodes[i];
+			edge.cost = r_state.g_score[cell];
+			r_state.start_edges.push_back(edge);
+		}
+	}
+	if (r_state.start_edges.is_empty()) {
+		return false;
+	}
+
+	const Rect2i end_bounds = _get_cluster_rect(end_cluster);
+	r_state.goal_costs.resize(end_nodes.size());
+	bool end_reachable = false;
+	for (uint32_t i = 0; i < end_nodes.size(); i++) {
+		const bool found = _solve(r_state, abstract_node_cell[end_nodes[i]], p_end_index, &end_bounds);
+		r_state.goal_costs[i] = found ? r_state.g_score[p_end_index] : -1;
+		end_reachable = end_reachable || found;
+	}
+	if (!end_reachable) {
+		return false;
+	}
+
+	// A* over the entrances, the beginning and the end being the two nodes after them.
+	const uint32_t node_count = abstract_node_cell.size() + 2;
+	const int32_t begin_node = node_count - 2;
+	const int32_t end_node = node_count - 1;
+	if (r_state.abstract_g_score.size() != node_count) {
+		r_state.abstract_g_score.resize(node_count);
+		r_state.abstract_prev.resize(node_count);
+		r_state.abstract_open_pass.resize(node_count);
+		r_state.abstract_closed_pass.resize(node_count);
+		for (uint32_t i = 0; i < node_count; i++) {
+			r_state.abstract_open_pass[i] = 0;
+			r_state.abstract_closed_pass[i] = 0;
+		}
+		r_state.abstract_pass = 0;
+	}
+
+	r_state.abstract_pass++;
+	const uint32_t pass = r_state.abstract_pass;
+	const int end_x = p_end_index % size.x;
+	const int end_y = p_end_index / size.x;
+	LocalVector<OpenEntry> &open_list = r_state.open_list;
+	open_list.clear();
+	SortArray<OpenEntry, SortOpenEntries> sorter;
+
+	r_state.abstract_g_score[begin_node] = 0;
+	r_state.abstract_prev[begin_node] = -1;
+	r_state.abstract_open_pass[begin_node] = pass;
+
+	OpenEntry begin_entry;
+	begin_entry.f_score = _estimate_cost(p_begin_index % size.x, p_begin_index / size.x, end_x, end_y);
+	begin_entry.index = begin_node;
+	open_list.push_back(begin_entry);
+
+	bool found = false;
+	while (!open_list.is_empty()) {
+		sorter.pop_heap(0, open_list.size(), open_list.ptr());
+		const OpenEntry entry = open_list[open_list.size() - 1];
+		open_list.resize(open_list.size() - 1);
+
+		if (r_state.abstract_closed_pass[entry.index] == pass || entry.g_score > r_state.abstract_g_score[entry.index]) {
+			continue;
+		}
+		if (entry.index == end_node) {
+			found = true;
+			break;
+		}
+		r_state.abstract_closed_pass[entry.index] = pass;
+
+		const bool in_end_cluster = entry.index != begin_node && _get_cluster(abstract_node_cell[entry.index]) == end_cluster;
+		const LocalVector<AbstractEdge> &edges = entry.index == begin_node ? r_state.start_edges : abstract_edges[entry.index];
+		const uint32_t edge_count = edges.size() + (in_end_cluster ? 1 : 0);
+		for (uint32_t i = 0; i < edge_count; i++) {
+			AbstractEdge edge;
+			if (i < edges.size()) {
+				edge = edges[i];
+			} else {
+				// The last edge of an entrance of the end cluster goes to the end.
+				const int64_t goal_cost_index = end_nodes.find(entry.index);
+				if (goal_cost_index < 0 || r_state.goal_costs[goal_cost_index] < 0) {
+					continue;
+				}
+				edge.to = end_node;
+				edge.cost = r_state.goal_costs[goal_cost_index];
+			}
+
+			if (r_state.abstract_closed_pass[edge.to] == pass) {
+				continue;
+			}
+			const real_t g_score = entry.g_score + edge.cost;
+			if (r_state.abstract_open_pass[edge.to] == pass && g_score >= r_state.abstract_g_score[edge.to]) {
+				continue;
+			}
+
+			r_state.abstract_open_pass[edge.to] = pass;
+			r_state.abstract_g_score[edge.to] = g_score;
+			r_state.abstract_prev[edge.to] = entry.index;
+
+			const int cell = edge.to == end_node ? p_end_index : abstract_node_cell[edge.to];
+			OpenEntry next_entry;
+			next_entry.f_score = g_score + _estimate_cost(cell % size.x, cell / size.x, end_x, end_y);
+			next_entry.g_score = g_score;
+			next_entry.index = edge.to;
+			open_list.push_back(next_entry);
+			sorter.push_heap(0, open_list.size() - 1, 0, next_entry, open_list.ptr());
+		}
+	}
+	if (!found) {
+		return false;
+	}
+
+	LocalVector<int32_t> &waypoints = r_state.waypoints;
+	waypoints.clear();
+	waypoints.push_back(p_end_index);
+	for (int32_t node = r_state.abstract_prev[end_node]; node != begin_node; node = r_state.abstract_prev[node]) {
+		waypoints.push_back(abstract_node_cell[node]);
+	}
+	waypoints.push_back(p_begin_index);
+	waypoints.invert();
+
+	// Refine the path between consecutive waypoints, they are either neighbors across a border or in the same cluster.
+	r_path.clear();
+	r_path.push_back(p_begin_index);
+	for (uint32_t i = 1; i < waypoints.size(); i++) {
+		const int from = waypoints[i - 1];
+		const int to = waypoints[i];
+		if (from == to) {
+			continue;
+		}
+		const int cluster = _get_cluster(from);
+		if (cluster != _get_cluster(to)) {
+			r_path.push_back(to);
+			continue;
+		}
+
+		const Rect2i bounds = _get_cluster_rect(cluster);
+		ERR_FAIL_COND_V(!_solve(r_state, from, to, &bounds), false);
+		_get_path(r_state, to, r_state.segment);
+		for (uint32_t j = 1; j < r_state.segment.size(); j++) {
+			r_path.push_back(r_state.segment[j]);
+		}
+	}
+	return true;
+}
+
+bool AStarGrid2D::_find_path(SolveState &r_state, int p_begin_index, int p_end_index, LocalVector<int32_t> &r_path) const {
+	// Neighboring clusters are as cheap to search directly. When the entrances miss a path (it may only
+	// cross diagonally at a cluster corner), search the whole grid so no path is lost.
+	if (!cluster_nodes.is_empty()) {
+		const int begin_cluster = _get_cluster(p_begin_index);
+		const int end_cluster = _get_cluster(p_end_index);
+		const int cluster_distance = MAX(ABS(begin_cluster % cluster_count.x - end_cluster % cluster_count.x), ABS(begin_cluster / cluster_count.x - end_cluster / cluster_count.x));
+		if (cluster_distance > 1 && _solve_hierarchical(r_state, p_begin_index, p_end_index, r_path)) {
+			return true;
+		}
+	}
+
+	if (!_solve(r_state, p_begin_index, p_end_index)) {
+		return false;
+	}
+	_get_path(r_state, p_end_index, r_path);
+	return true;
+}
+
+Vector<Vector2> AStarGrid2D::_get_point_path(SolveState &r_state, const Vector2i &p_from, const Vector2i &p_to) const {
+	const int begin_index = p_from.y * size.x + p_from.x;
+	const int end_index = p_to.y * size.x + p_to.x;
+
+	if (begin_index == end_index) {
+		Vector<Vector2> ret;
+		ret.push_back(get_point_position(p_from));
+		return ret;
+	}
+
+	LocalVector<int32_t> cells;
+	if (!_find_path(r_state, begin_index, end_index, cells)) {
+		return Vector<Vector2>();
+	}
+
+	Vector<Vector2> path;
+	path.resize(cells.size());
+	Vector2 *w = path.ptrw();
+	for (uint32_t i = 0; i < cells.size(); i++) {
+		w[i] = offset + Vector2(cells[i] % size.x, cells[i] / size.x) * cell_size;
+	}
+	return path;
+}
+
+TypedArray<Vector2i> AStarGrid2D::get_id_path(const Vector2i &p_from, const Vector2i &p_to) {
+	ERR_FAIL_COND_V_MSG(!is_in_bounds(p_from), TypedArray<Vector2i>(), vformat("Can't get id path. Point out of bounds (%s/%s, %s/%s).", p_from.x, size.x, p_from.y, size.y));
+	ERR_FAIL_COND_V_MSG(!is_in_bounds(p_to), TypedArray<Vector2i>(), vformat("Can't get id path. Point out of bounds (%s/%s, %s/%s).", p_to.x, size.x, p_to.y, size.y));
+
+	_update_abstract_graph();
+
+	const int begin_index = p_from.y * size.x + p_from.x;
+	const int end_index = p_to.y * size.x + p_to.x;
+
+	TypedArray<Vector2i> path;
+	if (begin_index == end_index) {
+		path.push_back(p_from);
+		return path;
+	}
+
+	LocalVector<int32_t> cells;
+	if (!_find_path(state, begin_index, end_index, cells)) {
+		return path;
+	}
+
+	path.resize(cells.size());
+	for (uint32_t i = 0; i < cells.size(); i++) {
+		path[i] = Vector2i(cells[i] % size.x, cells[i] / size.x);
+	}
+	return path;
+}
+
+Vector<Vector2> AStarGrid2D::get_point_path(const Vector2i &p_from, const Vector2i &p_to) {
+	ERR_FAIL_COND_V_MSG(!is_in_bounds(p_from), Vector<Vector2>(), vformat("Can't get point path. Point out of bounds (%s/%s, %s/%s).", p_from.x, size.x, p_from.y, size.y));
+	ERR_FAIL_COND_V_MSG(!is_in_bounds(p_to), Vector<Vector2>(), vformat("Can't get point path. Point out of bounds (%s/%s, %s/%s).", p_to.x, size.x, p_to.y, size.y));
+
+	_update_abstract_graph();
+	return _get_point_path(state, p_from, p_to);
+}
+
+// Every worker needs its own scratch memory, reuse it across batches.
+AStarGrid2D::SolveState *AStarGrid2D::_pop_batch_state() {
+	SolveState *solve_state = nullptr;
+	batch_states_mutex.lock();
+	if (batch_states.size()) {
+		solve_state = batch_states[batch_states.size() - 1];
+		batch_states.resize(batch_states.size() - 1);
+	}
+	batch_states_mutex.unlock();
+	if (!solve_state) {
+		solve_state = memnew(SolveState);
+	}
+	return solve_state;
+}
+
+void AStarGrid2D::_push_batch_state(SolveState *p_state) {
+	batch_states_mutex.lock();
+	batch_states.push_back(p_state);
+	batch_states_mutex.unlock();
+}
+
+// Must be called with the batch mutex held.
+ThreadWorkPool *AStarGrid2D::_get_batch_work_pool() {
+	if (!batch_work_pool) {
+		batch_work_pool = memnew(ThreadWorkPool);
+		batch_work_pool->init();
+	}
+	return batch_work_pool;
+}
+
+void AStarGrid2D::_solve_batch_query(uint32_t p_index, BatchQuery *p_query) {
+	const Vector2i &from = p_query->from[p_index];
+	const Vector2i &to = p_query->to[p_index];
+	if (!is_in_bounds(from) || !is_in_bounds(to)) {
+		return;
+	}
+
+	SolveState *solve_state = _pop_batch_state();
+	p_query->paths[p_index] = _get_point_path(*solve_state, from, to);
+	_push_batch_state(solve_state);
+}
+
+Array AStarGrid2D::get_point_paths(const TypedArray<Vector2i> &p_from, const TypedArray<Vector2i> &p_to) {
+	ERR_FAIL_COND_V_MSG(p_from.size() != p_to.size(), Array(), "The from and to arrays must have the same size.");
+	_update_abstract_graph();
+
+	BatchQuery query;
+	const uint32_t query_count = p_from.size();
+	query.from.resize(query_count);
+	query.to.resize(query_count);
+	query.paths.resize(query_count);
+	for (uint32_t i = 0; i < query_count; i++) {
+		query.from[i] = p_from[i];
+		query.to[i] = p_to[i];
+		ERR_CONTINUE_MSG(!is_in_bounds(query.from[i]) || !is_in_bounds(query.to[i]), vformat("Can't get point path %d. Point out of bounds.", i));
+	}
+
+	// Another batch may already be running on the pool, solve this one on the calling thread then.
+	if (query_count > 1 && OS::get_singleton()->get_processor_count() > 1 && batch_mutex.try_lock() == OK) {
+		_get_batch_work_pool()->do_work(query_count, this, &AStarGrid2D::_solve_batch_query, &query);
+		batch_mutex.unlock();
+	} else {
+		for (uint32_t i = 0; i < query_count; i++) {
+			_solve_batch_query(i, &query);
+		}
+	}
+
+	Array paths;
+	paths.resize(query_count);
+	for (uint32_t i = 0; i < query_count; i++) {
+		paths[i] = query.paths[i];
+	}
+	return paths;
+}
+
+void AStarGrid2D::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_size", "size"), &AStarGrid2D::set_size);
+	ClassDB::bind_method(D_METHOD("get_size"), &AStarGrid2D::get_size);
+	ClassDB::bind_method(D_METHOD("set_offset", "offset"), &AStarGrid2D::set_offset);
+	ClassDB::bind_method(D_METHOD("get_offset"), &AStarGrid2D::get_offset);
+	ClassDB::bind_method(D_METHOD("set_cell_size", "cell_size"), &AStarGrid2D::set_cell_size);
+	ClassDB::bind_method(D_METHOD("get_cell_size"), &AStarGrid2D::get_cell_size);
+	ClassDB::bind_method(D_METHOD("set_diagonal_mode", "mode"), &AStarGrid2D::set_diagonal_mode);
+	ClassDB::bind_method(D_METHOD("get_diagonal_mode"), &AStarGrid2D::get_diagonal_mode);
+	ClassDB::bind_method(D_METHOD("set_jumping_enabled", "enabled"), &AStarGrid2D::set_jumping_enabled);
+	ClassDB::bind_method(D_METHOD("is_jumping_enabled"), &AStarGrid2D::is_jumping_enabled);
+	ClassDB::bind_method(D_METHOD("set_cluster_size", "cluster_size"), &AStarGrid2D::set_cluster_size);
+	ClassDB::bind_method(D_METHOD("get_cluster_size"), &AStarGrid2D::get_cluster_size);
+
+	ClassDB::bind_method(D_METHOD("is_in_bounds", "id"), &AStarGrid2D::is_in_bounds);
+	ClassDB::bind_method(D_METHOD("set_point_solid", "id", "solid"), &AStarGrid2D::set_point_solid, DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("is_point_solid", "id"), &AStarGrid2D::is_point_solid);
+	ClassDB::bind_method(D_METHOD("set_point_weight_scale", "id", "weight_scale"), &AStarGrid2D::set_point_weight_scale);
+	ClassDB::bind_method(D_METHOD("get_point_weight_scale", "id"), &AStarGrid2D::get_point_weight_scale);
+	ClassDB::bind_method(D_METHOD("fill_solid_region", "region", "solid"), &AStarGrid2D::fill_solid_region, DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("fill_weight_scale_region", "region", "weight_scale"), &AStarGrid2D::fill_weight_scale_region);
+	ClassDB::bind_method(D_METHOD("get_point_position", "id"), &AStarGrid2D::get_point_position);
+	ClassDB::bind_method(D_METHOD("clear"), &AStarGrid2D::clear);
+
+	ClassDB::bind_method(D_METHOD("get_id_path", "from_id", "to_id"), &AStarGrid2D::get_id_path);
+	ClassDB::bind_method(D_METHOD("get_point_path", "from_id", "to_id"), &AStarGrid2D::get_point_path);
+	ClassDB::bind_method(D_METHOD("get_point_paths", "from_ids", "to_ids"), &AStarGrid2D::get_point_paths);
+
+	ADD_PROPERTY(PropertyInfo(Variant::VECTOR2I, "size"), "set_size", "get_size");
+	ADD_PROPERTY(PropertyInfo(Variant::VECTOR2, "offset"), "set_offset", "get_offset");
+	ADD_PROPERTY(PropertyInfo(Variant::VECTOR2, "cell_size"), "set_cell_size", "get_cell_size");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "diagonal_mode", PROPERTY_HINT_ENUM, "Always,Never,At Least One Walkable,Only If No Obstacles"), "set_diagonal_mode", "get_diagonal_mode");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "jumping_enabled"), "set_jumping_enabled", "is_jumping_enabled");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "cluster_size", PROPERTY_HINT_RANGE, "0,256,1,or_greater"), "set_cluster_size", "get_cluster_size");
+
+	BIND_ENUM_CONSTANT(DIAGONAL_MODE_ALWAYS);
+	BIND_ENUM_CONSTANT(DIAGONAL_MODE_NEVER);
+	BIND_ENUM_CONSTANT(DIAGONAL_MODE_AT_LEAST_ONE_WALKABLE);
+	BIND_ENUM_CONSTANT(DIAGONAL_MODE_ONLY_IF_NO_OBSTACLES);
+	BIND_ENUM_CONSTANT(DIAGONAL_MODE_MAX);
+}
+
+void AStarGrid2D::finish_batch_work_pool() {
+	MutexLock lock(batch_mutex);
+	if (batch_work_pool) {
+		memdelete(batch_work_pool);
+		batch_work_pool = nullptr;
+	}
+}
+
+AStarGrid2D::~AStarGrid2D() {
+	for (uint32_t i = 0; i < batch_states.size(); i++) {
+		memdelete(batch_states[i]);
+	}
+}
@@ -0,0 +1,215 @@
+/*************************************************************************/
+/*  a_star_grid_2d.h                                                     */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef A_STAR_GRID_2D_H
+#define A_STAR_GRID_2D_H
+
+#include "core/object/ref_counted.h"
+#include "core/os/mutex.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/thread_work_pool.h"
+#include "core/variant/typed_array.h"
+
+/**
+	A* pathfinding on a uniform grid.
+
+	Cells are stored in flat arrays instead of a graph of points, and paths
+	can be found with Jump Point Search when all cells cost the same.
+
+	Large grids can be split in clusters (HPA*): paths are first searched
+	between the entrances of the clusters, then refined inside each cluster.
+*/
+
+class AStarGrid2D : public RefCounted {
+	GDCLASS(AStarGrid2D, RefCounted);
+
+public:
+	enum DiagonalMode {
+		DIAGONAL_MODE_ALWAYS,
+		DIAGONAL_MODE_NEVER,
+		DIAGONAL_MODE_AT_LEAST_ONE_WALKABLE,
+		DIAGONAL_MODE_ONLY_IF_NO_OBSTACLES,
+		DIAGONAL_MODE_MAX,
+	};
+
+private:
+	struct OpenEntry {
+		real_t f_score = 0;
+		real_t g_score = 0;
+		int32_t index = 0;
+	};
+
+	struct SortOpenEntries {
+		_FORCE_INLINE_ bool operator()(const OpenEntry &A, const OpenEntry &B) const { // Returns true when the entry A is worse than entry B.
+			if (A.f_score > B.f_score) {
+				return true;
+			} else if (A.f_score < B.f_score) {
+				return false;
+			} else {
+				return A.g_score < B.g_score; // If the f_costs are the same then prioritize the points that are further away from the start.
+			}
+		}
+	};
+
+	struct AbstractEdge {
+		int32_t to = 0;
+		real_t cost = 0;
+	};
+
+	// Scratch memory of a path query, so several queries can run at the same time.
+	struct SolveState {
+		LocalVector<real_t> g_score;
+		LocalVector<int32_t> prev_index;
+		LocalVector<uint32_t> open_pass;
+		LocalVector<uint32_t> closed_pass;
+		uint32_t pass = 0;
+		LocalVector<OpenEntry> open_list;
+
+		// Search over the cluster entrances, followed by the start and the goal.
+		LocalVector<real_t> abstract_g_score;
+		LocalVector<int32_t> abstract_prev;
+		LocalVector<uint32_t> abstract_open_pass;
+		LocalVector<uint32_t> abstract_closed_pass;
+		uint32_t abstract_pass = 0;
+		LocalVector<AbstractEdge> start_edges;
+		LocalVector<real_t> goal_costs; // From each entrance of the goal cluster, negative if it can't reach the goal.
+		LocalVector<int32_t> waypoints;
+		LocalVector<int32_t> segment;
+	};
+
+	struct BatchQuery {
+		LocalVector<Vector2i> from;
+		LocalVector<Vector2i> to;
+		LocalVector<Vector<Vector2>> paths;
+	};
+
+	Vector2i size;
+	Vector2 offset;
+	Vector2 cell_size = Vector2(1, 1);
+	DiagonalMode diagonal_mode = DIAGONAL_MODE_ALWAYS;
+	bool jumping_enabled = false;
+
+	// Per cell data, indexed by y * size.x + x.
+	LocalVector<uint8_t> solid;
+	LocalVector<real_t> weight_scale;
+	int weighted_count = 0; // Cells with a weight scale other than 1, jumping needs all of them to cost the same.
+
+	// Cluster entrances (HPA*), built on the first query after the grid changed.
+	int cluster_size = 0; // 0 disables the hierarchy.
+	Vector2i cluster_count;
+	bool abstract_graph_dirty = true;
+	LocalVector<int32_t> cell_abstract_node; // -1 for cells that aren't entrances.
+	LocalVector<int32_t> abstract_node_cell;
+	LocalVector<LocalVector<AbstractEdge>> abstract_edges;
+	LocalVector<LocalVector<int32_t>> cluster_nodes;
+
+	SolveState state;
+	Mutex batch_states_mutex;
+	LocalVector<SolveState *> batch_states;
+	// Shared by every grid, started by the first batch and finished with the core types.
+	static Mutex batch_mutex; // Held while the work pool runs a batch.
+	static ThreadWorkPool *batch_work_pool;
+
+	_FORCE_INLINE_ bool _is_walkable(int p_x, int p_y) const {
+		return p_x >= 0 && p_y >= 0 && p_x < size.x && p_y < size.y && !solid[p_y * size.x + p_x];
+	}
+
+	bool _is_diagonal_allowed(int p_x, int p_y, int p_dx, int p_dy) const;
+	real_t _get_step_cost(int p_dx, int p_dy) const;
+	real_t _estimate_cost(int p_from_x, int p_from_y, int p_to_x, int p_to_y) const;
+	int _get_directions(int p_x, int p_y, int p_prev_index, bool p_jumping, int r_directions[8][2]) const;
+	int _jump(int p_x, int p_y, int p_dx, int p_dy, int p_end_index) const;
+	bool _solve(SolveState &r_state, int p_begin_index, int p_end_index, const Rect2i *p_bounds = nullptr) const;
+	void _get_path(const SolveState &p_state, int p_end_index, LocalVector<int32_t> &r_path) const;
+
+	_FORCE_INLINE_ int _get_cluster(int p_index) const {
+		return (p_index / size.x / cluster_size) * cluster_count.x + (p_index % size.x) / cluster_size;
+	}
+	Rect2i _get_cluster_rect(int p_cluster) const;
+	int32_t _get_abstract_node(int p_index);
+	void _add_entrances(const Vector2i &p_first, const Vector2i &p_step, const Vector2i &p_across, int p_length);
+	void _add_transition(const Vector2i &p_cell, const Vector2i &p_across);
+	void _update_abstract_graph();
+	void _link_cluster_entrances(uint32_t p_cluster, void *p_userdata);
+	bool _solve_hierarchical(SolveState &r_state, int p_begin_index, int p_end_index, LocalVector<int32_t> &r_path) const;
+	bool _find_path(SolveState &r_state, int p_begin_index, int p_end_index, LocalVector<int32_t> &r_path) const;
+	Vector<Vector2> _get_point_path(SolveState &r_state, const Vector2i &p_from, const Vector2i &p_to) const;
+	SolveState *_pop_batch_state();
+	void _push_batch_state(SolveState *p_state);
+	static ThreadWorkPool *_get_batch_work_pool();
+	void _solve_batch_query(uint32_t p_index, BatchQuery *p_query);
+
+protected:
+	static void _bind_methods();
+
+public:
+	void set_size(const Vector2i &p_size);
+	Vector2i get_size() const;
+
+	void set_offset(const Vector2 &p_offset);
+	Vector2 get_offset() const;
+
+	void set_cell_size(const Vector2 &p_cell_size);
+	Vector2 get_cell_size() const;
+
+	void set_diagonal_mode(DiagonalMode p_diagonal_mode);
+	DiagonalMode get_diagonal_mode() const;
+
+	void set_jumping_enabled(bool p_enabled);
+	bool is_jumping_enabled() const;
+
+	void set_cluster_size(int p_cluster_size);
+	int get_cluster_size() const;
+
+	bool is_in_bounds(const Vector2i &p_id) const;
+
+	void set_point_solid(const Vector2i &p_id, bool p_solid = true);
+	bool is_point_solid(const Vector2i &p_id) const;
+	void set_point_weight_scale(const Vector2i &p_id, real_t p_weight_scale);
+	real_t get_point_weight_scale(const Vector2i &p_id) const;
+	void fill_solid_region(const Rect2i &p_region, bool p_solid = true);
+	void fill_weight_scale_region(const Rect2i &p_region, real_t p_weight_scale);
+	Vector2 get_point_position(const Vector2i &p_id) const;
+
+	void clear();
+
+	TypedArray<Vector2i> get_id_path(const Vector2i &p_from, const Vector2i &p_to);
+	Vector<Vector2> get_point_path(const Vector2i &p_from, const Vector2i &p_to);
+	Array get_point_paths(const TypedArray<Vector2i> &p_from, const TypedArray<Vector2i> &p_to);
+
+	static void finish_batch_work_pool();
+
+	AStarGrid2D() {}
+	~AStarGrid2D();
+};
+
+VARIANT_ENUM_CAST(AStarGrid2D::DiagonalMode);
+
+#endif // A_STAR_GRID_2D_H
@@ -36,10 +36,107 @@
 
 MessageQueue *MessageQueue::singleton = nullptr;
 
+SafeNumeric<uint32_t> MessageQueue::last_queue_id;
+thread_local MessageQueue::ThreadBufferHandle MessageQueue::thread_buffer;
+thread_local bool MessageQueue::thread_deferring = false;
+thread_local bool MessageQueue::flush_thread = false;
+
+uint8_t *MessageQueue::Buffer::allocate(uint32_t p_size) {
+	if (page_count == 0 || write_pos + p_size > PAGE_SIZE_BYTES) {
+		if (page_count > 0 && write_pos + sizeof(Message) <= PAGE_SIZE_BYTES) {
+			Message *end = (Message *)(pages[page_count - 1] + write_pos);
+			end->type = TYPE_PAGE_END;
+		}
+		if (page_count == pages.size()) {
+			pages.push_back((uint8_t *)memalloc(PAGE_SIZE_BYTES));
+		}
+		page_count++;
+		write_pos = 0;
+	}
+
+	uint8_t *ptr = pages[page_count - 1] + write_pos;
+	write_pos += p_size;
+	return ptr;
+}
+
+MessageQueue::Message *MessageQueue::Buffer::next(uint32_t &r_page, uint32_t &r_pos) const {
+	while (r_page < page_count) {
+		if (r_page == page_count - 1 && r_pos == write_pos) {
+			return nullptr;
+		}
+
+		Message *message = (Message *)(pages[r_page] + r_pos);
+		if (r_pos + sizeof(Message) > PAGE_SIZE_BYTES || message->type == TYPE_PAGE_END) {
+			r_page++;
+			r_pos = 0;
+			continue;
+		}
+
+		r_pos += _get_message_size(message);
+		return message;
+	}
+	return nullptr;
+}
+
+void MessageQueue::Buffer::clear() {
+	page_count = 0;
+	write_pos = 0;
+}
+
+void MessageQueue::Buffer::trim(uint32_t p_max_pages) {
+	uint32_t keep = MAX(p_max_pages, page_count);
+	for (uint32_t i = keep; i < pages.size(); i++) {
+		memfree(pages[i]);
+	}
+	if (keep < pages.size()) {
+		pages.resize(keep);
+	}
+}
+
+MessageQueue::ThreadBufferHandle::~ThreadBufferHandle() {
+	// The buffer is freed by the queue once the messages left in it are flushed.
+	if (buffer && singleton && singleton->queue_id == queue_id) {
+		buffer->lock.lock();
+		buffer->exited = true;
+		buffer->lock.unlock();
+	}
+}
+
 MessageQueue *MessageQueue::get_singleton() {
 	return singleton;
 }
 
+uint8_t *MessageQueue::_lock_and_allocate(uint32_t p_size, ThreadBuffer **r_thread_buffer) {
+	if (flush_thread) {
+		_THREAD_SAFE_LOCK_
+		*r_thread_buffer = nullptr;
+		return buffer.allocate(p_size);
+	}
+
+	ThreadBufferHandle &handle = thread_buffer;
+	if (unlikely(!handle.buffer || handle.queue_id != queue_id)) {
+		ThreadBuffer *tb = memnew(ThreadBuffer);
+		tb->buffer = memnew(Buffer);
+		_THREAD_SAFE_LOCK_
+		thread_buffers.push_back(tb);
+		_THREAD_SAFE_UNLOCK_
+		handle.buffer = tb;
+		handle.queue_id = queue_id;
+	}
+
+	handle.buffer->lock.lock();
+	*r_thread_buffer = handle.buffer;
+	return handle.buffer->buffer->allocate(p_size);
+}
+
+void MessageQueue::_unlock(ThreadBuffer *p_thread_buffer) {
+	if (p_thread_buffer) {
+		p_thread_buffer->lock.unlock();
+	} else {
+		_THREAD_SAFE_UNLOCK_
+	}
+}
+
 Error MessageQueue::push_call(ObjectID p_id, const StringName &p_method, const Variant **p_args, int p_argcount, bool p_show_error) {
 	return push_callable(Callable(p_id, p_method), p_args, p_argcount, p_show_error);
 }
@@ -60,55 +157,27 @@ Error MessageQueue::push_call(ObjectID p_id, const StringName &p_method, VARIANT
 }
 
 Error MessageQueue::push_set(ObjectID p_id, const StringName &p_prop, const Variant &p_value) {
-	_THREAD_SAFE_METHOD_
-
-	uint8_t room_needed = sizeof(Message) + sizeof(Variant);
-
-	if ((buffer_end + room_needed) >= buffer_size) {
-		String type;
-		if (ObjectDB::get_instance(p_id)) {
-			type = ObjectDB::get_instance(p_id)->get_class();
-		}
-		print_line("Failed set: " + type + ":" + p_prop + " target ID: " + itos(p_id));
-		statistics();
-		ERR_FAIL_V_MSG(ERR_OUT_OF_MEMORY, "Message queue out of memory. Try increasing 'memory/limits/message_queue/max_size_kb' in project settings.");
-	}
-
-	Message *msg = memnew_placement(&buffer[buffer_end], Message);
-	msg->args = 1;
-	msg->callable = Callable(p_id, p_prop);
+	ThreadBuffer *tb;
+	Message *msg = (Message *)_lock_and_allocate(sizeof(Message) + sizeof(Callable) + sizeof(Variant), &tb);
 	msg->type = TYPE_SET;
-
-	buffer_end += sizeof(Message);
-
-	Variant *v = memnew_placement(&buffer[buffer_end], Variant);
-	buffer_end += sizeof(Variant);
-	*v = p_value;
+	msg->args = 1;
+	Callable *callable = memnew_placement(msg + 1, Callable(p_id, p_prop));
+	memnew_placement(callable + 1, Variant(p_value));
+	_unlock(tb);
 
 	return OK;
 }
 
 Error MessageQueue::push_notification(ObjectID p_id, int p_notification) {
-	_THREAD_SAFE_METHOD_
-
 	ERR_FAIL_COND_V(p_notification < 0, ERR_INVALID_PARAMETER);
 
-	uint8_t room_needed = sizeof(Message);
-
-	if ((buffer_end + room_needed) >= buffer_size) {
-		print_line("Failed notification: " + itos(p_notification) + " target ID: " + itos(p_id));
-		statistics();
-		ERR_FAIL_V_MSG(ERR_OUT_OF_MEMORY, "Message queue out of memory. Try increasing 'memory/limits/message_queue/max_size_kb' in project settings.");
-	}
-
-	Message *msg = memnew_placement(&buffer[buffer_end], Message);
-
+	// Only the target is stored, there is no need for a Callable.
+	ThreadBuffer *tb;
+	Message *msg = (Message *)_lock_and_allocate(sizeof(Message) + sizeof(ObjectID), &tb);
 	msg->type = TYPE_NOTIFICATION;
-	msg->callable = Callable(p_id, CoreStringNames::get_singleton()->notification); //name is meaningless but callable needs it
-	//msg->target;
 	msg->notification = p_notification;
-
-	buffer_end += sizeof(Message);
+	*(ObjectID *)(msg + 1) = p_id;
+	_unlock(tb);
 
 	return OK;
 }
@@ -126,31 +195,23 @@ Error MessageQueue::push_set(Object *p_object, const StringName &p_prop, const V
 }
 
 Error MessageQueue::push_callable(const Callable &p_callable, const Variant **p_args, int p_argcount, bool p_show_error) {
-	_THREAD_SAFE_METHOD_
-
-	int room_needed = sizeof(Message) + sizeof(Variant) * p_argcount;
-
-	if ((buffer_end + room_needed) >= buffer_size) {
-		print_line("Failed method: " + p_callable);
-		statistics();
-		ERR_FAIL_V_MSG(ERR_OUT_OF_MEMORY, "Message queue out of memory. Try increasing 'memory/limits/message_queue/max_size_kb' in project settings.");
-	}
+	uint32_t room_needed = sizeof(Message) + sizeof(Callable) + sizeof(Variant) * p_argcount;
+	ERR_FAIL_COND_V_MSG(room_needed > PAGE_SIZE_BYTES, ERR_OUT_OF_MEMORY, "Too many arguments for a deferred call to " + p_callable + ".");
 
-	Message *msg = memnew_placement(&buffer[buffer_end], Message);
-	msg->args = p_argcount;
-	msg->callable = p_callable;
+	ThreadBuffer *tb;
+	Message *msg = (Message *)_lock_and_allocate(room_needed, &tb);
 	msg->type = TYPE_CALL;
 	if (p_show_error) {
 		msg->type |= FLAG_SHOW_ERROR;
 	}
+	msg->args = p_argcount;
 
-	buffer_end += sizeof(Message);
-
+	Callable *callable = memnew_placement(msg + 1, Callable(p_callable));
+	Variant *args = (Variant *)(callable + 1);
 	for (int i = 0; i < p_argcount; i++) {
-		Variant *v = memnew_placement(&buffer[buffer_end], Variant);
-		buffer_end += sizeof(Variant);
-		*v = *p_args[i];
+		memnew_placement(&args[i], Variant(*p_args[i]));
 	}
+	_unlock(tb);
 
 	return OK;
 }
@@ -174,22 +235,38 @@ void MessageQueue::statistics() {
 	Map<StringName, int> set_count;
 	Map<int, int> notify_count;
 	Map<Callable, int> call_count;
+	int typed_call_count = 0;
 	int null_count = 0;
 
-	uint32_t read_pos = 0;
-	while (read_pos < buffer_end) {
-		Message *message = (Message *)&buffer[read_pos];
+	_THREAD_SAFE_METHOD_
 
-		Object *target = message->callable.get_object();
+	uint32_t read_page = 0;
+	uint32_t read_pos = 0;
+	Message *message = buffer.next(read_page, read_pos);
+	while (message) {
+		Object *target;
+		const Callable *callable = nullptr;
+		if ((message->type & FLAG_MASK) == TYPE_NOTIFICATION) {
+			target = ObjectDB::get_instance(*(ObjectID *)(message + 1));
+		} else if ((message->type & FLAG_MASK) == TYPE_TYPED_CALL) {
+			target = ObjectDB::get_instance(((TypedCall *)(message + 1))->target);
+		} else {
+			callable = (Callable *)(message + 1);
+			target = callable->get_object();
+		}
 
 		if (target != nullptr) {
 			switch (message->type & FLAG_MASK) {
 				case TYPE_CALL: {
-					if (!call_count.has(message->callable)) {
-						call_count[message->callable] = 0;
+					if (!call_count.has(*callable)) {
+						call_count[*callable] = 0;
 					}
 
-					call_count[message->callable]++;
+					call_count[*callable]++;
+
+				} break;
+				case TYPE_TYPED_CALL: {
+					typed_call_count++;
 
 				} break;
 				case TYPE_NOTIFICATION: {
@@ -201,7 +278,7 @@ void MessageQueue::statistics() {
 
 				} break;
 				case TYPE_SET: {
-					StringName t = message->callable.get_method();
+					StringName t = callable->get_method();
 					if (!set_count.has(t)) {
 						set_count[t] = 0;
 					}
@@ -218,14 +295,13 @@ void MessageQueue::statistics() {
 			null_count++;
 		}
 
-		read_pos += sizeof(Message);
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			read_pos += sizeof(Variant) * message->args;
-		}
+		message = buffer.next(read_page, read_pos);
 	}
 
-	print_line("TOTAL BYTES: " + itos(buffer_end));
+	print_line("TOTAL BYTES: " + itos(buffer.get_used_bytes()));
+	print_line("THREAD BUFFERS: " + itos(thread_buffers.size()));
 	print_line("NULL count: " + itos(null_count));
+	print_line("TYPED CALLS: " + itos(typed_call_count));
 
 	for (Map<StringName, int>::Element *E = set_count.front(); E; E = E->next()) {
 		print_line("SET " + E->key() + ": " + itos(E->get()));
@@ -261,76 +337,145 @@ void MessageQueue::_call_function(const Callable &p_callable, const Variant *p_a
 	}
 }
 
-void MessageQueue::flush() {
-	if (buffer_end > buffer_max_used) {
-		buffer_max_used = buffer_end;
+void MessageQueue::_run_message(Message *p_message) {
+	if ((p_message->type & FLAG_MASK) == TYPE_NOTIFICATION) {
+		Object *target = ObjectDB::get_instance(*(ObjectID *)(p_message + 1));
+		if (target != nullptr) {
+			// messages don't expect a return value
+			target->notification(p_message->notification);
+		}
+		return;
 	}
 
-	uint32_t read_pos = 0;
+	if ((p_message->type & FLAG_MASK) == TYPE_TYPED_CALL) {
+		TypedCall *typed_call = (TypedCall *)(p_message + 1);
+		Object *target = ObjectDB::get_instance(typed_call->target);
+		if (target != nullptr) {
+			typed_call->call(typed_call + 1, target);
+		}
+		return;
+	}
 
-	//using reverse locking strategy
-	_THREAD_SAFE_LOCK_
+	Callable *callable = (Callable *)(p_message + 1);
+	Object *target = callable->get_object();
+	if (target == nullptr) {
+		return;
+	}
 
-	if (flushing) {
-		_THREAD_SAFE_UNLOCK_
-		ERR_FAIL_COND(flushing); //already flushing, you did something odd
+	Variant *args = (Variant *)(callable + 1);
+	switch (p_message->type & FLAG_MASK) {
+		case TYPE_CALL: {
+			// messages don't expect a return value
+			_call_function(*callable, args, p_message->args, p_message->type & FLAG_SHOW_ERROR);
+
+		} break;
+		case TYPE_SET: {
+			// messages don't expect a return value
+			target->set(callable->get_method(), *args);
+
+		} break;
 	}
-	flushing = true;
+}
 
-	while (read_pos < buffer_end) {
-		//lock on each iteration, so a call can re-add itself to the message queue
+void MessageQueue::_free_message(Message *p_message) {
+	if ((p_message->type & FLAG_MASK) == TYPE_TYPED_CALL) {
+		TypedCall *typed_call = (TypedCall *)(p_message + 1);
+		typed_call->free(typed_call + 1);
+	} else if ((p_message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
+		Callable *callable = (Callable *)(p_message + 1);
+		Variant *args = (Variant *)(callable + 1);
+		for (int i = 0; i < p_message->args; i++) {
+			args[i].~Variant();
+		}
+		callable->~Callable();
+	}
+}
 
-		Message *message = (Message *)&buffer[read_pos];
+void MessageQueue::_flush_buffer(Buffer &p_buffer, bool p_locked) {
+	uint32_t read_page = 0;
+	uint32_t read_pos = 0;
 
-		uint32_t advance = sizeof(Message);
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			advance += sizeof(Variant) * message->args;
+	// Pre-advance, so calls can add messages to the buffer being flushed.
+	Message *message = p_buffer.next(read_page, read_pos);
+	while (message) {
+		if (p_locked) {
+			_THREAD_SAFE_UNLOCK_
 		}
 
-		//pre-advance so this function is reentrant
-		read_pos += advance;
+		_run_message(message);
+		_free_message(message);
 
-		_THREAD_SAFE_UNLOCK_
+		if (p_locked) {
+			_THREAD_SAFE_LOCK_
+		}
 
-		Object *target = message->callable.get_object();
+		message = p_buffer.next(read_page, read_pos);
+	}
 
-		if (target != nullptr) {
-			switch (message->type & FLAG_MASK) {
-				case TYPE_CALL: {
-					Variant *args = (Variant *)(message + 1);
+	p_buffer.clear();
+}
+
+void MessageQueue::_free_buffer(Buffer &p_buffer) {
+	uint32_t read_page = 0;
+	uint32_t read_pos = 0;
+	Message *message = p_buffer.next(read_page, read_pos);
+	while (message) {
+		_free_message(message);
+		message = p_buffer.next(read_page, read_pos);
+	}
 
-					// messages don't expect a return value
+	p_buffer.clear();
+	p_buffer.trim(0);
+}
 
-					_call_function(message->callable, args, message->args, message->type & FLAG_SHOW_ERROR);
+void MessageQueue::flush() {
+	//using reverse locking strategy
+	_THREAD_SAFE_LOCK_
 
-				} break;
-				case TYPE_NOTIFICATION: {
-					// messages don't expect a return value
-					target->notification(message->notification);
+	if (flushing) {
+		_THREAD_SAFE_UNLOCK_
+		ERR_FAIL_COND(flushing); //already flushing, you did something odd
+	}
+	flushing = true;
 
-				} break;
-				case TYPE_SET: {
-					Variant *arg = (Variant *)(message + 1);
-					// messages don't expect a return value
-					target->set(message->callable.get_method(), *arg);
+	buffer_max_used = MAX(buffer_max_used, buffer.get_used_bytes());
 
-				} break;
-			}
-		}
+	_flush_buffer(buffer, true);
 
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			Variant *args = (Variant *)(message + 1);
-			for (int i = 0; i < message->args; i++) {
-				args[i].~Variant();
-			}
+	// Messages from other threads. Only the buffers are swapped under their lock, so threads can keep pushing.
+	for (uint32_t i = 0; i < thread_buffers.size(); i++) {
+		ThreadBuffer *tb = thread_buffers[i];
+
+		tb->lock.lock();
+		bool exited = tb->exited;
+		if (!tb->buffer->is_empty()) {
+			SWAP(tb->buffer, flush_buffer);
 		}
+		tb->lock.unlock();
 
-		message->~Message();
+		if (!flush_buffer->is_empty()) {
+			buffer_max_used = MAX(buffer_max_used, flush_buffer->get_used_bytes());
+			_THREAD_SAFE_UNLOCK_
+			_flush_buffer(*flush_buffer, false);
+			_THREAD_SAFE_LOCK_
+		}
 
-		_THREAD_SAFE_LOCK_
+		if (exited) {
+			_free_buffer(*tb->buffer);
+			memdelete(tb->buffer);
+			memdelete(tb);
+			thread_buffers.remove_unordered(i);
+			i--;
+		}
 	}
 
-	buffer_end = 0; // reset buffer
+	// Messages pushed by the calls above.
+	_flush_buffer(buffer, true);
+
+	// Only keep the memory usually needed, in case there was a spike (like when loading a level).
+	buffer.trim(max_pages);
+	flush_buffer->trim(max_pages);
+
 	flushing = false;
 	_THREAD_SAFE_UNLOCK_
 }
@@ -342,33 +487,27 @@ bool MessageQueue::is_flushing() const {
 MessageQueue::MessageQueue() {
 	ERR_FAIL_COND_MSG(singleton != nullptr, "A MessageQueue singleton already exists.");
 	singleton = this;
+	queue_id = last_queue_id.increment();
+	flush_thread = true;
 
-	buffer_size = GLOBAL_DEF_RST("memory/limits/message_queue/max_size_kb", DEFAULT_QUEUE_SIZE_KB);
+	uint32_t max_size = GLOBAL_DEF_RST("memory/limits/message_queue/max_size_kb", DEFAULT_QUEUE_SIZE_KB);
 	ProjectSettings::get_singleton()->set_custom_property_info("memory/limits/message_queue/max_size_kb", PropertyInfo(Variant::INT, "memory/limits/message_queue/max_size_kb", PROPERTY_HINT_RANGE, "1024,4096,1,or_greater"));
-	buffer_size *= 1024;
-	buffer = memnew_arr(uint8_t, buffer_size);
+	max_pages = max_size * 1024 / PAGE_SIZE_BYTES;
+
+	flush_buffer = memnew(Buffer);
 }
 
 MessageQueue::~MessageQueue() {
-	uint32_t read_pos = 0;
-
-	while (read_pos < buffer_end) {
-		Message *message = (Message *)&buffer[read_pos];
-		Variant *args = (Variant *)(message + 1);
-		int argc = message->args;
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			for (int i = 0; i < argc; i++) {
-				args[i].~Variant();
-			}
-		}
-		message->~Message();
-
-		read_pos += sizeof(Message);
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			read_pos += sizeof(Variant) * message->args;
-		}
+	_free_buffer(buffer);
+	_free_buffer(*flush_buffer);
+	memdelete(flush_buffer);
+
+	for (uint32_t i = 0; i < thread_buffers.size(); i++) {
+		_free_buffer(*thread_buffers[i]->buffer);
+		memdelete(thread_buffers[i]->buffer);
+		memdelete(thread_buffers[i]);
 	}
 
+	flush_thread = false;
 	singleton = nullptr;
-	memdelete_arr(buffer);
 }
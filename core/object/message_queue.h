@@ -32,44 +32,152 @@
 #define MESSAGE_QUEUE_H
 
 #include "core/object/class_db.h"
+#include "core/os/spin_lock.h"
 #include "core/os/thread_safe.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
+
+#include <type_traits>
 
 class MessageQueue {
 	_THREAD_SAFE_CLASS_
 
 	enum {
-		DEFAULT_QUEUE_SIZE_KB = 4096
+		DEFAULT_QUEUE_SIZE_KB = 4096,
+		PAGE_SIZE_BYTES = 16 * 1024,
 	};
 
 	enum {
 		TYPE_CALL,
 		TYPE_NOTIFICATION,
 		TYPE_SET,
+		TYPE_TYPED_CALL,
+		TYPE_PAGE_END, // Nothing else in this page, the next message is at the start of the next one.
 		FLAG_SHOW_ERROR = 1 << 14,
 		FLAG_MASK = FLAG_SHOW_ERROR - 1
 
 	};
 
+	// Notifications are followed by the target ObjectID, calls and sets by a Callable and their arguments,
+	// typed calls by a TypedCall and the data it's called with.
 	struct Message {
-		Callable callable;
-		int16_t type;
+		int32_t type;
 		union {
-			int16_t notification;
-			int16_t args;
+			int32_t notification;
+			int32_t args;
+			int32_t data_size;
 		};
 	};
 
-	uint8_t *buffer;
-	uint32_t buffer_end = 0;
-	uint32_t buffer_max_used = 0;
-	uint32_t buffer_size;
+	// Calls a C++ method with its arguments stored as they are, without going through Variant or ClassDB.
+	struct TypedCall {
+		ObjectID target;
+		void (*call)(void *p_data, Object *p_target);
+		void (*free)(void *p_data);
+	};
 
-	void _call_function(const Callable &p_callable, const Variant *p_args, int p_argcount, bool p_show_error);
+	template <class L>
+	static void _typed_call_call(void *p_data, Object *p_target) {
+		(*(L *)p_data)(p_target);
+	}
+
+	template <class L>
+	static void _typed_call_free(void *p_data) {
+		((L *)p_data)->~L();
+	}
+
+	// Messages are stored in pages, allocated as needed. A message never crosses pages.
+	struct Buffer {
+		LocalVector<uint8_t *> pages;
+		uint32_t page_count = 0; // Pages holding messages, the others are kept for reuse.
+		uint32_t write_pos = 0; // Into the last page holding messages.
+
+		_FORCE_INLINE_ bool is_empty() const { return page_count == 0; }
+		_FORCE_INLINE_ uint32_t get_used_bytes() const { return page_count ? (page_count - 1) * PAGE_SIZE_BYTES + write_pos : 0; }
+		uint8_t *allocate(uint32_t p_size);
+		Message *next(uint32_t &r_page, uint32_t &r_pos) const;
+		void clear();
+		void trim(uint32_t p_max_pages);
+	};
+
+	// Threads other than the flushing one push to a buffer of their own, so they don't contend on the queue lock.
+	struct ThreadBuffer {
+		SpinLock lock;
+		Buffer *buffer = nullptr;
+		bool exited = false;
+	};
+
+	struct ThreadBufferHandle {
+		ThreadBuffer *buffer = nullptr;
+		uint32_t queue_id = 0;
+		~ThreadBufferHandle();
+	};
+
+	Buffer buffer;
+	Buffer *flush_buffer = nullptr; // Swapped with each thread buffer while flushing.
+	LocalVector<ThreadBuffer *> thread_buffers;
+	uint32_t buffer_max_used = 0;
+	uint32_t max_pages = 0;
+	uint32_t queue_id = 0;
 
 	static MessageQueue *singleton;
 
+	static SafeNumeric<uint32_t> last_queue_id;
+	static thread_local ThreadBufferHandle thread_buffer;
+	static thread_local bool thread_deferring;
+	static thread_local bool flush_thread;
+
 	bool flushing = false;
 
+	_FORCE_INLINE_ static uint32_t _get_message_size(const Message *p_message) {
+		if ((p_message->type & FLAG_MASK) == TYPE_NOTIFICATION) {
+			return sizeof(Message) + sizeof(ObjectID);
+		}
+		if ((p_message->type & FLAG_MASK) == TYPE_TYPED_CALL) {
+			return sizeof(Message) + sizeof(TypedCall) + p_message->data_size;
+		}
+		return sizeof(Message) + sizeof(Callable) + sizeof(Variant) * p_message->args;
+	}
+
+	uint8_t *_lock_and_allocate(uint32_t p_size, ThreadBuffer **r_thread_buffer);
+	void _unlock(ThreadBuffer *p_thread_buffer);
+
+	template <class L>
+	Error _push_typed_call(ObjectID p_id, L &&p_call) {
+		typedef typename std::decay<L>::type Call;
+		static_assert(alignof(Call) <= alignof(TypedCall), "Typed call arguments are over-aligned for the message queue.");
+		static_assert(sizeof(Message) + sizeof(TypedCall) + sizeof(Call) <= PAGE_SIZE_BYTES, "Typed call arguments don't fit in a message queue page.");
+		// Keep the next message aligned.
+		const uint32_t data_size = (sizeof(Call) + alignof(TypedCall) - 1) & ~uint32_t(alignof(TypedCall) - 1);
+
+		ThreadBuffer *tb;
+		Message *msg = (Message *)_lock_and_allocate(sizeof(Message) + sizeof(TypedCall) + data_size, &tb);
+		msg->type = TYPE_TYPED_CALL;
+		msg->data_size = data_size;
+		TypedCall *typed_call = (TypedCall *)(msg + 1);
+		typed_call->target = p_id;
+		typed_call->call = &_typed_call_call<Call>;
+		typed_call->free = &_typed_call_free<Call>;
+		memnew_placement(typed_call + 1, Call(std::forward<L>(p_call)));
+		_unlock(tb);
+
+		return OK;
+	}
+
+	template <class C, class... P>
+	Error _push_method_call(ObjectID p_id, void (C::*p_method)(P...), typename std::decay<P>::type... p_args) {
+		// The arguments are copied into the message, so references don't outlive what they point to.
+		return _push_typed_call(p_id, [p_method, p_args...](Object *p_target) mutable {
+			(static_cast<C *>(p_target)->*p_method)(p_args...);
+		});
+	}
+
+	void _call_function(const Callable &p_callable, const Variant *p_args, int p_argcount, bool p_show_error);
+	void _run_message(Message *p_message);
+	static void _free_message(Message *p_message);
+	void _flush_buffer(Buffer &p_buffer, bool p_locked);
+	static void _free_buffer(Buffer &p_buffer);
+
 public:
 	static MessageQueue *get_singleton();
 
@@ -84,6 +192,20 @@ public:
 	Error push_notification(Object *p_object, int p_notification);
 	Error push_set(Object *p_object, const StringName &p_prop, const Variant &p_value);
 
+	// Typed fast path: the method is called directly with copies of the arguments, skipping the Variant
+	// conversion and method lookup. Scripts can't override the call, use the StringName version for that.
+	template <class T, class C, class... P, class... A>
+	Error push_call(T *p_object, void (C::*p_method)(P...), A &&...p_args) {
+		static_assert(std::is_base_of<Object, C>::value && std::is_base_of<C, T>::value, "Typed deferred calls need a method of the target object.");
+		static_assert(sizeof...(P) == sizeof...(A), "Wrong argument count for a typed deferred call.");
+		return _push_method_call<C, P...>(p_object->get_instance_id(), p_method, std::forward<A>(p_args)...);
+	}
+
+	// Enabled on worker threads running code that must not touch shared state, like threaded node processing.
+	// Operations that aren't thread-safe (tree changes, signal emission) push themselves to the queue instead.
+	static void set_thread_deferring(bool p_enable) { thread_deferring = p_enable; }
+	_FORCE_INLINE_ static bool is_thread_deferring() { return thread_deferring; }
+
 	void statistics();
 	void flush();
 
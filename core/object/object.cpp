@@ -1048,6 +1048,18 @@ Error Object::emit_signal(const StringName &p_name, const Variant **p_args, int
 		return ERR_UNAVAILABLE;
 	}
 
+	if (MessageQueue::is_thread_deferring()) {
+		// Connected objects belong to the main thread, emit from there.
+		Variant name = p_name;
+		Vector<const Variant *> args;
+		args.resize(p_argcount + 1);
+		args.write[0] = &name;
+		for (int i = 0; i < p_argcount; i++) {
+			args.write[i + 1] = p_args[i];
+		}
+		return MessageQueue::get_singleton()->push_call(get_instance_id(), "emit_signal", args.ptr(), args.size(), true);
+	}
+
 	List<_ObjectSignalDisconnectData> disconnect_data;
 
 	//copy on write will ensure that disconnecting the signal or even deleting the object will not affect the signal calling.
@@ -31,10 +31,12 @@
 #include "memory.h"
 
 #include "core/error/error_macros.h"
+#include "core/os/size_class_allocator.h"
 #include "core/templates/safe_refcount.h"
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 void *operator new(size_t p_size, const char *p_description) {
 	return Memory::alloc_static(p_size, false);
@@ -63,7 +65,39 @@ SafeNumeric<uint64_t> Memory::mem_usage;
 SafeNumeric<uint64_t> Memory::max_usage;
 #endif
 
-SafeNumeric<uint64_t> Memory::alloc_count;
+// Small blocks come from the size class allocator, the rest from the system.
+
+static _FORCE_INLINE_ void *_alloc(size_t p_bytes) {
+	void *mem = SizeClassAllocator::alloc(p_bytes);
+	return mem ? mem : malloc(p_bytes);
+}
+
+static void *_realloc(void *p_mem, size_t p_bytes) {
+	size_t block_size = SizeClassAllocator::get_block_size(p_mem);
+	if (!block_size) {
+		return realloc(p_mem, p_bytes);
+	}
+	if (p_bytes == 0) {
+		SizeClassAllocator::free(p_mem);
+		return nullptr;
+	}
+	if (p_bytes <= block_size) {
+		return p_mem;
+	}
+
+	void *mem = _alloc(p_bytes);
+	if (mem) {
+		memcpy(mem, p_mem, block_size);
+		SizeClassAllocator::free(p_mem);
+	}
+	return mem;
+}
+
+static _FORCE_INLINE_ void _free(void *p_mem) {
+	if (!SizeClassAllocator::free(p_mem)) {
+		free(p_mem);
+	}
+}
 
 void *Memory::alloc_static(size_t p_bytes, bool p_pad_align) {
 #ifdef DEBUG_ENABLED
@@ -72,12 +106,10 @@ void *Memory::alloc_static(size_t p_bytes, bool p_pad_align) {
 	bool prepad = p_pad_align;
 #endif
 
-	void *mem = malloc(p_bytes + (prepad ? PAD_ALIGN : 0));
+	void *mem = _alloc(p_bytes + (prepad ? PAD_ALIGN : 0));
 
 	ERR_FAIL_COND_V(!mem, nullptr);
 
-	alloc_count.increment();
-
 	if (prepad) {
 		uint64_t *s = (uint64_t *)mem;
 		*s = p_bytes;
@@ -121,12 +153,12 @@ void *Memory::realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align) {
 #endif
 
 		if (p_bytes == 0) {
-			free(mem);
+			_free(mem);
 			return nullptr;
 		} else {
 			*s = p_bytes;
 
-			mem = (uint8_t *)realloc(mem, p_bytes + PAD_ALIGN);
+			mem = (uint8_t *)_realloc(mem, p_bytes + PAD_ALIGN);
 			ERR_FAIL_COND_V(!mem, nullptr);
 
 			s = (uint64_t *)mem;
@@ -136,7 +168,7 @@ void *Memory::realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align) {
 			return mem + PAD_ALIGN;
 		}
 	} else {
-		mem = (uint8_t *)realloc(mem, p_bytes);
+		mem = (uint8_t *)_realloc(mem, p_bytes);
 
 		ERR_FAIL_COND_V(mem == nullptr && p_bytes > 0, nullptr);
 
@@ -155,8 +187,6 @@ void Memory::free_static(void *p_ptr, bool p_pad_align) {
 	bool prepad = p_pad_align;
 #endif
 
-	alloc_count.decrement();
-
 	if (prepad) {
 		mem -= PAD_ALIGN;
 
@@ -165,9 +195,9 @@ void Memory::free_static(void *p_ptr, bool p_pad_align) {
 		mem_usage.sub(*s);
 #endif
 
-		free(mem);
+		_free(mem);
 	} else {
-		free(mem);
+		_free(mem);
 	}
 }
 
@@ -191,6 +221,14 @@ uint64_t Memory::get_mem_max_usage() {
 #endif
 }
 
+uint64_t Memory::get_small_alloc_reserved() {
+	return SizeClassAllocator::get_reserved_bytes();
+}
+
+uint64_t Memory::get_small_alloc_usage() {
+	return SizeClassAllocator::get_used_bytes();
+}
+
 _GlobalNil::_GlobalNil() {
 	left = this;
 	right = this;
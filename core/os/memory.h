@@ -47,8 +47,6 @@ class Memory {
 	static SafeNumeric<uint64_t> max_usage;
 #endif
 
-	static SafeNumeric<uint64_t> alloc_count;
-
 public:
 	static void *alloc_static(size_t p_bytes, bool p_pad_align = false);
 	static void *realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align = false);
@@ -57,6 +55,10 @@ public:
 	static uint64_t get_mem_available();
 	static uint64_t get_mem_usage();
 	static uint64_t get_mem_max_usage();
+
+	// Memory reserved for, and handed out in, small blocks (see SizeClassAllocator).
+	static uint64_t get_small_alloc_reserved();
+	static uint64_t get_small_alloc_usage();
 };
 
 class DefaultAllocator {
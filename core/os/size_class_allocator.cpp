@@ -0,0 +1,333 @@
+/*************************************************************************/
+/*  size_class_allocator.cpp                                             */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "size_class_allocator.h"
+
+#include "core/os/mutex.h"
+
+#include <stdlib.h>
+#include <atomic>
+
+// Sanitizers need to see every allocation on its own.
+#if defined(__SANITIZE_ADDRESS__) || defined(__SANITIZE_THREAD__)
+#define SIZE_CLASS_ALLOCATOR_DISABLED
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer) || __has_feature(thread_sanitizer) || __has_feature(memory_sanitizer)
+#define SIZE_CLASS_ALLOCATOR_DISABLED
+#endif
+#endif
+
+#ifdef SIZE_CLASS_ALLOCATOR_DISABLED
+static const bool enabled = false;
+#else
+static const bool enabled = true;
+#endif
+
+// Everything here is constant initialized, as allocations happen before static constructors run.
+
+static const uint32_t class_sizes[SizeClassAllocator::CLASS_COUNT] = {
+	16, 32, 48, 64, 80, 96, 112, 128,
+	160, 192, 224, 256,
+	320, 384, 448, 512,
+	640, 768, 896, 1024,
+	1280, 1536, 1792, 2048,
+	2560, 3072, 3584, 4096
+};
+
+static _FORCE_INLINE_ uint32_t _get_size_class(size_t p_bytes) {
+	if (p_bytes <= 128) {
+		return p_bytes ? uint32_t(p_bytes - 1) >> 4 : 0;
+	}
+
+	// Four classes per power of two above 128.
+	uint32_t shift = 7;
+	while ((size_t(1) << (shift + 1)) < p_bytes) {
+		shift++;
+	}
+	return 8 + (shift - 7) * 4 + uint32_t((p_bytes - 1 - (size_t(1) << shift)) >> (shift - 2));
+}
+
+// Blocks moved between a thread cache and the shared lists at once.
+static _FORCE_INLINE_ uint32_t _get_batch_size(uint32_t p_class) {
+	return CLAMP(16384 / class_sizes[p_class], 4u, 64u);
+}
+
+/* Page map */
+
+// Span addresses are split in a root and a leaf index. 48 bits cover the user space of
+// current 64-bit systems, memory above is left to malloc().
+enum {
+	SPAN_SHIFT = 16,
+	LEAF_BITS = 16,
+	ROOT_BITS = 48 - SPAN_SHIFT - LEAF_BITS,
+	SPANS_PER_CHUNK = 16,
+};
+
+static_assert((1 << SPAN_SHIFT) == SizeClassAllocator::SPAN_SIZE, "Span shift doesn't match the span size.");
+
+struct PageMapLeaf {
+	// Size class + 1 of each span, 0 for memory that isn't ours.
+	std::atomic<uint8_t> classes[1 << LEAF_BITS];
+};
+
+static std::atomic<PageMapLeaf *> page_map[1 << ROOT_BITS];
+
+static BinaryMutex span_mutex;
+static uint8_t *span_chunk = nullptr;
+static uint8_t *span_chunk_end = nullptr;
+
+static std::atomic<uint64_t> reserved_bytes{ 0 };
+static std::atomic<uint64_t> used_bytes{ 0 };
+
+static _FORCE_INLINE_ uint32_t _get_span_class(const void *p_ptr) {
+	uint64_t span = uint64_t(uintptr_t(p_ptr)) >> SPAN_SHIFT;
+	if (span >> (ROOT_BITS + LEAF_BITS)) {
+		return 0;
+	}
+	PageMapLeaf *leaf = page_map[span >> LEAF_BITS].load(std::memory_order_acquire);
+	if (!leaf) {
+		return 0;
+	}
+	return leaf->classes[span & ((1 << LEAF_BITS) - 1)].load(std::memory_order_relaxed);
+}
+
+static uint8_t *_alloc_span(uint32_t p_class) {
+	MutexLock lock(span_mutex);
+
+	if (span_chunk == span_chunk_end) {
+		// Spans start at multiples of their size, so a block finds its span by masking its address.
+		uint8_t *chunk = (uint8_t *)malloc(size_t(SizeClassAllocator::SPAN_SIZE) * (SPANS_PER_CHUNK + 1));
+		if (!chunk || (uint64_t(uintptr_t(chunk)) >> SPAN_SHIFT) + SPANS_PER_CHUNK + 1 >= (uint64_t(1) << (ROOT_BITS + LEAF_BITS))) {
+			::free(chunk);
+			return nullptr;
+		}
+		span_chunk = (uint8_t *)((uintptr_t(chunk) + SizeClassAllocator::SPAN_SIZE - 1) & ~uintptr_t(SizeClassAllocator::SPAN_SIZE - 1));
+		span_chunk_end = span_chunk + size_t(SizeClassAllocator::SPAN_SIZE) * SPANS_PER_CHUNK;
+		reserved_bytes.fetch_add(uint64_t(SizeClassAllocator::SPAN_SIZE) * SPANS_PER_CHUNK, std::memory_order_relaxed);
+	}
+
+	uint8_t *span = span_chunk;
+	uint64_t index = uint64_t(uintptr_t(span)) >> SPAN_SHIFT;
+	std::atomic<PageMapLeaf *> &root = page_map[index >> LEAF_BITS];
+	PageMapLeaf *leaf = root.load(std::memory_order_relaxed);
+	if (!leaf) {
+		leaf = (PageMapLeaf *)calloc(1, sizeof(PageMapLeaf));
+		if (!leaf) {
+			return nullptr;
+		}
+		root.store(leaf, std::memory_order_release);
+	}
+	leaf->classes[index & ((1 << LEAF_BITS) - 1)].store(p_class + 1, std::memory_order_relaxed);
+	span_chunk += SizeClassAllocator::SPAN_SIZE;
+
+	return span;
+}
+
+/* Shared lists */
+
+struct Block {
+	Block *next;
+};
+
+struct alignas(64) CentralList {
+	BinaryMutex mutex;
+	Block *free = nullptr;
+	uint8_t *bump = nullptr;
+	uint8_t *bump_end = nullptr;
+};
+
+static CentralList central_lists[SizeClassAllocator::CLASS_COUNT];
+
+// Returns how many blocks were taken, fewer than asked only when out of memory.
+static uint32_t _central_take(uint32_t p_class, uint32_t p_count, Block *&r_first) {
+	CentralList &list = central_lists[p_class];
+	uint32_t size = class_sizes[p_class];
+	Block *first = nullptr;
+	uint32_t taken = 0;
+
+	list.mutex.lock();
+	while (taken < p_count) {
+		Block *block = list.free;
+		if (block) {
+			list.free = block->next;
+		} else {
+			if (list.bump == list.bump_end) {
+				uint8_t *span = _alloc_span(p_class);
+				if (!span) {
+					break;
+				}
+				list.bump = span;
+				list.bump_end = span + (SizeClassAllocator::SPAN_SIZE / size) * size;
+			}
+			block = (Block *)list.bump;
+			list.bump += size;
+		}
+		block->next = first;
+		first = block;
+		taken++;
+	}
+	list.mutex.unlock();
+
+	used_bytes.fetch_add(uint64_t(taken) * size, std::memory_order_relaxed);
+	r_first = first;
+	return taken;
+}
+
+static void _central_give(uint32_t p_class, Block *p_first, Block *p_last, uint32_t p_count) {
+	CentralList &list = central_lists[p_class];
+
+	list.mutex.lock();
+	p_last->next = list.free;
+	list.free = p_first;
+	list.mutex.unlock();
+
+	used_bytes.fetch_sub(uint64_t(p_count) * class_sizes[p_class], std::memory_order_relaxed);
+}
+
+/* Thread caches */
+
+// Trivial, so using it costs no more than any thread local access.
+struct ThreadCache {
+	Block *free[SizeClassAllocator::CLASS_COUNT];
+	uint32_t count[SizeClassAllocator::CLASS_COUNT];
+};
+
+static thread_local ThreadCache thread_cache;
+static thread_local bool thread_cache_released = false;
+
+// Gives the cached blocks back when the thread exits. Only touched on slow paths, as using it
+// has to check whether it was constructed.
+struct ThreadCacheRelease {
+	bool used = false;
+
+	~ThreadCacheRelease() {
+		thread_cache_released = true;
+		for (uint32_t i = 0; i < SizeClassAllocator::CLASS_COUNT; i++) {
+			Block *first = thread_cache.free[i];
+			if (!first) {
+				continue;
+			}
+			Block *last = first;
+			while (last->next) {
+				last = last->next;
+			}
+			_central_give(i, first, last, thread_cache.count[i]);
+			thread_cache.free[i] = nullptr;
+			thread_cache.count[i] = 0;
+		}
+	}
+};
+
+static thread_local ThreadCacheRelease thread_cache_release;
+
+void *SizeClassAllocator::alloc(size_t p_bytes) {
+	if (!enabled || p_bytes > MAX_SIZE) {
+		return nullptr;
+	}
+
+	uint32_t size_class = _get_size_class(p_bytes);
+	Block *block;
+
+	if (unlikely(thread_cache_released)) {
+		return _central_take(size_class, 1, block) ? block : nullptr;
+	}
+
+	ThreadCache &cache = thread_cache;
+	block = cache.free[size_class];
+	if (unlikely(!block)) {
+		thread_cache_release.used = true;
+		cache.count[size_class] = _central_take(size_class, _get_batch_size(size_class), block);
+		if (!block) {
+			return nullptr;
+		}
+	}
+
+	cache.free[size_class] = block->next;
+	cache.count[size_class]--;
+	return block;
+}
+
+bool SizeClassAllocator::free(void *p_ptr) {
+	uint32_t span_class = _get_span_class(p_ptr);
+	if (!span_class) {
+		return false;
+	}
+
+	uint32_t size_class = span_class - 1;
+	Block *block = (Block *)p_ptr;
+
+	if (unlikely(thread_cache_released)) {
+		block->next = nullptr;
+		_central_give(size_class, block, block, 1);
+		return true;
+	}
+
+	ThreadCache &cache = thread_cache;
+	block->next = cache.free[size_class];
+	cache.free[size_class] = block;
+	uint32_t count = ++cache.count[size_class];
+
+	if (unlikely(count == 1)) {
+		thread_cache_release.used = true;
+	}
+
+	uint32_t batch = _get_batch_size(size_class);
+	if (unlikely(count > batch * 2)) {
+		// Keep the most recently freed blocks, they are the most likely to be in the CPU cache.
+		Block *keep_last = block;
+		for (uint32_t i = 1; i < batch; i++) {
+			keep_last = keep_last->next;
+		}
+		Block *first = keep_last->next;
+		keep_last->next = nullptr;
+
+		Block *last = first;
+		while (last->next) {
+			last = last->next;
+		}
+		_central_give(size_class, first, last, count - batch);
+		cache.count[size_class] = batch;
+	}
+
+	return true;
+}
+
+size_t SizeClassAllocator::get_block_size(const void *p_ptr) {
+	uint32_t span_class = _get_span_class(p_ptr);
+	return span_class ? class_sizes[span_class - 1] : 0;
+}
+
+uint64_t SizeClassAllocator::get_reserved_bytes() {
+	return reserved_bytes.load(std::memory_order_relaxed);
+}
+
+uint64_t SizeClassAllocator::get_used_bytes() {
+	return used_bytes.load(std::memory_order_relaxed);
+}
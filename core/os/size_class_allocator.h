@@ -0,0 +1,67 @@
+/*************************************************************************/
+/*  size_class_allocator.h                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef SIZE_CLASS_ALLOCATOR_H
+#define SIZE_CLASS_ALLOCATOR_H
+
+#include "core/typedefs.h"
+
+#include <stddef.h>
+
+// Serves the small allocations behind memalloc() and memnew() (objects, Variant containers,
+// string buffers) from blocks of a few fixed sizes. Each thread keeps a cache of free blocks
+// per size, so most allocations and frees take no lock and touch no shared counter. The
+// caches refill from, and overflow to, shared lists in batches.
+//
+// Blocks are carved from 64 KiB spans, which are never returned to the system, but are
+// reused for blocks of the same size. A page map tells which spans belong to the allocator,
+// so no header is needed to free a block.
+class SizeClassAllocator {
+public:
+	enum {
+		SPAN_SIZE = 64 * 1024,
+		MAX_SIZE = 4096,
+		CLASS_COUNT = 28,
+	};
+
+	// Returns nullptr if p_bytes is bigger than MAX_SIZE, or the allocator is disabled.
+	static void *alloc(size_t p_bytes);
+	// Returns false, doing nothing, if p_ptr doesn't come from this allocator.
+	static bool free(void *p_ptr);
+	// Returns the usable size of a block, or 0 if p_ptr doesn't come from this allocator.
+	static size_t get_block_size(const void *p_ptr);
+
+	// Memory in spans, whether the blocks are used or not.
+	static uint64_t get_reserved_bytes();
+	// Memory in blocks handed to threads, including the ones their caches keep free.
+	static uint64_t get_used_bytes();
+};
+
+#endif // SIZE_CLASS_ALLOCATOR_H
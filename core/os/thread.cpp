@@ -38,6 +38,7 @@
 
 Error (*Thread::set_name_func)(const String &) = nullptr;
 void (*Thread::set_priority_func)(Thread::Priority) = nullptr;
+Error (*Thread::set_realtime_func)() = nullptr;
 void (*Thread::init_func)() = nullptr;
 void (*Thread::term_func)() = nullptr;
 
@@ -53,11 +54,13 @@ void Thread::_set_platform_funcs(
 		Error (*p_set_name_func)(const String &),
 		void (*p_set_priority_func)(Thread::Priority),
 		void (*p_init_func)(),
-		void (*p_term_func)()) {
+		void (*p_term_func)(),
+		Error (*p_set_realtime_func)()) {
 	Thread::set_name_func = p_set_name_func;
 	Thread::set_priority_func = p_set_priority_func;
 	Thread::init_func = p_init_func;
 	Thread::term_func = p_term_func;
+	Thread::set_realtime_func = p_set_realtime_func;
 }
 
 void Thread::callback(Thread *p_self, const Settings &p_settings, Callback p_callback, void *p_userdata) {
@@ -112,6 +115,14 @@ Error Thread::set_name(const String &p_name) {
 	return ERR_UNAVAILABLE;
 }
 
+Error Thread::set_realtime() {
+	if (set_realtime_func) {
+		return set_realtime_func();
+	}
+
+	return ERR_UNAVAILABLE;
+}
+
 Thread::Thread() {
 	caller_id = _thread_id_hash(std::this_thread::get_id());
 }
@@ -73,6 +73,7 @@ private:
 
 	static Error (*set_name_func)(const String &);
 	static void (*set_priority_func)(Thread::Priority);
+	static Error (*set_realtime_func)();
 	static void (*init_func)();
 	static void (*term_func)();
 #endif
@@ -82,7 +83,8 @@ public:
 			Error (*p_set_name_func)(const String &),
 			void (*p_set_priority_func)(Thread::Priority),
 			void (*p_init_func)() = nullptr,
-			void (*p_term_func)() = nullptr);
+			void (*p_term_func)() = nullptr,
+			Error (*p_set_realtime_func)() = nullptr);
 
 #if !defined(NO_THREADS)
 	_FORCE_INLINE_ ID get_id() const { return id; }
@@ -92,6 +94,9 @@ public:
 	_FORCE_INLINE_ static ID get_main_id() { return main_thread_id; }
 
 	static Error set_name(const String &p_name);
+	// Asks for real-time scheduling of the caller thread. Only meant for short, latency-critical work like audio mixing,
+	// as such a thread can starve every other one. Fails without the needed privileges.
+	static Error set_realtime();
 
 	void start(Thread::Callback p_callback, void *p_user, const Settings &p_settings = Settings());
 	bool is_started() const;
@@ -108,6 +113,7 @@ public:
 	_FORCE_INLINE_ static ID get_main_id() { return 0; }
 
 	static Error set_name(const String &p_name) { return ERR_UNAVAILABLE; }
+	static Error set_realtime() { return ERR_UNAVAILABLE; }
 
 	void start(Thread::Callback p_callback, void *p_user, const Settings &p_settings = Settings()) {}
 	bool is_started() const { return false; }
@@ -62,6 +62,7 @@
 #include "core/io/udp_server.h"
 #include "core/io/xml_parser.h"
 #include "core/math/a_star.h"
+#include "core/math/a_star_grid_2d.h"
 #include "core/math/expression.h"
 #include "core/math/geometry_2d.h"
 #include "core/math/geometry_3d.h"
@@ -216,6 +217,7 @@ void register_core_types() {
 	ClassDB::register_virtual_class<PackedDataContainerRef>();
 	ClassDB::register_class<AStar>();
 	ClassDB::register_class<AStar2D>();
+	ClassDB::register_class<AStarGrid2D>();
 	ClassDB::register_class<EncodedObjectAsID>();
 	ClassDB::register_class<RandomNumberGenerator>();
 
@@ -303,6 +305,8 @@ void register_core_extensions() {
 void unregister_core_types() {
 	native_extension_manager->deinitialize_extensions(NativeExtension::INITIALIZATION_LEVEL_CORE);
 
+	AStarGrid2D::finish_batch_work_pool();
+
 	memdelete(native_extension_manager);
 	memdelete(_resource_loader);
 	memdelete(_resource_saver);
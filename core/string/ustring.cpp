@@ -41,6 +41,14 @@
 
 #include <cstdint>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define USTRING_SSE2
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define USTRING_NEON
+#include <arm_neon.h>
+#endif
+
 #ifndef NO_USE_STDLIB
 #include <stdio.h>
 #include <stdlib.h>
@@ -64,6 +72,155 @@ const char CharString::_null = 0;
 const char16_t Char16String::_null = 0;
 const char32_t String::_null = 0;
 
+/* Bulk character routines */
+
+// x86-64 always has SSE2 and 64-bit ARM always has NEON, other targets use the scalar loops.
+// The vector loops only handle whole blocks, the scalar loops finish (or take over at a block
+// needing a closer look).
+
+// Returns the index of the first p_char in [p_from, p_to), or -1.
+static _FORCE_INLINE_ int _find_char(const char32_t *p_str, int p_from, int p_to, char32_t p_char) {
+	int i = p_from;
+#if defined(USTRING_SSE2)
+	const __m128i needle = _mm_set1_epi32(int(p_char));
+	for (; i + 4 <= p_to; i += 4) {
+		if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *)(p_str + i)), needle))) {
+			break;
+		}
+	}
+#elif defined(USTRING_NEON)
+	const uint32x4_t needle = vdupq_n_u32(p_char);
+	for (; i + 4 <= p_to; i += 4) {
+		if (vmaxvq_u32(vceqq_u32(vld1q_u32((const uint32_t *)(p_str + i)), needle))) {
+			break;
+		}
+	}
+#endif
+	for (; i < p_to; i++) {
+		if (p_str[i] == p_char) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+// Returns how many of the first p_len characters are ASCII.
+static _FORCE_INLINE_ int _count_ascii(const char32_t *p_str, int p_len) {
+	int i = 0;
+#if defined(USTRING_SSE2)
+	const __m128i non_ascii = _mm_set1_epi32(~0x7f);
+	const __m128i zero = _mm_setzero_si128();
+	for (; i + 4 <= p_len; i += 4) {
+		__m128i chars = _mm_loadu_si128((const __m128i *)(p_str + i));
+		if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(chars, non_ascii), zero)) != 0xffff) {
+			break;
+		}
+	}
+#elif defined(USTRING_NEON)
+	for (; i + 4 <= p_len; i += 4) {
+		if (vmaxvq_u32(vld1q_u32((const uint32_t *)(p_str + i))) > 0x7f) {
+			break;
+		}
+	}
+#endif
+	while (i < p_len && p_str[i] <= 0x7f) {
+		i++;
+	}
+	return i;
+}
+
+// Returns how many of the first p_len bytes are ASCII, stopping at a null byte.
+static _FORCE_INLINE_ int _count_ascii_utf8(const char *p_str, int p_len) {
+	int i = 0;
+#if defined(USTRING_SSE2)
+	const __m128i zero = _mm_setzero_si128();
+	for (; i + 16 <= p_len; i += 16) {
+		// Non-ASCII bytes have their sign bit set.
+		__m128i bytes = _mm_loadu_si128((const __m128i *)(p_str + i));
+		if (_mm_movemask_epi8(bytes) | _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, zero))) {
+			break;
+		}
+	}
+#elif defined(USTRING_NEON)
+	for (; i + 16 <= p_len; i += 16) {
+		uint8x16_t bytes = vld1q_u8((const uint8_t *)(p_str + i));
+		if (vmaxvq_u8(bytes) > 0x7f || vminvq_u8(bytes) == 0) {
+			break;
+		}
+	}
+#endif
+	while (i < p_len) {
+		uint8_t c = p_str[i];
+		if (c == 0 || c > 0x7f) {
+			break;
+		}
+		i++;
+	}
+	return i;
+}
+
+// Copies ASCII bytes to characters.
+static _FORCE_INLINE_ void _widen_ascii(const char *p_src, char32_t *p_dst, int p_len) {
+	int i = 0;
+#if defined(USTRING_SSE2)
+	const __m128i zero = _mm_setzero_si128();
+	for (; i + 16 <= p_len; i += 16) {
+		__m128i bytes = _mm_loadu_si128((const __m128i *)(p_src + i));
+		__m128i low = _mm_unpacklo_epi8(bytes, zero);
+		__m128i high = _mm_unpackhi_epi8(bytes, zero);
+		_mm_storeu_si128((__m128i *)(p_dst + i), _mm_unpacklo_epi16(low, zero));
+		_mm_storeu_si128((__m128i *)(p_dst + i + 4), _mm_unpackhi_epi16(low, zero));
+		_mm_storeu_si128((__m128i *)(p_dst + i + 8), _mm_unpacklo_epi16(high, zero));
+		_mm_storeu_si128((__m128i *)(p_dst + i + 12), _mm_unpackhi_epi16(high, zero));
+	}
+#elif defined(USTRING_NEON)
+	for (; i + 16 <= p_len; i += 16) {
+		uint8x16_t bytes = vld1q_u8((const uint8_t *)(p_src + i));
+		uint16x8_t low = vmovl_u8(vget_low_u8(bytes));
+		uint16x8_t high = vmovl_u8(vget_high_u8(bytes));
+		vst1q_u32((uint32_t *)(p_dst + i), vmovl_u16(vget_low_u16(low)));
+		vst1q_u32((uint32_t *)(p_dst + i + 4), vmovl_u16(vget_high_u16(low)));
+		vst1q_u32((uint32_t *)(p_dst + i + 8), vmovl_u16(vget_low_u16(high)));
+		vst1q_u32((uint32_t *)(p_dst + i + 12), vmovl_u16(vget_high_u16(high)));
+	}
+#endif
+	for (; i < p_len; i++) {
+		p_dst[i] = uint8_t(p_src[i]);
+	}
+}
+
+// Copies ASCII characters to bytes.
+static _FORCE_INLINE_ void _narrow_ascii(const char32_t *p_src, uint8_t *p_dst, int p_len) {
+	int i = 0;
+#if defined(USTRING_SSE2)
+	for (; i + 16 <= p_len; i += 16) {
+		// No saturation happens, all values are below 0x80.
+		__m128i low = _mm_packs_epi32(_mm_loadu_si128((const __m128i *)(p_src + i)), _mm_loadu_si128((const __m128i *)(p_src + i + 4)));
+		__m128i high = _mm_packs_epi32(_mm_loadu_si128((const __m128i *)(p_src + i + 8)), _mm_loadu_si128((const __m128i *)(p_src + i + 12)));
+		_mm_storeu_si128((__m128i *)(p_dst + i), _mm_packus_epi16(low, high));
+	}
+#elif defined(USTRING_NEON)
+	for (; i + 16 <= p_len; i += 16) {
+		const uint32_t *src = (const uint32_t *)(p_src + i);
+		uint16x8_t low = vcombine_u16(vmovn_u32(vld1q_u32(src)), vmovn_u32(vld1q_u32(src + 4)));
+		uint16x8_t high = vcombine_u16(vmovn_u32(vld1q_u32(src + 8)), vmovn_u32(vld1q_u32(src + 12)));
+		vst1q_u8(p_dst + i, vcombine_u8(vmovn_u16(low), vmovn_u16(high)));
+	}
+#endif
+	for (; i < p_len; i++) {
+		p_dst[i] = uint8_t(p_src[i]);
+	}
+}
+
+// The case tables are binary searched, most text doesn't need to.
+static _FORCE_INLINE_ char32_t _find_lower_fast(char32_t p_char) {
+	return p_char < 0x80 ? LOWERCASE(p_char) : _find_lower(p_char);
+}
+
+static _FORCE_INLINE_ char32_t _find_upper_fast(char32_t p_char) {
+	return p_char < 0x80 ? UPPERCASE(p_char) : _find_upper(p_char);
+}
+
 bool is_symbol(char32_t c) {
 	return c != '_' && ((c >= '!' && c <= '/') || (c >= ':' && c <= '@') || (c >= '[' && c <= '`') || (c >= '{' && c <= '~') || c == '\t' || c == ' ');
 }
@@ -642,6 +799,9 @@ bool String::operator==(const char32_t *p_str) const {
 }
 
 bool String::operator==(const String &p_str) const {
+	if (_cowdata._ptr == p_str._cowdata._ptr) {
+		return true; // Copies share their buffer.
+	}
 	if (length() != p_str.length()) {
 		return false;
 	}
@@ -649,6 +809,13 @@ bool String::operator==(const String &p_str) const {
 		return true;
 	}
 
+	// Strings hashed before, like dictionary keys, differ when their hashes do.
+	uint32_t hashv = _cowdata._get_hash_cache()->get();
+	uint32_t other_hashv = p_str._cowdata._get_hash_cache()->get();
+	if (hashv && other_hashv && hashv != other_hashv) {
+		return false;
+	}
+
 	int l = length();
 
 	const char32_t *src = get_data();
@@ -1333,28 +1500,44 @@ char32_t String::char_lowercase(char32_t p_char) {
 }
 
 String String::to_upper() const {
-	String upper = *this;
+	const char32_t *src = get_data();
+	const int len = length();
 
-	for (int i = 0; i < upper.size(); i++) {
-		const char32_t s = upper[i];
-		const char32_t t = _find_upper(s);
-		if (s != t) { // avoid copy on write
-			upper[i] = t;
-		}
+	// Only copy on write once something changes.
+	int i = 0;
+	while (i < len && _find_upper_fast(src[i]) == src[i]) {
+		i++;
+	}
+	if (i == len) {
+		return *this;
+	}
+
+	String upper = *this;
+	char32_t *dst = upper.ptrw();
+	for (; i < len; i++) {
+		dst[i] = _find_upper_fast(dst[i]);
 	}
 
 	return upper;
 }
 
 String String::to_lower() const {
-	String lower = *this;
+	const char32_t *src = get_data();
+	const int len = length();
 
-	for (int i = 0; i < lower.size(); i++) {
-		const char32_t s = lower[i];
-		const char32_t t = _find_lower(s);
-		if (s != t) { // avoid copy on write
-			lower[i] = t;
-		}
+	// Only copy on write once something changes.
+	int i = 0;
+	while (i < len && _find_lower_fast(src[i]) == src[i]) {
+		i++;
+	}
+	if (i == len) {
+		return *this;
+	}
+
+	String lower = *this;
+	char32_t *dst = lower.ptrw();
+	for (; i < len; i++) {
+		dst[i] = _find_lower_fast(dst[i]);
 	}
 
 	return lower;
@@ -1805,12 +1988,24 @@ bool String::parse_utf8(const char *p_utf8, int p_len) {
 		}
 	}
 
+	if (p_len < 0) {
+		p_len = strlen(p_utf8);
+	}
+
 	{
 		const char *ptrtmp = p_utf8;
 		const char *ptrtmp_limit = &p_utf8[p_len];
 		int skip = 0;
 		while (ptrtmp != ptrtmp_limit && *ptrtmp) {
 			if (skip == 0) {
+				int ascii = _count_ascii_utf8(ptrtmp, ptrtmp_limit - ptrtmp);
+				if (ascii) {
+					str_size += ascii;
+					cstr_size += ascii;
+					ptrtmp += ascii;
+					continue;
+				}
+
 				uint8_t c = *ptrtmp >= 0 ? *ptrtmp : uint8_t(256 + *ptrtmp);
 
 				/* Determine the number of characters in sequence */
@@ -1858,6 +2053,15 @@ bool String::parse_utf8(const char *p_utf8, int p_len) {
 	dst[str_size] = 0;
 
 	while (cstr_size) {
+		int ascii = _count_ascii_utf8(p_utf8, cstr_size);
+		if (ascii) {
+			_widen_ascii(p_utf8, dst, ascii);
+			dst += ascii;
+			cstr_size -= ascii;
+			p_utf8 += ascii;
+			continue;
+		}
+
 		int len = 0;
 
 		/* Determine the number of characters in sequence */
@@ -1928,6 +2132,13 @@ CharString String::utf8() const {
 	const char32_t *d = &operator[](0);
 	int fl = 0;
 	for (int i = 0; i < l; i++) {
+		int ascii = _count_ascii(d + i, l - i);
+		fl += ascii;
+		i += ascii;
+		if (i == l) {
+			break;
+		}
+
 		uint32_t c = d[i];
 		if (c <= 0x7f) { // 7 bits.
 			fl += 1;
@@ -1958,6 +2169,14 @@ CharString String::utf8() const {
 #define APPEND_CHAR(m_c) *(cdst++) = m_c
 
 	for (int i = 0; i < l; i++) {
+		int ascii = _count_ascii(d + i, l - i);
+		_narrow_ascii(d + i, cdst, ascii);
+		cdst += ascii;
+		i += ascii;
+		if (i == l) {
+			break;
+		}
+
 		uint32_t c = d[i];
 
 		if (c <= 0x7f) { // 7 bits.
@@ -2729,6 +2948,15 @@ uint32_t String::hash(const char32_t *p_cstr) {
 }
 
 uint32_t String::hash() const {
+	// Cached in the buffer, shared by all copies, until it's written to.
+	SafeNumeric<uint32_t> *cache = _cowdata._get_hash_cache();
+	if (cache) {
+		uint32_t cached = cache->get();
+		if (cached) {
+			return cached;
+		}
+	}
+
 	/* simple djb2 hashing */
 
 	const char32_t *chr = get_data();
@@ -2739,6 +2967,9 @@ uint32_t String::hash() const {
 		hashv = ((hashv << 5) + hashv) + c; /* hash * 33 + c */
 	}
 
+	if (cache) {
+		cache->set(hashv);
+	}
 	return hashv;
 }
 
@@ -2876,24 +3107,11 @@ int String::find(const String &p_str, int p_from) const {
 
 	const char32_t *src = get_data();
 	const char32_t *str = p_str.get_data();
+	const int last = len - src_len;
 
-	for (int i = p_from; i <= (len - src_len); i++) {
-		bool found = true;
-		for (int j = 0; j < src_len; j++) {
-			int read_pos = i + j;
-
-			if (read_pos >= len) {
-				ERR_PRINT("read_pos>=len");
-				return -1;
-			}
-
-			if (src[read_pos] != str[j]) {
-				found = false;
-				break;
-			}
-		}
-
-		if (found) {
+	// Scan for the first character, then compare the rest.
+	for (int i = _find_char(src, p_from, last + 1, str[0]); i != -1; i = _find_char(src, i + 1, last + 1, str[0])) {
+		if (memcmp(src + i + 1, str + 1, (src_len - 1) * sizeof(char32_t)) == 0) {
 			return i;
 		}
 	}
@@ -2919,35 +3137,25 @@ int String::find(const char *p_str, int p_from) const {
 		src_len++;
 	}
 
-	if (src_len == 1) {
-		const char32_t needle = p_str[0];
-
-		for (int i = p_from; i < len; i++) {
-			if (src[i] == needle) {
-				return i;
-			}
-		}
+	if (src_len == 0) {
+		return p_from <= len ? p_from : -1;
+	}
 
-	} else {
-		for (int i = p_from; i <= (len - src_len); i++) {
-			bool found = true;
-			for (int j = 0; j < src_len; j++) {
-				int read_pos = i + j;
+	const char32_t first = (char32_t)p_str[0];
+	const int last = len - src_len;
 
-				if (read_pos >= len) {
-					ERR_PRINT("read_pos>=len");
-					return -1;
-				}
-
-				if (src[read_pos] != (char32_t)p_str[j]) {
-					found = false;
-					break;
-				}
+	// Scan for the first character, then compare the rest.
+	for (int i = _find_char(src, p_from, last + 1, first); i != -1; i = _find_char(src, i + 1, last + 1, first)) {
+		bool found = true;
+		for (int j = 1; j < src_len; j++) {
+			if (src[i + j] != (char32_t)p_str[j]) {
+				found = false;
+				break;
 			}
+		}
 
-			if (found) {
-				return i;
-			}
+		if (found) {
+			return i;
 		}
 	}
 
@@ -2955,7 +3163,11 @@ int String::find(const char *p_str, int p_from) const {
 }
 
 int String::find_char(const char32_t &p_char, int p_from) const {
-	return _cowdata.find(p_char, p_from);
+	if (p_from < 0) {
+		return -1;
+	}
+	// Searches the null terminator as well, like CowData::find().
+	return _find_char(get_data(), p_from, size(), p_char);
 }
 
 int String::findmk(const Vector<String> &p_keys, int p_from, int *r_key) const {
@@ -3025,21 +3237,17 @@ int String::findn(const String &p_str, int p_from) const {
 	}
 
 	const char32_t *srcd = get_data();
+	const String needle = p_str.to_lower();
+	const char32_t *str = needle.get_data();
 
 	for (int i = p_from; i <= (length() - src_len); i++) {
-		bool found = true;
-		for (int j = 0; j < src_len; j++) {
-			int read_pos = i + j;
-
-			if (read_pos >= length()) {
-				ERR_PRINT("read_pos>=length()");
-				return -1;
-			}
-
-			char32_t src = _find_lower(srcd[read_pos]);
-			char32_t dst = _find_lower(p_str[j]);
+		if (_find_lower_fast(srcd[i]) != str[0]) {
+			continue;
+		}
 
-			if (src != dst) {
+		bool found = true;
+		for (int j = 1; j < src_len; j++) {
+			if (_find_lower_fast(srcd[i + j]) != str[j]) {
 				found = false;
 				break;
 			}
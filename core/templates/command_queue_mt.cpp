@@ -33,12 +33,90 @@
 #include "core/config/project_settings.h"
 #include "core/os/os.h"
 
-void CommandQueueMT::lock() {
-	mutex.lock();
+thread_local CommandQueueMT::ProducerSlot CommandQueueMT::producer_slot;
+std::atomic<uint64_t> CommandQueueMT::free_producer_slots(UINT64_MAX);
+
+uint32_t CommandQueueMT::_acquire_producer_slot() {
+	uint64_t free_slots = free_producer_slots.load(std::memory_order_relaxed);
+	while (free_slots) {
+		uint32_t slot = 0;
+		while (!(free_slots & (uint64_t(1) << slot))) {
+			slot++;
+		}
+		if (free_producer_slots.compare_exchange_weak(free_slots, free_slots & ~(uint64_t(1) << slot), std::memory_order_acquire)) {
+			return slot;
+		}
+	}
+	return SHARED_PRODUCER_SLOT;
+}
+
+CommandQueueMT::ProducerSlot::~ProducerSlot() {
+	// The chunks of this slot stay with each queue, the next thread taking it keeps writing to them.
+	if (index < MAX_PRODUCER_SLOTS) {
+		free_producer_slots.fetch_or(uint64_t(1) << index, std::memory_order_release);
+	}
+}
+
+CommandQueueMT::Chunk *CommandQueueMT::_alloc_chunk(uint32_t p_size) {
+	Chunk *chunk = nullptr;
+	uint32_t capacity = MAX(uint32_t(CHUNK_SIZE_KB * 1024), p_size);
+	{
+		MutexLock lock(chunk_mutex);
+		if (capacity == CHUNK_SIZE_KB * 1024 && free_chunks.size()) {
+			chunk = free_chunks[free_chunks.size() - 1];
+			free_chunks.resize(free_chunks.size() - 1);
+		} else {
+			chunk = memnew_placement(memalloc(((sizeof(Chunk) + 8 - 1) & ~(8 - 1)) + capacity), Chunk);
+			chunk->capacity = capacity;
+			chunks.push_back(chunk);
+		}
+	}
+	chunk->used = 0;
+	chunk->refcount.set(1);
+	return chunk;
+}
+
+void CommandQueueMT::_free_chunk(Chunk *p_chunk) {
+	MutexLock lock(chunk_mutex);
+	if (p_chunk->capacity == CHUNK_SIZE_KB * 1024) {
+		free_chunks.push_back(p_chunk);
+	} else {
+		// Only made for a single large command.
+		chunks.erase(p_chunk);
+		memfree(p_chunk);
+	}
 }
 
-void CommandQueueMT::unlock() {
-	mutex.unlock();
+CommandQueueMT::CommandBase *CommandQueueMT::_pop() {
+	CommandBase *tail = queue_tail;
+	CommandBase *next = tail->next.load(std::memory_order_acquire);
+	if (tail == &queue_stub) {
+		if (!next) {
+			return nullptr;
+		}
+		queue_tail = next;
+		tail = next;
+		next = next->next.load(std::memory_order_acquire);
+	}
+
+	if (next) {
+		queue_tail = next;
+		return tail;
+	}
+
+	if (tail != queue_head.load(std::memory_order_acquire)) {
+		// A producer is in the middle of linking a command, it will run on the next flush.
+		return nullptr;
+	}
+
+	// The tail is the last command, put the stub behind it so it can be taken out.
+	_link(&queue_stub);
+	next = tail->next.load(std::memory_order_acquire);
+	if (next) {
+		queue_tail = next;
+		return tail;
+	}
+	return nullptr;
 }
 
 void CommandQueueMT::wait_for_flush() {
@@ -50,7 +128,7 @@ CommandQueueMT::SyncSemaphore *CommandQueueMT::_alloc_sync_sem() {
 	int idx = -1;
 
 	while (true) {
-		lock();
+		sync_sem_mutex.lock();
 		for (int i = 0; i < SYNC_SEMAPHORES; i++) {
 			if (!sync_sems[i].in_use) {
 				sync_sems[i].in_use = true;
@@ -58,7 +136,7 @@ CommandQueueMT::SyncSemaphore *CommandQueueMT::_alloc_sync_sem() {
 				break;
 			}
 		}
-		unlock();
+		sync_sem_mutex.unlock();
 
 		if (idx == -1) {
 			wait_for_flush();
@@ -71,12 +149,28 @@ CommandQueueMT::SyncSemaphore *CommandQueueMT::_alloc_sync_sem() {
 }
 
 CommandQueueMT::CommandQueueMT(bool p_sync) {
+	queue_stub.next.store(nullptr, std::memory_order_relaxed);
+	queue_head.store(&queue_stub, std::memory_order_relaxed);
+	queue_tail = &queue_stub;
+	sync_count.store(0, std::memory_order_relaxed);
+
 	if (p_sync) {
 		sync = memnew(Semaphore);
 	}
 }
 
 CommandQueueMT::~CommandQueueMT() {
+	// Commands never flushed are dropped.
+	CommandBase *cmd = _pop();
+	while (cmd) {
+		cmd->~CommandBase();
+		cmd = _pop();
+	}
+
+	for (uint32_t i = 0; i < chunks.size(); i++) {
+		memfree(chunks[i]);
+	}
+
 	if (sync) {
 		memdelete(sync);
 	}
@@ -36,9 +36,12 @@
 #include "core/os/semaphore.h"
 #include "core/string/print_string.h"
 #include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
 #include "core/templates/simple_type.h"
 #include "core/typedefs.h"
 
+#include <atomic>
+
 #define COMMA(N) _COMMA_##N
 #define _COMMA_0
 #define _COMMA_1 ,
@@ -250,13 +253,11 @@
 #define DECL_PUSH(N)                                                         \
 	template <class T, class M COMMA(N) COMMA_SEP_LIST(TYPE_PARAM, N)>       \
 	void push(T *p_instance, M p_method COMMA(N) COMMA_SEP_LIST(PARAM, N)) { \
-		CMD_TYPE(N) *cmd = allocate_and_lock<CMD_TYPE(N)>();                 \
+		CMD_TYPE(N) *cmd = allocate<CMD_TYPE(N)>();                          \
 		cmd->instance = p_instance;                                          \
 		cmd->method = p_method;                                              \
 		SEMIC_SEP_LIST(CMD_ASSIGN_PARAM, N);                                 \
-		unlock();                                                            \
-		if (sync)                                                            \
-			sync->post();                                                    \
+		commit(cmd);                                                         \
 	}
 
 #define CMD_RET_TYPE(N) CommandRet##N<T, M, COMMA_SEP_LIST(TYPE_ARG, N) COMMA(N) R>
@@ -265,15 +266,13 @@
 	template <class T, class M, COMMA_SEP_LIST(TYPE_PARAM, N) COMMA(N) class R>                \
 	void push_and_ret(T *p_instance, M p_method, COMMA_SEP_LIST(PARAM, N) COMMA(N) R *r_ret) { \
 		SyncSemaphore *ss = _alloc_sync_sem();                                                 \
-		CMD_RET_TYPE(N) *cmd = allocate_and_lock<CMD_RET_TYPE(N)>();                           \
+		CMD_RET_TYPE(N) *cmd = allocate<CMD_RET_TYPE(N)>();                                    \
 		cmd->instance = p_instance;                                                            \
 		cmd->method = p_method;                                                                \
 		SEMIC_SEP_LIST(CMD_ASSIGN_PARAM, N);                                                   \
 		cmd->ret = r_ret;                                                                      \
 		cmd->sync_sem = ss;                                                                    \
-		unlock();                                                                              \
-		if (sync)                                                                              \
-			sync->post();                                                                      \
+		commit(cmd);                                                                           \
 		ss->sem.wait();                                                                        \
 		ss->in_use = false;                                                                    \
 	}
@@ -284,27 +283,34 @@
 	template <class T, class M COMMA(N) COMMA_SEP_LIST(TYPE_PARAM, N)>                \
 	void push_and_sync(T *p_instance, M p_method COMMA(N) COMMA_SEP_LIST(PARAM, N)) { \
 		SyncSemaphore *ss = _alloc_sync_sem();                                        \
-		CMD_SYNC_TYPE(N) *cmd = allocate_and_lock<CMD_SYNC_TYPE(N)>();                \
+		CMD_SYNC_TYPE(N) *cmd = allocate<CMD_SYNC_TYPE(N)>();                         \
 		cmd->instance = p_instance;                                                   \
 		cmd->method = p_method;                                                       \
 		SEMIC_SEP_LIST(CMD_ASSIGN_PARAM, N);                                          \
 		cmd->sync_sem = ss;                                                           \
-		unlock();                                                                     \
-		if (sync)                                                                     \
-			sync->post();                                                             \
+		commit(cmd);                                                                  \
 		ss->sem.wait();                                                               \
 		ss->in_use = false;                                                           \
 	}
 
 #define MAX_CMD_PARAMS 15
 
+// Multiple producer, single consumer command queue.
+// Each producer thread writes commands to a chunk of its own, and links them to a lock-free list
+// shared by all producers, so commands run in the order they were pushed in across threads.
+// Pushing only takes a lock when a producer needs a new chunk.
 class CommandQueueMT {
 	struct SyncSemaphore {
 		Semaphore sem;
 		bool in_use = false;
 	};
 
+	struct Chunk;
+
 	struct CommandBase {
+		std::atomic<CommandBase *> next;
+		Chunk *chunk = nullptr;
+
 		virtual void call() = 0;
 		virtual void post() {}
 		virtual ~CommandBase() {}
@@ -318,6 +324,11 @@ class CommandQueueMT {
 		}
 	};
 
+	// Placeholder kept in the list, so producers never have to look at the consumer side.
+	struct StubCommand : public CommandBase {
+		virtual void call() {}
+	};
+
 	DECL_CMD(0)
 	SPACE_SEP_LIST(DECL_CMD, 15)
 
@@ -332,57 +343,126 @@ class CommandQueueMT {
 	/***** BASE *******/
 
 	enum {
-		DEFAULT_COMMAND_MEM_SIZE_KB = 256,
-		SYNC_SEMAPHORES = 8
+		CHUNK_SIZE_KB = 16,
+		SYNC_SEMAPHORES = 8,
+		MAX_PRODUCER_SLOTS = 64,
+		SHARED_PRODUCER_SLOT = MAX_PRODUCER_SLOTS, // Used by threads once all slots are taken, under a lock.
+	};
+
+	struct Chunk {
+		SafeNumeric<uint32_t> refcount; // Commands not run yet, plus one while a producer writes to it.
+		uint32_t capacity = 0;
+		uint32_t used = 0;
+
+		_FORCE_INLINE_ uint8_t *data() { return reinterpret_cast<uint8_t *>(this) + ((sizeof(Chunk) + 8 - 1) & ~(8 - 1)); }
+	};
+
+	struct ProducerSlot {
+		uint32_t index = UINT32_MAX; // Assigned on first push.
+		~ProducerSlot();
 	};
 
-	LocalVector<uint8_t> command_mem;
+	static thread_local ProducerSlot producer_slot;
+	static std::atomic<uint64_t> free_producer_slots;
+
+	static uint32_t _acquire_producer_slot();
+
+	Chunk *producer_chunks[MAX_PRODUCER_SLOTS + 1] = {};
+	Mutex shared_producer_mutex;
+
+	LocalVector<Chunk *> chunks;
+	LocalVector<Chunk *> free_chunks;
+	Mutex chunk_mutex;
+
+	std::atomic<CommandBase *> queue_head;
+	CommandBase *queue_tail = nullptr; // Only used by the consumer.
+	StubCommand queue_stub;
+	Mutex flush_mutex;
+
 	SyncSemaphore sync_sems[SYNC_SEMAPHORES];
-	Mutex mutex;
+	Mutex sync_sem_mutex;
+
 	Semaphore *sync = nullptr;
+	// Pushes not waited for yet, negative while the consumer sleeps. Producers only touch the semaphore then.
+	std::atomic<int32_t> sync_count;
+
+	Chunk *_alloc_chunk(uint32_t p_size);
+	void _free_chunk(Chunk *p_chunk);
+
+	_FORCE_INLINE_ void _release_chunk(Chunk *p_chunk) {
+		if (p_chunk->refcount.decrement() == 0) {
+			_free_chunk(p_chunk);
+		}
+	}
 
 	template <class T>
 	T *allocate() {
-		// alloc size is size+T+safeguard
+		// Commands are kept 8 byte aligned.
 		uint32_t alloc_size = ((sizeof(T) + 8 - 1) & ~(8 - 1));
-		uint64_t size = command_mem.size();
-		command_mem.resize(size + alloc_size + 8);
-		*(uint64_t *)&command_mem[size] = alloc_size;
-		T *cmd = memnew_placement(&command_mem[size + 8], T);
+
+		uint32_t slot = producer_slot.index;
+		if (unlikely(slot == UINT32_MAX)) {
+			slot = _acquire_producer_slot();
+			producer_slot.index = slot;
+		}
+		if (unlikely(slot == SHARED_PRODUCER_SLOT)) {
+			shared_producer_mutex.lock(); // Unlocked in commit().
+		}
+
+		Chunk *chunk = producer_chunks[slot];
+		if (unlikely(!chunk || chunk->used + alloc_size > chunk->capacity)) {
+			if (chunk) {
+				_release_chunk(chunk);
+			}
+			chunk = _alloc_chunk(alloc_size);
+			producer_chunks[slot] = chunk;
+		}
+
+		T *cmd = memnew_placement(chunk->data() + chunk->used, T);
+		cmd->chunk = chunk;
+		chunk->used += alloc_size;
+		chunk->refcount.increment();
 		return cmd;
 	}
 
-	template <class T>
-	T *allocate_and_lock() {
-		lock();
-		T *ret = allocate<T>();
-		return ret;
+	_FORCE_INLINE_ void _link(CommandBase *p_cmd) {
+		p_cmd->next.store(nullptr, std::memory_order_relaxed);
+		CommandBase *prev = queue_head.exchange(p_cmd, std::memory_order_acq_rel);
+		prev->next.store(p_cmd, std::memory_order_release);
 	}
 
-	void _flush() {
-		lock();
+	_FORCE_INLINE_ void commit(CommandBase *p_cmd) {
+		_link(p_cmd);
+		if (unlikely(producer_slot.index == SHARED_PRODUCER_SLOT)) {
+			shared_producer_mutex.unlock();
+		}
+		if (sync && sync_count.fetch_add(1, std::memory_order_acq_rel) < 0) {
+			sync->post();
+		}
+	}
 
-		uint64_t read_ptr = 0;
-		uint64_t limit = command_mem.size();
+	CommandBase *_pop();
 
-		while (read_ptr < limit) {
-			uint64_t size = *(uint64_t *)&command_mem[read_ptr];
-			read_ptr += 8;
-			CommandBase *cmd = reinterpret_cast<CommandBase *>(&command_mem[read_ptr]);
+	void _flush() {
+		MutexLock lock(flush_mutex);
+
+		CommandBase *cmd = _pop();
+		while (cmd) {
+			Chunk *chunk = cmd->chunk;
 
 			cmd->call(); //execute the function
 			cmd->post(); //release in case it needs sync/ret
 			cmd->~CommandBase(); //should be done, so erase the command
 
-			read_ptr += size;
+			_release_chunk(chunk);
+			cmd = _pop();
 		}
+	}
 
-		command_mem.clear();
-		unlock();
+	_FORCE_INLINE_ bool _has_pending() const {
+		return queue_tail != &queue_stub || queue_head.load(std::memory_order_acquire) != &queue_stub;
 	}
 
-	void lock();
-	void unlock();
 	void wait_for_flush();
 	SyncSemaphore *_alloc_sync_sem();
 
@@ -400,7 +480,7 @@ public:
 	SPACE_SEP_LIST(DECL_PUSH_AND_SYNC, 15)
 
 	_FORCE_INLINE_ void flush_if_pending() {
-		if (unlikely(command_mem.size() > 0)) {
+		if (unlikely(_has_pending())) {
 			_flush();
 		}
 	}
@@ -410,7 +490,9 @@ public:
 
 	void wait_and_flush() {
 		ERR_FAIL_COND(!sync);
-		sync->wait();
+		if (sync_count.fetch_sub(1, std::memory_order_acq_rel) <= 0) {
+			sync->wait();
+		}
 		_flush();
 	}
 
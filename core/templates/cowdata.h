@@ -36,6 +36,7 @@
 #include "core/templates/safe_refcount.h"
 
 #include <string.h>
+#include <type_traits>
 
 template <class T>
 class Vector;
@@ -60,10 +61,30 @@ class CowData {
 	friend class VMap;
 
 private:
+	// Allocations start with a header, 16 bytes so elements stay aligned:
+	// [unused (4)][hash cache (4)][refcount (4)][size (4)]
+	enum {
+		HEADER_SIZE = 16
+	};
+
 	mutable T *_ptr = nullptr;
 
 	// internal helpers
 
+	static _FORCE_INLINE_ uint32_t *_alloc(size_t p_bytes) {
+		uint8_t *mem = (uint8_t *)Memory::alloc_static(p_bytes + HEADER_SIZE);
+		return mem ? (uint32_t *)(mem + HEADER_SIZE) : nullptr;
+	}
+
+	static _FORCE_INLINE_ uint32_t *_realloc(T *p_ptr, size_t p_bytes) {
+		uint8_t *mem = (uint8_t *)Memory::realloc_static((uint8_t *)p_ptr - HEADER_SIZE, p_bytes + HEADER_SIZE);
+		return mem ? (uint32_t *)(mem + HEADER_SIZE) : nullptr;
+	}
+
+	static _FORCE_INLINE_ void _free(void *p_ptr) {
+		Memory::free_static((uint8_t *)p_ptr - HEADER_SIZE);
+	}
+
 	_FORCE_INLINE_ SafeNumeric<uint32_t> *_get_refcount() const {
 		if (!_ptr) {
 			return nullptr;
@@ -80,6 +101,15 @@ private:
 		return reinterpret_cast<uint32_t *>(_ptr) - 1;
 	}
 
+	// Used by String, which caches its hash in the shared buffer. 0 when not computed yet.
+	_FORCE_INLINE_ SafeNumeric<uint32_t> *_get_hash_cache() const {
+		if (!_ptr) {
+			return nullptr;
+		}
+
+		return reinterpret_cast<SafeNumeric<uint32_t> *>(_ptr) - 3;
+	}
+
 	_FORCE_INLINE_ T *_get_data() const {
 		if (!_ptr) {
 			return nullptr;
@@ -214,7 +244,7 @@ void CowData<T>::_unref(void *p_data) {
 	}
 
 	// free mem
-	Memory::free_static((uint8_t *)p_data, true);
+	_free(p_data);
 }
 
 template <class T>
@@ -230,8 +260,9 @@ uint32_t CowData<T>::_copy_on_write() {
 		/* in use by more than me */
 		uint32_t current_size = *_get_size();
 
-		uint32_t *mem_new = (uint32_t *)Memory::alloc_static(_get_alloc_size(current_size), true);
+		uint32_t *mem_new = _alloc(_get_alloc_size(current_size));
 
+		new (mem_new - 3, sizeof(uint32_t), "") SafeNumeric<uint32_t>(0); //hash cache
 		new (mem_new - 2, sizeof(uint32_t), "") SafeNumeric<uint32_t>(1); //refcount
 		*(mem_new - 1) = current_size; //size
 
@@ -251,6 +282,8 @@ uint32_t CowData<T>::_copy_on_write() {
 		_ptr = _data;
 
 		rc = 1;
+	} else if (std::is_same<T, char32_t>::value) {
+		_get_hash_cache()->set(0); // About to be written.
 	}
 	return rc;
 }
@@ -283,15 +316,16 @@ Error CowData<T>::resize(int p_size) {
 		if (alloc_size != current_alloc_size) {
 			if (current_size == 0) {
 				// alloc from scratch
-				uint32_t *ptr = (uint32_t *)Memory::alloc_static(alloc_size, true);
+				uint32_t *ptr = _alloc(alloc_size);
 				ERR_FAIL_COND_V(!ptr, ERR_OUT_OF_MEMORY);
 				*(ptr - 1) = 0; //size, currently none
 				new (ptr - 2, sizeof(uint32_t), "") SafeNumeric<uint32_t>(1); //refcount
+				new (ptr - 3, sizeof(uint32_t), "") SafeNumeric<uint32_t>(0); //hash cache
 
 				_ptr = (T *)ptr;
 
 			} else {
-				uint32_t *_ptrnew = (uint32_t *)Memory::realloc_static(_ptr, alloc_size, true);
+				uint32_t *_ptrnew = _realloc(_ptr, alloc_size);
 				ERR_FAIL_COND_V(!_ptrnew, ERR_OUT_OF_MEMORY);
 				new (_ptrnew - 2, sizeof(uint32_t), "") SafeNumeric<uint32_t>(rc); //refcount
 
@@ -321,7 +355,7 @@ Error CowData<T>::resize(int p_size) {
 		}
 
 		if (alloc_size != current_alloc_size) {
-			uint32_t *_ptrnew = (uint32_t *)Memory::realloc_static(_ptr, alloc_size, true);
+			uint32_t *_ptrnew = _realloc(_ptr, alloc_size);
 			ERR_FAIL_COND_V(!_ptrnew, ERR_OUT_OF_MEMORY);
 			new (_ptrnew - 2, sizeof(uint32_t), "") SafeNumeric<uint32_t>(rc); //refcount
 
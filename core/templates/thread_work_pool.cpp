@@ -34,6 +34,9 @@
 
 void ThreadWorkPool::_thread_function(void *p_user) {
 	ThreadData *thread = static_cast<ThreadData *>(p_user);
+	if (thread->realtime && Thread::set_realtime() != OK) {
+		WARN_PRINT_ONCE("Couldn't give worker threads real-time priority, they will use the default scheduling.");
+	}
 	while (true) {
 		thread->start.wait();
 		if (thread->exit.load()) {
@@ -44,7 +47,7 @@ void ThreadWorkPool::_thread_function(void *p_user) {
 	}
 }
 
-void ThreadWorkPool::init(int p_thread_count) {
+void ThreadWorkPool::init(int p_thread_count, bool p_realtime) {
 	ERR_FAIL_COND(threads != nullptr);
 	if (p_thread_count < 0) {
 		p_thread_count = OS::get_singleton()->get_processor_count();
@@ -55,6 +58,7 @@ void ThreadWorkPool::init(int p_thread_count) {
 
 	for (uint32_t i = 0; i < thread_count; i++) {
 		threads[i].exit.store(false);
+		threads[i].realtime = p_realtime;
 		threads[i].thread.start(&ThreadWorkPool::_thread_function, &threads[i]);
 	}
 }
@@ -36,6 +36,7 @@
 #include "core/os/thread.h"
 
 #include <atomic>
+#include <cstddef>
 
 class ThreadWorkPool {
 	std::atomic<uint32_t> index;
@@ -69,11 +70,20 @@ class ThreadWorkPool {
 		Semaphore completed;
 		std::atomic<bool> exit;
 		BaseWork *work;
+		bool realtime = false;
 	};
 
+	// Small works are built in place so dispatching doesn't touch the heap,
+	// which matters for callers on real-time threads like the audio mixer.
+	enum {
+		WORK_STORAGE_SIZE = 64
+	};
+	alignas(std::max_align_t) uint8_t work_storage[WORK_STORAGE_SIZE];
+
 	ThreadData *threads = nullptr;
 	uint32_t thread_count = 0;
 	BaseWork *current_work = nullptr;
+	bool current_work_in_storage = false;
 
 	static void _thread_function(void *p_user);
 
@@ -85,7 +95,15 @@ public:
 
 		index.store(0, std::memory_order_release);
 
-		Work<C, M, U> *w = memnew((Work<C, M, U>));
+		typedef Work<C, M, U> WorkType;
+		WorkType *w;
+		if constexpr (sizeof(WorkType) <= WORK_STORAGE_SIZE && alignof(WorkType) <= alignof(std::max_align_t)) {
+			w = memnew_placement(work_storage, WorkType);
+			current_work_in_storage = true;
+		} else {
+			w = memnew(WorkType);
+			current_work_in_storage = false;
+		}
 		w->instance = p_instance;
 		w->userdata = p_userdata;
 		w->method = p_method;
@@ -122,7 +140,11 @@ public:
 			threads[i].work = nullptr;
 		}
 
-		memdelete(current_work);
+		if (current_work_in_storage) {
+			current_work->~BaseWork();
+		} else {
+			memdelete(current_work);
+		}
 		current_work = nullptr;
 	}
 
@@ -133,7 +155,8 @@ public:
 	}
 
 	_FORCE_INLINE_ int get_thread_count() const { return thread_count; }
-	void init(int p_thread_count = -1);
+	// p_realtime asks for real-time scheduling of the workers, see Thread::set_realtime().
+	void init(int p_thread_count = -1, bool p_realtime = false);
 	void finish();
 	~ThreadWorkPool();
 };
@@ -39,6 +39,8 @@
 #include <pthread_np.h>
 #endif
 
+#include <sched.h>
+
 static Error set_name(const String &p_name) {
 #ifdef PTHREAD_NO_RENAME
 	return ERR_UNAVAILABLE;
@@ -69,8 +71,16 @@ static Error set_name(const String &p_name) {
 #endif // PTHREAD_NO_RENAME
 }
 
+static Error set_realtime() {
+	// Needs privileges (CAP_SYS_NICE or an RLIMIT_RTPRIO allowance), the policy is left as is otherwise.
+	sched_param param;
+	param.sched_priority = sched_get_priority_min(SCHED_FIFO) + 1;
+	int err = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+	return err == 0 ? OK : ERR_UNAUTHORIZED;
+}
+
 void init_thread_posix() {
-	Thread::_set_platform_funcs(&set_name, nullptr);
+	Thread::_set_platform_funcs(&set_name, nullptr, nullptr, nullptr, &set_realtime);
 }
 
 #endif
@@ -31,6 +31,7 @@
 #include "resource_importer_scene.h"
 
 #include "core/io/resource_saver.h"
+#include "core/templates/thread_work_pool.h"
 #include "editor/editor_node.h"
 #include "editor/import/scene_import_settings.h"
 #include "editor/import/scene_importer_mesh_node_3d.h"
@@ -1056,6 +1057,7 @@ void ResourceImporterScene::get_import_options(List<ImportOption> *r_options, in
 	r_options->push_back(ImportOption(PropertyInfo(Variant::FLOAT, "nodes/root_scale", PROPERTY_HINT_RANGE, "0.001,1000,0.001"), 1.0));
 	r_options->push_back(ImportOption(PropertyInfo(Variant::BOOL, "meshes/ensure_tangents"), true));
 	r_options->push_back(ImportOption(PropertyInfo(Variant::BOOL, "meshes/generate_lods"), true));
+	r_options->push_back(ImportOption(PropertyInfo(Variant::BOOL, "meshes/optimize_vertex_order"), true));
 	r_options->push_back(ImportOption(PropertyInfo(Variant::BOOL, "meshes/create_shadow_meshes"), true));
 	r_options->push_back(ImportOption(PropertyInfo(Variant::INT, "meshes/light_baking", PROPERTY_HINT_ENUM, "Disabled,Dynamic,Static,Static Lightmaps", PROPERTY_USAGE_DEFAULT | PROPERTY_USAGE_UPDATE_ALL_IF_MODIFIED), 2));
 	r_options->push_back(ImportOption(PropertyInfo(Variant::FLOAT, "meshes/lightmap_texel_size", PROPERTY_HINT_RANGE, "0.001,100,0.001"), 0.1));
@@ -1136,7 +1138,79 @@ Ref<Animation> ResourceImporterScene::import_animation_from_other_importer(Edito
 	return importer->import_animation(p_path, p_flags, p_bake_fps);
 }
 
-void ResourceImporterScene::_generate_meshes(Node *p_node, const Dictionary &p_mesh_data, bool p_generate_lods, bool p_create_shadow_meshes, LightBakeMode p_light_bake_mode, float p_lightmap_texel_size, const Vector<uint8_t> &p_src_lightmap_cache, Vector<Vector<uint8_t>> &r_lightmap_caches) {
+void ResourceImporterScene::_collect_mesh_surface_tasks(Node *p_node, const Dictionary &p_mesh_data, bool p_generate_lods, bool p_optimize_vertex_order, LightBakeMode p_light_bake_mode, Set<Ref<EditorSceneImporterMesh>> &r_visited, LocalVector<MeshSurfaceTask> &r_tasks) {
+	EditorSceneImporterMeshNode3D *src_mesh_node = Object::cast_to<EditorSceneImporterMeshNode3D>(p_node);
+	if (src_mesh_node) {
+		Ref<EditorSceneImporterMesh> mesh = src_mesh_node->get_mesh();
+		if (mesh.is_valid() && !mesh->has_mesh() && !r_visited.has(mesh)) {
+			r_visited.insert(mesh);
+
+			bool generate_lods = p_generate_lods;
+			bool bake_lightmaps = p_light_bake_mode == LIGHT_BAKE_STATIC_LIGHTMAPS;
+
+			String mesh_id;
+			if (mesh->has_meta("import_id")) {
+				mesh_id = mesh->get_meta("import_id");
+			} else {
+				mesh_id = mesh->get_name();
+			}
+
+			if (mesh_id != String() && p_mesh_data.has(mesh_id)) {
+				Dictionary mesh_settings = p_mesh_data[mesh_id];
+				if (mesh_settings.has("generate/lods")) {
+					int lods = mesh_settings["generate/lods"];
+					if (lods == MESH_OVERRIDE_ENABLE) {
+						generate_lods = true;
+					} else if (lods == MESH_OVERRIDE_DISABLE) {
+						generate_lods = false;
+					}
+				}
+
+				if (mesh_settings.has("generate/lightmap_uv")) {
+					int lightmap_uv = mesh_settings["generate/lightmap_uv"];
+					if (lightmap_uv == MESH_OVERRIDE_ENABLE) {
+						bake_lightmaps = true;
+					} else if (lightmap_uv == MESH_OVERRIDE_DISABLE) {
+						bake_lightmaps = false;
+					}
+				}
+			}
+
+			// Unwrapping for lightmaps rebuilds the vertex and index arrays afterwards,
+			// which discards the optimized order, so don't spend time on it.
+			bool optimize_vertex_order = p_optimize_vertex_order && !bake_lightmaps;
+
+			if (generate_lods || optimize_vertex_order) {
+				// The tasks write to the surfaces from several threads, copy them here if they're shared.
+				mesh->make_surfaces_unique();
+				for (int i = 0; i < mesh->get_surface_count(); i++) {
+					MeshSurfaceTask task;
+					task.mesh = mesh;
+					task.surface = i;
+					task.generate_lods = generate_lods;
+					task.optimize_vertex_order = optimize_vertex_order;
+					r_tasks.push_back(task);
+				}
+			}
+		}
+	}
+
+	for (int i = 0; i < p_node->get_child_count(); i++) {
+		_collect_mesh_surface_tasks(p_node->get_child(i), p_mesh_data, p_generate_lods, p_optimize_vertex_order, p_light_bake_mode, r_visited, r_tasks);
+	}
+}
+
+void ResourceImporterScene::_process_mesh_surface_task(uint32_t p_index, MeshSurfaceTask *p_tasks) {
+	MeshSurfaceTask &task = p_tasks[p_index];
+	if (task.generate_lods) {
+		task.mesh->generate_surface_lods(task.surface);
+	}
+	if (task.optimize_vertex_order) {
+		task.mesh->optimize_surface_vertex_order(task.surface);
+	}
+}
+
+void ResourceImporterScene::_generate_meshes(Node *p_node, const Dictionary &p_mesh_data, bool p_create_shadow_meshes, LightBakeMode p_light_bake_mode, float p_lightmap_texel_size, const Vector<uint8_t> &p_src_lightmap_cache, Vector<Vector<uint8_t>> &r_lightmap_caches) {
 	EditorSceneImporterMeshNode3D *src_mesh_node = Object::cast_to<EditorSceneImporterMeshNode3D>(p_node);
 	if (src_mesh_node) {
 		//is mesh
@@ -1150,7 +1224,6 @@ void ResourceImporterScene::_generate_meshes(Node *p_node, const Dictionary &p_m
 			if (!src_mesh_node->get_mesh()->has_mesh()) {
 				//do mesh processing
 
-				bool generate_lods = p_generate_lods;
 				bool create_shadow_meshes = p_create_shadow_meshes;
 				bool bake_lightmaps = p_light_bake_mode == LIGHT_BAKE_STATIC_LIGHTMAPS;
 				String save_to_file;
@@ -1184,15 +1257,6 @@ void ResourceImporterScene::_generate_meshes(Node *p_node, const Dictionary &p_m
 						}
 					}
 
-					if (mesh_settings.has("generate/lods")) {
-						int lods = mesh_settings["generate/lods"];
-						if (lods == MESH_OVERRIDE_ENABLE) {
-							generate_lods = true;
-						} else if (lods == MESH_OVERRIDE_DISABLE) {
-							generate_lods = false;
-						}
-					}
-
 					if (mesh_settings.has("save_to_file/enabled") && bool(mesh_settings["save_to_file/enabled"]) && mesh_settings.has("save_to_file/path")) {
 						save_to_file = mesh_settings["save_to_file/path"];
 						if (!save_to_file.is_resource_file()) {
@@ -1201,9 +1265,6 @@ void ResourceImporterScene::_generate_meshes(Node *p_node, const Dictionary &p_m
 					}
 				}
 
-				if (generate_lods) {
-					src_mesh_node->get_mesh()->generate_lods();
-				}
 				if (create_shadow_meshes) {
 					src_mesh_node->get_mesh()->create_shadow_mesh();
 				}
@@ -1286,7 +1347,7 @@ void ResourceImporterScene::_generate_meshes(Node *p_node, const Dictionary &p_m
 	}
 
 	for (int i = 0; i < p_node->get_child_count(); i++) {
-		_generate_meshes(p_node->get_child(i), p_mesh_data, p_generate_lods, p_create_shadow_meshes, p_light_bake_mode, p_lightmap_texel_size, p_src_lightmap_cache, r_lightmap_caches);
+		_generate_meshes(p_node->get_child(i), p_mesh_data, p_create_shadow_meshes, p_light_bake_mode, p_lightmap_texel_size, p_src_lightmap_cache, r_lightmap_caches);
 	}
 }
 
@@ -1448,6 +1509,7 @@ Error ResourceImporterScene::import(const String &p_source_file, const String &p
 	}
 
 	bool gen_lods = bool(p_options["meshes/generate_lods"]);
+	bool optimize_vertex_order = bool(p_options["meshes/optimize_vertex_order"]);
 	bool create_shadow_meshes = bool(p_options["meshes/create_shadow_meshes"]);
 	int light_bake_mode = p_options["meshes/light_baking"];
 	float texel_size = p_options["meshes/lightmap_texel_size"];
@@ -1467,7 +1529,22 @@ Error ResourceImporterScene::import(const String &p_source_file, const String &p
 	if (subresources.has("meshes")) {
 		mesh_data = subresources["meshes"];
 	}
-	_generate_meshes(scene, mesh_data, gen_lods, create_shadow_meshes, LightBakeMode(light_bake_mode), lightmap_texel_size, src_lightmap_cache, mesh_lightmap_caches);
+	{
+		// LOD generation and vertex order optimization only touch one surface each,
+		// so all the surfaces of all the meshes are processed in parallel.
+		Set<Ref<EditorSceneImporterMesh>> visited;
+		LocalVector<MeshSurfaceTask> mesh_surface_tasks;
+		_collect_mesh_surface_tasks(scene, mesh_data, gen_lods, optimize_vertex_order, LightBakeMode(light_bake_mode), visited, mesh_surface_tasks);
+
+		if (mesh_surface_tasks.size()) {
+			ThreadWorkPool work_pool;
+			work_pool.init();
+			work_pool.do_work(mesh_surface_tasks.size(), this, &ResourceImporterScene::_process_mesh_surface_task, mesh_surface_tasks.ptr());
+			work_pool.finish();
+		}
+	}
+
+	_generate_meshes(scene, mesh_data, create_shadow_meshes, LightBakeMode(light_bake_mode), lightmap_texel_size, src_lightmap_cache, mesh_lightmap_caches);
 
 	if (mesh_lightmap_caches.size()) {
 		FileAccessRef f = FileAccess::open(p_source_file + ".unwrap_cache", FileAccess::WRITE);
@@ -32,6 +32,7 @@
 #define RESOURCEIMPORTERSCENE_H
 
 #include "core/io/resource_importer.h"
+#include "core/templates/local_vector.h"
 #include "scene/3d/node_3d.h"
 #include "scene/resources/animation.h"
 #include "scene/resources/mesh.h"
@@ -119,7 +120,16 @@ class ResourceImporterScene : public ResourceImporter {
 	};
 
 	void _replace_owner(Node *p_node, Node *p_scene, Node *p_new_owner);
-	void _generate_meshes(Node *p_node, const Dictionary &p_mesh_data, bool p_generate_lods, bool p_create_shadow_meshes, LightBakeMode p_light_bake_mode, float p_lightmap_texel_size, const Vector<uint8_t> &p_src_lightmap_cache, Vector<Vector<uint8_t>> &r_lightmap_caches);
+	struct MeshSurfaceTask {
+		Ref<EditorSceneImporterMesh> mesh;
+		int surface = 0;
+		bool generate_lods = false;
+		bool optimize_vertex_order = false;
+	};
+
+	void _collect_mesh_surface_tasks(Node *p_node, const Dictionary &p_mesh_data, bool p_generate_lods, bool p_optimize_vertex_order, LightBakeMode p_light_bake_mode, Set<Ref<EditorSceneImporterMesh>> &r_visited, LocalVector<MeshSurfaceTask> &r_tasks);
+	void _process_mesh_surface_task(uint32_t p_index, MeshSurfaceTask *p_tasks);
+	void _generate_meshes(Node *p_node, const Dictionary &p_mesh_data, bool p_create_shadow_meshes, LightBakeMode p_light_bake_mode, float p_lightmap_texel_size, const Vector<uint8_t> &p_src_lightmap_cache, Vector<Vector<uint8_t>> &r_lightmap_caches);
 	void _add_shapes(Node *p_node, const List<Ref<Shape3D>> &p_shapes);
 
 public:
@@ -31,6 +31,7 @@
 #include "scene_importer_mesh.h"
 
 #include "core/math/math_defs.h"
+#include "core/templates/local_vector.h"
 #include "scene/resources/surface_tool.h"
 
 void EditorSceneImporterMesh::add_blend_shape(const String &p_name) {
@@ -154,7 +155,12 @@ Basis EditorSceneImporterMesh::compute_rotation_matrix_from_ortho_6d(Vector3 p_x
 	return basis;
 }
 
-void EditorSceneImporterMesh::generate_lods() {
+void EditorSceneImporterMesh::make_surfaces_unique() {
+	surfaces.ptrw();
+}
+
+void EditorSceneImporterMesh::generate_surface_lods(int p_surface) {
+	ERR_FAIL_INDEX(p_surface, surfaces.size());
 	if (!SurfaceTool::simplify_func) {
 		return;
 	}
@@ -168,75 +174,190 @@ void EditorSceneImporterMesh::generate_lods() {
 		return;
 	}
 
-	for (int i = 0; i < surfaces.size(); i++) {
-		if (surfaces[i].primitive != Mesh::PRIMITIVE_TRIANGLES) {
-			continue;
+	if (surfaces[p_surface].primitive != Mesh::PRIMITIVE_TRIANGLES) {
+		return;
+	}
+
+	surfaces.write[p_surface].lods.clear();
+	Vector<Vector3> vertices = surfaces[p_surface].arrays[RS::ARRAY_VERTEX];
+	Vector<int> indices = surfaces[p_surface].arrays[RS::ARRAY_INDEX];
+	if (indices.size() == 0) {
+		return; //no lods if no indices
+	}
+	Vector<Vector3> normals = surfaces[p_surface].arrays[RS::ARRAY_NORMAL];
+	uint32_t vertex_count = vertices.size();
+	const Vector3 *vertices_ptr = vertices.ptr();
+	Vector<float> attributes;
+	Vector<float> normal_weights;
+	int32_t attribute_count = 6;
+	if (normals.size()) {
+		attributes.resize(normals.size() * attribute_count);
+		for (int32_t normal_i = 0; normal_i < normals.size(); normal_i++) {
+			Basis basis;
+			basis.set_euler(normals[normal_i]);
+			Vector3 basis_x = basis.get_axis(0);
+			Vector3 basis_y = basis.get_axis(1);
+			basis = compute_rotation_matrix_from_ortho_6d(basis_x, basis_y);
+			basis_x = basis.get_axis(0);
+			basis_y = basis.get_axis(1);
+			attributes.write[normal_i * attribute_count + 0] = basis_x.x;
+			attributes.write[normal_i * attribute_count + 1] = basis_x.y;
+			attributes.write[normal_i * attribute_count + 2] = basis_x.z;
+			attributes.write[normal_i * attribute_count + 3] = basis_y.x;
+			attributes.write[normal_i * attribute_count + 4] = basis_y.y;
+			attributes.write[normal_i * attribute_count + 5] = basis_y.z;
 		}
+		normal_weights.resize(vertex_count);
+		for (int32_t weight_i = 0; weight_i < normal_weights.size(); weight_i++) {
+			normal_weights.write[weight_i] = 1.0;
+		}
+	} else {
+		attribute_count = 0;
+	}
+	const int min_indices = 10;
+	const float error_tolerance = 1.44224'95703; // Cube root of 3
+	const float threshold = 1.0 / error_tolerance;
+	int index_target = indices.size() * threshold;
+	float max_mesh_error_percentage = 1e0f;
+	float mesh_error = 0.0f;
+	float scale = SurfaceTool::simplify_scale_func((const float *)vertices_ptr, vertex_count, sizeof(Vector3));
+	while (index_target > min_indices) {
+		Vector<int> new_indices;
+		new_indices.resize(indices.size());
+		size_t new_len = SurfaceTool::simplify_with_attrib_func((unsigned int *)new_indices.ptrw(), (const unsigned int *)indices.ptr(), indices.size(), (const float *)vertices_ptr, vertex_count, sizeof(Vector3), index_target, max_mesh_error_percentage, &mesh_error, (float *)attributes.ptrw(), normal_weights.ptrw(), attribute_count);
+		if ((int)new_len > (index_target * error_tolerance)) {
+			break;
+		}
+		Surface::LOD lod;
+		lod.distance = mesh_error * scale;
+		if (Math::is_zero_approx(mesh_error)) {
+			break;
+		}
+		if (new_len <= 0) {
+			break;
+		}
+		new_indices.resize(new_len);
+		lod.indices = new_indices;
+		print_line("Lod " + itos(surfaces.write[p_surface].lods.size()) + " begin with " + itos(indices.size() / 3) + " triangles and shoot for " + itos(index_target / 3) + " triangles. Got " + itos(new_len / 3) + " triangles. Lod screen ratio " + rtos(lod.distance));
+		surfaces.write[p_surface].lods.push_back(lod);
+		index_target *= threshold;
+	}
+}
 
-		surfaces.write[i].lods.clear();
-		Vector<Vector3> vertices = surfaces[i].arrays[RS::ARRAY_VERTEX];
-		Vector<int> indices = surfaces[i].arrays[RS::ARRAY_INDEX];
-		if (indices.size() == 0) {
-			continue; //no lods if no indices
-		}
-		Vector<Vector3> normals = surfaces[i].arrays[RS::ARRAY_NORMAL];
-		uint32_t vertex_count = vertices.size();
-		const Vector3 *vertices_ptr = vertices.ptr();
-		Vector<float> attributes;
-		Vector<float> normal_weights;
-		int32_t attribute_count = 6;
-		if (normals.size()) {
-			attributes.resize(normals.size() * attribute_count);
-			for (int32_t normal_i = 0; normal_i < normals.size(); normal_i++) {
-				Basis basis;
-				basis.set_euler(normals[normal_i]);
-				Vector3 basis_x = basis.get_axis(0);
-				Vector3 basis_y = basis.get_axis(1);
-				basis = compute_rotation_matrix_from_ortho_6d(basis_x, basis_y);
-				basis_x = basis.get_axis(0);
-				basis_y = basis.get_axis(1);
-				attributes.write[normal_i * attribute_count + 0] = basis_x.x;
-				attributes.write[normal_i * attribute_count + 1] = basis_x.y;
-				attributes.write[normal_i * attribute_count + 2] = basis_x.z;
-				attributes.write[normal_i * attribute_count + 3] = basis_y.x;
-				attributes.write[normal_i * attribute_count + 4] = basis_y.y;
-				attributes.write[normal_i * attribute_count + 5] = basis_y.z;
-			}
-			normal_weights.resize(vertex_count);
-			for (int32_t weight_i = 0; weight_i < normal_weights.size(); weight_i++) {
-				normal_weights.write[weight_i] = 1.0;
-			}
-		} else {
-			attribute_count = 0;
-		}
-		const int min_indices = 10;
-		const float error_tolerance = 1.44224'95703; // Cube root of 3
-		const float threshold = 1.0 / error_tolerance;
-		int index_target = indices.size() * threshold;
-		float max_mesh_error_percentage = 1e0f;
-		float mesh_error = 0.0f;
-		float scale = SurfaceTool::simplify_scale_func((const float *)vertices_ptr, vertex_count, sizeof(Vector3));
-		while (index_target > min_indices) {
-			Vector<int> new_indices;
-			new_indices.resize(indices.size());
-			size_t new_len = SurfaceTool::simplify_with_attrib_func((unsigned int *)new_indices.ptrw(), (const unsigned int *)indices.ptr(), indices.size(), (const float *)vertices_ptr, vertex_count, sizeof(Vector3), index_target, max_mesh_error_percentage, &mesh_error, (float *)attributes.ptrw(), normal_weights.ptrw(), attribute_count);
-			if ((int)new_len > (index_target * error_tolerance)) {
-				break;
-			}
-			Surface::LOD lod;
-			lod.distance = mesh_error * scale;
-			if (Math::is_zero_approx(mesh_error)) {
-				break;
-			}
-			if (new_len <= 0) {
-				break;
-			}
-			new_indices.resize(new_len);
-			lod.indices = new_indices;
-			print_line("Lod " + itos(surfaces.write[i].lods.size()) + " begin with " + itos(indices.size() / 3) + " triangles and shoot for " + itos(index_target / 3) + " triangles. Got " + itos(new_len / 3) + " triangles. Lod screen ratio " + rtos(lod.distance));
-			surfaces.write[i].lods.push_back(lod);
-			index_target *= threshold;
+template <class T>
+static Vector<T> _remap_vertex_array(const Vector<T> &p_array, const LocalVector<uint32_t> &p_remap, uint32_t p_new_vertex_count) {
+	const int stride = p_array.size() / p_remap.size();
+	Vector<T> ret;
+	ret.resize(p_new_vertex_count * stride);
+	T *w = ret.ptrw();
+	const T *r = p_array.ptr();
+	for (uint32_t i = 0; i < p_remap.size(); i++) {
+		if (p_remap[i] == ~0u) {
+			continue; // Not used by any triangle.
+		}
+		for (int j = 0; j < stride; j++) {
+			w[p_remap[i] * stride + j] = r[i * stride + j];
+		}
+	}
+	return ret;
+}
+
+static Variant _remap_vertex_variant(const Variant &p_array, const LocalVector<uint32_t> &p_remap, uint32_t p_new_vertex_count) {
+	switch (p_array.get_type()) {
+		case Variant::PACKED_BYTE_ARRAY: {
+			const PackedByteArray array = p_array;
+			ERR_FAIL_COND_V(array.size() % p_remap.size(), p_array);
+			return _remap_vertex_array(array, p_remap, p_new_vertex_count);
+		}
+		case Variant::PACKED_INT32_ARRAY: {
+			const PackedInt32Array array = p_array;
+			ERR_FAIL_COND_V(array.size() % p_remap.size(), p_array);
+			return _remap_vertex_array(array, p_remap, p_new_vertex_count);
+		}
+		case Variant::PACKED_FLOAT32_ARRAY: {
+			const PackedFloat32Array array = p_array;
+			ERR_FAIL_COND_V(array.size() % p_remap.size(), p_array);
+			return _remap_vertex_array(array, p_remap, p_new_vertex_count);
+		}
+		case Variant::PACKED_VECTOR2_ARRAY: {
+			const PackedVector2Array array = p_array;
+			ERR_FAIL_COND_V(array.size() % p_remap.size(), p_array);
+			return _remap_vertex_array(array, p_remap, p_new_vertex_count);
+		}
+		case Variant::PACKED_VECTOR3_ARRAY: {
+			const PackedVector3Array array = p_array;
+			ERR_FAIL_COND_V(array.size() % p_remap.size(), p_array);
+			return _remap_vertex_array(array, p_remap, p_new_vertex_count);
+		}
+		case Variant::PACKED_COLOR_ARRAY: {
+			const PackedColorArray array = p_array;
+			ERR_FAIL_COND_V(array.size() % p_remap.size(), p_array);
+			return _remap_vertex_array(array, p_remap, p_new_vertex_count);
+		}
+		default: {
+			return p_array;
+		}
+	}
+}
+
+void EditorSceneImporterMesh::optimize_surface_vertex_order(int p_surface) {
+	ERR_FAIL_INDEX(p_surface, surfaces.size());
+	if (!SurfaceTool::optimize_vertex_cache_func || !SurfaceTool::optimize_overdraw_func || !SurfaceTool::optimize_vertex_fetch_remap_func) {
+		return;
+	}
+	if (surfaces[p_surface].primitive != Mesh::PRIMITIVE_TRIANGLES) {
+		return;
+	}
+
+	Surface &surface = surfaces.write[p_surface];
+	Vector<Vector3> vertices = surface.arrays[RS::ARRAY_VERTEX];
+	Vector<int> indices = surface.arrays[RS::ARRAY_INDEX];
+	if (indices.size() == 0 || vertices.size() == 0) {
+		return;
+	}
+	const uint32_t vertex_count = vertices.size();
+
+	// Order the triangles for the post-transform cache first, then for less overdraw,
+	// which only moves clusters of triangles around and keeps most of the cache locality.
+	Vector<int> cache_indices;
+	cache_indices.resize(indices.size());
+	SurfaceTool::optimize_vertex_cache_func((unsigned int *)cache_indices.ptrw(), (const unsigned int *)indices.ptr(), indices.size(), vertex_count);
+	SurfaceTool::optimize_overdraw_func((unsigned int *)indices.ptrw(), (const unsigned int *)cache_indices.ptr(), indices.size(), (const float *)vertices.ptr(), vertex_count, sizeof(Vector3), 1.05);
+
+	// Then store the vertices in the order the triangles use them, so they are fetched sequentially.
+	LocalVector<uint32_t> remap;
+	remap.resize(vertex_count);
+	const uint32_t new_vertex_count = SurfaceTool::optimize_vertex_fetch_remap_func(remap.ptr(), (const unsigned int *)indices.ptr(), indices.size(), vertex_count);
+
+	int *w = indices.ptrw();
+	for (int i = 0; i < indices.size(); i++) {
+		w[i] = remap[w[i]];
+	}
+
+	// The arrays may be shared with the importer, so new ones are created.
+	Array arrays;
+	arrays.resize(Mesh::ARRAY_MAX);
+	for (int i = 0; i < Mesh::ARRAY_MAX; i++) {
+		arrays[i] = i == Mesh::ARRAY_INDEX ? Variant(indices) : _remap_vertex_variant(surface.arrays[i], remap, new_vertex_count);
+	}
+	surface.arrays = arrays;
+
+	for (int i = 0; i < surface.blend_shape_data.size(); i++) {
+		Array blend_shape_arrays;
+		blend_shape_arrays.resize(Mesh::ARRAY_MAX);
+		for (int j = 0; j < Mesh::ARRAY_MAX; j++) {
+			blend_shape_arrays[j] = _remap_vertex_variant(surface.blend_shape_data[i].arrays[j], remap, new_vertex_count);
+		}
+		surface.blend_shape_data.write[i].arrays = blend_shape_arrays;
+	}
+
+	for (int i = 0; i < surface.lods.size(); i++) {
+		Vector<int> lod_indices = surface.lods[i].indices;
+		int *lod_w = lod_indices.ptrw();
+		for (int j = 0; j < lod_indices.size(); j++) {
+			lod_w[j] = remap[lod_w[j]];
 		}
+		SurfaceTool::optimize_vertex_cache_func((unsigned int *)surface.lods.write[i].indices.ptrw(), (const unsigned int *)lod_indices.ptr(), lod_indices.size(), new_vertex_count);
 	}
 }
 
@@ -97,7 +97,14 @@ public:
 
 	void set_surface_material(int p_surface, const Ref<Material> &p_material);
 
-	void generate_lods();
+	// Copies the surface list if it's shared. Once done, generate_surface_lods() and
+	// optimize_surface_vertex_order() are safe to call for different surfaces from separate threads.
+	void make_surfaces_unique();
+
+	void generate_surface_lods(int p_surface);
+
+	// Reorders the triangles and vertices of the surface for the GPU vertex cache, overdraw and vertex fetch.
+	void optimize_surface_vertex_order(int p_surface);
 
 	void create_shadow_mesh();
 	Ref<EditorSceneImporterMesh> get_shadow_mesh() const;
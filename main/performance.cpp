@@ -77,6 +77,10 @@ void Performance::_bind_methods() {
 	BIND_ENUM_CONSTANT(PHYSICS_3D_COLLISION_PAIRS);
 	BIND_ENUM_CONSTANT(PHYSICS_3D_ISLAND_COUNT);
 	BIND_ENUM_CONSTANT(AUDIO_OUTPUT_LATENCY);
+	BIND_ENUM_CONSTANT(AUDIO_REAL_VOICES);
+	BIND_ENUM_CONSTANT(AUDIO_VIRTUAL_VOICES);
+	BIND_ENUM_CONSTANT(MEMORY_SMALL_ALLOC_RESERVED);
+	BIND_ENUM_CONSTANT(MEMORY_SMALL_ALLOC_USED);
 
 	BIND_ENUM_CONSTANT(MONITOR_MAX);
 }
@@ -120,6 +124,10 @@ String Performance::get_monitor_name(Monitor p_monitor) const {
 		"physics_3d/collision_pairs",
 		"physics_3d/islands",
 		"audio/driver/output_latency",
+		"audio/voices/real",
+		"audio/voices/virtual",
+		"memory/small_alloc_reserved",
+		"memory/small_alloc_used",
 
 	};
 
@@ -182,6 +190,14 @@ float Performance::get_monitor(Monitor p_monitor) const {
 			return PhysicsServer3D::get_singleton()->get_process_info(PhysicsServer3D::INFO_ISLAND_COUNT);
 		case AUDIO_OUTPUT_LATENCY:
 			return AudioServer::get_singleton()->get_output_latency();
+		case AUDIO_REAL_VOICES:
+			return AudioServer::get_singleton()->get_real_voice_count();
+		case AUDIO_VIRTUAL_VOICES:
+			return AudioServer::get_singleton()->get_virtual_voice_count();
+		case MEMORY_SMALL_ALLOC_RESERVED:
+			return Memory::get_small_alloc_reserved();
+		case MEMORY_SMALL_ALLOC_USED:
+			return Memory::get_small_alloc_usage();
 
 		default: {
 		}
@@ -221,6 +237,10 @@ Performance::MonitorType Performance::get_monitor_type(Monitor p_monitor) const
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_MEMORY,
 
 	};
 
@@ -91,6 +91,10 @@ public:
 		PHYSICS_3D_ISLAND_COUNT,
 		//physics
 		AUDIO_OUTPUT_LATENCY,
+		AUDIO_REAL_VOICES,
+		AUDIO_VIRTUAL_VOICES,
+		MEMORY_SMALL_ALLOC_RESERVED,
+		MEMORY_SMALL_ALLOC_USED,
 		MONITOR_MAX
 	};
 
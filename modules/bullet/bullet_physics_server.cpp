@@ -388,6 +388,20 @@ void BulletPhysicsServer3D::area_set_transform(RID p_area, const Transform3D &p_
 	area->set_transform(p_transform);
 }
 
+void BulletPhysicsServer3D::area_set_transforms(const Vector<RID> &p_areas, const Vector<Transform3D> &p_transforms) {
+	ERR_FAIL_COND(p_areas.size() != p_transforms.size());
+
+	const RID *areas = p_areas.ptr();
+	const Transform3D *transforms = p_transforms.ptr();
+	for (int i = 0; i < p_areas.size(); i++) {
+		AreaBullet *area = area_owner.getornull(areas[i]);
+		if (!area) {
+			continue; // Freed after its transform was batched.
+		}
+		area->set_transform(transforms[i]);
+	}
+}
+
 Transform3D BulletPhysicsServer3D::area_get_transform(RID p_area) const {
 	AreaBullet *area = area_owner.getornull(p_area);
 	ERR_FAIL_COND_V(!area, Transform3D());
@@ -660,6 +674,20 @@ void BulletPhysicsServer3D::body_set_state(RID p_body, BodyState p_state, const
 	body->set_state(p_state, p_variant);
 }
 
+void BulletPhysicsServer3D::body_set_transforms(const Vector<RID> &p_bodies, const Vector<Transform3D> &p_transforms) {
+	ERR_FAIL_COND(p_bodies.size() != p_transforms.size());
+
+	const RID *bodies = p_bodies.ptr();
+	const Transform3D *transforms = p_transforms.ptr();
+	for (int i = 0; i < p_bodies.size(); i++) {
+		RigidBodyBullet *body = rigid_body_owner.getornull(bodies[i]);
+		if (!body) {
+			continue; // Freed after its transform was batched.
+		}
+		body->set_state(BODY_STATE_TRANSFORM, transforms[i]);
+	}
+}
+
 Variant BulletPhysicsServer3D::body_get_state(RID p_body, BodyState p_state) const {
 	RigidBodyBullet *body = rigid_body_owner.getornull(p_body);
 	ERR_FAIL_COND_V(!body, Variant());
@@ -154,6 +154,7 @@ public:
 	virtual Variant area_get_param(RID p_area, AreaParameter p_param) const override;
 
 	virtual void area_set_transform(RID p_area, const Transform3D &p_transform) override;
+	virtual void area_set_transforms(const Vector<RID> &p_areas, const Vector<Transform3D> &p_transforms) override;
 	virtual Transform3D area_get_transform(RID p_area) const override;
 
 	virtual void area_set_collision_mask(RID p_area, uint32_t p_mask) override;
@@ -213,6 +214,7 @@ public:
 	virtual real_t body_get_kinematic_safe_margin(RID p_body) const override;
 
 	virtual void body_set_state(RID p_body, BodyState p_state, const Variant &p_variant) override;
+	virtual void body_set_transforms(const Vector<RID> &p_bodies, const Vector<Transform3D> &p_transforms) override;
 	virtual Variant body_get_state(RID p_body, BodyState p_state) const override;
 
 	virtual void body_set_applied_force(RID p_body, const Vector3 &p_force) override;
@@ -185,6 +185,18 @@ inline static bool are_segements_parallel(const Vector2 p_segment1_points[2], co
 
 // CSGBrush
 
+// Runs p_method for every index, on the threads of the pool when one is given.
+template <class C, class U>
+static void _do_work(ThreadWorkPool *p_work_pool, uint32_t p_count, C *p_instance, void (C::*p_method)(uint32_t, U), U p_userdata) {
+	if (p_work_pool && p_count > 1) {
+		p_work_pool->do_work(p_count, p_instance, p_method, p_userdata);
+	} else {
+		for (uint32_t i = 0; i < p_count; i++) {
+			(p_instance->*p_method)(i, p_userdata);
+		}
+	}
+}
+
 void CSGBrush::_regen_face_aabbs() {
 	for (int i = 0; i < faces.size(); i++) {
 		faces.write[i].aabb = AABB();
@@ -283,13 +295,7 @@ void CSGBrush::copy_from(const CSGBrush &p_brush, const Transform3D &p_xform) {
 void CSGBrushOperation::merge_brushes(Operation p_operation, const CSGBrush &p_brush_a, const CSGBrush &p_brush_b, CSGBrush &r_merged_brush, float p_vertex_snap) {
 	// Check for face collisions and add necessary faces.
 	Build2DFaceCollection build2DFaceCollection;
-	for (int i = 0; i < p_brush_a.faces.size(); i++) {
-		for (int j = 0; j < p_brush_b.faces.size(); j++) {
-			if (p_brush_a.faces[i].aabb.intersects_inclusive(p_brush_b.faces[j].aabb)) {
-				update_faces(p_brush_a, i, p_brush_b, j, build2DFaceCollection, p_vertex_snap);
-			}
-		}
-	}
+	_collect_face_intersections(p_brush_a, p_brush_b, build2DFaceCollection, p_vertex_snap);
 
 	// Add faces to MeshMerge.
 	MeshMerge mesh_merge;
@@ -334,7 +340,7 @@ void CSGBrushOperation::merge_brushes(Operation p_operation, const CSGBrush &p_b
 	}
 
 	// Mark faces that ended up inside the intersection.
-	mesh_merge.mark_inside_faces();
+	mesh_merge.mark_inside_faces(work_pool);
 
 	// Create new brush and fill with new faces.
 	r_merged_brush.faces.clear();
@@ -656,7 +662,7 @@ bool CSGBrushOperation::MeshMerge::_bvh_inside(FaceBVH *facebvhptr, int p_max_de
 	return (intersectionsA.size() + intersectionsB.size()) & 1;
 }
 
-void CSGBrushOperation::MeshMerge::mark_inside_faces() {
+void CSGBrushOperation::MeshMerge::mark_inside_faces(ThreadWorkPool *p_work_pool) {
 	// Mark faces that are inside. This helps later do the boolean ops when merging.
 	// This approach is very brute force with a bunch of optimizations,
 	// such as BVH and pre AABB intersection test.
@@ -717,18 +723,28 @@ void CSGBrushOperation::MeshMerge::mark_inside_faces() {
 	int max_alloc = faces.size();
 	_create_bvh(facebvh, bvhptr, 0, faces.size(), 1, max_depth, max_alloc);
 
-	for (int i = 0; i < faces.size(); i++) {
-		// Check if face AABB intersects the intersection AABB.
-		if (!intersection_aabb.intersects_inclusive(facebvh[i].aabb)) {
-			continue;
-		}
+	// Every face casts its own ray, so they can be tested in parallel.
+	InsideQuery query;
+	query.facebvh = facebvh;
+	query.max_depth = max_depth;
+	query.bvh_first = max_alloc - 1;
+	query.intersection_aabb = intersection_aabb;
+	query.inside.resize(faces.size());
+	_do_work(p_work_pool, faces.size(), this, &MeshMerge::_mark_inside_face, &query);
 
-		if (_bvh_inside(facebvh, max_depth, max_alloc - 1, i)) {
+	for (int i = 0; i < faces.size(); i++) {
+		if (query.inside[i]) {
 			faces.write[i].inside = true;
 		}
 	}
 }
 
+void CSGBrushOperation::MeshMerge::_mark_inside_face(uint32_t p_face_idx, InsideQuery *p_query) {
+	// Check if face AABB intersects the intersection AABB.
+	p_query->inside[p_face_idx] = p_query->intersection_aabb.intersects_inclusive(p_query->facebvh[p_face_idx].aabb) &&
+			_bvh_inside(p_query->facebvh, p_query->max_depth, p_query->bvh_first, p_face_idx);
+}
+
 void CSGBrushOperation::MeshMerge::add_face(const Vector3 p_points[], const Vector2 p_uvs[], bool p_smooth, bool p_invert, const Ref<Material> &p_material, bool p_from_b) {
 	int indices[3];
 	for (int i = 0; i < 3; i++) {
@@ -1354,47 +1370,16 @@ CSGBrushOperation::Build2DFaces::Build2DFaces(const CSGBrush &p_brush, int p_fac
 	faces.push_back(face);
 }
 
-void CSGBrushOperation::update_faces(const CSGBrush &p_brush_a, const int p_face_idx_a, const CSGBrush &p_brush_b, const int p_face_idx_b, Build2DFaceCollection &p_collection, float p_vertex_snap) {
-	Vector3 vertices_a[3] = {
-		p_brush_a.faces[p_face_idx_a].vertices[0],
-		p_brush_a.faces[p_face_idx_a].vertices[1],
-		p_brush_a.faces[p_face_idx_a].vertices[2],
-	};
-
-	Vector3 vertices_b[3] = {
-		p_brush_b.faces[p_face_idx_b].vertices[0],
-		p_brush_b.faces[p_face_idx_b].vertices[1],
-		p_brush_b.faces[p_face_idx_b].vertices[2],
-	};
-
-	// Don't use degenerate faces.
-	bool has_degenerate = false;
-	if (is_snapable(vertices_a[0], vertices_a[1], p_vertex_snap) ||
-			is_snapable(vertices_a[0], vertices_a[2], p_vertex_snap) ||
-			is_snapable(vertices_a[1], vertices_a[2], p_vertex_snap)) {
-		p_collection.build2DFacesA[p_face_idx_a] = Build2DFaces();
-		has_degenerate = true;
-	}
-
-	if (is_snapable(vertices_b[0], vertices_b[1], p_vertex_snap) ||
-			is_snapable(vertices_b[0], vertices_b[2], p_vertex_snap) ||
-			is_snapable(vertices_b[1], vertices_b[2], p_vertex_snap)) {
-		p_collection.build2DFacesB[p_face_idx_b] = Build2DFaces();
-		has_degenerate = true;
-	}
-	if (has_degenerate) {
-		return;
-	}
-
+bool CSGBrushOperation::_faces_intersect(const Vector3 p_vertices_a[3], const Vector3 p_vertices_b[3]) {
 	// Ensure B has points either side of or in the plane of A.
 	int in_plane_count = 0, over_count = 0, under_count = 0;
-	Plane plane_a(vertices_a[0], vertices_a[1], vertices_a[2]);
-	ERR_FAIL_COND_MSG(plane_a.normal == Vector3(), "Couldn't form plane from Brush A face.");
+	Plane plane_a(p_vertices_a[0], p_vertices_a[1], p_vertices_a[2]);
+	ERR_FAIL_COND_V_MSG(plane_a.normal == Vector3(), false, "Couldn't form plane from Brush A face.");
 
 	for (int i = 0; i < 3; i++) {
-		if (plane_a.has_point(vertices_b[i])) {
+		if (plane_a.has_point(p_vertices_b[i])) {
 			in_plane_count++;
-		} else if (plane_a.is_point_over(vertices_b[i])) {
+		} else if (plane_a.is_point_over(p_vertices_b[i])) {
 			over_count++;
 		} else {
 			under_count++;
@@ -1402,20 +1387,20 @@ void CSGBrushOperation::update_faces(const CSGBrush &p_brush_a, const int p_face
 	}
 	// If all points under or over the plane, there is no intersection.
 	if (over_count == 3 || under_count == 3) {
-		return;
+		return false;
 	}
 
 	// Ensure A has points either side of or in the plane of B.
 	in_plane_count = 0;
 	over_count = 0;
 	under_count = 0;
-	Plane plane_b(vertices_b[0], vertices_b[1], vertices_b[2]);
-	ERR_FAIL_COND_MSG(plane_b.normal == Vector3(), "Couldn't form plane from Brush B face.");
+	Plane plane_b(p_vertices_b[0], p_vertices_b[1], p_vertices_b[2]);
+	ERR_FAIL_COND_V_MSG(plane_b.normal == Vector3(), false, "Couldn't form plane from Brush B face.");
 
 	for (int i = 0; i < 3; i++) {
-		if (plane_b.has_point(vertices_a[i])) {
+		if (plane_b.has_point(p_vertices_a[i])) {
 			in_plane_count++;
-		} else if (plane_b.is_point_over(vertices_a[i])) {
+		} else if (plane_b.is_point_over(p_vertices_a[i])) {
 			over_count++;
 		} else {
 			under_count++;
@@ -1423,17 +1408,17 @@ void CSGBrushOperation::update_faces(const CSGBrush &p_brush_a, const int p_face
 	}
 	// If all points under or over the plane, there is no intersection.
 	if (over_count == 3 || under_count == 3) {
-		return;
+		return false;
 	}
 
 	// Check for intersection using the SAT theorem.
 	{
 		// Edge pair cross product combinations.
 		for (int i = 0; i < 3; i++) {
-			Vector3 axis_a = (vertices_a[i] - vertices_a[(i + 1) % 3]).normalized();
+			Vector3 axis_a = (p_vertices_a[i] - p_vertices_a[(i + 1) % 3]).normalized();
 
 			for (int j = 0; j < 3; j++) {
-				Vector3 axis_b = (vertices_b[j] - vertices_b[(j + 1) % 3]).normalized();
+				Vector3 axis_b = (p_vertices_b[j] - p_vertices_b[(j + 1) % 3]).normalized();
 
 				Vector3 sep_axis = axis_a.cross(axis_b);
 				if (sep_axis == Vector3()) {
@@ -1445,10 +1430,10 @@ void CSGBrushOperation::update_faces(const CSGBrush &p_brush_a, const int p_face
 				real_t min_b = 1e20, max_b = -1e20;
 
 				for (int k = 0; k < 3; k++) {
-					real_t d = sep_axis.dot(vertices_a[k]);
+					real_t d = sep_axis.dot(p_vertices_a[k]);
 					min_a = MIN(min_a, d);
 					max_a = MAX(max_a, d);
-					d = sep_axis.dot(vertices_b[k]);
+					d = sep_axis.dot(p_vertices_b[k]);
 					min_b = MIN(min_b, d);
 					max_b = MAX(max_b, d);
 				}
@@ -1460,20 +1445,165 @@ void CSGBrushOperation::update_faces(const CSGBrush &p_brush_a, const int p_face
 				real_t dmax = max_b - (min_a + max_a) * 0.5;
 
 				if (dmin > CMP_EPSILON || dmax < -CMP_EPSILON) {
-					return; // Does not contain zero, so they don't overlap.
+					return false; // Does not contain zero, so they don't overlap.
 				}
 			}
 		}
 	}
 
-	// If we're still here, the faces probably intersect, so add new faces.
-	if (!p_collection.build2DFacesA.has(p_face_idx_a)) {
-		p_collection.build2DFacesA[p_face_idx_a] = Build2DFaces(p_brush_a, p_face_idx_a, p_vertex_snap);
+	// If we're still here, the faces probably intersect.
+	return true;
+}
+
+static bool _is_face_degenerate(const CSGBrush::Face &p_face, float p_vertex_snap) {
+	return is_snapable(p_face.vertices[0], p_face.vertices[1], p_vertex_snap) ||
+			is_snapable(p_face.vertices[0], p_face.vertices[2], p_vertex_snap) ||
+			is_snapable(p_face.vertices[1], p_face.vertices[2], p_vertex_snap);
+}
+
+struct CSGFaceQueryResult {
+	LocalVector<int> *faces = nullptr;
+
+	_FORCE_INLINE_ bool operator()(void *p_data) {
+		faces->push_back((int)(intptr_t)p_data);
+		return false;
 	}
-	p_collection.build2DFacesA[p_face_idx_a].insert(p_brush_b, p_face_idx_b);
+};
 
-	if (!p_collection.build2DFacesB.has(p_face_idx_b)) {
-		p_collection.build2DFacesB[p_face_idx_b] = Build2DFaces(p_brush_b, p_face_idx_b, p_vertex_snap);
+void CSGBrushOperation::_find_face_intersections(uint32_t p_face_idx_a, FaceIntersectionQuery *p_query) {
+	FaceIntersectionQuery::Result &result = p_query->results[p_face_idx_a];
+	const CSGBrush::Face &face_a = p_query->brush_a->faces[p_face_idx_a];
+
+	LocalVector<int> candidates;
+	CSGFaceQueryResult query_result;
+	query_result.faces = &candidates;
+	p_query->bvh_b->aabb_query(face_a.aabb, query_result);
+	if (candidates.is_empty()) {
+		return;
 	}
-	p_collection.build2DFacesB[p_face_idx_b].insert(p_brush_a, p_face_idx_a);
+	candidates.sort();
+
+	for (uint32_t i = 0; i < candidates.size(); i++) {
+		const int face_idx_b = candidates[i];
+
+		// Don't use degenerate faces.
+		if (p_query->degenerate_b[face_idx_b]) {
+			result.degenerate_faces_b.push_back(face_idx_b);
+			continue;
+		}
+		if (p_query->degenerate_a[p_face_idx_a]) {
+			continue;
+		}
+
+		if (_faces_intersect(face_a.vertices, p_query->brush_b->faces[face_idx_b].vertices)) {
+			result.faces_b.push_back(face_idx_b);
+		}
+	}
+	result.degenerate_hit = p_query->degenerate_a[p_face_idx_a];
+}
+
+void CSGBrushOperation::_split_face(uint32_t p_index, FaceSplitQuery *p_query) {
+	for (uint32_t i = p_query->other_faces_offsets[p_index]; i < p_query->other_faces_offsets[p_index + 1]; i++) {
+		p_query->faces[p_index]->insert(*p_query->other_brush, p_query->other_faces[i]);
+	}
+}
+
+void CSGBrushOperation::_collect_face_intersections(const CSGBrush &p_brush_a, const CSGBrush &p_brush_b, Build2DFaceCollection &r_collection, float p_vertex_snap) {
+	const int face_count_a = p_brush_a.faces.size();
+	const int face_count_b = p_brush_b.faces.size();
+	if (face_count_a == 0 || face_count_b == 0) {
+		return;
+	}
+
+	// Find the pairs of faces with overlapping AABBs through a BVH of brush B,
+	// instead of testing every face of A against every face of B.
+	DynamicBVH bvh_b;
+	for (int i = 0; i < face_count_b; i++) {
+		bvh_b.insert(p_brush_b.faces[i].aabb, (void *)(intptr_t)i);
+	}
+
+	FaceIntersectionQuery query;
+	query.brush_a = &p_brush_a;
+	query.brush_b = &p_brush_b;
+	query.bvh_b = &bvh_b;
+	query.degenerate_a.resize(face_count_a);
+	for (int i = 0; i < face_count_a; i++) {
+		query.degenerate_a[i] = _is_face_degenerate(p_brush_a.faces[i], p_vertex_snap);
+	}
+	query.degenerate_b.resize(face_count_b);
+	for (int i = 0; i < face_count_b; i++) {
+		query.degenerate_b[i] = _is_face_degenerate(p_brush_b.faces[i], p_vertex_snap);
+	}
+	query.results.resize(face_count_a);
+	_do_work(work_pool, face_count_a, this, &CSGBrushOperation::_find_face_intersections, &query);
+
+	// Degenerate faces touching the other brush are left out of the result,
+	// every other face is split by the faces it intersects in ascending order.
+	FaceSplitQuery split_a;
+	split_a.other_brush = &p_brush_b;
+	split_a.other_faces_offsets.push_back(0);
+
+	LocalVector<uint32_t> face_counts_b;
+	face_counts_b.resize(face_count_b);
+	for (int i = 0; i < face_count_b; i++) {
+		face_counts_b[i] = 0;
+	}
+
+	for (int i = 0; i < face_count_a; i++) {
+		const FaceIntersectionQuery::Result &result = query.results[i];
+		for (uint32_t j = 0; j < result.degenerate_faces_b.size(); j++) {
+			r_collection.build2DFacesB[result.degenerate_faces_b[j]] = Build2DFaces();
+		}
+		if (result.degenerate_hit) {
+			r_collection.build2DFacesA[i] = Build2DFaces();
+			continue;
+		}
+		if (result.faces_b.is_empty()) {
+			continue;
+		}
+
+		r_collection.build2DFacesA[i] = Build2DFaces(p_brush_a, i, p_vertex_snap);
+		split_a.faces.push_back(&r_collection.build2DFacesA[i]);
+		for (uint32_t j = 0; j < result.faces_b.size(); j++) {
+			split_a.other_faces.push_back(result.faces_b[j]);
+			face_counts_b[result.faces_b[j]]++;
+		}
+		split_a.other_faces_offsets.push_back(split_a.other_faces.size());
+	}
+
+	FaceSplitQuery split_b;
+	split_b.other_brush = &p_brush_a;
+	split_b.other_faces_offsets.push_back(0);
+
+	LocalVector<uint32_t> split_b_index;
+	split_b_index.resize(face_count_b);
+	for (int i = 0; i < face_count_b; i++) {
+		if (face_counts_b[i] == 0) {
+			continue;
+		}
+		r_collection.build2DFacesB[i] = Build2DFaces(p_brush_b, i, p_vertex_snap);
+		split_b_index[i] = split_b.faces.size();
+		split_b.faces.push_back(&r_collection.build2DFacesB[i]);
+		split_b.other_faces_offsets.push_back(split_b.other_faces_offsets[split_b.other_faces_offsets.size() - 1] + face_counts_b[i]);
+	}
+
+	// Faces of A are visited in ascending order, so every list of B stays sorted.
+	split_b.other_faces.resize(split_b.other_faces_offsets[split_b.other_faces_offsets.size() - 1]);
+	for (int i = 0; i < face_count_b; i++) {
+		face_counts_b[i] = 0;
+	}
+	for (int i = 0; i < face_count_a; i++) {
+		const FaceIntersectionQuery::Result &result = query.results[i];
+		if (result.degenerate_hit) {
+			continue;
+		}
+		for (uint32_t j = 0; j < result.faces_b.size(); j++) {
+			const int face_idx_b = result.faces_b[j];
+			const uint32_t index = split_b_index[face_idx_b];
+			split_b.other_faces[split_b.other_faces_offsets[index] + face_counts_b[face_idx_b]++] = i;
+		}
+	}
+
+	_do_work(work_pool, split_a.faces.size(), this, &CSGBrushOperation::_split_face, &split_a);
+	_do_work(work_pool, split_b.faces.size(), this, &CSGBrushOperation::_split_face, &split_b);
 }
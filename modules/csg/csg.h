@@ -32,14 +32,17 @@
 #define CSG_H
 
 #include "core/math/aabb.h"
+#include "core/math/dynamic_bvh.h"
 #include "core/math/plane.h"
 #include "core/math/transform_3d.h"
 #include "core/math/vector2.h"
 #include "core/math/vector3.h"
 #include "core/object/ref_counted.h"
 #include "core/templates/list.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/map.h"
 #include "core/templates/oa_hash_map.h"
+#include "core/templates/thread_work_pool.h"
 #include "core/templates/vector.h"
 #include "scene/resources/material.h"
 
@@ -70,6 +73,9 @@ struct CSGBrushOperation {
 		OPERATION_SUBSTRACTION,
 	};
 
+	// If set, face intersections and inside faces are computed on its threads.
+	ThreadWorkPool *work_pool = nullptr;
+
 	void merge_brushes(Operation p_operation, const CSGBrush &p_brush_a, const CSGBrush &p_brush_b, CSGBrush &r_merged_brush, float p_vertex_snap);
 
 	struct MeshMerge {
@@ -144,12 +150,21 @@ struct CSGBrushOperation {
 		OAHashMap<VertexKey, int, VertexKeyHash> snap_cache;
 		float vertex_snap = 0.0;
 
+		struct InsideQuery {
+			FaceBVH *facebvh = nullptr;
+			int max_depth = 0;
+			int bvh_first = 0;
+			AABB intersection_aabb;
+			LocalVector<uint8_t> inside;
+		};
+
 		inline void _add_distance(List<real_t> &r_intersectionsA, List<real_t> &r_intersectionsB, bool p_from_B, real_t p_distance) const;
 		inline bool _bvh_inside(FaceBVH *facebvhptr, int p_max_depth, int p_bvh_first, int p_face_idx) const;
 		inline int _create_bvh(FaceBVH *facebvhptr, FaceBVH **facebvhptrptr, int p_from, int p_size, int p_depth, int &r_max_depth, int &r_max_alloc);
+		void _mark_inside_face(uint32_t p_face_idx, InsideQuery *p_query);
 
 		void add_face(const Vector3 p_points[3], const Vector2 p_uvs[3], bool p_smooth, bool p_invert, const Ref<Material> &p_material, bool p_from_b);
-		void mark_inside_faces();
+		void mark_inside_faces(ThreadWorkPool *p_work_pool = nullptr);
 	};
 
 	struct Build2DFaces {
@@ -188,7 +203,34 @@ struct CSGBrushOperation {
 		Map<int, Build2DFaces> build2DFacesB;
 	};
 
-	void update_faces(const CSGBrush &p_brush_a, const int p_face_idx_a, const CSGBrush &p_brush_b, const int p_face_idx_b, Build2DFaceCollection &p_collection, float p_vertex_snap);
+	// Faces of the other brush that intersect each face of brush A.
+	struct FaceIntersectionQuery {
+		const CSGBrush *brush_a = nullptr;
+		const CSGBrush *brush_b = nullptr;
+		DynamicBVH *bvh_b = nullptr;
+		LocalVector<uint8_t> degenerate_a;
+		LocalVector<uint8_t> degenerate_b;
+
+		struct Result {
+			LocalVector<int> faces_b;
+			LocalVector<int> degenerate_faces_b;
+			bool degenerate_hit = false;
+		};
+		LocalVector<Result> results;
+	};
+
+	// Splits each face by the faces it intersects with, in ascending order.
+	struct FaceSplitQuery {
+		const CSGBrush *other_brush = nullptr;
+		LocalVector<Build2DFaces *> faces;
+		LocalVector<uint32_t> other_faces_offsets;
+		LocalVector<int> other_faces;
+	};
+
+	static bool _faces_intersect(const Vector3 p_vertices_a[3], const Vector3 p_vertices_b[3]);
+	void _find_face_intersections(uint32_t p_face_idx_a, FaceIntersectionQuery *p_query);
+	void _split_face(uint32_t p_index, FaceSplitQuery *p_query);
+	void _collect_face_intersections(const CSGBrush &p_brush_a, const CSGBrush &p_brush_b, Build2DFaceCollection &r_collection, float p_vertex_snap);
 };
 
 #endif // CSG_H
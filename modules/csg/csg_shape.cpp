@@ -132,13 +132,17 @@ float CSGShape3D::get_snap() const {
 	return snap;
 }
 
-void CSGShape3D::_make_dirty() {
+void CSGShape3D::_make_dirty(bool p_children_only) {
+	if (!p_children_only) {
+		base_dirty = true;
+	}
+
 	if (!is_inside_tree()) {
 		return;
 	}
 
 	if (parent) {
-		parent->_make_dirty();
+		parent->_make_dirty(true);
 	} else if (!dirty) {
 		call_deferred("_update_shape");
 	}
@@ -146,14 +150,29 @@ void CSGShape3D::_make_dirty() {
 	dirty = true;
 }
 
+void CSGShape3D::_clear_merged_children(uint32_t p_from) {
+	for (uint32_t i = p_from; i < merged_children.size(); i++) {
+		memdelete(merged_children[i].result);
+	}
+	if (p_from < merged_children.size()) {
+		merged_children.resize(p_from);
+	}
+}
+
 CSGBrush *CSGShape3D::_get_brush() {
 	if (dirty) {
-		if (brush) {
-			memdelete(brush);
+		if (base_dirty) {
+			// Every merge depends on this node's own brush.
+			_clear_merged_children();
+			if (base_brush) {
+				memdelete(base_brush);
+			}
+			base_brush = _build_brush();
+			base_dirty = false;
 		}
-		brush = nullptr;
 
-		CSGBrush *n = _build_brush();
+		CSGBrush *n = base_brush;
+		uint32_t merged_count = 0;
 
 		for (int i = 0; i < get_child_count(); i++) {
 			CSGShape3D *child = Object::cast_to<CSGShape3D>(get_child(i));
@@ -168,35 +187,57 @@ CSGBrush *CSGShape3D::_get_brush() {
 			if (!n2) {
 				continue;
 			}
-			if (!n) {
-				n = memnew(CSGBrush);
 
-				n->copy_from(*n2, child->get_transform());
+			if (merged_count < merged_children.size()) {
+				const MergedChild &merged = merged_children[merged_count];
+				if (merged.child == child->get_instance_id() && merged.child_brush_version == child->brush_version && merged.transform == child->get_transform() && merged.operation == child->get_operation()) {
+					// Same result as the last update.
+					n = merged.result;
+					merged_count++;
+					continue;
+				}
+				_clear_merged_children(merged_count);
+			}
+
+			CSGBrush *nn = memnew(CSGBrush);
+			if (!n) {
+				nn->copy_from(*n2, child->get_transform());
 
 			} else {
-				CSGBrush *nn = memnew(CSGBrush);
-				CSGBrush *nn2 = memnew(CSGBrush);
-				nn2->copy_from(*n2, child->get_transform());
+				CSGBrush nn2;
+				nn2.copy_from(*n2, child->get_transform());
 
 				CSGBrushOperation bop;
+				bop.work_pool = is_inside_tree() ? get_tree()->get_thread_work_pool_for_main_thread() : nullptr;
 
 				switch (child->get_operation()) {
 					case CSGShape3D::OPERATION_UNION:
-						bop.merge_brushes(CSGBrushOperation::OPERATION_UNION, *n, *nn2, *nn, snap);
+						bop.merge_brushes(CSGBrushOperation::OPERATION_UNION, *n, nn2, *nn, snap);
 						break;
 					case CSGShape3D::OPERATION_INTERSECTION:
-						bop.merge_brushes(CSGBrushOperation::OPERATION_INTERSECTION, *n, *nn2, *nn, snap);
+						bop.merge_brushes(CSGBrushOperation::OPERATION_INTERSECTION, *n, nn2, *nn, snap);
 						break;
 					case CSGShape3D::OPERATION_SUBTRACTION:
-						bop.merge_brushes(CSGBrushOperation::OPERATION_SUBSTRACTION, *n, *nn2, *nn, snap);
+						bop.merge_brushes(CSGBrushOperation::OPERATION_SUBSTRACTION, *n, nn2, *nn, snap);
 						break;
 				}
-				memdelete(n);
-				memdelete(nn2);
-				n = nn;
 			}
+
+			MergedChild merged;
+			merged.child = child->get_instance_id();
+			merged.child_brush_version = child->brush_version;
+			merged.transform = child->get_transform();
+			merged.operation = child->get_operation();
+			merged.result = nn;
+			merged_children.push_back(merged);
+			merged_count++;
+			merge_count++;
+			n = nn;
 		}
 
+		// Children removed since the last update.
+		_clear_merged_children(merged_count);
+
 		if (n) {
 			AABB aabb;
 			for (int i = 0; i < n->faces.size(); i++) {
@@ -214,6 +255,7 @@ CSGBrush *CSGShape3D::_get_brush() {
 		}
 
 		brush = n;
+		brush_version++;
 
 		dirty = false;
 	}
@@ -482,6 +524,10 @@ Vector<Vector3> CSGShape3D::get_brush_faces() {
 	return faces;
 }
 
+uint64_t CSGShape3D::get_merge_count() const {
+	return merge_count;
+}
+
 Vector<Face3> CSGShape3D::get_faces(uint32_t p_usage_flags) const {
 	return Vector<Face3>();
 }
@@ -520,19 +566,19 @@ void CSGShape3D::_notification(int p_what) {
 
 	if (p_what == NOTIFICATION_LOCAL_TRANSFORM_CHANGED) {
 		if (parent) {
-			parent->_make_dirty();
+			parent->_make_dirty(true);
 		}
 	}
 
 	if (p_what == NOTIFICATION_VISIBILITY_CHANGED) {
 		if (parent) {
-			parent->_make_dirty();
+			parent->_make_dirty(true);
 		}
 	}
 
 	if (p_what == NOTIFICATION_EXIT_TREE) {
 		if (parent) {
-			parent->_make_dirty();
+			parent->_make_dirty(true);
 		}
 		parent = nullptr;
 
@@ -547,7 +593,7 @@ void CSGShape3D::_notification(int p_what) {
 
 void CSGShape3D::set_operation(Operation p_operation) {
 	operation = p_operation;
-	_make_dirty();
+	_make_dirty(true); // The brush of this node doesn't depend on how it's merged into its parent.
 	update_gizmo();
 }
 
@@ -635,10 +681,12 @@ CSGShape3D::CSGShape3D() {
 }
 
 CSGShape3D::~CSGShape3D() {
-	if (brush) {
-		memdelete(brush);
-		brush = nullptr;
+	_clear_merged_children();
+	if (base_brush) {
+		memdelete(base_brush);
+		base_brush = nullptr;
 	}
+	brush = nullptr;
 }
 
 //////////////////////////////////
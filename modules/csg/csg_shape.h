@@ -53,11 +53,25 @@ private:
 	Operation operation = OPERATION_UNION;
 	CSGShape3D *parent = nullptr;
 
-	CSGBrush *brush = nullptr;
+	CSGBrush *brush = nullptr; // Owned by base_brush or merged_children.
+	CSGBrush *base_brush = nullptr;
+	uint64_t brush_version = 0;
+
+	// Brush after merging each child, reused while the children up to it don't change.
+	struct MergedChild {
+		ObjectID child;
+		uint64_t child_brush_version = 0;
+		Transform3D transform;
+		Operation operation = OPERATION_UNION;
+		CSGBrush *result = nullptr;
+	};
+	LocalVector<MergedChild> merged_children;
+	uint64_t merge_count = 0;
 
 	AABB node_aabb;
 
 	bool dirty = false;
+	bool base_dirty = true;
 	float snap = 0.001;
 
 	bool use_collision = false;
@@ -103,11 +117,12 @@ private:
 			const tbool bIsOrientationPreserving, const int iFace, const int iVert);
 
 	void _update_shape();
+	void _clear_merged_children(uint32_t p_from = 0);
 
 protected:
 	void _notification(int p_what);
 	virtual CSGBrush *_build_brush() = 0;
-	void _make_dirty();
+	void _make_dirty(bool p_children_only = false);
 
 	static void _bind_methods();
 
@@ -123,6 +138,8 @@ public:
 	Operation get_operation() const;
 
 	virtual Vector<Vector3> get_brush_faces();
+	// Number of children merged into this shape so far, reused results excluded.
+	uint64_t get_merge_count() const;
 
 	virtual AABB get_aabb() const override;
 	virtual Vector<Face3> get_faces(uint32_t p_usage_flags) const override;
@@ -0,0 +1,253 @@
+/*************************************************************************/
+/*  test_csg.h                                                           */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_CSG_H
+#define TEST_CSG_H
+
+#include "core/os/memory.h"
+#include "core/os/os.h"
+#include "modules/csg/csg.h"
+#include "modules/csg/csg_shape.h"
+
+#include "tests/test_macros.h"
+#include "tests/test_scene_tree.h"
+
+namespace TestCSG {
+
+// A box with every side split in p_subdivisions x p_subdivisions quads.
+static void create_box_brush(CSGBrush &r_brush, const Vector3 &p_center, real_t p_size, int p_subdivisions) {
+	Vector<Vector3> vertices;
+	Vector<Vector2> uvs;
+	Vector<bool> smooth;
+	Vector<Ref<Material>> materials;
+	Vector<bool> invert;
+
+	for (int axis = 0; axis < 3; axis++) {
+		for (int sign = -1; sign <= 1; sign += 2) {
+			Vector3 normal;
+			normal[axis] = sign;
+			Vector3 tangent;
+			tangent[(axis + 1) % 3] = 1;
+			Vector3 bitangent;
+			bitangent[(axis + 2) % 3] = 1;
+			if (sign < 0) {
+				SWAP(tangent, bitangent);
+			}
+
+			for (int v = 0; v < p_subdivisions; v++) {
+				for (int u = 0; u < p_subdivisions; u++) {
+					Vector3 quad[4];
+					for (int k = 0; k < 4; k++) {
+						const real_t qu = real_t(u + (k == 1 || k == 2)) / p_subdivisions - 0.5;
+						const real_t qv = real_t(v + (k >= 2)) / p_subdivisions - 0.5;
+						quad[k] = p_center + (normal * 0.5 + tangent * qu + bitangent * qv) * p_size;
+					}
+					const int triangles[6] = { 0, 1, 2, 0, 2, 3 };
+					for (int k = 0; k < 6; k++) {
+						vertices.push_back(quad[triangles[k]]);
+						uvs.push_back(Vector2());
+					}
+					for (int k = 0; k < 2; k++) {
+						smooth.push_back(false);
+						materials.push_back(Ref<Material>());
+						invert.push_back(false);
+					}
+				}
+			}
+		}
+	}
+
+	r_brush.build_from_faces(vertices, uvs, smooth, materials, invert);
+}
+
+static real_t get_brush_volume(const CSGBrush &p_brush) {
+	real_t volume = 0;
+	for (int i = 0; i < p_brush.faces.size(); i++) {
+		const Vector3 *v = p_brush.faces[i].vertices;
+		volume += v[0].dot(v[1].cross(v[2])) / 6.0;
+	}
+	return Math::abs(volume);
+}
+
+static bool are_brushes_equal(const CSGBrush &p_a, const CSGBrush &p_b) {
+	if (p_a.faces.size() != p_b.faces.size()) {
+		return false;
+	}
+	for (int i = 0; i < p_a.faces.size(); i++) {
+		for (int j = 0; j < 3; j++) {
+			if (p_a.faces[i].vertices[j] != p_b.faces[i].vertices[j]) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+TEST_CASE("[CSG] Boolean operations") {
+	CSGBrush box_a;
+	CSGBrush box_b;
+	create_box_brush(box_a, Vector3(), 1, 4);
+	create_box_brush(box_b, Vector3(0.5, 0.25, 0.25), 1, 4);
+	CHECK(Math::is_equal_approx(get_brush_volume(box_a), (real_t)1, (real_t)0.001));
+
+	// The boxes overlap in a 0.5 x 0.75 x 0.75 box.
+	const real_t overlap = 0.28125;
+	CSGBrushOperation bop;
+	CSGBrush result;
+	bop.merge_brushes(CSGBrushOperation::OPERATION_UNION, box_a, box_b, result, 0.001);
+	CHECK(Math::is_equal_approx(get_brush_volume(result), 2 - overlap, (real_t)0.001));
+	bop.merge_brushes(CSGBrushOperation::OPERATION_INTERSECTION, box_a, box_b, result, 0.001);
+	CHECK(Math::is_equal_approx(get_brush_volume(result), overlap, (real_t)0.001));
+	bop.merge_brushes(CSGBrushOperation::OPERATION_SUBSTRACTION, box_a, box_b, result, 0.001);
+	CHECK(Math::is_equal_approx(get_brush_volume(result), 1 - overlap, (real_t)0.001));
+
+	// Brushes that don't touch are kept as they are.
+	CSGBrush box_far;
+	create_box_brush(box_far, Vector3(10, 0, 0), 1, 4);
+	bop.merge_brushes(CSGBrushOperation::OPERATION_UNION, box_a, box_far, result, 0.001);
+	CHECK(result.faces.size() == box_a.faces.size() + box_far.faces.size());
+	bop.merge_brushes(CSGBrushOperation::OPERATION_INTERSECTION, box_a, box_far, result, 0.001);
+	CHECK(result.faces.size() == 0);
+}
+
+TEST_CASE("[CSG] Threaded operations give the same result") {
+	CSGBrush box_a;
+	CSGBrush box_b;
+	create_box_brush(box_a, Vector3(), 1, 16);
+	create_box_brush(box_b, Vector3(0.3, 0.4, 0.1), 0.8, 16);
+
+	ThreadWorkPool work_pool;
+	work_pool.init(4);
+
+	for (int operation = CSGBrushOperation::OPERATION_UNION; operation <= CSGBrushOperation::OPERATION_SUBSTRACTION; operation++) {
+		CSGBrushOperation serial_bop;
+		CSGBrush serial_result;
+		serial_bop.merge_brushes((CSGBrushOperation::Operation)operation, box_a, box_b, serial_result, 0.001);
+
+		CSGBrushOperation threaded_bop;
+		threaded_bop.work_pool = &work_pool;
+		CSGBrush threaded_result;
+		threaded_bop.merge_brushes((CSGBrushOperation::Operation)operation, box_a, box_b, threaded_result, 0.001);
+
+		CHECK(serial_result.faces.size() > 0);
+		CHECK(are_brushes_equal(serial_result, threaded_result));
+	}
+
+	work_pool.finish();
+}
+
+TEST_CASE("[CSG] Changing a child only merges the children after it again") {
+	TestSceneTree::HeadlessSceneTree headless;
+
+	CSGCombiner3D *combiner = memnew(CSGCombiner3D);
+	CSGBox3D *boxes[3];
+	for (int i = 0; i < 3; i++) {
+		boxes[i] = memnew(CSGBox3D);
+		boxes[i]->set_position(Vector3(i * 0.5, i * 0.2, 0));
+		combiner->add_child(boxes[i]);
+	}
+	boxes[1]->set_operation(CSGShape3D::OPERATION_SUBTRACTION);
+	headless.tree->get_root()->add_child(combiner);
+
+	const Vector<Vector3> faces = combiner->get_brush_faces();
+	CHECK(faces.size() > 0);
+	CHECK(combiner->get_merge_count() == 3);
+
+	boxes[2]->set_size(Vector3(2, 1, 1));
+	const Vector<Vector3> changed_faces = combiner->get_brush_faces();
+	CHECK_MESSAGE(combiner->get_merge_count() == 4, "Only the last child should be merged again.");
+	boxes[2]->set_size(Vector3(1, 1, 1));
+	CHECK(combiner->get_brush_faces() == faces);
+	CHECK(combiner->get_merge_count() == 5);
+
+	boxes[1]->set_operation(CSGShape3D::OPERATION_INTERSECTION);
+	combiner->get_brush_faces();
+	CHECK_MESSAGE(combiner->get_merge_count() == 7, "The middle child and the one after it should be merged again.");
+	boxes[1]->set_operation(CSGShape3D::OPERATION_SUBTRACTION);
+	CHECK(combiner->get_brush_faces() == faces);
+	CHECK(combiner->get_merge_count() == 9);
+
+	boxes[0]->set_position(Vector3(0, -0.1, 0));
+	boxes[0]->set_position(Vector3());
+	CHECK(combiner->get_brush_faces() == faces);
+	CHECK(combiner->get_merge_count() == 12);
+
+	// Nothing changed, everything is reused.
+	CHECK(combiner->get_brush_faces() == faces);
+	CHECK(combiner->get_merge_count() == 12);
+
+	// A combiner built from scratch in the changed state gives the same faces.
+	CSGCombiner3D *reference = memnew(CSGCombiner3D);
+	for (int i = 0; i < 3; i++) {
+		CSGBox3D *box = memnew(CSGBox3D);
+		box->set_position(Vector3(i * 0.5, i * 0.2, 0));
+		box->set_size(i == 2 ? Vector3(2, 1, 1) : Vector3(1, 1, 1));
+		box->set_operation(i == 1 ? CSGShape3D::OPERATION_SUBTRACTION : CSGShape3D::OPERATION_UNION);
+		reference->add_child(box);
+	}
+	headless.tree->get_root()->add_child(reference);
+	CHECK(reference->get_brush_faces() == changed_faces);
+}
+
+TEST_CASE_BENCHMARK("[CSG][Benchmark] Merge a nested tree of 100k faces") {
+	// 8 boxes of 13824 faces each, merged two by two, then the pairs merged together.
+	CSGBrush boxes[8];
+	for (int i = 0; i < 8; i++) {
+		create_box_brush(boxes[i], Vector3(i * 0.35, (i % 3) * 0.2, (i % 2) * 0.3), 1, 48);
+	}
+
+	ThreadWorkPool work_pool;
+	work_pool.init();
+
+	for (int threaded = 0; threaded < 2; threaded++) {
+		CSGBrushOperation bop;
+		bop.work_pool = threaded ? &work_pool : nullptr;
+
+		const uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		CSGBrush level[4];
+		for (int i = 0; i < 4; i++) {
+			bop.merge_brushes(i % 2 ? CSGBrushOperation::OPERATION_SUBSTRACTION : CSGBrushOperation::OPERATION_UNION, boxes[i * 2], boxes[i * 2 + 1], level[i], 0.001);
+		}
+		CSGBrush left;
+		CSGBrush right;
+		bop.merge_brushes(CSGBrushOperation::OPERATION_UNION, level[0], level[1], left, 0.001);
+		bop.merge_brushes(CSGBrushOperation::OPERATION_UNION, level[2], level[3], right, 0.001);
+		CSGBrush result;
+		bop.merge_brushes(CSGBrushOperation::OPERATION_UNION, left, right, result, 0.001);
+
+		MESSAGE((threaded ? "Threaded: " : "Single thread: "), ((OS::get_singleton()->get_ticks_usec() - begin) / 1000), " ms, ", result.faces.size(), " faces.");
+	}
+
+	work_pool.finish();
+}
+
+} // namespace TestCSG
+
+#endif // TEST_CSG_H
@@ -52,6 +52,7 @@
 #include "core/io/file_access.h"
 #include "core/io/json.h"
 #include "core/math/disjoint_set.h"
+#include "core/templates/thread_work_pool.h"
 #include "core/variant/typed_array.h"
 #include "core/version.h"
 #include "core/version_hash.gen.h"
@@ -235,11 +236,8 @@ Error GLTFDocument::_parse_json(const String &p_path, Ref<GLTFState> state) {
 	Vector<uint8_t> array;
 	array.resize(f->get_length());
 	f->get_buffer(array.ptrw(), array.size());
-	String text;
-	text.parse_utf8((const char *)array.ptr(), array.size());
-
 	JSON json;
-	err = json.parse(text);
+	err = json.parse_utf8(array);
 	if (err != OK) {
 		_err_print_error("", p_path.utf8().get_data(), json.get_error_line(), json.get_error_message().utf8().get_data(), ERR_HANDLER_SCRIPT);
 		return err;
@@ -294,11 +292,8 @@ Error GLTFDocument::_parse_glb(const String &p_path, Ref<GLTFState> state) {
 	uint32_t len = f->get_buffer(json_data.ptrw(), chunk_length);
 	ERR_FAIL_COND_V(len != chunk_length, ERR_FILE_CORRUPT);
 
-	String text;
-	text.parse_utf8((const char *)json_data.ptr(), json_data.size());
-
 	JSON json;
-	err = json.parse(text);
+	err = json.parse_utf8(json_data);
 	if (err != OK) {
 		_err_print_error("", p_path.utf8().get_data(), json.get_error_line(), json.get_error_message().utf8().get_data(), ERR_HANDLER_SCRIPT);
 		return err;
@@ -1275,7 +1270,37 @@ Error GLTFDocument::_encode_buffer_view(Ref<GLTFState> state, const double *src,
 	return OK;
 }
 
-Error GLTFDocument::_decode_buffer_view(Ref<GLTFState> state, double *dst, const GLTFBufferViewIndex p_buffer_view, const int skip_every, const int skip_bytes, const int element_size, const int count, const GLTFType type, const int component_count, const int component_type, const int component_size, const bool normalized, const int byte_offset, const bool for_vertex) {
+template <class T>
+static _FORCE_INLINE_ T _decode_component(const uint8_t *p_src, const int p_component_type, const bool p_normalized) {
+	switch (p_component_type) {
+		case GLTFDocument::COMPONENT_TYPE_BYTE: {
+			int8_t b = int8_t(*p_src);
+			return p_normalized ? T(double(b) / 128.0) : T(b);
+		}
+		case GLTFDocument::COMPONENT_TYPE_UNSIGNED_BYTE: {
+			uint8_t b = *p_src;
+			return p_normalized ? T(double(b) / 255.0) : T(b);
+		}
+		case GLTFDocument::COMPONENT_TYPE_SHORT: {
+			int16_t s = *(int16_t *)p_src;
+			return p_normalized ? T(double(s) / 32768.0) : T(s);
+		}
+		case GLTFDocument::COMPONENT_TYPE_UNSIGNED_SHORT: {
+			uint16_t s = *(uint16_t *)p_src;
+			return p_normalized ? T(double(s) / 65535.0) : T(s);
+		}
+		case GLTFDocument::COMPONENT_TYPE_INT: {
+			return T(*(int *)p_src);
+		}
+		case GLTFDocument::COMPONENT_TYPE_FLOAT: {
+			return T(*(float *)p_src);
+		}
+	}
+	return T(0);
+}
+
+template <class T>
+Error GLTFDocument::_decode_buffer_view(Ref<GLTFState> state, T *dst, const int dst_stride, const GLTFBufferViewIndex p_buffer_view, const int skip_every, const int skip_bytes, const int element_size, const int count, const GLTFType type, const int component_count, const int component_type, const int component_size, const bool normalized, const int byte_offset, const bool for_vertex) {
 	const Ref<GLTFBufferView> bv = state->buffer_views[p_buffer_view];
 
 	int stride = element_size;
@@ -1289,7 +1314,7 @@ Error GLTFDocument::_decode_buffer_view(Ref<GLTFState> state, double *dst, const
 	ERR_FAIL_INDEX_V(bv->buffer, state->buffers.size(), ERR_PARSE_ERROR);
 
 	const uint32_t offset = bv->byte_offset + byte_offset;
-	Vector<uint8_t> buffer = state->buffers[bv->buffer]; //copy on write, so no performance hit
+	const Vector<uint8_t> &buffer = state->buffers[bv->buffer];
 	const uint8_t *bufptr = buffer.ptr();
 
 	//use to debug
@@ -1301,60 +1326,22 @@ Error GLTFDocument::_decode_buffer_view(Ref<GLTFState> state, double *dst, const
 
 	ERR_FAIL_COND_V((int)(offset + buffer_end) > buffer.size(), ERR_PARSE_ERROR);
 
-	//fill everything as doubles
+	if (std::is_same<T, float>::value && component_type == COMPONENT_TYPE_FLOAT && !skip_every && stride == element_size && dst_stride == component_count) {
+		// Tightly packed floats are already in the layout of the destination array.
+		memcpy(dst, &bufptr[offset], count * element_size);
+		return OK;
+	}
 
 	for (int i = 0; i < count; i++) {
 		const uint8_t *src = &bufptr[offset + i * stride];
+		T *element = &dst[i * dst_stride];
 
 		for (int j = 0; j < component_count; j++) {
 			if (skip_every && j > 0 && (j % skip_every) == 0) {
 				src += skip_bytes;
 			}
 
-			double d = 0;
-
-			switch (component_type) {
-				case COMPONENT_TYPE_BYTE: {
-					int8_t b = int8_t(*src);
-					if (normalized) {
-						d = (double(b) / 128.0);
-					} else {
-						d = double(b);
-					}
-				} break;
-				case COMPONENT_TYPE_UNSIGNED_BYTE: {
-					uint8_t b = *src;
-					if (normalized) {
-						d = (double(b) / 255.0);
-					} else {
-						d = double(b);
-					}
-				} break;
-				case COMPONENT_TYPE_SHORT: {
-					int16_t s = *(int16_t *)src;
-					if (normalized) {
-						d = (double(s) / 32768.0);
-					} else {
-						d = double(s);
-					}
-				} break;
-				case COMPONENT_TYPE_UNSIGNED_SHORT: {
-					uint16_t s = *(uint16_t *)src;
-					if (normalized) {
-						d = (double(s) / 65535.0);
-					} else {
-						d = double(s);
-					}
-				} break;
-				case COMPONENT_TYPE_INT: {
-					d = *(int *)src;
-				} break;
-				case COMPONENT_TYPE_FLOAT: {
-					d = *(float *)src;
-				} break;
-			}
-
-			*dst++ = d;
+			element[j] = _decode_component<T>(src, component_type, normalized);
 			src += component_size;
 		}
 	}
@@ -1383,21 +1370,26 @@ int GLTFDocument::_get_component_type_size(const int component_type) {
 	return 0;
 }
 
-Vector<double> GLTFDocument::_decode_accessor(Ref<GLTFState> state, const GLTFAccessorIndex p_accessor, const bool p_for_vertex) {
+int GLTFDocument::_get_component_count(const GLTFType p_type) {
+	const int component_count_for_type[7] = {
+		1, 2, 3, 4, 4, 9, 16
+	};
+	ERR_FAIL_INDEX_V(p_type, 7, 0);
+	return component_count_for_type[p_type];
+}
+
+template <class T>
+Error GLTFDocument::_decode_accessor_components(Ref<GLTFState> state, const GLTFAccessorIndex p_accessor, const bool p_for_vertex, T *r_dst, const int p_dst_stride) {
 	//spec, for reference:
 	//https://github.com/KhronosGroup/glTF/tree/master/specification/2.0#data-alignment
 
-	ERR_FAIL_INDEX_V(p_accessor, state->accessors.size(), Vector<double>());
+	ERR_FAIL_INDEX_V(p_accessor, state->accessors.size(), ERR_INVALID_PARAMETER);
 
 	const Ref<GLTFAccessor> a = state->accessors[p_accessor];
 
-	const int component_count_for_type[7] = {
-		1, 2, 3, 4, 4, 9, 16
-	};
-
-	const int component_count = component_count_for_type[a->type];
+	const int component_count = _get_component_count(a->type);
 	const int component_size = _get_component_type_size(a->component_type);
-	ERR_FAIL_COND_V(component_size == 0, Vector<double>());
+	ERR_FAIL_COND_V(component_size == 0, ERR_PARSE_ERROR);
 	int element_size = component_count * component_size;
 
 	int skip_every = 0;
@@ -1429,51 +1421,63 @@ Vector<double> GLTFDocument::_decode_accessor(Ref<GLTFState> state, const GLTFAc
 		}
 	}
 
-	Vector<double> dst_buffer;
-	dst_buffer.resize(component_count * a->count);
-	double *dst = dst_buffer.ptrw();
-
 	if (a->buffer_view >= 0) {
-		ERR_FAIL_INDEX_V(a->buffer_view, state->buffer_views.size(), Vector<double>());
+		ERR_FAIL_INDEX_V(a->buffer_view, state->buffer_views.size(), ERR_PARSE_ERROR);
 
-		const Error err = _decode_buffer_view(state, dst, a->buffer_view, skip_every, skip_bytes, element_size, a->count, a->type, component_count, a->component_type, component_size, a->normalized, a->byte_offset, p_for_vertex);
+		const Error err = _decode_buffer_view(state, r_dst, p_dst_stride, a->buffer_view, skip_every, skip_bytes, element_size, a->count, a->type, component_count, a->component_type, component_size, a->normalized, a->byte_offset, p_for_vertex);
 		if (err != OK) {
-			return Vector<double>();
+			return err;
 		}
 	} else {
 		//fill with zeros, as bufferview is not defined.
-		for (int i = 0; i < (a->count * component_count); i++) {
-			dst_buffer.write[i] = 0;
+		for (int i = 0; i < a->count; i++) {
+			for (int j = 0; j < component_count; j++) {
+				r_dst[i * p_dst_stride + j] = T(0);
+			}
 		}
 	}
 
 	if (a->sparse_count > 0) {
 		// I could not find any file using this, so this code is so far untested
-		Vector<double> indices;
+		Vector<int> indices;
 		indices.resize(a->sparse_count);
 		const int indices_component_size = _get_component_type_size(a->sparse_indices_component_type);
 
-		Error err = _decode_buffer_view(state, indices.ptrw(), a->sparse_indices_buffer_view, 0, 0, indices_component_size, a->sparse_count, TYPE_SCALAR, 1, a->sparse_indices_component_type, indices_component_size, false, a->sparse_indices_byte_offset, false);
+		Error err = _decode_buffer_view(state, indices.ptrw(), 1, a->sparse_indices_buffer_view, 0, 0, indices_component_size, a->sparse_count, TYPE_SCALAR, 1, a->sparse_indices_component_type, indices_component_size, false, a->sparse_indices_byte_offset, false);
 		if (err != OK) {
-			return Vector<double>();
+			return err;
 		}
 
-		Vector<double> data;
+		Vector<T> data;
 		data.resize(component_count * a->sparse_count);
-		err = _decode_buffer_view(state, data.ptrw(), a->sparse_values_buffer_view, skip_every, skip_bytes, element_size, a->sparse_count, a->type, component_count, a->component_type, component_size, a->normalized, a->sparse_values_byte_offset, p_for_vertex);
+		err = _decode_buffer_view(state, data.ptrw(), component_count, a->sparse_values_buffer_view, skip_every, skip_bytes, element_size, a->sparse_count, a->type, component_count, a->component_type, component_size, a->normalized, a->sparse_values_byte_offset, p_for_vertex);
 		if (err != OK) {
-			return Vector<double>();
+			return err;
 		}
 
 		for (int i = 0; i < indices.size(); i++) {
-			const int write_offset = int(indices[i]) * component_count;
+			ERR_FAIL_INDEX_V(indices[i], a->count, ERR_PARSE_ERROR);
+			const int write_offset = indices[i] * p_dst_stride;
 
 			for (int j = 0; j < component_count; j++) {
-				dst[write_offset + j] = data[i * component_count + j];
+				r_dst[write_offset + j] = data[i * component_count + j];
 			}
 		}
 	}
 
+	return OK;
+}
+
+Vector<double> GLTFDocument::_decode_accessor(Ref<GLTFState> state, const GLTFAccessorIndex p_accessor, const bool p_for_vertex) {
+	ERR_FAIL_INDEX_V(p_accessor, state->accessors.size(), Vector<double>());
+	const Ref<GLTFAccessor> a = state->accessors[p_accessor];
+	const int component_count = _get_component_count(a->type);
+
+	Vector<double> dst_buffer;
+	dst_buffer.resize(component_count * a->count);
+	if (_decode_accessor_components(state, p_accessor, p_for_vertex, dst_buffer.ptrw(), component_count) != OK) {
+		return Vector<double>();
+	}
 	return dst_buffer;
 }
 
@@ -1531,39 +1535,27 @@ GLTFAccessorIndex GLTFDocument::_encode_accessor_as_ints(Ref<GLTFState> state, c
 }
 
 Vector<int> GLTFDocument::_decode_accessor_as_ints(Ref<GLTFState> state, const GLTFAccessorIndex p_accessor, const bool p_for_vertex) {
-	const Vector<double> attribs = _decode_accessor(state, p_accessor, p_for_vertex);
 	Vector<int> ret;
+	ERR_FAIL_INDEX_V(p_accessor, state->accessors.size(), ret);
+	const Ref<GLTFAccessor> a = state->accessors[p_accessor];
+	const int component_count = _get_component_count(a->type);
 
-	if (attribs.size() == 0) {
-		return ret;
-	}
-
-	const double *attribs_ptr = attribs.ptr();
-	const int ret_size = attribs.size();
-	ret.resize(ret_size);
-	{
-		for (int i = 0; i < ret_size; i++) {
-			ret.write[i] = int(attribs_ptr[i]);
-		}
+	ret.resize(component_count * a->count);
+	if (_decode_accessor_components(state, p_accessor, p_for_vertex, ret.ptrw(), component_count) != OK) {
+		return Vector<int>();
 	}
 	return ret;
 }
 
 Vector<float> GLTFDocument::_decode_accessor_as_floats(Ref<GLTFState> state, const GLTFAccessorIndex p_accessor, const bool p_for_vertex) {
-	const Vector<double> attribs = _decode_accessor(state, p_accessor, p_for_vertex);
 	Vector<float> ret;
+	ERR_FAIL_INDEX_V(p_accessor, state->accessors.size(), ret);
+	const Ref<GLTFAccessor> a = state->accessors[p_accessor];
+	const int component_count = _get_component_count(a->type);
 
-	if (attribs.size() == 0) {
-		return ret;
-	}
-
-	const double *attribs_ptr = attribs.ptr();
-	const int ret_size = attribs.size();
-	ret.resize(ret_size);
-	{
-		for (int i = 0; i < ret_size; i++) {
-			ret.write[i] = float(attribs_ptr[i]);
-		}
+	ret.resize(component_count * a->count);
+	if (_decode_accessor_components(state, p_accessor, p_for_vertex, ret.ptrw(), component_count) != OK) {
+		return Vector<float>();
 	}
 	return ret;
 }
@@ -1825,21 +1817,21 @@ GLTFAccessorIndex GLTFDocument::_encode_accessor_as_quaternions(Ref<GLTFState> s
 }
 
 Vector<Vector2> GLTFDocument::_decode_accessor_as_vec2(Ref<GLTFState> state, const GLTFAccessorIndex p_accessor, const bool p_for_vertex) {
-	const Vector<double> attribs = _decode_accessor(state, p_accessor, p_for_vertex);
 	Vector<Vector2> ret;
+	ERR_FAIL_INDEX_V(p_accessor, state->accessors.size(), ret);
+	const Ref<GLTFAccessor> a = state->accessors[p_accessor];
+	const int component_count = _get_component_count(a->type);
+	const int size = component_count * a->count;
 
-	if (attribs.size() == 0) {
+	if (size == 0) {
 		return ret;
 	}
 
-	ERR_FAIL_COND_V(attribs.size() % 2 != 0, ret);
-	const double *attribs_ptr = attribs.ptr();
-	const int ret_size = attribs.size() / 2;
-	ret.resize(ret_size);
-	{
-		for (int i = 0; i < ret_size; i++) {
-			ret.write[i] = Vector2(attribs_ptr[i * 2 + 0], attribs_ptr[i * 2 + 1]);
-		}
+	ERR_FAIL_COND_V(size % 2 != 0, ret);
+	// Components are written straight into the Vector2 array, which is 2 packed real_t.
+	ret.resize(size / 2);
+	if (_decode_accessor_components(state, p_accessor, p_for_vertex, (real_t *)ret.ptrw(), component_count) != OK) {
+		return Vector<Vector2>();
 	}
 	return ret;
 }
@@ -2004,67 +1996,73 @@ GLTFAccessorIndex GLTFDocument::_encode_accessor_as_xform(Ref<GLTFState> state,
 }
 
 Vector<Vector3> GLTFDocument::_decode_accessor_as_vec3(Ref<GLTFState> state, const GLTFAccessorIndex p_accessor, const bool p_for_vertex) {
-	const Vector<double> attribs = _decode_accessor(state, p_accessor, p_for_vertex);
 	Vector<Vector3> ret;
+	ERR_FAIL_INDEX_V(p_accessor, state->accessors.size(), ret);
+	const Ref<GLTFAccessor> a = state->accessors[p_accessor];
+	const int component_count = _get_component_count(a->type);
+	const int size = component_count * a->count;
 
-	if (attribs.size() == 0) {
+	if (size == 0) {
 		return ret;
 	}
 
-	ERR_FAIL_COND_V(attribs.size() % 3 != 0, ret);
-	const double *attribs_ptr = attribs.ptr();
-	const int ret_size = attribs.size() / 3;
-	ret.resize(ret_size);
-	{
-		for (int i = 0; i < ret_size; i++) {
-			ret.write[i] = Vector3(attribs_ptr[i * 3 + 0], attribs_ptr[i * 3 + 1], attribs_ptr[i * 3 + 2]);
-		}
+	ERR_FAIL_COND_V(size % 3 != 0, ret);
+	// Components are written straight into the Vector3 array, which is 3 packed real_t.
+	ret.resize(size / 3);
+	if (_decode_accessor_components(state, p_accessor, p_for_vertex, (real_t *)ret.ptrw(), component_count) != OK) {
+		return Vector<Vector3>();
 	}
 	return ret;
 }
 
 Vector<Color> GLTFDocument::_decode_accessor_as_color(Ref<GLTFState> state, const GLTFAccessorIndex p_accessor, const bool p_for_vertex) {
-	const Vector<double> attribs = _decode_accessor(state, p_accessor, p_for_vertex);
 	Vector<Color> ret;
+	ERR_FAIL_INDEX_V(p_accessor, state->accessors.size(), ret);
+	const Ref<GLTFAccessor> a = state->accessors[p_accessor];
 
-	if (attribs.size() == 0) {
+	if (a->count == 0) {
 		return ret;
 	}
 
-	const int type = state->accessors[p_accessor]->type;
+	const int type = a->type;
 	ERR_FAIL_COND_V(!(type == TYPE_VEC3 || type == TYPE_VEC4), ret);
 	int vec_len = 3;
 	if (type == TYPE_VEC4) {
 		vec_len = 4;
 	}
 
-	ERR_FAIL_COND_V(attribs.size() % vec_len != 0, ret);
-	const double *attribs_ptr = attribs.ptr();
-	const int ret_size = attribs.size() / vec_len;
-	ret.resize(ret_size);
-	{
-		for (int i = 0; i < ret_size; i++) {
-			ret.write[i] = Color(attribs_ptr[i * vec_len + 0], attribs_ptr[i * vec_len + 1], attribs_ptr[i * vec_len + 2], vec_len == 4 ? attribs_ptr[i * 4 + 3] : 1.0);
+	ret.resize(a->count);
+	Color *w = ret.ptrw();
+	if (vec_len == 3) {
+		for (int i = 0; i < ret.size(); i++) {
+			w[i].a = 1.0;
 		}
 	}
+	if (_decode_accessor_components(state, p_accessor, p_for_vertex, (float *)w, 4) != OK) {
+		return Vector<Color>();
+	}
 	return ret;
 }
 Vector<Quaternion> GLTFDocument::_decode_accessor_as_quaternion(Ref<GLTFState> state, const GLTFAccessorIndex p_accessor, const bool p_for_vertex) {
-	const Vector<double> attribs = _decode_accessor(state, p_accessor, p_for_vertex);
 	Vector<Quaternion> ret;
+	ERR_FAIL_INDEX_V(p_accessor, state->accessors.size(), ret);
+	const Ref<GLTFAccessor> a = state->accessors[p_accessor];
+	const int component_count = _get_component_count(a->type);
+	const int size = component_count * a->count;
 
-	if (attribs.size() == 0) {
+	if (size == 0) {
 		return ret;
 	}
 
-	ERR_FAIL_COND_V(attribs.size() % 4 != 0, ret);
-	const double *attribs_ptr = attribs.ptr();
-	const int ret_size = attribs.size() / 4;
-	ret.resize(ret_size);
-	{
-		for (int i = 0; i < ret_size; i++) {
-			ret.write[i] = Quaternion(attribs_ptr[i * 4 + 0], attribs_ptr[i * 4 + 1], attribs_ptr[i * 4 + 2], attribs_ptr[i * 4 + 3]).normalized();
-		}
+	ERR_FAIL_COND_V(size % 4 != 0, ret);
+	// Components are written straight into the Quaternion array, which is 4 packed real_t.
+	ret.resize(size / 4);
+	if (_decode_accessor_components(state, p_accessor, p_for_vertex, (real_t *)ret.ptrw(), component_count) != OK) {
+		return Vector<Quaternion>();
+	}
+	Quaternion *w = ret.ptrw();
+	for (int i = 0; i < ret.size(); i++) {
+		w[i].normalize();
 	}
 	return ret;
 }
@@ -2449,10 +2447,16 @@ Error GLTFDocument::_parse_meshes(Ref<GLTFState> state) {
 		return OK;
 	}
 
-	Array meshes = state->json["meshes"];
-	for (GLTFMeshIndex i = 0; i < meshes.size(); i++) {
-		print_verbose("glTF: Parsing mesh: " + itos(i));
-		Dictionary d = meshes[i];
+	MeshParseData data;
+	data.state = state;
+	data.meshes = state->json["meshes"];
+	data.materials.resize(data.meshes.size());
+	data.errors.resize(data.meshes.size());
+
+	// Names and materials are shared between meshes, so they are resolved here,
+	// before the surfaces of each mesh are decoded on their own thread.
+	for (GLTFMeshIndex i = 0; i < data.meshes.size(); i++) {
+		const Dictionary &d = data.meshes[i];
 
 		Ref<GLTFMesh> mesh;
 		mesh.instantiate();
@@ -2460,8 +2464,7 @@ Error GLTFDocument::_parse_meshes(Ref<GLTFState> state) {
 
 		ERR_FAIL_COND_V(!d.has("primitives"), ERR_PARSE_ERROR);
 
-		Array primitives = d["primitives"];
-		const Dictionary &extras = d.has("extras") ? (Dictionary)d["extras"] : Dictionary();
+		const Array &primitives = d["primitives"];
 		Ref<EditorSceneImporterMesh> import_mesh;
 		import_mesh.instantiate();
 		String mesh_name = "mesh";
@@ -2469,362 +2472,399 @@ Error GLTFDocument::_parse_meshes(Ref<GLTFState> state) {
 			mesh_name = d["name"];
 		}
 		import_mesh->set_name(_gen_unique_name(state, vformat("%s_%s", state->scene_name, mesh_name)));
+		mesh->set_mesh(import_mesh);
 
 		for (int j = 0; j < primitives.size(); j++) {
-			Dictionary p = primitives[j];
-
-			Array array;
-			array.resize(Mesh::ARRAY_MAX);
+			const Dictionary &p = primitives[j];
 
 			ERR_FAIL_COND_V(!p.has("attributes"), ERR_PARSE_ERROR);
 
-			Dictionary a = p["attributes"];
-
-			Mesh::PrimitiveType primitive = Mesh::PRIMITIVE_TRIANGLES;
-			if (p.has("mode")) {
-				const int mode = p["mode"];
-				ERR_FAIL_INDEX_V(mode, 7, ERR_FILE_CORRUPT);
-				static const Mesh::PrimitiveType primitives2[7] = {
-					Mesh::PRIMITIVE_POINTS,
-					Mesh::PRIMITIVE_LINES,
-					Mesh::PRIMITIVE_LINES, //loop not supported, should ce converted
-					Mesh::PRIMITIVE_LINES,
-					Mesh::PRIMITIVE_TRIANGLES,
-					Mesh::PRIMITIVE_TRIANGLE_STRIP,
-					Mesh::PRIMITIVE_TRIANGLES, //fan not supported, should be converted
-#ifndef _MSC_VER
-#warning line loop and triangle fan are not supported and need to be converted to lines and triangles
-#endif
-
-				};
-
-				primitive = primitives2[mode];
-			}
-
-			ERR_FAIL_COND_V(!a.has("POSITION"), ERR_PARSE_ERROR);
-			if (a.has("POSITION")) {
-				array[Mesh::ARRAY_VERTEX] = _decode_accessor_as_vec3(state, a["POSITION"], true);
-			}
-			if (a.has("NORMAL")) {
-				array[Mesh::ARRAY_NORMAL] = _decode_accessor_as_vec3(state, a["NORMAL"], true);
-			}
-			if (a.has("TANGENT")) {
-				array[Mesh::ARRAY_TANGENT] = _decode_accessor_as_floats(state, a["TANGENT"], true);
-			}
-			if (a.has("TEXCOORD_0")) {
-				array[Mesh::ARRAY_TEX_UV] = _decode_accessor_as_vec2(state, a["TEXCOORD_0"], true);
-			}
-			if (a.has("TEXCOORD_1")) {
-				array[Mesh::ARRAY_TEX_UV2] = _decode_accessor_as_vec2(state, a["TEXCOORD_1"], true);
-			}
+			const Dictionary &a = p["attributes"];
 			if (a.has("COLOR_0")) {
-				array[Mesh::ARRAY_COLOR] = _decode_accessor_as_color(state, a["COLOR_0"], true);
 				has_vertex_color = true;
 			}
-			if (a.has("JOINTS_0") && !a.has("JOINTS_1")) {
-				array[Mesh::ARRAY_BONES] = _decode_accessor_as_ints(state, a["JOINTS_0"], true);
-			} else if (a.has("JOINTS_0") && a.has("JOINTS_1")) {
-				PackedInt32Array joints_0 = _decode_accessor_as_ints(state, a["JOINTS_0"], true);
-				PackedInt32Array joints_1 = _decode_accessor_as_ints(state, a["JOINTS_1"], true);
-				ERR_FAIL_COND_V(joints_0.size() != joints_0.size(), ERR_INVALID_DATA);
-				int32_t weight_8_count = JOINT_GROUP_SIZE * 2;
-				int32_t vertex_count = joints_0.size() / JOINT_GROUP_SIZE;
-				Vector<int> joints;
-				joints.resize(vertex_count * weight_8_count);
-				for (int32_t vertex_i = 0; vertex_i < vertex_count; vertex_i++) {
-					joints.write[vertex_i * weight_8_count + 0] = joints_0[vertex_i * JOINT_GROUP_SIZE + 0];
-					joints.write[vertex_i * weight_8_count + 1] = joints_0[vertex_i * JOINT_GROUP_SIZE + 1];
-					joints.write[vertex_i * weight_8_count + 2] = joints_0[vertex_i * JOINT_GROUP_SIZE + 2];
-					joints.write[vertex_i * weight_8_count + 3] = joints_0[vertex_i * JOINT_GROUP_SIZE + 3];
-					joints.write[vertex_i * weight_8_count + 4] = joints_1[vertex_i * JOINT_GROUP_SIZE + 0];
-					joints.write[vertex_i * weight_8_count + 5] = joints_1[vertex_i * JOINT_GROUP_SIZE + 1];
-					joints.write[vertex_i * weight_8_count + 6] = joints_1[vertex_i * JOINT_GROUP_SIZE + 2];
-					joints.write[vertex_i * weight_8_count + 7] = joints_1[vertex_i * JOINT_GROUP_SIZE + 3];
-				}
-				array[Mesh::ARRAY_BONES] = joints;
-			}
-			if (a.has("WEIGHTS_0") && !a.has("WEIGHTS_1")) {
-				Vector<float> weights = _decode_accessor_as_floats(state, a["WEIGHTS_0"], true);
-				{ //gltf does not seem to normalize the weights for some reason..
-					int wc = weights.size();
-					float *w = weights.ptrw();
-
-					for (int k = 0; k < wc; k += 4) {
-						float total = 0.0;
-						total += w[k + 0];
-						total += w[k + 1];
-						total += w[k + 2];
-						total += w[k + 3];
-						if (total > 0.0) {
-							w[k + 0] /= total;
-							w[k + 1] /= total;
-							w[k + 2] /= total;
-							w[k + 3] /= total;
-						}
-					}
-				}
-				array[Mesh::ARRAY_WEIGHTS] = weights;
-			} else if (a.has("WEIGHTS_0") && a.has("WEIGHTS_1")) {
-				Vector<float> weights_0 = _decode_accessor_as_floats(state, a["WEIGHTS_0"], true);
-				Vector<float> weights_1 = _decode_accessor_as_floats(state, a["WEIGHTS_1"], true);
-				Vector<float> weights;
-				ERR_FAIL_COND_V(weights_0.size() != weights_1.size(), ERR_INVALID_DATA);
-				int32_t weight_8_count = JOINT_GROUP_SIZE * 2;
-				int32_t vertex_count = weights_0.size() / JOINT_GROUP_SIZE;
-				weights.resize(vertex_count * weight_8_count);
-				for (int32_t vertex_i = 0; vertex_i < vertex_count; vertex_i++) {
-					weights.write[vertex_i * weight_8_count + 0] = weights_0[vertex_i * JOINT_GROUP_SIZE + 0];
-					weights.write[vertex_i * weight_8_count + 1] = weights_0[vertex_i * JOINT_GROUP_SIZE + 1];
-					weights.write[vertex_i * weight_8_count + 2] = weights_0[vertex_i * JOINT_GROUP_SIZE + 2];
-					weights.write[vertex_i * weight_8_count + 3] = weights_0[vertex_i * JOINT_GROUP_SIZE + 3];
-					weights.write[vertex_i * weight_8_count + 4] = weights_1[vertex_i * JOINT_GROUP_SIZE + 0];
-					weights.write[vertex_i * weight_8_count + 5] = weights_1[vertex_i * JOINT_GROUP_SIZE + 1];
-					weights.write[vertex_i * weight_8_count + 6] = weights_1[vertex_i * JOINT_GROUP_SIZE + 2];
-					weights.write[vertex_i * weight_8_count + 7] = weights_1[vertex_i * JOINT_GROUP_SIZE + 3];
-				}
-				{ //gltf does not seem to normalize the weights for some reason..
-					int wc = weights.size();
-					float *w = weights.ptrw();
-
-					for (int k = 0; k < wc; k += weight_8_count) {
-						float total = 0.0;
-						total += w[k + 0];
-						total += w[k + 1];
-						total += w[k + 2];
-						total += w[k + 3];
-						total += w[k + 4];
-						total += w[k + 5];
-						total += w[k + 6];
-						total += w[k + 7];
-						if (total > 0.0) {
-							w[k + 0] /= total;
-							w[k + 1] /= total;
-							w[k + 2] /= total;
-							w[k + 3] /= total;
-							w[k + 4] /= total;
-							w[k + 5] /= total;
-							w[k + 6] /= total;
-							w[k + 7] /= total;
-						}
-					}
+
+			Ref<BaseMaterial3D> mat;
+			if (p.has("material")) {
+				const int material = p["material"];
+				ERR_FAIL_INDEX_V(material, state->materials.size(), ERR_FILE_CORRUPT);
+				Ref<BaseMaterial3D> mat3d = state->materials[material];
+				if (has_vertex_color) {
+					mat3d->set_flag(BaseMaterial3D::FLAG_ALBEDO_FROM_VERTEX_COLOR, true);
 				}
-				array[Mesh::ARRAY_WEIGHTS] = weights;
+				mat = mat3d;
+
+			} else if (has_vertex_color) {
+				Ref<StandardMaterial3D> mat3d;
+				mat3d.instantiate();
+				mat3d->set_flag(BaseMaterial3D::FLAG_ALBEDO_FROM_VERTEX_COLOR, true);
+				mat = mat3d;
 			}
+			data.materials[i].push_back(mat);
+		}
+
+		state->meshes.push_back(mesh);
+	}
+
+	if (data.meshes.size()) {
+		ThreadWorkPool work_pool;
+		work_pool.init();
+		work_pool.do_work(data.meshes.size(), this, &GLTFDocument::_parse_mesh_surfaces_thread, &data);
+		work_pool.finish();
+	}
+
+	for (uint32_t i = 0; i < data.errors.size(); i++) {
+		if (data.errors[i] != OK) {
+			return data.errors[i];
+		}
+	}
+
+	print_verbose("glTF: Total meshes: " + itos(state->meshes.size()));
+
+	return OK;
+}
+
+void GLTFDocument::_parse_mesh_surfaces_thread(uint32_t p_index, MeshParseData *p_data) {
+	p_data->errors[p_index] = _parse_mesh_surfaces(p_data->state, p_index, p_data->meshes[p_index], p_data->materials[p_index]);
+}
+
+Error GLTFDocument::_parse_mesh_surfaces(Ref<GLTFState> state, const GLTFMeshIndex p_mesh, const Dictionary &d, const Vector<Ref<Material>> &p_materials) {
+	print_verbose("glTF: Parsing mesh: " + itos(p_mesh));
 
-			if (p.has("indices")) {
-				Vector<int> indices = _decode_accessor_as_ints(state, p["indices"], false);
+	Ref<GLTFMesh> mesh = state->meshes[p_mesh];
+	Ref<EditorSceneImporterMesh> import_mesh = mesh->get_mesh();
 
-				if (primitive == Mesh::PRIMITIVE_TRIANGLES) {
-					//swap around indices, convert ccw to cw for front face
+	const Array &primitives = d["primitives"];
+	const Dictionary &extras = d.has("extras") ? (Dictionary)d["extras"] : Dictionary();
+
+	for (int j = 0; j < primitives.size(); j++) {
+		const Dictionary &p = primitives[j];
+
+		Array array;
+		array.resize(Mesh::ARRAY_MAX);
+
+		const Dictionary &a = p["attributes"];
+
+		Mesh::PrimitiveType primitive = Mesh::PRIMITIVE_TRIANGLES;
+		if (p.has("mode")) {
+			const int mode = p["mode"];
+			ERR_FAIL_INDEX_V(mode, 7, ERR_FILE_CORRUPT);
+			static const Mesh::PrimitiveType primitives2[7] = {
+				Mesh::PRIMITIVE_POINTS,
+				Mesh::PRIMITIVE_LINES,
+				Mesh::PRIMITIVE_LINES, //loop not supported, should ce converted
+				Mesh::PRIMITIVE_LINES,
+				Mesh::PRIMITIVE_TRIANGLES,
+				Mesh::PRIMITIVE_TRIANGLE_STRIP,
+				Mesh::PRIMITIVE_TRIANGLES, //fan not supported, should be converted
+#ifndef _MSC_VER
+#warning line loop and triangle fan are not supported and need to be converted to lines and triangles
+#endif
 
-					const int is = indices.size();
-					int *w = indices.ptrw();
-					for (int k = 0; k < is; k += 3) {
-						SWAP(w[k + 1], w[k + 2]);
+			};
+
+			primitive = primitives2[mode];
+		}
+
+		ERR_FAIL_COND_V(!a.has("POSITION"), ERR_PARSE_ERROR);
+		if (a.has("POSITION")) {
+			array[Mesh::ARRAY_VERTEX] = _decode_accessor_as_vec3(state, a["POSITION"], true);
+		}
+		if (a.has("NORMAL")) {
+			array[Mesh::ARRAY_NORMAL] = _decode_accessor_as_vec3(state, a["NORMAL"], true);
+		}
+		if (a.has("TANGENT")) {
+			array[Mesh::ARRAY_TANGENT] = _decode_accessor_as_floats(state, a["TANGENT"], true);
+		}
+		if (a.has("TEXCOORD_0")) {
+			array[Mesh::ARRAY_TEX_UV] = _decode_accessor_as_vec2(state, a["TEXCOORD_0"], true);
+		}
+		if (a.has("TEXCOORD_1")) {
+			array[Mesh::ARRAY_TEX_UV2] = _decode_accessor_as_vec2(state, a["TEXCOORD_1"], true);
+		}
+		if (a.has("COLOR_0")) {
+			array[Mesh::ARRAY_COLOR] = _decode_accessor_as_color(state, a["COLOR_0"], true);
+		}
+		if (a.has("JOINTS_0") && !a.has("JOINTS_1")) {
+			array[Mesh::ARRAY_BONES] = _decode_accessor_as_ints(state, a["JOINTS_0"], true);
+		} else if (a.has("JOINTS_0") && a.has("JOINTS_1")) {
+			PackedInt32Array joints_0 = _decode_accessor_as_ints(state, a["JOINTS_0"], true);
+			PackedInt32Array joints_1 = _decode_accessor_as_ints(state, a["JOINTS_1"], true);
+			ERR_FAIL_COND_V(joints_0.size() != joints_0.size(), ERR_INVALID_DATA);
+			int32_t weight_8_count = JOINT_GROUP_SIZE * 2;
+			int32_t vertex_count = joints_0.size() / JOINT_GROUP_SIZE;
+			Vector<int> joints;
+			joints.resize(vertex_count * weight_8_count);
+			for (int32_t vertex_i = 0; vertex_i < vertex_count; vertex_i++) {
+				joints.write[vertex_i * weight_8_count + 0] = joints_0[vertex_i * JOINT_GROUP_SIZE + 0];
+				joints.write[vertex_i * weight_8_count + 1] = joints_0[vertex_i * JOINT_GROUP_SIZE + 1];
+				joints.write[vertex_i * weight_8_count + 2] = joints_0[vertex_i * JOINT_GROUP_SIZE + 2];
+				joints.write[vertex_i * weight_8_count + 3] = joints_0[vertex_i * JOINT_GROUP_SIZE + 3];
+				joints.write[vertex_i * weight_8_count + 4] = joints_1[vertex_i * JOINT_GROUP_SIZE + 0];
+				joints.write[vertex_i * weight_8_count + 5] = joints_1[vertex_i * JOINT_GROUP_SIZE + 1];
+				joints.write[vertex_i * weight_8_count + 6] = joints_1[vertex_i * JOINT_GROUP_SIZE + 2];
+				joints.write[vertex_i * weight_8_count + 7] = joints_1[vertex_i * JOINT_GROUP_SIZE + 3];
+			}
+			array[Mesh::ARRAY_BONES] = joints;
+		}
+		if (a.has("WEIGHTS_0") && !a.has("WEIGHTS_1")) {
+			Vector<float> weights = _decode_accessor_as_floats(state, a["WEIGHTS_0"], true);
+			{ //gltf does not seem to normalize the weights for some reason..
+				int wc = weights.size();
+				float *w = weights.ptrw();
+
+				for (int k = 0; k < wc; k += 4) {
+					float total = 0.0;
+					total += w[k + 0];
+					total += w[k + 1];
+					total += w[k + 2];
+					total += w[k + 3];
+					if (total > 0.0) {
+						w[k + 0] /= total;
+						w[k + 1] /= total;
+						w[k + 2] /= total;
+						w[k + 3] /= total;
 					}
 				}
-				array[Mesh::ARRAY_INDEX] = indices;
-
-			} else if (primitive == Mesh::PRIMITIVE_TRIANGLES) {
-				//generate indices because they need to be swapped for CW/CCW
-				const Vector<Vector3> &vertices = array[Mesh::ARRAY_VERTEX];
-				ERR_FAIL_COND_V(vertices.size() == 0, ERR_PARSE_ERROR);
-				Vector<int> indices;
-				const int vs = vertices.size();
-				indices.resize(vs);
-				{
-					int *w = indices.ptrw();
-					for (int k = 0; k < vs; k += 3) {
-						w[k] = k;
-						w[k + 1] = k + 2;
-						w[k + 2] = k + 1;
+			}
+			array[Mesh::ARRAY_WEIGHTS] = weights;
+		} else if (a.has("WEIGHTS_0") && a.has("WEIGHTS_1")) {
+			Vector<float> weights_0 = _decode_accessor_as_floats(state, a["WEIGHTS_0"], true);
+			Vector<float> weights_1 = _decode_accessor_as_floats(state, a["WEIGHTS_1"], true);
+			Vector<float> weights;
+			ERR_FAIL_COND_V(weights_0.size() != weights_1.size(), ERR_INVALID_DATA);
+			int32_t weight_8_count = JOINT_GROUP_SIZE * 2;
+			int32_t vertex_count = weights_0.size() / JOINT_GROUP_SIZE;
+			weights.resize(vertex_count * weight_8_count);
+			for (int32_t vertex_i = 0; vertex_i < vertex_count; vertex_i++) {
+				weights.write[vertex_i * weight_8_count + 0] = weights_0[vertex_i * JOINT_GROUP_SIZE + 0];
+				weights.write[vertex_i * weight_8_count + 1] = weights_0[vertex_i * JOINT_GROUP_SIZE + 1];
+				weights.write[vertex_i * weight_8_count + 2] = weights_0[vertex_i * JOINT_GROUP_SIZE + 2];
+				weights.write[vertex_i * weight_8_count + 3] = weights_0[vertex_i * JOINT_GROUP_SIZE + 3];
+				weights.write[vertex_i * weight_8_count + 4] = weights_1[vertex_i * JOINT_GROUP_SIZE + 0];
+				weights.write[vertex_i * weight_8_count + 5] = weights_1[vertex_i * JOINT_GROUP_SIZE + 1];
+				weights.write[vertex_i * weight_8_count + 6] = weights_1[vertex_i * JOINT_GROUP_SIZE + 2];
+				weights.write[vertex_i * weight_8_count + 7] = weights_1[vertex_i * JOINT_GROUP_SIZE + 3];
+			}
+			{ //gltf does not seem to normalize the weights for some reason..
+				int wc = weights.size();
+				float *w = weights.ptrw();
+
+				for (int k = 0; k < wc; k += weight_8_count) {
+					float total = 0.0;
+					total += w[k + 0];
+					total += w[k + 1];
+					total += w[k + 2];
+					total += w[k + 3];
+					total += w[k + 4];
+					total += w[k + 5];
+					total += w[k + 6];
+					total += w[k + 7];
+					if (total > 0.0) {
+						w[k + 0] /= total;
+						w[k + 1] /= total;
+						w[k + 2] /= total;
+						w[k + 3] /= total;
+						w[k + 4] /= total;
+						w[k + 5] /= total;
+						w[k + 6] /= total;
+						w[k + 7] /= total;
 					}
 				}
-				array[Mesh::ARRAY_INDEX] = indices;
 			}
+			array[Mesh::ARRAY_WEIGHTS] = weights;
+		}
 
-			bool generate_tangents = (primitive == Mesh::PRIMITIVE_TRIANGLES && !a.has("TANGENT") && a.has("TEXCOORD_0") && a.has("NORMAL"));
+		if (p.has("indices")) {
+			Vector<int> indices = _decode_accessor_as_ints(state, p["indices"], false);
 
-			if (generate_tangents) {
-				//must generate mikktspace tangents.. ergh..
-				Ref<SurfaceTool> st;
-				st.instantiate();
-				st->create_from_triangle_arrays(array);
-				if (a.has("JOINTS_0") && a.has("JOINTS_1")) {
-					st->set_skin_weight_count(SurfaceTool::SKIN_8_WEIGHTS);
+			if (primitive == Mesh::PRIMITIVE_TRIANGLES) {
+				//swap around indices, convert ccw to cw for front face
+
+				const int is = indices.size();
+				int *w = indices.ptrw();
+				for (int k = 0; k < is; k += 3) {
+					SWAP(w[k + 1], w[k + 2]);
 				}
-				st->generate_tangents();
-				array = st->commit_to_arrays();
 			}
+			array[Mesh::ARRAY_INDEX] = indices;
 
-			Array morphs;
-			//blend shapes
-			if (p.has("targets")) {
-				print_verbose("glTF: Mesh has targets");
-				const Array &targets = p["targets"];
-
-				//ideally BLEND_SHAPE_MODE_RELATIVE since gltf2 stores in displacement
-				//but it could require a larger refactor?
-				import_mesh->set_blend_shape_mode(Mesh::BLEND_SHAPE_MODE_NORMALIZED);
-
-				if (j == 0) {
-					const Array &target_names = extras.has("targetNames") ? (Array)extras["targetNames"] : Array();
-					for (int k = 0; k < targets.size(); k++) {
-						const String name = k < target_names.size() ? (String)target_names[k] : String("morph_") + itos(k);
-						import_mesh->add_blend_shape(name);
-					}
+		} else if (primitive == Mesh::PRIMITIVE_TRIANGLES) {
+			//generate indices because they need to be swapped for CW/CCW
+			const Vector<Vector3> &vertices = array[Mesh::ARRAY_VERTEX];
+			ERR_FAIL_COND_V(vertices.size() == 0, ERR_PARSE_ERROR);
+			Vector<int> indices;
+			const int vs = vertices.size();
+			indices.resize(vs);
+			{
+				int *w = indices.ptrw();
+				for (int k = 0; k < vs; k += 3) {
+					w[k] = k;
+					w[k + 1] = k + 2;
+					w[k + 2] = k + 1;
 				}
+			}
+			array[Mesh::ARRAY_INDEX] = indices;
+		}
+
+		bool generate_tangents = (primitive == Mesh::PRIMITIVE_TRIANGLES && !a.has("TANGENT") && a.has("TEXCOORD_0") && a.has("NORMAL"));
 
+		if (generate_tangents) {
+			//must generate mikktspace tangents.. ergh..
+			Ref<SurfaceTool> st;
+			st.instantiate();
+			st->create_from_triangle_arrays(array);
+			if (a.has("JOINTS_0") && a.has("JOINTS_1")) {
+				st->set_skin_weight_count(SurfaceTool::SKIN_8_WEIGHTS);
+			}
+			st->generate_tangents();
+			array = st->commit_to_arrays();
+		}
+
+		Array morphs;
+		//blend shapes
+		if (p.has("targets")) {
+			print_verbose("glTF: Mesh has targets");
+			const Array &targets = p["targets"];
+
+			//ideally BLEND_SHAPE_MODE_RELATIVE since gltf2 stores in displacement
+			//but it could require a larger refactor?
+			import_mesh->set_blend_shape_mode(Mesh::BLEND_SHAPE_MODE_NORMALIZED);
+
+			if (j == 0) {
+				const Array &target_names = extras.has("targetNames") ? (Array)extras["targetNames"] : Array();
 				for (int k = 0; k < targets.size(); k++) {
-					const Dictionary &t = targets[k];
+					const String name = k < target_names.size() ? (String)target_names[k] : String("morph_") + itos(k);
+					import_mesh->add_blend_shape(name);
+				}
+			}
 
-					Array array_copy;
-					array_copy.resize(Mesh::ARRAY_MAX);
+			for (int k = 0; k < targets.size(); k++) {
+				const Dictionary &t = targets[k];
 
-					for (int l = 0; l < Mesh::ARRAY_MAX; l++) {
-						array_copy[l] = array[l];
-					}
+				Array array_copy;
+				array_copy.resize(Mesh::ARRAY_MAX);
 
-					array_copy[Mesh::ARRAY_INDEX] = Variant();
+				for (int l = 0; l < Mesh::ARRAY_MAX; l++) {
+					array_copy[l] = array[l];
+				}
 
-					if (t.has("POSITION")) {
-						Vector<Vector3> varr = _decode_accessor_as_vec3(state, t["POSITION"], true);
-						const Vector<Vector3> src_varr = array[Mesh::ARRAY_VERTEX];
-						const int size = src_varr.size();
-						ERR_FAIL_COND_V(size == 0, ERR_PARSE_ERROR);
-						{
-							const int max_idx = varr.size();
-							varr.resize(size);
-
-							Vector3 *w_varr = varr.ptrw();
-							const Vector3 *r_varr = varr.ptr();
-							const Vector3 *r_src_varr = src_varr.ptr();
-							for (int l = 0; l < size; l++) {
-								if (l < max_idx) {
-									w_varr[l] = r_varr[l] + r_src_varr[l];
-								} else {
-									w_varr[l] = r_src_varr[l];
-								}
+				array_copy[Mesh::ARRAY_INDEX] = Variant();
+
+				if (t.has("POSITION")) {
+					Vector<Vector3> varr = _decode_accessor_as_vec3(state, t["POSITION"], true);
+					const Vector<Vector3> src_varr = array[Mesh::ARRAY_VERTEX];
+					const int size = src_varr.size();
+					ERR_FAIL_COND_V(size == 0, ERR_PARSE_ERROR);
+					{
+						const int max_idx = varr.size();
+						varr.resize(size);
+
+						Vector3 *w_varr = varr.ptrw();
+						const Vector3 *r_varr = varr.ptr();
+						const Vector3 *r_src_varr = src_varr.ptr();
+						for (int l = 0; l < size; l++) {
+							if (l < max_idx) {
+								w_varr[l] = r_varr[l] + r_src_varr[l];
+							} else {
+								w_varr[l] = r_src_varr[l];
 							}
 						}
-						array_copy[Mesh::ARRAY_VERTEX] = varr;
 					}
-					if (t.has("NORMAL")) {
-						Vector<Vector3> narr = _decode_accessor_as_vec3(state, t["NORMAL"], true);
-						const Vector<Vector3> src_narr = array[Mesh::ARRAY_NORMAL];
-						int size = src_narr.size();
-						ERR_FAIL_COND_V(size == 0, ERR_PARSE_ERROR);
-						{
-							int max_idx = narr.size();
-							narr.resize(size);
-
-							Vector3 *w_narr = narr.ptrw();
-							const Vector3 *r_narr = narr.ptr();
-							const Vector3 *r_src_narr = src_narr.ptr();
-							for (int l = 0; l < size; l++) {
-								if (l < max_idx) {
-									w_narr[l] = r_narr[l] + r_src_narr[l];
-								} else {
-									w_narr[l] = r_src_narr[l];
-								}
+					array_copy[Mesh::ARRAY_VERTEX] = varr;
+				}
+				if (t.has("NORMAL")) {
+					Vector<Vector3> narr = _decode_accessor_as_vec3(state, t["NORMAL"], true);
+					const Vector<Vector3> src_narr = array[Mesh::ARRAY_NORMAL];
+					int size = src_narr.size();
+					ERR_FAIL_COND_V(size == 0, ERR_PARSE_ERROR);
+					{
+						int max_idx = narr.size();
+						narr.resize(size);
+
+						Vector3 *w_narr = narr.ptrw();
+						const Vector3 *r_narr = narr.ptr();
+						const Vector3 *r_src_narr = src_narr.ptr();
+						for (int l = 0; l < size; l++) {
+							if (l < max_idx) {
+								w_narr[l] = r_narr[l] + r_src_narr[l];
+							} else {
+								w_narr[l] = r_src_narr[l];
 							}
 						}
-						array_copy[Mesh::ARRAY_NORMAL] = narr;
 					}
-					if (t.has("TANGENT")) {
-						const Vector<Vector3> tangents_v3 = _decode_accessor_as_vec3(state, t["TANGENT"], true);
-						const Vector<float> src_tangents = array[Mesh::ARRAY_TANGENT];
-						ERR_FAIL_COND_V(src_tangents.size() == 0, ERR_PARSE_ERROR);
+					array_copy[Mesh::ARRAY_NORMAL] = narr;
+				}
+				if (t.has("TANGENT")) {
+					const Vector<Vector3> tangents_v3 = _decode_accessor_as_vec3(state, t["TANGENT"], true);
+					const Vector<float> src_tangents = array[Mesh::ARRAY_TANGENT];
+					ERR_FAIL_COND_V(src_tangents.size() == 0, ERR_PARSE_ERROR);
 
-						Vector<float> tangents_v4;
+					Vector<float> tangents_v4;
 
-						{
-							int max_idx = tangents_v3.size();
-
-							int size4 = src_tangents.size();
-							tangents_v4.resize(size4);
-							float *w4 = tangents_v4.ptrw();
-
-							const Vector3 *r3 = tangents_v3.ptr();
-							const float *r4 = src_tangents.ptr();
-
-							for (int l = 0; l < size4 / 4; l++) {
-								if (l < max_idx) {
-									w4[l * 4 + 0] = r3[l].x + r4[l * 4 + 0];
-									w4[l * 4 + 1] = r3[l].y + r4[l * 4 + 1];
-									w4[l * 4 + 2] = r3[l].z + r4[l * 4 + 2];
-								} else {
-									w4[l * 4 + 0] = r4[l * 4 + 0];
-									w4[l * 4 + 1] = r4[l * 4 + 1];
-									w4[l * 4 + 2] = r4[l * 4 + 2];
-								}
-								w4[l * 4 + 3] = r4[l * 4 + 3]; //copy flip value
+					{
+						int max_idx = tangents_v3.size();
+
+						int size4 = src_tangents.size();
+						tangents_v4.resize(size4);
+						float *w4 = tangents_v4.ptrw();
+
+						const Vector3 *r3 = tangents_v3.ptr();
+						const float *r4 = src_tangents.ptr();
+
+						for (int l = 0; l < size4 / 4; l++) {
+							if (l < max_idx) {
+								w4[l * 4 + 0] = r3[l].x + r4[l * 4 + 0];
+								w4[l * 4 + 1] = r3[l].y + r4[l * 4 + 1];
+								w4[l * 4 + 2] = r3[l].z + r4[l * 4 + 2];
+							} else {
+								w4[l * 4 + 0] = r4[l * 4 + 0];
+								w4[l * 4 + 1] = r4[l * 4 + 1];
+								w4[l * 4 + 2] = r4[l * 4 + 2];
 							}
+							w4[l * 4 + 3] = r4[l * 4 + 3]; //copy flip value
 						}
-
-						array_copy[Mesh::ARRAY_TANGENT] = tangents_v4;
 					}
 
-					if (generate_tangents) {
-						Ref<SurfaceTool> st;
-						st.instantiate();
-						st->create_from_triangle_arrays(array_copy);
-						if (a.has("JOINTS_0") && a.has("JOINTS_1")) {
-							st->set_skin_weight_count(SurfaceTool::SKIN_8_WEIGHTS);
-						}
-						st->deindex();
-						st->generate_tangents();
-						array_copy = st->commit_to_arrays();
-					}
-
-					morphs.push_back(array_copy);
+					array_copy[Mesh::ARRAY_TANGENT] = tangents_v4;
 				}
-			}
 
-			//just add it
-
-			Ref<BaseMaterial3D> mat;
-			if (p.has("material")) {
-				const int material = p["material"];
-				ERR_FAIL_INDEX_V(material, state->materials.size(), ERR_FILE_CORRUPT);
-				Ref<BaseMaterial3D> mat3d = state->materials[material];
-				if (has_vertex_color) {
-					mat3d->set_flag(BaseMaterial3D::FLAG_ALBEDO_FROM_VERTEX_COLOR, true);
+				if (generate_tangents) {
+					Ref<SurfaceTool> st;
+					st.instantiate();
+					st->create_from_triangle_arrays(array_copy);
+					if (a.has("JOINTS_0") && a.has("JOINTS_1")) {
+						st->set_skin_weight_count(SurfaceTool::SKIN_8_WEIGHTS);
+					}
+					st->deindex();
+					st->generate_tangents();
+					array_copy = st->commit_to_arrays();
 				}
-				mat = mat3d;
 
-			} else if (has_vertex_color) {
-				Ref<StandardMaterial3D> mat3d;
-				mat3d.instantiate();
-				mat3d->set_flag(BaseMaterial3D::FLAG_ALBEDO_FROM_VERTEX_COLOR, true);
-				mat = mat3d;
+				morphs.push_back(array_copy);
 			}
-
-			import_mesh->add_surface(primitive, array, morphs, Dictionary(), mat);
 		}
 
-		Vector<float> blend_weights;
-		blend_weights.resize(import_mesh->get_blend_shape_count());
-		for (int32_t weight_i = 0; weight_i < blend_weights.size(); weight_i++) {
-			blend_weights.write[weight_i] = 0.0f;
-		}
+		//just add it
+		import_mesh->add_surface(primitive, array, morphs, Dictionary(), p_materials[j]);
+	}
 
-		if (d.has("weights")) {
-			const Array &weights = d["weights"];
-			for (int j = 0; j < weights.size(); j++) {
-				if (j >= blend_weights.size()) {
-					break;
-				}
-				blend_weights.write[j] = weights[j];
+	Vector<float> blend_weights;
+	blend_weights.resize(import_mesh->get_blend_shape_count());
+	for (int32_t weight_i = 0; weight_i < blend_weights.size(); weight_i++) {
+		blend_weights.write[weight_i] = 0.0f;
+	}
+
+	if (d.has("weights")) {
+		const Array &weights = d["weights"];
+		for (int j = 0; j < weights.size(); j++) {
+			if (j >= blend_weights.size()) {
+				break;
 			}
+			blend_weights.write[j] = weights[j];
 		}
-		mesh->set_blend_weights(blend_weights);
-		mesh->set_mesh(import_mesh);
-
-		state->meshes.push_back(mesh);
 	}
-
-	print_verbose("glTF: Total meshes: " + itos(state->meshes.size()));
+	mesh->set_blend_weights(blend_weights);
 
 	return OK;
 }
@@ -2907,8 +2947,10 @@ Error GLTFDocument::_parse_images(Ref<GLTFState> state, const String &p_base_pat
 	// Ref: https://github.com/KhronosGroup/glTF/blob/master/specification/2.0/README.md#images
 
 	const Array &images = state->json["images"];
+	LocalVector<ImageData> images_data;
 	for (int i = 0; i < images.size(); i++) {
 		const Dictionary &d = images[i];
+		ImageData image;
 
 		// glTF 2.0 supports PNG and JPEG types, which can be specified as (from spec):
 		// "- a URI to an external file in one of the supported images formats, or
@@ -2924,14 +2966,12 @@ Error GLTFDocument::_parse_images(Ref<GLTFState> state, const String &p_base_pat
 			WARN_PRINT("Invalid image definition in glTF file using both 'uri' and 'bufferView'. 'bufferView' will take precedence.");
 		}
 
-		String mimetype;
+		String &mimetype = image.mimetype;
 		if (d.has("mimeType")) { // Should be "image/png" or "image/jpeg".
 			mimetype = d["mimeType"];
 		}
 
-		Vector<uint8_t> data;
-		const uint8_t *data_ptr = nullptr;
-		int data_size = 0;
+		Vector<uint8_t> &data = image.data;
 
 		if (d.has("uri")) {
 			// Handles the first two bullet points from the spec (embedded data, or external file).
@@ -2944,12 +2984,12 @@ Error GLTFDocument::_parse_images(Ref<GLTFState> state, const String &p_base_pat
 						!uri.begins_with("data:image/png;base64") &&
 						!uri.begins_with("data:image/jpeg;base64")) {
 					WARN_PRINT(vformat("glTF: Image index '%d' uses an unsupported URI data type: %s. Skipping it.", i, uri));
-					state->images.push_back(Ref<Texture2D>()); // Placeholder to keep count.
+					images_data.push_back(image); // Placeholder to keep count.
 					continue;
 				}
 				data = _parse_base64_uri(uri);
-				data_ptr = data.ptr();
-				data_size = data.size();
+				image.data_ptr = data.ptr();
+				image.data_size = data.size();
 				// mimeType is optional, but if we have it defined in the URI, let's use it.
 				if (mimetype.is_empty()) {
 					if (uri.begins_with("data:image/png;base64")) {
@@ -2965,9 +3005,9 @@ Error GLTFDocument::_parse_images(Ref<GLTFState> state, const String &p_base_pat
 				// there could be a `.png` image which is actually JPEG), but there's no easy
 				// API for that in Godot, so we'd have to load as a buffer (i.e. embedded in
 				// the material), so we do this only as fallback.
-				Ref<Texture2D> texture = ResourceLoader::load(uri);
-				if (texture.is_valid()) {
-					state->images.push_back(texture);
+				image.texture = ResourceLoader::load(uri);
+				if (image.texture.is_valid()) {
+					images_data.push_back(image);
 					continue;
 				} else if (mimetype == "image/png" || mimetype == "image/jpeg") {
 					// Fallback to loading as byte array.
@@ -2976,14 +3016,14 @@ Error GLTFDocument::_parse_images(Ref<GLTFState> state, const String &p_base_pat
 					data = FileAccess::get_file_as_array(uri);
 					if (data.size() == 0) {
 						WARN_PRINT(vformat("glTF: Image index '%d' couldn't be loaded as a buffer of MIME type '%s' from URI: %s. Skipping it.", i, mimetype, uri));
-						state->images.push_back(Ref<Texture2D>()); // Placeholder to keep count.
+						images_data.push_back(image); // Placeholder to keep count.
 						continue;
 					}
-					data_ptr = data.ptr();
-					data_size = data.size();
+					image.data_ptr = data.ptr();
+					image.data_size = data.size();
 				} else {
 					WARN_PRINT(vformat("glTF: Image index '%d' couldn't be loaded from URI: %s. Skipping it.", i, uri));
-					state->images.push_back(Ref<Texture2D>()); // Placeholder to keep count.
+					images_data.push_back(image); // Placeholder to keep count.
 					continue;
 				}
 			}
@@ -3003,32 +3043,37 @@ Error GLTFDocument::_parse_images(Ref<GLTFState> state, const String &p_base_pat
 
 			ERR_FAIL_COND_V(bv->byte_offset + bv->byte_length > state->buffers[bi].size(), ERR_FILE_CORRUPT);
 
-			data_ptr = &state->buffers[bi][bv->byte_offset];
-			data_size = bv->byte_length;
+			image.data_ptr = &state->buffers[bi][bv->byte_offset];
+			image.data_size = bv->byte_length;
 		}
 
-		Ref<Image> img;
-
-		if (mimetype == "image/png") { // Load buffer as PNG.
-			ERR_FAIL_COND_V(Image::_png_mem_loader_func == nullptr, ERR_UNAVAILABLE);
-			img = Image::_png_mem_loader_func(data_ptr, data_size);
-		} else if (mimetype == "image/jpeg") { // Loader buffer as JPEG.
+		if (mimetype == "image/jpeg") {
 			ERR_FAIL_COND_V(Image::_jpg_mem_loader_func == nullptr, ERR_UNAVAILABLE);
-			img = Image::_jpg_mem_loader_func(data_ptr, data_size);
 		} else {
-			// We can land here if we got an URI with base64-encoded data with application/* MIME type,
-			// and the optional mimeType property was not defined to tell us how to handle this data (or was invalid).
-			// So let's try PNG first, then JPEG.
 			ERR_FAIL_COND_V(Image::_png_mem_loader_func == nullptr, ERR_UNAVAILABLE);
-			img = Image::_png_mem_loader_func(data_ptr, data_size);
-			if (img.is_null()) {
-				ERR_FAIL_COND_V(Image::_jpg_mem_loader_func == nullptr, ERR_UNAVAILABLE);
-				img = Image::_jpg_mem_loader_func(data_ptr, data_size);
-			}
 		}
+		image.decode = true;
+		images_data.push_back(image);
+	}
+
+	// PNG and JPEG decoding doesn't depend on anything else, so all the images are decoded in parallel.
+	if (images_data.size()) {
+		ThreadWorkPool work_pool;
+		work_pool.init();
+		work_pool.do_work(images_data.size(), this, &GLTFDocument::_decode_image_thread, &images_data);
+		work_pool.finish();
+	}
 
+	for (uint32_t i = 0; i < images_data.size(); i++) {
+		const ImageData &image = images_data[i];
+		if (!image.decode) {
+			state->images.push_back(image.texture);
+			continue;
+		}
+
+		Ref<Image> img = image.image;
 		if (img.is_null()) {
-			ERR_PRINT(vformat("glTF: Couldn't load image index '%d' with its given mimetype: %s.", i, mimetype));
+			ERR_PRINT(vformat("glTF: Couldn't load image index '%d' with its given mimetype: %s.", i, image.mimetype));
 			state->images.push_back(Ref<Texture2D>());
 			continue;
 		}
@@ -3045,6 +3090,27 @@ Error GLTFDocument::_parse_images(Ref<GLTFState> state, const String &p_base_pat
 	return OK;
 }
 
+void GLTFDocument::_decode_image_thread(uint32_t p_index, LocalVector<ImageData> *p_images) {
+	ImageData &image = (*p_images)[p_index];
+	if (!image.decode) {
+		return;
+	}
+
+	if (image.mimetype == "image/png") { // Load buffer as PNG.
+		image.image = Image::_png_mem_loader_func(image.data_ptr, image.data_size);
+	} else if (image.mimetype == "image/jpeg") { // Loader buffer as JPEG.
+		image.image = Image::_jpg_mem_loader_func(image.data_ptr, image.data_size);
+	} else {
+		// We can land here if we got an URI with base64-encoded data with application/* MIME type,
+		// and the optional mimeType property was not defined to tell us how to handle this data (or was invalid).
+		// So let's try PNG first, then JPEG.
+		image.image = Image::_png_mem_loader_func(image.data_ptr, image.data_size);
+		if (image.image.is_null() && Image::_jpg_mem_loader_func) {
+			image.image = Image::_jpg_mem_loader_func(image.data_ptr, image.data_size);
+		}
+	}
+}
+
 Error GLTFDocument::_serialize_textures(Ref<GLTFState> state) {
 	if (!state->textures.size()) {
 		return OK;
@@ -31,6 +31,7 @@
 #ifndef GLTF_DOCUMENT_H
 #define GLTF_DOCUMENT_H
 
+#include "core/templates/local_vector.h"
 #include "editor/import/resource_importer_scene.h"
 #include "editor/import/scene_importer_mesh_node_3d.h"
 #include "gltf_animation.h"
@@ -179,7 +180,8 @@ private:
 	Error _parse_buffer_views(Ref<GLTFState> state);
 	GLTFType _get_type_from_str(const String &p_string);
 	Error _parse_accessors(Ref<GLTFState> state);
-	Error _decode_buffer_view(Ref<GLTFState> state, double *dst,
+	template <class T>
+	Error _decode_buffer_view(Ref<GLTFState> state, T *dst, const int dst_stride,
 			const GLTFBufferViewIndex p_buffer_view,
 			const int skip_every, const int skip_bytes,
 			const int element_size, const int count,
@@ -187,6 +189,11 @@ private:
 			const int component_type, const int component_size,
 			const bool normalized, const int byte_offset,
 			const bool for_vertex);
+	int _get_component_count(const GLTFType p_type);
+	template <class T>
+	Error _decode_accessor_components(Ref<GLTFState> state,
+			const GLTFAccessorIndex p_accessor,
+			const bool p_for_vertex, T *r_dst, const int p_dst_stride);
 	Vector<double> _decode_accessor(Ref<GLTFState> state,
 			const GLTFAccessorIndex p_accessor,
 			const bool p_for_vertex);
@@ -217,11 +224,30 @@ private:
 	Vector<Transform3D> _decode_accessor_as_xform(Ref<GLTFState> state,
 			const GLTFAccessorIndex p_accessor,
 			const bool p_for_vertex);
+	struct MeshParseData {
+		Ref<GLTFState> state;
+		Array meshes;
+		LocalVector<Vector<Ref<Material>>> materials;
+		LocalVector<Error> errors;
+	};
 	Error _parse_meshes(Ref<GLTFState> state);
+	void _parse_mesh_surfaces_thread(uint32_t p_index, MeshParseData *p_data);
+	Error _parse_mesh_surfaces(Ref<GLTFState> state, const GLTFMeshIndex p_mesh,
+			const Dictionary &d, const Vector<Ref<Material>> &p_materials);
 	Error _serialize_textures(Ref<GLTFState> state);
 	Error _serialize_images(Ref<GLTFState> state, const String &p_path);
 	Error _serialize_lights(Ref<GLTFState> state);
+	struct ImageData {
+		String mimetype;
+		Vector<uint8_t> data;
+		const uint8_t *data_ptr = nullptr;
+		int data_size = 0;
+		bool decode = false;
+		Ref<Image> image;
+		Ref<Texture2D> texture;
+	};
 	Error _parse_images(Ref<GLTFState> state, const String &p_base_path);
+	void _decode_image_thread(uint32_t p_index, LocalVector<ImageData> *p_images);
 	Error _parse_textures(Ref<GLTFState> state);
 	Error _parse_materials(Ref<GLTFState> state);
 	void _set_texture_transform_uv1(const Dictionary &d, Ref<BaseMaterial3D> material);
@@ -0,0 +1,304 @@
+/*************************************************************************/
+/*  test_gltf_document.h                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_GLTF_DOCUMENT_H
+#define TEST_GLTF_DOCUMENT_H
+
+#include "core/io/file_access.h"
+#include "core/io/json.h"
+#include "core/os/os.h"
+#include "modules/gltf/gltf_document.h"
+#include "modules/gltf/gltf_mesh.h"
+#include "modules/gltf/gltf_state.h"
+
+#include "tests/test_macros.h"
+
+namespace TestGLTFDocument {
+
+// Builds a binary glTF file in memory, with a single buffer holding all the views.
+class GLBBuilder {
+	Vector<uint8_t> bin;
+	Array buffer_views;
+	Array accessors;
+	Array meshes;
+	Array images;
+	Array nodes;
+
+public:
+	int add_buffer_view(const void *p_data, int p_size, int p_stride = 0) {
+		while (bin.size() % 4) {
+			bin.push_back(0);
+		}
+		Dictionary view;
+		view["buffer"] = 0;
+		view["byteOffset"] = bin.size();
+		view["byteLength"] = p_size;
+		if (p_stride) {
+			view["byteStride"] = p_stride;
+		}
+		int ofs = bin.size();
+		bin.resize(ofs + p_size);
+		memcpy(bin.ptrw() + ofs, p_data, p_size);
+		buffer_views.push_back(view);
+		return buffer_views.size() - 1;
+	}
+
+	int add_accessor(int p_buffer_view, int p_byte_offset, int p_component_type, const String &p_type, int p_count, bool p_normalized = false) {
+		Dictionary accessor;
+		accessor["bufferView"] = p_buffer_view;
+		accessor["byteOffset"] = p_byte_offset;
+		accessor["componentType"] = p_component_type;
+		accessor["type"] = p_type;
+		accessor["count"] = p_count;
+		accessor["normalized"] = p_normalized;
+		accessors.push_back(accessor);
+		return accessors.size() - 1;
+	}
+
+	int add_accessor(const void *p_data, int p_size, int p_component_type, const String &p_type, int p_count, bool p_normalized = false) {
+		return add_accessor(add_buffer_view(p_data, p_size), 0, p_component_type, p_type, p_count, p_normalized);
+	}
+
+	void add_mesh(const Dictionary &p_attributes, int p_indices) {
+		Dictionary primitive;
+		primitive["attributes"] = p_attributes;
+		primitive["indices"] = p_indices;
+		Array primitives;
+		primitives.push_back(primitive);
+		Dictionary mesh;
+		mesh["primitives"] = primitives;
+		meshes.push_back(mesh);
+
+		Dictionary node;
+		node["mesh"] = meshes.size() - 1;
+		nodes.push_back(node);
+	}
+
+	void add_png_image(const Ref<Image> &p_image) {
+		Vector<uint8_t> png = p_image->save_png_to_buffer();
+		Dictionary image;
+		image["bufferView"] = add_buffer_view(png.ptr(), png.size());
+		image["mimeType"] = "image/png";
+		images.push_back(image);
+	}
+
+	String save(const String &p_file) {
+		Dictionary asset;
+		asset["version"] = "2.0";
+		Array scene_nodes;
+		for (int i = 0; i < nodes.size(); i++) {
+			scene_nodes.push_back(i);
+		}
+		Dictionary scene;
+		scene["nodes"] = scene_nodes;
+		Array scenes;
+		scenes.push_back(scene);
+		Array buffers;
+		Dictionary buffer;
+		buffer["byteLength"] = bin.size();
+		buffers.push_back(buffer);
+
+		Dictionary gltf;
+		gltf["asset"] = asset;
+		gltf["scene"] = 0;
+		gltf["scenes"] = scenes;
+		gltf["nodes"] = nodes;
+		gltf["meshes"] = meshes;
+		gltf["accessors"] = accessors;
+		gltf["bufferViews"] = buffer_views;
+		gltf["buffers"] = buffers;
+		if (images.size()) {
+			gltf["images"] = images;
+		}
+
+		JSON json;
+		Vector<uint8_t> json_data = json.stringify_utf8(gltf);
+		while (json_data.size() % 4) {
+			json_data.push_back(' ');
+		}
+		while (bin.size() % 4) {
+			bin.push_back(0);
+		}
+
+		const String path = OS::get_singleton()->get_cache_path().plus_file(p_file);
+		FileAccessRef f = FileAccess::open(path, FileAccess::WRITE);
+		if (!f) {
+			return String();
+		}
+		f->store_32(0x46546C67); // glTF
+		f->store_32(2);
+		f->store_32(12 + 8 + json_data.size() + 8 + bin.size());
+		f->store_32(json_data.size());
+		f->store_32(0x4E4F534A); // JSON
+		f->store_buffer(json_data.ptr(), json_data.size());
+		f->store_32(bin.size());
+		f->store_32(0x004E4942); // BIN
+		f->store_buffer(bin.ptr(), bin.size());
+		f->close();
+		return path;
+	}
+};
+
+TEST_CASE("[GLTFDocument] Decode accessors") {
+	GLBBuilder builder;
+
+	// Positions and normals interleaved in the same view.
+	const float vertices[4][6] = {
+		{ 0, 0, 0, 0, 0, 1 },
+		{ 1, 0, 0, 0, 0, 1 },
+		{ 1, 1, 0, 0, 1, 0 },
+		{ 0, 1, 0, 1, 0, 0 },
+	};
+	int vertex_view = builder.add_buffer_view(vertices, sizeof(vertices), sizeof(float) * 6);
+	const uint8_t colors[4][4] = { { 255, 0, 0, 255 }, { 0, 255, 0, 128 }, { 0, 0, 255, 0 }, { 255, 255, 255, 255 } };
+	const uint16_t uvs[4][2] = { { 0, 0 }, { 65535, 0 }, { 65535, 65535 }, { 0, 32768 } };
+	const uint8_t indices[6] = { 0, 1, 2, 0, 2, 3 };
+
+	Dictionary attributes;
+	attributes["POSITION"] = builder.add_accessor(vertex_view, 0, GLTFDocument::COMPONENT_TYPE_FLOAT, "VEC3", 4);
+	attributes["NORMAL"] = builder.add_accessor(vertex_view, sizeof(float) * 3, GLTFDocument::COMPONENT_TYPE_FLOAT, "VEC3", 4);
+	attributes["COLOR_0"] = builder.add_accessor(colors, sizeof(colors), GLTFDocument::COMPONENT_TYPE_UNSIGNED_BYTE, "VEC4", 4, true);
+	attributes["TEXCOORD_1"] = builder.add_accessor(uvs, sizeof(uvs), GLTFDocument::COMPONENT_TYPE_UNSIGNED_SHORT, "VEC2", 4, true);
+	builder.add_mesh(attributes, builder.add_accessor(indices, sizeof(indices), GLTFDocument::COMPONENT_TYPE_UNSIGNED_BYTE, "SCALAR", 6));
+
+	const String path = builder.save("gltf_decode_accessors.glb");
+	REQUIRE(!path.is_empty());
+
+	Ref<GLTFDocument> doc;
+	doc.instantiate();
+	Ref<GLTFState> state;
+	state.instantiate();
+	REQUIRE(doc->parse(state, path) == OK);
+
+	Array meshes = state->get_meshes();
+	REQUIRE(meshes.size() == 1);
+	Ref<GLTFMesh> mesh = meshes[0];
+	REQUIRE(mesh->get_mesh()->get_surface_count() == 1);
+	Array arrays = mesh->get_mesh()->get_surface_arrays(0);
+
+	Vector<Vector3> points = arrays[Mesh::ARRAY_VERTEX];
+	Vector<Vector3> normals = arrays[Mesh::ARRAY_NORMAL];
+	REQUIRE(points.size() == 4);
+	REQUIRE(normals.size() == 4);
+	for (int i = 0; i < 4; i++) {
+		CHECK(points[i] == Vector3(vertices[i][0], vertices[i][1], vertices[i][2]));
+		CHECK(normals[i] == Vector3(vertices[i][3], vertices[i][4], vertices[i][5]));
+	}
+
+	Vector<Color> decoded_colors = arrays[Mesh::ARRAY_COLOR];
+	REQUIRE(decoded_colors.size() == 4);
+	CHECK(decoded_colors[0].is_equal_approx(Color(1, 0, 0, 1)));
+	CHECK(decoded_colors[1].is_equal_approx(Color(0, 1, 0, 128.0 / 255.0)));
+	CHECK(decoded_colors[2].is_equal_approx(Color(0, 0, 1, 0)));
+
+	Vector<Vector2> decoded_uvs = arrays[Mesh::ARRAY_TEX_UV2];
+	REQUIRE(decoded_uvs.size() == 4);
+	CHECK(decoded_uvs[2].is_equal_approx(Vector2(1, 1)));
+	CHECK(decoded_uvs[3].is_equal_approx(Vector2(0, 32768.0 / 65535.0)));
+
+	// Winding is flipped to clockwise.
+	Vector<int> decoded_indices = arrays[Mesh::ARRAY_INDEX];
+	REQUIRE(decoded_indices.size() == 6);
+	const int expected_indices[6] = { 0, 2, 1, 0, 3, 2 };
+	for (int i = 0; i < 6; i++) {
+		CHECK(decoded_indices[i] == expected_indices[i]);
+	}
+}
+
+TEST_CASE_BENCHMARK("[GLTFDocument][Benchmark] Import a large binary glTF") {
+	const int mesh_count = 64;
+	const int grid_size = 256;
+	const int image_count = 16;
+	const int image_size = 1024;
+
+	GLBBuilder builder;
+
+	Vector<Vector3> positions;
+	Vector<Vector3> normals;
+	Vector<Vector2> uvs;
+	Vector<uint32_t> indices;
+	for (int y = 0; y < grid_size; y++) {
+		for (int x = 0; x < grid_size; x++) {
+			Vector2 uv = Vector2(x, y) / (grid_size - 1);
+			positions.push_back(Vector3(uv.x, Math::sin(uv.x * 10.0) * 0.1, uv.y));
+			normals.push_back(Vector3(0, 1, 0));
+			uvs.push_back(uv);
+			if (x < grid_size - 1 && y < grid_size - 1) {
+				uint32_t i = y * grid_size + x;
+				indices.push_back(i);
+				indices.push_back(i + grid_size);
+				indices.push_back(i + 1);
+				indices.push_back(i + 1);
+				indices.push_back(i + grid_size);
+				indices.push_back(i + grid_size + 1);
+			}
+		}
+	}
+
+	for (int i = 0; i < mesh_count; i++) {
+		Dictionary attributes;
+		attributes["POSITION"] = builder.add_accessor(positions.ptr(), positions.size() * sizeof(Vector3), GLTFDocument::COMPONENT_TYPE_FLOAT, "VEC3", positions.size());
+		attributes["NORMAL"] = builder.add_accessor(normals.ptr(), normals.size() * sizeof(Vector3), GLTFDocument::COMPONENT_TYPE_FLOAT, "VEC3", normals.size());
+		attributes["TEXCOORD_0"] = builder.add_accessor(uvs.ptr(), uvs.size() * sizeof(Vector2), GLTFDocument::COMPONENT_TYPE_FLOAT, "VEC2", uvs.size());
+		builder.add_mesh(attributes, builder.add_accessor(indices.ptr(), indices.size() * sizeof(uint32_t), GLTFDocument::COMPONENT_TYPE_INT, "SCALAR", indices.size()));
+	}
+
+	Ref<Image> image;
+	image.instantiate();
+	image->create(image_size, image_size, false, Image::FORMAT_RGBA8);
+	for (int y = 0; y < image_size; y++) {
+		for (int x = 0; x < image_size; x++) {
+			image->set_pixel(x, y, Color(float(x) / image_size, float(y) / image_size, float((x * y) % 255) / 255.0));
+		}
+	}
+	for (int i = 0; i < image_count; i++) {
+		builder.add_png_image(image);
+	}
+
+	const String path = builder.save("gltf_benchmark.glb");
+	REQUIRE(!path.is_empty());
+
+	Ref<GLTFDocument> doc;
+	doc.instantiate();
+	Ref<GLTFState> state;
+	state.instantiate();
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	REQUIRE(doc->parse(state, path) == OK);
+	uint64_t usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	MESSAGE("Imported ", mesh_count, " meshes of ", positions.size(), " vertices and ", image_count, " images in ", usec / 1000, " ms");
+	CHECK(state->get_meshes().size() == mesh_count);
+	CHECK(state->get_images().size() == image_count);
+}
+
+} // namespace TestGLTFDocument
+
+#endif // TEST_GLTF_DOCUMENT_H
@@ -50,13 +50,14 @@ bool GridMap::_set(const StringName &p_name, const Variant &p_value) {
 			int amount = cells.size();
 			const int *r = cells.ptr();
 			ERR_FAIL_COND_V(amount % 3, false); // not even
-			cell_map.clear();
+			_clear_cells();
 			for (int i = 0; i < amount / 3; i++) {
 				IndexKey ik;
 				ik.key = decode_uint64((const uint8_t *)&r[i * 3]);
 				Cell cell;
 				cell.cell = decode_uint32((const uint8_t *)&r[i * 3 + 2]);
-				cell_map[ik] = cell;
+				int cell_count_change;
+				_store_cell(ik, &cell, cell_count_change);
 			}
 		}
 
@@ -96,14 +97,38 @@ bool GridMap::_get(const StringName &p_name, Variant &r_ret) const {
 	if (name == "data") {
 		Dictionary d;
 
+		// Save the cells sorted by key, so saving doesn't depend on the chunks' hashing order.
+		struct KeyCell {
+			IndexKey key;
+			Cell cell;
+		};
+		struct KeyCellComparator {
+			_FORCE_INLINE_ bool operator()(const KeyCell &p_a, const KeyCell &p_b) const {
+				return p_a.key < p_b.key;
+			}
+		};
+		LocalVector<KeyCell> sorted;
+		sorted.reserve(cell_count);
+		for (const Vector3i *E = cell_chunks.next(nullptr); E; E = cell_chunks.next(E)) {
+			const CellChunk *chunk = cell_chunks[*E];
+			for (int i = 0; i < CELL_CHUNK_CELLS; i++) {
+				if (chunk->used_mask[i >> 6] & (uint64_t(1) << (i & 63))) {
+					KeyCell kc;
+					kc.key = IndexKey(_chunk_index_to_cell(*E, i));
+					kc.cell = chunk->cells[i];
+					sorted.push_back(kc);
+				}
+			}
+		}
+		sorted.sort_custom<KeyCellComparator>();
+
 		Vector<int> cells;
-		cells.resize(cell_map.size() * 3);
+		cells.resize(sorted.size() * 3);
 		{
 			int *w = cells.ptrw();
-			int i = 0;
-			for (Map<IndexKey, Cell>::Element *E = cell_map.front(); E; E = E->next(), i++) {
-				encode_uint64(E->key().key, (uint8_t *)&w[i * 3]);
-				encode_uint32(E->get().cell, (uint8_t *)&w[i * 3 + 2]);
+			for (uint32_t i = 0; i < sorted.size(); i++) {
+				encode_uint64(sorted[i].key.key, (uint8_t *)&w[i * 3]);
+				encode_uint32(sorted[i].cell.cell, (uint8_t *)&w[i * 3 + 2]);
 			}
 		}
 
@@ -265,79 +290,188 @@ bool GridMap::get_center_z() const {
 	return center_z;
 }
 
-void GridMap::set_cell_item(const Vector3i &p_position, int p_item, int p_rot) {
-	if (baked_meshes.size() && !recreating_octants) {
-		//if you set a cell item, baked meshes go good bye
-		clear_baked_meshes();
-		_recreate_octant_data();
+GridMap::OctantKey GridMap::_get_octant_key(const Vector3i &p_cell) const {
+	// Rounding down, instead of simply rounding towards zero (truncating).
+	OctantKey ok;
+	ok.x = p_cell.x >= 0 ? p_cell.x / octant_size : (p_cell.x - (octant_size - 1)) / octant_size;
+	ok.y = p_cell.y >= 0 ? p_cell.y / octant_size : (p_cell.y - (octant_size - 1)) / octant_size;
+	ok.z = p_cell.z >= 0 ? p_cell.z / octant_size : (p_cell.z - (octant_size - 1)) / octant_size;
+	return ok;
+}
+
+const GridMap::Cell *GridMap::_get_cell_ptr(const IndexKey &p_key) const {
+	const Vector3i cell = p_key;
+	CellChunk *const *chunk = cell_chunks.getptr(_cell_to_chunk_key(cell));
+	if (!chunk) {
+		return nullptr;
+	}
+	const int index = _cell_to_chunk_index(cell);
+	if (!((*chunk)->used_mask[index >> 6] & (uint64_t(1) << (index & 63)))) {
+		return nullptr;
 	}
+	return &(*chunk)->cells[index];
+}
 
-	ERR_FAIL_INDEX(ABS(p_position.x), 1 << 20);
-	ERR_FAIL_INDEX(ABS(p_position.y), 1 << 20);
-	ERR_FAIL_INDEX(ABS(p_position.z), 1 << 20);
+void GridMap::_get_chunk_cells_in_box(const Vector3i &p_chunk_key, const CellChunk *p_chunk, const Vector3i &p_begin, const Vector3i &p_end, LocalVector<Vector3i> &r_cells, LocalVector<Cell> &r_values) const {
+	const Vector3i chunk_begin = p_chunk_key * CELL_CHUNK_SIZE;
+	const Vector3i from(MAX(p_begin.x, chunk_begin.x), MAX(p_begin.y, chunk_begin.y), MAX(p_begin.z, chunk_begin.z));
+	const Vector3i to(MIN(p_end.x, chunk_begin.x + CELL_CHUNK_SIZE), MIN(p_end.y, chunk_begin.y + CELL_CHUNK_SIZE), MIN(p_end.z, chunk_begin.z + CELL_CHUNK_SIZE));
+	for (int z = from.z; z < to.z; z++) {
+		for (int y = from.y; y < to.y; y++) {
+			for (int x = from.x; x < to.x; x++) {
+				const int index = _cell_to_chunk_index(Vector3i(x, y, z));
+				if (p_chunk->used_mask[index >> 6] & (uint64_t(1) << (index & 63))) {
+					r_cells.push_back(Vector3i(x, y, z));
+					r_values.push_back(p_chunk->cells[index]);
+				}
+			}
+		}
+	}
+}
 
-	IndexKey key;
-	key.x = p_position.x;
-	key.y = p_position.y;
-	key.z = p_position.z;
+void GridMap::_get_cells_in_box(const Vector3i &p_begin, const Vector3i &p_end, LocalVector<Vector3i> &r_cells, LocalVector<Cell> &r_values) const {
+	const Vector3i chunk_begin = _cell_to_chunk_key(p_begin);
+	const Vector3i chunk_end = _cell_to_chunk_key(p_end - Vector3i(1, 1, 1));
+	const int64_t box_chunks = int64_t(chunk_end.x - chunk_begin.x + 1) * (chunk_end.y - chunk_begin.y + 1) * (chunk_end.z - chunk_begin.z + 1);
 
-	OctantKey ok;
-	ok.x = p_position.x / octant_size;
-	ok.y = p_position.y / octant_size;
-	ok.z = p_position.z / octant_size;
-
-	if (p_item < 0) {
-		//erase
-		if (cell_map.has(key)) {
-			OctantKey octantkey = ok;
-
-			ERR_FAIL_COND(!octant_map.has(octantkey));
-			Octant &g = *octant_map[octantkey];
-			g.cells.erase(key);
-			g.dirty = true;
-			cell_map.erase(key);
-			_queue_octants_dirty();
+	if (box_chunks > cell_chunks.size()) {
+		// Large octants, it's cheaper to go over the chunks that exist.
+		for (const Vector3i *E = cell_chunks.next(nullptr); E; E = cell_chunks.next(E)) {
+			if (E->x >= chunk_begin.x && E->x <= chunk_end.x && E->y >= chunk_begin.y && E->y <= chunk_end.y && E->z >= chunk_begin.z && E->z <= chunk_end.z) {
+				_get_chunk_cells_in_box(*E, cell_chunks[*E], p_begin, p_end, r_cells, r_values);
+			}
 		}
 		return;
 	}
 
-	OctantKey octantkey = ok;
+	for (int z = chunk_begin.z; z <= chunk_end.z; z++) {
+		for (int y = chunk_begin.y; y <= chunk_end.y; y++) {
+			for (int x = chunk_begin.x; x <= chunk_end.x; x++) {
+				CellChunk *const *chunk = cell_chunks.getptr(Vector3i(x, y, z));
+				if (chunk) {
+					_get_chunk_cells_in_box(Vector3i(x, y, z), *chunk, p_begin, p_end, r_cells, r_values);
+				}
+			}
+		}
+	}
+}
 
-	if (!octant_map.has(octantkey)) {
-		//create octant because it does not exist
-		Octant *g = memnew(Octant);
-		g->dirty = true;
-		g->static_body = PhysicsServer3D::get_singleton()->body_create();
-		PhysicsServer3D::get_singleton()->body_set_mode(g->static_body, PhysicsServer3D::BODY_MODE_STATIC);
-		PhysicsServer3D::get_singleton()->body_attach_object_instance_id(g->static_body, get_instance_id());
-		PhysicsServer3D::get_singleton()->body_set_collision_layer(g->static_body, collision_layer);
-		PhysicsServer3D::get_singleton()->body_set_collision_mask(g->static_body, collision_mask);
-		SceneTree *st = SceneTree::get_singleton();
+bool GridMap::_store_cell(const IndexKey &p_key, const Cell *p_cell, int &r_cell_count_change) {
+	r_cell_count_change = 0;
 
-		if (st && st->is_debugging_collisions_hint()) {
-			g->collision_debug = RenderingServer::get_singleton()->mesh_create();
-			g->collision_debug_instance = RenderingServer::get_singleton()->instance_create();
-			RenderingServer::get_singleton()->instance_set_base(g->collision_debug_instance, g->collision_debug);
-		}
+	const Vector3i cell = p_key;
+	const Vector3i chunk_key = _cell_to_chunk_key(cell);
+	const int index = _cell_to_chunk_index(cell);
+	const uint64_t bit = uint64_t(1) << (index & 63);
+	CellChunk **chunk_ptr = cell_chunks.getptr(chunk_key);
+	CellChunk *chunk = chunk_ptr ? *chunk_ptr : nullptr;
 
-		octant_map[octantkey] = g;
+	if (!p_cell) {
+		if (!chunk || !(chunk->used_mask[index >> 6] & bit)) {
+			return false; // Nothing to do, the cell is already empty.
+		}
 
-		if (is_inside_world()) {
-			_octant_enter_world(octantkey);
-			_octant_transform(octantkey);
+		// Erase the cell, and its chunk once empty.
+		chunk->used_mask[index >> 6] &= ~bit;
+		chunk->cells[index] = Cell();
+		r_cell_count_change = -1;
+		cell_count--;
+		chunk->used--;
+		if (chunk->used == 0) {
+			memdelete(chunk);
+			cell_chunks.erase(chunk_key);
 		}
+		return true;
+	}
+
+	if (!chunk) {
+		chunk = memnew(CellChunk);
+		cell_chunks.set(chunk_key, chunk);
+	}
+	if (!(chunk->used_mask[index >> 6] & bit)) {
+		chunk->used_mask[index >> 6] |= bit;
+		r_cell_count_change = 1;
+		cell_count++;
+		chunk->used++;
+	} else if (chunk->cells[index].cell == p_cell->cell) {
+		return false; // Nothing changed.
+	}
+	chunk->cells[index] = *p_cell;
+	return true;
+}
+
+void GridMap::_clear_cells() {
+	for (const Vector3i *E = cell_chunks.next(nullptr); E; E = cell_chunks.next(E)) {
+		memdelete(cell_chunks[*E]);
 	}
+	cell_chunks.clear();
+	cell_count = 0;
+}
 
-	Octant &g = *octant_map[octantkey];
-	g.cells.insert(key);
-	g.dirty = true;
+GridMap::Octant *GridMap::_octant_create(const OctantKey &p_key) {
+	Octant *g = memnew(Octant);
+	g->dirty = true;
+	g->static_body = PhysicsServer3D::get_singleton()->body_create();
+	PhysicsServer3D::get_singleton()->body_set_mode(g->static_body, PhysicsServer3D::BODY_MODE_STATIC);
+	PhysicsServer3D::get_singleton()->body_attach_object_instance_id(g->static_body, get_instance_id());
+	PhysicsServer3D::get_singleton()->body_set_collision_layer(g->static_body, collision_layer);
+	PhysicsServer3D::get_singleton()->body_set_collision_mask(g->static_body, collision_mask);
+	SceneTree *st = SceneTree::get_singleton();
+
+	if (st && st->is_debugging_collisions_hint()) {
+		g->collision_debug = RenderingServer::get_singleton()->mesh_create();
+		g->collision_debug_instance = RenderingServer::get_singleton()->instance_create();
+		RenderingServer::get_singleton()->instance_set_base(g->collision_debug_instance, g->collision_debug);
+	}
+
+	octant_map.set(p_key, g);
+
+	if (is_inside_world()) {
+		_octant_enter_world(p_key);
+		_octant_transform(p_key);
+	}
+
+	return g;
+}
+
+void GridMap::_update_cell_octant(const IndexKey &p_key, int p_cell_count_change) {
+	OctantKey octantkey = _get_octant_key(p_key);
+	Octant **octant_ptr = octant_map.getptr(octantkey);
+	Octant *g;
+	if (octant_ptr) {
+		g = *octant_ptr;
+	} else {
+		//create octant because it does not exist
+		ERR_FAIL_COND(p_cell_count_change <= 0);
+		g = _octant_create(octantkey);
+	}
+
+	// Empty octants are cleaned up by the next update.
+	g->cell_count += p_cell_count_change;
+	g->dirty = true;
 	_queue_octants_dirty();
+}
+
+void GridMap::set_cell_item(const Vector3i &p_position, int p_item, int p_rot) {
+	if (baked_meshes.size()) {
+		//if you set a cell item, baked meshes go good bye
+		clear_baked_meshes();
+	}
+
+	ERR_FAIL_INDEX(ABS(p_position.x), 1 << 20);
+	ERR_FAIL_INDEX(ABS(p_position.y), 1 << 20);
+	ERR_FAIL_INDEX(ABS(p_position.z), 1 << 20);
+
+	IndexKey key(p_position);
 
 	Cell c;
 	c.item = p_item;
 	c.rot = p_rot;
 
-	cell_map[key] = c;
+	int cell_count_change;
+	if (_store_cell(key, p_item < 0 ? nullptr : &c, cell_count_change)) {
+		_update_cell_octant(key, cell_count_change);
+	}
 }
 
 int GridMap::get_cell_item(const Vector3i &p_position) const {
@@ -345,15 +479,11 @@ int GridMap::get_cell_item(const Vector3i &p_position) const {
 	ERR_FAIL_INDEX_V(ABS(p_position.y), 1 << 20, INVALID_CELL_ITEM);
 	ERR_FAIL_INDEX_V(ABS(p_position.z), 1 << 20, INVALID_CELL_ITEM);
 
-	IndexKey key;
-	key.x = p_position.x;
-	key.y = p_position.y;
-	key.z = p_position.z;
-
-	if (!cell_map.has(key)) {
+	const Cell *cell = _get_cell_ptr(IndexKey(p_position));
+	if (!cell) {
 		return INVALID_CELL_ITEM;
 	}
-	return cell_map[key].item;
+	return cell->item;
 }
 
 int GridMap::get_cell_item_orientation(const Vector3i &p_position) const {
@@ -361,15 +491,68 @@ int GridMap::get_cell_item_orientation(const Vector3i &p_position) const {
 	ERR_FAIL_INDEX_V(ABS(p_position.y), 1 << 20, -1);
 	ERR_FAIL_INDEX_V(ABS(p_position.z), 1 << 20, -1);
 
-	IndexKey key;
-	key.x = p_position.x;
-	key.y = p_position.y;
-	key.z = p_position.z;
-
-	if (!cell_map.has(key)) {
+	const Cell *cell = _get_cell_ptr(IndexKey(p_position));
+	if (!cell) {
 		return -1;
 	}
-	return cell_map[key].rot;
+	return cell->rot;
+}
+
+void GridMap::fill_box(const Vector3i &p_position, const Vector3i &p_size, int p_item, int p_rot) {
+	ERR_FAIL_COND(p_size.x < 0 || p_size.y < 0 || p_size.z < 0);
+	if (p_size.x == 0 || p_size.y == 0 || p_size.z == 0) {
+		return;
+	}
+	const Vector3i end = p_position + p_size - Vector3i(1, 1, 1);
+	ERR_FAIL_INDEX(ABS(p_position.x), 1 << 20);
+	ERR_FAIL_INDEX(ABS(p_position.y), 1 << 20);
+	ERR_FAIL_INDEX(ABS(p_position.z), 1 << 20);
+	ERR_FAIL_INDEX(ABS(end.x), 1 << 20);
+	ERR_FAIL_INDEX(ABS(end.y), 1 << 20);
+	ERR_FAIL_INDEX(ABS(end.z), 1 << 20);
+
+	if (baked_meshes.size()) {
+		clear_baked_meshes();
+	}
+
+	Cell c;
+	c.item = p_item;
+	c.rot = p_rot;
+
+	for (int z = p_position.z; z <= end.z; z++) {
+		for (int y = p_position.y; y <= end.y; y++) {
+			for (int x = p_position.x; x <= end.x; x++) {
+				IndexKey key(Vector3i(x, y, z));
+				int cell_count_change;
+				if (_store_cell(key, p_item < 0 ? nullptr : &c, cell_count_change)) {
+					_update_cell_octant(key, cell_count_change);
+				}
+			}
+		}
+	}
+}
+
+void GridMap::set_cell_items(const PackedInt32Array &p_cells) {
+	ERR_FAIL_COND_MSG(p_cells.size() % 5, "The cells must have 5 integers each: x, y, z, item and orientation.");
+
+	if (baked_meshes.size()) {
+		clear_baked_meshes();
+	}
+
+	const int32_t *r = p_cells.ptr();
+	for (int i = 0; i < p_cells.size(); i += 5) {
+		ERR_CONTINUE(ABS(r[i]) >= 1 << 20 || ABS(r[i + 1]) >= 1 << 20 || ABS(r[i + 2]) >= 1 << 20);
+
+		IndexKey key(Vector3i(r[i], r[i + 1], r[i + 2]));
+		Cell c;
+		c.item = r[i + 3];
+		c.rot = r[i + 4];
+
+		int cell_count_change;
+		if (_store_cell(key, r[i + 3] < 0 ? nullptr : &c, cell_count_change)) {
+			_update_cell_octant(key, cell_count_change);
+		}
+	}
 }
 
 Vector3i GridMap::world_to_map(const Vector3 &p_world_position) const {
@@ -403,150 +586,181 @@ void GridMap::_octant_transform(const OctantKey &p_key) {
 	}
 }
 
-bool GridMap::_octant_update(const OctantKey &p_key) {
-	ERR_FAIL_COND_V(!octant_map.has(p_key), false);
-	Octant &g = *octant_map[p_key];
-	if (!g.dirty) {
-		return false;
-	}
-
-	//erase body shapes
-	PhysicsServer3D::get_singleton()->body_clear_shapes(g.static_body);
+void GridMap::_octant_build(uint32_t p_index, OctantBuild *p_builds) {
+	// Runs on the worker threads, so it only reads the cells and the mesh library.
+	struct CellDataComparator {
+		_FORCE_INLINE_ bool operator()(const OctantBuild::CellData &p_a, const OctantBuild::CellData &p_b) const {
+			return p_a.item < p_b.item || (p_a.item == p_b.item && p_a.key < p_b.key);
+		}
+	};
 
-	//erase body shapes debug
-	if (g.collision_debug.is_valid()) {
-		RS::get_singleton()->mesh_clear(g.collision_debug);
+	OctantBuild &b = p_builds[p_index];
+	if (!mesh_library.is_valid()) {
+		return;
 	}
 
-	//erase navigation
-	for (Map<IndexKey, Octant::NavMesh>::Element *E = g.navmesh_ids.front(); E; E = E->next()) {
-		NavigationServer3D::get_singleton()->free(E->get().region);
-	}
-	g.navmesh_ids.clear();
+	LocalVector<Vector3i> cells;
+	LocalVector<Cell> values;
+	const Vector3i begin = Vector3i(b.key.x, b.key.y, b.key.z) * octant_size;
+	_get_cells_in_box(begin, begin + Vector3i(octant_size, octant_size, octant_size), cells, values);
 
-	//erase multimeshes
+	const Vector3 ofs = _get_offset();
+	b.cells.reserve(cells.size());
+	for (uint32_t i = 0; i < cells.size(); i++) {
+		const Cell &c = values[i];
+		if (!mesh_library->has_item(c.item)) {
+			continue;
+		}
 
-	for (int i = 0; i < g.multimesh_instances.size(); i++) {
-		RS::get_singleton()->free(g.multimesh_instances[i].instance);
-		RS::get_singleton()->free(g.multimesh_instances[i].multimesh);
+		OctantBuild::CellData cd;
+		cd.xform.basis.set_orthogonal_index(c.rot);
+		cd.xform.set_origin(Vector3(cells[i]) * cell_size + ofs);
+		cd.xform.basis.scale(Vector3(cell_scale, cell_scale, cell_scale));
+		cd.key = IndexKey(cells[i]);
+		cd.item = c.item;
+		b.cells.push_back(cd);
 	}
-	g.multimesh_instances.clear();
+	b.cells.sort_custom<CellDataComparator>();
 
-	if (g.cells.size() == 0) {
-		//octant no longer needed
-		_octant_clean_up(p_key);
-		return true;
+	//prepare the multimeshes, only if not baked
+	if (baked_meshes.size() != 0) {
+		return;
 	}
+	for (uint32_t first = 0; first < b.cells.size();) {
+		const int item = b.cells[first].item;
+		uint32_t count = 1;
+		while (first + count < b.cells.size() && b.cells[first + count].item == item) {
+			count++;
+		}
 
-	Vector<Vector3> col_debug;
-
-	/*
-	 * foreach item in this octant,
-	 * set item's multimesh's instance count to number of cells which have this item
-	 * and set said multimesh bounding box to one containing all cells which have this item
-	 */
+		if (mesh_library->get_item_mesh(item).is_valid()) {
+			OctantBuild::MultimeshData md;
+			md.item = item;
+			md.first = first;
+			md.count = count;
+			md.buffer.resize(count * 12);
+			float *w = md.buffer.ptrw();
+			for (uint32_t i = 0; i < count; i++, w += 12) {
+				const Transform3D &xform = b.cells[first + i].xform;
+				w[0] = xform.basis.elements[0][0];
+				w[1] = xform.basis.elements[0][1];
+				w[2] = xform.basis.elements[0][2];
+				w[3] = xform.origin.x;
+				w[4] = xform.basis.elements[1][0];
+				w[5] = xform.basis.elements[1][1];
+				w[6] = xform.basis.elements[1][2];
+				w[7] = xform.origin.y;
+				w[8] = xform.basis.elements[2][0];
+				w[9] = xform.basis.elements[2][1];
+				w[10] = xform.basis.elements[2][2];
+				w[11] = xform.origin.z;
+			}
+			b.multimeshes.push_back(md);
+		}
 
-	Map<int, List<Pair<Transform3D, IndexKey>>> multimesh_items;
+		first += count;
+	}
+}
 
-	for (Set<IndexKey>::Element *E = g.cells.front(); E; E = E->next()) {
-		ERR_CONTINUE(!cell_map.has(E->get()));
-		const Cell &c = cell_map[E->get()];
+void GridMap::_octant_update(OctantBuild &p_build) {
+	Octant &g = *p_build.octant;
 
-		if (!mesh_library.is_valid() || !mesh_library->has_item(c.item)) {
-			continue;
-		}
+	//erase body shapes
+	PhysicsServer3D::get_singleton()->body_clear_shapes(g.static_body);
 
-		Vector3 cellpos = Vector3(E->get().x, E->get().y, E->get().z);
-		Vector3 ofs = _get_offset();
+	//erase body shapes debug
+	if (g.collision_debug.is_valid()) {
+		RS::get_singleton()->mesh_clear(g.collision_debug);
+	}
 
-		Transform3D xform;
+	// Keep the previous navigation regions and multimeshes until the new ones are ready,
+	// they are swapped in at once so the octant is never drawn empty.
+	Map<IndexKey, Octant::NavMesh> old_navmesh_ids = g.navmesh_ids;
+	Vector<Octant::MultimeshInstance> old_multimesh_instances = g.multimesh_instances;
+	g.navmesh_ids.clear();
+	g.multimesh_instances.clear();
 
-		xform.basis.set_orthogonal_index(c.rot);
-		xform.set_origin(cellpos * cell_size + ofs);
-		xform.basis.scale(Vector3(cell_scale, cell_scale, cell_scale));
-		if (baked_meshes.size() == 0) {
-			if (mesh_library->get_item_mesh(c.item).is_valid()) {
-				if (!multimesh_items.has(c.item)) {
-					multimesh_items[c.item] = List<Pair<Transform3D, IndexKey>>();
-				}
+	Vector<Vector3> col_debug;
 
-				Pair<Transform3D, IndexKey> p;
-				p.first = xform;
-				p.second = E->get();
-				multimesh_items[c.item].push_back(p);
-			}
-		}
+	for (uint32_t cell_index = 0; cell_index < p_build.cells.size(); cell_index++) {
+		const OctantBuild::CellData &cd = p_build.cells[cell_index];
 
-		Vector<MeshLibrary::ShapeData> shapes = mesh_library->get_item_shapes(c.item);
+		Vector<MeshLibrary::ShapeData> shapes = mesh_library->get_item_shapes(cd.item);
 		// add the item's shape at given xform to octant's static_body
 		for (int i = 0; i < shapes.size(); i++) {
 			// add the item's shape
 			if (!shapes[i].shape.is_valid()) {
 				continue;
 			}
-			PhysicsServer3D::get_singleton()->body_add_shape(g.static_body, shapes[i].shape->get_rid(), xform * shapes[i].local_transform);
+			PhysicsServer3D::get_singleton()->body_add_shape(g.static_body, shapes[i].shape->get_rid(), cd.xform * shapes[i].local_transform);
 			if (g.collision_debug.is_valid()) {
-				shapes.write[i].shape->add_vertices_to_array(col_debug, xform * shapes[i].local_transform);
+				shapes.write[i].shape->add_vertices_to_array(col_debug, cd.xform * shapes[i].local_transform);
 			}
 		}
 
 		// add the item's navmesh at given xform to GridMap's Navigation ancestor
-		Ref<NavigationMesh> navmesh = mesh_library->get_item_navmesh(c.item);
+		Ref<NavigationMesh> navmesh = mesh_library->get_item_navmesh(cd.item);
 		if (navmesh.is_valid()) {
 			Octant::NavMesh nm;
-			nm.xform = xform * mesh_library->get_item_navmesh_transform(c.item);
+			nm.xform = cd.xform * mesh_library->get_item_navmesh_transform(cd.item);
 
 			if (bake_navigation) {
 				RID region = NavigationServer3D::get_singleton()->region_create();
 				NavigationServer3D::get_singleton()->region_set_layers(region, navigation_layers);
 				NavigationServer3D::get_singleton()->region_set_navmesh(region, navmesh);
-				NavigationServer3D::get_singleton()->region_set_transform(region, get_global_transform() * mesh_library->get_item_navmesh_transform(c.item));
+				NavigationServer3D::get_singleton()->region_set_transform(region, get_global_transform() * mesh_library->get_item_navmesh_transform(cd.item));
 				NavigationServer3D::get_singleton()->region_set_map(region, get_world_3d()->get_navigation_map());
 				nm.region = region;
 			}
 
-			g.navmesh_ids[E->get()] = nm;
+			g.navmesh_ids[cd.key] = nm;
 		}
 	}
 
-	//update multimeshes, only if not baked
-	if (baked_meshes.size() == 0) {
-		for (Map<int, List<Pair<Transform3D, IndexKey>>>::Element *E = multimesh_items.front(); E; E = E->next()) {
-			Octant::MultimeshInstance mmi;
+	//update multimeshes, the transforms are uploaded in a single buffer
+	for (uint32_t mm_index = 0; mm_index < p_build.multimeshes.size(); mm_index++) {
+		const OctantBuild::MultimeshData &md = p_build.multimeshes[mm_index];
+		Octant::MultimeshInstance mmi;
 
-			RID mm = RS::get_singleton()->multimesh_create();
-			RS::get_singleton()->multimesh_allocate_data(mm, E->get().size(), RS::MULTIMESH_TRANSFORM_3D);
-			RS::get_singleton()->multimesh_set_mesh(mm, mesh_library->get_item_mesh(E->key())->get_rid());
+		RID mm = RS::get_singleton()->multimesh_create();
+		RS::get_singleton()->multimesh_allocate_data(mm, md.count, RS::MULTIMESH_TRANSFORM_3D);
+		RS::get_singleton()->multimesh_set_mesh(mm, mesh_library->get_item_mesh(md.item)->get_rid());
+		RS::get_singleton()->multimesh_set_buffer(mm, md.buffer);
 
-			int idx = 0;
-			for (List<Pair<Transform3D, IndexKey>>::Element *F = E->get().front(); F; F = F->next()) {
-				RS::get_singleton()->multimesh_instance_set_transform(mm, idx, F->get().first);
 #ifdef TOOLS_ENABLED
-
-				Octant::MultimeshInstance::Item it;
-				it.index = idx;
-				it.transform = F->get().first;
-				it.key = F->get().second;
-				mmi.items.push_back(it);
+		mmi.items.resize(md.count);
+		for (uint32_t i = 0; i < md.count; i++) {
+			Octant::MultimeshInstance::Item &it = mmi.items.write[i];
+			it.index = i;
+			it.transform = p_build.cells[md.first + i].xform;
+			it.key = p_build.cells[md.first + i].key;
+		}
 #endif
 
-				idx++;
-			}
+		RID instance = RS::get_singleton()->instance_create();
+		RS::get_singleton()->instance_set_base(instance, mm);
 
-			RID instance = RS::get_singleton()->instance_create();
-			RS::get_singleton()->instance_set_base(instance, mm);
+		if (is_inside_tree()) {
+			RS::get_singleton()->instance_set_scenario(instance, get_world_3d()->get_scenario());
+			RS::get_singleton()->instance_set_transform(instance, get_global_transform());
+		}
 
-			if (is_inside_tree()) {
-				RS::get_singleton()->instance_set_scenario(instance, get_world_3d()->get_scenario());
-				RS::get_singleton()->instance_set_transform(instance, get_global_transform());
-			}
+		mmi.multimesh = mm;
+		mmi.instance = instance;
 
-			mmi.multimesh = mm;
-			mmi.instance = instance;
+		g.multimesh_instances.push_back(mmi);
+	}
 
-			g.multimesh_instances.push_back(mmi);
+	//erase the previous navigation and multimeshes
+	for (Map<IndexKey, Octant::NavMesh>::Element *E = old_navmesh_ids.front(); E; E = E->next()) {
+		if (E->get().region.is_valid()) {
+			NavigationServer3D::get_singleton()->free(E->get().region);
 		}
 	}
+	for (int i = 0; i < old_multimesh_instances.size(); i++) {
+		RS::get_singleton()->free(old_multimesh_instances[i].instance);
+		RS::get_singleton()->free(old_multimesh_instances[i].multimesh);
+	}
 
 	if (col_debug.size()) {
 		Array arr;
@@ -561,14 +775,12 @@ bool GridMap::_octant_update(const OctantKey &p_key) {
 	}
 
 	g.dirty = false;
-
-	return false;
 }
 
 void GridMap::_reset_physic_bodies_collision_filters() {
-	for (Map<OctantKey, Octant *>::Element *E = octant_map.front(); E; E = E->next()) {
-		PhysicsServer3D::get_singleton()->body_set_collision_layer(E->get()->static_body, collision_layer);
-		PhysicsServer3D::get_singleton()->body_set_collision_mask(E->get()->static_body, collision_mask);
+	for (const OctantKey *E = octant_map.next(nullptr); E; E = octant_map.next(E)) {
+		PhysicsServer3D::get_singleton()->body_set_collision_layer(octant_map[*E]->static_body, collision_layer);
+		PhysicsServer3D::get_singleton()->body_set_collision_mask(octant_map[*E]->static_body, collision_mask);
 	}
 }
 
@@ -590,8 +802,9 @@ void GridMap::_octant_enter_world(const OctantKey &p_key) {
 
 	if (bake_navigation && mesh_library.is_valid()) {
 		for (Map<IndexKey, Octant::NavMesh>::Element *F = g.navmesh_ids.front(); F; F = F->next()) {
-			if (cell_map.has(F->key()) && F->get().region.is_valid() == false) {
-				Ref<NavigationMesh> nm = mesh_library->get_item_navmesh(cell_map[F->key()].item);
+			const Cell *cell = _get_cell_ptr(F->key());
+			if (cell && F->get().region.is_valid() == false) {
+				Ref<NavigationMesh> nm = mesh_library->get_item_navmesh(cell->item);
 				if (nm.is_valid()) {
 					RID region = NavigationServer3D::get_singleton()->region_create();
 					NavigationServer3D::get_singleton()->region_set_layers(region, navigation_layers);
@@ -661,8 +874,8 @@ void GridMap::_notification(int p_what) {
 		case NOTIFICATION_ENTER_WORLD: {
 			last_transform = get_global_transform();
 
-			for (Map<OctantKey, Octant *>::Element *E = octant_map.front(); E; E = E->next()) {
-				_octant_enter_world(E->key());
+			for (const OctantKey *E = octant_map.next(nullptr); E; E = octant_map.next(E)) {
+				_octant_enter_world(*E);
 			}
 
 			for (int i = 0; i < baked_meshes.size(); i++) {
@@ -677,8 +890,8 @@ void GridMap::_notification(int p_what) {
 				break;
 			}
 			//update run
-			for (Map<OctantKey, Octant *>::Element *E = octant_map.front(); E; E = E->next()) {
-				_octant_transform(E->key());
+			for (const OctantKey *E = octant_map.next(nullptr); E; E = octant_map.next(E)) {
+				_octant_transform(*E);
 			}
 
 			last_transform = new_xform;
@@ -688,8 +901,8 @@ void GridMap::_notification(int p_what) {
 			}
 		} break;
 		case NOTIFICATION_EXIT_WORLD: {
-			for (Map<OctantKey, Octant *>::Element *E = octant_map.front(); E; E = E->next()) {
-				_octant_exit_world(E->key());
+			for (const OctantKey *E = octant_map.next(nullptr); E; E = octant_map.next(E)) {
+				_octant_exit_world(*E);
 			}
 
 			//_queue_octants_dirty(MAP_DIRTY_INSTANCES|MAP_DIRTY_TRANSFORMS);
@@ -711,8 +924,8 @@ void GridMap::_update_visibility() {
 		return;
 	}
 
-	for (Map<OctantKey, Octant *>::Element *e = octant_map.front(); e; e = e->next()) {
-		Octant *octant = e->value();
+	for (const OctantKey *E = octant_map.next(nullptr); E; E = octant_map.next(E)) {
+		Octant *octant = octant_map[*E];
 		for (int i = 0; i < octant->multimesh_instances.size(); i++) {
 			const Octant::MultimeshInstance &mi = octant->multimesh_instances[i];
 			RS::get_singleton()->instance_set_visible(mi.instance, is_visible_in_tree());
@@ -734,27 +947,33 @@ void GridMap::_queue_octants_dirty() {
 }
 
 void GridMap::_recreate_octant_data() {
-	recreating_octants = true;
-	Map<IndexKey, Cell> cell_copy = cell_map;
-	_clear_internal();
-	for (Map<IndexKey, Cell>::Element *E = cell_copy.front(); E; E = E->next()) {
-		set_cell_item(Vector3i(E->key()), E->get().item, E->get().rot);
+	_clear_octants();
+	for (const Vector3i *E = cell_chunks.next(nullptr); E; E = cell_chunks.next(E)) {
+		const CellChunk *chunk = cell_chunks[*E];
+		for (int i = 0; i < CELL_CHUNK_CELLS; i++) {
+			if (chunk->used_mask[i >> 6] & (uint64_t(1) << (i & 63))) {
+				_update_cell_octant(IndexKey(_chunk_index_to_cell(*E, i)), 1);
+			}
+		}
 	}
-	recreating_octants = false;
 }
 
-void GridMap::_clear_internal() {
-	for (Map<OctantKey, Octant *>::Element *E = octant_map.front(); E; E = E->next()) {
+void GridMap::_clear_octants() {
+	for (const OctantKey *E = octant_map.next(nullptr); E; E = octant_map.next(E)) {
 		if (is_inside_world()) {
-			_octant_exit_world(E->key());
+			_octant_exit_world(*E);
 		}
 
-		_octant_clean_up(E->key());
-		memdelete(E->get());
+		_octant_clean_up(*E);
+		memdelete(octant_map[*E]);
 	}
 
 	octant_map.clear();
-	cell_map.clear();
+}
+
+void GridMap::_clear_internal() {
+	_clear_octants();
+	_clear_cells();
 }
 
 void GridMap::clear() {
@@ -771,16 +990,42 @@ void GridMap::_update_octants_callback() {
 		return;
 	}
 
-	List<OctantKey> to_delete;
-	for (Map<OctantKey, Octant *>::Element *E = octant_map.front(); E; E = E->next()) {
-		if (_octant_update(E->key())) {
-			to_delete.push_back(E->key());
+	// Free the octants that no longer have cells, and gather the dirty ones.
+	LocalVector<OctantKey> to_delete;
+	LocalVector<OctantBuild> builds;
+	for (const OctantKey *E = octant_map.next(nullptr); E; E = octant_map.next(E)) {
+		Octant *g = octant_map[*E];
+		if (!g->dirty) {
+			continue;
+		}
+		if (g->cell_count == 0) {
+			to_delete.push_back(*E);
+			continue;
+		}
+		builds.push_back(OctantBuild());
+		builds[builds.size() - 1].key = *E;
+		builds[builds.size() - 1].octant = g;
+	}
+
+	for (uint32_t i = 0; i < to_delete.size(); i++) {
+		_octant_clean_up(to_delete[i]);
+		memdelete(octant_map[to_delete[i]]);
+		octant_map.erase(to_delete[i]);
+	}
+
+	// Compute the transforms and multimesh buffers on the worker threads, this only reads the cells.
+	ThreadWorkPool *pool = is_inside_tree() && builds.size() > 1 ? get_tree()->get_thread_work_pool_for_main_thread() : nullptr;
+	if (pool) {
+		pool->do_work(builds.size(), this, &GridMap::_octant_build, builds.ptr());
+	} else {
+		for (uint32_t i = 0; i < builds.size(); i++) {
+			_octant_build(i, builds.ptr());
 		}
 	}
 
-	while (to_delete.front()) {
-		octant_map.erase(to_delete.front()->get());
-		to_delete.pop_back();
+	// Then swap the results in, the servers are only used from here.
+	for (uint32_t i = 0; i < builds.size(); i++) {
+		_octant_update(builds[i]);
 	}
 
 	_update_visibility();
@@ -822,6 +1067,9 @@ void GridMap::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_cell_item", "position"), &GridMap::get_cell_item);
 	ClassDB::bind_method(D_METHOD("get_cell_item_orientation", "position"), &GridMap::get_cell_item_orientation);
 
+	ClassDB::bind_method(D_METHOD("fill_box", "position", "size", "item", "orientation"), &GridMap::fill_box, DEFVAL(0));
+	ClassDB::bind_method(D_METHOD("set_cell_items", "cells"), &GridMap::set_cell_items);
+
 	ClassDB::bind_method(D_METHOD("world_to_map", "world_position"), &GridMap::world_to_map);
 	ClassDB::bind_method(D_METHOD("map_to_world", "map_position"), &GridMap::map_to_world);
 
@@ -882,9 +1130,8 @@ void GridMap::set_clip(bool p_enabled, bool p_clip_above, int p_floor, Vector3::
 	clip_above = p_clip_above;
 
 	//make it all update
-	for (Map<OctantKey, Octant *>::Element *E = octant_map.front(); E; E = E->next()) {
-		Octant *g = E->get();
-		g->dirty = true;
+	for (const OctantKey *E = octant_map.next(nullptr); E; E = octant_map.next(E)) {
+		octant_map[*E]->dirty = true;
 	}
 	awaiting_update = true;
 	_update_octants_callback();
@@ -901,11 +1148,15 @@ float GridMap::get_cell_scale() const {
 
 Array GridMap::get_used_cells() const {
 	Array a;
-	a.resize(cell_map.size());
-	int i = 0;
-	for (Map<IndexKey, Cell>::Element *E = cell_map.front(); E; E = E->next()) {
-		Vector3 p(E->key().x, E->key().y, E->key().z);
-		a[i++] = p;
+	a.resize(cell_count);
+	int idx = 0;
+	for (const Vector3i *E = cell_chunks.next(nullptr); E; E = cell_chunks.next(E)) {
+		const CellChunk *chunk = cell_chunks[*E];
+		for (int i = 0; i < CELL_CHUNK_CELLS; i++) {
+			if (chunk->used_mask[i >> 6] & (uint64_t(1) << (i & 63))) {
+				a[idx++] = Vector3(_chunk_index_to_cell(*E, i));
+			}
+		}
 	}
 
 	return a;
@@ -919,34 +1170,49 @@ Array GridMap::get_meshes() {
 	Vector3 ofs = _get_offset();
 	Array meshes;
 
-	for (Map<IndexKey, Cell>::Element *E = cell_map.front(); E; E = E->next()) {
-		int id = E->get().item;
-		if (!mesh_library->has_item(id)) {
-			continue;
-		}
-		Ref<Mesh> mesh = mesh_library->get_item_mesh(id);
-		if (mesh.is_null()) {
-			continue;
-		}
-
-		IndexKey ik = E->key();
+	for (const Vector3i *E = cell_chunks.next(nullptr); E; E = cell_chunks.next(E)) {
+		const CellChunk *chunk = cell_chunks[*E];
+		for (int i = 0; i < CELL_CHUNK_CELLS; i++) {
+			if (!(chunk->used_mask[i >> 6] & (uint64_t(1) << (i & 63)))) {
+				continue;
+			}
+			int id = chunk->cells[i].item;
+			if (!mesh_library->has_item(id)) {
+				continue;
+			}
+			Ref<Mesh> mesh = mesh_library->get_item_mesh(id);
+			if (mesh.is_null()) {
+				continue;
+			}
 
-		Vector3 cellpos = Vector3(ik.x, ik.y, ik.z);
+			Vector3 cellpos = Vector3(_chunk_index_to_cell(*E, i));
 
-		Transform3D xform;
+			Transform3D xform;
 
-		xform.basis.set_orthogonal_index(E->get().rot);
+			xform.basis.set_orthogonal_index(chunk->cells[i].rot);
 
-		xform.set_origin(cellpos * cell_size + ofs);
-		xform.basis.scale(Vector3(cell_scale, cell_scale, cell_scale));
+			xform.set_origin(cellpos * cell_size + ofs);
+			xform.basis.scale(Vector3(cell_scale, cell_scale, cell_scale));
 
-		meshes.push_back(xform);
-		meshes.push_back(mesh);
+			meshes.push_back(xform);
+			meshes.push_back(mesh);
+		}
 	}
 
 	return meshes;
 }
 
+Vector<RID> GridMap::get_octant_multimeshes() const {
+	Vector<RID> multimeshes;
+	for (const OctantKey *E = octant_map.next(nullptr); E; E = octant_map.next(E)) {
+		const Octant *octant = octant_map[*E];
+		for (int i = 0; i < octant->multimesh_instances.size(); i++) {
+			multimeshes.push_back(octant->multimesh_instances[i].multimesh);
+		}
+	}
+	return multimeshes;
+}
+
 Vector3 GridMap::_get_offset() const {
 	return Vector3(
 			cell_size.x * 0.5 * int(center_x),
@@ -971,54 +1237,57 @@ void GridMap::make_baked_meshes(bool p_gen_lightmap_uv, float p_lightmap_uv_texe
 	//generate
 	Map<OctantKey, Map<Ref<Material>, Ref<SurfaceTool>>> surface_map;
 
-	for (Map<IndexKey, Cell>::Element *E = cell_map.front(); E; E = E->next()) {
-		IndexKey key = E->key();
+	for (const Vector3i *E = cell_chunks.next(nullptr); E; E = cell_chunks.next(E)) {
+		const CellChunk *chunk = cell_chunks[*E];
+		for (int cell_index = 0; cell_index < CELL_CHUNK_CELLS; cell_index++) {
+			if (!(chunk->used_mask[cell_index >> 6] & (uint64_t(1) << (cell_index & 63)))) {
+				continue;
+			}
+			const Vector3i cell = _chunk_index_to_cell(*E, cell_index);
 
-		int item = E->get().item;
-		if (!mesh_library->has_item(item)) {
-			continue;
-		}
+			int item = chunk->cells[cell_index].item;
+			if (!mesh_library->has_item(item)) {
+				continue;
+			}
 
-		Ref<Mesh> mesh = mesh_library->get_item_mesh(item);
-		if (!mesh.is_valid()) {
-			continue;
-		}
+			Ref<Mesh> mesh = mesh_library->get_item_mesh(item);
+			if (!mesh.is_valid()) {
+				continue;
+			}
 
-		Vector3 cellpos = Vector3(key.x, key.y, key.z);
-		Vector3 ofs = _get_offset();
+			Vector3 cellpos = Vector3(cell);
+			Vector3 ofs = _get_offset();
 
-		Transform3D xform;
+			Transform3D xform;
 
-		xform.basis.set_orthogonal_index(E->get().rot);
-		xform.set_origin(cellpos * cell_size + ofs);
-		xform.basis.scale(Vector3(cell_scale, cell_scale, cell_scale));
+			xform.basis.set_orthogonal_index(chunk->cells[cell_index].rot);
+			xform.set_origin(cellpos * cell_size + ofs);
+			xform.basis.scale(Vector3(cell_scale, cell_scale, cell_scale));
 
-		OctantKey ok;
-		ok.x = key.x / octant_size;
-		ok.y = key.y / octant_size;
-		ok.z = key.z / octant_size;
+			OctantKey ok = _get_octant_key(cell);
 
-		if (!surface_map.has(ok)) {
-			surface_map[ok] = Map<Ref<Material>, Ref<SurfaceTool>>();
-		}
+			if (!surface_map.has(ok)) {
+				surface_map[ok] = Map<Ref<Material>, Ref<SurfaceTool>>();
+			}
 
-		Map<Ref<Material>, Ref<SurfaceTool>> &mat_map = surface_map[ok];
+			Map<Ref<Material>, Ref<SurfaceTool>> &mat_map = surface_map[ok];
 
-		for (int i = 0; i < mesh->get_surface_count(); i++) {
-			if (mesh->surface_get_primitive_type(i) != Mesh::PRIMITIVE_TRIANGLES) {
-				continue;
-			}
+			for (int i = 0; i < mesh->get_surface_count(); i++) {
+				if (mesh->surface_get_primitive_type(i) != Mesh::PRIMITIVE_TRIANGLES) {
+					continue;
+				}
 
-			Ref<Material> surf_mat = mesh->surface_get_material(i);
-			if (!mat_map.has(surf_mat)) {
-				Ref<SurfaceTool> st;
-				st.instantiate();
-				st->begin(Mesh::PRIMITIVE_TRIANGLES);
-				st->set_material(surf_mat);
-				mat_map[surf_mat] = st;
-			}
+				Ref<Material> surf_mat = mesh->surface_get_material(i);
+				if (!mat_map.has(surf_mat)) {
+					Ref<SurfaceTool> st;
+					st.instantiate();
+					st->begin(Mesh::PRIMITIVE_TRIANGLES);
+					st->set_material(surf_mat);
+					mat_map[surf_mat] = st;
+				}
 
-			mat_map[surf_mat]->append_from(mesh, i, xform);
+				mat_map[surf_mat]->append_from(mesh, i, xform);
+			}
 		}
 	}
 
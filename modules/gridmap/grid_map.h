@@ -31,6 +31,8 @@
 #ifndef GRID_MAP_H
 #define GRID_MAP_H
 
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
 #include "scene/3d/node_3d.h"
 #include "scene/resources/mesh_library.h"
 #include "scene/resources/multimesh.h"
@@ -58,6 +60,10 @@ class GridMap : public Node3D {
 			return key < p_key.key;
 		}
 
+		_FORCE_INLINE_ bool operator==(const IndexKey &p_key) const {
+			return key == p_key.key;
+		}
+
 		_FORCE_INLINE_ operator Vector3i() const {
 			return Vector3i(x, y, z);
 		}
@@ -105,7 +111,7 @@ class GridMap : public Node3D {
 		};
 
 		Vector<MultimeshInstance> multimesh_instances;
-		Set<IndexKey> cells;
+		int cell_count = 0;
 		RID collision_debug;
 		RID collision_debug_instance;
 
@@ -128,10 +134,41 @@ class GridMap : public Node3D {
 			return key < p_key.key;
 		}
 
+		_FORCE_INLINE_ bool operator==(const OctantKey &p_key) const {
+			return key == p_key.key;
+		}
+
 		//OctantKey(const IndexKey& p_k, int p_item) { indexkey=p_k.key; item=p_item; }
 		OctantKey() {}
 	};
 
+	struct OctantKeyHasher {
+		_FORCE_INLINE_ static uint32_t hash(const OctantKey &p_key) { return hash_one_uint64(p_key.key); }
+	};
+
+	/**
+	 * @brief The data needed to update an Octant, computed from its cells on the worker threads.
+	 */
+	struct OctantBuild {
+		struct CellData {
+			Transform3D xform;
+			IndexKey key;
+			int item = 0;
+		};
+
+		struct MultimeshData {
+			int item = 0;
+			uint32_t first = 0;
+			uint32_t count = 0;
+			Vector<float> buffer;
+		};
+
+		OctantKey key;
+		Octant *octant = nullptr;
+		LocalVector<CellData> cells; // Sorted by item.
+		LocalVector<MultimeshData> multimeshes;
+	};
+
 	uint32_t collision_layer = 1;
 	uint32_t collision_mask = 1;
 	bool bake_navigation = false;
@@ -151,14 +188,54 @@ class GridMap : public Node3D {
 	bool clip_above = true;
 	int clip_floor = 0;
 
-	bool recreating_octants = false;
-
 	Vector3::Axis clip_axis = Vector3::AXIS_Z;
 
 	Ref<MeshLibrary> mesh_library;
 
-	Map<OctantKey, Octant *> octant_map;
-	Map<IndexKey, Cell> cell_map;
+	HashMap<OctantKey, Octant *, OctantKeyHasher> octant_map;
+
+	// Map of cells, stored in cubic chunks so large maps don't need a tree node per cell.
+	enum {
+		CELL_CHUNK_SHIFT = 3,
+		CELL_CHUNK_SIZE = 1 << CELL_CHUNK_SHIFT,
+		CELL_CHUNK_MASK = CELL_CHUNK_SIZE - 1,
+		CELL_CHUNK_CELLS = CELL_CHUNK_SIZE * CELL_CHUNK_SIZE * CELL_CHUNK_SIZE,
+	};
+	struct CellChunk {
+		Cell cells[CELL_CHUNK_CELLS];
+		uint64_t used_mask[CELL_CHUNK_CELLS / 64] = {};
+		int used = 0;
+	};
+	struct ChunkKeyHasher {
+		_FORCE_INLINE_ static uint32_t hash(const Vector3i &p_key) {
+			uint32_t h = hash_djb2_one_32(p_key.x);
+			h = hash_djb2_one_32(p_key.y, h);
+			return hash_djb2_one_32(p_key.z, h);
+		}
+	};
+	HashMap<Vector3i, CellChunk *, ChunkKeyHasher> cell_chunks;
+	int cell_count = 0;
+
+	// Arithmetic shifts and masks round down for negative coords too.
+	_FORCE_INLINE_ static Vector3i _cell_to_chunk_key(const Vector3i &p_cell) {
+		return Vector3i(p_cell.x >> CELL_CHUNK_SHIFT, p_cell.y >> CELL_CHUNK_SHIFT, p_cell.z >> CELL_CHUNK_SHIFT);
+	}
+	_FORCE_INLINE_ static int _cell_to_chunk_index(const Vector3i &p_cell) {
+		return ((p_cell.z & CELL_CHUNK_MASK) << (CELL_CHUNK_SHIFT * 2)) | ((p_cell.y & CELL_CHUNK_MASK) << CELL_CHUNK_SHIFT) | (p_cell.x & CELL_CHUNK_MASK);
+	}
+	_FORCE_INLINE_ static Vector3i _chunk_index_to_cell(const Vector3i &p_chunk_key, int p_index) {
+		return Vector3i(
+				p_chunk_key.x * CELL_CHUNK_SIZE + (p_index & CELL_CHUNK_MASK),
+				p_chunk_key.y * CELL_CHUNK_SIZE + ((p_index >> CELL_CHUNK_SHIFT) & CELL_CHUNK_MASK),
+				p_chunk_key.z * CELL_CHUNK_SIZE + (p_index >> (CELL_CHUNK_SHIFT * 2)));
+	}
+	OctantKey _get_octant_key(const Vector3i &p_cell) const;
+	const Cell *_get_cell_ptr(const IndexKey &p_key) const;
+	void _get_chunk_cells_in_box(const Vector3i &p_chunk_key, const CellChunk *p_chunk, const Vector3i &p_begin, const Vector3i &p_end, LocalVector<Vector3i> &r_cells, LocalVector<Cell> &r_values) const;
+	void _get_cells_in_box(const Vector3i &p_begin, const Vector3i &p_end, LocalVector<Vector3i> &r_cells, LocalVector<Cell> &r_values) const;
+	bool _store_cell(const IndexKey &p_key, const Cell *p_cell, int &r_cell_count_change);
+	void _update_cell_octant(const IndexKey &p_key, int p_cell_count_change);
+	void _clear_cells();
 
 	void _recreate_octant_data();
 
@@ -176,7 +253,9 @@ class GridMap : public Node3D {
 	void _reset_physic_bodies_collision_filters();
 	void _octant_enter_world(const OctantKey &p_key);
 	void _octant_exit_world(const OctantKey &p_key);
-	bool _octant_update(const OctantKey &p_key);
+	void _octant_build(uint32_t p_index, OctantBuild *p_builds);
+	void _octant_update(OctantBuild &p_build);
+	Octant *_octant_create(const OctantKey &p_key);
 	void _octant_clean_up(const OctantKey &p_key);
 	void _octant_transform(const OctantKey &p_key);
 	bool awaiting_update = false;
@@ -186,6 +265,7 @@ class GridMap : public Node3D {
 
 	void resource_changed(const RES &p_res);
 
+	void _clear_octants();
 	void _clear_internal();
 
 	Vector3 _get_offset() const;
@@ -249,6 +329,10 @@ public:
 	int get_cell_item(const Vector3i &p_position) const;
 	int get_cell_item_orientation(const Vector3i &p_position) const;
 
+	// Bulk operations, set_cell_items() takes 5 integers per cell: x, y, z, item, orientation.
+	void fill_box(const Vector3i &p_position, const Vector3i &p_size, int p_item, int p_rot = 0);
+	void set_cell_items(const PackedInt32Array &p_cells);
+
 	Vector3i world_to_map(const Vector3 &p_world_position) const;
 	Vector3 map_to_world(const Vector3i &p_map_position) const;
 
@@ -260,6 +344,7 @@ public:
 	Array get_used_cells() const;
 
 	Array get_meshes();
+	Vector<RID> get_octant_multimeshes() const; // One per item in each octant.
 
 	void clear_baked_meshes();
 	void make_baked_meshes(bool p_gen_lightmap_uv = false, float p_lightmap_uv_texel_size = 0.1);
@@ -0,0 +1,290 @@
+/*************************************************************************/
+/*  test_grid_map.h                                                      */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_GRID_MAP_H
+#define TEST_GRID_MAP_H
+
+#include "core/object/message_queue.h"
+#include "core/os/memory.h"
+#include "core/os/os.h"
+#include "modules/gridmap/grid_map.h"
+#include "scene/resources/primitive_meshes.h"
+
+#include "tests/test_macros.h"
+#include "tests/test_scene_tree.h"
+
+namespace TestGridMap {
+
+static Ref<MeshLibrary> create_mesh_library() {
+	Ref<BoxMesh> mesh;
+	mesh.instantiate();
+	Ref<MeshLibrary> mesh_library;
+	mesh_library.instantiate();
+	mesh_library->create_item(0);
+	mesh_library->set_item_mesh(0, mesh);
+	mesh_library->create_item(1);
+	mesh_library->set_item_mesh(1, mesh);
+	return mesh_library;
+}
+
+TEST_CASE("[GridMap] Set and get cells") {
+	TestSceneTree::HeadlessSceneTree headless;
+	GridMap *grid_map = memnew(GridMap);
+	grid_map->set_mesh_library(create_mesh_library());
+	headless.tree->get_root()->add_child(grid_map);
+
+	// Cover both sides of the chunk and octant boundaries, including negative coords.
+	const Vector3i cells[] = { Vector3i(0, 0, 0), Vector3i(7, 7, 7), Vector3i(8, 0, -1), Vector3i(-1, -1, -1), Vector3i(-9, 100, -300) };
+	for (int i = 0; i < 5; i++) {
+		grid_map->set_cell_item(cells[i], i % 2, i);
+	}
+	MessageQueue::get_singleton()->flush();
+
+	for (int i = 0; i < 5; i++) {
+		CHECK(grid_map->get_cell_item(cells[i]) == i % 2);
+		CHECK(grid_map->get_cell_item_orientation(cells[i]) == i);
+	}
+	CHECK(grid_map->get_cell_item(Vector3i(1, 0, 0)) == GridMap::INVALID_CELL_ITEM);
+	CHECK(grid_map->get_cell_item_orientation(Vector3i(-2, -1, -1)) == -1);
+	CHECK(grid_map->get_used_cells().size() == 5);
+	CHECK(grid_map->get_meshes().size() == 10);
+
+	grid_map->set_cell_item(Vector3i(-9, 100, -300), GridMap::INVALID_CELL_ITEM);
+	grid_map->set_cell_item(Vector3i(7, 7, 7), GridMap::INVALID_CELL_ITEM);
+	MessageQueue::get_singleton()->flush();
+	CHECK(grid_map->get_cell_item(Vector3i(7, 7, 7)) == GridMap::INVALID_CELL_ITEM);
+	CHECK(grid_map->get_used_cells().size() == 3);
+
+	// The saved data doesn't depend on the storage, and loads back the same cells.
+	GridMap *copy = memnew(GridMap);
+	copy->set("data", grid_map->get("data"));
+	CHECK(copy->get_used_cells().size() == 3);
+	CHECK(copy->get_cell_item(Vector3i(-1, -1, -1)) == 1);
+	CHECK(copy->get_cell_item_orientation(Vector3i(-1, -1, -1)) == 3);
+	PackedInt32Array saved_cells = Dictionary(grid_map->get("data"))["cells"];
+	PackedInt32Array copied_cells = Dictionary(copy->get("data"))["cells"];
+	CHECK(saved_cells.size() == 9);
+	CHECK(copied_cells == saved_cells);
+	memdelete(copy);
+
+	grid_map->clear();
+	CHECK(grid_map->get_used_cells().size() == 0);
+	CHECK(grid_map->get_cell_item(Vector3i(0, 0, 0)) == GridMap::INVALID_CELL_ITEM);
+}
+
+TEST_CASE("[GridMap] Bulk cell operations") {
+	TestSceneTree::HeadlessSceneTree headless;
+	GridMap *grid_map = memnew(GridMap);
+	grid_map->set_mesh_library(create_mesh_library());
+	headless.tree->get_root()->add_child(grid_map);
+
+	grid_map->fill_box(Vector3i(-10, -2, -10), Vector3i(20, 4, 20), 0, 10);
+	CHECK(grid_map->get_used_cells().size() == 1600);
+	CHECK(grid_map->get_cell_item(Vector3i(-10, -2, -10)) == 0);
+	CHECK(grid_map->get_cell_item_orientation(Vector3i(9, 1, 9)) == 10);
+	CHECK(grid_map->get_cell_item(Vector3i(10, 1, 9)) == GridMap::INVALID_CELL_ITEM);
+
+	// Carve a hole.
+	grid_map->fill_box(Vector3i(-5, -2, -5), Vector3i(10, 4, 10), GridMap::INVALID_CELL_ITEM);
+	CHECK(grid_map->get_used_cells().size() == 1200);
+	CHECK(grid_map->get_cell_item(Vector3i(0, 0, 0)) == GridMap::INVALID_CELL_ITEM);
+
+	PackedInt32Array items;
+	const int values[] = { 0, 0, 0, 1, 4, /**/ 100, -100, 3, 0, 0, /**/ -10, -2, -10, -1, 0 };
+	for (int i = 0; i < 15; i++) {
+		items.push_back(values[i]);
+	}
+	grid_map->set_cell_items(items);
+	CHECK(grid_map->get_cell_item(Vector3i(0, 0, 0)) == 1);
+	CHECK(grid_map->get_cell_item_orientation(Vector3i(0, 0, 0)) == 4);
+	CHECK(grid_map->get_cell_item(Vector3i(100, -100, 3)) == 0);
+	CHECK(grid_map->get_cell_item(Vector3i(-10, -2, -10)) == GridMap::INVALID_CELL_ITEM);
+	CHECK(grid_map->get_used_cells().size() == 1201);
+	MessageQueue::get_singleton()->flush();
+
+	ERR_PRINT_OFF;
+	items.resize(14);
+	grid_map->set_cell_items(items);
+	grid_map->fill_box(Vector3i(0, 0, 0), Vector3i(-1, 1, 1), 0);
+	ERR_PRINT_ON;
+	CHECK(grid_map->get_used_cells().size() == 1201);
+}
+
+struct TransformOriginSort {
+	_FORCE_INLINE_ bool operator()(const Transform3D &p_a, const Transform3D &p_b) const {
+		return p_a.origin < p_b.origin;
+	}
+};
+
+// Reads the cells back from the multimesh buffers uploaded by the octants, sorted by position.
+// Fails if a multimesh has cells from more than one octant.
+static LocalVector<Transform3D> get_rendered_cells(GridMap *p_grid_map, int &r_multimesh_count) {
+	const Vector<RID> multimeshes = p_grid_map->get_octant_multimeshes();
+	const Vector3 octant_extents = p_grid_map->get_cell_size() * p_grid_map->get_octant_size();
+	r_multimesh_count = multimeshes.size();
+
+	LocalVector<Transform3D> cells;
+	for (int i = 0; i < multimeshes.size(); i++) {
+		const int count = RS::get_singleton()->multimesh_get_instance_count(multimeshes[i]);
+		const Vector<float> buffer = RS::get_singleton()->multimesh_get_buffer(multimeshes[i]);
+		CHECK(count > 0);
+		REQUIRE(buffer.size() == count * 12);
+
+		bool same_octant = true;
+		Vector3 first_octant;
+		for (int j = 0; j < count; j++) {
+			const float *r = buffer.ptr() + j * 12;
+			const Transform3D xform(Basis(r[0], r[1], r[2], r[4], r[5], r[6], r[8], r[9], r[10]), Vector3(r[3], r[7], r[11]));
+			const Vector3 octant = (xform.origin / octant_extents).floor();
+			if (j == 0) {
+				first_octant = octant;
+			}
+			same_octant = same_octant && octant == first_octant;
+			cells.push_back(xform);
+		}
+		CHECK_MESSAGE(same_octant, "Octants should only hold the cells inside of them, rounding keys down.");
+	}
+	cells.sort_custom<TransformOriginSort>();
+	return cells;
+}
+
+static LocalVector<Transform3D> build_octants(bool p_use_thread_work_pool, int &r_multimesh_count) {
+	TestSceneTree::HeadlessSceneTree headless;
+	headless.tree->set_thread_work_pool_enabled(p_use_thread_work_pool);
+	GridMap *grid_map = memnew(GridMap);
+	grid_map->set_mesh_library(create_mesh_library());
+	headless.tree->get_root()->add_child(grid_map);
+
+	// Both sides of the origin, where truncated octant keys used to merge two octants.
+	grid_map->fill_box(Vector3i(-20, -3, -20), Vector3i(40, 6, 40), 0);
+	grid_map->fill_box(Vector3i(-5, -3, -5), Vector3i(10, 6, 10), 1, 10);
+	MessageQueue::get_singleton()->flush();
+	return get_rendered_cells(grid_map, r_multimesh_count);
+}
+
+TEST_CASE("[GridMap] Octants give the same multimeshes on the worker threads and serially") {
+	int threaded_count = 0;
+	int serial_count = 0;
+	const LocalVector<Transform3D> threaded = build_octants(true, threaded_count);
+	const LocalVector<Transform3D> serial = build_octants(false, serial_count);
+
+	CHECK(threaded.size() == 9600);
+	CHECK(threaded_count == serial_count);
+	REQUIRE(threaded.size() == serial.size());
+	bool equal = true;
+	for (uint32_t i = 0; i < threaded.size(); i++) {
+		equal = equal && threaded[i] == serial[i];
+	}
+	CHECK(equal);
+}
+
+TEST_CASE("[GridMap] Rendered cells match the map") {
+	TestSceneTree::HeadlessSceneTree headless;
+	GridMap *grid_map = memnew(GridMap);
+	grid_map->set_mesh_library(create_mesh_library());
+	headless.tree->get_root()->add_child(grid_map);
+
+	grid_map->fill_box(Vector3i(-20, -3, -20), Vector3i(40, 6, 40), 0);
+	grid_map->fill_box(Vector3i(-5, -3, -5), Vector3i(10, 6, 10), 1, 10);
+	MessageQueue::get_singleton()->flush();
+
+	// Empty two whole octants, they are freed along with their multimeshes.
+	int multimesh_count = 0;
+	get_rendered_cells(grid_map, multimesh_count);
+	grid_map->fill_box(Vector3i(-16, -3, -16), Vector3i(8, 6, 8), GridMap::INVALID_CELL_ITEM);
+	MessageQueue::get_singleton()->flush();
+	int emptied_multimesh_count = 0;
+	const LocalVector<Transform3D> rendered = get_rendered_cells(grid_map, emptied_multimesh_count);
+	CHECK(emptied_multimesh_count == multimesh_count - 2);
+
+	LocalVector<Transform3D> expected;
+	const Array meshes = grid_map->get_meshes();
+	for (int i = 0; i < meshes.size(); i += 2) {
+		expected.push_back(meshes[i]);
+	}
+	expected.sort_custom<TransformOriginSort>();
+
+	CHECK(rendered.size() == 9600 - 384);
+	REQUIRE(rendered.size() == expected.size());
+	bool equal = true;
+	for (uint32_t i = 0; i < rendered.size(); i++) {
+		equal = equal && rendered[i] == expected[i];
+	}
+	CHECK(equal);
+}
+
+TEST_CASE_BENCHMARK("[GridMap][Benchmark] Fill a 256x256x256 map") {
+	TestSceneTree::HeadlessSceneTree headless;
+	GridMap *grid_map = memnew(GridMap);
+	headless.tree->get_root()->add_child(grid_map);
+
+	// Storage and octant bookkeeping, without meshes.
+	const int size = 256;
+	uint64_t mem_before = Memory::get_mem_usage();
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	grid_map->fill_box(Vector3i(0, 0, 0), Vector3i(size, size, size), 0);
+	MessageQueue::get_singleton()->flush();
+	uint64_t fill_usec = OS::get_singleton()->get_ticks_usec() - begin;
+	uint64_t mem_used = Memory::get_mem_usage() - mem_before;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	int64_t sum = 0;
+	for (int z = 0; z < size; z++) {
+		for (int y = 0; y < size; y++) {
+			for (int x = 0; x < size; x++) {
+				sum += grid_map->get_cell_item(Vector3i(x, y, z)) + 1;
+			}
+		}
+	}
+	uint64_t get_usec = OS::get_singleton()->get_ticks_usec() - begin;
+	CHECK(sum == int64_t(size) * size * size);
+
+	MESSAGE("fill_box: ", (fill_usec / 1000), " ms, get_cell_item: ", (get_usec / 1000), " ms");
+	MESSAGE("Cell storage: ", (mem_used / size / size / size), " bytes per cell");
+
+	// Meshing a 64x64x64 part, this builds the multimeshes of 512 octants.
+	grid_map->clear();
+	grid_map->set_mesh_library(create_mesh_library());
+	begin = OS::get_singleton()->get_ticks_usec();
+	grid_map->fill_box(Vector3i(0, 0, 0), Vector3i(64, 64, 64), 0);
+	MessageQueue::get_singleton()->flush();
+	uint64_t mesh_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	grid_map->fill_box(Vector3i(0, 0, 0), Vector3i(64, 64, 64), 1);
+	MessageQueue::get_singleton()->flush();
+	uint64_t remesh_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	MESSAGE("Meshing 64x64x64 cells: ", (mesh_usec / 1000), " ms, remeshing: ", (remesh_usec / 1000), " ms");
+}
+
+} // namespace TestGridMap
+
+#endif // TEST_GRID_MAP_H
@@ -0,0 +1,17 @@
+def can_build(env, platform):
+    # Rays are traced through the Embree raycaster, which is only registered in editor builds.
+    return env["tools"] and not env["disable_3d"]
+
+
+def configure(env):
+    pass
+
+
+def get_doc_classes():
+    return [
+        "LightmapperCPU",
+    ]
+
+
+def get_doc_path():
+    return "doc_classes"
@@ -0,0 +1,1073 @@
+/*************************************************************************/
+/*  lightmapper_cpu.cpp                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "lightmapper_cpu.h"
+
+#include "core/config/project_settings.h"
+#include "core/math/geometry_2d.h"
+#include "core/os/os.h"
+#include "core/templates/hash_map.h"
+
+void LightmapperCPU::add_mesh(const MeshData &p_mesh) {
+	ERR_FAIL_COND(p_mesh.albedo_on_uv2.is_null() || p_mesh.albedo_on_uv2->is_empty());
+	ERR_FAIL_COND(p_mesh.emission_on_uv2.is_null() || p_mesh.emission_on_uv2->is_empty());
+	ERR_FAIL_COND(p_mesh.albedo_on_uv2->get_width() != p_mesh.emission_on_uv2->get_width());
+	ERR_FAIL_COND(p_mesh.albedo_on_uv2->get_height() != p_mesh.emission_on_uv2->get_height());
+	ERR_FAIL_COND(p_mesh.points.size() == 0);
+	MeshInstance mi;
+	mi.data = p_mesh;
+	mesh_instances.push_back(mi);
+}
+
+void LightmapperCPU::add_directional_light(bool p_static, const Vector3 &p_direction, const Color &p_color, float p_energy, float p_angular_distance) {
+	Light l;
+	l.type = LIGHT_TYPE_DIRECTIONAL;
+	l.direction = p_direction;
+	l.color = p_color;
+	l.energy = p_energy;
+	l.static_bake = p_static;
+	lights.push_back(l);
+}
+
+void LightmapperCPU::add_omni_light(bool p_static, const Vector3 &p_position, const Color &p_color, float p_energy, float p_range, float p_attenuation, float p_size) {
+	Light l;
+	l.type = LIGHT_TYPE_OMNI;
+	l.position = p_position;
+	l.range = p_range;
+	l.attenuation = p_attenuation;
+	l.color = p_color;
+	l.energy = p_energy;
+	l.static_bake = p_static;
+	lights.push_back(l);
+}
+
+void LightmapperCPU::add_spot_light(bool p_static, const Vector3 &p_position, const Vector3 p_direction, const Color &p_color, float p_energy, float p_range, float p_attenuation, float p_spot_angle, float p_spot_attenuation, float p_size) {
+	Light l;
+	l.type = LIGHT_TYPE_SPOT;
+	l.position = p_position;
+	l.direction = p_direction;
+	l.range = p_range;
+	l.attenuation = p_attenuation;
+	l.cos_spot_angle = Math::cos(Math::deg2rad(p_spot_angle));
+	l.inv_spot_attenuation = 1.0f / p_spot_attenuation;
+	l.color = p_color;
+	l.energy = p_energy;
+	l.static_bake = p_static;
+	lights.push_back(l);
+}
+
+void LightmapperCPU::add_probe(const Vector3 &p_position) {
+	probe_positions.push_back(p_position);
+}
+
+// Same atlas packing as LightmapperRD, so both bakers lay out the lightmaps alike.
+Lightmapper::BakeError LightmapperCPU::_blit_meshes_into_atlas(int p_max_texture_size, BakeStepFunc p_step_function, void *p_bake_userdata) {
+	Vector<Size2i> sizes;
+	atlas_size = Size2i();
+
+	for (int m_i = 0; m_i < mesh_instances.size(); m_i++) {
+		MeshInstance &mi = mesh_instances.write[m_i];
+		Size2i s = Size2i(mi.data.albedo_on_uv2->get_width(), mi.data.albedo_on_uv2->get_height());
+		sizes.push_back(s);
+		atlas_size.width = MAX(atlas_size.width, s.width + 2);
+		atlas_size.height = MAX(atlas_size.height, s.height + 2);
+	}
+
+	int max = nearest_power_of_2_templated(atlas_size.width);
+	max = MAX(max, nearest_power_of_2_templated(atlas_size.height));
+
+	if (max > p_max_texture_size) {
+		return BAKE_ERROR_LIGHTMAP_TOO_SMALL;
+	}
+
+	if (p_step_function) {
+		p_step_function(0.1, TTR("Determining optimal atlas size"), p_bake_userdata, true);
+	}
+
+	atlas_size = Size2i(max, max);
+
+	Size2i best_atlas_size;
+	int best_atlas_slices = 0;
+	int best_atlas_memory = 0x7FFFFFFF;
+	Vector<Vector3i> best_atlas_offsets;
+
+	//determine best texture array atlas size by bruteforce fitting
+	while (atlas_size.x <= p_max_texture_size && atlas_size.y <= p_max_texture_size) {
+		Vector<Vector2i> source_sizes;
+		Vector<int> source_indices;
+		source_sizes.resize(sizes.size());
+		source_indices.resize(sizes.size());
+		for (int i = 0; i < source_indices.size(); i++) {
+			source_sizes.write[i] = sizes[i] + Vector2i(2, 2); // Add padding between lightmaps
+			source_indices.write[i] = i;
+		}
+		Vector<Vector3i> atlas_offsets;
+		atlas_offsets.resize(source_sizes.size());
+
+		int slices = 0;
+
+		while (source_sizes.size() > 0) {
+			Vector<Vector3i> offsets = Geometry2D::partial_pack_rects(source_sizes, atlas_size);
+			Vector<int> new_indices;
+			Vector<Vector2i> new_sources;
+			for (int i = 0; i < offsets.size(); i++) {
+				Vector3i ofs = offsets[i];
+				int sidx = source_indices[i];
+				if (ofs.z > 0) {
+					//valid
+					ofs.z = slices;
+					atlas_offsets.write[sidx] = ofs + Vector3i(1, 1, 0); // Center lightmap in the reserved oversized region
+				} else {
+					new_indices.push_back(sidx);
+					new_sources.push_back(source_sizes[i]);
+				}
+			}
+
+			source_sizes = new_sources;
+			source_indices = new_indices;
+			slices++;
+		}
+
+		int mem_used = atlas_size.x * atlas_size.y * slices;
+		if (mem_used < best_atlas_memory) {
+			best_atlas_size = atlas_size;
+			best_atlas_offsets = atlas_offsets;
+			best_atlas_slices = slices;
+			best_atlas_memory = mem_used;
+		}
+
+		if (atlas_size.width == atlas_size.height) {
+			atlas_size.width *= 2;
+		} else {
+			atlas_size.height *= 2;
+		}
+	}
+	atlas_size = best_atlas_size;
+	atlas_slices = best_atlas_slices;
+
+	if (p_step_function) {
+		p_step_function(0.2, TTR("Blitting albedo and emission"), p_bake_userdata, true);
+	}
+
+	uint32_t texel_count = atlas_size.width * atlas_size.height * atlas_slices;
+	albedo.resize(texel_count);
+	emission.resize(texel_count);
+	for (uint32_t i = 0; i < texel_count; i++) {
+		albedo[i] = Color(0, 0, 0, 0);
+		emission[i] = Color(0, 0, 0, 0);
+	}
+
+	for (int m_i = 0; m_i < mesh_instances.size(); m_i++) {
+		MeshInstance &mi = mesh_instances.write[m_i];
+		mi.offset.x = best_atlas_offsets[m_i].x;
+		mi.offset.y = best_atlas_offsets[m_i].y;
+		mi.slice = best_atlas_offsets[m_i].z;
+
+		Ref<Image> albedo_image = mi.data.albedo_on_uv2;
+		Ref<Image> emission_image = mi.data.emission_on_uv2;
+		for (int y = 0; y < sizes[m_i].height; y++) {
+			uint32_t ofs = (mi.slice * atlas_size.height + mi.offset.y + y) * atlas_size.width + mi.offset.x;
+			for (int x = 0; x < sizes[m_i].width; x++) {
+				albedo[ofs + x] = albedo_image->get_pixel(x, y);
+				emission[ofs + x] = emission_image->get_pixel(x, y);
+			}
+		}
+	}
+
+	return BAKE_OK;
+}
+
+// Moves the position towards the projections on the vertex normal planes, like lm_raster.glsl,
+// so curved surfaces don't shadow themselves along their flat triangles.
+static Vector3 _smooth_position(const Vector3 &p_position, const Vector3 p_points[3], const Vector3 p_normals[3], const Vector3 &p_barycentric, const Vector3 &p_face_normal) {
+	Vector3 center = (p_points[0] + p_points[1] + p_points[2]) * (1.0 / 3.0);
+	Vector3 smooth_position;
+	for (int i = 0; i < 3; i++) {
+		Vector3 normal = p_normals[i];
+		Vector3 dir = (p_points[i] - center).normalized();
+		float d = dir.dot(normal);
+		if (d < 0) {
+			//pointing inwards
+			normal = (normal - dir * d).normalized();
+		}
+		Vector3 proj = p_position - normal * (normal.dot(p_position) - normal.dot(p_points[i]));
+		smooth_position += proj * p_barycentric[i];
+	}
+
+	if (p_face_normal.dot(smooth_position) > p_face_normal.dot(p_position)) { //only project outwards
+		return smooth_position;
+	}
+	return p_position;
+}
+
+void LightmapperCPU::_raster_mesh(uint32_t p_index, void *p_userdata) {
+	const MeshInstance &mi = mesh_instances[p_index];
+	Vector2 mesh_size = Vector2(mi.data.albedo_on_uv2->get_width(), mi.data.albedo_on_uv2->get_height());
+	Vector2 mesh_offset = mi.offset;
+	uint32_t layer_ofs = mi.slice * atlas_size.width * atlas_size.height;
+
+	const Vector3 *points = mi.data.points.ptr();
+	const Vector3 *normals = mi.data.normal.ptr();
+	const Vector2 *uv2 = mi.data.uv2.ptr();
+	int triangle_count = mi.data.points.size() / 3;
+
+	// Meshes don't overlap in the atlas, so each one can be rastered on its own thread.
+	// Texels with their center inside a triangle are filled first, then the ones touching
+	// the triangle edges, so lookups near the borders don't sample empty texels.
+	for (int pass = 0; pass < 2; pass++) {
+		for (int i = 0; i < triangle_count; i++) {
+			Vector2 uvs[3];
+			Vector3 vtxs[3];
+			Vector3 vtx_normals[3];
+			for (int k = 0; k < 3; k++) {
+				uvs[k] = uv2[i * 3 + k] * mesh_size + mesh_offset;
+				vtxs[k] = points[i * 3 + k];
+				vtx_normals[k] = normals[i * 3 + k];
+			}
+
+			Vector2 e1 = uvs[1] - uvs[0];
+			Vector2 e2 = uvs[2] - uvs[0];
+			real_t det = e1.cross(e2);
+			if (Math::abs(det) < CMP_EPSILON2) {
+				continue; // Degenerate in UV space.
+			}
+
+			Vector3 face_normal = -(vtxs[0] - vtxs[1]).cross(vtxs[0] - vtxs[2]).normalized();
+
+			// World space size of a texel, worst case.
+			Vector3 world_e1 = vtxs[1] - vtxs[0];
+			Vector3 world_e2 = vtxs[2] - vtxs[0];
+			Vector3 d_x = ((world_e1 * e2.y - world_e2 * e1.y) / det).abs();
+			Vector3 d_y = ((world_e2 * e1.x - world_e1 * e2.x) / det).abs();
+			Vector3 delta = Vector3(MAX(d_x.x, d_y.x), MAX(d_x.y, d_y.y), MAX(d_x.z, d_y.z));
+			float texel_size = MAX(delta.x, MAX(delta.y, delta.z)) * Math_SQRT2;
+
+			Rect2 uv_rect(uvs[0], Vector2());
+			uv_rect.expand_to(uvs[1]);
+			uv_rect.expand_to(uvs[2]);
+			int from_x = CLAMP(int(Math::floor(uv_rect.position.x)) - 1, 0, atlas_size.width - 1);
+			int from_y = CLAMP(int(Math::floor(uv_rect.position.y)) - 1, 0, atlas_size.height - 1);
+			int to_x = CLAMP(int(Math::ceil(uv_rect.position.x + uv_rect.size.x)) + 1, 0, atlas_size.width - 1);
+			int to_y = CLAMP(int(Math::ceil(uv_rect.position.y + uv_rect.size.y)) + 1, 0, atlas_size.height - 1);
+
+			for (int y = from_y; y <= to_y; y++) {
+				for (int x = from_x; x <= to_x; x++) {
+					Texel &texel = texels[layer_ofs + y * atlas_size.width + x];
+					if (pass == 1 && texel.valid) {
+						continue;
+					}
+
+					Vector2 pos = Vector2(x + 0.5, y + 0.5);
+					Vector3 barycentric;
+					barycentric.y = (pos - uvs[0]).cross(e2) / det;
+					barycentric.z = e1.cross(pos - uvs[0]) / det;
+					barycentric.x = 1.0 - barycentric.y - barycentric.z;
+
+					bool inside = barycentric.x >= 0 && barycentric.y >= 0 && barycentric.z >= 0;
+					if (pass == 0 && !inside) {
+						continue;
+					}
+					if (pass == 1) {
+						// Use the closest point of the triangle for texels partially covered by it.
+						Vector2 closest;
+						real_t closest_dist = 1e20;
+						for (int k = 0; k < 3; k++) {
+							Vector2 segment[2] = { uvs[k], uvs[(k + 1) % 3] };
+							Vector2 p = Geometry2D::get_closest_point_to_segment(pos, segment);
+							real_t dist = p.distance_to(pos);
+							if (dist < closest_dist) {
+								closest_dist = dist;
+								closest = p;
+							}
+						}
+						if (closest_dist > Math_SQRT12) {
+							continue;
+						}
+						barycentric.y = CLAMP((closest - uvs[0]).cross(e2) / det, 0, 1);
+						barycentric.z = CLAMP(e1.cross(closest - uvs[0]) / det, 0, 1 - barycentric.y);
+						barycentric.x = 1.0 - barycentric.y - barycentric.z;
+					}
+
+					Vector3 position = vtxs[0] * barycentric.x + vtxs[1] * barycentric.y + vtxs[2] * barycentric.z;
+					Vector3 normal = vtx_normals[0] * barycentric.x + vtx_normals[1] * barycentric.y + vtx_normals[2] * barycentric.z;
+
+					texel.position = _smooth_position(position, vtxs, vtx_normals, barycentric, face_normal);
+					texel.normal = normal.normalized();
+					texel.face_normal = face_normal;
+					texel.size = texel_size;
+					texel.valid = true;
+				}
+			}
+		}
+	}
+}
+
+bool LightmapperCPU::_trace_ray(const Vector3 &p_from, const Vector3 &p_dir, float p_max_distance, LightmapRaycaster::Ray &r_ray) {
+	r_ray = LightmapRaycaster::Ray(p_from, p_dir, 0.0, p_max_distance);
+	return raycaster->intersect(r_ray);
+}
+
+Color LightmapperCPU::_sample_layer(const LocalVector<Color> &p_light, int p_layer, const Vector2 &p_pos) const {
+	// Bilinear, clamped to the edges, like the linear sampler used by LightmapperRD.
+	float x = p_pos.x - 0.5;
+	float y = p_pos.y - 0.5;
+	int x0 = int(Math::floor(x));
+	int y0 = int(Math::floor(y));
+	float fx = x - x0;
+	float fy = y - y0;
+	int x1 = CLAMP(x0 + 1, 0, atlas_size.width - 1);
+	int y1 = CLAMP(y0 + 1, 0, atlas_size.height - 1);
+	x0 = CLAMP(x0, 0, atlas_size.width - 1);
+	y0 = CLAMP(y0, 0, atlas_size.height - 1);
+
+	const Color *layer = &p_light[p_layer * atlas_size.width * atlas_size.height];
+	Color top = layer[y0 * atlas_size.width + x0].lerp(layer[y0 * atlas_size.width + x1], fx);
+	Color bottom = layer[y1 * atlas_size.width + x0].lerp(layer[y1 * atlas_size.width + x1], fx);
+	return top.lerp(bottom, fy);
+}
+
+Color LightmapperCPU::_sample_light(const LocalVector<Color> &p_light, const LightmapRaycaster::Ray &p_ray) const {
+	if (p_ray.geomID >= uint32_t(mesh_instances.size())) {
+		return Color(0, 0, 0, 0);
+	}
+	// The raycaster returns the lightmap UV of the hit in u and v.
+	const MeshInstance &mi = mesh_instances[p_ray.geomID];
+	Vector2 mesh_size = Vector2(mi.data.albedo_on_uv2->get_width(), mi.data.albedo_on_uv2->get_height());
+	return _sample_layer(p_light, mi.slice, Vector2(p_ray.u, p_ray.v) * mesh_size + Vector2(mi.offset));
+}
+
+Color LightmapperCPU::_sample_environment(const Vector3 &p_dir) const {
+	Vector3 sky_dir = environment_transform.xform(p_dir).normalized();
+	Vector2 st = Vector2(Math::atan2(sky_dir.x, sky_dir.z), Math::acos(CLAMP(sky_dir.y, -1.0, 1.0)));
+	if (st.x < 0.0) {
+		st.x += Math_TAU;
+	}
+	st /= Vector2(Math_TAU, Math_PI);
+
+	float x = st.x * environment_size.width - 0.5;
+	float y = st.y * environment_size.height - 0.5;
+	int x0 = int(Math::floor(x));
+	int y0 = int(Math::floor(y));
+	float fx = x - x0;
+	float fy = y - y0;
+	int x1 = Math::posmod(x0 + 1, environment_size.width);
+	x0 = Math::posmod(x0, environment_size.width);
+	int y1 = CLAMP(y0 + 1, 0, environment_size.height - 1);
+	y0 = CLAMP(y0, 0, environment_size.height - 1);
+
+	Color top = environment[y0 * environment_size.width + x0].lerp(environment[y0 * environment_size.width + x1], fx);
+	Color bottom = environment[y1 * environment_size.width + x0].lerp(environment[y1 * environment_size.width + x1], fx);
+	return top.lerp(bottom, fy);
+}
+
+static const float golden_angle = Math_PI * (3.0 - Math::sqrt(5.0));
+
+static Vector3 _vogel_hemisphere(uint32_t p_index, uint32_t p_count, float p_offset) {
+	float r = Math::sqrt(float(p_index) + 0.5f) / Math::sqrt(float(p_count));
+	float theta = float(p_index) * golden_angle + p_offset;
+	float y = Math::cos(r * Math_PI * 0.5);
+	float l = Math::sin(r * Math_PI * 0.5);
+	return Vector3(l * Math::cos(theta), l * Math::sin(theta), y);
+}
+
+static float _quick_hash(const Vector2 &p_pos) {
+	float h = Math::sin((p_pos * 19.19).dot(Vector2(49.5791, 97.413))) * 49831.189237;
+	return h - Math::floor(h);
+}
+
+static float _get_omni_attenuation(float p_distance, float p_inv_range, float p_decay) {
+	float nd = p_distance * p_inv_range;
+	nd *= nd;
+	nd *= nd; // nd^4
+	nd = MAX(1.0 - nd, 0.0);
+	nd *= nd; // nd^2
+	return nd * Math::pow(MAX(p_distance, 0.0001f), -p_decay);
+}
+
+void LightmapperCPU::_unocclude_row(uint32_t p_row, void *p_userdata) {
+	// Push texels out of the geometry they are buried in, see
+	// https://ndotl.wordpress.com/2018/08/29/baking-artifact-free-lightmaps/
+	uint32_t ofs = p_row * atlas_size.width;
+	for (int x = 0; x < atlas_size.width; x++) {
+		Texel &texel = texels[ofs + x];
+		if (!texel.valid) {
+			continue;
+		}
+
+		Vector3 face_normal = texel.face_normal;
+		Vector3 v0 = Math::abs(face_normal.z) < 0.999 ? Vector3(0, 0, 1) : Vector3(0, 1, 0);
+		Vector3 tangent = v0.cross(face_normal).normalized();
+		Vector3 bitangent = tangent.cross(face_normal).normalized();
+		Vector3 base_pos = texel.position + face_normal * bias; //raise a bit
+
+		const Vector3 rays[4] = { tangent, bitangent, -tangent, -bitangent };
+		float min_d = 1e20;
+		for (int i = 0; i < 4; i++) {
+			LightmapRaycaster::Ray ray;
+			if (!_trace_ray(base_pos, rays[i], texel.size, ray)) {
+				continue;
+			}
+			Vector3 hit_normal = ray.normal.normalized();
+			if (hit_normal.dot(rays[i]) < 0.0) {
+				continue; // Front face, the texel is not inside.
+			}
+			if (ray.tfar < min_d) {
+				// This bias needs to be greater than the regular bias, otherwise rays will go through when pointing back.
+				texel.position = base_pos + rays[i] * ray.tfar + hit_normal * bias * 10.0;
+				min_d = ray.tfar;
+			}
+		}
+	}
+}
+
+void LightmapperCPU::_direct_light_row(uint32_t p_row, void *p_userdata) {
+	uint32_t ofs = p_row * atlas_size.width;
+	uint32_t layer_size = atlas_size.width * atlas_size.height;
+	uint32_t slice = p_row / atlas_size.height;
+
+	for (int x = 0; x < atlas_size.width; x++) {
+		uint32_t idx = ofs + x;
+		const Texel &texel = texels[idx];
+		if (!texel.valid) {
+			continue;
+		}
+
+		Vector3 position = texel.position;
+		Vector3 normal = texel.normal;
+		Vector3 static_light;
+		Vector3 dynamic_light;
+		Vector3 sh_accum[4];
+
+		for (int i = 0; i < lights.size(); i++) {
+			const Light &light = lights[i];
+			Vector3 light_pos;
+			float attenuation;
+			if (light.type == LIGHT_TYPE_DIRECTIONAL) {
+				light_pos = position - light.direction * world_size;
+				attenuation = 1.0;
+			} else {
+				light_pos = light.position;
+				float d = position.distance_to(light_pos);
+				if (d > light.range) {
+					continue;
+				}
+
+				attenuation = _get_omni_attenuation(d, 1.0 / light.range, light.attenuation);
+
+				if (light.type == LIGHT_TYPE_SPOT) {
+					Vector3 rel = (position - light_pos).normalized();
+					float cos_angle = rel.dot(light.direction);
+					if (cos_angle < light.cos_spot_angle) {
+						continue; //invisible, dont try
+					}
+
+					float scos = MAX(cos_angle, light.cos_spot_angle);
+					float spot_rim = MAX(0.0001, (1.0 - scos) / (1.0 - light.cos_spot_angle));
+					attenuation *= 1.0 - Math::pow(spot_rim, light.inv_spot_attenuation);
+				}
+			}
+
+			Vector3 light_dir = (light_pos - position).normalized();
+			attenuation *= MAX(0.0, normal.dot(light_dir));
+			if (attenuation <= 0.0001) {
+				continue; //no need to do anything
+			}
+
+			Vector3 from = position + light_dir * bias;
+			LightmapRaycaster::Ray ray;
+			if (_trace_ray(from, light_dir, from.distance_to(light_pos), ray)) {
+				continue; // In shadow.
+			}
+
+			Vector3 light_color = Vector3(light.color.r, light.color.g, light.color.b) * light.energy * attenuation;
+			if (light.static_bake) {
+				static_light += light_color;
+				if (bake_sh) {
+					const float c[4] = {
+						0.282095, //l0
+						0.488603f * light_dir.y, //l1n1
+						0.488603f * light_dir.z, //l1n0
+						0.488603f * light_dir.x //l1p1
+					};
+					for (int j = 0; j < 4; j++) {
+						sh_accum[j] += light_color * c[j] * (1.0 / 3.0);
+					}
+				}
+			} else {
+				dynamic_light += light_color;
+			}
+		}
+
+		Vector3 texel_albedo = Vector3(albedo[idx].r, albedo[idx].g, albedo[idx].b);
+		Vector3 texel_emission = Vector3(emission[idx].r, emission[idx].g, emission[idx].b);
+
+		dynamic_light *= texel_albedo; //if it will bounce, must multiply by albedo
+		dynamic_light += texel_emission;
+
+		//keep for lightprobes
+		light_primary_dynamic[idx] = Color(dynamic_light.x, dynamic_light.y, dynamic_light.z, 1.0);
+
+		dynamic_light += static_light * texel_albedo; //send for bounces
+		light_bounce[0][idx] = Color(dynamic_light.x, dynamic_light.y, dynamic_light.z, 1.0);
+
+		if (bake_sh) {
+			//keep for adding at the end
+			for (int j = 0; j < 4; j++) {
+				light_accum[(slice * 4 + j) * layer_size + idx - slice * layer_size] = Color(sh_accum[j].x, sh_accum[j].y, sh_accum[j].z, 1.0);
+			}
+		} else {
+			light_accum[idx] = Color(static_light.x, static_light.y, static_light.z, 1.0);
+		}
+	}
+}
+
+void LightmapperCPU::_bounce_light_row(uint32_t p_row, void *p_userdata) {
+	uint32_t ofs = p_row * atlas_size.width;
+	uint32_t layer_size = atlas_size.width * atlas_size.height;
+	uint32_t slice = p_row / atlas_size.height;
+	int y = p_row % atlas_size.height;
+
+	const LocalVector<Color> &source = light_bounce[bounce_source];
+	LocalVector<Color> &dest = light_bounce[1 - bounce_source];
+
+	for (int x = 0; x < atlas_size.width; x++) {
+		uint32_t idx = ofs + x;
+		const Texel &texel = texels[idx];
+		if (!texel.valid) {
+			continue;
+		}
+
+		Vector3 position = texel.position;
+		Vector3 normal = texel.normal;
+		Vector3 v0 = Math::abs(normal.z) < 0.999 ? Vector3(0, 0, 1) : Vector3(0, 1, 0);
+		Vector3 tangent = v0.cross(normal).normalized();
+		Vector3 bitangent = tangent.cross(normal).normalized();
+		float offset = _quick_hash(Vector2(x, y));
+
+		Vector3 sh_accum[4];
+		Vector3 light_total;
+		for (uint32_t i = 0; i < ray_count; i++) {
+			Vector3 v = _vogel_hemisphere(i, ray_count, offset);
+			Vector3 ray_dir = tangent * v.x + bitangent * v.y + normal * v.z;
+
+			Color light;
+			LightmapRaycaster::Ray ray;
+			if (_trace_ray(position + ray_dir * bias, ray_dir, world_size, ray)) {
+				light = _sample_light(source, ray);
+			} else if (first_bounce) {
+				// Did not hit a triangle, reach out for the sky.
+				light = _sample_environment(ray_dir);
+			} else {
+				continue;
+			}
+
+			Vector3 light_rgb = Vector3(light.r, light.g, light.b);
+			light_total += light_rgb;
+
+			if (bake_sh) {
+				const float c[4] = {
+					0.282095, //l0
+					0.488603f * ray_dir.y, //l1n1
+					0.488603f * ray_dir.z, //l1n0
+					0.488603f * ray_dir.x //l1p1
+				};
+				for (int j = 0; j < 4; j++) {
+					sh_accum[j] += light_rgb * c[j] * (8.0 / float(ray_count));
+				}
+			}
+		}
+
+		light_total /= float(ray_count);
+		dest[idx] = Color(light_total.x, light_total.y, light_total.z, 1.0);
+
+		if (bake_sh) {
+			for (int j = 0; j < 4; j++) {
+				Color &accum = light_accum[(slice * 4 + j) * layer_size + idx - slice * layer_size];
+				accum.r += sh_accum[j].x;
+				accum.g += sh_accum[j].y;
+				accum.b += sh_accum[j].z;
+			}
+		} else {
+			Color &accum = light_accum[idx];
+			accum.r += light_total.x;
+			accum.g += light_total.y;
+			accum.b += light_total.z;
+		}
+	}
+}
+
+void LightmapperCPU::_light_probe(uint32_t p_index, void *p_userdata) {
+	Vector3 position = probe_positions[p_index];
+	float offset = _quick_hash(Vector2(p_index, 0));
+
+	Vector3 probe_sh_accum[9];
+	for (uint32_t i = 0; i < ray_count; i++) {
+		Vector3 ray_dir = _vogel_hemisphere(i, ray_count, offset);
+		if (i & 1) {
+			//throw to both sides, so alternate them
+			ray_dir.z *= -1.0;
+		}
+
+		Color light;
+		LightmapRaycaster::Ray ray;
+		if (_trace_ray(position + ray_dir * bias, ray_dir, world_size, ray)) {
+			light = _sample_light(light_primary_dynamic, ray);
+			if (probe_bounce_light) {
+				light += _sample_light(light_bounce[1 - bounce_source], ray);
+			}
+		} else {
+			light = _sample_environment(ray_dir);
+		}
+
+		const float c[9] = {
+			0.282095, //l0
+			0.488603f * ray_dir.y, //l1n1
+			0.488603f * ray_dir.z, //l1n0
+			0.488603f * ray_dir.x, //l1p1
+			1.092548f * ray_dir.x * ray_dir.y, //l2n2
+			1.092548f * ray_dir.y * ray_dir.z, //l2n1
+			0.315392f * (3.0f * ray_dir.z * ray_dir.z - 1.0f), //l20
+			1.092548f * ray_dir.x * ray_dir.z, //l2p1
+			0.546274f * (ray_dir.x * ray_dir.x - ray_dir.y * ray_dir.y) //l2p2
+		};
+
+		Vector3 light_rgb = Vector3(light.r, light.g, light.b);
+		for (int j = 0; j < 9; j++) {
+			probe_sh_accum[j] += light_rgb * c[j];
+		}
+	}
+
+	Color *values = probe_values.ptrw() + p_index * 9;
+	for (int j = 0; j < 9; j++) {
+		Vector3 sh = probe_sh_accum[j] * (4.0 / float(ray_count));
+		values[j] = Color(sh.x, sh.y, sh.z, 0.0);
+	}
+}
+
+void LightmapperCPU::_dilate_row(uint32_t p_row, void *p_userdata) {
+	// Sides first as they are closer, then the corners, then two texels away.
+	static const Vector2i offsets[24] = {
+		Vector2i(-1, 0), Vector2i(0, 1), Vector2i(1, 0), Vector2i(0, -1),
+		Vector2i(-1, -1), Vector2i(-1, 1), Vector2i(1, -1), Vector2i(1, 1),
+		Vector2i(-2, 0), Vector2i(0, 2), Vector2i(2, 0), Vector2i(0, -2),
+		Vector2i(-2, -1), Vector2i(-2, 1), Vector2i(2, -1), Vector2i(2, 1),
+		Vector2i(-1, -2), Vector2i(-1, 2), Vector2i(1, -2), Vector2i(1, 2),
+		Vector2i(-2, -2), Vector2i(-2, 2), Vector2i(2, -2), Vector2i(2, 2)
+	};
+
+	uint32_t layer_ofs = (p_row / atlas_size.height) * atlas_size.width * atlas_size.height;
+	int y = p_row % atlas_size.height;
+
+	for (int x = 0; x < atlas_size.width; x++) {
+		Color c = light_accum[layer_ofs + y * atlas_size.width + x];
+		for (int i = 0; i < 24 && c.a <= 0.5; i++) {
+			Vector2i pos = Vector2i(x, y) + offsets[i];
+			if (pos.x < 0 || pos.y < 0 || pos.x >= atlas_size.width || pos.y >= atlas_size.height) {
+				continue;
+			}
+			c = light_accum[layer_ofs + pos.y * atlas_size.width + pos.x];
+		}
+		light_dilated[layer_ofs + y * atlas_size.width + x] = c;
+	}
+}
+
+void LightmapperCPU::_blend_seams() {
+	// Both sides of a seam get the average of the two, sampled along the edge.
+	light_accum = light_dilated;
+
+	uint32_t layer_size = atlas_size.width * atlas_size.height;
+	int subslices = bake_sh ? 4 : 1;
+	for (uint32_t i = 0; i < seams.size(); i++) {
+		const Seam &seam = seams[i];
+		real_t length = MAX(seam.a[0].distance_to(seam.a[1]), seam.b[0].distance_to(seam.b[1]));
+		int steps = int(length * 2.0) + 1;
+
+		for (int k = 0; k < subslices; k++) {
+			int layer = seam.slice * subslices + k;
+			for (int s = 0; s <= steps; s++) {
+				float t = float(s) / steps;
+				Vector2 pos_a = seam.a[0].lerp(seam.a[1], t);
+				Vector2 pos_b = seam.b[0].lerp(seam.b[1], t);
+				Color color_a = _sample_layer(light_dilated, layer, pos_a);
+				Color color_b = _sample_layer(light_dilated, layer, pos_b);
+
+				Vector2i texel_a = Vector2i(CLAMP(int(pos_a.x), 0, atlas_size.width - 1), CLAMP(int(pos_a.y), 0, atlas_size.height - 1));
+				Vector2i texel_b = Vector2i(CLAMP(int(pos_b.x), 0, atlas_size.width - 1), CLAMP(int(pos_b.y), 0, atlas_size.height - 1));
+				uint32_t idx_a = layer * layer_size + texel_a.y * atlas_size.width + texel_a.x;
+				uint32_t idx_b = layer * layer_size + texel_b.y * atlas_size.width + texel_b.x;
+
+				float alpha_a = light_accum[idx_a].a;
+				float alpha_b = light_accum[idx_b].a;
+				light_accum[idx_a] = light_dilated[idx_a].lerp(color_b, 0.5);
+				light_accum[idx_a].a = alpha_a;
+				light_accum[idx_b] = light_dilated[idx_b].lerp(color_a, 0.5);
+				light_accum[idx_b].a = alpha_b;
+			}
+		}
+	}
+}
+
+template <class M>
+void LightmapperCPU::_dispatch(ThreadWorkPool &p_pool, uint32_t p_count, M p_method, float p_progress_from, float p_progress_to, const String &p_text, BakeStepFunc p_step_function, void *p_bake_userdata) {
+	if (p_count == 0) {
+		return;
+	}
+	p_pool.begin_work(p_count, this, p_method, (void *)nullptr);
+	while (!p_pool.is_done_dispatching()) {
+		OS::get_singleton()->delay_usec(10000);
+		if (p_step_function) {
+			int percent = p_pool.get_work_index() * 100 / p_count;
+			p_step_function(p_progress_from + (p_progress_to - p_progress_from) * percent / 100.0, vformat("%s %d%%", p_text, percent), p_bake_userdata, false);
+		}
+	}
+	p_pool.end_work();
+}
+
+static void _clear_light(LocalVector<Color> &r_light, uint32_t p_size) {
+	r_light.resize(p_size);
+	for (uint32_t i = 0; i < p_size; i++) {
+		r_light[i] = Color(0, 0, 0, 0);
+	}
+}
+
+static Ref<Image> _light_layer_to_image(const LocalVector<Color> &p_light, int p_layer, const Size2i &p_size) {
+	Vector<uint8_t> data;
+	data.resize(p_size.width * p_size.height * sizeof(Color));
+	memcpy(data.ptrw(), &p_light[p_layer * p_size.width * p_size.height], data.size());
+	Ref<Image> img;
+	img.instantiate();
+	img->create(p_size.width, p_size.height, false, Image::FORMAT_RGBAF, data);
+	return img;
+}
+
+LightmapperCPU::BakeError LightmapperCPU::bake(BakeQuality p_quality, bool p_use_denoiser, int p_bounces, float p_bias, int p_max_texture_size, bool p_bake_sh, GenerateProbes p_generate_probes, const Ref<Image> &p_environment_panorama, const Basis &p_environment_transform, BakeStepFunc p_step_function, void *p_bake_userdata) {
+	if (p_step_function) {
+		p_step_function(0.0, TTR("Begin Bake"), p_bake_userdata, true);
+	}
+	bake_textures.clear();
+	probe_values.clear();
+
+	raycaster = LightmapRaycaster::create();
+	ERR_FAIL_COND_V_MSG(raycaster.is_null(), BAKE_ERROR_LIGHTMAP_CANT_PRE_BAKE_MESHES, "The CPU lightmapper needs a LightmapRaycaster, which is provided by the raycast module.");
+
+	/* STEP 1: Fetch material textures and pack the atlas */
+
+	BakeError bake_error = _blit_meshes_into_atlas(p_max_texture_size, p_step_function, p_bake_userdata);
+	if (bake_error != BAKE_OK) {
+		raycaster.unref();
+		return bake_error;
+	}
+
+	bake_sh = p_bake_sh;
+	bias = p_bias;
+	environment_transform = p_environment_transform;
+
+	/* STEP 2: Build the acceleration structure and find the seams */
+
+	if (p_step_function) {
+		p_step_function(0.3, TTR("Creating acceleration structure"), p_bake_userdata, true);
+	}
+
+	AABB bounds;
+	seams.clear();
+	for (int m_i = 0; m_i < mesh_instances.size(); m_i++) {
+		const MeshInstance &mi = mesh_instances[m_i];
+		raycaster->add_mesh(mi.data.points, mi.data.normal, mi.data.uv2, m_i);
+
+		Vector2 mesh_size = Vector2(mi.data.albedo_on_uv2->get_width(), mi.data.albedo_on_uv2->get_height());
+		if (m_i == 0) {
+			bounds.position = mi.data.points[0];
+		}
+
+		HashMap<Edge, EdgeUV2, EdgeHash> edges;
+		for (int i = 0; i < mi.data.points.size(); i += 3) {
+			for (int k = 0; k < 3; k++) {
+				bounds.expand_to(mi.data.points[i + k]);
+			}
+
+			//compute seams that will need to be blended later
+			for (int k = 0; k < 3; k++) {
+				int n = (k + 1) % 3;
+
+				Edge edge;
+				edge.a = mi.data.points[i + k];
+				edge.b = mi.data.points[i + n];
+				edge.na = mi.data.normal[i + k];
+				edge.nb = mi.data.normal[i + n];
+				EdgeUV2 uv2;
+				uv2.a = mi.data.uv2[i + k] * mesh_size + Vector2(mi.offset);
+				uv2.b = mi.data.uv2[i + n] * mesh_size + Vector2(mi.offset);
+
+				if (edge.b == edge.a) {
+					continue; //degenerate, somehow
+				}
+				if (edge.b < edge.a) {
+					SWAP(edge.a, edge.b);
+					SWAP(edge.na, edge.nb);
+					SWAP(uv2.a, uv2.b);
+				}
+
+				EdgeUV2 *euv2 = edges.getptr(edge);
+				if (!euv2) {
+					edges[edge] = uv2;
+				} else {
+					if (euv2->a == uv2.a && euv2->b == uv2.b) {
+						continue; // seam shared UV space, no need to blend
+					}
+					if (euv2->seam_found) {
+						continue; //bad geometry
+					}
+
+					Seam seam;
+					seam.a[0] = uv2.a;
+					seam.a[1] = uv2.b;
+					seam.b[0] = euv2->a;
+					seam.b[1] = euv2->b;
+					seam.slice = mi.slice;
+					seams.push_back(seam);
+					euv2->seam_found = true;
+				}
+			}
+		}
+	}
+
+	//also consider probe positions for bounds
+	for (int i = 0; i < probe_positions.size(); i++) {
+		bounds.expand_to(probe_positions[i]);
+	}
+	bounds.grow_by(0.1); //grow a bit to avoid numerical error
+	world_size = bounds.size.length();
+
+	raycaster->commit();
+
+	uint32_t layer_size = atlas_size.width * atlas_size.height;
+	uint32_t texel_count = layer_size * atlas_slices;
+	uint32_t accum_layers = atlas_slices * (bake_sh ? 4 : 1);
+	uint32_t rows = atlas_size.height * atlas_slices;
+
+	texels.clear();
+	texels.resize(texel_count);
+	_clear_light(light_bounce[0], texel_count);
+	_clear_light(light_bounce[1], texel_count);
+	_clear_light(light_primary_dynamic, texel_count);
+	_clear_light(light_accum, layer_size * accum_layers);
+	bounce_source = 0;
+
+	ThreadWorkPool work_pool;
+	work_pool.init();
+
+	/* STEP 3: Raster the geometry into texels */
+
+	_dispatch(work_pool, mesh_instances.size(), &LightmapperCPU::_raster_mesh, 0.4, 0.49, TTR("Rasterizing geometry"), p_step_function, p_bake_userdata);
+	_dispatch(work_pool, rows, &LightmapperCPU::_unocclude_row, 0.49, 0.5, TTR("Un-occluding geometry"), p_step_function, p_bake_userdata);
+
+	/* STEP 4: Direct light */
+
+	_dispatch(work_pool, rows, &LightmapperCPU::_direct_light_row, 0.5, 0.6, TTR("Plot direct lighting"), p_step_function, p_bake_userdata);
+
+	/* STEP 5: Indirect light */
+
+	{
+		Ref<Image> panorama;
+		if (p_environment_panorama.is_valid()) {
+			panorama = p_environment_panorama->duplicate();
+			panorama->convert(Image::FORMAT_RGBAF);
+		}
+		if (panorama.is_valid() && !panorama->is_empty()) {
+			environment_size = panorama->get_size();
+			environment.resize(environment_size.width * environment_size.height);
+			memcpy(environment.ptr(), panorama->get_data().ptr(), environment.size() * sizeof(Color));
+		} else {
+			environment_size = Size2i(1, 1);
+			environment.resize(1);
+			environment[0] = Color(0, 0, 0, 1);
+		}
+	}
+
+	switch (p_quality) {
+		case BAKE_QUALITY_LOW: {
+			ray_count = GLOBAL_GET("rendering/lightmapping/bake_quality/low_quality_ray_count");
+		} break;
+		case BAKE_QUALITY_MEDIUM: {
+			ray_count = GLOBAL_GET("rendering/lightmapping/bake_quality/medium_quality_ray_count");
+		} break;
+		case BAKE_QUALITY_HIGH: {
+			ray_count = GLOBAL_GET("rendering/lightmapping/bake_quality/high_quality_ray_count");
+		} break;
+		case BAKE_QUALITY_ULTRA: {
+			ray_count = GLOBAL_GET("rendering/lightmapping/bake_quality/ultra_quality_ray_count");
+		} break;
+	}
+	ray_count = CLAMP(ray_count, 16u, 8192u);
+
+	for (int b = 0; b < p_bounces; b++) {
+		if (b > 0) {
+			bounce_source = 1 - bounce_source;
+		}
+		first_bounce = b == 0;
+		float progress = 0.6 + 0.1 * b / p_bounces;
+		_dispatch(work_pool, rows, &LightmapperCPU::_bounce_light_row, progress, progress + 0.1 / p_bounces, vformat(TTR("Bounce %d/%d: Integrate indirect lighting"), b + 1, p_bounces), p_step_function, p_bake_userdata);
+	}
+
+	/* STEP 6: Light probes */
+
+	if (probe_positions.size()) {
+		switch (p_quality) {
+			case BAKE_QUALITY_LOW: {
+				ray_count = GLOBAL_GET("rendering/lightmapping/bake_quality/low_quality_probe_ray_count");
+			} break;
+			case BAKE_QUALITY_MEDIUM: {
+				ray_count = GLOBAL_GET("rendering/lightmapping/bake_quality/medium_quality_probe_ray_count");
+			} break;
+			case BAKE_QUALITY_HIGH: {
+				ray_count = GLOBAL_GET("rendering/lightmapping/bake_quality/high_quality_probe_ray_count");
+			} break;
+			case BAKE_QUALITY_ULTRA: {
+				ray_count = GLOBAL_GET("rendering/lightmapping/bake_quality/ultra_quality_probe_ray_count");
+			} break;
+		}
+		ray_count = CLAMP(ray_count, 16u, 8192u);
+
+		probe_bounce_light = p_bounces > 0;
+		probe_values.resize(probe_positions.size() * 9);
+		_dispatch(work_pool, probe_positions.size(), &LightmapperCPU::_light_probe, 0.7, 0.8, TTR("Integrating light probes"), p_step_function, p_bake_userdata);
+	}
+
+	/* STEP 7: Denoise */
+
+	if (p_use_denoiser) {
+		if (p_step_function) {
+			p_step_function(0.8, TTR("Denoising"), p_bake_userdata, true);
+		}
+
+		Ref<LightmapDenoiser> denoiser = LightmapDenoiser::create();
+		if (denoiser.is_valid()) {
+			for (uint32_t i = 0; i < accum_layers; i++) {
+				Ref<Image> img = _light_layer_to_image(light_accum, i, atlas_size);
+				Ref<Image> denoised = denoiser->denoise_image(img);
+				if (denoised != img) {
+					denoised->convert(Image::FORMAT_RGBAF);
+					Vector<uint8_t> data = denoised->get_data();
+					const Color *src = (const Color *)data.ptr();
+					Color *dst = &light_accum[i * layer_size];
+					for (uint32_t j = 0; j < layer_size; j++) {
+						// Keep the alpha, it tells dilation which texels are used.
+						dst[j] = Color(src[j].r, src[j].g, src[j].b, dst[j].a);
+					}
+				}
+			}
+		}
+	}
+
+	/* STEP 8: Dilate and blend the seams */
+
+	light_dilated.resize(light_accum.size());
+	_dispatch(work_pool, atlas_size.height * accum_layers, &LightmapperCPU::_dilate_row, 0.85, 0.88, TTR("Dilating lightmaps"), p_step_function, p_bake_userdata);
+	_blend_seams();
+
+	work_pool.finish();
+
+	if (p_step_function) {
+		p_step_function(0.9, TTR("Retrieving textures"), p_bake_userdata, true);
+	}
+
+	for (uint32_t i = 0; i < accum_layers; i++) {
+		Ref<Image> img = _light_layer_to_image(light_accum, i, atlas_size);
+		img->convert(Image::FORMAT_RGBH); //remove alpha
+		bake_textures.push_back(img);
+	}
+
+	raycaster.unref();
+	texels.clear();
+	albedo.clear();
+	emission.clear();
+	light_bounce[0].clear();
+	light_bounce[1].clear();
+	light_primary_dynamic.clear();
+	light_accum.clear();
+	light_dilated.clear();
+	environment.clear();
+	seams.clear();
+
+	return BAKE_OK;
+}
+
+int LightmapperCPU::get_bake_texture_count() const {
+	return bake_textures.size();
+}
+
+Ref<Image> LightmapperCPU::get_bake_texture(int p_index) const {
+	ERR_FAIL_INDEX_V(p_index, bake_textures.size(), Ref<Image>());
+	return bake_textures[p_index];
+}
+
+int LightmapperCPU::get_bake_mesh_count() const {
+	return mesh_instances.size();
+}
+
+Variant LightmapperCPU::get_bake_mesh_userdata(int p_index) const {
+	ERR_FAIL_INDEX_V(p_index, mesh_instances.size(), Variant());
+	return mesh_instances[p_index].data.userdata;
+}
+
+Rect2 LightmapperCPU::get_bake_mesh_uv_scale(int p_index) const {
+	ERR_FAIL_COND_V(bake_textures.size() == 0, Rect2());
+	ERR_FAIL_INDEX_V(p_index, mesh_instances.size(), Rect2());
+	Rect2 uv_ofs;
+	Vector2 atlas_size_f = Vector2(bake_textures[0]->get_width(), bake_textures[0]->get_height());
+	uv_ofs.position = Vector2(mesh_instances[p_index].offset) / atlas_size_f;
+	uv_ofs.size = Vector2(mesh_instances[p_index].data.albedo_on_uv2->get_width(), mesh_instances[p_index].data.albedo_on_uv2->get_height()) / atlas_size_f;
+	return uv_ofs;
+}
+
+int LightmapperCPU::get_bake_mesh_texture_slice(int p_index) const {
+	ERR_FAIL_INDEX_V(p_index, mesh_instances.size(), 0);
+	return mesh_instances[p_index].slice;
+}
+
+int LightmapperCPU::get_bake_probe_count() const {
+	return probe_positions.size();
+}
+
+Vector3 LightmapperCPU::get_bake_probe_point(int p_probe) const {
+	ERR_FAIL_INDEX_V(p_probe, probe_positions.size(), Vector3());
+	return probe_positions[p_probe];
+}
+
+Vector<Color> LightmapperCPU::get_bake_probe_sh(int p_probe) const {
+	ERR_FAIL_INDEX_V(p_probe * 9, probe_values.size(), Vector<Color>());
+	Vector<Color> ret;
+	ret.resize(9);
+	memcpy(ret.ptrw(), &probe_values[p_probe * 9], sizeof(Color) * 9);
+	return ret;
+}
+
+LightmapperCPU::LightmapperCPU() {
+}
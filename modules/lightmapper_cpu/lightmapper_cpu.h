@@ -0,0 +1,179 @@
+/*************************************************************************/
+/*  lightmapper_cpu.h                                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef LIGHTMAPPER_CPU_H
+#define LIGHTMAPPER_CPU_H
+
+#include "core/templates/local_vector.h"
+#include "core/templates/thread_work_pool.h"
+#include "scene/3d/lightmapper.h"
+#include "scene/resources/mesh.h"
+
+// Bakes lightmaps without a RenderingDevice, for machines without a GPU.
+// It follows the same passes as LightmapperRD, tracing rays through the
+// LightmapRaycaster (Embree) and spreading texel rows over all cores.
+class LightmapperCPU : public Lightmapper {
+	GDCLASS(LightmapperCPU, Lightmapper)
+
+	struct MeshInstance {
+		MeshData data;
+		int slice = 0;
+		Vector2i offset;
+	};
+
+	struct Light {
+		Vector3 position;
+		uint32_t type = LIGHT_TYPE_DIRECTIONAL;
+		Vector3 direction;
+		float energy = 0.0;
+		Color color;
+		float range = 0.0;
+		float attenuation = 0.0;
+		float cos_spot_angle = 0.0;
+		float inv_spot_attenuation = 0.0;
+		bool static_bake = false;
+	};
+
+	// Surface rasterized into a lightmap texel.
+	struct Texel {
+		Vector3 position;
+		Vector3 normal;
+		Vector3 face_normal;
+		float size = 0.0;
+		bool valid = false;
+	};
+
+	struct Edge {
+		Vector3 a;
+		Vector3 b;
+		Vector3 na;
+		Vector3 nb;
+		bool operator==(const Edge &p_edge) const {
+			return a == p_edge.a && b == p_edge.b && na == p_edge.na && nb == p_edge.nb;
+		}
+	};
+
+	struct EdgeHash {
+		_FORCE_INLINE_ static uint32_t hash(const Edge &p_edge) {
+			uint32_t h = hash_djb2_one_float(p_edge.a.x);
+			h = hash_djb2_one_float(p_edge.a.y, h);
+			h = hash_djb2_one_float(p_edge.a.z, h);
+			h = hash_djb2_one_float(p_edge.b.x, h);
+			h = hash_djb2_one_float(p_edge.b.y, h);
+			h = hash_djb2_one_float(p_edge.b.z, h);
+			return h;
+		}
+	};
+
+	struct EdgeUV2 {
+		Vector2 a;
+		Vector2 b;
+		bool seam_found = false;
+	};
+
+	// Edge shared by two triangles with different lightmap coordinates, in atlas texels.
+	struct Seam {
+		Vector2 a[2];
+		Vector2 b[2];
+		int slice = 0;
+	};
+
+	Vector<MeshInstance> mesh_instances;
+	Vector<Light> lights;
+	Vector<Vector3> probe_positions;
+
+	Vector<Ref<Image>> bake_textures;
+	Vector<Color> probe_values;
+
+	// State of the bake in progress, read by the worker threads.
+	Ref<LightmapRaycaster> raycaster;
+	Size2i atlas_size;
+	int atlas_slices = 0;
+	bool bake_sh = false;
+	float bias = 0.0;
+	float world_size = 0.0;
+	uint32_t ray_count = 0;
+	bool first_bounce = false;
+	bool probe_bounce_light = false;
+	Basis environment_transform;
+
+	LocalVector<Texel> texels;
+	LocalVector<Color> albedo;
+	LocalVector<Color> emission;
+	// Light leaving each texel, read from light_bounce[bounce_source] and written to the other one.
+	LocalVector<Color> light_bounce[2];
+	uint32_t bounce_source = 0;
+	LocalVector<Color> light_primary_dynamic;
+	LocalVector<Color> light_accum;
+	LocalVector<Color> light_dilated;
+	LocalVector<Seam> seams;
+
+	LocalVector<Color> environment;
+	Size2i environment_size;
+
+	BakeError _blit_meshes_into_atlas(int p_max_texture_size, BakeStepFunc p_step_function, void *p_bake_userdata);
+	void _raster_mesh(uint32_t p_index, void *p_userdata);
+	void _unocclude_row(uint32_t p_row, void *p_userdata);
+	void _direct_light_row(uint32_t p_row, void *p_userdata);
+	void _bounce_light_row(uint32_t p_row, void *p_userdata);
+	void _light_probe(uint32_t p_index, void *p_userdata);
+	void _dilate_row(uint32_t p_row, void *p_userdata);
+	void _blend_seams();
+
+	bool _trace_ray(const Vector3 &p_from, const Vector3 &p_dir, float p_max_distance, LightmapRaycaster::Ray &r_ray);
+	Color _sample_light(const LocalVector<Color> &p_light, const LightmapRaycaster::Ray &p_ray) const;
+	Color _sample_layer(const LocalVector<Color> &p_light, int p_layer, const Vector2 &p_pos) const;
+	Color _sample_environment(const Vector3 &p_dir) const;
+
+	template <class M>
+	void _dispatch(ThreadWorkPool &p_pool, uint32_t p_count, M p_method, float p_progress_from, float p_progress_to, const String &p_text, BakeStepFunc p_step_function, void *p_bake_userdata);
+
+public:
+	virtual void add_mesh(const MeshData &p_mesh) override;
+	virtual void add_directional_light(bool p_static, const Vector3 &p_direction, const Color &p_color, float p_energy, float p_angular_distance) override;
+	virtual void add_omni_light(bool p_static, const Vector3 &p_position, const Color &p_color, float p_energy, float p_range, float p_attenuation, float p_size) override;
+	virtual void add_spot_light(bool p_static, const Vector3 &p_position, const Vector3 p_direction, const Color &p_color, float p_energy, float p_range, float p_attenuation, float p_spot_angle, float p_spot_attenuation, float p_size) override;
+	virtual void add_probe(const Vector3 &p_position) override;
+	virtual BakeError bake(BakeQuality p_quality, bool p_use_denoiser, int p_bounces, float p_bias, int p_max_texture_size, bool p_bake_sh, GenerateProbes p_generate_probes, const Ref<Image> &p_environment_panorama, const Basis &p_environment_transform, BakeStepFunc p_step_function = nullptr, void *p_bake_userdata = nullptr) override;
+
+	int get_bake_texture_count() const override;
+	Ref<Image> get_bake_texture(int p_index) const override;
+	int get_bake_mesh_count() const override;
+	Variant get_bake_mesh_userdata(int p_index) const override;
+	Rect2 get_bake_mesh_uv_scale(int p_index) const override;
+	int get_bake_mesh_texture_slice(int p_index) const override;
+	int get_bake_probe_count() const override;
+	Vector3 get_bake_probe_point(int p_probe) const override;
+	Vector<Color> get_bake_probe_sh(int p_probe) const override;
+
+	LightmapperCPU();
+};
+
+#endif // LIGHTMAPPER_CPU_H
@@ -0,0 +1,241 @@
+/*************************************************************************/
+/*  test_lightmapper_cpu.h                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_LIGHTMAPPER_CPU_H
+#define TEST_LIGHTMAPPER_CPU_H
+
+#include "modules/lightmapper_cpu/lightmapper_cpu.h"
+#include "scene/3d/lightmap_gi.h"
+#include "scene/resources/material.h"
+
+#include "tests/test_macros.h"
+#include "tests/test_scene_tree.h"
+
+namespace TestLightmapperCPU {
+
+// Horizontal quad facing up (or down), with its lightmap UVs following X and Z.
+static Lightmapper::MeshData create_quad(const Vector3 &p_from, const Vector3 &p_to, int p_texture_size, bool p_facing_down = false) {
+	const Vector3 corners[4] = { Vector3(p_from.x, p_from.y, p_from.z), Vector3(p_to.x, p_from.y, p_from.z), Vector3(p_to.x, p_from.y, p_to.z), Vector3(p_from.x, p_from.y, p_to.z) };
+	const Vector2 uvs[4] = { Vector2(0, 0), Vector2(1, 0), Vector2(1, 1), Vector2(0, 1) };
+	const int indices_up[6] = { 0, 1, 2, 0, 2, 3 };
+	const int indices_down[6] = { 0, 2, 1, 0, 3, 2 };
+	const int *indices = p_facing_down ? indices_down : indices_up;
+
+	Lightmapper::MeshData mesh;
+	for (int i = 0; i < 6; i++) {
+		mesh.points.push_back(corners[indices[i]]);
+		mesh.uv2.push_back(uvs[indices[i]]);
+		mesh.normal.push_back(Vector3(0, p_facing_down ? -1 : 1, 0));
+	}
+
+	mesh.albedo_on_uv2.instantiate();
+	mesh.albedo_on_uv2->create(p_texture_size, p_texture_size, false, Image::FORMAT_RGBA8);
+	mesh.albedo_on_uv2->fill(Color(1, 1, 1));
+	mesh.emission_on_uv2.instantiate();
+	mesh.emission_on_uv2->create(p_texture_size, p_texture_size, false, Image::FORMAT_RGBAH);
+	mesh.emission_on_uv2->fill(Color(0, 0, 0));
+	return mesh;
+}
+
+static Color get_lightmap_pixel(const Ref<LightmapperCPU> &p_lightmapper, int p_mesh, const Vector2 &p_uv) {
+	Ref<Image> texture = p_lightmapper->get_bake_texture(p_lightmapper->get_bake_mesh_texture_slice(p_mesh));
+	Rect2 uv_scale = p_lightmapper->get_bake_mesh_uv_scale(p_mesh);
+	Vector2 pos = (uv_scale.position + p_uv * uv_scale.size) * Vector2(texture->get_width(), texture->get_height());
+	return texture->get_pixel(pos.x, pos.y);
+}
+
+TEST_CASE("[LightmapperCPU] Direct light and shadows") {
+	if (LightmapRaycaster::create().is_null()) {
+		MESSAGE("No LightmapRaycaster available, skipping.");
+		return;
+	}
+
+	Ref<LightmapperCPU> lightmapper;
+	lightmapper.instantiate();
+	// Floor, with an occluder covering its -X half.
+	lightmapper->add_mesh(create_quad(Vector3(-1, 0, -1), Vector3(1, 0, 1), 32));
+	lightmapper->add_mesh(create_quad(Vector3(-1.5, 0.5, -1.5), Vector3(0, 0.5, 1.5), 16));
+	lightmapper->add_directional_light(true, Vector3(0, -1, 0), Color(1, 1, 1), 1.0, 0.0);
+	// Dynamic lights are not baked into the lightmap, only into the probes.
+	lightmapper->add_directional_light(false, Vector3(0, -1, 0), Color(1, 1, 1), 1.0, 0.0);
+	lightmapper->add_probe(Vector3(0.5, 0.25, 0));
+
+	Lightmapper::BakeError err = lightmapper->bake(Lightmapper::BAKE_QUALITY_LOW, false, 0, 0.005, 1024, false, Lightmapper::GENERATE_PROBES_DISABLED, Ref<Image>(), Basis());
+	REQUIRE(err == Lightmapper::BAKE_OK);
+	REQUIRE(lightmapper->get_bake_texture_count() == 1);
+	CHECK(lightmapper->get_bake_texture(0)->get_format() == Image::FORMAT_RGBH);
+
+	Color lit = get_lightmap_pixel(lightmapper, 0, Vector2(0.75, 0.5));
+	Color shadowed = get_lightmap_pixel(lightmapper, 0, Vector2(0.25, 0.5));
+	CHECK(lit.r > 0.9);
+	CHECK(shadowed.r < lit.r * 0.5);
+
+	// The top of the occluder is lit as well.
+	CHECK(get_lightmap_pixel(lightmapper, 1, Vector2(0.5, 0.5)).r > 0.9);
+
+	// The probe sees the floor lit by the dynamic light.
+	Vector<Color> sh = lightmapper->get_bake_probe_sh(0);
+	REQUIRE(sh.size() == 9);
+	CHECK(sh[0].r > 0.0);
+}
+
+// Floor lit from above, with a shelf facing down over its -X half that only bounced light reaches.
+static Ref<LightmapperCPU> bake_shelf(int p_bounces, bool p_use_denoiser) {
+	Ref<LightmapperCPU> lightmapper;
+	lightmapper.instantiate();
+	lightmapper->add_mesh(create_quad(Vector3(-1, 0, -1), Vector3(1, 0, 1), 32));
+	lightmapper->add_mesh(create_quad(Vector3(-1, 0.5, -1), Vector3(0, 0.5, 1), 16, true));
+	lightmapper->add_directional_light(true, Vector3(0, -1, 0), Color(1, 1, 1), 1.0, 0.0);
+
+	Lightmapper::BakeError err = lightmapper->bake(Lightmapper::BAKE_QUALITY_LOW, p_use_denoiser, p_bounces, 0.005, 1024, false, Lightmapper::GENERATE_PROBES_DISABLED, Ref<Image>(), Basis());
+	CHECK(err == Lightmapper::BAKE_OK);
+	return lightmapper;
+}
+
+// Sum of the differences between neighbor texels across the shelf, higher when noisier.
+static float get_shelf_noise(const Ref<LightmapperCPU> &p_lightmapper, float &r_average) {
+	float noise = 0;
+	r_average = 0;
+	Color previous = get_lightmap_pixel(p_lightmapper, 1, Vector2(1.0 / 32.0, 0.5));
+	for (int i = 1; i < 16; i++) {
+		Color pixel = get_lightmap_pixel(p_lightmapper, 1, Vector2((i * 2 + 1) / 32.0, 0.5));
+		noise += Math::abs(pixel.r - previous.r);
+		r_average += pixel.r / 15.0;
+		previous = pixel;
+	}
+	return noise;
+}
+
+TEST_CASE("[LightmapperCPU] Indirect light") {
+	if (LightmapRaycaster::create().is_null()) {
+		MESSAGE("No LightmapRaycaster available, skipping.");
+		return;
+	}
+
+	Ref<LightmapperCPU> direct = bake_shelf(0, false);
+	CHECK(get_lightmap_pixel(direct, 1, Vector2(0.5, 0.5)).r < 0.01);
+
+	// The lit floor bounces light up to the shelf.
+	Ref<LightmapperCPU> bounced = bake_shelf(2, false);
+	float shelf = get_lightmap_pixel(bounced, 1, Vector2(0.5, 0.5)).r;
+	CHECK(shelf > 0.02);
+	CHECK(shelf < 1.0);
+
+	// The floor under the shelf gets the light bounced back down.
+	CHECK(get_lightmap_pixel(bounced, 0, Vector2(0.25, 0.5)).r > get_lightmap_pixel(direct, 0, Vector2(0.25, 0.5)).r);
+}
+
+TEST_CASE("[LightmapperCPU] Denoising") {
+	if (LightmapRaycaster::create().is_null() || LightmapDenoiser::create().is_null()) {
+		MESSAGE("No LightmapRaycaster or LightmapDenoiser available, skipping.");
+		return;
+	}
+
+	// The low quality ray count leaves visible noise in the bounced light.
+	float noisy_average;
+	float noisy = get_shelf_noise(bake_shelf(1, false), noisy_average);
+	float denoised_average;
+	float denoised = get_shelf_noise(bake_shelf(1, true), denoised_average);
+
+	CHECK(denoised < noisy);
+	CHECK(denoised_average == doctest::Approx(noisy_average).epsilon(0.25));
+}
+
+TEST_CASE("[LightmapperCPU] Reading materials into UV2 without a RenderingDevice") {
+	TestSceneTree::HeadlessSceneTree headless;
+
+	// A quad covering the whole lightmap, with its UVs matching the lightmap UVs.
+	Array arrays;
+	arrays.resize(Mesh::ARRAY_MAX);
+	const Vector2 corners[6] = { Vector2(0, 0), Vector2(1, 0), Vector2(1, 1), Vector2(0, 0), Vector2(1, 1), Vector2(0, 1) };
+	Vector<Vector3> vertices;
+	Vector<Vector3> normals;
+	Vector<Vector2> uvs;
+	for (int i = 0; i < 6; i++) {
+		vertices.push_back(Vector3(corners[i].x, 0, corners[i].y));
+		normals.push_back(Vector3(0, 1, 0));
+		uvs.push_back(corners[i]);
+	}
+	arrays[Mesh::ARRAY_VERTEX] = vertices;
+	arrays[Mesh::ARRAY_NORMAL] = normals;
+	arrays[Mesh::ARRAY_TEX_UV] = uvs;
+	arrays[Mesh::ARRAY_TEX_UV2] = uvs;
+	Ref<ArrayMesh> mesh;
+	mesh.instantiate();
+	mesh->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, arrays);
+
+	Ref<StandardMaterial3D> material;
+	material.instantiate();
+	material->set_albedo(Color(1, 0, 0));
+	material->set_metallic(0.5);
+	material->set_feature(BaseMaterial3D::FEATURE_EMISSION, true);
+	material->set_emission(Color(0, 0, 1));
+	material->set_emission_energy(2.0);
+	mesh->surface_set_material(0, material);
+
+	TypedArray<Image> images = LightmapGI::bake_render_uv2_cpu(mesh, Vector<Ref<Material>>(), Size2i(8, 8));
+	REQUIRE(images.size() == RS::BAKE_CHANNEL_EMISSION + 1);
+	Ref<Image> albedo = images[RS::BAKE_CHANNEL_ALBEDO_ALPHA];
+	Ref<Image> orm = images[RS::BAKE_CHANNEL_ORM];
+	Ref<Image> emission = images[RS::BAKE_CHANNEL_EMISSION];
+	CHECK(albedo->get_size() == Size2i(8, 8));
+	CHECK(albedo->get_pixel(1, 6).is_equal_approx(Color(1, 0, 0)));
+	CHECK(albedo->get_pixel(6, 1).is_equal_approx(Color(1, 0, 0)));
+	CHECK(orm->get_pixel(4, 4).b == doctest::Approx(0.5).epsilon(0.01));
+	CHECK(emission->get_pixel(4, 4).is_equal_approx(Color(0, 0, 2)));
+
+	// Overrides replace the mesh materials, and textures are read through the UVs.
+	Ref<Image> checker;
+	checker.instantiate();
+	checker->create(2, 1, false, Image::FORMAT_RGBA8);
+	checker->set_pixel(0, 0, Color(0, 0, 0));
+	checker->set_pixel(1, 0, Color(1, 1, 1));
+	Ref<ImageTexture> texture;
+	texture.instantiate();
+	texture->create_from_image(checker);
+
+	Ref<StandardMaterial3D> textured;
+	textured.instantiate();
+	textured->set_texture(BaseMaterial3D::TEXTURE_ALBEDO, texture);
+	Vector<Ref<Material>> overrides;
+	overrides.push_back(textured);
+
+	images = LightmapGI::bake_render_uv2_cpu(mesh, overrides, Size2i(8, 8));
+	REQUIRE(images.size() == RS::BAKE_CHANNEL_EMISSION + 1);
+	albedo = images[RS::BAKE_CHANNEL_ALBEDO_ALPHA];
+	emission = images[RS::BAKE_CHANNEL_EMISSION];
+	CHECK(albedo->get_pixel(1, 4).is_equal_approx(Color(0, 0, 0)));
+	CHECK(albedo->get_pixel(6, 4).is_equal_approx(Color(1, 1, 1)));
+	CHECK(emission->get_pixel(4, 4).is_equal_approx(Color(0, 0, 0)));
+}
+
+} // namespace TestLightmapperCPU
+
+#endif // TEST_LIGHTMAPPER_CPU_H
@@ -33,9 +33,13 @@
 #include "core/config/project_settings.h"
 #include "lightmapper_rd.h"
 #include "scene/3d/lightmapper.h"
+#include "servers/rendering/rendering_device.h"
 
 #ifndef _3D_DISABLED
 static Lightmapper *create_lightmapper_rd() {
+	if (!RenderingDevice::get_singleton()) {
+		return nullptr; // Let Lightmapper::create() fall back to the CPU lightmapper.
+	}
 	return memnew(LightmapperRD);
 }
 #endif
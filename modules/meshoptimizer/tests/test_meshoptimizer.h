@@ -0,0 +1,162 @@
+/*************************************************************************/
+/*  test_meshoptimizer.h                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_MESHOPTIMIZER_H
+#define TEST_MESHOPTIMIZER_H
+
+#ifdef TOOLS_ENABLED
+
+#include "editor/import/scene_importer_mesh.h"
+#include "scene/resources/surface_tool.h"
+
+#include "tests/test_macros.h"
+
+namespace TestMeshOptimizer {
+
+// Describes every triangle by the data of its corners, so surfaces can be compared whatever
+// the order of their vertices and triangles. Each triangle starts with its smallest corner,
+// which keeps the winding.
+static Vector<String> get_triangles(const Array &p_arrays, const Array &p_blend_shape_arrays, const Vector<int> &p_indices) {
+	const Vector<Vector3> vertices = p_arrays[Mesh::ARRAY_VERTEX];
+	const Vector<Vector2> uvs = p_arrays[Mesh::ARRAY_TEX_UV];
+	const Vector<Vector3> blend_shape_vertices = p_blend_shape_arrays[Mesh::ARRAY_VERTEX];
+
+	Vector<String> triangles;
+	for (int i = 0; i + 2 < p_indices.size(); i += 3) {
+		String corners[3];
+		for (int j = 0; j < 3; j++) {
+			const int index = p_indices[i + j];
+			REQUIRE(index >= 0);
+			REQUIRE(index < vertices.size());
+			corners[j] = String(vertices[index]) + " " + String(uvs[index]) + " " + String(blend_shape_vertices[index]);
+		}
+		int first = 0;
+		for (int j = 1; j < 3; j++) {
+			if (corners[j] < corners[first]) {
+				first = j;
+			}
+		}
+		triangles.push_back(corners[first] + " | " + corners[(first + 1) % 3] + " | " + corners[(first + 2) % 3]);
+	}
+	triangles.sort();
+	return triangles;
+}
+
+TEST_CASE("[MeshOptimizer] Optimizing the vertex order keeps the triangles") {
+	REQUIRE(SurfaceTool::optimize_vertex_cache_func);
+	REQUIRE(SurfaceTool::optimize_overdraw_func);
+	REQUIRE(SurfaceTool::optimize_vertex_fetch_remap_func);
+
+	// A 9x9 vertices grid, with the vertices stored in a scrambled order.
+	const int grid_size = 9;
+	const int vertex_count = grid_size * grid_size;
+	Vector<int> grid_to_vertex;
+	grid_to_vertex.resize(vertex_count);
+	Vector<Vector3> vertices;
+	Vector<Vector2> uvs;
+	Vector<Vector3> blend_shape_vertices;
+	vertices.resize(vertex_count);
+	uvs.resize(vertex_count);
+	blend_shape_vertices.resize(vertex_count);
+	for (int i = 0; i < vertex_count; i++) {
+		const int vertex = (i * 37) % vertex_count;
+		const int x = i % grid_size;
+		const int y = i / grid_size;
+		grid_to_vertex.write[i] = vertex;
+		vertices.write[vertex] = Vector3(x, y, 0);
+		uvs.write[vertex] = Vector2(x, y) / (grid_size - 1);
+		blend_shape_vertices.write[vertex] = Vector3(x, y, (x * y) % 3);
+	}
+
+	Vector<int> indices;
+	for (int y = 0; y < grid_size - 1; y++) {
+		for (int x = 0; x < grid_size - 1; x++) {
+			const int corner = y * grid_size + x;
+			indices.push_back(grid_to_vertex[corner]);
+			indices.push_back(grid_to_vertex[corner + 1]);
+			indices.push_back(grid_to_vertex[corner + grid_size]);
+			indices.push_back(grid_to_vertex[corner + 1]);
+			indices.push_back(grid_to_vertex[corner + grid_size + 1]);
+			indices.push_back(grid_to_vertex[corner + grid_size]);
+		}
+	}
+	// The LOD keeps every other triangle.
+	Vector<int> lod_indices;
+	for (int i = 0; i < indices.size(); i += 6) {
+		lod_indices.push_back(indices[i]);
+		lod_indices.push_back(indices[i + 1]);
+		lod_indices.push_back(indices[i + 2]);
+	}
+
+	Array arrays;
+	arrays.resize(Mesh::ARRAY_MAX);
+	arrays[Mesh::ARRAY_VERTEX] = vertices;
+	arrays[Mesh::ARRAY_TEX_UV] = uvs;
+	arrays[Mesh::ARRAY_INDEX] = indices;
+	Array blend_shape_arrays;
+	blend_shape_arrays.resize(Mesh::ARRAY_MAX);
+	blend_shape_arrays[Mesh::ARRAY_VERTEX] = blend_shape_vertices;
+	Array blend_shapes;
+	blend_shapes.push_back(blend_shape_arrays);
+	Dictionary lods;
+	lods[1.0] = lod_indices;
+
+	Ref<EditorSceneImporterMesh> mesh;
+	mesh.instantiate();
+	mesh->add_blend_shape("bend");
+	mesh->add_surface(Mesh::PRIMITIVE_TRIANGLES, arrays, blend_shapes, lods);
+
+	const Vector<String> triangles = get_triangles(arrays, blend_shape_arrays, indices);
+	const Vector<String> lod_triangles = get_triangles(arrays, blend_shape_arrays, lod_indices);
+
+	mesh->optimize_surface_vertex_order(0);
+
+	const Array optimized_arrays = mesh->get_surface_arrays(0);
+	const Array optimized_blend_shape_arrays = mesh->get_surface_blend_shape_arrays(0, 0);
+	const Vector<int> optimized_indices = optimized_arrays[Mesh::ARRAY_INDEX];
+	CHECK(Vector<Vector3>(optimized_arrays[Mesh::ARRAY_VERTEX]).size() == vertex_count);
+	CHECK(Vector<Vector2>(optimized_arrays[Mesh::ARRAY_TEX_UV]).size() == vertex_count);
+	CHECK(Vector<Vector3>(optimized_blend_shape_arrays[Mesh::ARRAY_VERTEX]).size() == vertex_count);
+	CHECK(optimized_indices != indices);
+	CHECK(get_triangles(optimized_arrays, optimized_blend_shape_arrays, optimized_indices) == triangles);
+
+	REQUIRE(mesh->get_surface_lod_count(0) == 1);
+	CHECK(get_triangles(optimized_arrays, optimized_blend_shape_arrays, mesh->get_surface_lod_indices(0, 0)) == lod_triangles);
+
+	// The arrays given to the mesh are left untouched.
+	CHECK(Vector<int>(arrays[Mesh::ARRAY_INDEX]) == indices);
+	CHECK(Vector<Vector3>(arrays[Mesh::ARRAY_VERTEX]) == vertices);
+}
+
+} // namespace TestMeshOptimizer
+
+#endif // TOOLS_ENABLED
+
+#endif // TEST_MESHOPTIMIZER_H
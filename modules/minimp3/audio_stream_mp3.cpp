@@ -32,96 +32,89 @@
 #define MINIMP3_FLOAT_OUTPUT
 #define MINIMP3_IMPLEMENTATION
 #define MINIMP3_NO_STDIO
+// Read buffer of the playbacks streamed from disk, the default is 128 KiB.
+#define MINIMP3_IO_SIZE (32 * 1024)
 
 #include "audio_stream_mp3.h"
 
-#include "core/io/file_access.h"
+static size_t _file_section_read(void *p_buf, size_t p_size, void *p_user) {
+	MP3FileSection *section = (MP3FileSection *)p_user;
+	uint64_t pos = section->file->get_position() - section->offset;
+	if (pos >= section->length) {
+		return 0;
+	}
+	return section->file->get_buffer((uint8_t *)p_buf, MIN(uint64_t(p_size), section->length - pos));
+}
 
-void AudioStreamPlaybackMP3::_mix_internal(AudioFrame *p_buffer, int p_frames) {
-	ERR_FAIL_COND(!active);
+static int _file_section_seek(uint64_t p_position, void *p_user) {
+	MP3FileSection *section = (MP3FileSection *)p_user;
+	if (p_position > section->length) {
+		return -1;
+	}
+	section->file->seek(section->offset + p_position);
+	return 0;
+}
 
-	int todo = p_frames;
+void MP3FileSection::init_io() {
+	io.read = _file_section_read;
+	io.read_data = this;
+	io.seek = _file_section_seek;
+	io.seek_data = this;
+}
+
+int AudioStreamPlaybackMP3::_decode(AudioFrame *p_buffer, int p_frames) {
+	int mixed = 0;
 
-	while (todo && active) {
+	while (mixed < p_frames) {
 		mp3dec_frame_info_t frame_info;
 		mp3d_sample_t *buf_frame = nullptr;
 
 		int samples_mixed = mp3dec_ex_read_frame(mp3d, &buf_frame, &frame_info, mp3_stream->channels);
-
-		if (samples_mixed) {
-			p_buffer[p_frames - todo] = AudioFrame(buf_frame[0], buf_frame[samples_mixed - 1]);
-			--todo;
-			++frames_mixed;
+		if (!samples_mixed) {
+			break; //EOF
 		}
 
-		else {
-			//EOF
-			if (mp3_stream->loop) {
-				seek(mp3_stream->loop_offset);
-				loops++;
-			} else {
-				//fill remainder with silence
-				for (int i = p_frames - todo; i < p_frames; i++) {
-					p_buffer[i] = AudioFrame(0, 0);
-				}
-				active = false;
-				todo = 0;
-			}
-		}
+		p_buffer[mixed++] = AudioFrame(buf_frame[0], buf_frame[samples_mixed - 1]);
 	}
-}
-
-float AudioStreamPlaybackMP3::get_stream_sampling_rate() {
-	return mp3_stream->sample_rate;
-}
 
-void AudioStreamPlaybackMP3::start(float p_from_pos) {
-	active = true;
-	seek(p_from_pos);
-	loops = 0;
-	_begin_resample();
+	return mixed;
 }
 
-void AudioStreamPlaybackMP3::stop() {
-	active = false;
+void AudioStreamPlaybackMP3::_decoder_seek(uint32_t p_frame) {
+	mp3dec_ex_seek(mp3d, uint64_t(p_frame) * mp3_stream->channels);
 }
 
-bool AudioStreamPlaybackMP3::is_playing() const {
-	return active;
+float AudioStreamPlaybackMP3::_get_length() const {
+	return mp3_stream->length;
 }
 
-int AudioStreamPlaybackMP3::get_loop_count() const {
-	return loops;
+bool AudioStreamPlaybackMP3::_has_loop() const {
+	return mp3_stream->loop.is_set();
 }
 
-float AudioStreamPlaybackMP3::get_playback_position() const {
-	return float(frames_mixed) / mp3_stream->sample_rate;
+float AudioStreamPlaybackMP3::_get_loop_offset() const {
+	return mp3_stream->loop_offset.get();
 }
 
-void AudioStreamPlaybackMP3::seek(float p_time) {
-	if (!active) {
-		return;
-	}
-
-	if (p_time >= mp3_stream->get_length()) {
-		p_time = 0;
-	}
-
-	frames_mixed = uint32_t(mp3_stream->sample_rate * p_time);
-	mp3dec_ex_seek(mp3d, frames_mixed * mp3_stream->channels);
+float AudioStreamPlaybackMP3::get_stream_sampling_rate() {
+	return mp3_stream->sample_rate;
 }
 
 AudioStreamPlaybackMP3::~AudioStreamPlaybackMP3() {
+	_stream_end();
 	if (mp3d) {
 		mp3dec_ex_close(mp3d);
 		memfree(mp3d);
 	}
+	if (file_section.file) {
+		memdelete(file_section.file);
+	}
 }
 
 Ref<AudioStreamPlayback> AudioStreamMP3::instance_playback() {
 	Ref<AudioStreamPlaybackMP3> mp3s;
 
-	ERR_FAIL_COND_V_MSG(data == nullptr, mp3s,
+	ERR_FAIL_COND_V_MSG(data == nullptr && file_path.is_empty(), mp3s,
 			"This AudioStreamMP3 does not have an audio file assigned "
 			"to it. AudioStreamMP3 should not be created from the "
 			"inspector or with `.new()`. Instead, load an audio file.");
@@ -130,16 +123,26 @@ Ref<AudioStreamPlayback> AudioStreamMP3::instance_playback() {
 	mp3s->mp3_stream = Ref<AudioStreamMP3>(this);
 	mp3s->mp3d = (mp3dec_ex_t *)memalloc(sizeof(mp3dec_ex_t));
 
-	int errorcode = mp3dec_ex_open_buf(mp3s->mp3d, (const uint8_t *)data, data_len, MP3D_SEEK_TO_SAMPLE);
-
-	mp3s->frames_mixed = 0;
-	mp3s->active = false;
-	mp3s->loops = 0;
+	int errorcode;
+	if (file_path.is_empty()) {
+		errorcode = mp3dec_ex_open_buf(mp3s->mp3d, (const uint8_t *)data, data_len, MP3D_SEEK_TO_SAMPLE);
+	} else {
+		// Each playback reads the file on its own, only what is being decoded is kept in memory.
+		// The length is already known, so the file isn't scanned until the first seek.
+		memset(mp3s->mp3d, 0, sizeof(mp3dec_ex_t));
+		mp3s->file_section.file = FileAccess::open(file_path, FileAccess::READ);
+		mp3s->file_section.offset = file_offset;
+		mp3s->file_section.length = data_len;
+		mp3s->file_section.init_io();
+		errorcode = mp3s->file_section.file ? mp3dec_ex_open_cb(mp3s->mp3d, &mp3s->file_section.io, MP3D_SEEK_TO_SAMPLE | MP3D_DO_NOT_SCAN) : MP3D_E_IOERROR;
+	}
 
 	if (errorcode) {
 		ERR_FAIL_COND_V(errorcode, Ref<AudioStreamPlaybackMP3>());
 	}
 
+	mp3s->_stream_begin(streaming);
+
 	return mp3s;
 }
 
@@ -151,8 +154,71 @@ void AudioStreamMP3::clear_data() {
 	if (data) {
 		memfree(data);
 		data = nullptr;
-		data_len = 0;
 	}
+	data_len = 0;
+	file_path = String();
+	file_offset = 0;
+}
+
+void AudioStreamMP3::_set_info(const mp3dec_ex_t &p_mp3d) {
+	channels = p_mp3d.info.channels;
+	sample_rate = p_mp3d.info.hz;
+	length = float(p_mp3d.samples) / (sample_rate * float(channels));
+}
+
+Error AudioStreamMP3::load(const String &p_path) {
+	FileAccessRef f = FileAccess::open(p_path, FileAccess::READ);
+	ERR_FAIL_COND_V_MSG(!f, ERR_CANT_OPEN, vformat("Unable to open file: %s.", p_path));
+
+	uint8_t header[4] = {};
+	f->get_buffer(header, 4);
+	if (header[0] != 'G' || header[1] != 'S' || header[2] != 'M' || header[3] != '3') {
+		return ERR_FILE_UNRECOGNIZED; // Imported as a binary resource, left to its loader.
+	}
+
+	uint32_t version = f->get_32();
+	ERR_FAIL_COND_V_MSG(version > FORMAT_VERSION, ERR_FILE_CORRUPT, "MP3 stream file is too new.");
+
+	uint32_t flags = f->get_32();
+	float offset = f->get_float();
+	uint32_t size = f->get_32();
+	uint64_t data_offset = f->get_position();
+	ERR_FAIL_COND_V_MSG(data_offset + size > f->get_length(), ERR_FILE_CORRUPT, "MP3 stream file is corrupt (truncated data).");
+
+	if (flags & FORMAT_BIT_STREAM) {
+		// Scans the frames for the length, without decoding them.
+		MP3FileSection section;
+		section.file = f;
+		section.offset = data_offset;
+		section.length = size;
+		section.init_io();
+
+		mp3dec_ex_t mp3d;
+		int err = mp3dec_ex_open_cb(&mp3d, &section.io, MP3D_SEEK_TO_SAMPLE);
+		if (err != 0) {
+			mp3dec_ex_close(&mp3d);
+			ERR_FAIL_V(ERR_FILE_CORRUPT);
+		}
+		_set_info(mp3d);
+		mp3dec_ex_close(&mp3d);
+
+		clear_data();
+		file_path = p_path;
+		file_offset = data_offset;
+		data_len = size;
+	} else {
+		Vector<uint8_t> file_data;
+		file_data.resize(size);
+		ERR_FAIL_COND_V(f->get_buffer(file_data.ptrw(), size) != size, ERR_FILE_CORRUPT);
+		set_data(file_data);
+		ERR_FAIL_COND_V(data == nullptr, ERR_FILE_CORRUPT);
+	}
+
+	set_loop(flags & FORMAT_BIT_LOOP);
+	set_loop_offset(offset);
+	set_streaming(flags & FORMAT_BIT_STREAM);
+
+	return OK;
 }
 
 void AudioStreamMP3::set_data(const Vector<uint8_t> &p_data) {
@@ -163,9 +229,7 @@ void AudioStreamMP3::set_data(const Vector<uint8_t> &p_data) {
 	int err = mp3dec_ex_open_buf(&mp3d, src_datar, src_data_len, MP3D_SEEK_TO_SAMPLE);
 	ERR_FAIL_COND(err != 0);
 
-	channels = mp3d.info.channels;
-	sample_rate = mp3d.info.hz;
-	length = float(mp3d.samples) / (sample_rate * float(channels));
+	_set_info(mp3d);
 
 	mp3dec_ex_close(&mp3d);
 
@@ -179,7 +243,13 @@ void AudioStreamMP3::set_data(const Vector<uint8_t> &p_data) {
 Vector<uint8_t> AudioStreamMP3::get_data() const {
 	Vector<uint8_t> vdata;
 
-	if (data_len && data) {
+	if (!file_path.is_empty()) {
+		FileAccessRef f = FileAccess::open(file_path, FileAccess::READ);
+		ERR_FAIL_COND_V_MSG(!f, vdata, vformat("Unable to open file: %s.", file_path));
+		vdata.resize(data_len);
+		f->seek(file_offset);
+		f->get_buffer(vdata.ptrw(), data_len);
+	} else if (data_len && data) {
 		vdata.resize(data_len);
 		{
 			uint8_t *w = vdata.ptrw();
@@ -191,19 +261,27 @@ Vector<uint8_t> AudioStreamMP3::get_data() const {
 }
 
 void AudioStreamMP3::set_loop(bool p_enable) {
-	loop = p_enable;
+	loop.set_to(p_enable);
 }
 
 bool AudioStreamMP3::has_loop() const {
-	return loop;
+	return loop.is_set();
 }
 
 void AudioStreamMP3::set_loop_offset(float p_seconds) {
-	loop_offset = p_seconds;
+	loop_offset.set(p_seconds);
 }
 
 float AudioStreamMP3::get_loop_offset() const {
-	return loop_offset;
+	return loop_offset.get();
+}
+
+void AudioStreamMP3::set_streaming(bool p_enable) {
+	streaming = p_enable;
+}
+
+bool AudioStreamMP3::is_streaming() const {
+	return streaming;
 }
 
 float AudioStreamMP3::get_length() const {
@@ -220,9 +298,13 @@ void AudioStreamMP3::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_loop_offset", "seconds"), &AudioStreamMP3::set_loop_offset);
 	ClassDB::bind_method(D_METHOD("get_loop_offset"), &AudioStreamMP3::get_loop_offset);
 
+	ClassDB::bind_method(D_METHOD("set_streaming", "enable"), &AudioStreamMP3::set_streaming);
+	ClassDB::bind_method(D_METHOD("is_streaming"), &AudioStreamMP3::is_streaming);
+
 	ADD_PROPERTY(PropertyInfo(Variant::PACKED_BYTE_ARRAY, "data", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NOEDITOR), "set_data", "get_data");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "loop", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NOEDITOR), "set_loop", "has_loop");
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "loop_offset", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NOEDITOR), "set_loop_offset", "get_loop_offset");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "streaming"), "set_streaming", "is_streaming");
 }
 
 AudioStreamMP3::AudioStreamMP3() {
@@ -231,3 +313,32 @@ AudioStreamMP3::AudioStreamMP3() {
 AudioStreamMP3::~AudioStreamMP3() {
 	clear_data();
 }
+
+RES ResourceFormatLoaderAudioStreamMP3::load(const String &p_path, const String &p_original_path, Error *r_error, bool p_use_sub_threads, float *r_progress, CacheMode p_cache_mode) {
+	Ref<AudioStreamMP3> mp3_stream;
+	mp3_stream.instantiate();
+	Error err = mp3_stream->load(p_path);
+	if (r_error) {
+		*r_error = err;
+	}
+	if (err != OK) {
+		return RES();
+	}
+
+	return mp3_stream;
+}
+
+void ResourceFormatLoaderAudioStreamMP3::get_recognized_extensions(List<String> *p_extensions) const {
+	p_extensions->push_back("mp3str");
+}
+
+bool ResourceFormatLoaderAudioStreamMP3::handles_type(const String &p_type) const {
+	return ClassDB::is_parent_class("AudioStreamMP3", p_type);
+}
+
+String ResourceFormatLoaderAudioStreamMP3::get_resource_type(const String &p_path) const {
+	if (p_path.get_extension().to_lower() == "mp3str") {
+		return "AudioStreamMP3";
+	}
+	return "";
+}
@@ -31,6 +31,7 @@
 #ifndef AUDIO_STREAM_MP3_H
 #define AUDIO_STREAM_MP3_H
 
+#include "core/io/file_access.h"
 #include "core/io/resource_loader.h"
 #include "servers/audio/audio_stream.h"
 
@@ -38,32 +39,37 @@
 
 class AudioStreamMP3;
 
-class AudioStreamPlaybackMP3 : public AudioStreamPlaybackResampled {
-	GDCLASS(AudioStreamPlaybackMP3, AudioStreamPlaybackResampled);
+// Reads the MP3 data stored after the header of an imported file.
+struct MP3FileSection {
+	FileAccess *file = nullptr;
+	uint64_t offset = 0;
+	uint32_t length = 0;
+	mp3dec_io_t io; // Kept by the decoder.
+
+	void init_io();
+};
+
+class AudioStreamPlaybackMP3 : public AudioStreamPlaybackStreamed {
+	GDCLASS(AudioStreamPlaybackMP3, AudioStreamPlaybackStreamed);
 
 	mp3dec_ex_t *mp3d = nullptr;
-	uint32_t frames_mixed = 0;
-	bool active = false;
-	int loops = 0;
+	MP3FileSection file_section; // Only used by the decoder once open.
 
 	friend class AudioStreamMP3;
 
 	Ref<AudioStreamMP3> mp3_stream;
 
 protected:
-	virtual void _mix_internal(AudioFrame *p_buffer, int p_frames) override;
-	virtual float get_stream_sampling_rate() override;
+	virtual int _decode(AudioFrame *p_buffer, int p_frames) override;
+	virtual void _decoder_seek(uint32_t p_frame) override;
 
-public:
-	virtual void start(float p_from_pos = 0.0) override;
-	virtual void stop() override;
-	virtual bool is_playing() const override;
-
-	virtual int get_loop_count() const override; //times it looped
+	virtual float _get_length() const override;
+	virtual bool _has_loop() const override;
+	virtual float _get_loop_offset() const override;
 
-	virtual float get_playback_position() const override;
-	virtual void seek(float p_time) override;
+	virtual float get_stream_sampling_rate() override;
 
+public:
 	AudioStreamPlaybackMP3() {}
 	~AudioStreamPlaybackMP3();
 };
@@ -78,23 +84,44 @@ class AudioStreamMP3 : public AudioStream {
 	void *data = nullptr;
 	uint32_t data_len = 0;
 
+	// When streamed from disk, each playback reads the data from the file instead.
+	String file_path;
+	uint64_t file_offset = 0;
+
 	float sample_rate = 1.0;
 	int channels = 1;
 	float length = 0.0;
-	bool loop = false;
-	float loop_offset = 0.0;
+	// Read by the playbacks on the decoder thread.
+	SafeFlag loop;
+	SafeNumeric<float> loop_offset;
+	bool streaming = false;
 	void clear_data();
+	void _set_info(const mp3dec_ex_t &p_mp3d);
 
 protected:
 	static void _bind_methods();
 
 public:
+	enum {
+		FORMAT_VERSION = 1,
+	};
+
+	enum FormatBits {
+		FORMAT_BIT_LOOP = 1 << 0,
+		FORMAT_BIT_STREAM = 1 << 1,
+	};
+
+	Error load(const String &p_path);
+
 	void set_loop(bool p_enable);
 	bool has_loop() const;
 
 	void set_loop_offset(float p_seconds);
 	float get_loop_offset() const;
 
+	void set_streaming(bool p_enable);
+	bool is_streaming() const;
+
 	virtual Ref<AudioStreamPlayback> instance_playback() override;
 	virtual String get_stream_name() const override;
 
@@ -107,4 +134,12 @@ public:
 	virtual ~AudioStreamMP3();
 };
 
+class ResourceFormatLoaderAudioStreamMP3 : public ResourceFormatLoader {
+public:
+	virtual RES load(const String &p_path, const String &p_original_path = "", Error *r_error = nullptr, bool p_use_sub_threads = false, float *r_progress = nullptr, CacheMode p_cache_mode = CACHE_MODE_REUSE);
+	virtual void get_recognized_extensions(List<String> *p_extensions) const;
+	virtual bool handles_type(const String &p_type) const;
+	virtual String get_resource_type(const String &p_path) const;
+};
+
 #endif // AUDIO_STREAM_MP3_H
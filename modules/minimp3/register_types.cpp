@@ -32,6 +32,8 @@
 
 #include "audio_stream_mp3.h"
 
+static Ref<ResourceFormatLoaderAudioStreamMP3> resource_loader_mp3;
+
 #ifdef TOOLS_ENABLED
 #include "core/config/engine.h"
 #include "resource_importer_mp3.h"
@@ -46,7 +48,13 @@ void register_minimp3_types() {
 	}
 #endif
 	ClassDB::register_class<AudioStreamMP3>();
+
+	// Ahead of the binary loader, which loads the files imported before the data was streamed from disk.
+	resource_loader_mp3.instantiate();
+	ResourceLoader::add_resource_format_loader(resource_loader_mp3, true);
 }
 
 void unregister_minimp3_types() {
+	ResourceLoader::remove_resource_format_loader(resource_loader_mp3);
+	resource_loader_mp3.unref();
 }
@@ -31,7 +31,6 @@
 #include "resource_importer_mp3.h"
 
 #include "core/io/file_access.h"
-#include "core/io/resource_saver.h"
 #include "scene/resources/texture.h"
 
 String ResourceImporterMP3::get_importer_name() const {
@@ -58,6 +57,11 @@ bool ResourceImporterMP3::get_option_visibility(const String &p_option, const Ma
 	return true;
 }
 
+// 1: Saved in the GSM3 stream layout instead of as a binary resource.
+int ResourceImporterMP3::get_format_version() const {
+	return 1;
+}
+
 int ResourceImporterMP3::get_preset_count() const {
 	return 0;
 }
@@ -69,11 +73,13 @@ String ResourceImporterMP3::get_preset_name(int p_idx) const {
 void ResourceImporterMP3::get_import_options(List<ImportOption> *r_options, int p_preset) const {
 	r_options->push_back(ImportOption(PropertyInfo(Variant::BOOL, "loop"), true));
 	r_options->push_back(ImportOption(PropertyInfo(Variant::FLOAT, "loop_offset"), 0));
+	r_options->push_back(ImportOption(PropertyInfo(Variant::BOOL, "streaming"), false));
 }
 
 Error ResourceImporterMP3::import(const String &p_source_file, const String &p_save_path, const Map<StringName, Variant> &p_options, List<String> *r_platform_variants, List<String> *r_gen_files, Variant *r_metadata) {
 	bool loop = p_options["loop"];
 	float loop_offset = p_options["loop_offset"];
+	bool streaming = p_options["streaming"];
 
 	FileAccess *f = FileAccess::open(p_source_file, FileAccess::READ);
 
@@ -94,10 +100,32 @@ Error ResourceImporterMP3::import(const String &p_source_file, const String &p_s
 
 	mp3_stream->set_data(data);
 	ERR_FAIL_COND_V(!mp3_stream->get_data().size(), ERR_FILE_CORRUPT);
-	mp3_stream->set_loop(loop);
-	mp3_stream->set_loop_offset(loop_offset);
 
-	return ResourceSaver::save(p_save_path + ".mp3str", mp3_stream);
+	// Saved with a small header so a streaming stream can read the data from the file as it plays.
+	f = FileAccess::open(p_save_path + ".mp3str", FileAccess::WRITE);
+	ERR_FAIL_COND_V_MSG(!f, ERR_CANT_OPEN, "Cannot open file '" + p_save_path + ".mp3str' for writing.");
+
+	uint32_t flags = 0;
+	if (loop) {
+		flags |= AudioStreamMP3::FORMAT_BIT_LOOP;
+	}
+	if (streaming) {
+		flags |= AudioStreamMP3::FORMAT_BIT_STREAM;
+	}
+
+	f->store_8('G');
+	f->store_8('S');
+	f->store_8('M');
+	f->store_8('3');
+	f->store_32(AudioStreamMP3::FORMAT_VERSION);
+	f->store_32(flags);
+	f->store_float(loop_offset);
+	f->store_32(data.size());
+	f->store_buffer(data.ptr(), data.size());
+
+	memdelete(f);
+
+	return OK;
 }
 
 ResourceImporterMP3::ResourceImporterMP3() {
@@ -30,101 +30,95 @@
 
 #include "audio_stream_ogg_vorbis.h"
 
-#include "core/io/file_access.h"
+static int _file_section_read(void *p_user, unsigned char *p_data, int p_size) {
+	OGGVorbisFileSection *section = (OGGVorbisFileSection *)p_user;
+	uint64_t pos = section->file->get_position() - section->offset;
+	if (pos >= section->length) {
+		return 0;
+	}
+	return section->file->get_buffer(p_data, MIN(uint64_t(p_size), section->length - pos));
+}
 
-void AudioStreamPlaybackOGGVorbis::_mix_internal(AudioFrame *p_buffer, int p_frames) {
-	ERR_FAIL_COND(!active);
+static int _file_section_seek(void *p_user, unsigned int p_offset) {
+	OGGVorbisFileSection *section = (OGGVorbisFileSection *)p_user;
+	if (p_offset > section->length) {
+		return 0;
+	}
+	section->file->seek(section->offset + p_offset);
+	return 1;
+}
 
-	int todo = p_frames;
+static unsigned int _file_section_tell(void *p_user) {
+	OGGVorbisFileSection *section = (OGGVorbisFileSection *)p_user;
+	return section->file->get_position() - section->offset;
+}
 
-	int start_buffer = 0;
+stb_vorbis_io OGGVorbisFileSection::get_io() {
+	stb_vorbis_io io;
+	io.read = _file_section_read;
+	io.seek = _file_section_seek;
+	io.tell = _file_section_tell;
+	io.user = this;
+	return io;
+}
 
-	while (todo && active) {
-		float *buffer = (float *)p_buffer;
-		if (start_buffer > 0) {
-			buffer = (buffer + start_buffer * 2);
-		}
+int AudioStreamPlaybackOGGVorbis::_decode(AudioFrame *p_buffer, int p_frames) {
+	int todo = p_frames;
+
+	while (todo) {
+		float *buffer = (float *)(p_buffer + p_frames - todo);
 		int mixed = stb_vorbis_get_samples_float_interleaved(ogg_stream, 2, buffer, todo * 2);
-		if (vorbis_stream->channels == 1 && mixed > 0) {
+		if (mixed == 0) {
+			break; // End of file.
+		}
+
+		if (vorbis_stream->channels == 1) {
 			//mix mono to stereo
-			for (int i = start_buffer; i < start_buffer + mixed; i++) {
+			for (int i = p_frames - todo; i < p_frames - todo + mixed; i++) {
 				p_buffer[i].r = p_buffer[i].l;
 			}
 		}
 		todo -= mixed;
-		frames_mixed += mixed;
-
-		if (todo) {
-			//end of file!
-			bool is_not_empty = mixed > 0 || stb_vorbis_stream_length_in_samples(ogg_stream) > 0;
-			if (vorbis_stream->loop && is_not_empty) {
-				//loop
-				seek(vorbis_stream->loop_offset);
-				loops++;
-				// we still have buffer to fill, start from this element in the next iteration.
-				start_buffer = p_frames - todo;
-			} else {
-				for (int i = p_frames - todo; i < p_frames; i++) {
-					p_buffer[i] = AudioFrame(0, 0);
-				}
-				active = false;
-				todo = 0;
-			}
-		}
 	}
-}
-
-float AudioStreamPlaybackOGGVorbis::get_stream_sampling_rate() {
-	return vorbis_stream->sample_rate;
-}
 
-void AudioStreamPlaybackOGGVorbis::start(float p_from_pos) {
-	active = true;
-	seek(p_from_pos);
-	loops = 0;
-	_begin_resample();
+	return p_frames - todo;
 }
 
-void AudioStreamPlaybackOGGVorbis::stop() {
-	active = false;
+void AudioStreamPlaybackOGGVorbis::_decoder_seek(uint32_t p_frame) {
+	stb_vorbis_seek(ogg_stream, p_frame);
 }
 
-bool AudioStreamPlaybackOGGVorbis::is_playing() const {
-	return active;
+float AudioStreamPlaybackOGGVorbis::_get_length() const {
+	return vorbis_stream->length;
 }
 
-int AudioStreamPlaybackOGGVorbis::get_loop_count() const {
-	return loops;
+bool AudioStreamPlaybackOGGVorbis::_has_loop() const {
+	return vorbis_stream->loop.is_set();
 }
 
-float AudioStreamPlaybackOGGVorbis::get_playback_position() const {
-	return float(frames_mixed) / vorbis_stream->sample_rate;
+float AudioStreamPlaybackOGGVorbis::_get_loop_offset() const {
+	return vorbis_stream->loop_offset.get();
 }
 
-void AudioStreamPlaybackOGGVorbis::seek(float p_time) {
-	if (!active) {
-		return;
-	}
-
-	if (p_time >= vorbis_stream->get_length()) {
-		p_time = 0;
-	}
-	frames_mixed = uint32_t(vorbis_stream->sample_rate * p_time);
-
-	stb_vorbis_seek(ogg_stream, frames_mixed);
+float AudioStreamPlaybackOGGVorbis::get_stream_sampling_rate() {
+	return vorbis_stream->sample_rate;
 }
 
 AudioStreamPlaybackOGGVorbis::~AudioStreamPlaybackOGGVorbis() {
+	_stream_end();
 	if (ogg_alloc.alloc_buffer) {
 		stb_vorbis_close(ogg_stream);
 		memfree(ogg_alloc.alloc_buffer);
 	}
+	if (file_section.file) {
+		memdelete(file_section.file);
+	}
 }
 
 Ref<AudioStreamPlayback> AudioStreamOGGVorbis::instance_playback() {
 	Ref<AudioStreamPlaybackOGGVorbis> ovs;
 
-	ERR_FAIL_COND_V_MSG(data == nullptr, ovs,
+	ERR_FAIL_COND_V_MSG(data == nullptr && file_path.is_empty(), ovs,
 			"This AudioStreamOGGVorbis does not have an audio file assigned "
 			"to it. AudioStreamOGGVorbis should not be created from the "
 			"inspector or with `.new()`. Instead, load an audio file.");
@@ -133,17 +127,27 @@ Ref<AudioStreamPlayback> AudioStreamOGGVorbis::instance_playback() {
 	ovs->vorbis_stream = Ref<AudioStreamOGGVorbis>(this);
 	ovs->ogg_alloc.alloc_buffer = (char *)memalloc(decode_mem_size);
 	ovs->ogg_alloc.alloc_buffer_length_in_bytes = decode_mem_size;
-	ovs->frames_mixed = 0;
-	ovs->active = false;
-	ovs->loops = 0;
 	int error;
-	ovs->ogg_stream = stb_vorbis_open_memory((const unsigned char *)data, data_len, &error, &ovs->ogg_alloc);
+	if (file_path.is_empty()) {
+		ovs->ogg_stream = stb_vorbis_open_memory((const unsigned char *)data, data_len, &error, &ovs->ogg_alloc);
+	} else {
+		// Each playback reads the file on its own, only what is being decoded is kept in memory.
+		ovs->file_section.file = FileAccess::open(file_path, FileAccess::READ);
+		ovs->file_section.offset = file_offset;
+		ovs->file_section.length = data_len;
+		if (ovs->file_section.file) {
+			stb_vorbis_io io = ovs->file_section.get_io();
+			ovs->ogg_stream = stb_vorbis_open_io(&io, data_len, &error, &ovs->ogg_alloc);
+		}
+	}
 	if (!ovs->ogg_stream) {
 		memfree(ovs->ogg_alloc.alloc_buffer);
 		ovs->ogg_alloc.alloc_buffer = nullptr;
 		ERR_FAIL_COND_V(!ovs->ogg_stream, Ref<AudioStreamPlaybackOGGVorbis>());
 	}
 
+	ovs->_stream_begin(streaming);
+
 	return ovs;
 }
 
@@ -155,12 +159,13 @@ void AudioStreamOGGVorbis::clear_data() {
 	if (data) {
 		memfree(data);
 		data = nullptr;
-		data_len = 0;
 	}
+	data_len = 0;
+	file_path = String();
+	file_offset = 0;
 }
 
-void AudioStreamOGGVorbis::set_data(const Vector<uint8_t> &p_data) {
-	int src_data_len = p_data.size();
+bool AudioStreamOGGVorbis::_read_info(const uint8_t *p_data, const stb_vorbis_io *p_io, uint32_t p_length) {
 	uint32_t alloc_try = 1024;
 	Vector<char> alloc_mem;
 	char *w;
@@ -178,16 +183,17 @@ void AudioStreamOGGVorbis::set_data(const Vector<uint8_t> &p_data) {
 		ogg_alloc.alloc_buffer = w;
 		ogg_alloc.alloc_buffer_length_in_bytes = alloc_try;
 
-		const uint8_t *src_datar = p_data.ptr();
-
 		int error;
-		ogg_stream = stb_vorbis_open_memory((const unsigned char *)src_datar, src_data_len, &error, &ogg_alloc);
+		if (p_io) {
+			ogg_stream = stb_vorbis_open_io(p_io, p_length, &error, &ogg_alloc);
+		} else {
+			ogg_stream = stb_vorbis_open_memory((const unsigned char *)p_data, p_length, &error, &ogg_alloc);
+		}
 
 		if (!ogg_stream && error == VORBIS_outofmem) {
 			alloc_try *= 2;
 		} else {
-			ERR_FAIL_COND(alloc_try == MAX_TEST_MEM);
-			ERR_FAIL_COND(ogg_stream == nullptr);
+			ERR_FAIL_COND_V(ogg_stream == nullptr, false);
 
 			stb_vorbis_info info = stb_vorbis_get_info(ogg_stream);
 
@@ -199,25 +205,82 @@ void AudioStreamOGGVorbis::set_data(const Vector<uint8_t> &p_data) {
 
 			length = stb_vorbis_stream_length_in_seconds(ogg_stream);
 			stb_vorbis_close(ogg_stream);
+			return true;
+		}
+	}
 
-			// free any existing data
-			clear_data();
+	ERR_FAIL_V_MSG(false, vformat("Couldn't set vorbis data even with an alloc buffer of %d bytes, report bug.", MAX_TEST_MEM));
+}
 
-			data = memalloc(src_data_len);
-			memcpy(data, src_datar, src_data_len);
-			data_len = src_data_len;
+Error AudioStreamOGGVorbis::load(const String &p_path) {
+	FileAccessRef f = FileAccess::open(p_path, FileAccess::READ);
+	ERR_FAIL_COND_V_MSG(!f, ERR_CANT_OPEN, vformat("Unable to open file: %s.", p_path));
 
-			break;
-		}
+	uint8_t header[4] = {};
+	f->get_buffer(header, 4);
+	if (header[0] != 'G' || header[1] != 'S' || header[2] != 'O' || header[3] != 'V') {
+		return ERR_FILE_UNRECOGNIZED; // Imported as a binary resource, left to its loader.
 	}
 
-	ERR_FAIL_COND_MSG(alloc_try == MAX_TEST_MEM, vformat("Couldn't set vorbis data even with an alloc buffer of %d bytes, report bug.", MAX_TEST_MEM));
+	uint32_t version = f->get_32();
+	ERR_FAIL_COND_V_MSG(version > FORMAT_VERSION, ERR_FILE_CORRUPT, "OGG Vorbis stream file is too new.");
+
+	uint32_t flags = f->get_32();
+	float offset = f->get_float();
+	uint32_t size = f->get_32();
+	uint64_t data_offset = f->get_position();
+	ERR_FAIL_COND_V_MSG(data_offset + size > f->get_length(), ERR_FILE_CORRUPT, "OGG Vorbis stream file is corrupt (truncated data).");
+
+	if (flags & FORMAT_BIT_STREAM) {
+		OGGVorbisFileSection section;
+		section.file = f;
+		section.offset = data_offset;
+		section.length = size;
+		stb_vorbis_io io = section.get_io();
+		ERR_FAIL_COND_V(!_read_info(nullptr, &io, size), ERR_FILE_CORRUPT);
+
+		clear_data();
+		file_path = p_path;
+		file_offset = data_offset;
+		data_len = size;
+	} else {
+		Vector<uint8_t> file_data;
+		file_data.resize(size);
+		ERR_FAIL_COND_V(f->get_buffer(file_data.ptrw(), size) != size, ERR_FILE_CORRUPT);
+		set_data(file_data);
+		ERR_FAIL_COND_V(data == nullptr, ERR_FILE_CORRUPT);
+	}
+
+	set_loop(flags & FORMAT_BIT_LOOP);
+	set_loop_offset(offset);
+	set_streaming(flags & FORMAT_BIT_STREAM);
+
+	return OK;
+}
+
+void AudioStreamOGGVorbis::set_data(const Vector<uint8_t> &p_data) {
+	if (!_read_info(p_data.ptr(), nullptr, p_data.size())) {
+		return;
+	}
+
+	// free any existing data
+	clear_data();
+
+	data_len = p_data.size();
+	data = memalloc(data_len);
+	memcpy(data, p_data.ptr(), data_len);
 }
 
 Vector<uint8_t> AudioStreamOGGVorbis::get_data() const {
 	Vector<uint8_t> vdata;
 
-	if (data_len && data) {
+	if (!file_path.is_empty()) {
+		FileAccessRef f = FileAccess::open(file_path, FileAccess::READ);
+		ERR_FAIL_COND_V_MSG(!f, vdata, vformat("Unable to open file: %s.", file_path));
+		vdata.resize(data_len);
+		f->seek(file_offset);
+		f->get_buffer(vdata.ptrw(), data_len);
+	} else if (data_len && data) {
 		vdata.resize(data_len);
 		{
 			uint8_t *w = vdata.ptrw();
@@ -229,19 +292,27 @@ Vector<uint8_t> AudioStreamOGGVorbis::get_data() const {
 }
 
 void AudioStreamOGGVorbis::set_loop(bool p_enable) {
-	loop = p_enable;
+	loop.set_to(p_enable);
 }
 
 bool AudioStreamOGGVorbis::has_loop() const {
-	return loop;
+	return loop.is_set();
 }
 
 void AudioStreamOGGVorbis::set_loop_offset(float p_seconds) {
-	loop_offset = p_seconds;
+	loop_offset.set(p_seconds);
 }
 
 float AudioStreamOGGVorbis::get_loop_offset() const {
-	return loop_offset;
+	return loop_offset.get();
+}
+
+void AudioStreamOGGVorbis::set_streaming(bool p_enable) {
+	streaming = p_enable;
+}
+
+bool AudioStreamOGGVorbis::is_streaming() const {
+	return streaming;
 }
 
 float AudioStreamOGGVorbis::get_length() const {
@@ -258,9 +329,13 @@ void AudioStreamOGGVorbis::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_loop_offset", "seconds"), &AudioStreamOGGVorbis::set_loop_offset);
 	ClassDB::bind_method(D_METHOD("get_loop_offset"), &AudioStreamOGGVorbis::get_loop_offset);
 
+	ClassDB::bind_method(D_METHOD("set_streaming", "enable"), &AudioStreamOGGVorbis::set_streaming);
+	ClassDB::bind_method(D_METHOD("is_streaming"), &AudioStreamOGGVorbis::is_streaming);
+
 	ADD_PROPERTY(PropertyInfo(Variant::PACKED_BYTE_ARRAY, "data", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NOEDITOR), "set_data", "get_data");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "loop"), "set_loop", "has_loop");
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "loop_offset"), "set_loop_offset", "get_loop_offset");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "streaming"), "set_streaming", "is_streaming");
 }
 
 AudioStreamOGGVorbis::AudioStreamOGGVorbis() {}
@@ -268,3 +343,32 @@ AudioStreamOGGVorbis::AudioStreamOGGVorbis() {}
 AudioStreamOGGVorbis::~AudioStreamOGGVorbis() {
 	clear_data();
 }
+
+RES ResourceFormatLoaderAudioStreamOGGVorbis::load(const String &p_path, const String &p_original_path, Error *r_error, bool p_use_sub_threads, float *r_progress, CacheMode p_cache_mode) {
+	Ref<AudioStreamOGGVorbis> ogg_stream;
+	ogg_stream.instantiate();
+	Error err = ogg_stream->load(p_path);
+	if (r_error) {
+		*r_error = err;
+	}
+	if (err != OK) {
+		return RES();
+	}
+
+	return ogg_stream;
+}
+
+void ResourceFormatLoaderAudioStreamOGGVorbis::get_recognized_extensions(List<String> *p_extensions) const {
+	p_extensions->push_back("oggstr");
+}
+
+bool ResourceFormatLoaderAudioStreamOGGVorbis::handles_type(const String &p_type) const {
+	return ClassDB::is_parent_class("AudioStreamOGGVorbis", p_type);
+}
+
+String ResourceFormatLoaderAudioStreamOGGVorbis::get_resource_type(const String &p_path) const {
+	if (p_path.get_extension().to_lower() == "oggstr") {
+		return "AudioStreamOGGVorbis";
+	}
+	return "";
+}
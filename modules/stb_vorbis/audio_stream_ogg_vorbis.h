@@ -31,6 +31,7 @@
 #ifndef AUDIO_STREAM_STB_VORBIS_H
 #define AUDIO_STREAM_STB_VORBIS_H
 
+#include "core/io/file_access.h"
 #include "core/io/resource_loader.h"
 #include "servers/audio/audio_stream.h"
 
@@ -38,33 +39,37 @@
 
 class AudioStreamOGGVorbis;
 
-class AudioStreamPlaybackOGGVorbis : public AudioStreamPlaybackResampled {
-	GDCLASS(AudioStreamPlaybackOGGVorbis, AudioStreamPlaybackResampled);
+// Reads the Vorbis data stored after the header of an imported file.
+struct OGGVorbisFileSection {
+	FileAccess *file = nullptr;
+	uint64_t offset = 0;
+	uint32_t length = 0;
+
+	stb_vorbis_io get_io();
+};
+
+class AudioStreamPlaybackOGGVorbis : public AudioStreamPlaybackStreamed {
+	GDCLASS(AudioStreamPlaybackOGGVorbis, AudioStreamPlaybackStreamed);
 
 	stb_vorbis *ogg_stream = nullptr;
 	stb_vorbis_alloc ogg_alloc;
-	uint32_t frames_mixed = 0;
-	bool active = false;
-	int loops = 0;
+	OGGVorbisFileSection file_section; // Only used by the decoder once open.
 
 	friend class AudioStreamOGGVorbis;
 
 	Ref<AudioStreamOGGVorbis> vorbis_stream;
 
 protected:
-	virtual void _mix_internal(AudioFrame *p_buffer, int p_frames) override;
-	virtual float get_stream_sampling_rate() override;
+	virtual int _decode(AudioFrame *p_buffer, int p_frames) override;
+	virtual void _decoder_seek(uint32_t p_frame) override;
 
-public:
-	virtual void start(float p_from_pos = 0.0) override;
-	virtual void stop() override;
-	virtual bool is_playing() const override;
-
-	virtual int get_loop_count() const override; //times it looped
+	virtual float _get_length() const override;
+	virtual bool _has_loop() const override;
+	virtual float _get_loop_offset() const override;
 
-	virtual float get_playback_position() const override;
-	virtual void seek(float p_time) override;
+	virtual float get_stream_sampling_rate() override;
 
+public:
 	AudioStreamPlaybackOGGVorbis() {}
 	~AudioStreamPlaybackOGGVorbis();
 };
@@ -79,24 +84,45 @@ class AudioStreamOGGVorbis : public AudioStream {
 	void *data = nullptr;
 	uint32_t data_len = 0;
 
+	// When streamed from disk, each playback reads the data from the file instead.
+	String file_path;
+	uint64_t file_offset = 0;
+
 	int decode_mem_size = 0;
 	float sample_rate = 1.0;
 	int channels = 1;
 	float length = 0.0;
-	bool loop = false;
-	float loop_offset = 0.0;
+	// Read by the playbacks on the decoder thread.
+	SafeFlag loop;
+	SafeNumeric<float> loop_offset;
+	bool streaming = false;
 	void clear_data();
+	bool _read_info(const uint8_t *p_data, const stb_vorbis_io *p_io, uint32_t p_length);
 
 protected:
 	static void _bind_methods();
 
 public:
+	enum {
+		FORMAT_VERSION = 1,
+	};
+
+	enum FormatBits {
+		FORMAT_BIT_LOOP = 1 << 0,
+		FORMAT_BIT_STREAM = 1 << 1,
+	};
+
+	Error load(const String &p_path);
+
 	void set_loop(bool p_enable);
 	bool has_loop() const;
 
 	void set_loop_offset(float p_seconds);
 	float get_loop_offset() const;
 
+	void set_streaming(bool p_enable);
+	bool is_streaming() const;
+
 	virtual Ref<AudioStreamPlayback> instance_playback() override;
 	virtual String get_stream_name() const override;
 
@@ -109,4 +135,12 @@ public:
 	virtual ~AudioStreamOGGVorbis();
 };
 
+class ResourceFormatLoaderAudioStreamOGGVorbis : public ResourceFormatLoader {
+public:
+	virtual RES load(const String &p_path, const String &p_original_path = "", Error *r_error = nullptr, bool p_use_sub_threads = false, float *r_progress = nullptr, CacheMode p_cache_mode = CACHE_MODE_REUSE);
+	virtual void get_recognized_extensions(List<String> *p_extensions) const;
+	virtual bool handles_type(const String &p_type) const;
+	virtual String get_resource_type(const String &p_path) const;
+};
+
 #endif
@@ -32,6 +32,8 @@
 
 #include "audio_stream_ogg_vorbis.h"
 
+static Ref<ResourceFormatLoaderAudioStreamOGGVorbis> resource_loader_ogg_vorbis;
+
 #ifdef TOOLS_ENABLED
 #include "core/config/engine.h"
 #include "resource_importer_ogg_vorbis.h"
@@ -46,7 +48,13 @@ void register_stb_vorbis_types() {
 	}
 #endif
 	ClassDB::register_class<AudioStreamOGGVorbis>();
+
+	// Ahead of the binary loader, which loads the files imported before the data was streamed from disk.
+	resource_loader_ogg_vorbis.instantiate();
+	ResourceLoader::add_resource_format_loader(resource_loader_ogg_vorbis, true);
 }
 
 void unregister_stb_vorbis_types() {
+	ResourceLoader::remove_resource_format_loader(resource_loader_ogg_vorbis);
+	resource_loader_ogg_vorbis.unref();
 }
@@ -37,12 +37,47 @@
 void AudioStreamPlayer2D::_mix_audio() {
 	if (!stream_playback.is_valid() || !active.is_set() ||
 			(stream_paused && !stream_paused_fade_out)) {
+		voice.playing = false;
 		return;
 	}
 
+	voice.playing = true;
+
 	if (setseek.get() >= 0.0) {
 		stream_playback->start(setseek.get());
 		setseek.set(-1.0); //reset seek
+		voice_virtual = false;
+		virtual_time = 0.0;
+	}
+
+	float mix_rate = AudioServer::get_singleton()->get_mix_rate();
+
+	if (voice.is_virtual) {
+		if (voice_virtual) {
+			// Only keep track of time, the playback is advanced when revived or when it should end.
+			virtual_time += mix_buffer.size() * pitch_scale / mix_rate;
+			float length = stream->get_length();
+			if (length > 0 && stream_playback->get_playback_position() + virtual_time >= length) {
+				stream_playback->skip(virtual_time);
+				virtual_time = 0.0;
+			}
+
+			if (!stream_playback->is_playing()) {
+				active.clear();
+			}
+			output_ready.clear();
+			return;
+		}
+
+		// Fade out the last mix before becoming virtual.
+		voice_virtual = true;
+		stream_paused_fade_out = true;
+		virtual_time = (mix_buffer.size() - MIN(mix_buffer.size(), 128)) * pitch_scale / mix_rate;
+	} else if (voice_virtual) {
+		voice_virtual = false;
+		stream_playback->skip(virtual_time);
+		virtual_time = 0.0;
+		stream_paused_fade_in = true;
 	}
 
 	//get data
@@ -146,6 +181,7 @@ void AudioStreamPlayer2D::_mix_audio() {
 void AudioStreamPlayer2D::_notification(int p_what) {
 	if (p_what == NOTIFICATION_ENTER_TREE) {
 		AudioServer::get_singleton()->add_callback(_mix_audios, this);
+		AudioServer::get_singleton()->voice_add(&voice);
 		if (autoplay && !Engine::get_singleton()->is_editor_hint()) {
 			play();
 		}
@@ -153,6 +189,7 @@ void AudioStreamPlayer2D::_notification(int p_what) {
 
 	if (p_what == NOTIFICATION_EXIT_TREE) {
 		AudioServer::get_singleton()->remove_callback(_mix_audios, this);
+		AudioServer::get_singleton()->voice_remove(&voice);
 	}
 
 	if (p_what == NOTIFICATION_PAUSED) {
@@ -241,6 +278,13 @@ void AudioStreamPlayer2D::_notification(int p_what) {
 				}
 			}
 
+			// Used to decide which voices become virtual when there are too many.
+			float max_volume = 0.0;
+			for (int i = 0; i < new_output_count; i++) {
+				max_volume = MAX(max_volume, MAX(outputs[i].vol.l, outputs[i].vol.r));
+			}
+			voice.volume_db.set(Math::linear2db(max_volume + AUDIO_PEAK_OFFSET));
+
 			output_count.set(new_output_count);
 			output_ready.set();
 		}
@@ -444,6 +488,14 @@ bool AudioStreamPlayer2D::get_stream_paused() const {
 	return stream_paused;
 }
 
+void AudioStreamPlayer2D::set_voice_priority(int p_priority) {
+	voice.priority.set(p_priority);
+}
+
+int AudioStreamPlayer2D::get_voice_priority() const {
+	return voice.priority.get();
+}
+
 Ref<AudioStreamPlayback> AudioStreamPlayer2D::get_stream_playback() {
 	return stream_playback;
 }
@@ -486,6 +538,9 @@ void AudioStreamPlayer2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_stream_paused", "pause"), &AudioStreamPlayer2D::set_stream_paused);
 	ClassDB::bind_method(D_METHOD("get_stream_paused"), &AudioStreamPlayer2D::get_stream_paused);
 
+	ClassDB::bind_method(D_METHOD("set_voice_priority", "priority"), &AudioStreamPlayer2D::set_voice_priority);
+	ClassDB::bind_method(D_METHOD("get_voice_priority"), &AudioStreamPlayer2D::get_voice_priority);
+
 	ClassDB::bind_method(D_METHOD("get_stream_playback"), &AudioStreamPlayer2D::get_stream_playback);
 
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "stream", PROPERTY_HINT_RESOURCE_TYPE, "AudioStream"), "set_stream", "get_stream");
@@ -498,6 +553,7 @@ void AudioStreamPlayer2D::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "attenuation", PROPERTY_HINT_EXP_EASING, "attenuation"), "set_attenuation", "get_attenuation");
 	ADD_PROPERTY(PropertyInfo(Variant::STRING_NAME, "bus", PROPERTY_HINT_ENUM, ""), "set_bus", "get_bus");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "area_mask", PROPERTY_HINT_LAYERS_2D_PHYSICS), "set_area_mask", "get_area_mask");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "voice_priority", PROPERTY_HINT_RANGE, "-128,128,1,or_lesser,or_greater"), "set_voice_priority", "get_voice_priority");
 
 	ADD_SIGNAL(MethodInfo("finished"));
 }
@@ -31,11 +31,21 @@
 #include "cpu_particles_2d.h"
 
 #include "core/core_string_names.h"
+#include "core/math/random_pcg.h"
+#include "core/templates/thread_work_pool.h"
 #include "scene/2d/gpu_particles_2d.h"
 #include "scene/main/canvas_item.h"
+#include "scene/main/scene_tree.h"
 #include "scene/resources/particles_material.h"
 #include "servers/rendering_server.h"
 
+#if !defined(REAL_T_IS_DOUBLE)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CPU_PARTICLES_2D_SSE2
+#include <emmintrin.h>
+#endif
+#endif
+
 void CPUParticles2D::set_emitting(bool p_emitting) {
 	if (emitting == p_emitting) {
 		return;
@@ -59,6 +69,14 @@ void CPUParticles2D::set_amount(int p_amount) {
 		}
 	}
 
+	for (int i = 0; i < 2; i++) {
+		particle_position[i].resize(p_amount);
+		particle_velocity[i].resize(p_amount);
+		memset(particle_position[i].ptr(), 0, sizeof(real_t) * p_amount);
+		memset(particle_velocity[i].ptr(), 0, sizeof(real_t) * p_amount);
+	}
+	particle_step.resize(p_amount);
+
 	particle_data.resize((8 + 4 + 4) * p_amount);
 	RS::get_singleton()->multimesh_allocate_data(multimesh, p_amount, RS::MULTIMESH_TRANSFORM_2D, true, true);
 
@@ -278,6 +296,11 @@ void CPUParticles2D::restart() {
 	set_emitting(true);
 }
 
+Vector<float> CPUParticles2D::get_particle_data() const {
+	MutexLock lock(update_mutex);
+	return particle_data;
+}
+
 void CPUParticles2D::set_direction(Vector2 p_direction) {
 	direction = p_direction;
 }
@@ -581,14 +604,16 @@ void CPUParticles2D::_update_internal() {
 	_update_particle_data_buffer();
 }
 
+ThreadWorkPool *CPUParticles2D::_get_chunk_work_pool(uint32_t p_chunk_count) const {
+	if (p_chunk_count < 2 || !is_inside_tree()) {
+		return nullptr;
+	}
+	return get_tree()->get_thread_work_pool_for_main_thread();
+}
+
 void CPUParticles2D::_particles_process(float p_delta) {
 	p_delta *= speed_scale;
 
-	int pcount = particles.size();
-	Particle *w = particles.ptrw();
-
-	Particle *parray = w;
-
 	float prev_time = time;
 	time += p_delta;
 	if (time > lifetime) {
@@ -600,24 +625,68 @@ void CPUParticles2D::_particles_process(float p_delta) {
 		}
 	}
 
-	Transform2D emission_xform;
-	Transform2D velocity_xform;
+	process_frame.delta = p_delta;
+	process_frame.prev_time = prev_time;
+	process_frame.system_phase = time / lifetime;
+	process_frame.seed = Math::rand();
+	process_frame.emission_xform = Transform2D();
+	process_frame.velocity_xform = Transform2D();
 	if (!local_coords) {
-		emission_xform = get_global_transform();
-		velocity_xform = emission_xform;
-		velocity_xform[2] = Vector2();
+		process_frame.emission_xform = get_global_transform();
+		process_frame.velocity_xform = process_frame.emission_xform;
+		process_frame.velocity_xform[2] = Vector2();
+	}
+
+	// Gradients sort their points lazily, make sure that happened before sampling from several threads.
+	if (color_ramp.is_valid()) {
+		color_ramp->get_color_at_offset(0.0);
 	}
 
-	float system_phase = time / lifetime;
+	Particle *w = particles.ptrw();
+
+	uint32_t chunk_count = (particles.size() + PROCESS_CHUNK_SIZE - 1) / PROCESS_CHUNK_SIZE;
+	ThreadWorkPool *pool = _get_chunk_work_pool(chunk_count);
+	if (pool) {
+		pool->do_work(chunk_count, this, &CPUParticles2D::_process_particle_chunk, w);
+	} else {
+		for (uint32_t i = 0; i < chunk_count; i++) {
+			_process_particle_chunk(i, w);
+		}
+	}
+}
+
+void CPUParticles2D::_process_particle_chunk(uint32_t p_chunk, Particle *p_particles) {
+	const float prev_time = process_frame.prev_time;
+	const float system_phase = process_frame.system_phase;
+	const Transform2D &emission_xform = process_frame.emission_xform;
+	const Transform2D &velocity_xform = process_frame.velocity_xform;
 
-	for (int i = 0; i < pcount; i++) {
+	RandomPCG rng(process_frame.seed, p_chunk);
+
+	int pcount = particles.size();
+	Particle *parray = p_particles;
+
+	int from = p_chunk * PROCESS_CHUNK_SIZE;
+	int to = MIN(from + PROCESS_CHUNK_SIZE, pcount);
+
+	real_t *px = particle_position[0].ptr();
+	real_t *py = particle_position[1].ptr();
+	real_t *vx = particle_velocity[0].ptr();
+	real_t *vy = particle_velocity[1].ptr();
+	float *step = particle_step.ptr();
+
+	for (int i = from; i < to; i++) {
 		Particle &p = parray[i];
 
+		step[i] = 0.0;
 		if (!emitting && !p.active) {
 			continue;
 		}
 
-		float local_delta = p_delta;
+		Vector2 origin(px[i], py[i]);
+		Vector2 velocity(vx[i], vy[i]);
+
+		float local_delta = process_frame.delta;
 
 		// The phase is a ratio between 0 (birth) and 1 (end of life) for each particle.
 		// While we use time in tests later on, for randomness we use the phase as done in the
@@ -692,16 +761,16 @@ void CPUParticles2D::_particles_process(float p_delta) {
 				tex_anim_offset = curve_parameters[PARAM_ANGLE]->interpolate(tv);
 			}
 
-			p.seed = Math::rand();
+			p.seed = rng.rand();
 
-			p.angle_rand = Math::randf();
-			p.scale_rand = Math::randf();
-			p.hue_rot_rand = Math::randf();
-			p.anim_offset_rand = Math::randf();
+			p.angle_rand = rng.randf();
+			p.scale_rand = rng.randf();
+			p.hue_rot_rand = rng.randf();
+			p.anim_offset_rand = rng.randf();
 
-			real_t angle1_rad = Math::atan2(direction.y, direction.x) + Math::deg2rad((Math::randf() * 2.0 - 1.0) * spread);
+			real_t angle1_rad = Math::atan2(direction.y, direction.x) + Math::deg2rad((rng.randf() * 2.0 - 1.0) * spread);
 			Vector2 rot = Vector2(Math::cos(angle1_rad), Math::sin(angle1_rad));
-			p.velocity = rot * parameters[PARAM_INITIAL_LINEAR_VELOCITY] * Math::lerp((real_t)1.0, real_t(Math::randf()), randomness[PARAM_INITIAL_LINEAR_VELOCITY]);
+			velocity = rot * parameters[PARAM_INITIAL_LINEAR_VELOCITY] * Math::lerp((real_t)1.0, real_t(rng.randf()), randomness[PARAM_INITIAL_LINEAR_VELOCITY]);
 
 			real_t base_angle = (parameters[PARAM_ANGLE] + tex_angle) * Math::lerp((real_t)1.0, p.angle_rand, randomness[PARAM_ANGLE]);
 			p.rotation = Math::deg2rad(base_angle);
@@ -710,9 +779,10 @@ void CPUParticles2D::_particles_process(float p_delta) {
 			p.custom[1] = 0.0; // phase [0..1]
 			p.custom[2] = (parameters[PARAM_ANIM_OFFSET] + tex_anim_offset) * Math::lerp((real_t)1.0, p.anim_offset_rand, randomness[PARAM_ANIM_OFFSET]); //animation phase [0..1]
 			p.custom[3] = 0.0;
-			p.transform = Transform2D();
+			p.basis = Transform2D();
+			origin = Vector2();
 			p.time = 0;
-			p.lifetime = lifetime * (1.0 - Math::randf() * lifetime_randomness);
+			p.lifetime = lifetime * (1.0 - rng.randf() * lifetime_randomness);
 			p.base_color = Color(1, 1, 1, 1);
 
 			switch (emission_shape) {
@@ -720,12 +790,12 @@ void CPUParticles2D::_particles_process(float p_delta) {
 					//do none
 				} break;
 				case EMISSION_SHAPE_SPHERE: {
-					real_t s = Math::randf(), t = Math_TAU * Math::randf();
+					real_t s = rng.randf(), t = Math_TAU * rng.randf();
 					real_t radius = emission_sphere_radius * Math::sqrt(1.0 - s * s);
-					p.transform[2] = Vector2(Math::cos(t), Math::sin(t)) * radius;
+					origin = Vector2(Math::cos(t), Math::sin(t)) * radius;
 				} break;
 				case EMISSION_SHAPE_RECTANGLE: {
-					p.transform[2] = Vector2(Math::randf() * 2.0 - 1.0, Math::randf() * 2.0 - 1.0) * emission_rect_extents;
+					origin = Vector2(rng.randf() * 2.0 - 1.0, rng.randf() * 2.0 - 1.0) * emission_rect_extents;
 				} break;
 				case EMISSION_SHAPE_POINTS:
 				case EMISSION_SHAPE_DIRECTED_POINTS: {
@@ -734,16 +804,16 @@ void CPUParticles2D::_particles_process(float p_delta) {
 						break;
 					}
 
-					int random_idx = Math::rand() % pc;
+					int random_idx = rng.rand() % pc;
 
-					p.transform[2] = emission_points.get(random_idx);
+					origin = emission_points.get(random_idx);
 
 					if (emission_shape == EMISSION_SHAPE_DIRECTED_POINTS && emission_normals.size() == pc) {
 						Vector2 normal = emission_normals.get(random_idx);
 						Transform2D m2;
 						m2.set_axis(0, normal);
 						m2.set_axis(1, normal.orthogonal());
-						p.velocity = m2.basis_xform(p.velocity);
+						velocity = m2.basis_xform(velocity);
 					}
 
 					if (emission_colors.size() == pc) {
@@ -756,8 +826,10 @@ void CPUParticles2D::_particles_process(float p_delta) {
 			}
 
 			if (!local_coords) {
-				p.velocity = velocity_xform.xform(p.velocity);
-				p.transform = emission_xform * p.transform;
+				velocity = velocity_xform.xform(velocity);
+				p.basis.elements[0] = emission_xform.basis_xform(p.basis.elements[0]);
+				p.basis.elements[1] = emission_xform.basis_xform(p.basis.elements[1]);
+				origin = emission_xform.xform(origin);
 			}
 
 		} else if (!p.active) {
@@ -822,10 +894,10 @@ void CPUParticles2D::_particles_process(float p_delta) {
 			}
 
 			Vector2 force = gravity;
-			Vector2 pos = p.transform[2];
+			Vector2 pos = origin;
 
 			//apply linear acceleration
-			force += p.velocity.length() > 0.0 ? p.velocity.normalized() * (parameters[PARAM_LINEAR_ACCEL] + tex_linear_accel) * Math::lerp((real_t)1.0, rand_from_seed(alt_seed), randomness[PARAM_LINEAR_ACCEL]) : Vector2();
+			force += velocity.length() > 0.0 ? velocity.normalized() * (parameters[PARAM_LINEAR_ACCEL] + tex_linear_accel) * Math::lerp((real_t)1.0, rand_from_seed(alt_seed), randomness[PARAM_LINEAR_ACCEL]) : Vector2();
 			//apply radial acceleration
 			Vector2 org = emission_xform[2];
 			Vector2 diff = pos - org;
@@ -834,7 +906,7 @@ void CPUParticles2D::_particles_process(float p_delta) {
 			Vector2 yx = Vector2(diff.y, diff.x);
 			force += yx.length() > 0.0 ? (yx * Vector2(-1.0, 1.0)).normalized() * ((parameters[PARAM_TANGENTIAL_ACCEL] + tex_tangential_accel) * Math::lerp((real_t)1.0, rand_from_seed(alt_seed), randomness[PARAM_TANGENTIAL_ACCEL])) : Vector2();
 			//apply attractor forces
-			p.velocity += force * local_delta;
+			velocity += force * local_delta;
 			//orbit velocity
 			real_t orbit_amount = (parameters[PARAM_ORBIT_VELOCITY] + tex_orbit_velocity) * Math::lerp((real_t)1.0, rand_from_seed(alt_seed), randomness[PARAM_ORBIT_VELOCITY]);
 			if (orbit_amount != 0.0) {
@@ -842,21 +914,21 @@ void CPUParticles2D::_particles_process(float p_delta) {
 				// Not sure why the ParticlesMaterial code uses a clockwise rotation matrix,
 				// but we use -ang here to reproduce its behavior.
 				Transform2D rot = Transform2D(-ang, Vector2());
-				p.transform[2] -= diff;
-				p.transform[2] += rot.basis_xform(diff);
+				origin -= diff;
+				origin += rot.basis_xform(diff);
 			}
 			if (curve_parameters[PARAM_INITIAL_LINEAR_VELOCITY].is_valid()) {
-				p.velocity = p.velocity.normalized() * tex_linear_velocity;
+				velocity = velocity.normalized() * tex_linear_velocity;
 			}
 
 			if (parameters[PARAM_DAMPING] + tex_damping > 0.0) {
-				real_t v = p.velocity.length();
+				real_t v = velocity.length();
 				real_t damp = (parameters[PARAM_DAMPING] + tex_damping) * Math::lerp((real_t)1.0, rand_from_seed(alt_seed), randomness[PARAM_DAMPING]);
 				v -= damp * local_delta;
 				if (v < 0.0) {
-					p.velocity = Vector2();
+					velocity = Vector2();
 				} else {
-					p.velocity = p.velocity.normalized() * v;
+					velocity = velocity.normalized() * v;
 				}
 			}
 			real_t base_angle = (parameters[PARAM_ANGLE] + tex_angle) * Math::lerp((real_t)1.0, p.angle_rand, randomness[PARAM_ANGLE]);
@@ -907,14 +979,14 @@ void CPUParticles2D::_particles_process(float p_delta) {
 		p.color *= p.base_color;
 
 		if (particle_flags[PARTICLE_FLAG_ALIGN_Y_TO_VELOCITY]) {
-			if (p.velocity.length() > 0.0) {
-				p.transform.elements[1] = p.velocity.normalized();
-				p.transform.elements[0] = p.transform.elements[1].orthogonal();
+			if (velocity.length() > 0.0) {
+				p.basis.elements[1] = velocity.normalized();
+				p.basis.elements[0] = p.basis.elements[1].orthogonal();
 			}
 
 		} else {
-			p.transform.elements[0] = Vector2(Math::cos(p.rotation), -Math::sin(p.rotation));
-			p.transform.elements[1] = Vector2(Math::sin(p.rotation), Math::cos(p.rotation));
+			p.basis.elements[0] = Vector2(Math::cos(p.rotation), -Math::sin(p.rotation));
+			p.basis.elements[1] = Vector2(Math::sin(p.rotation), Math::cos(p.rotation));
 		}
 
 		//scale by scale
@@ -923,10 +995,37 @@ void CPUParticles2D::_particles_process(float p_delta) {
 			base_scale = 0.000001;
 		}
 
-		p.transform.elements[0] *= base_scale;
-		p.transform.elements[1] *= base_scale;
+		p.basis.elements[0] *= base_scale;
+		p.basis.elements[1] *= base_scale;
+
+		px[i] = origin.x;
+		py[i] = origin.y;
+		vx[i] = velocity.x;
+		vy[i] = velocity.y;
+		step[i] = local_delta;
+	}
+
+	_integrate_particles(from, to);
+}
+
+void CPUParticles2D::_integrate_particles(int p_from, int p_to) {
+	real_t *px = particle_position[0].ptr();
+	real_t *py = particle_position[1].ptr();
+	const real_t *vx = particle_velocity[0].ptr();
+	const real_t *vy = particle_velocity[1].ptr();
+	const float *step = particle_step.ptr();
 
-		p.transform[2] += p.velocity * local_delta;
+	int i = p_from;
+#if defined(CPU_PARTICLES_2D_SSE2)
+	for (; i + 4 <= p_to; i += 4) {
+		const __m128 dt = _mm_loadu_ps(step + i);
+		_mm_storeu_ps(px + i, _mm_add_ps(_mm_loadu_ps(px + i), _mm_mul_ps(_mm_loadu_ps(vx + i), dt)));
+		_mm_storeu_ps(py + i, _mm_add_ps(_mm_loadu_ps(py + i), _mm_mul_ps(_mm_loadu_ps(vy + i), dt)));
+	}
+#endif
+	for (; i < p_to; i++) {
+		px[i] += vx[i] * step[i];
+		py[i] += vy[i] * step[i];
 	}
 }
 
@@ -940,7 +1039,6 @@ void CPUParticles2D::_update_particle_data_buffer() {
 
 	float *w = particle_data.ptrw();
 	const Particle *r = particles.ptr();
-	float *ptr = w;
 
 	if (draw_order != DRAW_ORDER_INDEX) {
 		ow = particle_order.ptrw();
@@ -956,10 +1054,36 @@ void CPUParticles2D::_update_particle_data_buffer() {
 		}
 	}
 
-	for (int i = 0; i < pc; i++) {
+	DataChunks chunks;
+	chunks.order = order;
+	chunks.data = w;
+
+	uint32_t chunk_count = (pc + PROCESS_CHUNK_SIZE - 1) / PROCESS_CHUNK_SIZE;
+	ThreadWorkPool *pool = _get_chunk_work_pool(chunk_count);
+	if (pool) {
+		pool->do_work(chunk_count, this, &CPUParticles2D::_update_particle_data_chunk, &chunks);
+	} else {
+		for (uint32_t i = 0; i < chunk_count; i++) {
+			_update_particle_data_chunk(i, &chunks);
+		}
+	}
+}
+
+void CPUParticles2D::_update_particle_data_chunk(uint32_t p_chunk, const DataChunks *p_chunks) {
+	int pc = particles.size();
+	const Particle *r = particles.ptr();
+	const real_t *px = particle_position[0].ptr();
+	const real_t *py = particle_position[1].ptr();
+	const int *order = p_chunks->order;
+
+	int from = p_chunk * PROCESS_CHUNK_SIZE;
+	int to = MIN(from + PROCESS_CHUNK_SIZE, pc);
+	float *ptr = p_chunks->data + from * 16;
+
+	for (int i = from; i < to; i++) {
 		int idx = order ? order[i] : i;
 
-		Transform2D t = r[idx].transform;
+		Transform2D t(r[idx].basis.elements[0], r[idx].basis.elements[1], Vector2(px[idx], py[idx]));
 
 		if (!local_coords) {
 			t = inv_emission_transform * t;
@@ -1064,10 +1188,12 @@ void CPUParticles2D::_notification(int p_what) {
 
 				float *w = particle_data.ptrw();
 				const Particle *r = particles.ptr();
+				const real_t *px = particle_position[0].ptr();
+				const real_t *py = particle_position[1].ptr();
 				float *ptr = w;
 
 				for (int i = 0; i < pc; i++) {
-					Transform2D t = inv_emission_transform * r[i].transform;
+					Transform2D t = inv_emission_transform * Transform2D(r[i].basis.elements[0], r[i].basis.elements[1], Vector2(px[i], py[i]));
 
 					if (r[i].active) {
 						ptr[0] = t.elements[0][0];
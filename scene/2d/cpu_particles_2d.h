@@ -31,10 +31,13 @@
 #ifndef CPU_PARTICLES_2D_H
 #define CPU_PARTICLES_2D_H
 
+#include "core/templates/local_vector.h"
 #include "core/templates/rid.h"
 #include "scene/2d/node_2d.h"
 #include "scene/resources/texture.h"
 
+class ThreadWorkPool;
+
 class CPUParticles2D : public Node2D {
 private:
 	GDCLASS(CPUParticles2D, Node2D);
@@ -81,11 +84,10 @@ private:
 	bool emitting = false;
 
 	struct Particle {
-		Transform2D transform;
+		Transform2D basis; // The origin stays zero, see particle_position.
 		Color color;
 		float custom[4] = {};
 		real_t rotation = 0.0;
-		Vector2 velocity;
 		bool active = false;
 		real_t angle_rand = 0.0;
 		real_t scale_rand = 0.0;
@@ -111,6 +113,13 @@ private:
 	Vector<float> particle_data;
 	Vector<int> particle_order;
 
+	// Positions and velocities are kept out of Particle, one array per axis, so integration can
+	// move several particles per instruction. The step is how far in time each particle moves
+	// this frame, 0 for those that stay put.
+	LocalVector<real_t> particle_position[2];
+	LocalVector<real_t> particle_velocity[2];
+	LocalVector<float> particle_step;
+
 	struct SortLifetime {
 		const Particle *particles = nullptr;
 
@@ -120,10 +129,10 @@ private:
 	};
 
 	struct SortAxis {
-		const Particle *particles = nullptr;
+		const real_t *position[2] = {};
 		Vector2 axis;
 		bool operator()(int p_a, int p_b) const {
-			return axis.dot(particles[p_a].transform[2]) < axis.dot(particles[p_b].transform[2]);
+			return axis.dot(Vector2(position[0][p_a], position[1][p_a])) < axis.dot(Vector2(position[0][p_b], position[1][p_b]));
 		}
 	};
 
@@ -171,9 +180,35 @@ private:
 
 	Vector2 gravity = Vector2(0, 980);
 
+	// Particles are simulated and packed in chunks, which run on the scene tree worker threads when there are several.
+	// Every chunk draws from its own random stream, so the result doesn't depend on how chunks are distributed.
+	enum {
+		PROCESS_CHUNK_SIZE = 256
+	};
+
+	struct ProcessFrame {
+		float delta = 0.0;
+		float prev_time = 0.0;
+		float system_phase = 0.0;
+		uint64_t seed = 0;
+		Transform2D emission_xform;
+		Transform2D velocity_xform;
+	};
+
+	ProcessFrame process_frame;
+
+	struct DataChunks {
+		const int *order = nullptr;
+		float *data = nullptr;
+	};
+
+	ThreadWorkPool *_get_chunk_work_pool(uint32_t p_chunk_count) const;
 	void _update_internal();
 	void _particles_process(float p_delta);
+	void _process_particle_chunk(uint32_t p_chunk, Particle *p_particles);
+	void _integrate_particles(int p_from, int p_to);
 	void _update_particle_data_buffer();
+	void _update_particle_data_chunk(uint32_t p_chunk, const DataChunks *p_chunks);
 
 	Mutex update_mutex;
 
@@ -279,6 +314,9 @@ public:
 
 	void restart();
 
+	// The instance buffer of the last update, 16 floats per particle.
+	Vector<float> get_particle_data() const;
+
 	void convert_from_particles(Node *p_particles);
 
 	CPUParticles2D();
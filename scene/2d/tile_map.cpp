@@ -262,6 +262,10 @@ void TileMap::_notification(int p_what) {
 		case NOTIFICATION_EXIT_TREE: {
 			_clear_quadrants();
 		} break;
+		case NOTIFICATION_INTERNAL_PROCESS: {
+			// Continue the update of the quadrants left over by the time budget.
+			update_dirty_quadrants();
+		} break;
 	}
 
 	// Transfers the notification to tileset plugins.
@@ -334,41 +338,57 @@ TileMap::VisibilityMode TileMap::get_navigation_visibility_mode() {
 	return show_navigation;
 }
 
+void TileMap::set_update_time_budget(float p_msec) {
+	ERR_FAIL_COND_MSG(p_msec < 0, "The update time budget cannot be negative.");
+	update_time_budget = p_msec;
+}
+
+float TileMap::get_update_time_budget() const {
+	return update_time_budget;
+}
+
 void TileMap::set_y_sort_enabled(bool p_enable) {
 	Node2D::set_y_sort_enabled(p_enable);
 	_recreate_quadrants();
 	emit_signal("changed");
 }
 
-void TileMap::update_dirty_quadrants() {
-	if (!pending_update) {
-		return;
-	}
-	if (!is_inside_tree() || !tile_set.is_valid()) {
-		pending_update = false;
-		return;
+void TileMap::_prepare_dirty_quadrant(TileMapQuadrant *p_quadrant) {
+	_update_quadrant_cells(p_quadrant);
+	for (int i = 0; i < tile_set->get_tile_set_atlas_plugins().size(); i++) {
+		tile_set->get_tile_set_atlas_plugins()[i]->prepare_dirty_quadrant(this, p_quadrant);
 	}
+}
 
-	// Update the coords cache.
-	for (SelfList<TileMapQuadrant> *q = dirty_quadrant_list.first(); q; q = q->next()) {
-		q->self()->map_to_world.clear();
-		q->self()->world_to_map.clear();
-		for (Set<Vector2i>::Element *E = q->self()->cells.front(); E; E = E->next()) {
-			Vector2i pk = E->get();
-			Vector2i pk_world_coords = map_to_world(pk);
-			q->self()->map_to_world[pk] = pk_world_coords;
-			q->self()->world_to_map[pk_world_coords] = pk;
+void TileMap::_prepare_dirty_quadrant_threaded(uint32_t p_index, TileMapQuadrant **p_quadrants) {
+	_prepare_dirty_quadrant(p_quadrants[p_index]);
+}
+
+void TileMap::_update_dirty_quadrant_batch(SelfList<TileMapQuadrant>::List &r_batch) {
+	// Sort the cells and build what the plugins send to the servers.
+	// This only reads the cells and the tileset, so it can be spread over the worker threads.
+	LocalVector<TileMapQuadrant *> quadrants;
+	for (SelfList<TileMapQuadrant> *q = r_batch.first(); q; q = q->next()) {
+		quadrants.push_back(q->self());
+	}
+	ThreadWorkPool *pool = quadrants.size() > 1 ? get_tree()->get_thread_work_pool_for_main_thread() : nullptr;
+	if (pool) {
+		pool->do_work(quadrants.size(), this, &TileMap::_prepare_dirty_quadrant_threaded, quadrants.ptr());
+	} else {
+		for (uint32_t i = 0; i < quadrants.size(); i++) {
+			_prepare_dirty_quadrant(quadrants[i]);
 		}
 	}
 
 	// Call the update_dirty_quadrant method on plugins.
+	// They talk to the servers, so they run on the main thread.
 	for (int i = 0; i < tile_set->get_tile_set_atlas_plugins().size(); i++) {
-		tile_set->get_tile_set_atlas_plugins()[i]->update_dirty_quadrants(this, dirty_quadrant_list);
+		tile_set->get_tile_set_atlas_plugins()[i]->update_dirty_quadrants(this, r_batch);
 	}
 
 	// Redraw the debug canvas_items.
 	RenderingServer *rs = RenderingServer::get_singleton();
-	for (SelfList<TileMapQuadrant> *q = dirty_quadrant_list.first(); q; q = q->next()) {
+	for (SelfList<TileMapQuadrant> *q = r_batch.first(); q; q = q->next()) {
 		rs->canvas_item_clear(q->self()->debug_canvas_item);
 		Transform2D xform;
 		xform.set_origin(map_to_world(q->self()->coords * get_effective_quadrant_size()));
@@ -379,13 +399,48 @@ void TileMap::update_dirty_quadrants() {
 	}
 
 	// Clear the list
-	while (dirty_quadrant_list.first()) {
-		dirty_quadrant_list.remove(dirty_quadrant_list.first());
+	while (r_batch.first()) {
+		r_batch.remove(r_batch.first());
 	}
+}
 
-	pending_update = false;
+void TileMap::update_dirty_quadrants() {
+	if (!pending_update) {
+		return;
+	}
+	if (!is_inside_tree() || !tile_set.is_valid()) {
+		pending_update = false;
+		set_process_internal(false);
+		return;
+	}
+
+	if (update_time_budget <= 0) {
+		_update_dirty_quadrant_batch(dirty_quadrant_list);
+	} else {
+		// Update the quadrants in small batches, until the time budget is spent.
+		// Whatever is left is updated on the next frames.
+		const int batch_size = 8;
+		const uint64_t budget_usec = uint64_t(update_time_budget * 1000.0);
+		const uint64_t begin_usec = OS::get_singleton()->get_ticks_usec();
+		SelfList<TileMapQuadrant>::List batch;
+		while (dirty_quadrant_list.first()) {
+			for (int i = 0; i < batch_size && dirty_quadrant_list.first(); i++) {
+				SelfList<TileMapQuadrant> *q = dirty_quadrant_list.first();
+				dirty_quadrant_list.remove(q);
+				batch.add_last(q);
+			}
+			_update_dirty_quadrant_batch(batch);
+
+			if (OS::get_singleton()->get_ticks_usec() - begin_usec >= budget_usec) {
+				break;
+			}
+		}
+	}
 
 	_recompute_rect_cache();
+
+	pending_update = dirty_quadrant_list.first() != nullptr;
+	set_process_internal(pending_update);
 }
 
 void TileMap::_recompute_rect_cache() {
@@ -397,14 +452,16 @@ void TileMap::_recompute_rect_cache() {
 	}
 
 	Rect2 r_total;
-	for (Map<Vector2i, TileMapQuadrant>::Element *E = quadrant_map.front(); E; E = E->next()) {
+	bool first = true;
+	for (const Vector2i *E = quadrant_map.next(nullptr); E; E = quadrant_map.next(E)) {
 		Rect2 r;
-		r.position = map_to_world(E->key() * get_effective_quadrant_size());
-		r.expand_to(map_to_world((E->key() + Vector2i(1, 0)) * get_effective_quadrant_size()));
-		r.expand_to(map_to_world((E->key() + Vector2i(1, 1)) * get_effective_quadrant_size()));
-		r.expand_to(map_to_world((E->key() + Vector2i(0, 1)) * get_effective_quadrant_size()));
-		if (E == quadrant_map.front()) {
+		r.position = map_to_world(*E * get_effective_quadrant_size());
+		r.expand_to(map_to_world((*E + Vector2i(1, 0)) * get_effective_quadrant_size()));
+		r.expand_to(map_to_world((*E + Vector2i(1, 1)) * get_effective_quadrant_size()));
+		r.expand_to(map_to_world((*E + Vector2i(0, 1)) * get_effective_quadrant_size()));
+		if (first) {
 			r_total = r;
+			first = false;
 		} else {
 			r_total = r_total.merge(r);
 		}
@@ -418,8 +475,8 @@ void TileMap::_recompute_rect_cache() {
 #endif
 }
 
-Map<Vector2i, TileMapQuadrant>::Element *TileMap::_create_quadrant(const Vector2i &p_qk) {
-	TileMapQuadrant q;
+TileMapQuadrant *TileMap::_create_quadrant(const Vector2i &p_qk) {
+	TileMapQuadrant &q = quadrant_map.set(p_qk, TileMapQuadrant())->value();
 	q.coords = p_qk;
 
 	rect_cache_dirty = true;
@@ -437,12 +494,12 @@ Map<Vector2i, TileMapQuadrant>::Element *TileMap::_create_quadrant(const Vector2
 		}
 	}
 
-	return quadrant_map.insert(p_qk, q);
+	return &q;
 }
 
-void TileMap::_erase_quadrant(Map<Vector2i, TileMapQuadrant>::Element *Q) {
+void TileMap::_erase_quadrant(TileMapQuadrant *p_quadrant) {
 	// Remove a quadrant.
-	TileMapQuadrant *q = &(Q->get());
+	TileMapQuadrant *q = p_quadrant;
 
 	// Call the cleanup_quadrant method on plugins.
 	if (tile_set.is_valid()) {
@@ -460,15 +517,16 @@ void TileMap::_erase_quadrant(Map<Vector2i, TileMapQuadrant>::Element *Q) {
 	RenderingServer *rs = RenderingServer::get_singleton();
 	rs->free(q->debug_canvas_item);
 
-	quadrant_map.erase(Q);
+	quadrant_map.erase(q->coords);
 	rect_cache_dirty = true;
 }
 
 void TileMap::_make_all_quadrants_dirty(bool p_update) {
 	// Make all quandrants dirty, then trigger an update later.
-	for (Map<Vector2i, TileMapQuadrant>::Element *E = quadrant_map.front(); E; E = E->next()) {
-		if (!E->value().dirty_list_element.in_list()) {
-			dirty_quadrant_list.add(&E->value().dirty_list_element);
+	for (const Vector2i *E = quadrant_map.next(nullptr); E; E = quadrant_map.next(E)) {
+		TileMapQuadrant &q = quadrant_map[*E];
+		if (!q.dirty_list_element.in_list()) {
+			dirty_quadrant_list.add(&q.dirty_list_element);
 		}
 	}
 
@@ -484,11 +542,10 @@ void TileMap::_make_all_quadrants_dirty(bool p_update) {
 	}
 }
 
-void TileMap::_make_quadrant_dirty(Map<Vector2i, TileMapQuadrant>::Element *Q, bool p_update) {
+void TileMap::_make_quadrant_dirty(TileMapQuadrant *p_quadrant, bool p_update) {
 	// Make the given quadrant dirty, then trigger an update later.
-	TileMapQuadrant &q = Q->get();
-	if (!q.dirty_list_element.in_list()) {
-		dirty_quadrant_list.add(&q.dirty_list_element);
+	if (!p_quadrant->dirty_list_element.in_list()) {
+		dirty_quadrant_list.add(&p_quadrant->dirty_list_element);
 	}
 
 	if (pending_update) {
@@ -504,112 +561,263 @@ void TileMap::_make_quadrant_dirty(Map<Vector2i, TileMapQuadrant>::Element *Q, b
 	}
 }
 
-void TileMap::set_cell(const Vector2i &p_coords, int p_source_id, const Vector2i p_atlas_coords, int p_alternative_tile) {
-	// Set the current cell tile (using integer position).
-	Vector2i pk(p_coords);
-	Map<Vector2i, TileMapCell>::Element *E = tile_map.find(pk);
-
-	int source_id = p_source_id;
-	Vector2i atlas_coords = p_atlas_coords;
-	int alternative_tile = p_alternative_tile;
-
-	if ((source_id == -1 || atlas_coords == TileSetSource::INVALID_ATLAS_COORDS || alternative_tile == TileSetSource::INVALID_TILE_ALTERNATIVE) &&
-			(source_id != -1 || atlas_coords != TileSetSource::INVALID_ATLAS_COORDS || alternative_tile != TileSetSource::INVALID_TILE_ALTERNATIVE)) {
-		WARN_PRINT("Setting a cell a cell as empty requires both source_id, atlas_coord and alternative_tile to be set to their respective \"invalid\" values. Values were thus changes accordingly.");
-		source_id = -1;
-		atlas_coords = TileSetSource::INVALID_ATLAS_COORDS;
-		alternative_tile = TileSetSource::INVALID_TILE_ALTERNATIVE;
+const TileMapCell *TileMap::_get_cell_ptr(const Vector2i &p_coords) const {
+	CellChunk *const *chunk = cell_chunks.getptr(_coords_to_chunk_coords(p_coords));
+	if (!chunk) {
+		return nullptr;
 	}
+	const TileMapCell *cell = &(*chunk)->cells[_coords_to_chunk_index(p_coords)];
+	return cell->source_id == -1 ? nullptr : cell;
+}
 
-	if (!E && source_id == -1) {
-		return; // Nothing to do, the tile is already empty.
+void TileMap::_get_cells_in_rect(const Rect2i &p_rect, LocalVector<Vector2i> &r_cells) const {
+	// Visit the chunks overlapping the rect, instead of looking up every cell.
+	const Vector2i begin = p_rect.position;
+	const Vector2i end = p_rect.position + p_rect.size;
+	const Vector2i chunk_begin = _coords_to_chunk_coords(begin);
+	const Vector2i chunk_end = _coords_to_chunk_coords(end - Vector2i(1, 1));
+	for (int chunk_y = chunk_begin.y; chunk_y <= chunk_end.y; chunk_y++) {
+		for (int chunk_x = chunk_begin.x; chunk_x <= chunk_end.x; chunk_x++) {
+			CellChunk *const *chunk = cell_chunks.getptr(Vector2i(chunk_x, chunk_y));
+			if (!chunk) {
+				continue;
+			}
+			const int from_x = MAX(begin.x, chunk_x * CELL_CHUNK_SIZE);
+			const int to_x = MIN(end.x, (chunk_x + 1) * CELL_CHUNK_SIZE);
+			const int from_y = MAX(begin.y, chunk_y * CELL_CHUNK_SIZE);
+			const int to_y = MIN(end.y, (chunk_y + 1) * CELL_CHUNK_SIZE);
+			for (int y = from_y; y < to_y; y++) {
+				const TileMapCell *row = &(*chunk)->cells[(y & CELL_CHUNK_MASK) << CELL_CHUNK_SHIFT];
+				for (int x = from_x; x < to_x; x++) {
+					if (row[x & CELL_CHUNK_MASK].source_id != -1) {
+						r_cells.push_back(Vector2i(x, y));
+					}
+				}
+			}
+		}
 	}
+}
 
-	// Get the quadrant
-	Vector2i qk = _coords_to_quadrant_coords(pk);
+bool TileMap::_store_cell(const Vector2i &p_coords, const TileMapCell &p_cell, int &r_cell_count_change) {
+	r_cell_count_change = 0;
 
-	Map<Vector2i, TileMapQuadrant>::Element *Q = quadrant_map.find(qk);
+	const Vector2i chunk_coords = _coords_to_chunk_coords(p_coords);
+	CellChunk **chunk_ptr = cell_chunks.getptr(chunk_coords);
+	CellChunk *chunk = chunk_ptr ? *chunk_ptr : nullptr;
 
-	if (source_id == -1) {
-		// Erase existing cell in the tile map.
-		tile_map.erase(pk);
+	if (p_cell.source_id == -1) {
+		if (!chunk) {
+			return false; // Nothing to do, the tile is already empty.
+		}
+		TileMapCell &cell = chunk->cells[_coords_to_chunk_index(p_coords)];
+		if (cell.source_id == -1) {
+			return false;
+		}
 
-		// Erase existing cell in the quadrant.
-		ERR_FAIL_COND(!Q);
-		TileMapQuadrant &q = Q->get();
+		// Erase the cell, and its chunk once empty.
+		cell = TileMapCell();
+		r_cell_count_change = -1;
+		cell_count--;
+		chunk->used--;
+		if (chunk->used == 0) {
+			memdelete(chunk);
+			cell_chunks.erase(chunk_coords);
+		}
+		return true;
+	}
 
-		q.cells.erase(pk);
+	if (!chunk) {
+		chunk = memnew(CellChunk);
+		cell_chunks.set(chunk_coords, chunk);
+	}
+	TileMapCell &cell = chunk->cells[_coords_to_chunk_index(p_coords)];
+	if (cell.source_id == -1) {
+		r_cell_count_change = 1;
+		cell_count++;
+		chunk->used++;
+	} else if (!(cell != p_cell)) {
+		return false; // Nothing changed.
+	}
+	cell = p_cell;
+	return true;
+}
 
-		// Remove or make the quadrant dirty.
-		if (q.cells.size() == 0) {
-			_erase_quadrant(Q);
-		} else {
-			_make_quadrant_dirty(Q);
-		}
+void TileMap::_clear_cells() {
+	for (const Vector2i *E = cell_chunks.next(nullptr); E; E = cell_chunks.next(E)) {
+		memdelete(cell_chunks[*E]);
+	}
+	cell_chunks.clear();
+	cell_count = 0;
+}
 
-		used_size_cache_dirty = true;
-	} else {
-		if (!E) {
-			// Insert a new cell in the tile map.
-			E = tile_map.insert(pk, TileMapCell());
+void TileMap::_update_cell_quadrant(const Vector2i &p_coords, int p_cell_count_change) {
+	// Quadrants only exist inside the tree, they are recreated when entering it.
+	if (!is_inside_tree()) {
+		return;
+	}
 
-			// Create a new quadrant if needed, then insert the cell if needed.
-			if (!Q) {
-				Q = _create_quadrant(qk);
-			}
-			TileMapQuadrant &q = Q->get();
-			q.cells.insert(pk);
+	Vector2i qk = _coords_to_quadrant_coords(p_coords);
+	TileMapQuadrant *q = quadrant_map.getptr(qk);
+	if (!q) {
+		ERR_FAIL_COND(p_cell_count_change <= 0); // TileMapQuadrant should exist...
+		q = _create_quadrant(qk);
+	}
 
-		} else {
-			ERR_FAIL_COND(!Q); // TileMapQuadrant should exist...
+	// Remove or make the quadrant dirty.
+	q->cell_count += p_cell_count_change;
+	if (q->cell_count == 0) {
+		_erase_quadrant(q);
+	} else {
+		_make_quadrant_dirty(q);
+	}
+}
 
-			if (E->get().source_id == source_id && E->get().get_atlas_coords() == atlas_coords && E->get().alternative_tile == alternative_tile) {
-				return; // Nothing changed.
-			}
+void TileMap::_update_quadrant_cells(TileMapQuadrant *p_quadrant) {
+	struct CellWorldCoords {
+		Vector2i world;
+		Vector2i coords;
+	};
+	struct CellWorldCoordsComparator {
+		_ALWAYS_INLINE_ bool operator()(const CellWorldCoords &p_a, const CellWorldCoords &p_b) const {
+			return TileMapQuadrant::CoordsWorldComparator()(p_a.world, p_b.world);
 		}
+	};
 
-		TileMapCell &c = E->get();
+	int size = get_effective_quadrant_size();
+	p_quadrant->cells.clear();
+	_get_cells_in_rect(Rect2i(p_quadrant->coords * size, Vector2i(size, size)), p_quadrant->cells);
 
-		c.source_id = source_id;
-		c.set_atlas_coords(atlas_coords);
-		c.alternative_tile = alternative_tile;
+	LocalVector<CellWorldCoords> sorted;
+	sorted.resize(p_quadrant->cells.size());
+	for (uint32_t i = 0; i < sorted.size(); i++) {
+		sorted[i].world = map_to_world(p_quadrant->cells[i]);
+		sorted[i].coords = p_quadrant->cells[i];
+	}
+	sorted.sort_custom<CellWorldCoordsComparator>();
+	for (uint32_t i = 0; i < sorted.size(); i++) {
+		p_quadrant->cells[i] = sorted[i].coords;
+	}
+}
+
+void TileMap::set_cell(const Vector2i &p_coords, int p_source_id, const Vector2i p_atlas_coords, int p_alternative_tile) {
+	// Set the current cell tile (using integer position).
+	int source_id = p_source_id;
+	Vector2i atlas_coords = p_atlas_coords;
+	int alternative_tile = p_alternative_tile;
+
+	if ((source_id == -1 || atlas_coords == TileSetSource::INVALID_ATLAS_COORDS || alternative_tile == TileSetSource::INVALID_TILE_ALTERNATIVE) &&
+			(source_id != -1 || atlas_coords != TileSetSource::INVALID_ATLAS_COORDS || alternative_tile != TileSetSource::INVALID_TILE_ALTERNATIVE)) {
+		WARN_PRINT("Setting a cell a cell as empty requires both source_id, atlas_coord and alternative_tile to be set to their respective \"invalid\" values. Values were thus changes accordingly.");
+		source_id = -1;
+		atlas_coords = TileSetSource::INVALID_ATLAS_COORDS;
+		alternative_tile = TileSetSource::INVALID_TILE_ALTERNATIVE;
+	}
 
-		_make_quadrant_dirty(Q);
+	int cell_count_change;
+	if (_store_cell(p_coords, TileMapCell(source_id, atlas_coords, alternative_tile), cell_count_change)) {
+		_update_cell_quadrant(p_coords, cell_count_change);
 		used_size_cache_dirty = true;
 	}
 }
 
 int TileMap::get_cell_source_id(const Vector2i &p_coords) const {
 	// Get a cell source id from position
-	const Map<Vector2i, TileMapCell>::Element *E = tile_map.find(p_coords);
+	const TileMapCell *cell = _get_cell_ptr(p_coords);
 
-	if (!E) {
+	if (!cell) {
 		return -1;
 	}
 
-	return E->get().source_id;
+	return cell->source_id;
 }
 
 Vector2i TileMap::get_cell_atlas_coords(const Vector2i &p_coords) const {
 	// Get a cell source id from position
-	const Map<Vector2i, TileMapCell>::Element *E = tile_map.find(p_coords);
+	const TileMapCell *cell = _get_cell_ptr(p_coords);
 
-	if (!E) {
+	if (!cell) {
 		return TileSetSource::INVALID_ATLAS_COORDS;
 	}
 
-	return E->get().get_atlas_coords();
+	return cell->get_atlas_coords();
 }
 
 int TileMap::get_cell_alternative_tile(const Vector2i &p_coords) const {
 	// Get a cell source id from position
-	const Map<Vector2i, TileMapCell>::Element *E = tile_map.find(p_coords);
+	const TileMapCell *cell = _get_cell_ptr(p_coords);
 
-	if (!E) {
+	if (!cell) {
 		return TileSetSource::INVALID_TILE_ALTERNATIVE;
 	}
 
-	return E->get().alternative_tile;
+	return cell->alternative_tile;
+}
+
+void TileMap::fill_rect(const Rect2i &p_rect, int p_source_id, const Vector2i p_atlas_coords, int p_alternative_tile) {
+	ERR_FAIL_COND(p_rect.size.x < 0 || p_rect.size.y < 0);
+
+	TileMapCell cell(p_source_id, p_atlas_coords, p_alternative_tile);
+	if (p_source_id == -1 || p_atlas_coords == TileSetSource::INVALID_ATLAS_COORDS || p_alternative_tile == TileSetSource::INVALID_TILE_ALTERNATIVE) {
+		cell = TileMapCell();
+	}
+
+	bool changed = false;
+	for (int y = p_rect.position.y; y < p_rect.position.y + p_rect.size.y; y++) {
+		for (int x = p_rect.position.x; x < p_rect.position.x + p_rect.size.x; x++) {
+			int cell_count_change;
+			if (_store_cell(Vector2i(x, y), cell, cell_count_change)) {
+				_update_cell_quadrant(Vector2i(x, y), cell_count_change);
+				changed = true;
+			}
+		}
+	}
+	if (changed) {
+		used_size_cache_dirty = true;
+	}
+}
+
+void TileMap::set_cell_block(const Rect2i &p_rect, const PackedInt32Array &p_cells) {
+	ERR_FAIL_COND(p_rect.size.x < 0 || p_rect.size.y < 0);
+	ERR_FAIL_COND_MSG(p_cells.size() != p_rect.size.x * p_rect.size.y * 4, "The cell block must have 4 integers per cell of the rect.");
+
+	const int32_t *r = p_cells.ptr();
+	bool changed = false;
+	for (int y = p_rect.position.y; y < p_rect.position.y + p_rect.size.y; y++) {
+		for (int x = p_rect.position.x; x < p_rect.position.x + p_rect.size.x; x++, r += 4) {
+			TileMapCell cell(r[0], Vector2i(r[1], r[2]), r[3]);
+			if (r[0] == -1 || Vector2i(r[1], r[2]) == TileSetSource::INVALID_ATLAS_COORDS || r[3] == TileSetSource::INVALID_TILE_ALTERNATIVE) {
+				cell = TileMapCell();
+			}
+
+			int cell_count_change;
+			if (_store_cell(Vector2i(x, y), cell, cell_count_change)) {
+				_update_cell_quadrant(Vector2i(x, y), cell_count_change);
+				changed = true;
+			}
+		}
+	}
+	if (changed) {
+		used_size_cache_dirty = true;
+	}
+}
+
+PackedInt32Array TileMap::get_cell_block(const Rect2i &p_rect) const {
+	ERR_FAIL_COND_V(p_rect.size.x < 0 || p_rect.size.y < 0, PackedInt32Array());
+
+	PackedInt32Array cells;
+	cells.resize(p_rect.size.x * p_rect.size.y * 4);
+	int32_t *w = cells.ptrw();
+	for (int y = p_rect.position.y; y < p_rect.position.y + p_rect.size.y; y++) {
+		for (int x = p_rect.position.x; x < p_rect.position.x + p_rect.size.x; x++, w += 4) {
+			const TileMapCell *cell = _get_cell_ptr(Vector2i(x, y));
+			const TileMapCell &c = cell ? *cell : TileMapCell();
+			w[0] = c.source_id;
+			w[1] = c.coord_x;
+			w[2] = c.coord_y;
+			w[3] = c.alternative_tile;
+		}
+	}
+	return cells;
 }
 
 TileMapPattern *TileMap::get_pattern(TypedArray<Vector2i> p_coords_array) {
@@ -698,29 +906,37 @@ void TileMap::set_pattern(Vector2i p_position, const TileMapPattern *p_pattern)
 }
 
 TileMapCell TileMap::get_cell(const Vector2i &p_coords) const {
-	if (!tile_map.has(p_coords)) {
+	const TileMapCell *cell = _get_cell_ptr(p_coords);
+	if (!cell) {
 		return TileMapCell();
 	} else {
-		return tile_map.find(p_coords)->get();
+		return *cell;
 	}
 }
 
-Map<Vector2i, TileMapQuadrant> &TileMap::get_quadrant_map() {
+HashMap<Vector2i, TileMapQuadrant, TileMapQuadrant::CoordsHasher> &TileMap::get_quadrant_map() {
 	return quadrant_map;
 }
 
 void TileMap::fix_invalid_tiles() {
 	ERR_FAIL_COND_MSG(tile_set.is_null(), "Cannot fix invalid tiles if Tileset is not open.");
 
-	Set<Vector2i> coords;
-	for (Map<Vector2i, TileMapCell>::Element *E = tile_map.front(); E; E = E->next()) {
-		TileSetSource *source = *tile_set->get_source(E->get().source_id);
-		if (!source || !source->has_tile(E->get().get_atlas_coords()) || !source->has_alternative_tile(E->get().get_atlas_coords(), E->get().alternative_tile)) {
-			coords.insert(E->key());
+	LocalVector<Vector2i> coords;
+	for (const Vector2i *E = cell_chunks.next(nullptr); E; E = cell_chunks.next(E)) {
+		const CellChunk *chunk = cell_chunks[*E];
+		for (int i = 0; i < CELL_CHUNK_SIZE * CELL_CHUNK_SIZE; i++) {
+			const TileMapCell &c = chunk->cells[i];
+			if (c.source_id == -1) {
+				continue;
+			}
+			TileSetSource *source = *tile_set->get_source(c.source_id);
+			if (!source || !source->has_tile(c.get_atlas_coords()) || !source->has_alternative_tile(c.get_atlas_coords(), c.alternative_tile)) {
+				coords.push_back(Vector2i(E->x * CELL_CHUNK_SIZE + (i & CELL_CHUNK_MASK), E->y * CELL_CHUNK_SIZE + (i >> CELL_CHUNK_SHIFT)));
+			}
 		}
 	}
-	for (Set<Vector2i>::Element *E = coords.front(); E; E = E->next()) {
-		set_cell(E->get(), -1, TileSetSource::INVALID_ATLAS_COORDS, TileSetSource::INVALID_TILE_ALTERNATIVE);
+	for (uint32_t i = 0; i < coords.size(); i++) {
+		set_cell(coords[i], -1, TileSetSource::INVALID_ATLAS_COORDS, TileSetSource::INVALID_TILE_ALTERNATIVE);
 	}
 }
 
@@ -728,19 +944,27 @@ void TileMap::_recreate_quadrants() {
 	// Clear then recreate all quadrants.
 	_clear_quadrants();
 
-	for (Map<Vector2i, TileMapCell>::Element *E = tile_map.front(); E; E = E->next()) {
-		Vector2i qk = _coords_to_quadrant_coords(Vector2i(E->key().x, E->key().y));
-
-		Map<Vector2i, TileMapQuadrant>::Element *Q = quadrant_map.find(qk);
-		if (!Q) {
-			Q = _create_quadrant(qk);
-			dirty_quadrant_list.add(&Q->get().dirty_list_element);
-		}
+	// Quadrants only exist inside the tree.
+	if (!is_inside_tree()) {
+		return;
+	}
 
-		Vector2i pk = E->key();
-		Q->get().cells.insert(pk);
+	for (const Vector2i *E = cell_chunks.next(nullptr); E; E = cell_chunks.next(E)) {
+		const CellChunk *chunk = cell_chunks[*E];
+		for (int i = 0; i < CELL_CHUNK_SIZE * CELL_CHUNK_SIZE; i++) {
+			if (chunk->cells[i].source_id == -1) {
+				continue;
+			}
+			Vector2i pk(E->x * CELL_CHUNK_SIZE + (i & CELL_CHUNK_MASK), E->y * CELL_CHUNK_SIZE + (i >> CELL_CHUNK_SHIFT));
+			Vector2i qk = _coords_to_quadrant_coords(pk);
 
-		_make_quadrant_dirty(Q, false);
+			TileMapQuadrant *q = quadrant_map.getptr(qk);
+			if (!q) {
+				q = _create_quadrant(qk);
+				_make_quadrant_dirty(q, false);
+			}
+			q->cell_count++;
+		}
 	}
 
 	update_dirty_quadrants();
@@ -749,7 +973,7 @@ void TileMap::_recreate_quadrants() {
 void TileMap::_clear_quadrants() {
 	// Clear quadrants.
 	while (quadrant_map.size()) {
-		_erase_quadrant(quadrant_map.front());
+		_erase_quadrant(&quadrant_map[*quadrant_map.next(nullptr)]);
 	}
 
 	// Clear the dirty quadrants list.
@@ -761,7 +985,7 @@ void TileMap::_clear_quadrants() {
 void TileMap::clear() {
 	// Remove all tiles.
 	_clear_quadrants();
-	tile_map.clear();
+	_clear_cells();
 	used_size_cache_dirty = true;
 }
 
@@ -840,20 +1064,32 @@ void TileMap::_set_tile_data(const Vector<int> &p_data) {
 Vector<int> TileMap::_get_tile_data() const {
 	// Export tile data to raw format
 	Vector<int> data;
-	data.resize(tile_map.size() * 3);
+	data.resize(cell_count * 3);
 	int *w = data.ptrw();
 
-	// Save in highest format
+	// Save in highest format, sorted by coords so saving the same map gives the same data.
+	LocalVector<Vector2i> coords;
+	coords.reserve(cell_count);
+	for (const Vector2i *E = cell_chunks.next(nullptr); E; E = cell_chunks.next(E)) {
+		const CellChunk *chunk = cell_chunks[*E];
+		for (int i = 0; i < CELL_CHUNK_SIZE * CELL_CHUNK_SIZE; i++) {
+			if (chunk->cells[i].source_id != -1) {
+				coords.push_back(Vector2i(E->x * CELL_CHUNK_SIZE + (i & CELL_CHUNK_MASK), E->y * CELL_CHUNK_SIZE + (i >> CELL_CHUNK_SHIFT)));
+			}
+		}
+	}
+	coords.sort();
 
 	int idx = 0;
-	for (const Map<Vector2i, TileMapCell>::Element *E = tile_map.front(); E; E = E->next()) {
+	for (uint32_t i = 0; i < coords.size(); i++) {
+		const TileMapCell &c = *_get_cell_ptr(coords[i]);
 		uint8_t *ptr = (uint8_t *)&w[idx];
-		encode_uint16((int16_t)(E->key().x), &ptr[0]);
-		encode_uint16((int16_t)(E->key().y), &ptr[2]);
-		encode_uint16(E->get().source_id, &ptr[4]);
-		encode_uint16(E->get().coord_x, &ptr[6]);
-		encode_uint16(E->get().coord_y, &ptr[8]);
-		encode_uint16(E->get().alternative_tile, &ptr[10]);
+		encode_uint16((int16_t)(coords[i].x), &ptr[0]);
+		encode_uint16((int16_t)(coords[i].y), &ptr[2]);
+		encode_uint16(c.source_id, &ptr[4]);
+		encode_uint16(c.coord_x, &ptr[6]);
+		encode_uint16(c.coord_y, &ptr[8]);
+		encode_uint16(c.alternative_tile, &ptr[10]);
 		idx += 3;
 	}
 
@@ -1530,11 +1766,15 @@ Vector2i TileMap::get_neighbor_cell(const Vector2i &p_coords, TileSet::CellNeigh
 TypedArray<Vector2i> TileMap::get_used_cells() const {
 	// Returns the cells used in the tilemap.
 	TypedArray<Vector2i> a;
-	a.resize(tile_map.size());
-	int i = 0;
-	for (Map<Vector2i, TileMapCell>::Element *E = tile_map.front(); E; E = E->next()) {
-		Vector2i p(E->key().x, E->key().y);
-		a[i++] = p;
+	a.resize(cell_count);
+	int idx = 0;
+	for (const Vector2i *E = cell_chunks.next(nullptr); E; E = cell_chunks.next(E)) {
+		const CellChunk *chunk = cell_chunks[*E];
+		for (int i = 0; i < CELL_CHUNK_SIZE * CELL_CHUNK_SIZE; i++) {
+			if (chunk->cells[i].source_id != -1) {
+				a[idx++] = Vector2i(E->x * CELL_CHUNK_SIZE + (i & CELL_CHUNK_MASK), E->y * CELL_CHUNK_SIZE + (i >> CELL_CHUNK_SHIFT));
+			}
+		}
 	}
 
 	return a;
@@ -1543,11 +1783,22 @@ TypedArray<Vector2i> TileMap::get_used_cells() const {
 Rect2 TileMap::get_used_rect() { // Not const because of cache
 	// Return the rect of the currently used area
 	if (used_size_cache_dirty) {
-		if (tile_map.size() > 0) {
-			used_size_cache = Rect2(tile_map.front()->key().x, tile_map.front()->key().y, 0, 0);
-
-			for (Map<Vector2i, TileMapCell>::Element *E = tile_map.front(); E; E = E->next()) {
-				used_size_cache.expand_to(Vector2(E->key().x, E->key().y));
+		if (cell_count > 0) {
+			bool first = true;
+			for (const Vector2i *E = cell_chunks.next(nullptr); E; E = cell_chunks.next(E)) {
+				const CellChunk *chunk = cell_chunks[*E];
+				for (int i = 0; i < CELL_CHUNK_SIZE * CELL_CHUNK_SIZE; i++) {
+					if (chunk->cells[i].source_id == -1) {
+						continue;
+					}
+					Vector2 coords(E->x * CELL_CHUNK_SIZE + (i & CELL_CHUNK_MASK), E->y * CELL_CHUNK_SIZE + (i >> CELL_CHUNK_SHIFT));
+					if (first) {
+						used_size_cache = Rect2(coords, Vector2());
+						first = false;
+					} else {
+						used_size_cache.expand_to(coords);
+					}
+				}
 			}
 
 			used_size_cache.size += Vector2(1, 1);
@@ -1566,8 +1817,8 @@ Rect2 TileMap::get_used_rect() { // Not const because of cache
 void TileMap::set_light_mask(int p_light_mask) {
 	// Occlusion: set light mask.
 	CanvasItem::set_light_mask(p_light_mask);
-	for (Map<Vector2i, TileMapQuadrant>::Element *E = quadrant_map.front(); E; E = E->next()) {
-		for (List<RID>::Element *F = E->get().canvas_items.front(); F; F = F->next()) {
+	for (const Vector2i *E = quadrant_map.next(nullptr); E; E = quadrant_map.next(E)) {
+		for (List<RID>::Element *F = quadrant_map[*E].canvas_items.front(); F; F = F->next()) {
 			RenderingServer::get_singleton()->canvas_item_set_light_mask(F->get(), get_light_mask());
 		}
 	}
@@ -1578,8 +1829,8 @@ void TileMap::set_material(const Ref<Material> &p_material) {
 	CanvasItem::set_material(p_material);
 
 	// Update material for the whole tilemap.
-	for (Map<Vector2i, TileMapQuadrant>::Element *E = quadrant_map.front(); E; E = E->next()) {
-		TileMapQuadrant &q = E->get();
+	for (const Vector2i *E = quadrant_map.next(nullptr); E; E = quadrant_map.next(E)) {
+		TileMapQuadrant &q = quadrant_map[*E];
 		for (List<RID>::Element *F = q.canvas_items.front(); F; F = F->next()) {
 			RS::get_singleton()->canvas_item_set_use_parent_material(F->get(), get_use_parent_material() || get_material().is_valid());
 		}
@@ -1591,8 +1842,8 @@ void TileMap::set_use_parent_material(bool p_use_parent_material) {
 	CanvasItem::set_use_parent_material(p_use_parent_material);
 
 	// Update use_parent_material for the whole tilemap.
-	for (Map<Vector2i, TileMapQuadrant>::Element *E = quadrant_map.front(); E; E = E->next()) {
-		TileMapQuadrant &q = E->get();
+	for (const Vector2i *E = quadrant_map.next(nullptr); E; E = quadrant_map.next(E)) {
+		TileMapQuadrant &q = quadrant_map[*E];
 		for (List<RID>::Element *F = q.canvas_items.front(); F; F = F->next()) {
 			RS::get_singleton()->canvas_item_set_use_parent_material(F->get(), get_use_parent_material() || get_material().is_valid());
 		}
@@ -1602,11 +1853,11 @@ void TileMap::set_use_parent_material(bool p_use_parent_material) {
 void TileMap::set_texture_filter(TextureFilter p_texture_filter) {
 	// Set a default texture filter for the whole tilemap
 	CanvasItem::set_texture_filter(p_texture_filter);
-	for (Map<Vector2i, TileMapQuadrant>::Element *F = quadrant_map.front(); F; F = F->next()) {
-		TileMapQuadrant &q = F->get();
+	for (const Vector2i *F = quadrant_map.next(nullptr); F; F = quadrant_map.next(F)) {
+		TileMapQuadrant &q = quadrant_map[*F];
 		for (List<RID>::Element *E = q.canvas_items.front(); E; E = E->next()) {
 			RenderingServer::get_singleton()->canvas_item_set_default_texture_filter(E->get(), RS::CanvasItemTextureFilter(p_texture_filter));
-			_make_quadrant_dirty(F);
+			_make_quadrant_dirty(&q);
 		}
 	}
 }
@@ -1614,11 +1865,11 @@ void TileMap::set_texture_filter(TextureFilter p_texture_filter) {
 void TileMap::set_texture_repeat(CanvasItem::TextureRepeat p_texture_repeat) {
 	// Set a default texture repeat for the whole tilemap
 	CanvasItem::set_texture_repeat(p_texture_repeat);
-	for (Map<Vector2i, TileMapQuadrant>::Element *F = quadrant_map.front(); F; F = F->next()) {
-		TileMapQuadrant &q = F->get();
+	for (const Vector2i *F = quadrant_map.next(nullptr); F; F = quadrant_map.next(F)) {
+		TileMapQuadrant &q = quadrant_map[*F];
 		for (List<RID>::Element *E = q.canvas_items.front(); E; E = E->next()) {
 			RenderingServer::get_singleton()->canvas_item_set_default_texture_repeat(E->get(), RS::CanvasItemTextureRepeat(p_texture_repeat));
-			_make_quadrant_dirty(F);
+			_make_quadrant_dirty(&q);
 		}
 	}
 }
@@ -1727,11 +1978,18 @@ void TileMap::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_navigation_visibility_mode", "show_navigation"), &TileMap::set_navigation_visibility_mode);
 	ClassDB::bind_method(D_METHOD("get_navigation_visibility_mode"), &TileMap::get_navigation_visibility_mode);
 
+	ClassDB::bind_method(D_METHOD("set_update_time_budget", "msec"), &TileMap::set_update_time_budget);
+	ClassDB::bind_method(D_METHOD("get_update_time_budget"), &TileMap::get_update_time_budget);
+
 	ClassDB::bind_method(D_METHOD("set_cell", "coords", "source_id", "atlas_coords", "alternative_tile"), &TileMap::set_cell, DEFVAL(-1), DEFVAL(TileSetSource::INVALID_ATLAS_COORDS), DEFVAL(TileSetSource::INVALID_TILE_ALTERNATIVE));
 	ClassDB::bind_method(D_METHOD("get_cell_source_id", "coords"), &TileMap::get_cell_source_id);
 	ClassDB::bind_method(D_METHOD("get_cell_atlas_coords", "coords"), &TileMap::get_cell_atlas_coords);
 	ClassDB::bind_method(D_METHOD("get_cell_alternative_tile", "coords"), &TileMap::get_cell_alternative_tile);
 
+	ClassDB::bind_method(D_METHOD("fill_rect", "rect", "source_id", "atlas_coords", "alternative_tile"), &TileMap::fill_rect, DEFVAL(-1), DEFVAL(TileSetSource::INVALID_ATLAS_COORDS), DEFVAL(TileSetSource::INVALID_TILE_ALTERNATIVE));
+	ClassDB::bind_method(D_METHOD("set_cell_block", "rect", "cells"), &TileMap::set_cell_block);
+	ClassDB::bind_method(D_METHOD("get_cell_block", "rect"), &TileMap::get_cell_block);
+
 	ClassDB::bind_method(D_METHOD("fix_invalid_tiles"), &TileMap::fix_invalid_tiles);
 	ClassDB::bind_method(D_METHOD("get_surrounding_tiles", "coords"), &TileMap::get_surrounding_tiles);
 	ClassDB::bind_method(D_METHOD("clear"), &TileMap::clear);
@@ -1753,6 +2011,7 @@ void TileMap::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "cell_quadrant_size", PROPERTY_HINT_RANGE, "1,128,1"), "set_quadrant_size", "get_quadrant_size");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "show_collision", PROPERTY_HINT_ENUM, "Default,Force Show,Force Hide"), "set_collision_visibility_mode", "get_collision_visibility_mode");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "show_navigation", PROPERTY_HINT_ENUM, "Default,Force Show,Force Hide"), "set_navigation_visibility_mode", "get_navigation_visibility_mode");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "update_time_budget", PROPERTY_HINT_RANGE, "0,100,0.1,or_greater"), "set_update_time_budget", "get_update_time_budget");
 
 	ADD_PROPERTY_DEFAULT("format", FORMAT_1);
 
@@ -1778,4 +2037,5 @@ TileMap::~TileMap() {
 		tile_set->disconnect("changed", callable_mp(this, &TileMap::_tile_set_changed));
 	}
 	_clear_quadrants();
+	_clear_cells();
 }
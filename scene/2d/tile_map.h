@@ -31,6 +31,8 @@
 #ifndef TILE_MAP_H
 #define TILE_MAP_H
 
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/self_list.h"
 #include "core/templates/vset.h"
 #include "scene/2d/node_2d.h"
@@ -96,18 +98,23 @@ struct TileMapQuadrant {
 		}
 	};
 
+	struct CoordsHasher {
+		_FORCE_INLINE_ static uint32_t hash(const Vector2i &p_coords) {
+			uint32_t h = hash_djb2_one_32(p_coords.x);
+			return hash_djb2_one_32(p_coords.y, h);
+		}
+	};
+
 	// Dirty list element
 	SelfList<TileMapQuadrant> dirty_list_element;
 
 	// Quadrant coords.
 	Vector2i coords;
 
-	// TileMapCells
-	Set<Vector2i> cells;
-	// We need those two maps to sort by world position for rendering
-	// This is kind of workaround, it would be better to sort the cells directly in the "cells" set instead.
-	Map<Vector2i, Vector2i> map_to_world;
-	Map<Vector2i, Vector2i, CoordsWorldComparator> world_to_map;
+	// TileMapCells, sorted by their world coords as it is needed by rendering.
+	// The TileMap rebuilds this list from its cells when updating the quadrant.
+	LocalVector<Vector2i> cells;
+	int cell_count = 0;
 
 	// Debug.
 	RID debug_canvas_item;
@@ -125,6 +132,50 @@ struct TileMapQuadrant {
 	// Scenes.
 	Map<Vector2i, String> scenes;
 
+	// What the plugins send to the servers, built from the cells on the worker
+	// threads, then consumed on the main thread.
+	struct RenderingTile {
+		Ref<Texture2D> texture;
+		Rect2 dest_rect;
+		Rect2 source_rect;
+		Color modulate;
+		bool transpose = false;
+	};
+
+	struct RenderingGroup {
+		Ref<ShaderMaterial> material;
+		int z_index = 0;
+		Vector2 position;
+		LocalVector<RenderingTile> tiles;
+	};
+
+	struct RenderingOccluder {
+		Transform2D xform;
+		Ref<OccluderPolygon2D> polygon;
+		int light_mask = 0;
+	};
+
+	struct PhysicsShape {
+		int body_index = 0;
+		int shape_index = 0;
+		Ref<ConvexPolygonShape2D> shape;
+		Transform2D xform;
+		Vector2i coords;
+		bool one_way_collision = false;
+		float one_way_collision_margin = 0.0;
+	};
+
+	struct NavigationCell {
+		Vector2i coords;
+		Transform2D xform;
+		Vector<Ref<NavigationPolygon>> polygons;
+	};
+
+	LocalVector<RenderingGroup> rendering_groups;
+	LocalVector<RenderingOccluder> rendering_occluders;
+	LocalVector<PhysicsShape> physics_shapes;
+	LocalVector<NavigationCell> navigation_cells;
+
 	void operator=(const TileMapQuadrant &q) {
 		coords = q.coords;
 		debug_canvas_item = q.debug_canvas_item;
@@ -204,6 +255,7 @@ private:
 
 	// Updates.
 	bool pending_update = false;
+	float update_time_budget = 0.0; // In milliseconds, 0 means no limit.
 
 	// Rect.
 	Rect2 rect_cache;
@@ -211,18 +263,46 @@ private:
 	Rect2 used_size_cache;
 	bool used_size_cache_dirty = true;
 
-	// Map of cells.
-	Map<Vector2i, TileMapCell> tile_map;
+	// Map of cells, stored in square chunks so large maps don't need a tree node per cell.
+	// Empty cells of a chunk have a source_id of -1.
+	enum {
+		CELL_CHUNK_SHIFT = 5,
+		CELL_CHUNK_SIZE = 1 << CELL_CHUNK_SHIFT,
+		CELL_CHUNK_MASK = CELL_CHUNK_SIZE - 1,
+	};
+	struct CellChunk {
+		TileMapCell cells[CELL_CHUNK_SIZE * CELL_CHUNK_SIZE];
+		int used = 0;
+	};
+	HashMap<Vector2i, CellChunk *, TileMapQuadrant::CoordsHasher> cell_chunks;
+	int cell_count = 0;
+
+	// Arithmetic shifts and masks round down for negative coords too.
+	_FORCE_INLINE_ static Vector2i _coords_to_chunk_coords(const Vector2i &p_coords) {
+		return Vector2i(p_coords.x >> CELL_CHUNK_SHIFT, p_coords.y >> CELL_CHUNK_SHIFT);
+	}
+	_FORCE_INLINE_ static int _coords_to_chunk_index(const Vector2i &p_coords) {
+		return ((p_coords.y & CELL_CHUNK_MASK) << CELL_CHUNK_SHIFT) | (p_coords.x & CELL_CHUNK_MASK);
+	}
+	const TileMapCell *_get_cell_ptr(const Vector2i &p_coords) const;
+	void _get_cells_in_rect(const Rect2i &p_rect, LocalVector<Vector2i> &r_cells) const;
+	bool _store_cell(const Vector2i &p_coords, const TileMapCell &p_cell, int &r_cell_count_change);
+	void _clear_cells();
 
 	// Quadrants management.
-	Map<Vector2i, TileMapQuadrant> quadrant_map;
+	HashMap<Vector2i, TileMapQuadrant, TileMapQuadrant::CoordsHasher> quadrant_map;
 	Vector2i _coords_to_quadrant_coords(const Vector2i &p_coords) const;
 	SelfList<TileMapQuadrant>::List dirty_quadrant_list;
 
-	Map<Vector2i, TileMapQuadrant>::Element *_create_quadrant(const Vector2i &p_qk);
-	void _erase_quadrant(Map<Vector2i, TileMapQuadrant>::Element *Q);
+	TileMapQuadrant *_create_quadrant(const Vector2i &p_qk);
+	void _erase_quadrant(TileMapQuadrant *p_quadrant);
 	void _make_all_quadrants_dirty(bool p_update = true);
-	void _make_quadrant_dirty(Map<Vector2i, TileMapQuadrant>::Element *Q, bool p_update = true);
+	void _make_quadrant_dirty(TileMapQuadrant *p_quadrant, bool p_update = true);
+	void _update_cell_quadrant(const Vector2i &p_coords, int p_cell_count_change);
+	void _update_quadrant_cells(TileMapQuadrant *p_quadrant);
+	void _prepare_dirty_quadrant(TileMapQuadrant *p_quadrant);
+	void _prepare_dirty_quadrant_threaded(uint32_t p_index, TileMapQuadrant **p_quadrants);
+	void _update_dirty_quadrant_batch(SelfList<TileMapQuadrant>::List &r_batch);
 	void _recreate_quadrants();
 	void _clear_quadrants();
 	void _recompute_rect_cache();
@@ -264,18 +344,26 @@ public:
 	void set_navigation_visibility_mode(VisibilityMode p_show_navigation);
 	VisibilityMode get_navigation_visibility_mode();
 
+	void set_update_time_budget(float p_msec);
+	float get_update_time_budget() const;
+
 	void set_cell(const Vector2i &p_coords, int p_source_id = -1, const Vector2i p_atlas_coords = TileSetSource::INVALID_ATLAS_COORDS, int p_alternative_tile = TileSetSource::INVALID_TILE_ALTERNATIVE);
 	int get_cell_source_id(const Vector2i &p_coords) const;
 	Vector2i get_cell_atlas_coords(const Vector2i &p_coords) const;
 	int get_cell_alternative_tile(const Vector2i &p_coords) const;
 
+	// Bulk operations, each cell takes 4 integers: source_id, atlas_coords.x, atlas_coords.y, alternative_tile.
+	void fill_rect(const Rect2i &p_rect, int p_source_id = -1, const Vector2i p_atlas_coords = TileSetSource::INVALID_ATLAS_COORDS, int p_alternative_tile = TileSetSource::INVALID_TILE_ALTERNATIVE);
+	void set_cell_block(const Rect2i &p_rect, const PackedInt32Array &p_cells);
+	PackedInt32Array get_cell_block(const Rect2i &p_rect) const;
+
 	TileMapPattern *get_pattern(TypedArray<Vector2i> p_coords_array);
 	Vector2i map_pattern(Vector2i p_position_in_tilemap, Vector2i p_coords_in_pattern, const TileMapPattern *p_pattern);
 	void set_pattern(Vector2i p_position, const TileMapPattern *p_pattern);
 
 	// Not exposed to users
 	TileMapCell get_cell(const Vector2i &p_coords) const;
-	Map<Vector2i, TileMapQuadrant> &get_quadrant_map();
+	HashMap<Vector2i, TileMapQuadrant, TileMapQuadrant::CoordsHasher> &get_quadrant_map();
 	int get_effective_quadrant_size() const;
 
 	void update_dirty_quadrants();
@@ -140,14 +140,49 @@ void AudioStreamPlayer3D::_calc_output_vol(const Vector3 &source_dir, real_t tig
 void AudioStreamPlayer3D::_mix_audio() {
 	if (!stream_playback.is_valid() || !active.is_set() ||
 			(stream_paused && !stream_paused_fade_out)) {
+		voice.playing = false;
 		return;
 	}
 
+	voice.playing = true;
+
 	bool started = false;
 	if (setseek.get() >= 0.0) {
 		stream_playback->start(setseek.get());
 		setseek.set(-1.0); //reset seek
 		started = true;
+		voice_virtual = false;
+		virtual_time = 0.0;
+	}
+
+	float mix_rate = AudioServer::get_singleton()->get_mix_rate();
+
+	if (voice.is_virtual) {
+		if (voice_virtual) {
+			// Only keep track of time, the playback is advanced when revived or when it should end.
+			virtual_time += mix_buffer.size() * pitch_scale / mix_rate;
+			float length = stream->get_length();
+			if (length > 0 && stream_playback->get_playback_position() + virtual_time >= length) {
+				stream_playback->skip(virtual_time);
+				virtual_time = 0.0;
+			}
+
+			if (!stream_playback->is_playing()) {
+				active.clear();
+			}
+			output_ready.clear();
+			return;
+		}
+
+		// Fade out the last mix before becoming virtual.
+		voice_virtual = true;
+		stream_paused_fade_out = true;
+		virtual_time = (mix_buffer.size() - MIN(mix_buffer.size(), 128)) * pitch_scale / mix_rate;
+	} else if (voice_virtual) {
+		voice_virtual = false;
+		stream_playback->skip(virtual_time);
+		virtual_time = 0.0;
+		stream_paused_fade_in = true;
 	}
 
 	//get data
@@ -331,6 +366,7 @@ void AudioStreamPlayer3D::_notification(int p_what) {
 	if (p_what == NOTIFICATION_ENTER_TREE) {
 		velocity_tracker->reset(get_global_transform().origin);
 		AudioServer::get_singleton()->add_callback(_mix_audios, this);
+		AudioServer::get_singleton()->voice_add(&voice);
 		if (autoplay && !Engine::get_singleton()->is_editor_hint()) {
 			play();
 		}
@@ -338,6 +374,7 @@ void AudioStreamPlayer3D::_notification(int p_what) {
 
 	if (p_what == NOTIFICATION_EXIT_TREE) {
 		AudioServer::get_singleton()->remove_callback(_mix_audios, this);
+		AudioServer::get_singleton()->voice_remove(&voice);
 	}
 
 	if (p_what == NOTIFICATION_PAUSED) {
@@ -593,6 +630,17 @@ void AudioStreamPlayer3D::_notification(int p_what) {
 				}
 			}
 
+			// Used to decide which voices become virtual when there are too many.
+			float max_volume = 0.0;
+			unsigned int cc = AudioServer::get_singleton()->get_channel_count();
+			for (int i = 0; i < new_output_count; i++) {
+				for (unsigned int k = 0; k < cc; k++) {
+					max_volume = MAX(max_volume, MAX(outputs[i].vol[k].l, outputs[i].vol[k].r));
+					max_volume = MAX(max_volume, MAX(outputs[i].reverb_vol[k].l, outputs[i].reverb_vol[k].r));
+				}
+			}
+			voice.volume_db.set(Math::linear2db(max_volume + AUDIO_PEAK_OFFSET));
+
 			output_count.set(new_output_count);
 			output_ready.set();
 		}
@@ -887,6 +935,14 @@ bool AudioStreamPlayer3D::get_stream_paused() const {
 	return stream_paused;
 }
 
+void AudioStreamPlayer3D::set_voice_priority(int p_priority) {
+	voice.priority.set(p_priority);
+}
+
+int AudioStreamPlayer3D::get_voice_priority() const {
+	return voice.priority.get();
+}
+
 Ref<AudioStreamPlayback> AudioStreamPlayer3D::get_stream_playback() {
 	return stream_playback;
 }
@@ -956,6 +1012,9 @@ void AudioStreamPlayer3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_stream_paused", "pause"), &AudioStreamPlayer3D::set_stream_paused);
 	ClassDB::bind_method(D_METHOD("get_stream_paused"), &AudioStreamPlayer3D::get_stream_paused);
 
+	ClassDB::bind_method(D_METHOD("set_voice_priority", "priority"), &AudioStreamPlayer3D::set_voice_priority);
+	ClassDB::bind_method(D_METHOD("get_voice_priority"), &AudioStreamPlayer3D::get_voice_priority);
+
 	ClassDB::bind_method(D_METHOD("get_stream_playback"), &AudioStreamPlayer3D::get_stream_playback);
 
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "stream", PROPERTY_HINT_RESOURCE_TYPE, "AudioStream"), "set_stream", "get_stream");
@@ -971,6 +1030,7 @@ void AudioStreamPlayer3D::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "out_of_range_mode", PROPERTY_HINT_ENUM, "Mix,Pause"), "set_out_of_range_mode", "get_out_of_range_mode");
 	ADD_PROPERTY(PropertyInfo(Variant::STRING_NAME, "bus", PROPERTY_HINT_ENUM, ""), "set_bus", "get_bus");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "area_mask", PROPERTY_HINT_LAYERS_2D_PHYSICS), "set_area_mask", "get_area_mask");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "voice_priority", PROPERTY_HINT_RANGE, "-128,128,1,or_lesser,or_greater"), "set_voice_priority", "get_voice_priority");
 	ADD_GROUP("Emission Angle", "emission_angle");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "emission_angle_enabled"), "set_emission_angle_enabled", "is_emission_angle_enabled");
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "emission_angle_degrees", PROPERTY_HINT_RANGE, "0.1,90,0.1"), "set_emission_angle", "get_emission_angle");
@@ -107,6 +107,10 @@ private:
 	bool stream_paused_fade_out = false;
 	StringName bus;
 
+	AudioServer::Voice voice;
+	bool voice_virtual = false; // Used by audio thread to fade out and revive the voice.
+	float virtual_time = 0.0; // Time elapsed since the voice became virtual.
+
 	static void _calc_output_vol(const Vector3 &source_dir, real_t tightness, Output &output);
 	void _mix_audio();
 	static void _mix_audios(void *self) { reinterpret_cast<AudioStreamPlayer3D *>(self)->_mix_audio(); }
@@ -200,6 +204,9 @@ public:
 	void set_stream_paused(bool p_pause);
 	bool get_stream_paused() const;
 
+	void set_voice_priority(int p_priority);
+	int get_voice_priority() const;
+
 	Ref<AudioStreamPlayback> get_stream_playback();
 
 	AudioStreamPlayer3D();
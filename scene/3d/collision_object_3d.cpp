@@ -71,11 +71,7 @@ void CollisionObject3D::_notification(int p_what) {
 		} break;
 
 		case NOTIFICATION_TRANSFORM_CHANGED: {
-			if (area) {
-				PhysicsServer3D::get_singleton()->area_set_transform(rid, get_global_transform());
-			} else {
-				PhysicsServer3D::get_singleton()->body_set_state(rid, PhysicsServer3D::BODY_STATE_TRANSFORM, get_global_transform());
-			}
+			get_tree()->_set_collision_object_transform(rid, area, get_global_transform());
 
 			_on_transform_changed();
 
@@ -30,11 +30,21 @@
 
 #include "cpu_particles_3d.h"
 
+#include "core/math/random_pcg.h"
+#include "core/templates/thread_work_pool.h"
 #include "scene/3d/camera_3d.h"
 #include "scene/3d/gpu_particles_3d.h"
+#include "scene/main/scene_tree.h"
 #include "scene/resources/particles_material.h"
 #include "servers/rendering_server.h"
 
+#if !defined(REAL_T_IS_DOUBLE)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CPU_PARTICLES_3D_SSE2
+#include <emmintrin.h>
+#endif
+#endif
+
 AABB CPUParticles3D::get_aabb() const {
 	return AABB();
 }
@@ -72,6 +82,14 @@ void CPUParticles3D::set_amount(int p_amount) {
 		}
 	}
 
+	for (int i = 0; i < 3; i++) {
+		particle_position[i].resize(p_amount);
+		particle_velocity[i].resize(p_amount);
+		memset(particle_position[i].ptr(), 0, sizeof(real_t) * p_amount);
+		memset(particle_velocity[i].ptr(), 0, sizeof(real_t) * p_amount);
+	}
+	particle_step.resize(p_amount);
+
 	particle_data.resize((12 + 4 + 4) * p_amount);
 	RS::get_singleton()->multimesh_allocate_data(multimesh, p_amount, RS::MULTIMESH_TRANSFORM_3D, true, true);
 
@@ -239,6 +257,11 @@ void CPUParticles3D::restart() {
 	set_emitting(true);
 }
 
+Vector<float> CPUParticles3D::get_particle_data() const {
+	MutexLock lock(update_mutex);
+	return particle_data;
+}
+
 void CPUParticles3D::set_direction(Vector3 p_direction) {
 	direction = p_direction;
 }
@@ -555,14 +578,16 @@ void CPUParticles3D::_update_internal() {
 	}
 }
 
+ThreadWorkPool *CPUParticles3D::_get_chunk_work_pool(uint32_t p_chunk_count) const {
+	if (p_chunk_count < 2 || !is_inside_tree()) {
+		return nullptr;
+	}
+	return get_tree()->get_thread_work_pool_for_main_thread();
+}
+
 void CPUParticles3D::_particles_process(float p_delta) {
 	p_delta *= speed_scale;
 
-	int pcount = particles.size();
-	Particle *w = particles.ptrw();
-
-	Particle *parray = w;
-
 	float prev_time = time;
 	time += p_delta;
 	if (time > lifetime) {
@@ -574,23 +599,69 @@ void CPUParticles3D::_particles_process(float p_delta) {
 		}
 	}
 
-	Transform3D emission_xform;
-	Basis velocity_xform;
+	process_frame.delta = p_delta;
+	process_frame.prev_time = prev_time;
+	process_frame.system_phase = time / lifetime;
+	process_frame.seed = Math::rand();
+	process_frame.emission_xform = Transform3D();
+	process_frame.velocity_xform = Basis();
 	if (!local_coords) {
-		emission_xform = get_global_transform();
-		velocity_xform = emission_xform.basis;
+		process_frame.emission_xform = get_global_transform();
+		process_frame.velocity_xform = process_frame.emission_xform.basis;
+	}
+
+	// Gradients sort their points lazily, make sure that happened before sampling from several threads.
+	if (color_ramp.is_valid()) {
+		color_ramp->get_color_at_offset(0.0);
 	}
 
-	float system_phase = time / lifetime;
+	Particle *w = particles.ptrw();
+
+	uint32_t chunk_count = (particles.size() + PROCESS_CHUNK_SIZE - 1) / PROCESS_CHUNK_SIZE;
+	ThreadWorkPool *pool = _get_chunk_work_pool(chunk_count);
+	if (pool) {
+		pool->do_work(chunk_count, this, &CPUParticles3D::_process_particle_chunk, w);
+	} else {
+		for (uint32_t i = 0; i < chunk_count; i++) {
+			_process_particle_chunk(i, w);
+		}
+	}
+}
+
+void CPUParticles3D::_process_particle_chunk(uint32_t p_chunk, Particle *p_particles) {
+	const float prev_time = process_frame.prev_time;
+	const float system_phase = process_frame.system_phase;
+	const Transform3D &emission_xform = process_frame.emission_xform;
+	const Basis &velocity_xform = process_frame.velocity_xform;
+
+	RandomPCG rng(process_frame.seed, p_chunk);
 
-	for (int i = 0; i < pcount; i++) {
+	int pcount = particles.size();
+	Particle *parray = p_particles;
+
+	int from = p_chunk * PROCESS_CHUNK_SIZE;
+	int to = MIN(from + PROCESS_CHUNK_SIZE, pcount);
+
+	real_t *px = particle_position[0].ptr();
+	real_t *py = particle_position[1].ptr();
+	real_t *pz = particle_position[2].ptr();
+	real_t *vx = particle_velocity[0].ptr();
+	real_t *vy = particle_velocity[1].ptr();
+	real_t *vz = particle_velocity[2].ptr();
+	float *step = particle_step.ptr();
+
+	for (int i = from; i < to; i++) {
 		Particle &p = parray[i];
 
+		step[i] = 0.0;
 		if (!emitting && !p.active) {
 			continue;
 		}
 
-		float local_delta = p_delta;
+		Vector3 origin(px[i], py[i], pz[i]);
+		Vector3 velocity(vx[i], vy[i], vz[i]);
+
+		float local_delta = process_frame.delta;
 
 		// The phase is a ratio between 0 (birth) and 1 (end of life) for each particle.
 		// While we use time in tests later on, for randomness we use the phase as done in the
@@ -665,37 +736,38 @@ void CPUParticles3D::_particles_process(float p_delta) {
 				tex_anim_offset = curve_parameters[PARAM_ANGLE]->interpolate(tv);
 			}
 
-			p.seed = Math::rand();
+			p.seed = rng.rand();
 
-			p.angle_rand = Math::randf();
-			p.scale_rand = Math::randf();
-			p.hue_rot_rand = Math::randf();
-			p.anim_offset_rand = Math::randf();
+			p.angle_rand = rng.randf();
+			p.scale_rand = rng.randf();
+			p.hue_rot_rand = rng.randf();
+			p.anim_offset_rand = rng.randf();
 
 			if (particle_flags[PARTICLE_FLAG_DISABLE_Z]) {
-				float angle1_rad = Math::atan2(direction.y, direction.x) + Math::deg2rad((Math::randf() * 2.0 - 1.0) * spread);
+				float angle1_rad = Math::atan2(direction.y, direction.x) + Math::deg2rad((rng.randf() * 2.0 - 1.0) * spread);
 				Vector3 rot = Vector3(Math::cos(angle1_rad), Math::sin(angle1_rad), 0.0);
-				p.velocity = rot * parameters[PARAM_INITIAL_LINEAR_VELOCITY] * Math::lerp(1.0f, float(Math::randf()), randomness[PARAM_INITIAL_LINEAR_VELOCITY]);
+				velocity = rot * parameters[PARAM_INITIAL_LINEAR_VELOCITY] * Math::lerp(1.0f, float(rng.randf()), randomness[PARAM_INITIAL_LINEAR_VELOCITY]);
 			} else {
 				//initiate velocity spread in 3D
-				float angle1_rad = Math::atan2(direction.x, direction.z) + Math::deg2rad((Math::randf() * 2.0 - 1.0) * spread);
-				float angle2_rad = Math::atan2(direction.y, Math::abs(direction.z)) + Math::deg2rad((Math::randf() * 2.0 - 1.0) * (1.0 - flatness) * spread);
+				float angle1_rad = Math::atan2(direction.x, direction.z) + Math::deg2rad((rng.randf() * 2.0 - 1.0) * spread);
+				float angle2_rad = Math::atan2(direction.y, Math::abs(direction.z)) + Math::deg2rad((rng.randf() * 2.0 - 1.0) * (1.0 - flatness) * spread);
 
 				Vector3 direction_xz = Vector3(Math::sin(angle1_rad), 0, Math::cos(angle1_rad));
 				Vector3 direction_yz = Vector3(0, Math::sin(angle2_rad), Math::cos(angle2_rad));
 				direction_yz.z = direction_yz.z / MAX(0.0001, Math::sqrt(ABS(direction_yz.z))); //better uniform distribution
 				Vector3 direction = Vector3(direction_xz.x * direction_yz.z, direction_yz.y, direction_xz.z * direction_yz.z);
 				direction.normalize();
-				p.velocity = direction * parameters[PARAM_INITIAL_LINEAR_VELOCITY] * Math::lerp(1.0f, float(Math::randf()), randomness[PARAM_INITIAL_LINEAR_VELOCITY]);
+				velocity = direction * parameters[PARAM_INITIAL_LINEAR_VELOCITY] * Math::lerp(1.0f, float(rng.randf()), randomness[PARAM_INITIAL_LINEAR_VELOCITY]);
 			}
 
 			float base_angle = (parameters[PARAM_ANGLE] + tex_angle) * Math::lerp(1.0f, p.angle_rand, randomness[PARAM_ANGLE]);
 			p.custom[0] = Math::deg2rad(base_angle); //angle
 			p.custom[1] = 0.0; //phase
 			p.custom[2] = (parameters[PARAM_ANIM_OFFSET] + tex_anim_offset) * Math::lerp(1.0f, p.anim_offset_rand, randomness[PARAM_ANIM_OFFSET]); //animation offset (0-1)
-			p.transform = Transform3D();
+			p.basis = Basis();
+			origin = Vector3();
 			p.time = 0;
-			p.lifetime = lifetime * (1.0 - Math::randf() * lifetime_randomness);
+			p.lifetime = lifetime * (1.0 - rng.randf() * lifetime_randomness);
 			p.base_color = Color(1, 1, 1, 1);
 
 			switch (emission_shape) {
@@ -703,13 +775,13 @@ void CPUParticles3D::_particles_process(float p_delta) {
 					//do none
 				} break;
 				case EMISSION_SHAPE_SPHERE: {
-					real_t s = 2.0 * Math::randf() - 1.0;
-					real_t t = Math_TAU * Math::randf();
+					real_t s = 2.0 * rng.randf() - 1.0;
+					real_t t = Math_TAU * rng.randf();
 					real_t radius = emission_sphere_radius * Math::sqrt(1.0 - s * s);
-					p.transform.origin = Vector3(radius * Math::cos(t), radius * Math::sin(t), emission_sphere_radius * s);
+					origin = Vector3(radius * Math::cos(t), radius * Math::sin(t), emission_sphere_radius * s);
 				} break;
 				case EMISSION_SHAPE_BOX: {
-					p.transform.origin = Vector3(Math::randf() * 2.0 - 1.0, Math::randf() * 2.0 - 1.0, Math::randf() * 2.0 - 1.0) * emission_box_extents;
+					origin = Vector3(rng.randf() * 2.0 - 1.0, rng.randf() * 2.0 - 1.0, rng.randf() * 2.0 - 1.0) * emission_box_extents;
 				} break;
 				case EMISSION_SHAPE_POINTS:
 				case EMISSION_SHAPE_DIRECTED_POINTS: {
@@ -718,9 +790,9 @@ void CPUParticles3D::_particles_process(float p_delta) {
 						break;
 					}
 
-					int random_idx = Math::rand() % pc;
+					int random_idx = rng.rand() % pc;
 
-					p.transform.origin = emission_points.get(random_idx);
+					origin = emission_points.get(random_idx);
 
 					if (emission_shape == EMISSION_SHAPE_DIRECTED_POINTS && emission_normals.size() == pc) {
 						if (particle_flags[PARTICLE_FLAG_DISABLE_Z]) {
@@ -729,10 +801,10 @@ void CPUParticles3D::_particles_process(float p_delta) {
 							Transform2D m2;
 							m2.set_axis(0, normal_2d);
 							m2.set_axis(1, normal_2d.orthogonal());
-							Vector2 velocity_2d(p.velocity.x, p.velocity.y);
+							Vector2 velocity_2d(velocity.x, velocity.y);
 							velocity_2d = m2.basis_xform(velocity_2d);
-							p.velocity.x = velocity_2d.x;
-							p.velocity.y = velocity_2d.y;
+							velocity.x = velocity_2d.x;
+							velocity.y = velocity_2d.y;
 						} else {
 							Vector3 normal = emission_normals.get(random_idx);
 							Vector3 v0 = Math::abs(normal.z) < 0.999 ? Vector3(0.0, 0.0, 1.0) : Vector3(0, 1.0, 0.0);
@@ -742,7 +814,7 @@ void CPUParticles3D::_particles_process(float p_delta) {
 							m3.set_axis(0, tangent);
 							m3.set_axis(1, bitangent);
 							m3.set_axis(2, normal);
-							p.velocity = m3.xform(p.velocity);
+							velocity = m3.xform(velocity);
 						}
 					}
 
@@ -756,13 +828,14 @@ void CPUParticles3D::_particles_process(float p_delta) {
 			}
 
 			if (!local_coords) {
-				p.velocity = velocity_xform.xform(p.velocity);
-				p.transform = emission_xform * p.transform;
+				velocity = velocity_xform.xform(velocity);
+				p.basis = emission_xform.basis * p.basis;
+				origin = emission_xform.xform(origin);
 			}
 
 			if (particle_flags[PARTICLE_FLAG_DISABLE_Z]) {
-				p.velocity.z = 0.0;
-				p.transform.origin.z = 0.0;
+				velocity.z = 0.0;
+				origin.z = 0.0;
 			}
 
 		} else if (!p.active) {
@@ -829,12 +902,12 @@ void CPUParticles3D::_particles_process(float p_delta) {
 			}
 
 			Vector3 force = gravity;
-			Vector3 position = p.transform.origin;
+			Vector3 position = origin;
 			if (particle_flags[PARTICLE_FLAG_DISABLE_Z]) {
 				position.z = 0.0;
 			}
 			//apply linear acceleration
-			force += p.velocity.length() > 0.0 ? p.velocity.normalized() * (parameters[PARAM_LINEAR_ACCEL] + tex_linear_accel) * Math::lerp(1.0f, rand_from_seed(alt_seed), randomness[PARAM_LINEAR_ACCEL]) : Vector3();
+			force += velocity.length() > 0.0 ? velocity.normalized() * (parameters[PARAM_LINEAR_ACCEL] + tex_linear_accel) * Math::lerp(1.0f, rand_from_seed(alt_seed), randomness[PARAM_LINEAR_ACCEL]) : Vector3();
 			//apply radial acceleration
 			Vector3 org = emission_xform.origin;
 			Vector3 diff = position - org;
@@ -850,7 +923,7 @@ void CPUParticles3D::_particles_process(float p_delta) {
 				force += crossDiff.length() > 0.0 ? crossDiff.normalized() * ((parameters[PARAM_TANGENTIAL_ACCEL] + tex_tangential_accel) * Math::lerp(1.0f, rand_from_seed(alt_seed), randomness[PARAM_TANGENTIAL_ACCEL])) : Vector3();
 			}
 			//apply attractor forces
-			p.velocity += force * local_delta;
+			velocity += force * local_delta;
 			//orbit velocity
 			if (particle_flags[PARTICLE_FLAG_DISABLE_Z]) {
 				float orbit_amount = (parameters[PARAM_ORBIT_VELOCITY] + tex_orbit_velocity) * Math::lerp(1.0f, rand_from_seed(alt_seed), randomness[PARAM_ORBIT_VELOCITY]);
@@ -860,21 +933,21 @@ void CPUParticles3D::_particles_process(float p_delta) {
 					// but we use -ang here to reproduce its behavior.
 					Transform2D rot = Transform2D(-ang, Vector2());
 					Vector2 rotv = rot.basis_xform(Vector2(diff.x, diff.y));
-					p.transform.origin -= Vector3(diff.x, diff.y, 0);
-					p.transform.origin += Vector3(rotv.x, rotv.y, 0);
+					origin -= Vector3(diff.x, diff.y, 0);
+					origin += Vector3(rotv.x, rotv.y, 0);
 				}
 			}
 			if (curve_parameters[PARAM_INITIAL_LINEAR_VELOCITY].is_valid()) {
-				p.velocity = p.velocity.normalized() * tex_linear_velocity;
+				velocity = velocity.normalized() * tex_linear_velocity;
 			}
 			if (parameters[PARAM_DAMPING] + tex_damping > 0.0) {
-				float v = p.velocity.length();
+				float v = velocity.length();
 				float damp = (parameters[PARAM_DAMPING] + tex_damping) * Math::lerp(1.0f, rand_from_seed(alt_seed), randomness[PARAM_DAMPING]);
 				v -= damp * local_delta;
 				if (v < 0.0) {
-					p.velocity = Vector3();
+					velocity = Vector3();
 				} else {
-					p.velocity = p.velocity.normalized() * v;
+					velocity = velocity.normalized() * v;
 				}
 			}
 			float base_angle = (parameters[PARAM_ANGLE] + tex_angle) * Math::lerp(1.0f, p.angle_rand, randomness[PARAM_ANGLE]);
@@ -925,43 +998,43 @@ void CPUParticles3D::_particles_process(float p_delta) {
 
 		if (particle_flags[PARTICLE_FLAG_DISABLE_Z]) {
 			if (particle_flags[PARTICLE_FLAG_ALIGN_Y_TO_VELOCITY]) {
-				if (p.velocity.length() > 0.0) {
-					p.transform.basis.set_axis(1, p.velocity.normalized());
+				if (velocity.length() > 0.0) {
+					p.basis.set_axis(1, velocity.normalized());
 				} else {
-					p.transform.basis.set_axis(1, p.transform.basis.get_axis(1));
+					p.basis.set_axis(1, p.basis.get_axis(1));
 				}
-				p.transform.basis.set_axis(0, p.transform.basis.get_axis(1).cross(p.transform.basis.get_axis(2)).normalized());
-				p.transform.basis.set_axis(2, Vector3(0, 0, 1));
+				p.basis.set_axis(0, p.basis.get_axis(1).cross(p.basis.get_axis(2)).normalized());
+				p.basis.set_axis(2, Vector3(0, 0, 1));
 
 			} else {
-				p.transform.basis.set_axis(0, Vector3(Math::cos(p.custom[0]), -Math::sin(p.custom[0]), 0.0));
-				p.transform.basis.set_axis(1, Vector3(Math::sin(p.custom[0]), Math::cos(p.custom[0]), 0.0));
-				p.transform.basis.set_axis(2, Vector3(0, 0, 1));
+				p.basis.set_axis(0, Vector3(Math::cos(p.custom[0]), -Math::sin(p.custom[0]), 0.0));
+				p.basis.set_axis(1, Vector3(Math::sin(p.custom[0]), Math::cos(p.custom[0]), 0.0));
+				p.basis.set_axis(2, Vector3(0, 0, 1));
 			}
 
 		} else {
 			//orient particle Y towards velocity
 			if (particle_flags[PARTICLE_FLAG_ALIGN_Y_TO_VELOCITY]) {
-				if (p.velocity.length() > 0.0) {
-					p.transform.basis.set_axis(1, p.velocity.normalized());
+				if (velocity.length() > 0.0) {
+					p.basis.set_axis(1, velocity.normalized());
 				} else {
-					p.transform.basis.set_axis(1, p.transform.basis.get_axis(1).normalized());
+					p.basis.set_axis(1, p.basis.get_axis(1).normalized());
 				}
-				if (p.transform.basis.get_axis(1) == p.transform.basis.get_axis(0)) {
-					p.transform.basis.set_axis(0, p.transform.basis.get_axis(1).cross(p.transform.basis.get_axis(2)).normalized());
-					p.transform.basis.set_axis(2, p.transform.basis.get_axis(0).cross(p.transform.basis.get_axis(1)).normalized());
+				if (p.basis.get_axis(1) == p.basis.get_axis(0)) {
+					p.basis.set_axis(0, p.basis.get_axis(1).cross(p.basis.get_axis(2)).normalized());
+					p.basis.set_axis(2, p.basis.get_axis(0).cross(p.basis.get_axis(1)).normalized());
 				} else {
-					p.transform.basis.set_axis(2, p.transform.basis.get_axis(0).cross(p.transform.basis.get_axis(1)).normalized());
-					p.transform.basis.set_axis(0, p.transform.basis.get_axis(1).cross(p.transform.basis.get_axis(2)).normalized());
+					p.basis.set_axis(2, p.basis.get_axis(0).cross(p.basis.get_axis(1)).normalized());
+					p.basis.set_axis(0, p.basis.get_axis(1).cross(p.basis.get_axis(2)).normalized());
 				}
 			} else {
-				p.transform.basis.orthonormalize();
+				p.basis.orthonormalize();
 			}
 
 			//turn particle by rotation in Y
 			if (particle_flags[PARTICLE_FLAG_ROTATE_Y]) {
 				Basis rot_y(Vector3(0, 1, 0), p.custom[0]);
-				p.transform.basis = p.transform.basis * rot_y;
+				p.basis = p.basis * rot_y;
 			}
 		}
 
@@ -971,14 +1044,47 @@ void CPUParticles3D::_particles_process(float p_delta) {
 			base_scale = 0.000001;
 		}
 
-		p.transform.basis.scale(Vector3(1, 1, 1) * base_scale);
+		p.basis.scale(Vector3(1, 1, 1) * base_scale);
 
 		if (particle_flags[PARTICLE_FLAG_DISABLE_Z]) {
-			p.velocity.z = 0.0;
-			p.transform.origin.z = 0.0;
+			velocity.z = 0.0;
+			origin.z = 0.0;
 		}
 
-		p.transform.origin += p.velocity * local_delta;
+		px[i] = origin.x;
+		py[i] = origin.y;
+		pz[i] = origin.z;
+		vx[i] = velocity.x;
+		vy[i] = velocity.y;
+		vz[i] = velocity.z;
+		step[i] = local_delta;
+	}
+
+	_integrate_particles(from, to);
+}
+
+void CPUParticles3D::_integrate_particles(int p_from, int p_to) {
+	real_t *px = particle_position[0].ptr();
+	real_t *py = particle_position[1].ptr();
+	real_t *pz = particle_position[2].ptr();
+	const real_t *vx = particle_velocity[0].ptr();
+	const real_t *vy = particle_velocity[1].ptr();
+	const real_t *vz = particle_velocity[2].ptr();
+	const float *step = particle_step.ptr();
+
+	int i = p_from;
+#if defined(CPU_PARTICLES_3D_SSE2)
+	for (; i + 4 <= p_to; i += 4) {
+		const __m128 dt = _mm_loadu_ps(step + i);
+		_mm_storeu_ps(px + i, _mm_add_ps(_mm_loadu_ps(px + i), _mm_mul_ps(_mm_loadu_ps(vx + i), dt)));
+		_mm_storeu_ps(py + i, _mm_add_ps(_mm_loadu_ps(py + i), _mm_mul_ps(_mm_loadu_ps(vy + i), dt)));
+		_mm_storeu_ps(pz + i, _mm_add_ps(_mm_loadu_ps(pz + i), _mm_mul_ps(_mm_loadu_ps(vz + i), dt)));
+	}
+#endif
+	for (; i < p_to; i++) {
+		px[i] += vx[i] * step[i];
+		py[i] += vy[i] * step[i];
+		pz[i] += vz[i] * step[i];
 	}
 }
 
@@ -992,7 +1098,6 @@ void CPUParticles3D::_update_particle_data_buffer() {
 
 	float *w = particle_data.ptrw();
 	const Particle *r = particles.ptr();
-	float *ptr = w;
 
 	if (draw_order != DRAW_ORDER_INDEX) {
 		ow = particle_order.ptrw();
@@ -1020,17 +1125,48 @@ void CPUParticles3D::_update_particle_data_buffer() {
 				}
 
 				SortArray<int, SortAxis> sorter;
-				sorter.compare.particles = r;
+				for (int i = 0; i < 3; i++) {
+					sorter.compare.position[i] = particle_position[i].ptr();
+				}
 				sorter.compare.axis = dir;
 				sorter.sort(order, pc);
 			}
 		}
 	}
 
-	for (int i = 0; i < pc; i++) {
+	DataChunks chunks;
+	chunks.order = order;
+	chunks.data = w;
+
+	uint32_t chunk_count = (pc + PROCESS_CHUNK_SIZE - 1) / PROCESS_CHUNK_SIZE;
+	ThreadWorkPool *pool = _get_chunk_work_pool(chunk_count);
+	if (pool) {
+		pool->do_work(chunk_count, this, &CPUParticles3D::_update_particle_data_chunk, &chunks);
+	} else {
+		for (uint32_t i = 0; i < chunk_count; i++) {
+			_update_particle_data_chunk(i, &chunks);
+		}
+	}
+
+	can_update.set();
+}
+
+void CPUParticles3D::_update_particle_data_chunk(uint32_t p_chunk, const DataChunks *p_chunks) {
+	int pc = particles.size();
+	const Particle *r = particles.ptr();
+	const real_t *px = particle_position[0].ptr();
+	const real_t *py = particle_position[1].ptr();
+	const real_t *pz = particle_position[2].ptr();
+	const int *order = p_chunks->order;
+
+	int from = p_chunk * PROCESS_CHUNK_SIZE;
+	int to = MIN(from + PROCESS_CHUNK_SIZE, pc);
+	float *ptr = p_chunks->data + from * 20;
+
+	for (int i = from; i < to; i++) {
 		int idx = order ? order[i] : i;
 
-		Transform3D t = r[idx].transform;
+		Transform3D t(r[idx].basis, Vector3(px[idx], py[idx], pz[idx]));
 
 		if (!local_coords) {
 			t = inv_emission_transform * t;
@@ -1067,8 +1203,6 @@ void CPUParticles3D::_update_particle_data_buffer() {
 
 		ptr += 20;
 	}
-
-	can_update.set();
 }
 
 void CPUParticles3D::_set_redraw(bool p_redraw) {
@@ -1136,10 +1270,13 @@ void CPUParticles3D::_notification(int p_what) {
 
 			float *w = particle_data.ptrw();
 			const Particle *r = particles.ptr();
+			const real_t *px = particle_position[0].ptr();
+			const real_t *py = particle_position[1].ptr();
+			const real_t *pz = particle_position[2].ptr();
 			float *ptr = w;
 
 			for (int i = 0; i < pc; i++) {
-				Transform3D t = inv_emission_transform * r[i].transform;
+				Transform3D t = inv_emission_transform * Transform3D(r[i].basis, Vector3(px[i], py[i], pz[i]));
 
 				if (r[i].active) {
 					ptr[0] = t.basis.elements[0][0];
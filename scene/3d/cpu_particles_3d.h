@@ -31,10 +31,13 @@
 #ifndef CPU_PARTICLES_H
 #define CPU_PARTICLES_H
 
+#include "core/templates/local_vector.h"
 #include "core/templates/rid.h"
 #include "core/templates/safe_refcount.h"
 #include "scene/3d/visual_instance_3d.h"
 
+class ThreadWorkPool;
+
 class CPUParticles3D : public GeometryInstance3D {
 private:
 	GDCLASS(CPUParticles3D, GeometryInstance3D);
@@ -83,10 +86,9 @@ private:
 	bool emitting = false;
 
 	struct Particle {
-		Transform3D transform;
+		Basis basis;
 		Color color;
 		float custom[4] = {};
-		Vector3 velocity;
 		bool active = false;
 		float angle_rand = 0.0;
 		float scale_rand = 0.0;
@@ -111,6 +113,13 @@ private:
 	Vector<float> particle_data;
 	Vector<int> particle_order;
 
+	// Positions and velocities are kept out of Particle, one array per axis, so integration can
+	// move several particles per instruction. The step is how far in time each particle moves
+	// this frame, 0 for those that stay put.
+	LocalVector<real_t> particle_position[3];
+	LocalVector<real_t> particle_velocity[3];
+	LocalVector<float> particle_step;
+
 	struct SortLifetime {
 		const Particle *particles = nullptr;
 
@@ -120,10 +129,10 @@ private:
 	};
 
 	struct SortAxis {
-		const Particle *particles = nullptr;
+		const real_t *position[3] = {};
 		Vector3 axis;
 		bool operator()(int p_a, int p_b) const {
-			return axis.dot(particles[p_a].transform.origin) < axis.dot(particles[p_b].transform.origin);
+			return axis.dot(Vector3(position[0][p_a], position[1][p_a], position[2][p_a])) < axis.dot(Vector3(position[0][p_b], position[1][p_b], position[2][p_b]));
 		}
 	};
 
@@ -174,9 +183,35 @@ private:
 
 	Vector3 gravity = Vector3(0, -9.8, 0);
 
+	// Particles are simulated and packed in chunks, which run on the scene tree worker threads when there are several.
+	// Every chunk draws from its own random stream, so the result doesn't depend on how chunks are distributed.
+	enum {
+		PROCESS_CHUNK_SIZE = 256
+	};
+
+	struct ProcessFrame {
+		float delta = 0.0;
+		float prev_time = 0.0;
+		float system_phase = 0.0;
+		uint64_t seed = 0;
+		Transform3D emission_xform;
+		Basis velocity_xform;
+	};
+
+	ProcessFrame process_frame;
+
+	struct DataChunks {
+		const int *order = nullptr;
+		float *data = nullptr;
+	};
+
+	ThreadWorkPool *_get_chunk_work_pool(uint32_t p_chunk_count) const;
 	void _update_internal();
 	void _particles_process(float p_delta);
+	void _process_particle_chunk(uint32_t p_chunk, Particle *p_particles);
+	void _integrate_particles(int p_from, int p_to);
 	void _update_particle_data_buffer();
+	void _update_particle_data_chunk(uint32_t p_chunk, const DataChunks *p_chunks);
 
 	Mutex update_mutex;
 
@@ -284,6 +319,9 @@ public:
 
 	void restart();
 
+	// The instance buffer of the last update, 20 floats per particle.
+	Vector<float> get_particle_data() const;
+
 	void convert_from_particles(Node *p_particles);
 
 	CPUParticles3D();
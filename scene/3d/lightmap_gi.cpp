@@ -618,6 +618,273 @@ void LightmapGI::_gen_new_positions_from_octree(const GenProbesOctree *p_cell, f
 	}
 }
 
+static Ref<Image> _get_bake_texture_image(const Ref<Texture2D> &p_texture) {
+	if (p_texture.is_null()) {
+		return Ref<Image>();
+	}
+	Ref<Image> image = p_texture->get_image();
+	if (image.is_null() || image->is_empty()) {
+		return Ref<Image>();
+	}
+	if (image->is_compressed()) {
+		Ref<Image> decompressed;
+		decompressed.instantiate();
+		decompressed->copy_internals_from(image);
+		decompressed->decompress();
+		image = decompressed;
+	}
+	return image;
+}
+
+// Nearest filtered with repeat, the default for material textures.
+static Color _sample_bake_texture(const Ref<Image> &p_image, const Vector2 &p_uv) {
+	int width = p_image->get_width();
+	int height = p_image->get_height();
+	int x = int(Math::floor(p_uv.x * width)) % width;
+	int y = int(Math::floor(p_uv.y * height)) % height;
+	return p_image->get_pixel(x < 0 ? x + width : x, y < 0 ? y + height : y);
+}
+
+static float _get_bake_texture_channel(const Color &p_color, BaseMaterial3D::TextureChannel p_channel) {
+	switch (p_channel) {
+		case BaseMaterial3D::TEXTURE_CHANNEL_RED:
+			return p_color.r;
+		case BaseMaterial3D::TEXTURE_CHANNEL_GREEN:
+			return p_color.g;
+		case BaseMaterial3D::TEXTURE_CHANNEL_BLUE:
+			return p_color.b;
+		case BaseMaterial3D::TEXTURE_CHANNEL_ALPHA:
+			return p_color.a;
+		case BaseMaterial3D::TEXTURE_CHANNEL_GRAYSCALE:
+			return (p_color.r + p_color.g + p_color.b) / 3.0;
+		default:
+			return p_color.r;
+	}
+}
+
+TypedArray<Image> LightmapGI::bake_render_uv2_cpu(const Ref<Mesh> &p_mesh, const Vector<Ref<Material>> &p_material_overrides, const Size2i &p_image_size) {
+	ERR_FAIL_COND_V(p_mesh.is_null(), TypedArray<Image>());
+	ERR_FAIL_COND_V(p_image_size.width <= 0 || p_image_size.height <= 0, TypedArray<Image>());
+
+	const int width = p_image_size.width;
+	const int height = p_image_size.height;
+	const int pixel_count = width * height;
+
+	LocalVector<Color> albedo;
+	LocalVector<Color> orm;
+	LocalVector<Color> emission;
+	LocalVector<Vector3> normal;
+	LocalVector<uint8_t> covered;
+	albedo.resize(pixel_count);
+	orm.resize(pixel_count);
+	emission.resize(pixel_count);
+	normal.resize(pixel_count);
+	covered.resize(pixel_count);
+	for (int i = 0; i < pixel_count; i++) {
+		albedo[i] = Color(0, 0, 0, 0);
+		orm[i] = Color(1, 1, 0);
+		emission[i] = Color(0, 0, 0);
+		normal[i] = Vector3(0, 0, 1);
+		covered[i] = 0;
+	}
+
+	for (int s = 0; s < p_mesh->get_surface_count(); s++) {
+		if (p_mesh->surface_get_primitive_type(s) != Mesh::PRIMITIVE_TRIANGLES) {
+			continue;
+		}
+
+		Ref<Material> material = s < p_material_overrides.size() && p_material_overrides[s].is_valid() ? p_material_overrides[s] : p_mesh->surface_get_material(s);
+
+		// Other materials bake like the default material.
+		Color albedo_color(1, 1, 1);
+		float metallic = 0.0;
+		float roughness = 1.0;
+		Color emission_color(0, 0, 0);
+		bool emission_multiply = false;
+		bool use_vertex_color = false;
+		Vector2 uv_scale(1, 1);
+		Vector2 uv_offset;
+		Ref<Image> albedo_texture;
+		Ref<Image> metallic_texture;
+		Ref<Image> roughness_texture;
+		Ref<Image> emission_texture;
+		BaseMaterial3D::TextureChannel metallic_channel = BaseMaterial3D::TEXTURE_CHANNEL_RED;
+		BaseMaterial3D::TextureChannel roughness_channel = BaseMaterial3D::TEXTURE_CHANNEL_RED;
+
+		Ref<BaseMaterial3D> base_material = material;
+		if (base_material.is_valid()) {
+			albedo_color = base_material->get_albedo().to_linear();
+			metallic = base_material->get_metallic();
+			roughness = base_material->get_roughness();
+			use_vertex_color = base_material->get_flag(BaseMaterial3D::FLAG_ALBEDO_FROM_VERTEX_COLOR);
+			Vector3 scale = base_material->get_uv1_scale();
+			Vector3 offset = base_material->get_uv1_offset();
+			uv_scale = Vector2(scale.x, scale.y);
+			uv_offset = Vector2(offset.x, offset.y);
+			albedo_texture = _get_bake_texture_image(base_material->get_texture(BaseMaterial3D::TEXTURE_ALBEDO));
+			metallic_texture = _get_bake_texture_image(base_material->get_texture(BaseMaterial3D::TEXTURE_METALLIC));
+			roughness_texture = _get_bake_texture_image(base_material->get_texture(BaseMaterial3D::TEXTURE_ROUGHNESS));
+			metallic_channel = base_material->get_metallic_texture_channel();
+			roughness_channel = base_material->get_roughness_texture_channel();
+			if (base_material->get_feature(BaseMaterial3D::FEATURE_EMISSION)) {
+				emission_color = base_material->get_emission().to_linear() * base_material->get_emission_energy();
+				emission_multiply = base_material->get_emission_operator() == BaseMaterial3D::EMISSION_OP_MULTIPLY;
+				emission_texture = _get_bake_texture_image(base_material->get_texture(BaseMaterial3D::TEXTURE_EMISSION));
+			}
+		}
+
+		Array arrays = p_mesh->surface_get_arrays(s);
+		Vector<Vector2> uv2 = arrays[Mesh::ARRAY_TEX_UV2];
+		Vector<Vector2> uv = arrays[Mesh::ARRAY_TEX_UV];
+		Vector<Vector3> normals = arrays[Mesh::ARRAY_NORMAL];
+		Vector<Color> colors = arrays[Mesh::ARRAY_COLOR];
+		Vector<int> indices = arrays[Mesh::ARRAY_INDEX];
+		ERR_CONTINUE(uv2.is_empty());
+
+		const int vertex_count = uv2.size();
+		const bool has_uv = uv.size() == vertex_count;
+		const bool has_normals = normals.size() == vertex_count;
+		const bool has_colors = use_vertex_color && colors.size() == vertex_count;
+		const int face_count = indices.size() ? indices.size() / 3 : vertex_count / 3;
+
+		for (int f = 0; f < face_count; f++) {
+			int v[3];
+			for (int j = 0; j < 3; j++) {
+				v[j] = indices.size() ? indices[f * 3 + j] : f * 3 + j;
+				ERR_FAIL_INDEX_V(v[j], vertex_count, TypedArray<Image>());
+			}
+
+			Vector2 p[3];
+			for (int j = 0; j < 3; j++) {
+				p[j] = uv2[v[j]] * Vector2(width, height);
+			}
+			float area = (p[1] - p[0]).cross(p[2] - p[0]);
+			if (Math::is_zero_approx(area)) {
+				continue;
+			}
+
+			Rect2 rect(p[0], Vector2());
+			rect.expand_to(p[1]);
+			rect.expand_to(p[2]);
+			int from_x = CLAMP(int(Math::floor(rect.position.x)), 0, width - 1);
+			int from_y = CLAMP(int(Math::floor(rect.position.y)), 0, height - 1);
+			int to_x = CLAMP(int(Math::ceil(rect.position.x + rect.size.x)), 0, width - 1);
+			int to_y = CLAMP(int(Math::ceil(rect.position.y + rect.size.y)), 0, height - 1);
+
+			for (int y = from_y; y <= to_y; y++) {
+				for (int x = from_x; x <= to_x; x++) {
+					// Texel centers, like the lightmappers sample.
+					Vector2 center(x + 0.5, y + 0.5);
+					float b1 = (center - p[0]).cross(p[2] - p[0]) / area;
+					float b2 = (p[1] - p[0]).cross(center - p[0]) / area;
+					float b0 = 1.0 - b1 - b2;
+					if (b0 < 0 || b1 < 0 || b2 < 0) {
+						continue;
+					}
+
+					Color texel_albedo = albedo_color;
+					Color texel_emission = emission_color;
+					float texel_metallic = metallic;
+					float texel_roughness = roughness;
+					if (has_uv) {
+						Vector2 texel_uv = (uv[v[0]] * b0 + uv[v[1]] * b1 + uv[v[2]] * b2) * uv_scale + uv_offset;
+						if (albedo_texture.is_valid()) {
+							texel_albedo *= _sample_bake_texture(albedo_texture, texel_uv).to_linear();
+						}
+						if (metallic_texture.is_valid()) {
+							texel_metallic *= _get_bake_texture_channel(_sample_bake_texture(metallic_texture, texel_uv), metallic_channel);
+						}
+						if (roughness_texture.is_valid()) {
+							texel_roughness *= _get_bake_texture_channel(_sample_bake_texture(roughness_texture, texel_uv), roughness_channel);
+						}
+						if (emission_texture.is_valid()) {
+							Color emission_sample = _sample_bake_texture(emission_texture, texel_uv).to_linear();
+							if (emission_multiply) {
+								texel_emission *= emission_sample;
+							} else {
+								texel_emission += emission_sample * base_material->get_emission_energy();
+							}
+						}
+					}
+					if (has_colors) {
+						texel_albedo *= colors[v[0]] * b0 + colors[v[1]] * b1 + colors[v[2]] * b2;
+					}
+
+					int ofs = y * width + x;
+					albedo[ofs] = Color(texel_albedo.r, texel_albedo.g, texel_albedo.b, 1.0);
+					orm[ofs] = Color(1.0, texel_roughness, texel_metallic);
+					emission[ofs] = Color(texel_emission.r, texel_emission.g, texel_emission.b, 1.0);
+					if (has_normals) {
+						normal[ofs] = (normals[v[0]] * b0 + normals[v[1]] * b1 + normals[v[2]] * b2).normalized();
+					}
+					covered[ofs] = 1;
+				}
+			}
+		}
+	}
+
+	// Grow the charts by a couple of texels, as edge texels with their centers outside every
+	// triangle are still sampled by the lightmappers.
+	for (int pass = 0; pass < 2; pass++) {
+		LocalVector<uint8_t> was_covered = covered;
+		for (int y = 0; y < height; y++) {
+			for (int x = 0; x < width; x++) {
+				int ofs = y * width + x;
+				if (was_covered[ofs]) {
+					continue;
+				}
+				const Vector2i neighbors[4] = { Vector2i(x - 1, y), Vector2i(x + 1, y), Vector2i(x, y - 1), Vector2i(x, y + 1) };
+				for (int j = 0; j < 4; j++) {
+					if (neighbors[j].x < 0 || neighbors[j].x >= width || neighbors[j].y < 0 || neighbors[j].y >= height) {
+						continue;
+					}
+					int from = neighbors[j].y * width + neighbors[j].x;
+					if (was_covered[from]) {
+						albedo[ofs] = albedo[from];
+						orm[ofs] = orm[from];
+						emission[ofs] = emission[from];
+						normal[ofs] = normal[from];
+						covered[ofs] = 1;
+						break;
+					}
+				}
+			}
+		}
+	}
+
+	Ref<Image> albedo_image;
+	albedo_image.instantiate();
+	albedo_image->create(width, height, false, Image::FORMAT_RGBA8);
+	Ref<Image> normal_image;
+	normal_image.instantiate();
+	normal_image->create(width, height, false, Image::FORMAT_RGBA8);
+	Ref<Image> orm_image;
+	orm_image.instantiate();
+	orm_image->create(width, height, false, Image::FORMAT_RGBA8);
+	Ref<Image> emission_image;
+	emission_image.instantiate();
+	emission_image->create(width, height, false, Image::FORMAT_RGBAH);
+
+	for (int y = 0; y < height; y++) {
+		for (int x = 0; x < width; x++) {
+			int ofs = y * width + x;
+			albedo_image->set_pixel(x, y, albedo[ofs]);
+			Vector3 n = normal[ofs] * 0.5 + Vector3(0.5, 0.5, 0.5);
+			normal_image->set_pixel(x, y, Color(n.x, n.y, n.z));
+			orm_image->set_pixel(x, y, orm[ofs]);
+			emission_image->set_pixel(x, y, emission[ofs]);
+		}
+	}
+
+	TypedArray<Image> images;
+	images.resize(RS::BAKE_CHANNEL_EMISSION + 1);
+	images[RS::BAKE_CHANNEL_ALBEDO_ALPHA] = albedo_image;
+	images[RS::BAKE_CHANNEL_NORMAL] = normal_image;
+	images[RS::BAKE_CHANNEL_ORM] = orm_image;
+	images[RS::BAKE_CHANNEL_EMISSION] = emission_image;
+	return images;
+}
+
 LightmapGI::BakeError LightmapGI::bake(Node *p_from_node, String p_image_data_path, Lightmapper::BakeStepFunc p_bake_step, void *p_bake_userdata) {
 	if (p_image_data_path == "") {
 		if (get_light_data().is_null()) {
@@ -674,6 +941,10 @@ LightmapGI::BakeError LightmapGI::bake(Node *p_from_node, String p_image_data_pa
 				}
 			}
 			TypedArray<Image> images = RS::get_singleton()->bake_render_uv2(mf.mesh->get_rid(), overrides, lightmap_size);
+			if (images.is_empty()) {
+				// Renderers without a RenderingDevice can't draw the materials, like headless bake servers.
+				images = bake_render_uv2_cpu(mf.mesh, mf.overrides, lightmap_size);
+			}
 
 			ERR_FAIL_COND_V(images.is_empty(), BAKE_ERROR_CANT_CREATE_IMAGE);
 
@@ -273,6 +273,9 @@ public:
 	Vector<Face3> get_faces(uint32_t p_usage_flags) const override;
 
 	BakeError bake(Node *p_from_node, String p_image_data_path = "", Lightmapper::BakeStepFunc p_bake_step = nullptr, void *p_bake_userdata = nullptr);
+
+	// Same channels as RenderingServer::bake_render_uv2(), read from the materials instead of rendered.
+	static TypedArray<Image> bake_render_uv2_cpu(const Ref<Mesh> &p_mesh, const Vector<Ref<Material>> &p_material_overrides, const Size2i &p_image_size);
 	LightmapGI();
 };
 
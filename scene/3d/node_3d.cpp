@@ -81,7 +81,7 @@ void Node3D::_notify_dirty() {
 	if (data.notify_transform && !data.ignore_notification && !xform_change.in_list()) {
 
 #endif
-		get_tree()->xform_change_list.add(&xform_change);
+		get_tree()->_add_xform_change(&xform_change);
 	}
 }
 
@@ -91,34 +91,44 @@ void Node3D::_update_local_transform() const {
 	data.dirty &= ~DIRTY_LOCAL;
 }
 
-void Node3D::_propagate_transform_changed(Node3D *p_origin) {
+void Node3D::_propagate_transform_changed() {
 	if (!is_inside_tree()) {
 		return;
 	}
 
-	/*
-	if (data.dirty&DIRTY_GLOBAL)
-		return; //already dirty
-	*/
+	// Walk the subtree breadth first instead of recursing, so deep hierarchies (long chains of
+	// attachments or bones) don't use a call frame per level.
+	static thread_local LocalVector<Node3D *> nodes;
+	uint32_t base = nodes.size();
+	nodes.push_back(this);
 
-	data.children_lock++;
-
-	for (List<Node3D *>::Element *E = data.children.front(); E; E = E->next()) {
-		if (E->get()->data.top_level_active) {
-			continue; //don't propagate to a top_level
+	for (uint32_t i = base; i < nodes.size(); i++) {
+		Node3D *node = nodes[i];
+		for (List<Node3D *>::Element *E = node->data.children.front(); E; E = E->next()) {
+			if (E->get()->data.top_level_active) {
+				continue; //don't propagate to a top_level
+			}
+			nodes.push_back(E->get());
 		}
-		E->get()->_propagate_transform_changed(p_origin);
+		node->data.dirty |= DIRTY_GLOBAL;
 	}
+
+	// Added in reverse, so the list starts parents first, the order SceneTree notifies in.
+	SceneTree *tree = get_tree();
+	tree->_lock_xform_change_list();
+	for (uint32_t i = nodes.size(); i > base; i--) {
+		Node3D *node = nodes[i - 1];
 #ifdef TOOLS_ENABLED
-	if ((data.gizmo.is_valid() || data.notify_transform) && !data.ignore_notification && !xform_change.in_list()) {
+		if ((node->data.gizmo.is_valid() || node->data.notify_transform) && !node->data.ignore_notification && !node->xform_change.in_list()) {
 #else
-	if (data.notify_transform && !data.ignore_notification && !xform_change.in_list()) {
+		if (node->data.notify_transform && !node->data.ignore_notification && !node->xform_change.in_list()) {
 #endif
-		get_tree()->xform_change_list.add(&xform_change);
+			tree->xform_change_list.add(&node->xform_change);
+		}
 	}
-	data.dirty |= DIRTY_GLOBAL;
+	tree->_unlock_xform_change_list();
 
-	data.children_lock--;
+	nodes.resize(base);
 }
 
 void Node3D::_notification(int p_what) {
@@ -154,9 +164,7 @@ void Node3D::_notification(int p_what) {
 		} break;
 		case NOTIFICATION_EXIT_TREE: {
 			notification(NOTIFICATION_EXIT_WORLD, true);
-			if (xform_change.in_list()) {
-				get_tree()->xform_change_list.remove(&xform_change);
-			}
+			get_tree()->_remove_xform_change(&xform_change);
 			if (data.C) {
 				data.parent->data.children.erase(data.C);
 			}
@@ -229,7 +237,7 @@ void Node3D::_notification(int p_what) {
 void Node3D::set_transform(const Transform3D &p_transform) {
 	data.local_transform = p_transform;
 	data.dirty |= DIRTY_VECTORS;
-	_propagate_transform_changed(this);
+	_propagate_transform_changed();
 	if (data.notify_local_transform) {
 		notification(NOTIFICATION_LOCAL_TRANSFORM_CHANGED);
 	}
@@ -308,7 +316,7 @@ Transform3D Node3D::get_relative_transform(const Node *p_parent) const {
 
 void Node3D::set_position(const Vector3 &p_position) {
 	data.local_transform.origin = p_position;
-	_propagate_transform_changed(this);
+	_propagate_transform_changed();
 	if (data.notify_local_transform) {
 		notification(NOTIFICATION_LOCAL_TRANSFORM_CHANGED);
 	}
@@ -322,7 +330,7 @@ void Node3D::set_rotation(const Vector3 &p_euler_rad) {
 
 	data.rotation = p_euler_rad;
 	data.dirty |= DIRTY_LOCAL;
-	_propagate_transform_changed(this);
+	_propagate_transform_changed();
 	if (data.notify_local_transform) {
 		notification(NOTIFICATION_LOCAL_TRANSFORM_CHANGED);
 	}
@@ -340,7 +348,7 @@ void Node3D::set_scale(const Vector3 &p_scale) {
 
 	data.scale = p_scale;
 	data.dirty |= DIRTY_LOCAL;
-	_propagate_transform_changed(this);
+	_propagate_transform_changed();
 	if (data.notify_local_transform) {
 		notification(NOTIFICATION_LOCAL_TRANSFORM_CHANGED);
 	}
@@ -689,10 +697,9 @@ bool Node3D::is_local_transform_notification_enabled() const {
 
 void Node3D::force_update_transform() {
 	ERR_FAIL_COND(!is_inside_tree());
-	if (!xform_change.in_list()) {
+	if (!get_tree()->_remove_xform_change(&xform_change)) {
 		return; //nothing to update
 	}
-	get_tree()->xform_change_list.remove(&xform_change);
 
 	notification(NOTIFICATION_TRANSFORM_CHANGED);
 }
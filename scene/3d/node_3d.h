@@ -101,7 +101,7 @@ class Node3D : public Node {
 
 	void _update_gizmo();
 	void _notify_dirty();
-	void _propagate_transform_changed(Node3D *p_origin);
+	void _propagate_transform_changed();
 
 	void _propagate_visibility_changed();
 
@@ -38,6 +38,61 @@
 #include "scene/resources/surface_tool.h"
 #include "scene/scene_string_names.h"
 
+#if !defined(REAL_T_IS_DOUBLE)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SKELETON_3D_SSE2
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define SKELETON_3D_NEON
+#include <arm_neon.h>
+#endif
+#endif
+
+// Writes p_pose * p_bind as the 3x4 row-major matrix the skeleton buffer expects.
+// Each output row is a combination of the rows of p_bind (with its origin as
+// fourth column), weighted by the matching row of p_pose.
+static _FORCE_INLINE_ void _write_skin_transform(const Transform3D &p_pose, const Transform3D &p_bind, float *r_dst) {
+	const Basis &a = p_pose.basis;
+	const Basis &b = p_bind.basis;
+#if defined(SKELETON_3D_SSE2)
+	const __m128 b0 = _mm_setr_ps(b.elements[0][0], b.elements[0][1], b.elements[0][2], p_bind.origin.x);
+	const __m128 b1 = _mm_setr_ps(b.elements[1][0], b.elements[1][1], b.elements[1][2], p_bind.origin.y);
+	const __m128 b2 = _mm_setr_ps(b.elements[2][0], b.elements[2][1], b.elements[2][2], p_bind.origin.z);
+	for (int i = 0; i < 3; i++) {
+		__m128 row = _mm_setr_ps(0, 0, 0, p_pose.origin[i]);
+		row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(a.elements[i][0]), b0));
+		row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(a.elements[i][1]), b1));
+		row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(a.elements[i][2]), b2));
+		_mm_storeu_ps(r_dst + i * 4, row);
+	}
+#elif defined(SKELETON_3D_NEON)
+	const float b_rows[12] = {
+		b.elements[0][0], b.elements[0][1], b.elements[0][2], p_bind.origin.x,
+		b.elements[1][0], b.elements[1][1], b.elements[1][2], p_bind.origin.y,
+		b.elements[2][0], b.elements[2][1], b.elements[2][2], p_bind.origin.z
+	};
+	const float32x4_t b0 = vld1q_f32(b_rows);
+	const float32x4_t b1 = vld1q_f32(b_rows + 4);
+	const float32x4_t b2 = vld1q_f32(b_rows + 8);
+	for (int i = 0; i < 3; i++) {
+		const float origin[4] = { 0, 0, 0, p_pose.origin[i] };
+		float32x4_t row = vld1q_f32(origin);
+		row = vmlaq_n_f32(row, b0, a.elements[i][0]);
+		row = vmlaq_n_f32(row, b1, a.elements[i][1]);
+		row = vmlaq_n_f32(row, b2, a.elements[i][2]);
+		vst1q_f32(r_dst + i * 4, row);
+	}
+#else
+	const Transform3D xform = p_pose * p_bind;
+	for (int i = 0; i < 3; i++) {
+		r_dst[i * 4 + 0] = xform.basis.elements[i][0];
+		r_dst[i * 4 + 1] = xform.basis.elements[i][1];
+		r_dst[i * 4 + 2] = xform.basis.elements[i][2];
+		r_dst[i * 4 + 3] = xform.origin[i];
+	}
+#endif
+}
+
 void SkinReference::_skin_changed() {
 	if (skeleton_node) {
 		skeleton_node->_make_dirty();
@@ -59,6 +114,10 @@ Ref<Skin> SkinReference::get_skin() const {
 	return skin;
 }
 
+Vector<float> SkinReference::get_bone_buffer() const {
+	return bone_buffer;
+}
+
 SkinReference::~SkinReference() {
 	if (skeleton_node) {
 		skeleton_node->skin_bindings.erase(this);
@@ -206,61 +265,52 @@ void Skeleton3D::_notification(int p_what) {
 
 			const int *order = process_order.ptr();
 
+			// Bones are processed parents first, so a bone only needs to be recomputed if its
+			// own pose changed or its parent was recomputed.
+			bool update_all = dirty_all_bones;
+			dirty_all_bones = false;
+
 			for (int i = 0; i < len; i++) {
 				Bone &b = bonesptr[order[i]];
 
-				if (b.disable_rest) {
-					if (b.enabled) {
-						Transform3D pose = b.pose;
-						if (b.custom_pose_enable) {
-							pose = b.custom_pose * pose;
-						}
-						if (b.parent >= 0) {
-							b.pose_global = bonesptr[b.parent].pose_global * pose;
-							b.pose_global_no_override = bonesptr[b.parent].pose_global * pose;
-						} else {
-							b.pose_global = pose;
-							b.pose_global_no_override = pose;
-						}
-					} else {
-						if (b.parent >= 0) {
-							b.pose_global = bonesptr[b.parent].pose_global;
-							b.pose_global_no_override = bonesptr[b.parent].pose_global;
-						} else {
-							b.pose_global = Transform3D();
-							b.pose_global_no_override = Transform3D();
-						}
-					}
+				bool parent_changed = b.parent >= 0 && bonesptr[b.parent].global_pose_changed;
+				b.global_pose_changed = update_all || b.pose_dirty || parent_changed || b.global_pose_override_amount >= CMP_EPSILON;
+				b.pose_dirty = false;
+
+				if (!b.global_pose_changed) {
+					continue;
+				}
 
+				Transform3D pose_global;
+
+				if (b.enabled) {
+					Transform3D pose = b.pose;
+					if (b.custom_pose_enable) {
+						pose = b.custom_pose * pose;
+					}
+					if (!b.disable_rest) {
+						pose = b.rest * pose;
+					}
+					pose_global = b.parent >= 0 ? bonesptr[b.parent].pose_global * pose : pose;
 				} else {
-					if (b.enabled) {
-						Transform3D pose = b.pose;
-						if (b.custom_pose_enable) {
-							pose = b.custom_pose * pose;
-						}
-						if (b.parent >= 0) {
-							b.pose_global = bonesptr[b.parent].pose_global * (b.rest * pose);
-							b.pose_global_no_override = bonesptr[b.parent].pose_global * (b.rest * pose);
-						} else {
-							b.pose_global = b.rest * pose;
-							b.pose_global_no_override = b.rest * pose;
-						}
+					if (b.disable_rest) {
+						pose_global = b.parent >= 0 ? bonesptr[b.parent].pose_global : Transform3D();
 					} else {
-						if (b.parent >= 0) {
-							b.pose_global = bonesptr[b.parent].pose_global * b.rest;
-							b.pose_global_no_override = bonesptr[b.parent].pose_global * b.rest;
-						} else {
-							b.pose_global = b.rest;
-							b.pose_global_no_override = b.rest;
-						}
+						pose_global = b.parent >= 0 ? bonesptr[b.parent].pose_global * b.rest : b.rest;
 					}
 				}
 
+				b.pose_global = pose_global;
+				b.pose_global_no_override = pose_global;
+
 				if (b.global_pose_override_amount >= CMP_EPSILON) {
 					b.pose_global = b.pose_global.interpolate_with(b.global_pose_override, b.global_pose_override_amount);
 				}
 
 				if (b.global_pose_override_reset) {
+					if (b.global_pose_override_amount >= CMP_EPSILON) {
+						b.pose_dirty = true; // Recompute without the override next time.
+					}
 					b.global_pose_override_amount = 0.0;
 				}
 
@@ -279,14 +329,20 @@ void Skeleton3D::_notification(int p_what) {
 				RID skeleton = E->get()->skeleton;
 				uint32_t bind_count = skin->get_bind_count();
 
+				// Bind poses may have changed too, in which case every bind needs to be uploaded again.
+				bool full_update = update_all;
+
 				if (E->get()->bind_count != bind_count) {
 					RS::get_singleton()->skeleton_allocate_data(skeleton, bind_count);
 					E->get()->bind_count = bind_count;
 					E->get()->skin_bone_indices.resize(bind_count);
 					E->get()->skin_bone_indices_ptrs = E->get()->skin_bone_indices.ptrw();
+					full_update = true;
 				}
 
 				if (E->get()->skeleton_version != version) {
+					full_update = true;
+
 					for (uint32_t i = 0; i < bind_count; i++) {
 						StringName bind_name = skin->get_bind_name(i);
 
@@ -322,10 +378,29 @@ void Skeleton3D::_notification(int p_what) {
 					E->get()->skeleton_version = version;
 				}
 
+				// Only changed bones are written to the buffer, which is then sent to the server in one call.
+				if (E->get()->bone_buffer.size() != int(bind_count * 12)) {
+					E->get()->bone_buffer.resize(bind_count * 12);
+					full_update = true;
+				}
+
+				float *bufptr = E->get()->bone_buffer.ptrw();
+				bool buffer_changed = full_update;
+
 				for (uint32_t i = 0; i < bind_count; i++) {
 					uint32_t bone_index = E->get()->skin_bone_indices_ptrs[i];
 					ERR_CONTINUE(bone_index >= (uint32_t)len);
-					rs->skeleton_bone_set_transform(skeleton, i, bonesptr[bone_index].pose_global * skin->get_bind_pose(i));
+					if (!full_update && !bonesptr[bone_index].global_pose_changed) {
+						continue;
+					}
+
+					_write_skin_transform(bonesptr[bone_index].pose_global, skin->get_bind_pose(i), bufptr + i * 12);
+
+					buffer_changed = true;
+				}
+
+				if (buffer_changed && bind_count) {
+					rs->skeleton_set_buffer(skeleton, E->get()->bone_buffer);
 				}
 			}
 
@@ -371,7 +446,7 @@ void Skeleton3D::set_bone_global_pose_override(int p_bone, const Transform3D &p_
 	bones.write[p_bone].global_pose_override_amount = p_amount;
 	bones.write[p_bone].global_pose_override = p_pose;
 	bones.write[p_bone].global_pose_override_reset = !p_persistent;
-	_make_dirty();
+	_make_bone_dirty(p_bone);
 }
 
 Transform3D Skeleton3D::get_bone_global_pose(int p_bone) const {
@@ -481,6 +556,7 @@ void Skeleton3D::unparent_bone_and_rest(int p_bone) {
 void Skeleton3D::set_bone_disable_rest(int p_bone, bool p_disable) {
 	ERR_FAIL_INDEX(p_bone, bones.size());
 	bones.write[p_bone].disable_rest = p_disable;
+	bones.write[p_bone].pose_dirty = true;
 }
 
 bool Skeleton3D::is_bone_rest_disabled(int p_bone) const {
@@ -563,9 +639,15 @@ void Skeleton3D::clear_bones() {
 void Skeleton3D::set_bone_pose(int p_bone, const Transform3D &p_pose) {
 	ERR_FAIL_INDEX(p_bone, bones.size());
 
-	bones.write[p_bone].pose = p_pose;
+	Bone &bone = bones.write[p_bone];
+	if (bone.pose == p_pose) {
+		return;
+	}
+
+	bone.pose = p_pose;
+	bone.pose_dirty = true;
 	if (is_inside_tree()) {
-		_make_dirty();
+		_queue_update();
 	}
 }
 Transform3D Skeleton3D::get_bone_pose(int p_bone) const {
@@ -573,6 +655,72 @@ Transform3D Skeleton3D::get_bone_pose(int p_bone) const {
 	return bones[p_bone].pose;
 }
 
+void Skeleton3D::set_bone_pose_buffer(const Vector<float> &p_buffer) {
+	int len = bones.size();
+	ERR_FAIL_COND(p_buffer.size() != len * 12);
+
+	Bone *bonesptr = bones.ptrw();
+	const float *r = p_buffer.ptr();
+	bool changed = false;
+
+	for (int i = 0; i < len; i++) {
+		const float *dataptr = r + i * 12;
+
+		Transform3D pose;
+		pose.basis.elements[0][0] = dataptr[0];
+		pose.basis.elements[0][1] = dataptr[1];
+		pose.basis.elements[0][2] = dataptr[2];
+		pose.origin.x = dataptr[3];
+		pose.basis.elements[1][0] = dataptr[4];
+		pose.basis.elements[1][1] = dataptr[5];
+		pose.basis.elements[1][2] = dataptr[6];
+		pose.origin.y = dataptr[7];
+		pose.basis.elements[2][0] = dataptr[8];
+		pose.basis.elements[2][1] = dataptr[9];
+		pose.basis.elements[2][2] = dataptr[10];
+		pose.origin.z = dataptr[11];
+
+		if (bonesptr[i].pose != pose) {
+			bonesptr[i].pose = pose;
+			bonesptr[i].pose_dirty = true;
+			changed = true;
+		}
+	}
+
+	if (changed && is_inside_tree()) {
+		_queue_update();
+	}
+}
+
+Vector<float> Skeleton3D::get_bone_pose_buffer() const {
+	int len = bones.size();
+	Vector<float> buffer;
+	buffer.resize(len * 12);
+
+	const Bone *bonesptr = bones.ptr();
+	float *w = buffer.ptrw();
+
+	for (int i = 0; i < len; i++) {
+		const Transform3D &pose = bonesptr[i].pose;
+		float *dataptr = w + i * 12;
+
+		dataptr[0] = pose.basis.elements[0][0];
+		dataptr[1] = pose.basis.elements[0][1];
+		dataptr[2] = pose.basis.elements[0][2];
+		dataptr[3] = pose.origin.x;
+		dataptr[4] = pose.basis.elements[1][0];
+		dataptr[5] = pose.basis.elements[1][1];
+		dataptr[6] = pose.basis.elements[1][2];
+		dataptr[7] = pose.origin.y;
+		dataptr[8] = pose.basis.elements[2][0];
+		dataptr[9] = pose.basis.elements[2][1];
+		dataptr[10] = pose.basis.elements[2][2];
+		dataptr[11] = pose.origin.z;
+	}
+
+	return buffer;
+}
+
 void Skeleton3D::set_bone_custom_pose(int p_bone, const Transform3D &p_custom_pose) {
 	ERR_FAIL_INDEX(p_bone, bones.size());
 	//ERR_FAIL_COND( !is_inside_scene() );
@@ -580,7 +728,7 @@ void Skeleton3D::set_bone_custom_pose(int p_bone, const Transform3D &p_custom_po
 	bones.write[p_bone].custom_pose_enable = (p_custom_pose != Transform3D());
 	bones.write[p_bone].custom_pose = p_custom_pose;
 
-	_make_dirty();
+	_make_bone_dirty(p_bone);
 }
 
 Transform3D Skeleton3D::get_bone_custom_pose(int p_bone) const {
@@ -589,6 +737,16 @@ Transform3D Skeleton3D::get_bone_custom_pose(int p_bone) const {
 }
 
 void Skeleton3D::_make_dirty() {
+	dirty_all_bones = true;
+	_queue_update();
+}
+
+void Skeleton3D::_make_bone_dirty(int p_bone) {
+	bones.write[p_bone].pose_dirty = true;
+	_queue_update();
+}
+
+void Skeleton3D::_queue_update() {
 	if (dirty) {
 		return;
 	}
@@ -881,6 +1039,9 @@ void Skeleton3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_bone_pose", "bone_idx"), &Skeleton3D::get_bone_pose);
 	ClassDB::bind_method(D_METHOD("set_bone_pose", "bone_idx", "pose"), &Skeleton3D::set_bone_pose);
 
+	ClassDB::bind_method(D_METHOD("get_bone_pose_buffer"), &Skeleton3D::get_bone_pose_buffer);
+	ClassDB::bind_method(D_METHOD("set_bone_pose_buffer", "buffer"), &Skeleton3D::set_bone_pose_buffer);
+
 	ClassDB::bind_method(D_METHOD("clear_bones_global_pose_override"), &Skeleton3D::clear_bones_global_pose_override);
 	ClassDB::bind_method(D_METHOD("set_bone_global_pose_override", "bone_idx", "pose", "amount", "persistent"), &Skeleton3D::set_bone_global_pose_override, DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("get_bone_global_pose", "bone_idx"), &Skeleton3D::get_bone_global_pose);
@@ -51,6 +51,7 @@ class SkinReference : public RefCounted {
 	uint64_t skeleton_version = 0;
 	Vector<uint32_t> skin_bone_indices;
 	uint32_t *skin_bone_indices_ptrs;
+	Vector<float> bone_buffer;
 	void _skin_changed();
 
 protected:
@@ -59,6 +60,8 @@ protected:
 public:
 	RID get_skeleton() const;
 	Ref<Skin> get_skin() const;
+	// The bind transforms last sent to the rendering server, 12 floats per bind.
+	Vector<float> get_bone_buffer() const;
 	~SkinReference();
 };
 
@@ -81,6 +84,8 @@ private:
 		Transform3D pose;
 		Transform3D pose_global;
 		Transform3D pose_global_no_override;
+		bool pose_dirty = true;
+		bool global_pose_changed = false;
 
 		bool custom_pose_enable = false;
 		Transform3D custom_pose;
@@ -105,7 +110,10 @@ private:
 	bool process_order_dirty = true;
 
 	void _make_dirty();
+	void _make_bone_dirty(int p_bone);
+	void _queue_update();
 	bool dirty = false;
+	bool dirty_all_bones = true;
 
 	uint64_t version = 1;
 
@@ -163,6 +171,9 @@ public:
 	void set_bone_pose(int p_bone, const Transform3D &p_pose);
 	Transform3D get_bone_pose(int p_bone) const;
 
+	void set_bone_pose_buffer(const Vector<float> &p_buffer);
+	Vector<float> get_bone_pose_buffer() const;
+
 	void set_bone_custom_pose(int p_bone, const Transform3D &p_custom_pose);
 	Transform3D get_bone_custom_pose(int p_bone) const;
 
@@ -211,7 +211,11 @@ void AnimationPlayer::_notification(int p_what) {
 			}
 
 			if (processing) {
-				_animation_process(get_process_delta_time());
+				if (process_threaded) {
+					_queue_threaded_process(get_process_delta_time());
+				} else {
+					_animation_process(get_process_delta_time());
+				}
 			}
 		} break;
 		case NOTIFICATION_INTERNAL_PHYSICS_PROCESS: {
@@ -220,10 +224,18 @@ void AnimationPlayer::_notification(int p_what) {
 			}
 
 			if (processing) {
-				_animation_process(get_physics_process_delta_time());
+				if (process_threaded) {
+					_queue_threaded_process(get_physics_process_delta_time());
+				} else {
+					_animation_process(get_physics_process_delta_time());
+				}
 			}
 		} break;
 		case NOTIFICATION_EXIT_TREE: {
+			if (threaded_queued) {
+				get_tree()->_unqueue_threaded_animation_player(this);
+				threaded_queued = false;
+			}
 			clear_caches();
 		} break;
 	}
@@ -342,19 +354,14 @@ void AnimationPlayer::_ensure_node_caches(AnimationData *p_anim, Node *p_root_ov
 }
 
 void AnimationPlayer::_animation_process_animation(AnimationData *p_anim, float p_time, float p_delta, float p_interp, bool p_is_current, bool p_seeked, bool p_started) {
-	_ensure_node_caches(p_anim);
+	// Caches are built in _animation_process_prepare(), on the main thread, as this may run
+	// on a worker thread. Tracks with side effects are only fired in the commit step, so the
+	// animation can't change while it's processed.
 	ERR_FAIL_COND(p_anim->node_cache.size() != p_anim->animation->get_track_count());
 
 	Animation *a = p_anim->animation.operator->();
-	bool can_call = is_inside_tree() && !Engine::get_singleton()->is_editor_hint();
 
 	for (int i = 0; i < a->get_track_count(); i++) {
-		// If an animation changes this animation (or it animates itself)
-		// we need to recreate our animation cache
-		if (p_anim->node_cache.size() != a->get_track_count()) {
-			_ensure_node_caches(p_anim);
-		}
-
 		TrackNodeCache *nc = p_anim->node_cache[i];
 
 		if (!nc) {
@@ -482,67 +489,140 @@ void AnimationPlayer::_animation_process_animation(AnimationData *p_anim, float
 					}
 
 				} else if (p_is_current && p_delta != 0) {
-					List<int> indices;
-					a->value_track_get_key_indices(i, p_time, p_delta, &indices);
-
-					for (List<int>::Element *F = indices.front(); F; F = F->next()) {
-						Variant value = a->track_get_key_value(i, F->get());
-						switch (pa->special) {
-							case SP_NONE: {
-								bool valid;
-								pa->object->set_indexed(pa->subpath, value, &valid); //you are not speshul
+					_animation_push_track_event(a, i, nc, pa, p_time, p_delta, p_seeked);
+				}
+
+			} break;
+			case Animation::TYPE_METHOD: {
+				if (!nc->node) {
+					continue;
+				}
+				if (p_delta == 0) {
+					continue;
+				}
+				if (!p_is_current) {
+					break;
+				}
+
+				_animation_push_track_event(a, i, nc, nullptr, p_time, p_delta, p_seeked);
+			} break;
+			case Animation::TYPE_BEZIER: {
+				if (!nc->node) {
+					continue;
+				}
+
+				Map<StringName, TrackNodeCache::BezierAnim>::Element *E = nc->bezier_anim.find(a->track_get_path(i).get_concatenated_subnames());
+				ERR_CONTINUE(!E); //should it continue, or create a new one?
+
+				TrackNodeCache::BezierAnim *ba = &E->get();
+
+				float bezier = a->bezier_track_interpolate(i, p_time);
+				if (ba->accum_pass != accum_pass) {
+					ERR_CONTINUE(cache_update_bezier_size >= NODE_CACHE_UPDATE_MAX);
+					cache_update_bezier[cache_update_bezier_size++] = ba;
+					ba->bezier_accum = bezier;
+					ba->accum_pass = accum_pass;
+				} else {
+					ba->bezier_accum = Math::lerp(ba->bezier_accum, bezier, p_interp);
+				}
+
+			} break;
+			case Animation::TYPE_AUDIO: {
+				if (!nc->node) {
+					continue;
+				}
+				if (p_delta == 0) {
+					continue;
+				}
+
+				_animation_push_track_event(a, i, nc, nullptr, p_time, p_delta, p_seeked);
+			} break;
+			case Animation::TYPE_ANIMATION: {
+				_animation_push_track_event(a, i, nc, nullptr, p_time, p_delta, p_seeked);
+			} break;
+		}
+	}
+}
+
+void AnimationPlayer::_animation_push_track_event(Animation *p_animation, int p_track, TrackNodeCache *p_nc, TrackNodeCache::PropertyAnim *p_pa, float p_time, float p_delta, bool p_seeked) {
+	TrackEvent ev;
+	ev.animation = Ref<Animation>(p_animation);
+	ev.track = p_track;
+	ev.nc = p_nc;
+	ev.pa = p_pa;
+	ev.time = p_time;
+	ev.delta = p_delta;
+	ev.seeked = p_seeked;
+	track_events.push_back(ev);
+}
+
+void AnimationPlayer::_animation_fire_track_events() {
+	bool can_call = is_inside_tree() && !Engine::get_singleton()->is_editor_hint();
+
+	// Firing an event may clear the caches (and the events with them), so copy it first.
+	for (uint32_t e = 0; e < track_events.size(); e++) {
+		TrackEvent ev = track_events[e];
+
+		Animation *a = ev.animation.ptr();
+		int i = ev.track;
+		TrackNodeCache *nc = ev.nc;
+		float time = ev.time;
+		float delta = ev.delta;
+		bool seeked = ev.seeked;
+
+		switch (a->track_get_type(i)) {
+			case Animation::TYPE_VALUE: {
+				TrackNodeCache::PropertyAnim *pa = ev.pa;
+
+				List<int> indices;
+				a->value_track_get_key_indices(i, time, delta, &indices);
+
+				for (List<int>::Element *F = indices.front(); F; F = F->next()) {
+					Variant value = a->track_get_key_value(i, F->get());
+					switch (pa->special) {
+						case SP_NONE: {
+							bool valid;
+							pa->object->set_indexed(pa->subpath, value, &valid); //you are not speshul
 #ifdef DEBUG_ENABLED
-								if (!valid) {
-									ERR_PRINT("Failed setting track value '" + String(pa->owner->path) + "'. Check if property exists or the type of key is valid. Animation '" + a->get_name() + "' at node '" + get_path() + "'.");
-								}
+							if (!valid) {
+								ERR_PRINT("Failed setting track value '" + String(pa->owner->path) + "'. Check if property exists or the type of key is valid. Animation '" + a->get_name() + "' at node '" + get_path() + "'.");
+							}
 #endif
 
-							} break;
-							case SP_NODE2D_POS: {
+						} break;
+						case SP_NODE2D_POS: {
 #ifdef DEBUG_ENABLED
-								if (value.get_type() != Variant::VECTOR2) {
-									ERR_PRINT("Position key at time " + rtos(p_time) + " in Animation Track '" + String(pa->owner->path) + "' not of type Vector2(). Animation '" + a->get_name() + "' at node '" + get_path() + "'.");
-								}
+							if (value.get_type() != Variant::VECTOR2) {
+								ERR_PRINT("Position key at time " + rtos(time) + " in Animation Track '" + String(pa->owner->path) + "' not of type Vector2(). Animation '" + a->get_name() + "' at node '" + get_path() + "'.");
+							}
 #endif
-								static_cast<Node2D *>(pa->object)->set_position(value);
-							} break;
-							case SP_NODE2D_ROT: {
+							static_cast<Node2D *>(pa->object)->set_position(value);
+						} break;
+						case SP_NODE2D_ROT: {
 #ifdef DEBUG_ENABLED
-								if (value.is_num()) {
-									ERR_PRINT("Rotation key at time " + rtos(p_time) + " in Animation Track '" + String(pa->owner->path) + "' not numerical. Animation '" + a->get_name() + "' at node '" + get_path() + "'.");
-								}
+							if (value.is_num()) {
+								ERR_PRINT("Rotation key at time " + rtos(time) + " in Animation Track '" + String(pa->owner->path) + "' not numerical. Animation '" + a->get_name() + "' at node '" + get_path() + "'.");
+							}
 #endif
 
-								static_cast<Node2D *>(pa->object)->set_rotation(Math::deg2rad((double)value));
-							} break;
-							case SP_NODE2D_SCALE: {
+							static_cast<Node2D *>(pa->object)->set_rotation(Math::deg2rad((double)value));
+						} break;
+						case SP_NODE2D_SCALE: {
 #ifdef DEBUG_ENABLED
-								if (value.get_type() != Variant::VECTOR2) {
-									ERR_PRINT("Scale key at time " + rtos(p_time) + " in Animation Track '" + String(pa->owner->path) + "' not of type Vector2()." + a->get_name() + "' at node '" + get_path() + "'.");
-								}
+							if (value.get_type() != Variant::VECTOR2) {
+								ERR_PRINT("Scale key at time " + rtos(time) + " in Animation Track '" + String(pa->owner->path) + "' not of type Vector2()." + a->get_name() + "' at node '" + get_path() + "'.");
+							}
 #endif
 
-								static_cast<Node2D *>(pa->object)->set_scale(value);
-							} break;
-						}
+							static_cast<Node2D *>(pa->object)->set_scale(value);
+						} break;
 					}
 				}
-
 			} break;
 			case Animation::TYPE_METHOD: {
-				if (!nc->node) {
-					continue;
-				}
-				if (p_delta == 0) {
-					continue;
-				}
-				if (!p_is_current) {
-					break;
-				}
-
 				List<int> indices;
 
-				a->method_track_get_key_indices(i, p_time, p_delta, &indices);
+				a->method_track_get_key_indices(i, time, delta, &indices);
 
 				for (List<int>::Element *E = indices.front(); E; E = E->next()) {
 					StringName method = a->method_track_get_name(i, E->get());
@@ -579,39 +659,11 @@ void AnimationPlayer::_animation_process_animation(AnimationData *p_anim, float
 					}
 				}
 
-			} break;
-			case Animation::TYPE_BEZIER: {
-				if (!nc->node) {
-					continue;
-				}
-
-				Map<StringName, TrackNodeCache::BezierAnim>::Element *E = nc->bezier_anim.find(a->track_get_path(i).get_concatenated_subnames());
-				ERR_CONTINUE(!E); //should it continue, or create a new one?
-
-				TrackNodeCache::BezierAnim *ba = &E->get();
-
-				float bezier = a->bezier_track_interpolate(i, p_time);
-				if (ba->accum_pass != accum_pass) {
-					ERR_CONTINUE(cache_update_bezier_size >= NODE_CACHE_UPDATE_MAX);
-					cache_update_bezier[cache_update_bezier_size++] = ba;
-					ba->bezier_accum = bezier;
-					ba->accum_pass = accum_pass;
-				} else {
-					ba->bezier_accum = Math::lerp(ba->bezier_accum, bezier, p_interp);
-				}
-
 			} break;
 			case Animation::TYPE_AUDIO: {
-				if (!nc->node) {
-					continue;
-				}
-				if (p_delta == 0) {
-					continue;
-				}
-
-				if (p_seeked) {
+				if (seeked) {
 					//find whatever should be playing
-					int idx = a->track_find_key(i, p_time);
+					int idx = a->track_find_key(i, time);
 					if (idx < 0) {
 						continue;
 					}
@@ -623,7 +675,7 @@ void AnimationPlayer::_animation_process_animation(AnimationData *p_anim, float
 						playing_caches.erase(nc);
 					} else {
 						float start_ofs = a->audio_track_get_key_start_offset(i, idx);
-						start_ofs += p_time - a->track_get_key_time(i, idx);
+						start_ofs += time - a->track_get_key_time(i, idx);
 						float end_ofs = a->audio_track_get_key_end_offset(i, idx);
 						float len = stream->get_length();
 
@@ -645,13 +697,13 @@ void AnimationPlayer::_animation_process_animation(AnimationData *p_anim, float
 							nc->audio_len = 0;
 						}
 
-						nc->audio_start = p_time;
+						nc->audio_start = time;
 					}
 
 				} else {
 					//find stuff to play
 					List<int> to_play;
-					a->track_get_key_indices_in_range(i, p_time, p_delta, &to_play);
+					a->track_get_key_indices_in_range(i, time, delta, &to_play);
 					if (to_play.size()) {
 						int idx = to_play.back()->get();
 
@@ -676,17 +728,17 @@ void AnimationPlayer::_animation_process_animation(AnimationData *p_anim, float
 								nc->audio_len = 0;
 							}
 
-							nc->audio_start = p_time;
+							nc->audio_start = time;
 						}
 					} else if (nc->audio_playing) {
 						bool loop = a->has_loop();
 
 						bool stop = false;
 
-						if (!loop && p_time < nc->audio_start) {
+						if (!loop && time < nc->audio_start) {
 							stop = true;
 						} else if (nc->audio_len > 0) {
-							float len = nc->audio_start > p_time ? (a->get_length() - nc->audio_start) + p_time : p_time - nc->audio_start;
+							float len = nc->audio_start > time ? (a->get_length() - nc->audio_start) + time : time - nc->audio_start;
 
 							if (len > nc->audio_len) {
 								stop = true;
@@ -709,9 +761,9 @@ void AnimationPlayer::_animation_process_animation(AnimationData *p_anim, float
 					continue;
 				}
 
-				if (p_delta == 0 || p_seeked) {
+				if (delta == 0 || seeked) {
 					//seek
-					int idx = a->track_find_key(i, p_time);
+					int idx = a->track_find_key(i, time);
 					if (idx < 0) {
 						continue;
 					}
@@ -728,12 +780,12 @@ void AnimationPlayer::_animation_process_animation(AnimationData *p_anim, float
 					float at_anim_pos;
 
 					if (anim->has_loop()) {
-						at_anim_pos = Math::fposmod(p_time - pos, anim->get_length()); //seek to loop
+						at_anim_pos = Math::fposmod(time - pos, anim->get_length()); //seek to loop
 					} else {
-						at_anim_pos = MAX(anim->get_length(), p_time - pos); //seek to end
+						at_anim_pos = MAX(anim->get_length(), time - pos); //seek to end
 					}
 
-					if (player->is_playing() || p_seeked) {
+					if (player->is_playing() || seeked) {
 						player->play(anim_name);
 						player->seek(at_anim_pos);
 						nc->animation_playing = true;
@@ -745,7 +797,7 @@ void AnimationPlayer::_animation_process_animation(AnimationData *p_anim, float
 				} else {
 					//find stuff to play
 					List<int> to_play;
-					a->track_get_key_indices_in_range(i, p_time, p_delta, &to_play);
+					a->track_get_key_indices_in_range(i, time, delta, &to_play);
 					if (to_play.size()) {
 						int idx = to_play.back()->get();
 
@@ -765,8 +817,12 @@ void AnimationPlayer::_animation_process_animation(AnimationData *p_anim, float
 				}
 
 			} break;
+			default: {
+			} //the rest are accumulated
 		}
 	}
+
+	track_events.clear();
 }
 
 void AnimationPlayer::_animation_process_data(PlaybackData &cd, float p_delta, float p_blend, bool p_seeked, bool p_started) {
@@ -920,40 +976,78 @@ void AnimationPlayer::_animation_update_transforms() {
 	cache_update_bezier_size = 0;
 }
 
-void AnimationPlayer::_animation_process(float p_delta) {
-	if (playback.current.from) {
-		end_reached = false;
-		end_notify = false;
-		_animation_process2(p_delta, playback.started);
+bool AnimationPlayer::_animation_process_prepare() {
+	if (!playback.current.from) {
+		_set_process(false);
+		return false;
+	}
 
-		if (playback.started) {
-			playback.started = false;
-		}
+	// Node caches are resolved here, as this needs to access the scene tree.
+	_ensure_node_caches(playback.current.from);
+	for (List<Blend>::Element *E = playback.blend.front(); E; E = E->next()) {
+		_ensure_node_caches(E->get().data.from);
+	}
 
-		_animation_update_transforms();
-		if (end_reached) {
-			if (queued.size()) {
-				String old = playback.assigned;
-				play(queued.front()->get());
-				String new_name = playback.assigned;
-				queued.pop_front();
-				if (end_notify) {
-					emit_signal(SceneStringNames::get_singleton()->animation_changed, old, new_name);
-				}
-			} else {
-				//stop();
-				playing = false;
-				_set_process(false);
-				if (end_notify) {
-					emit_signal(SceneStringNames::get_singleton()->animation_finished, playback.assigned);
-				}
+	track_events.clear();
+
+	return true;
+}
+
+void AnimationPlayer::_animation_process_blend(float p_delta) {
+	// This may run on a worker thread (see process_threaded), so it must only
+	// touch the state of this player. Anything with side effects on other objects
+	// is recorded as a track event and fired in _animation_process_commit().
+
+	end_reached = false;
+	end_notify = false;
+	_animation_process2(p_delta, playback.started);
+
+	if (playback.started) {
+		playback.started = false;
+	}
+}
+
+void AnimationPlayer::_animation_process_commit() {
+	_animation_fire_track_events();
+	_animation_update_transforms();
+	if (end_reached) {
+		if (queued.size()) {
+			String old = playback.assigned;
+			play(queued.front()->get());
+			String new_name = playback.assigned;
+			queued.pop_front();
+			if (end_notify) {
+				emit_signal(SceneStringNames::get_singleton()->animation_changed, old, new_name);
+			}
+		} else {
+			//stop();
+			playing = false;
+			_set_process(false);
+			if (end_notify) {
+				emit_signal(SceneStringNames::get_singleton()->animation_finished, playback.assigned);
 			}
-			end_reached = false;
 		}
+		end_reached = false;
+	}
+}
 
-	} else {
-		_set_process(false);
+void AnimationPlayer::_animation_process(float p_delta) {
+	if (!_animation_process_prepare()) {
+		return;
 	}
+
+	_animation_process_blend(p_delta);
+	_animation_process_commit();
+}
+
+void AnimationPlayer::_queue_threaded_process(float p_delta) {
+	if (threaded_queued) {
+		return;
+	}
+
+	threaded_delta = p_delta;
+	threaded_queued = true;
+	get_tree()->_queue_threaded_animation_player(this);
 }
 
 Error AnimationPlayer::add_animation(const StringName &p_name, const Ref<Animation> &p_animation) {
@@ -1364,6 +1458,7 @@ void AnimationPlayer::clear_caches() {
 	cache_update_size = 0;
 	cache_update_prop_size = 0;
 	cache_update_bezier_size = 0;
+	track_events.clear();
 }
 
 void AnimationPlayer::set_active(bool p_active) {
@@ -1428,6 +1523,14 @@ AnimationPlayer::AnimationProcessCallback AnimationPlayer::get_process_callback(
 	return process_callback;
 }
 
+void AnimationPlayer::set_process_threaded(bool p_threaded) {
+	process_threaded = p_threaded;
+}
+
+bool AnimationPlayer::is_process_threaded() const {
+	return process_threaded;
+}
+
 void AnimationPlayer::set_method_call_mode(AnimationMethodCallMode p_mode) {
 	method_call_mode = p_mode;
 }
@@ -1646,6 +1749,9 @@ void AnimationPlayer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_process_callback", "mode"), &AnimationPlayer::set_process_callback);
 	ClassDB::bind_method(D_METHOD("get_process_callback"), &AnimationPlayer::get_process_callback);
 
+	ClassDB::bind_method(D_METHOD("set_process_threaded", "enable"), &AnimationPlayer::set_process_threaded);
+	ClassDB::bind_method(D_METHOD("is_process_threaded"), &AnimationPlayer::is_process_threaded);
+
 	ClassDB::bind_method(D_METHOD("set_method_call_mode", "mode"), &AnimationPlayer::set_method_call_mode);
 	ClassDB::bind_method(D_METHOD("get_method_call_mode"), &AnimationPlayer::get_method_call_mode);
 
@@ -1665,6 +1771,7 @@ void AnimationPlayer::_bind_methods() {
 
 	ADD_GROUP("Playback Options", "playback_");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "playback_process_mode", PROPERTY_HINT_ENUM, "Physics,Idle,Manual"), "set_process_callback", "get_process_callback");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "playback_process_threaded"), "set_process_threaded", "is_process_threaded");
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "playback_default_blend_time", PROPERTY_HINT_RANGE, "0,4096,0.01"), "set_default_blend_time", "get_default_blend_time");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "playback_active", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NONE), "set_active", "is_active");
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "playback_speed", PROPERTY_HINT_RANGE, "-64,64,0.01"), "set_speed_scale", "get_speed_scale");
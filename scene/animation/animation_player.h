@@ -31,6 +31,7 @@
 #ifndef ANIMATION_PLAYER_H
 #define ANIMATION_PLAYER_H
 
+#include "core/templates/local_vector.h"
 #include "scene/2d/node_2d.h"
 #include "scene/3d/node_3d.h"
 #include "scene/3d/skeleton_3d.h"
@@ -160,6 +161,20 @@ private:
 	int cache_update_bezier_size = 0;
 	Set<TrackNodeCache *> playing_caches;
 
+	// Tracks with side effects on other objects (method calls, audio, sub-animations and discrete values),
+	// recorded while processing and fired afterwards on the main thread.
+	struct TrackEvent {
+		Ref<Animation> animation;
+		int track = 0;
+		TrackNodeCache *nc = nullptr;
+		TrackNodeCache::PropertyAnim *pa = nullptr;
+		float time = 0.0;
+		float delta = 0.0;
+		bool seeked = false;
+	};
+
+	LocalVector<TrackEvent> track_events;
+
 	uint64_t accum_pass = 1;
 	float speed_scale = 1.0;
 	float default_blend_time = 0.0;
@@ -209,6 +224,7 @@ private:
 	String autoplay;
 	bool reset_on_save = true;
 	AnimationProcessCallback process_callback = ANIMATION_PROCESS_IDLE;
+	bool process_threaded = false;
 	AnimationMethodCallMode method_call_mode = ANIMATION_METHOD_CALL_DEFERRED;
 	bool processing = false;
 	bool active = true;
@@ -223,6 +239,17 @@ private:
 	void _animation_update_transforms();
 	void _animation_process(float p_delta);
 
+	void _animation_push_track_event(Animation *p_animation, int p_track, TrackNodeCache *p_nc, TrackNodeCache::PropertyAnim *p_pa, float p_time, float p_delta, bool p_seeked);
+	void _animation_fire_track_events();
+	bool _animation_process_prepare();
+	void _animation_process_blend(float p_delta);
+	void _animation_process_commit();
+
+	float threaded_delta = 0.0;
+	bool threaded_queued = false;
+	void _queue_threaded_process(float p_delta);
+	friend class SceneTree;
+
 	void _node_removed(Node *p_node);
 	void _stop_playing_caches();
 
@@ -303,6 +330,9 @@ public:
 	void set_process_callback(AnimationProcessCallback p_mode);
 	AnimationProcessCallback get_process_callback() const;
 
+	void set_process_threaded(bool p_threaded);
+	bool is_process_threaded() const;
+
 	void set_method_call_mode(AnimationMethodCallMode p_mode);
 	AnimationMethodCallMode get_method_call_mode() const;
 
@@ -519,6 +519,14 @@ AnimationTree::AnimationProcessCallback AnimationTree::get_process_callback() co
 	return process_callback;
 }
 
+void AnimationTree::set_process_threaded(bool p_threaded) {
+	process_threaded = p_threaded;
+}
+
+bool AnimationTree::is_process_threaded() const {
+	return process_threaded;
+}
+
 void AnimationTree::_node_removed(Node *p_node) {
 	cache_valid = false;
 }
@@ -713,12 +721,13 @@ void AnimationTree::_clear_caches() {
 		memdelete(track_cache[*K]);
 	}
 	playing_caches.clear();
+	track_events.clear();
 
 	track_cache.clear();
 	cache_valid = false;
 }
 
-void AnimationTree::_process_graph(float p_delta) {
+bool AnimationTree::_process_graph_prepare() {
 	_update_properties(); //if properties need updating, update them
 
 	//check all tracks, see if they need modification
@@ -729,14 +738,14 @@ void AnimationTree::_process_graph(float p_delta) {
 		ERR_PRINT("AnimationTree: root AnimationNode is not set, disabling playback.");
 		set_active(false);
 		cache_valid = false;
-		return;
+		return false;
 	}
 
 	if (!has_node(animation_player)) {
 		ERR_PRINT("AnimationTree: no valid AnimationPlayer path set, disabling playback");
 		set_active(false);
 		cache_valid = false;
-		return;
+		return false;
 	}
 
 	AnimationPlayer *player = Object::cast_to<AnimationPlayer>(get_node(animation_player));
@@ -766,12 +775,12 @@ void AnimationTree::_process_graph(float p_delta) {
 		ERR_PRINT("AnimationTree: path points to a node not an AnimationPlayer, disabling playback");
 		set_active(false);
 		cache_valid = false;
-		return;
+		return false;
 	}
 
 	if (!cache_valid) {
 		if (!_update_caches(player)) {
-			return;
+			return false;
 		}
 	}
 
@@ -786,19 +795,31 @@ void AnimationTree::_process_graph(float p_delta) {
 		state.player = player;
 		state.last_pass = process_pass;
 		state.tree = this;
+	}
 
-		// root source blends
+	track_events.clear();
+
+	return true;
+}
+
+void AnimationTree::_process_graph_blend(float p_delta) {
+	// This may run on a worker thread (see process_threaded), so it must only
+	// touch the state of this tree. Anything with side effects on other objects
+	// is recorded as a track event and fired in _process_graph_commit().
+	// The nodes of the graph are resources that other trees may share, and
+	// they hold evaluation data (blends, state), so trees sharing nodes are
+	// never blended at the same time (see SceneTree::_flush_threaded_animations()).
 
+	//process
+
+	{
+		// root source blends
 		root->blends.resize(state.track_count);
 		float *src_blendsw = root->blends.ptrw();
 		for (int i = 0; i < state.track_count; i++) {
 			src_blendsw[i] = 1.0; //by default all go to 1 for the root input
 		}
-	}
 
-	//process
-
-	{
 		if (started) {
 			//if started, seek
 			root->_pre_process(SceneStringNames::get_singleton()->parameters_base_path, nullptr, &state, 0, true, Vector<StringName>());
@@ -811,11 +832,9 @@ void AnimationTree::_process_graph(float p_delta) {
 	if (!state.valid) {
 		return; //state is not valid. do nothing.
 	}
-	//apply value/transform/bezier blends to track caches and execute method/audio/animation tracks
+	//apply value/transform/bezier blends to track caches and record method/audio/animation tracks
 
 	{
-		bool can_call = is_inside_tree() && !Engine::get_singleton()->is_editor_hint();
-
 		for (List<AnimationNode::AnimationState>::Element *E = state.animation_states.front(); E; E = E->next()) {
 			const AnimationNode::AnimationState &as = E->get();
 
@@ -959,42 +978,7 @@ void AnimationTree::_process_graph(float p_delta) {
 							Variant::interpolate(t->value, value, blend, t->value);
 
 						} else if (delta != 0) {
-							List<int> indices;
-							a->value_track_get_key_indices(i, time, delta, &indices);
-
-							for (List<int>::Element *F = indices.front(); F; F = F->next()) {
-								Variant value = a->track_get_key_value(i, F->get());
-								t->object->set_indexed(t->subpath, value);
-							}
-						}
-
-					} break;
-					case Animation::TYPE_METHOD: {
-						if (delta == 0) {
-							continue;
-						}
-						TrackCacheMethod *t = static_cast<TrackCacheMethod *>(track);
-
-						List<int> indices;
-
-						a->method_track_get_key_indices(i, time, delta, &indices);
-
-						for (List<int>::Element *F = indices.front(); F; F = F->next()) {
-							StringName method = a->method_track_get_name(i, F->get());
-							Vector<Variant> params = a->method_track_get_params(i, F->get());
-
-							int s = params.size();
-
-							ERR_CONTINUE(s > VARIANT_ARG_MAX);
-							if (can_call) {
-								t->object->call_deferred(
-										method,
-										s >= 1 ? params[0] : Variant(),
-										s >= 2 ? params[1] : Variant(),
-										s >= 3 ? params[2] : Variant(),
-										s >= 4 ? params[3] : Variant(),
-										s >= 5 ? params[4] : Variant());
-							}
+							_push_track_event(a, i, track, time, delta, blend, seeked);
 						}
 
 					} break;
@@ -1011,16 +995,142 @@ void AnimationTree::_process_graph(float p_delta) {
 						t->value = Math::lerp(t->value, bezier, blend);
 
 					} break;
-					case Animation::TYPE_AUDIO: {
-						TrackCacheAudio *t = static_cast<TrackCacheAudio *>(track);
+					case Animation::TYPE_METHOD:
+					case Animation::TYPE_AUDIO:
+					case Animation::TYPE_ANIMATION: {
+						_push_track_event(a, i, track, time, delta, blend, seeked);
+					} break;
+				}
+			}
+		}
+	}
+}
+
+void AnimationTree::_push_track_event(const Ref<Animation> &p_animation, int p_track, TrackCache *p_track_cache, float p_time, float p_delta, float p_blend, bool p_seeked) {
+	TrackEvent ev;
+	ev.animation = p_animation;
+	ev.track = p_track;
+	ev.track_cache = p_track_cache;
+	ev.time = p_time;
+	ev.delta = p_delta;
+	ev.blend = p_blend;
+	ev.seeked = p_seeked;
+	track_events.push_back(ev);
+}
+
+void AnimationTree::_process_graph_commit() {
+	if (!state.valid) {
+		return;
+	}
+
+	// execute method/audio/animation tracks and discrete value tracks recorded while blending
+
+	{
+		bool can_call = is_inside_tree() && !Engine::get_singleton()->is_editor_hint();
+
+		// Firing an event may clear the caches (and the events with them), so copy it first.
+		for (uint32_t e = 0; e < track_events.size(); e++) {
+			const TrackEvent ev = track_events[e];
+
+			Ref<Animation> a = ev.animation;
+			int i = ev.track;
+			TrackCache *track = ev.track_cache;
+			float time = ev.time;
+			float delta = ev.delta;
+			float blend = ev.blend;
+			bool seeked = ev.seeked;
+
+			switch (track->type) {
+				case Animation::TYPE_VALUE: {
+					TrackCacheValue *t = static_cast<TrackCacheValue *>(track);
+
+					List<int> indices;
+					a->value_track_get_key_indices(i, time, delta, &indices);
 
-						if (seeked) {
-							//find whatever should be playing
-							int idx = a->track_find_key(i, time);
-							if (idx < 0) {
+					for (List<int>::Element *F = indices.front(); F; F = F->next()) {
+						Variant value = a->track_get_key_value(i, F->get());
+						t->object->set_indexed(t->subpath, value);
+					}
+
+				} break;
+				case Animation::TYPE_METHOD: {
+					if (delta == 0) {
+						continue;
+					}
+					TrackCacheMethod *t = static_cast<TrackCacheMethod *>(track);
+
+					List<int> indices;
+
+					a->method_track_get_key_indices(i, time, delta, &indices);
+
+					for (List<int>::Element *F = indices.front(); F; F = F->next()) {
+						StringName method = a->method_track_get_name(i, F->get());
+						Vector<Variant> params = a->method_track_get_params(i, F->get());
+
+						int s = params.size();
+
+						ERR_CONTINUE(s > VARIANT_ARG_MAX);
+						if (can_call) {
+							t->object->call_deferred(
+									method,
+									s >= 1 ? params[0] : Variant(),
+									s >= 2 ? params[1] : Variant(),
+									s >= 3 ? params[2] : Variant(),
+									s >= 4 ? params[3] : Variant(),
+									s >= 5 ? params[4] : Variant());
+						}
+					}
+
+				} break;
+				case Animation::TYPE_AUDIO: {
+					TrackCacheAudio *t = static_cast<TrackCacheAudio *>(track);
+
+					if (seeked) {
+						//find whatever should be playing
+						int idx = a->track_find_key(i, time);
+						if (idx < 0) {
+							continue;
+						}
+
+						Ref<AudioStream> stream = a->audio_track_get_key_stream(i, idx);
+						if (!stream.is_valid()) {
+							t->object->call("stop");
+							t->playing = false;
+							playing_caches.erase(t);
+						} else {
+							float start_ofs = a->audio_track_get_key_start_offset(i, idx);
+							start_ofs += time - a->track_get_key_time(i, idx);
+							float end_ofs = a->audio_track_get_key_end_offset(i, idx);
+							float len = stream->get_length();
+
+							if (start_ofs > len - end_ofs) {
+								t->object->call("stop");
+								t->playing = false;
+								playing_caches.erase(t);
 								continue;
 							}
 
+							t->object->call("set_stream", stream);
+							t->object->call("play", start_ofs);
+
+							t->playing = true;
+							playing_caches.insert(t);
+							if (len && end_ofs > 0) { //force an end at a time
+								t->len = len - start_ofs - end_ofs;
+							} else {
+								t->len = 0;
+							}
+
+							t->start = time;
+						}
+
+					} else {
+						//find stuff to play
+						List<int> to_play;
+						a->track_get_key_indices_in_range(i, time, delta, &to_play);
+						if (to_play.size()) {
+							int idx = to_play.back()->get();
+
 							Ref<AudioStream> stream = a->audio_track_get_key_stream(i, idx);
 							if (!stream.is_valid()) {
 								t->object->call("stop");
@@ -1028,17 +1138,9 @@ void AnimationTree::_process_graph(float p_delta) {
 								playing_caches.erase(t);
 							} else {
 								float start_ofs = a->audio_track_get_key_start_offset(i, idx);
-								start_ofs += time - a->track_get_key_time(i, idx);
 								float end_ofs = a->audio_track_get_key_end_offset(i, idx);
 								float len = stream->get_length();
 
-								if (start_ofs > len - end_ofs) {
-									t->object->call("stop");
-									t->playing = false;
-									playing_caches.erase(t);
-									continue;
-								}
-
 								t->object->call("set_stream", stream);
 								t->object->call("play", start_ofs);
 
@@ -1052,136 +1154,108 @@ void AnimationTree::_process_graph(float p_delta) {
 
 								t->start = time;
 							}
+						} else if (t->playing) {
+							bool loop = a->has_loop();
 
-						} else {
-							//find stuff to play
-							List<int> to_play;
-							a->track_get_key_indices_in_range(i, time, delta, &to_play);
-							if (to_play.size()) {
-								int idx = to_play.back()->get();
-
-								Ref<AudioStream> stream = a->audio_track_get_key_stream(i, idx);
-								if (!stream.is_valid()) {
-									t->object->call("stop");
-									t->playing = false;
-									playing_caches.erase(t);
-								} else {
-									float start_ofs = a->audio_track_get_key_start_offset(i, idx);
-									float end_ofs = a->audio_track_get_key_end_offset(i, idx);
-									float len = stream->get_length();
-
-									t->object->call("set_stream", stream);
-									t->object->call("play", start_ofs);
-
-									t->playing = true;
-									playing_caches.insert(t);
-									if (len && end_ofs > 0) { //force an end at a time
-										t->len = len - start_ofs - end_ofs;
-									} else {
-										t->len = 0;
-									}
-
-									t->start = time;
-								}
-							} else if (t->playing) {
-								bool loop = a->has_loop();
+							bool stop = false;
 
-								bool stop = false;
+							if (!loop && time < t->start) {
+								stop = true;
+							} else if (t->len > 0) {
+								float len = t->start > time ? (a->get_length() - t->start) + time : time - t->start;
 
-								if (!loop && time < t->start) {
+								if (len > t->len) {
 									stop = true;
-								} else if (t->len > 0) {
-									float len = t->start > time ? (a->get_length() - t->start) + time : time - t->start;
-
-									if (len > t->len) {
-										stop = true;
-									}
 								}
+							}
 
-								if (stop) {
-									//time to stop
-									t->object->call("stop");
-									t->playing = false;
-									playing_caches.erase(t);
-								}
+							if (stop) {
+								//time to stop
+								t->object->call("stop");
+								t->playing = false;
+								playing_caches.erase(t);
 							}
 						}
+					}
 
-						float db = Math::linear2db(MAX(blend, 0.00001));
-						if (t->object->has_method("set_unit_db")) {
-							t->object->call("set_unit_db", db);
-						} else {
-							t->object->call("set_volume_db", db);
-						}
-					} break;
-					case Animation::TYPE_ANIMATION: {
-						TrackCacheAnimation *t = static_cast<TrackCacheAnimation *>(track);
+					float db = Math::linear2db(MAX(blend, 0.00001));
+					if (t->object->has_method("set_unit_db")) {
+						t->object->call("set_unit_db", db);
+					} else {
+						t->object->call("set_volume_db", db);
+					}
+				} break;
+				case Animation::TYPE_ANIMATION: {
+					TrackCacheAnimation *t = static_cast<TrackCacheAnimation *>(track);
+
+					AnimationPlayer *player2 = Object::cast_to<AnimationPlayer>(t->object);
 
-						AnimationPlayer *player2 = Object::cast_to<AnimationPlayer>(t->object);
+					if (!player2) {
+						continue;
+					}
 
-						if (!player2) {
+					if (delta == 0 || seeked) {
+						//seek
+						int idx = a->track_find_key(i, time);
+						if (idx < 0) {
 							continue;
 						}
 
-						if (delta == 0 || seeked) {
-							//seek
-							int idx = a->track_find_key(i, time);
-							if (idx < 0) {
-								continue;
-							}
+						float pos = a->track_get_key_time(i, idx);
 
-							float pos = a->track_get_key_time(i, idx);
+						StringName anim_name = a->animation_track_get_key_animation(i, idx);
+						if (String(anim_name) == "[stop]" || !player2->has_animation(anim_name)) {
+							continue;
+						}
 
-							StringName anim_name = a->animation_track_get_key_animation(i, idx);
-							if (String(anim_name) == "[stop]" || !player2->has_animation(anim_name)) {
-								continue;
-							}
+						Ref<Animation> anim = player2->get_animation(anim_name);
 
-							Ref<Animation> anim = player2->get_animation(anim_name);
+						float at_anim_pos;
 
-							float at_anim_pos;
+						if (anim->has_loop()) {
+							at_anim_pos = Math::fposmod(time - pos, anim->get_length()); //seek to loop
+						} else {
+							at_anim_pos = MAX(anim->get_length(), time - pos); //seek to end
+						}
 
-							if (anim->has_loop()) {
-								at_anim_pos = Math::fposmod(time - pos, anim->get_length()); //seek to loop
-							} else {
-								at_anim_pos = MAX(anim->get_length(), time - pos); //seek to end
-							}
+						if (player2->is_playing() || seeked) {
+							player2->play(anim_name);
+							player2->seek(at_anim_pos);
+							t->playing = true;
+							playing_caches.insert(t);
+						} else {
+							player2->set_assigned_animation(anim_name);
+							player2->seek(at_anim_pos, true);
+						}
+					} else {
+						//find stuff to play
+						List<int> to_play;
+						a->track_get_key_indices_in_range(i, time, delta, &to_play);
+						if (to_play.size()) {
+							int idx = to_play.back()->get();
 
-							if (player2->is_playing() || seeked) {
+							StringName anim_name = a->animation_track_get_key_animation(i, idx);
+							if (String(anim_name) == "[stop]" || !player2->has_animation(anim_name)) {
+								if (playing_caches.has(t)) {
+									playing_caches.erase(t);
+									player2->stop();
+									t->playing = false;
+								}
+							} else {
 								player2->play(anim_name);
-								player2->seek(at_anim_pos);
 								t->playing = true;
 								playing_caches.insert(t);
-							} else {
-								player2->set_assigned_animation(anim_name);
-								player2->seek(at_anim_pos, true);
-							}
-						} else {
-							//find stuff to play
-							List<int> to_play;
-							a->track_get_key_indices_in_range(i, time, delta, &to_play);
-							if (to_play.size()) {
-								int idx = to_play.back()->get();
-
-								StringName anim_name = a->animation_track_get_key_animation(i, idx);
-								if (String(anim_name) == "[stop]" || !player2->has_animation(anim_name)) {
-									if (playing_caches.has(t)) {
-										playing_caches.erase(t);
-										player2->stop();
-										t->playing = false;
-									}
-								} else {
-									player2->play(anim_name);
-									t->playing = true;
-									playing_caches.insert(t);
-								}
 							}
 						}
+					}
 
-					} break;
-				}
+				} break;
+				default: {
+				} //the rest are blended
 			}
 		}
+
+		track_events.clear();
 	}
 
 	{
@@ -1236,20 +1310,51 @@ void AnimationTree::_process_graph(float p_delta) {
 	}
 }
 
+void AnimationTree::_process_graph(float p_delta) {
+	if (!_process_graph_prepare()) {
+		return;
+	}
+
+	_process_graph_blend(p_delta);
+	_process_graph_commit();
+}
+
+void AnimationTree::_queue_threaded_process(float p_delta) {
+	if (threaded_queued) {
+		return;
+	}
+
+	threaded_delta = p_delta;
+	threaded_queued = true;
+	get_tree()->_queue_threaded_animation_tree(this);
+}
+
 void AnimationTree::advance(float p_time) {
 	_process_graph(p_time);
 }
 
 void AnimationTree::_notification(int p_what) {
 	if (active && p_what == NOTIFICATION_INTERNAL_PHYSICS_PROCESS && process_callback == ANIMATION_PROCESS_PHYSICS) {
-		_process_graph(get_physics_process_delta_time());
+		if (process_threaded) {
+			_queue_threaded_process(get_physics_process_delta_time());
+		} else {
+			_process_graph(get_physics_process_delta_time());
+		}
 	}
 
 	if (active && p_what == NOTIFICATION_INTERNAL_PROCESS && process_callback == ANIMATION_PROCESS_IDLE) {
-		_process_graph(get_process_delta_time());
+		if (process_threaded) {
+			_queue_threaded_process(get_process_delta_time());
+		} else {
+			_process_graph(get_process_delta_time());
+		}
 	}
 
 	if (p_what == NOTIFICATION_EXIT_TREE) {
+		if (threaded_queued) {
+			get_tree()->_unqueue_threaded_animation_tree(this);
+			threaded_queued = false;
+		}
 		_clear_caches();
 		if (last_animation_player.is_valid()) {
 			Object *player = ObjectDB::get_instance(last_animation_player);
@@ -1470,6 +1575,9 @@ void AnimationTree::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_process_callback", "mode"), &AnimationTree::set_process_callback);
 	ClassDB::bind_method(D_METHOD("get_process_callback"), &AnimationTree::get_process_callback);
 
+	ClassDB::bind_method(D_METHOD("set_process_threaded", "enable"), &AnimationTree::set_process_threaded);
+	ClassDB::bind_method(D_METHOD("is_process_threaded"), &AnimationTree::is_process_threaded);
+
 	ClassDB::bind_method(D_METHOD("set_animation_player", "root"), &AnimationTree::set_animation_player);
 	ClassDB::bind_method(D_METHOD("get_animation_player"), &AnimationTree::get_animation_player);
 
@@ -1488,6 +1596,7 @@ void AnimationTree::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::NODE_PATH, "anim_player", PROPERTY_HINT_NODE_PATH_VALID_TYPES, "AnimationPlayer"), "set_animation_player", "get_animation_player");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "active"), "set_active", "is_active");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "process_callback", PROPERTY_HINT_ENUM, "Physics,Idle,Manual"), "set_process_callback", "get_process_callback");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "process_threaded"), "set_process_threaded", "is_process_threaded");
 	ADD_GROUP("Root Motion", "root_motion_");
 	ADD_PROPERTY(PropertyInfo(Variant::NODE_PATH, "root_motion_track"), "set_root_motion_track", "get_root_motion_track");
 
@@ -32,6 +32,7 @@
 #define ANIMATION_GRAPH_PLAYER_H
 
 #include "animation_player.h"
+#include "core/templates/local_vector.h"
 #include "scene/3d/node_3d.h"
 #include "scene/3d/skeleton_3d.h"
 #include "scene/resources/animation.h"
@@ -238,9 +239,24 @@ private:
 	HashMap<NodePath, TrackCache *> track_cache;
 	Set<TrackCache *> playing_caches;
 
+	// Tracks with side effects on other objects (method calls, audio, sub-animations and discrete values),
+	// recorded while blending and fired afterwards on the main thread.
+	struct TrackEvent {
+		Ref<Animation> animation;
+		int track = 0;
+		TrackCache *track_cache = nullptr;
+		float time = 0.0;
+		float delta = 0.0;
+		float blend = 0.0;
+		bool seeked = false;
+	};
+
+	LocalVector<TrackEvent> track_events;
+
 	Ref<AnimationNode> root;
 
 	AnimationProcessCallback process_callback = ANIMATION_PROCESS_IDLE;
+	bool process_threaded = false;
 	bool active = false;
 	NodePath animation_player;
 
@@ -253,6 +269,16 @@ private:
 	bool _update_caches(AnimationPlayer *player);
 	void _process_graph(float p_delta);
 
+	bool _process_graph_prepare();
+	void _process_graph_blend(float p_delta);
+	void _process_graph_commit();
+	void _push_track_event(const Ref<Animation> &p_animation, int p_track, TrackCache *p_track_cache, float p_time, float p_delta, float p_blend, bool p_seeked);
+
+	float threaded_delta = 0.0;
+	bool threaded_queued = false;
+	void _queue_threaded_process(float p_delta);
+	friend class SceneTree;
+
 	uint64_t setup_pass = 1;
 	uint64_t process_pass = 1;
 
@@ -299,6 +325,9 @@ public:
 	void set_process_callback(AnimationProcessCallback p_mode);
 	AnimationProcessCallback get_process_callback() const;
 
+	void set_process_threaded(bool p_threaded);
+	bool is_process_threaded() const;
+
 	void set_animation_player(const NodePath &p_player);
 	NodePath get_animation_player() const;
 
@@ -582,8 +582,8 @@ void CanvasItem::_notification(int p_what) {
 				}
 			}
 			_enter_canvas();
-			if (!block_transform_notify && !xform_change.in_list()) {
-				get_tree()->xform_change_list.add(&xform_change);
+			if (!block_transform_notify) {
+				get_tree()->_add_xform_change(&xform_change);
 			}
 		} break;
 		case NOTIFICATION_MOVED_IN_PARENT: {
@@ -601,9 +601,7 @@ void CanvasItem::_notification(int p_what) {
 
 		} break;
 		case NOTIFICATION_EXIT_TREE: {
-			if (xform_change.in_list()) {
-				get_tree()->xform_change_list.remove(&xform_change);
-			}
+			get_tree()->_remove_xform_change(&xform_change);
 			_exit_canvas();
 			if (C) {
 				Object::cast_to<CanvasItem>(get_parent())->children_items.erase(C);
@@ -949,23 +947,37 @@ void CanvasItem::_notify_transform(CanvasItem *p_node) {
 		return; //nothing to do
 	}
 
+	// Walk the subtree breadth first instead of recursing, like Node3D does.
+	static thread_local LocalVector<CanvasItem *> nodes;
+	uint32_t base = nodes.size();
+	nodes.push_back(p_node);
 	p_node->global_invalid = true;
 
-	if (p_node->notify_transform && !p_node->xform_change.in_list()) {
-		if (!p_node->block_transform_notify) {
-			if (p_node->is_inside_tree()) {
-				get_tree()->xform_change_list.add(&p_node->xform_change);
+	for (uint32_t i = base; i < nodes.size(); i++) {
+		CanvasItem *node = nodes[i];
+		for (List<CanvasItem *>::Element *E = node->children_items.front(); E; E = E->next()) {
+			CanvasItem *ci = E->get();
+			if (ci->top_level || ci->global_invalid) {
+				continue;
 			}
+			ci->global_invalid = true;
+			nodes.push_back(ci);
 		}
 	}
 
-	for (List<CanvasItem *>::Element *E = p_node->children_items.front(); E; E = E->next()) {
-		CanvasItem *ci = E->get();
-		if (ci->top_level) {
-			continue;
+	// Added in reverse, so the list starts parents first, the order SceneTree notifies in.
+	for (uint32_t i = nodes.size(); i > base; i--) {
+		CanvasItem *node = nodes[i - 1];
+		if (node->notify_transform && !node->xform_change.in_list()) {
+			if (!node->block_transform_notify) {
+				if (node->is_inside_tree()) {
+					node->get_tree()->_add_xform_change(&node->xform_change);
+				}
+			}
 		}
-		_notify_transform(ci);
 	}
+
+	nodes.resize(base);
 }
 
 Rect2 CanvasItem::get_viewport_rect() const {
@@ -1088,12 +1100,10 @@ Vector2 CanvasItem::get_local_mouse_position() const {
 
 void CanvasItem::force_update_transform() {
 	ERR_FAIL_COND(!is_inside_tree());
-	if (!xform_change.in_list()) {
+	if (!get_tree()->_remove_xform_change(&xform_change)) {
 		return;
 	}
 
-	get_tree()->xform_change_list.remove(&xform_change);
-
 	notification(NOTIFICATION_TRANSFORM_CHANGED);
 }
 
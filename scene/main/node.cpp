@@ -48,6 +48,7 @@
 #include <stdint.h>
 
 VARIANT_ENUM_CAST(Node::ProcessMode);
+VARIANT_ENUM_CAST(Node::ProcessThreadGroup);
 
 int Node::orphan_node_count = 0;
 
@@ -80,6 +81,14 @@ void Node::_notification(int p_notification) {
 				data.process_owner = this;
 			}
 
+			if (data.process_thread_group == PROCESS_THREAD_GROUP_INHERIT) {
+				data.process_thread_group_owner = data.parent ? data.parent->data.process_thread_group_owner : nullptr;
+			} else if (data.process_thread_group == PROCESS_THREAD_GROUP_SUB_THREAD) {
+				data.process_thread_group_owner = this;
+			} else {
+				data.process_thread_group_owner = nullptr;
+			}
+
 			if (data.input) {
 				add_to_group("_vp_input" + itos(get_viewport()->get_instance_id()));
 			}
@@ -112,6 +121,7 @@ void Node::_notification(int p_notification) {
 			}
 
 			data.process_owner = nullptr;
+			data.process_thread_group_owner = nullptr;
 			if (data.path_cache) {
 				memdelete(data.path_cache);
 				data.path_cache = nullptr;
@@ -293,6 +303,10 @@ void Node::_propagate_exit_tree() {
 
 void Node::move_child(Node *p_child, int p_pos) {
 	ERR_FAIL_NULL(p_child);
+	if (MessageQueue::is_thread_deferring()) {
+		MessageQueue::get_singleton()->push_call(this, "move_child", p_child, p_pos);
+		return;
+	}
 	ERR_FAIL_INDEX_MSG(p_pos, data.children.size() + 1, vformat("Invalid new child position: %d.", p_pos));
 	ERR_FAIL_COND_MSG(p_child->data.parent != this, "Child is not a child of this node.");
 	ERR_FAIL_COND_MSG(data.blocked > 0, "Parent node is busy setting up children, move_child() failed. Consider using call_deferred(\"move_child\") instead (or \"popup\" if this is from a popup).");
@@ -470,6 +484,42 @@ void Node::_propagate_process_owner(Node *p_owner, int p_notification) {
 	}
 }
 
+void Node::set_process_thread_group(ProcessThreadGroup p_group) {
+	ERR_FAIL_INDEX(p_group, PROCESS_THREAD_GROUP_SUB_THREAD + 1);
+	if (data.process_thread_group == p_group) {
+		return;
+	}
+
+	data.process_thread_group = p_group;
+
+	if (!is_inside_tree()) {
+		return;
+	}
+
+	if (data.process_thread_group == PROCESS_THREAD_GROUP_INHERIT) {
+		_propagate_process_thread_group_owner(data.parent ? data.parent->data.process_thread_group_owner : nullptr);
+	} else if (data.process_thread_group == PROCESS_THREAD_GROUP_SUB_THREAD) {
+		_propagate_process_thread_group_owner(this);
+	} else {
+		_propagate_process_thread_group_owner(nullptr);
+	}
+}
+
+Node::ProcessThreadGroup Node::get_process_thread_group() const {
+	return data.process_thread_group;
+}
+
+void Node::_propagate_process_thread_group_owner(Node *p_owner) {
+	data.process_thread_group_owner = p_owner;
+
+	for (int i = 0; i < data.children.size(); i++) {
+		Node *c = data.children[i];
+		if (c->data.process_thread_group == PROCESS_THREAD_GROUP_INHERIT) {
+			c->_propagate_process_thread_group_owner(p_owner);
+		}
+	}
+}
+
 void Node::set_network_master(int p_peer_id, bool p_recursive) {
 	data.network_master = p_peer_id;
 
@@ -816,17 +866,31 @@ StringName Node::get_name() const {
 }
 
 void Node::_set_name_nocheck(const StringName &p_name) {
+	if (data.parent) {
+		data.parent->_remove_child_name(this);
+	}
+
 	data.name = p_name;
+
+	if (data.parent) {
+		data.parent->_add_child_name(this);
+	}
 }
 
 void Node::set_name(const String &p_name) {
 	String name = p_name.validate_node_name();
 
 	ERR_FAIL_COND(name == "");
+
+	if (data.parent) {
+		data.parent->_remove_child_name(this);
+	}
+
 	data.name = name;
 
 	if (data.parent) {
 		data.parent->_validate_child_name(this);
+		data.parent->_add_child_name(this);
 	}
 
 	propagate_notification(NOTIFICATION_PATH_CHANGED);
@@ -879,18 +943,7 @@ void Node::_validate_child_name(Node *p_child, bool p_force_human_readable) {
 			unique = false;
 		} else {
 			//check if exists
-			Node **children = data.children.ptrw();
-			int cc = data.children.size();
-
-			for (int i = 0; i < cc; i++) {
-				if (children[i] == p_child) {
-					continue;
-				}
-				if (children[i]->data.name == p_child->data.name) {
-					unique = false;
-					break;
-				}
-			}
+			unique = !_is_child_name_taken(p_child->data.name, p_child);
 		}
 
 		if (!unique) {
@@ -947,20 +1000,9 @@ void Node::_generate_serial_child_name(const Node *p_child, StringName &name) co
 	}
 
 	//quickly test if proposed name exists
-	int cc = data.children.size(); //children count
-	const Node *const *children_ptr = data.children.ptr();
-
 	{
-		bool exists = false;
-
-		for (int i = 0; i < cc; i++) {
-			if (children_ptr[i] == p_child) { //exclude self in renaming if it's already a child
-				continue;
-			}
-			if (children_ptr[i]->data.name == name) {
-				exists = true;
-			}
-		}
+		//exclude self in renaming if it's already a child
+		bool exists = _is_child_name_taken(name, p_child);
 
 		if (!exists) {
 			return; //if it does not exist, it does not need validation
@@ -991,16 +1033,7 @@ void Node::_generate_serial_child_name(const Node *p_child, StringName &name) co
 
 	for (;;) {
 		StringName attempt = name_string + nums;
-		bool exists = false;
-
-		for (int i = 0; i < cc; i++) {
-			if (children_ptr[i] == p_child) {
-				continue;
-			}
-			if (children_ptr[i]->data.name == attempt) {
-				exists = true;
-			}
-		}
+		bool exists = _is_child_name_taken(attempt, p_child);
 
 		if (!exists) {
 			name = attempt;
@@ -1023,6 +1056,7 @@ void Node::_add_child_nocheck(Node *p_child, const StringName &p_name) {
 	p_child->data.name = p_name;
 	p_child->data.pos = data.children.size();
 	data.children.push_back(p_child);
+	_add_child_name(p_child);
 	p_child->data.parent = this;
 	p_child->notification(NOTIFICATION_PARENTED);
 
@@ -1038,6 +1072,10 @@ void Node::_add_child_nocheck(Node *p_child, const StringName &p_name) {
 
 void Node::add_child(Node *p_child, bool p_legible_unique_name) {
 	ERR_FAIL_NULL(p_child);
+	if (MessageQueue::is_thread_deferring()) {
+		MessageQueue::get_singleton()->push_call(this, "add_child", p_child, p_legible_unique_name);
+		return;
+	}
 	ERR_FAIL_COND_MSG(p_child == this, vformat("Can't add child '%s' to itself.", p_child->get_name())); // adding to itself!
 	ERR_FAIL_COND_MSG(p_child->data.parent, vformat("Can't add child '%s' to '%s', already has a parent '%s'.", p_child->get_name(), get_name(), p_child->data.parent->get_name())); //Fail if node has a parent
 #ifdef DEBUG_ENABLED
@@ -1053,6 +1091,10 @@ void Node::add_child(Node *p_child, bool p_legible_unique_name) {
 
 void Node::add_sibling(Node *p_sibling, bool p_legible_unique_name) {
 	ERR_FAIL_NULL(p_sibling);
+	if (MessageQueue::is_thread_deferring()) {
+		MessageQueue::get_singleton()->push_call(this, "add_sibling", p_sibling, p_legible_unique_name);
+		return;
+	}
 	ERR_FAIL_COND_MSG(p_sibling == this, vformat("Can't add sibling '%s' to itself.", p_sibling->get_name())); // adding to itself!
 	ERR_FAIL_COND_MSG(data.blocked > 0, "Parent node is busy setting up children, add_sibling() failed. Consider using call_deferred(\"add_sibling\", sibling) instead.");
 
@@ -1087,6 +1129,10 @@ void Node::_propagate_validate_owner() {
 
 void Node::remove_child(Node *p_child) {
 	ERR_FAIL_NULL(p_child);
+	if (MessageQueue::is_thread_deferring()) {
+		MessageQueue::get_singleton()->push_call(this, "remove_child", p_child);
+		return;
+	}
 	ERR_FAIL_COND_MSG(data.blocked > 0, "Parent node is busy setting up children, remove_node() failed. Consider using call_deferred(\"remove_child\", child) instead.");
 
 	int child_count = data.children.size();
@@ -1120,6 +1166,7 @@ void Node::remove_child(Node *p_child) {
 	p_child->notification(NOTIFICATION_UNPARENTED);
 
 	data.children.remove(idx);
+	_remove_child_name(p_child);
 
 	//update pointer and size
 	child_count = data.children.size();
@@ -1155,16 +1202,72 @@ Node *Node::get_child(int p_index) const {
 }
 
 Node *Node::_get_child_by_name(const StringName &p_name) const {
-	int cc = data.children.size();
-	Node *const *cd = data.children.ptr();
+	if (data.children_unindexed_names > 0) {
+		// Names set without validation can be duplicated, the first child has precedence.
+		int cc = data.children.size();
+		Node *const *cd = data.children.ptr();
+		for (int i = 0; i < cc; i++) {
+			if (cd[i]->data.name == p_name) {
+				return cd[i];
+			}
+		}
+		return nullptr;
+	}
 
-	for (int i = 0; i < cc; i++) {
-		if (cd[i]->data.name == p_name) {
-			return cd[i];
+	Node *const *child = data.children_by_name.getptr(p_name);
+	return child ? *child : nullptr;
+}
+
+bool Node::_is_child_name_taken(const StringName &p_name, const Node *p_child) const {
+	if (data.children_unindexed_names > 0) {
+		int cc = data.children.size();
+		Node *const *cd = data.children.ptr();
+		for (int i = 0; i < cc; i++) {
+			if (cd[i] != p_child && cd[i]->data.name == p_name) {
+				return true;
+			}
 		}
+		return false;
 	}
 
-	return nullptr;
+	Node *const *child = data.children_by_name.getptr(p_name);
+	return child && *child != p_child;
+}
+
+void Node::_add_child_name(Node *p_child) {
+	Node **named = data.children_by_name.getptr(p_child->data.name);
+	if (named && *named != p_child) {
+		data.children_unindexed_names++; // Another child has the name already.
+	} else {
+		data.children_by_name.set(p_child->data.name, p_child);
+	}
+}
+
+void Node::_remove_child_name(Node *p_child) {
+	Node **named = data.children_by_name.getptr(p_child->data.name);
+	if (!named) {
+		return;
+	}
+
+	if (*named != p_child) {
+		data.children_unindexed_names--; // It wasn't in the index.
+		return;
+	}
+
+	data.children_by_name.erase(p_child->data.name);
+
+	if (data.children_unindexed_names > 0) {
+		// Index another child with the same name, if any.
+		int cc = data.children.size();
+		Node **cd = data.children.ptrw();
+		for (int i = 0; i < cc; i++) {
+			if (cd[i] != p_child && cd[i]->data.name == p_child->data.name) {
+				data.children_by_name.set(cd[i]->data.name, cd[i]);
+				data.children_unindexed_names--;
+				break;
+			}
+		}
+	}
 }
 
 Node *Node::get_node_or_null(const NodePath &p_path) const {
@@ -1207,16 +1310,7 @@ Node *Node::get_node_or_null(const NodePath &p_path) const {
 			}
 
 		} else {
-			next = nullptr;
-
-			for (int j = 0; j < current->data.children.size(); j++) {
-				Node *child = current->data.children[j];
-
-				if (child->data.name == name) {
-					next = child;
-					break;
-				}
-			}
+			next = current->_get_child_by_name(name);
 			if (next == nullptr) {
 				return nullptr;
 			};
@@ -1525,6 +1619,10 @@ bool Node::is_in_group(const StringName &p_identifier) const {
 
 void Node::add_to_group(const StringName &p_identifier, bool p_persistent) {
 	ERR_FAIL_COND(!p_identifier.operator String().length());
+	if (MessageQueue::is_thread_deferring()) {
+		MessageQueue::get_singleton()->push_call(this, "add_to_group", p_identifier, p_persistent);
+		return;
+	}
 
 	if (data.grouped.has(p_identifier)) {
 		return;
@@ -1544,6 +1642,10 @@ void Node::add_to_group(const StringName &p_identifier, bool p_persistent) {
 }
 
 void Node::remove_from_group(const StringName &p_identifier) {
+	if (MessageQueue::is_thread_deferring()) {
+		MessageQueue::get_singleton()->push_call(this, "remove_from_group", p_identifier);
+		return;
+	}
 	ERR_FAIL_COND(!data.grouped.has(p_identifier));
 
 	Map<StringName, GroupData>::Element *E = data.grouped.find(p_identifier);
@@ -2378,6 +2480,10 @@ void Node::print_stray_nodes() {
 }
 
 void Node::queue_delete() {
+	if (MessageQueue::is_thread_deferring()) {
+		MessageQueue::get_singleton()->push_call(this, "queue_free");
+		return;
+	}
 	if (is_inside_tree()) {
 		get_tree()->queue_delete(this);
 	} else {
@@ -2551,6 +2657,8 @@ void Node::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_process_mode", "mode"), &Node::set_process_mode);
 	ClassDB::bind_method(D_METHOD("get_process_mode"), &Node::get_process_mode);
 	ClassDB::bind_method(D_METHOD("can_process"), &Node::can_process);
+	ClassDB::bind_method(D_METHOD("set_process_thread_group", "group"), &Node::set_process_thread_group);
+	ClassDB::bind_method(D_METHOD("get_process_thread_group"), &Node::get_process_thread_group);
 	ClassDB::bind_method(D_METHOD("print_stray_nodes"), &Node::_print_stray_nodes);
 
 	ClassDB::bind_method(D_METHOD("set_display_folded", "fold"), &Node::set_display_folded);
@@ -2656,6 +2764,10 @@ void Node::_bind_methods() {
 	BIND_ENUM_CONSTANT(PROCESS_MODE_ALWAYS);
 	BIND_ENUM_CONSTANT(PROCESS_MODE_DISABLED);
 
+	BIND_ENUM_CONSTANT(PROCESS_THREAD_GROUP_INHERIT);
+	BIND_ENUM_CONSTANT(PROCESS_THREAD_GROUP_MAIN_THREAD);
+	BIND_ENUM_CONSTANT(PROCESS_THREAD_GROUP_SUB_THREAD);
+
 	BIND_ENUM_CONSTANT(DUPLICATE_SIGNALS);
 	BIND_ENUM_CONSTANT(DUPLICATE_GROUPS);
 	BIND_ENUM_CONSTANT(DUPLICATE_SCRIPTS);
@@ -2676,6 +2788,7 @@ void Node::_bind_methods() {
 	ADD_GROUP("Process", "process_");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "process_mode", PROPERTY_HINT_ENUM, "Inherit,Pausable,When Paused,Always,Disabled"), "set_process_mode", "get_process_mode");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "process_priority"), "set_process_priority", "get_process_priority");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "process_thread_group", PROPERTY_HINT_ENUM, "Inherit,Main Thread,Sub Thread"), "set_process_thread_group", "get_process_thread_group");
 
 	ADD_GROUP("Editor Description", "editor_");
 	ADD_PROPERTY(PropertyInfo(Variant::STRING, "editor_description", PROPERTY_HINT_MULTILINE_TEXT, "", PROPERTY_USAGE_EDITOR | PROPERTY_USAGE_INTERNAL), "set_editor_description", "get_editor_description");
@@ -2713,6 +2826,8 @@ Node::~Node() {
 	data.grouped.clear();
 	data.owned.clear();
 	data.children.clear();
+	data.children_by_name.clear();
+	data.children_unindexed_names = 0;
 
 	ERR_FAIL_COND(data.parent);
 	ERR_FAIL_COND(data.children.size());
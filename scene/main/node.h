@@ -35,6 +35,7 @@
 #include "core/object/class_db.h"
 #include "core/object/script_language.h"
 #include "core/string/node_path.h"
+#include "core/templates/hash_map.h"
 #include "core/templates/map.h"
 #include "core/variant/typed_array.h"
 #include "scene/main/scene_tree.h"
@@ -57,6 +58,12 @@ public:
 		PROCESS_MODE_DISABLED, // never process
 	};
 
+	enum ProcessThreadGroup {
+		PROCESS_THREAD_GROUP_INHERIT, // same as parent node
+		PROCESS_THREAD_GROUP_MAIN_THREAD, // process on the main thread
+		PROCESS_THREAD_GROUP_SUB_THREAD, // process this subtree on a worker thread, alongside other sub thread groups
+	};
+
 	enum DuplicateFlags {
 		DUPLICATE_SIGNALS = 1,
 		DUPLICATE_GROUPS = 2,
@@ -91,6 +98,8 @@ private:
 		Node *parent = nullptr;
 		Node *owner = nullptr;
 		Vector<Node *> children;
+		HashMap<StringName, Node *> children_by_name;
+		int children_unindexed_names = 0; // Children missing from children_by_name, as another child has their name.
 		int pos = -1;
 		int depth = -1;
 		int blocked = 0; // Safeguard that throws an error when attempting to modify the tree in a harmful way while being traversed.
@@ -113,6 +122,10 @@ private:
 		ProcessMode process_mode = PROCESS_MODE_INHERIT;
 		Node *process_owner = nullptr;
 
+		ProcessThreadGroup process_thread_group = PROCESS_THREAD_GROUP_INHERIT;
+		Node *process_thread_group_owner = nullptr; // Null when processing on the main thread.
+		int process_thread_batch = -1; // Used by SceneTree while dispatching the group owned by this node.
+
 		int network_master = 1; // Server by default.
 		Vector<MultiplayerAPI::RPCConfig> rpc_methods;
 
@@ -152,6 +165,9 @@ private:
 	void _print_tree(const Node *p_node);
 
 	Node *_get_child_by_name(const StringName &p_name) const;
+	bool _is_child_name_taken(const StringName &p_name, const Node *p_child) const;
+	void _add_child_name(Node *p_child);
+	void _remove_child_name(Node *p_child);
 
 	void _replace_connections_target(Node *p_new_target);
 
@@ -167,6 +183,7 @@ private:
 	void _propagate_validate_owner();
 	void _print_stray_nodes();
 	void _propagate_process_owner(Node *p_owner, int p_notification);
+	void _propagate_process_thread_group_owner(Node *p_owner);
 	Array _get_node_and_resource(const NodePath &p_path);
 
 	void _duplicate_signals(const Node *p_original, Node *p_copy) const;
@@ -386,6 +403,10 @@ public:
 	bool can_process() const;
 	bool can_process_notification(int p_what) const;
 
+	void set_process_thread_group(ProcessThreadGroup p_group);
+	ProcessThreadGroup get_process_thread_group() const;
+	_FORCE_INLINE_ bool is_process_threaded() const { return data.process_thread_group_owner != nullptr; }
+
 	void request_ready();
 
 	static void print_stray_nodes();
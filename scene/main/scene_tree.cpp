@@ -41,6 +41,8 @@
 #include "core/os/os.h"
 #include "core/string/print_string.h"
 #include "node.h"
+#include "scene/animation/animation_player.h"
+#include "scene/animation/animation_tree.h"
 #include "scene/animation/tween.h"
 #include "scene/debugger/scene_debugger.h"
 #include "scene/resources/font.h"
@@ -118,36 +120,149 @@ void SceneTree::node_renamed(Node *p_node) {
 }
 
 SceneTree::Group *SceneTree::add_to_group(const StringName &p_group, Node *p_node) {
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
-	if (!E) {
-		E = group_map.insert(p_group, Group());
+	Group *group = group_map.getptr(p_group);
+	if (!group) {
+		group = &group_map.set(p_group, Group())->value();
+		group->process_order = p_group == process_group || p_group == process_internal_group || p_group == physics_process_group || p_group == physics_process_internal_group;
+	}
+
+	// Node keeps track of its groups, so it's not added twice. Added nodes are kept after
+	// the sorted ones, and merged in the next time the group is used.
+	group->nodes.push_back(p_node);
+	return group;
+}
+
+template <class C>
+static int _find_sorted_group_node(const Node *const *p_nodes, int p_count, const Node *p_node) {
+	C compare;
+	int low = 0;
+	int high = p_count;
+	while (low < high) {
+		int middle = (low + high) / 2;
+		if (compare(p_nodes[middle], p_node)) {
+			low = middle + 1;
+		} else {
+			high = middle;
+		}
 	}
-
-	ERR_FAIL_COND_V_MSG(E->get().nodes.find(p_node) != -1, &E->get(), "Already in group: " + p_group + ".");
-	E->get().nodes.push_back(p_node);
-	//E->get().last_tree_version=0;
-	E->get().changed = true;
-	return &E->get();
+	return (low < p_count && p_nodes[low] == p_node) ? low : -1;
 }
 
 void SceneTree::remove_from_group(const StringName &p_group, Node *p_node) {
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
-	ERR_FAIL_COND(!E);
+	Group *group = group_map.getptr(p_group);
+	ERR_FAIL_COND(!group);
+
+	int idx = -1;
+	if (!group->changed) {
+		if (group->process_order) {
+			idx = _find_sorted_group_node<Node::ComparatorWithPriority>(group->nodes.ptr(), group->sorted_count, p_node);
+		} else {
+			idx = _find_sorted_group_node<Node::Comparator>(group->nodes.ptr(), group->sorted_count, p_node);
+		}
+	}
+	if (idx == -1) {
+		idx = group->nodes.find(p_node);
+	}
 
-	E->get().nodes.erase(p_node);
-	if (E->get().nodes.is_empty()) {
-		group_map.erase(E);
+	if (idx != -1) {
+		group->nodes.remove(idx);
+		if (idx < group->sorted_count) {
+			group->sorted_count--;
+		}
+	}
+
+	if (group->nodes.is_empty()) {
+		group_map.erase(p_group);
 	}
 }
 
 void SceneTree::make_group_changed(const StringName &p_group) {
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
-	if (E) {
-		E->get().changed = true;
+	Group *group = group_map.getptr(p_group);
+	if (group) {
+		group->changed = true;
+	}
+}
+
+void SceneTree::_sort_transform_notifications() {
+	xform_change_sort.clear();
+	int max_depth = 0;
+	bool sorted = true;
+	for (SelfList<Node> *n = xform_change_list.first(); n; n = n->next()) {
+		int depth = n->self()->data.depth;
+		sorted = sorted && depth >= max_depth;
+		max_depth = MAX(max_depth, depth);
+		xform_change_sort.push_back(n);
+	}
+
+	if (sorted) {
+		return;
+	}
+
+	// Counting sort by depth, which keeps the order of the nodes at the same depth.
+	xform_change_depth_offsets.resize(max_depth + 2);
+	for (uint32_t i = 0; i < xform_change_depth_offsets.size(); i++) {
+		xform_change_depth_offsets[i] = 0;
+	}
+	uint32_t count = xform_change_sort.size();
+	for (uint32_t i = 0; i < count; i++) {
+		xform_change_depth_offsets[xform_change_sort[i]->self()->data.depth + 1]++;
+	}
+	for (uint32_t i = 1; i < xform_change_depth_offsets.size(); i++) {
+		xform_change_depth_offsets[i] += xform_change_depth_offsets[i - 1];
+	}
+
+	xform_change_sort.resize(count * 2);
+	for (uint32_t i = 0; i < count; i++) {
+		SelfList<Node> *n = xform_change_sort[i];
+		xform_change_sort[count + xform_change_depth_offsets[n->self()->data.depth]++] = n;
+		xform_change_list.remove(n);
+	}
+	for (uint32_t i = count; i < count * 2; i++) {
+		xform_change_list.add_last(xform_change_sort[i]);
+	}
+}
+
+void SceneTree::_set_instance_transform(RID p_instance, const Transform3D &p_transform) {
+	if (!xform_change_flushing) {
+		RS::get_singleton()->instance_set_transform(p_instance, p_transform);
+		return;
+	}
+
+	xform_change_instances.push_back(p_instance);
+	xform_change_instance_transforms.push_back(p_transform);
+}
+
+void SceneTree::_set_collision_object_transform(RID p_object, bool p_area, const Transform3D &p_transform) {
+	if (!xform_change_flushing) {
+		if (p_area) {
+			PhysicsServer3D::get_singleton()->area_set_transform(p_object, p_transform);
+		} else {
+			PhysicsServer3D::get_singleton()->body_set_state(p_object, PhysicsServer3D::BODY_STATE_TRANSFORM, p_transform);
+		}
+		return;
+	}
+
+	if (p_area) {
+		xform_change_areas.push_back(p_object);
+		xform_change_area_transforms.push_back(p_transform);
+	} else {
+		xform_change_bodies.push_back(p_object);
+		xform_change_body_transforms.push_back(p_transform);
 	}
 }
 
 void SceneTree::flush_transform_notifications() {
+	if (!xform_change_list.first()) {
+		return;
+	}
+
+	// Parents are notified before their children, so global transforms are computed top
+	// down, each from an up to date parent, instead of climbing the tree for every node.
+	_sort_transform_notifications();
+
+	bool was_flushing = xform_change_flushing;
+	xform_change_flushing = true;
+
 	SelfList<Node> *n = xform_change_list.first();
 	while (n) {
 		Node *node = n->self();
@@ -156,6 +271,253 @@ void SceneTree::flush_transform_notifications() {
 		n = nx;
 		node->notification(NOTIFICATION_TRANSFORM_CHANGED);
 	}
+
+	xform_change_flushing = was_flushing;
+	if (xform_change_flushing) {
+		return;
+	}
+	if (xform_change_instances.size()) {
+		RS::get_singleton()->instance_set_transforms(xform_change_instances, xform_change_instance_transforms);
+		xform_change_instances.clear();
+		xform_change_instance_transforms.clear();
+	}
+	// Like the instances, moved collision objects reach the physics server at the end of the flush.
+	if (xform_change_bodies.size()) {
+		PhysicsServer3D::get_singleton()->body_set_transforms(xform_change_bodies, xform_change_body_transforms);
+		xform_change_bodies.clear();
+		xform_change_body_transforms.clear();
+	}
+	if (xform_change_areas.size()) {
+		PhysicsServer3D::get_singleton()->area_set_transforms(xform_change_areas, xform_change_area_transforms);
+		xform_change_areas.clear();
+		xform_change_area_transforms.clear();
+	}
+}
+
+ThreadWorkPool *SceneTree::get_thread_work_pool() {
+	if (!thread_work_pool) {
+		thread_work_pool = memnew(ThreadWorkPool);
+		thread_work_pool->init();
+	}
+	return thread_work_pool;
+}
+
+ThreadWorkPool *SceneTree::get_thread_work_pool_for_main_thread() {
+	if (!thread_work_pool_enabled || Thread::get_caller_id() != Thread::get_main_id()) {
+		return nullptr;
+	}
+	ThreadWorkPool *pool = get_thread_work_pool();
+	if (pool->get_thread_count() < 2 || pool->is_working()) {
+		return nullptr;
+	}
+	return pool;
+}
+
+void SceneTree::set_thread_work_pool_enabled(bool p_enabled) {
+	thread_work_pool_enabled = p_enabled;
+}
+
+bool SceneTree::is_thread_work_pool_enabled() const {
+	return thread_work_pool_enabled;
+}
+
+void SceneTree::_queue_threaded_animation_player(AnimationPlayer *p_player) {
+	threaded_animation_players.push_back(p_player);
+}
+
+void SceneTree::_unqueue_threaded_animation_player(AnimationPlayer *p_player) {
+	// Keep indices stable, as this may happen while the queue is being committed.
+	int64_t idx = threaded_animation_players.find(p_player);
+	if (idx >= 0) {
+		threaded_animation_players[idx] = nullptr;
+	}
+}
+
+void SceneTree::_queue_threaded_animation_tree(AnimationTree *p_tree) {
+	threaded_animation_trees.push_back(p_tree);
+}
+
+void SceneTree::_unqueue_threaded_animation_tree(AnimationTree *p_tree) {
+	int64_t idx = threaded_animation_trees.find(p_tree);
+	if (idx >= 0) {
+		threaded_animation_trees[idx] = nullptr;
+	}
+}
+
+void SceneTree::_threaded_animation_player_blend(uint32_t p_index, void *p_userdata) {
+	AnimationPlayer *player = threaded_animation_players[p_index];
+	if (player) {
+		player->_animation_process_blend(player->threaded_delta);
+	}
+}
+
+void SceneTree::_threaded_animation_tree_blend(uint32_t p_index, void *p_userdata) {
+	const LocalVector<AnimationTree *> &trees = threaded_animation_tree_groups[p_index];
+	for (uint32_t i = 0; i < trees.size(); i++) {
+		trees[i]->_process_graph_blend(trees[i]->threaded_delta);
+	}
+}
+
+static void _collect_animation_nodes(AnimationNode *p_node, HashMap<ObjectID, uint32_t> &r_users, uint32_t p_user, LocalVector<uint32_t> &r_group_of) {
+	ObjectID id = p_node->get_instance_id();
+	uint32_t *other = r_users.getptr(id);
+	if (other) {
+		if (*other == p_user) {
+			return; // Already visited for this tree.
+		}
+		// Shared with an earlier tree, merge both groups.
+		uint32_t a = p_user;
+		while (r_group_of[a] != a) {
+			a = r_group_of[a];
+		}
+		uint32_t b = *other;
+		while (r_group_of[b] != b) {
+			b = r_group_of[b];
+		}
+		r_group_of[MAX(a, b)] = MIN(a, b);
+	}
+	r_users[id] = p_user;
+
+	List<AnimationNode::ChildNode> children;
+	p_node->get_child_nodes(&children);
+	for (List<AnimationNode::ChildNode>::Element *E = children.front(); E; E = E->next()) {
+		if (E->get().node.is_valid()) {
+			_collect_animation_nodes(E->get().node.ptr(), r_users, p_user, r_group_of);
+		}
+	}
+}
+
+void SceneTree::_group_threaded_animation_trees() {
+	for (uint32_t i = 0; i < threaded_animation_tree_group_count; i++) {
+		threaded_animation_tree_groups[i].clear();
+	}
+	threaded_animation_tree_group_count = 0;
+
+	// Union-find over the queued trees, linking the ones that reach a common node.
+	const uint32_t tree_count = threaded_animation_trees.size();
+	LocalVector<uint32_t> group_of;
+	group_of.resize(tree_count);
+	HashMap<ObjectID, uint32_t> users;
+	for (uint32_t i = 0; i < tree_count; i++) {
+		group_of[i] = i;
+		AnimationTree *tree = threaded_animation_trees[i];
+		if (tree && tree->get_tree_root().is_valid()) {
+			_collect_animation_nodes(tree->get_tree_root().ptr(), users, i, group_of);
+		}
+	}
+
+	// Groups keep the queue order of their trees.
+	LocalVector<int> group_index;
+	group_index.resize(tree_count);
+	for (uint32_t i = 0; i < tree_count; i++) {
+		group_index[i] = -1;
+		AnimationTree *tree = threaded_animation_trees[i];
+		if (!tree) {
+			continue;
+		}
+		uint32_t root = i;
+		while (group_of[root] != root) {
+			root = group_of[root];
+		}
+		if (group_index[root] < 0) {
+			group_index[root] = threaded_animation_tree_group_count++;
+			if (threaded_animation_tree_groups.size() < threaded_animation_tree_group_count) {
+				threaded_animation_tree_groups.resize(threaded_animation_tree_group_count);
+			}
+		}
+		threaded_animation_tree_groups[group_index[root]].push_back(tree);
+	}
+}
+
+void SceneTree::_flush_threaded_animations() {
+	if (threaded_animation_players.is_empty() && threaded_animation_trees.is_empty()) {
+		return;
+	}
+
+	// Resolve caches and validate first, nodes may have changed since they were queued.
+	for (uint32_t i = 0; i < threaded_animation_players.size(); i++) {
+		AnimationPlayer *player = threaded_animation_players[i];
+		if (player && !player->_animation_process_prepare()) {
+			player->threaded_queued = false;
+			threaded_animation_players[i] = nullptr;
+		}
+	}
+	for (uint32_t i = 0; i < threaded_animation_trees.size(); i++) {
+		AnimationTree *tree = threaded_animation_trees[i];
+		if (tree && !tree->_process_graph_prepare()) {
+			tree->threaded_queued = false;
+			threaded_animation_trees[i] = nullptr;
+		}
+	}
+
+	ThreadWorkPool *pool = get_thread_work_pool();
+
+	// Evaluation only touches the state of each player/tree, so all of them can blend at once.
+	if (threaded_animation_players.size()) {
+		pool->do_work(threaded_animation_players.size(), this, &SceneTree::_threaded_animation_player_blend, nullptr);
+	}
+	_group_threaded_animation_trees();
+	if (threaded_animation_tree_group_count) {
+		pool->do_work(threaded_animation_tree_group_count, this, &SceneTree::_threaded_animation_tree_blend, nullptr);
+	}
+
+	// Writing the results to the animated nodes has to happen here, in queue order.
+	for (uint32_t i = 0; i < threaded_animation_players.size(); i++) {
+		AnimationPlayer *player = threaded_animation_players[i];
+		if (player) {
+			player->threaded_queued = false;
+			player->_animation_process_commit();
+		}
+	}
+	for (uint32_t i = 0; i < threaded_animation_trees.size(); i++) {
+		AnimationTree *tree = threaded_animation_trees[i];
+		if (tree) {
+			tree->threaded_queued = false;
+			tree->_process_graph_commit();
+		}
+	}
+
+	threaded_animation_players.clear();
+	threaded_animation_trees.clear();
+}
+
+void SceneTree::_queue_threaded_process(Node *p_node) {
+	Node *owner = p_node->data.process_thread_group_owner;
+	int batch = owner->data.process_thread_batch;
+	if (batch < 0) {
+		batch = process_thread_batch_count++;
+		if (process_thread_batches.size() < process_thread_batch_count) {
+			process_thread_batches.resize(process_thread_batch_count);
+		}
+		process_thread_batches[batch].owner = owner;
+		owner->data.process_thread_batch = batch;
+	}
+	process_thread_batches[batch].nodes.push_back(p_node);
+}
+
+void SceneTree::_threaded_process_batch(uint32_t p_index, int p_notification) {
+	MessageQueue::set_thread_deferring(true);
+	const LocalVector<Node *> &nodes = process_thread_batches[p_index].nodes;
+	for (uint32_t i = 0; i < nodes.size(); i++) {
+		nodes[i]->notification(p_notification);
+	}
+	MessageQueue::set_thread_deferring(false);
+}
+
+void SceneTree::_flush_threaded_process(int p_notification) {
+	if (process_thread_batch_count == 0) {
+		return;
+	}
+
+	process_thread_batches_running = true;
+	get_thread_work_pool()->do_work(process_thread_batch_count, this, &SceneTree::_threaded_process_batch, p_notification);
+	process_thread_batches_running = false;
+
+	for (uint32_t i = 0; i < process_thread_batch_count; i++) {
+		process_thread_batches[i].owner->data.process_thread_batch = -1;
+		process_thread_batches[i].nodes.clear();
+	}
+	process_thread_batch_count = 0;
 }
 
 void SceneTree::_flush_ugc() {
@@ -178,33 +540,57 @@ void SceneTree::_flush_ugc() {
 	ugc_locked = false;
 }
 
-void SceneTree::_update_group_order(Group &g, bool p_use_priority) {
-	if (!g.changed) {
-		return;
+// Sorts the nodes added after the first p_sorted ones, then merges them in.
+template <class C>
+static void _merge_group_nodes(Node **p_nodes, int p_count, int p_sorted) {
+	SortArray<Node *, C> node_sort;
+	node_sort.sort(p_nodes + p_sorted, p_count - p_sorted);
+
+	C compare;
+	if (p_sorted == 0 || !compare(p_nodes[p_sorted], p_nodes[p_sorted - 1])) {
+		return; // Already in order, usual when nodes are added at the end of the tree.
 	}
-	if (g.nodes.is_empty()) {
+
+	LocalVector<Node *> added;
+	added.resize(p_count - p_sorted);
+	memcpy(added.ptr(), p_nodes + p_sorted, added.size() * sizeof(Node *));
+
+	int i = p_sorted - 1;
+	int j = added.size() - 1;
+	int to = p_count - 1;
+	while (j >= 0) {
+		if (i >= 0 && compare(added[j], p_nodes[i])) {
+			p_nodes[to--] = p_nodes[i--];
+		} else {
+			p_nodes[to--] = added[j--];
+		}
+	}
+}
+
+void SceneTree::_update_group_order(Group &g) {
+	int node_count = g.nodes.size();
+	if (!g.changed && g.sorted_count == node_count) {
 		return;
 	}
 
 	Node **nodes = g.nodes.ptrw();
-	int node_count = g.nodes.size();
+	int sorted_count = g.changed ? 0 : g.sorted_count;
 
-	if (p_use_priority) {
-		SortArray<Node *, Node::ComparatorWithPriority> node_sort;
-		node_sort.sort(nodes, node_count);
+	if (g.process_order) {
+		_merge_group_nodes<Node::ComparatorWithPriority>(nodes, node_count, sorted_count);
 	} else {
-		SortArray<Node *, Node::Comparator> node_sort;
-		node_sort.sort(nodes, node_count);
+		_merge_group_nodes<Node::Comparator>(nodes, node_count, sorted_count);
 	}
+	g.sorted_count = node_count;
 	g.changed = false;
 }
 
 void SceneTree::call_group_flags(uint32_t p_call_flags, const StringName &p_group, const StringName &p_function, VARIANT_ARG_DECLARE) {
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
-	if (!E) {
+	Group *group = group_map.getptr(p_group);
+	if (!group) {
 		return;
 	}
-	Group &g = E->get();
+	Group &g = *group;
 	if (g.nodes.is_empty()) {
 		return;
 	}
@@ -237,7 +623,7 @@ void SceneTree::call_group_flags(uint32_t p_call_flags, const StringName &p_grou
 	_update_group_order(g);
 
 	Vector<Node *> nodes_copy = g.nodes;
-	Node **nodes = nodes_copy.ptrw();
+	Node *const *nodes = nodes_copy.ptr();
 	int node_count = nodes_copy.size();
 
 	call_lock++;
@@ -276,11 +662,11 @@ void SceneTree::call_group_flags(uint32_t p_call_flags, const StringName &p_grou
 }
 
 void SceneTree::notify_group_flags(uint32_t p_call_flags, const StringName &p_group, int p_notification) {
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
-	if (!E) {
+	Group *group = group_map.getptr(p_group);
+	if (!group) {
 		return;
 	}
-	Group &g = E->get();
+	Group &g = *group;
 	if (g.nodes.is_empty()) {
 		return;
 	}
@@ -288,7 +674,7 @@ void SceneTree::notify_group_flags(uint32_t p_call_flags, const StringName &p_gr
 	_update_group_order(g);
 
 	Vector<Node *> nodes_copy = g.nodes;
-	Node **nodes = nodes_copy.ptrw();
+	Node *const *nodes = nodes_copy.ptr();
 	int node_count = nodes_copy.size();
 
 	call_lock++;
@@ -327,11 +713,11 @@ void SceneTree::notify_group_flags(uint32_t p_call_flags, const StringName &p_gr
 }
 
 void SceneTree::set_group_flags(uint32_t p_call_flags, const StringName &p_group, const String &p_name, const Variant &p_value) {
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
-	if (!E) {
+	Group *group = group_map.getptr(p_group);
+	if (!group) {
 		return;
 	}
-	Group &g = E->get();
+	Group &g = *group;
 	if (g.nodes.is_empty()) {
 		return;
 	}
@@ -339,7 +725,7 @@ void SceneTree::set_group_flags(uint32_t p_call_flags, const StringName &p_group
 	_update_group_order(g);
 
 	Vector<Node *> nodes_copy = g.nodes;
-	Node **nodes = nodes_copy.ptrw();
+	Node *const *nodes = nodes_copy.ptr();
 	int node_count = nodes_copy.size();
 
 	call_lock++;
@@ -408,9 +794,10 @@ bool SceneTree::physics_process(float p_time) {
 
 	emit_signal("physics_frame");
 
-	_notify_group_pause("physics_process_internal", Node::NOTIFICATION_INTERNAL_PHYSICS_PROCESS);
+	_notify_group_pause(physics_process_internal_group, Node::NOTIFICATION_INTERNAL_PHYSICS_PROCESS);
+	_flush_threaded_animations();
 	call_group_flags(GROUP_CALL_REALTIME, "_viewports", "_process_picking");
-	_notify_group_pause("physics_process", Node::NOTIFICATION_PHYSICS_PROCESS);
+	_notify_group_pause(physics_process_group, Node::NOTIFICATION_PHYSICS_PROCESS);
 	_flush_ugc();
 	MessageQueue::get_singleton()->flush(); //small little hack
 
@@ -442,8 +829,9 @@ bool SceneTree::process(float p_time) {
 
 	flush_transform_notifications();
 
-	_notify_group_pause("process_internal", Node::NOTIFICATION_INTERNAL_PROCESS);
-	_notify_group_pause("process", Node::NOTIFICATION_PROCESS);
+	_notify_group_pause(process_internal_group, Node::NOTIFICATION_INTERNAL_PROCESS);
+	_flush_threaded_animations();
+	_notify_group_pause(process_group, Node::NOTIFICATION_PROCESS);
 
 	_flush_ugc();
 	MessageQueue::get_singleton()->flush(); //small little hack
@@ -803,23 +1191,27 @@ bool SceneTree::is_paused() const {
 }
 
 void SceneTree::_notify_group_pause(const StringName &p_group, int p_notification) {
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
-	if (!E) {
+	Group *group = group_map.getptr(p_group);
+	if (!group) {
 		return;
 	}
-	Group &g = E->get();
+	Group &g = *group;
 	if (g.nodes.is_empty()) {
 		return;
 	}
 
-	_update_group_order(g, p_notification == Node::NOTIFICATION_PROCESS || p_notification == Node::NOTIFICATION_INTERNAL_PROCESS || p_notification == Node::NOTIFICATION_PHYSICS_PROCESS || p_notification == Node::NOTIFICATION_INTERNAL_PHYSICS_PROCESS);
+	_update_group_order(g);
 
 	//copy, so copy on write happens in case something is removed from process while being called
 	//performance is not lost because only if something is added/removed the vector is copied.
+	//only read through ptr(), ptrw() would make the copy right away.
 	Vector<Node *> nodes_copy = g.nodes;
 
 	int node_count = nodes_copy.size();
-	Node **nodes = nodes_copy.ptrw();
+	Node *const *nodes = nodes_copy.ptr();
+
+	// Only user processing can be moved to other threads, engine nodes use internal processing.
+	bool threaded = p_notification == Node::NOTIFICATION_PROCESS || p_notification == Node::NOTIFICATION_PHYSICS_PROCESS;
 
 	call_lock++;
 
@@ -836,10 +1228,20 @@ void SceneTree::_notify_group_pause(const StringName &p_group, int p_notificatio
 			continue;
 		}
 
+		if (threaded && n->is_process_threaded()) {
+			_queue_threaded_process(n);
+			continue;
+		}
+
+		// Nodes on the main thread still see every node before them in processing order as processed.
+		_flush_threaded_process(p_notification);
+
 		n->notification(p_notification);
 		//ERR_FAIL_COND(node_count != g.nodes.size());
 	}
 
+	_flush_threaded_process(p_notification);
+
 	call_lock--;
 	if (call_lock == 0) {
 		call_skip.clear();
@@ -856,11 +1258,11 @@ void SceneMainLoop::_update_listener_2d() {
 */
 
 void SceneTree::_call_input_pause(const StringName &p_group, const StringName &p_method, const Ref<InputEvent> &p_input, Viewport *p_viewport) {
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
-	if (!E) {
+	Group *group = group_map.getptr(p_group);
+	if (!group) {
 		return;
 	}
-	Group &g = E->get();
+	Group &g = *group;
 	if (g.nodes.is_empty()) {
 		return;
 	}
@@ -872,7 +1274,7 @@ void SceneTree::_call_input_pause(const StringName &p_group, const StringName &p
 	Vector<Node *> nodes_copy = g.nodes;
 
 	int node_count = nodes_copy.size();
-	Node **nodes = nodes_copy.ptrw();
+	Node *const *nodes = nodes_copy.ptr();
 
 	Variant arg = p_input;
 	const Variant *v[1] = { &arg };
@@ -958,20 +1360,20 @@ int64_t SceneTree::get_frame() const {
 
 Array SceneTree::_get_nodes_in_group(const StringName &p_group) {
 	Array ret;
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
-	if (!E) {
+	Group *group = group_map.getptr(p_group);
+	if (!group) {
 		return ret;
 	}
 
-	_update_group_order(E->get()); //update order just in case
-	int nc = E->get().nodes.size();
+	_update_group_order(*group); //update order just in case
+	int nc = group->nodes.size();
 	if (nc == 0) {
 		return ret;
 	}
 
 	ret.resize(nc);
 
-	Node **ptr = E->get().nodes.ptrw();
+	Node **ptr = group->nodes.ptrw();
 	for (int i = 0; i < nc; i++) {
 		ret[i] = ptr[i];
 	}
@@ -984,32 +1386,32 @@ bool SceneTree::has_group(const StringName &p_identifier) const {
 }
 
 Node *SceneTree::get_first_node_in_group(const StringName &p_group) {
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
-	if (!E) {
+	Group *group = group_map.getptr(p_group);
+	if (!group) {
 		return nullptr; //no group
 	}
 
-	_update_group_order(E->get()); //update order just in case
+	_update_group_order(*group); //update order just in case
 
-	if (E->get().nodes.size() == 0) {
+	if (group->nodes.size() == 0) {
 		return nullptr;
 	}
 
-	return E->get().nodes[0];
+	return group->nodes[0];
 }
 
 void SceneTree::get_nodes_in_group(const StringName &p_group, List<Node *> *p_list) {
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
-	if (!E) {
+	Group *group = group_map.getptr(p_group);
+	if (!group) {
 		return;
 	}
 
-	_update_group_order(E->get()); //update order just in case
-	int nc = E->get().nodes.size();
+	_update_group_order(*group); //update order just in case
+	int nc = group->nodes.size();
 	if (nc == 0) {
 		return;
 	}
-	Node **ptr = E->get().nodes.ptrw();
+	Node **ptr = group->nodes.ptrw();
 	for (int i = 0; i < nc; i++) {
 		p_list->push_back(ptr[i]);
 	}
@@ -1522,6 +1924,11 @@ SceneTree::~SceneTree() {
 		memdelete(root);
 	}
 
+	if (thread_work_pool) {
+		thread_work_pool->finish();
+		memdelete(thread_work_pool);
+	}
+
 	if (singleton == this) {
 		singleton = nullptr;
 	}
@@ -33,8 +33,12 @@
 
 #include "core/io/multiplayer_api.h"
 #include "core/os/main_loop.h"
+#include "core/os/spin_lock.h"
 #include "core/os/thread_safe.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/self_list.h"
+#include "core/templates/thread_work_pool.h"
 #include "scene/resources/mesh.h"
 #include "scene/resources/world_2d.h"
 #include "scene/resources/world_3d.h"
@@ -48,6 +52,8 @@ class Material;
 class Mesh;
 class SceneDebugger;
 class Tween;
+class AnimationPlayer;
+class AnimationTree;
 
 class SceneTreeTimer : public RefCounted {
 	GDCLASS(SceneTreeTimer, RefCounted);
@@ -81,7 +87,9 @@ public:
 private:
 	struct Group {
 		Vector<Node *> nodes;
-		bool changed = false;
+		int sorted_count = 0; // Nodes added after these are sorted when the group is used.
+		bool changed = false; // The sorted nodes need to be sorted again.
+		bool process_order = false; // Sorted by process priority first.
 	};
 
 	Window *root = nullptr;
@@ -99,7 +107,7 @@ private:
 	bool paused = false;
 	int root_lock = 0;
 
-	Map<StringName, Group> group_map;
+	HashMap<StringName, Group> group_map;
 	bool _quit = false;
 	bool initialized = false;
 
@@ -108,6 +116,11 @@ private:
 	StringName node_removed_name = "node_removed";
 	StringName node_renamed_name = "node_renamed";
 
+	StringName process_group = "process";
+	StringName process_internal_group = "process_internal";
+	StringName physics_process_group = "physics_process";
+	StringName physics_process_internal_group = "physics_process_internal";
+
 	int64_t current_frame = 0;
 	int node_count = 0;
 
@@ -131,7 +144,7 @@ private:
 	bool ugc_locked = false;
 	void _flush_ugc();
 
-	_FORCE_INLINE_ void _update_group_order(Group &g, bool p_use_priority = false);
+	void _update_group_order(Group &g);
 	void _update_listener();
 
 	Array _get_nodes_in_group(const StringName &p_group);
@@ -184,12 +197,98 @@ private:
 	Variant _call_group(const Variant **p_args, int p_argcount, Callable::CallError &r_error);
 
 	void _flush_delete_queue();
+
+	// Worker threads shared by scene systems, created on first use.
+	ThreadWorkPool *thread_work_pool = nullptr;
+	bool thread_work_pool_enabled = true;
+
+	// Animations with threaded processing, blended in parallel once all internal process notifications were sent.
+	friend class AnimationPlayer;
+	friend class AnimationTree;
+
+	LocalVector<AnimationPlayer *> threaded_animation_players;
+	LocalVector<AnimationTree *> threaded_animation_trees;
+
+	void _queue_threaded_animation_player(AnimationPlayer *p_player);
+	void _unqueue_threaded_animation_player(AnimationPlayer *p_player);
+	void _queue_threaded_animation_tree(AnimationTree *p_tree);
+	void _unqueue_threaded_animation_tree(AnimationTree *p_tree);
+	void _threaded_animation_player_blend(uint32_t p_index, void *p_userdata);
+	void _threaded_animation_tree_blend(uint32_t p_index, void *p_userdata);
+	void _flush_threaded_animations();
+
+	// AnimationNodes keep evaluation data on the resource, so trees sharing any node are blended in order in one group.
+	LocalVector<LocalVector<AnimationTree *>> threaded_animation_tree_groups;
+	uint32_t threaded_animation_tree_group_count = 0;
+	void _group_threaded_animation_trees();
+
+	// Nodes in sub thread process groups, batched per group. Each batch is processed in order on a worker thread.
+	struct ProcessThreadBatch {
+		Node *owner = nullptr;
+		LocalVector<Node *> nodes;
+	};
+
+	LocalVector<ProcessThreadBatch> process_thread_batches;
+	uint32_t process_thread_batch_count = 0;
+	bool process_thread_batches_running = false;
+
+	void _queue_threaded_process(Node *p_node);
+	void _threaded_process_batch(uint32_t p_index, int p_notification);
+	void _flush_threaded_process(int p_notification);
+
 	// Optimization.
 	friend class CanvasItem;
+	friend class CollisionObject3D;
 	friend class Node3D;
 	friend class Viewport;
+	friend class VisualInstance3D;
 
 	SelfList<Node>::List xform_change_list;
+	// Sub thread process groups can move nodes from several threads at once.
+	SpinLock xform_change_lock;
+	LocalVector<SelfList<Node> *> xform_change_sort;
+	LocalVector<uint32_t> xform_change_depth_offsets;
+
+	// Instance and collision object transforms set while flushing, sent to the servers in one call each.
+	bool xform_change_flushing = false;
+	Vector<RID> xform_change_instances;
+	Vector<Transform3D> xform_change_instance_transforms;
+	Vector<RID> xform_change_bodies;
+	Vector<Transform3D> xform_change_body_transforms;
+	Vector<RID> xform_change_areas;
+	Vector<Transform3D> xform_change_area_transforms;
+
+	_FORCE_INLINE_ void _lock_xform_change_list() {
+		if (process_thread_batches_running) {
+			xform_change_lock.lock();
+		}
+	}
+	_FORCE_INLINE_ void _unlock_xform_change_list() {
+		if (process_thread_batches_running) {
+			xform_change_lock.unlock();
+		}
+	}
+	_FORCE_INLINE_ void _add_xform_change(SelfList<Node> *p_xform_change) {
+		_lock_xform_change_list();
+		if (!p_xform_change->in_list()) {
+			xform_change_list.add(p_xform_change);
+		}
+		_unlock_xform_change_list();
+	}
+	// Returns false if it was not in the list.
+	_FORCE_INLINE_ bool _remove_xform_change(SelfList<Node> *p_xform_change) {
+		_lock_xform_change_list();
+		bool in_list = p_xform_change->in_list();
+		if (in_list) {
+			xform_change_list.remove(p_xform_change);
+		}
+		_unlock_xform_change_list();
+		return in_list;
+	}
+
+	void _sort_transform_notifications();
+	void _set_instance_transform(RID p_instance, const Transform3D &p_transform);
+	void _set_collision_object_transform(RID p_object, bool p_area, const Transform3D &p_transform);
 
 #ifdef DEBUG_ENABLED // No live editor in release build.
 	friend class LiveEditor;
@@ -238,6 +337,13 @@ public:
 
 	void flush_transform_notifications();
 
+	ThreadWorkPool *get_thread_work_pool();
+	// The pool when the caller can spread work over it right now, otherwise null and the work runs on the calling thread.
+	ThreadWorkPool *get_thread_work_pool_for_main_thread();
+	// While disabled, get_thread_work_pool_for_main_thread() returns null. Useful to debug or compare results.
+	void set_thread_work_pool_enabled(bool p_enabled);
+	bool is_thread_work_pool_enabled() const;
+
 	virtual void initialize() override;
 
 	virtual bool physics_process(float p_time) override;
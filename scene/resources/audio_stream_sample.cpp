@@ -86,6 +86,35 @@ void AudioStreamPlaybackSample::seek(float p_time) {
 	offset = uint64_t(p_time * base->mix_rate) << MIX_FRAC_BITS;
 }
 
+void AudioStreamPlaybackSample::skip(float p_time) {
+	if (!active) {
+		return;
+	}
+
+	float pos = get_playback_position() + p_time;
+
+	switch (base->loop_mode) {
+		case AudioStreamSample::LOOP_DISABLED: {
+			if (pos >= base->get_length()) {
+				active = false;
+				return;
+			}
+		} break;
+		case AudioStreamSample::LOOP_FORWARD: {
+			float loop_begin = base->loop_begin / float(base->mix_rate);
+			float loop_end = base->loop_end / float(base->mix_rate);
+			if (pos >= loop_end && loop_end > loop_begin) {
+				pos = loop_begin + Math::fmod(pos - loop_begin, loop_end - loop_begin);
+			}
+		} break;
+		default: {
+			// Direction changes are not tracked, the position is clamped by seek().
+		} break;
+	}
+
+	seek(pos);
+}
+
 template <class Depth, bool is_stereo, bool is_ima_adpcm>
 void AudioStreamPlaybackSample::do_resample(const Depth *p_src, AudioFrame *p_dst, int64_t &offset, int32_t &increment, uint32_t amount, IMA_ADPCM_State *ima_adpcm) {
 	// this function will be compiled branchless by any decent compiler
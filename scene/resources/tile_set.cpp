@@ -3788,13 +3788,14 @@ void TileSetPluginAtlasRendering::tilemap_notification(TileMap *p_tile_map, int
 	switch (p_what) {
 		case CanvasItem::NOTIFICATION_VISIBILITY_CHANGED: {
 			bool visible = p_tile_map->is_visible_in_tree();
-			for (Map<Vector2i, TileMapQuadrant>::Element *E_quadrant = p_tile_map->get_quadrant_map().front(); E_quadrant; E_quadrant = E_quadrant->next()) {
-				TileMapQuadrant &q = E_quadrant->get();
+			HashMap<Vector2i, TileMapQuadrant, TileMapQuadrant::CoordsHasher> &quadrant_map = p_tile_map->get_quadrant_map();
+			for (const Vector2i *E_quadrant = quadrant_map.next(nullptr); E_quadrant; E_quadrant = quadrant_map.next(E_quadrant)) {
+				TileMapQuadrant &q = quadrant_map[*E_quadrant];
 
 				// Update occluders transform.
-				for (Map<Vector2i, Vector2i, TileMapQuadrant::CoordsWorldComparator>::Element *E_cell = q.world_to_map.front(); E_cell; E_cell = E_cell->next()) {
+				for (uint32_t cell_index = 0; cell_index < q.cells.size(); cell_index++) {
 					Transform2D xform;
-					xform.set_origin(E_cell->key());
+					xform.set_origin(p_tile_map->map_to_world(q.cells[cell_index]));
 					for (List<RID>::Element *E_occluder_id = q.occluders.front(); E_occluder_id; E_occluder_id = E_occluder_id->next()) {
 						RS::get_singleton()->canvas_light_occluder_set_enabled(E_occluder_id->get(), visible);
 					}
@@ -3806,13 +3807,14 @@ void TileSetPluginAtlasRendering::tilemap_notification(TileMap *p_tile_map, int
 				return;
 			}
 
-			for (Map<Vector2i, TileMapQuadrant>::Element *E_quadrant = p_tile_map->get_quadrant_map().front(); E_quadrant; E_quadrant = E_quadrant->next()) {
-				TileMapQuadrant &q = E_quadrant->get();
+			HashMap<Vector2i, TileMapQuadrant, TileMapQuadrant::CoordsHasher> &quadrant_map = p_tile_map->get_quadrant_map();
+			for (const Vector2i *E_quadrant = quadrant_map.next(nullptr); E_quadrant; E_quadrant = quadrant_map.next(E_quadrant)) {
+				TileMapQuadrant &q = quadrant_map[*E_quadrant];
 
 				// Update occluders transform.
-				for (Map<Vector2i, Vector2i, TileMapQuadrant::CoordsWorldComparator>::Element *E_cell = q.world_to_map.front(); E_cell; E_cell = E_cell->next()) {
+				for (uint32_t cell_index = 0; cell_index < q.cells.size(); cell_index++) {
 					Transform2D xform;
-					xform.set_origin(E_cell->key());
+					xform.set_origin(p_tile_map->map_to_world(q.cells[cell_index]));
 					for (List<RID>::Element *E_occluder_id = q.occluders.front(); E_occluder_id; E_occluder_id = E_occluder_id->next()) {
 						RS::get_singleton()->canvas_light_occluder_set_transform(E_occluder_id->get(), p_tile_map->get_global_transform() * xform);
 					}
@@ -3828,61 +3830,146 @@ void TileSetPluginAtlasRendering::tilemap_notification(TileMap *p_tile_map, int
 	}
 }
 
-void TileSetPluginAtlasRendering::draw_tile(RID p_canvas_item, Vector2i p_position, const Ref<TileSet> p_tile_set, int p_atlas_source_id, Vector2i p_atlas_coords, int p_alternative_tile, Color p_modulation) {
-	ERR_FAIL_COND(!p_tile_set.is_valid());
-	ERR_FAIL_COND(!p_tile_set->has_source(p_atlas_source_id));
-	ERR_FAIL_COND(!p_tile_set->get_source(p_atlas_source_id)->has_tile(p_atlas_coords));
-	ERR_FAIL_COND(!p_tile_set->get_source(p_atlas_source_id)->has_alternative_tile(p_atlas_coords, p_alternative_tile));
+// Computes how a tile is drawn, without talking to the RenderingServer.
+static bool _get_atlas_tile_rendering(TileMapQuadrant::RenderingTile &r_tile, Vector2i p_position, const Ref<TileSet> p_tile_set, int p_atlas_source_id, Vector2i p_atlas_coords, int p_alternative_tile, Color p_modulation) {
+	ERR_FAIL_COND_V(!p_tile_set.is_valid(), false);
+	ERR_FAIL_COND_V(!p_tile_set->has_source(p_atlas_source_id), false);
+	ERR_FAIL_COND_V(!p_tile_set->get_source(p_atlas_source_id)->has_tile(p_atlas_coords), false);
+	ERR_FAIL_COND_V(!p_tile_set->get_source(p_atlas_source_id)->has_alternative_tile(p_atlas_coords, p_alternative_tile), false);
 
 	TileSetSource *source = *p_tile_set->get_source(p_atlas_source_id);
 	TileSetAtlasSource *atlas_source = Object::cast_to<TileSetAtlasSource>(source);
-	if (atlas_source) {
-		// Get the texture.
-		Ref<Texture2D> tex = atlas_source->get_texture();
-		if (!tex.is_valid()) {
-			return;
-		}
+	if (!atlas_source) {
+		return false;
+	}
 
-		// Check if we are in the texture, return otherwise.
-		Vector2i grid_size = atlas_source->get_atlas_grid_size();
-		if (p_atlas_coords.x >= grid_size.x || p_atlas_coords.y >= grid_size.y) {
-			return;
-		}
+	// Get the texture.
+	Ref<Texture2D> tex = atlas_source->get_texture();
+	if (!tex.is_valid()) {
+		return false;
+	}
 
-		// Get tile data.
-		TileData *tile_data = Object::cast_to<TileData>(atlas_source->get_tile_data(p_atlas_coords, p_alternative_tile));
+	// Check if we are in the texture, return otherwise.
+	Vector2i grid_size = atlas_source->get_atlas_grid_size();
+	if (p_atlas_coords.x >= grid_size.x || p_atlas_coords.y >= grid_size.y) {
+		return false;
+	}
 
-		// Compute the offset
-		Rect2i source_rect = atlas_source->get_tile_texture_region(p_atlas_coords);
-		Vector2i tile_offset = atlas_source->get_tile_effective_texture_offset(p_atlas_coords, p_alternative_tile);
+	// Get tile data.
+	TileData *tile_data = Object::cast_to<TileData>(atlas_source->get_tile_data(p_atlas_coords, p_alternative_tile));
 
-		// Compute the destination rectangle in the CanvasItem.
-		Rect2 dest_rect;
-		dest_rect.size = source_rect.size;
-		dest_rect.size.x += fp_adjust;
-		dest_rect.size.y += fp_adjust;
+	// Compute the offset
+	Rect2i source_rect = atlas_source->get_tile_texture_region(p_atlas_coords);
+	Vector2i tile_offset = atlas_source->get_tile_effective_texture_offset(p_atlas_coords, p_alternative_tile);
 
-		bool transpose = tile_data->get_transpose();
-		if (transpose) {
-			dest_rect.position = (p_position - Vector2(dest_rect.size.y, dest_rect.size.x) / 2 - tile_offset);
-		} else {
-			dest_rect.position = (p_position - dest_rect.size / 2 - tile_offset);
+	// Compute the destination rectangle in the CanvasItem.
+	Rect2 dest_rect;
+	dest_rect.size = source_rect.size;
+	const float fp_adjust = 0.00001;
+	dest_rect.size.x += fp_adjust;
+	dest_rect.size.y += fp_adjust;
+
+	bool transpose = tile_data->get_transpose();
+	if (transpose) {
+		dest_rect.position = (p_position - Vector2(dest_rect.size.y, dest_rect.size.x) / 2 - tile_offset);
+	} else {
+		dest_rect.position = (p_position - dest_rect.size / 2 - tile_offset);
+	}
+
+	if (tile_data->get_flip_h()) {
+		dest_rect.size.x = -dest_rect.size.x;
+	}
+
+	if (tile_data->get_flip_v()) {
+		dest_rect.size.y = -dest_rect.size.y;
+	}
+
+	// Get the tile modulation.
+	Color modulate = tile_data->get_modulate();
+	modulate = Color(modulate.r * p_modulation.r, modulate.g * p_modulation.g, modulate.b * p_modulation.b, modulate.a * p_modulation.a);
+
+	r_tile.texture = tex;
+	r_tile.dest_rect = dest_rect;
+	r_tile.source_rect = source_rect;
+	r_tile.modulate = modulate;
+	r_tile.transpose = transpose;
+	return true;
+}
+
+void TileSetPluginAtlasRendering::draw_tile(RID p_canvas_item, Vector2i p_position, const Ref<TileSet> p_tile_set, int p_atlas_source_id, Vector2i p_atlas_coords, int p_alternative_tile, Color p_modulation) {
+	TileMapQuadrant::RenderingTile tile;
+	if (!_get_atlas_tile_rendering(tile, p_position, p_tile_set, p_atlas_source_id, p_atlas_coords, p_alternative_tile, p_modulation)) {
+		return;
+	}
+
+	// Draw the tile.
+	tile.texture->draw_rect_region(p_canvas_item, tile.dest_rect, tile.source_rect, tile.modulate, tile.transpose, p_tile_set->is_uv_clipping());
+}
+
+void TileSetPluginAtlasRendering::prepare_dirty_quadrant(TileMap *p_tile_map, TileMapQuadrant *p_quadrant) {
+	Ref<TileSet> tile_set = p_tile_map->get_tileset();
+	ERR_FAIL_COND(!tile_set.is_valid());
+
+	TileMapQuadrant &q = *p_quadrant;
+	q.rendering_groups.clear();
+	q.rendering_occluders.clear();
+
+	// Quandrant pos.
+	const Vector2 quadrant_position = p_tile_map->map_to_world(q.coords * p_tile_map->get_effective_quadrant_size());
+	const Color self_modulate = p_tile_map->get_self_modulate();
+
+	// Iterate over the cells of the quadrant.
+	for (uint32_t cell_index = 0; cell_index < q.cells.size(); cell_index++) {
+		const Vector2 cell_world_coords = p_tile_map->map_to_world(q.cells[cell_index]);
+		TileMapCell c = p_tile_map->get_cell(q.cells[cell_index]);
+
+		if (!tile_set->has_source(c.source_id)) {
+			continue;
+		}
+		TileSetSource *source = *tile_set->get_source(c.source_id);
+		if (!source->has_tile(c.get_atlas_coords()) || !source->has_alternative_tile(c.get_atlas_coords(), c.alternative_tile)) {
+			continue;
 		}
 
-		if (tile_data->get_flip_h()) {
-			dest_rect.size.x = -dest_rect.size.x;
+		TileSetAtlasSource *atlas_source = Object::cast_to<TileSetAtlasSource>(source);
+		if (!atlas_source) {
+			continue;
 		}
 
-		if (tile_data->get_flip_v()) {
-			dest_rect.size.y = -dest_rect.size.y;
+		// Get the tile data.
+		TileData *tile_data = Object::cast_to<TileData>(atlas_source->get_tile_data(c.get_atlas_coords(), c.alternative_tile));
+		Ref<ShaderMaterial> mat = tile_data->tile_get_material();
+		int z_index = tile_data->get_z_index();
+
+		// Cells sharing their material and z_index are grouped in the same CanvasItem.
+		if (q.rendering_groups.is_empty() || q.rendering_groups[q.rendering_groups.size() - 1].material != mat || q.rendering_groups[q.rendering_groups.size() - 1].z_index != z_index) {
+			TileMapQuadrant::RenderingGroup group;
+			group.material = mat;
+			group.z_index = z_index;
+			group.position = quadrant_position;
+			if (tile_set->is_y_sorting()) {
+				// When Y-sorting, the quandrant size is sure to be 1, we can thus offset the CanvasItem.
+				group.position.y += tile_data->get_y_sort_origin();
+			}
+			q.rendering_groups.push_back(group);
 		}
+		TileMapQuadrant::RenderingGroup &group = q.rendering_groups[q.rendering_groups.size() - 1];
 
-		// Get the tile modulation.
-		Color modulate = tile_data->get_modulate();
-		modulate = Color(modulate.r * p_modulation.r, modulate.g * p_modulation.g, modulate.b * p_modulation.b, modulate.a * p_modulation.a);
+		TileMapQuadrant::RenderingTile tile;
+		if (_get_atlas_tile_rendering(tile, cell_world_coords - group.position, tile_set, c.source_id, c.get_atlas_coords(), c.alternative_tile, self_modulate)) {
+			group.tiles.push_back(tile);
+		}
 
-		// Draw the tile.
-		tex->draw_rect_region(p_canvas_item, dest_rect, source_rect, modulate, transpose, p_tile_set->is_uv_clipping());
+		// --- Occluders ---
+		for (int i = 0; i < tile_set->get_occlusion_layers_count(); i++) {
+			if (tile_data->get_occluder(i).is_valid()) {
+				TileMapQuadrant::RenderingOccluder occluder;
+				occluder.xform.set_origin(cell_world_coords);
+				occluder.polygon = tile_data->get_occluder(i);
+				occluder.light_mask = tile_set->get_occlusion_layer_light_mask(i);
+				q.rendering_occluders.push_back(occluder);
+			}
+		}
 	}
 }
 
@@ -3893,13 +3980,14 @@ void TileSetPluginAtlasRendering::update_dirty_quadrants(TileMap *p_tile_map, Se
 	ERR_FAIL_COND(!tile_set.is_valid());
 
 	bool visible = p_tile_map->is_visible_in_tree();
+	bool uv_clipping = tile_set->is_uv_clipping();
+	Transform2D global_transform = p_tile_map->get_global_transform();
+	RenderingServer *rs = RenderingServer::get_singleton();
 
 	SelfList<TileMapQuadrant> *q_list_element = r_dirty_quadrant_list.first();
 	while (q_list_element) {
 		TileMapQuadrant &q = *q_list_element->self();
 
-		RenderingServer *rs = RenderingServer::get_singleton();
-
 		// Free the canvas items.
 		for (List<RID>::Element *E = q.canvas_items.front(); E; E = E->next()) {
 			rs->free(E->get());
@@ -3912,93 +4000,53 @@ void TileSetPluginAtlasRendering::update_dirty_quadrants(TileMap *p_tile_map, Se
 		}
 		q.occluders.clear();
 
-		// Those allow to group cell per material or z-index.
-		Ref<ShaderMaterial> prev_material;
-		int prev_z_index = 0;
-		RID prev_canvas_item;
-
-		// Iterate over the cells of the quadrant.
-		for (Map<Vector2i, Vector2i, TileMapQuadrant::CoordsWorldComparator>::Element *E_cell = q.world_to_map.front(); E_cell; E_cell = E_cell->next()) {
-			TileMapCell c = p_tile_map->get_cell(E_cell->value());
-
-			TileSetSource *source;
-			if (tile_set->has_source(c.source_id)) {
-				source = *tile_set->get_source(c.source_id);
-
-				if (!source->has_tile(c.get_atlas_coords()) || !source->has_alternative_tile(c.get_atlas_coords(), c.alternative_tile)) {
-					continue;
-				}
+		// --- CanvasItems ---
+		// One per group of cells sharing their material and z_index.
+		for (uint32_t group_index = 0; group_index < q.rendering_groups.size(); group_index++) {
+			const TileMapQuadrant::RenderingGroup &group = q.rendering_groups[group_index];
 
-				TileSetAtlasSource *atlas_source = Object::cast_to<TileSetAtlasSource>(source);
-				if (atlas_source) {
-					// Get the tile data.
-					TileData *tile_data = Object::cast_to<TileData>(atlas_source->get_tile_data(c.get_atlas_coords(), c.alternative_tile));
-					Ref<ShaderMaterial> mat = tile_data->tile_get_material();
-					int z_index = tile_data->get_z_index();
-
-					// Quandrant pos.
-					Vector2 position = p_tile_map->map_to_world(q.coords * p_tile_map->get_effective_quadrant_size());
-					if (tile_set->is_y_sorting()) {
-						// When Y-sorting, the quandrant size is sure to be 1, we can thus offset the CanvasItem.
-						position.y += tile_data->get_y_sort_origin();
-					}
-
-					// --- CanvasItems ---
-					// Create two canvas items, for rendering and debug.
-					RID canvas_item;
-
-					// Check if the material or the z_index changed.
-					if (prev_canvas_item == RID() || prev_material != mat || prev_z_index != z_index) {
-						// If so, create a new CanvasItem.
-						canvas_item = rs->canvas_item_create();
-						if (mat.is_valid()) {
-							rs->canvas_item_set_material(canvas_item, mat->get_rid());
-						}
-						rs->canvas_item_set_parent(canvas_item, p_tile_map->get_canvas_item());
-						rs->canvas_item_set_use_parent_material(canvas_item, p_tile_map->get_use_parent_material() || p_tile_map->get_material().is_valid());
-
-						Transform2D xform;
-						xform.set_origin(position);
-						rs->canvas_item_set_transform(canvas_item, xform);
-
-						rs->canvas_item_set_light_mask(canvas_item, p_tile_map->get_light_mask());
-						rs->canvas_item_set_z_index(canvas_item, z_index);
+			RID canvas_item = rs->canvas_item_create();
+			if (group.material.is_valid()) {
+				rs->canvas_item_set_material(canvas_item, group.material->get_rid());
+			}
+			rs->canvas_item_set_parent(canvas_item, p_tile_map->get_canvas_item());
+			rs->canvas_item_set_use_parent_material(canvas_item, p_tile_map->get_use_parent_material() || p_tile_map->get_material().is_valid());
 
-						rs->canvas_item_set_default_texture_filter(canvas_item, RS::CanvasItemTextureFilter(p_tile_map->CanvasItem::get_texture_filter()));
-						rs->canvas_item_set_default_texture_repeat(canvas_item, RS::CanvasItemTextureRepeat(p_tile_map->CanvasItem::get_texture_repeat()));
+			Transform2D xform;
+			xform.set_origin(group.position);
+			rs->canvas_item_set_transform(canvas_item, xform);
 
-						q.canvas_items.push_back(canvas_item);
+			rs->canvas_item_set_light_mask(canvas_item, p_tile_map->get_light_mask());
+			rs->canvas_item_set_z_index(canvas_item, group.z_index);
 
-						prev_canvas_item = canvas_item;
-						prev_material = mat;
-						prev_z_index = z_index;
+			rs->canvas_item_set_default_texture_filter(canvas_item, RS::CanvasItemTextureFilter(p_tile_map->CanvasItem::get_texture_filter()));
+			rs->canvas_item_set_default_texture_repeat(canvas_item, RS::CanvasItemTextureRepeat(p_tile_map->CanvasItem::get_texture_repeat()));
 
-					} else {
-						// Keep the same canvas_item to draw on.
-						canvas_item = prev_canvas_item;
-					}
+			q.canvas_items.push_back(canvas_item);
 
-					// Drawing the tile in the canvas item.
-					draw_tile(canvas_item, E_cell->key() - position, tile_set, c.source_id, c.get_atlas_coords(), c.alternative_tile, p_tile_map->get_self_modulate());
-
-					// --- Occluders ---
-					for (int i = 0; i < tile_set->get_occlusion_layers_count(); i++) {
-						Transform2D xform;
-						xform.set_origin(E_cell->key());
-						if (tile_data->get_occluder(i).is_valid()) {
-							RID occluder_id = rs->canvas_light_occluder_create();
-							rs->canvas_light_occluder_set_enabled(occluder_id, visible);
-							rs->canvas_light_occluder_set_transform(occluder_id, p_tile_map->get_global_transform() * xform);
-							rs->canvas_light_occluder_set_polygon(occluder_id, tile_data->get_occluder(i)->get_rid());
-							rs->canvas_light_occluder_attach_to_canvas(occluder_id, p_tile_map->get_canvas());
-							rs->canvas_light_occluder_set_light_mask(occluder_id, tile_set->get_occlusion_layer_light_mask(i));
-							q.occluders.push_back(occluder_id);
-						}
-					}
-				}
+			// Drawing the tiles in the canvas item.
+			for (uint32_t tile_index = 0; tile_index < group.tiles.size(); tile_index++) {
+				const TileMapQuadrant::RenderingTile &tile = group.tiles[tile_index];
+				tile.texture->draw_rect_region(canvas_item, tile.dest_rect, tile.source_rect, tile.modulate, tile.transpose, uv_clipping);
 			}
 		}
 
+		// --- Occluders ---
+		for (uint32_t occluder_index = 0; occluder_index < q.rendering_occluders.size(); occluder_index++) {
+			const TileMapQuadrant::RenderingOccluder &occluder = q.rendering_occluders[occluder_index];
+			RID occluder_id = rs->canvas_light_occluder_create();
+			rs->canvas_light_occluder_set_enabled(occluder_id, visible);
+			rs->canvas_light_occluder_set_transform(occluder_id, global_transform * occluder.xform);
+			rs->canvas_light_occluder_set_polygon(occluder_id, occluder.polygon->get_rid());
+			rs->canvas_light_occluder_attach_to_canvas(occluder_id, p_tile_map->get_canvas());
+			rs->canvas_light_occluder_set_light_mask(occluder_id, occluder.light_mask);
+			q.occluders.push_back(occluder_id);
+		}
+
+		// The servers hold what they need now, don't keep the textures and materials referenced.
+		q.rendering_groups.reset();
+		q.rendering_occluders.reset();
+
 		quadrant_order_dirty = true;
 		q_list_element = q_list_element->next();
 	}
@@ -4009,9 +4057,9 @@ void TileSetPluginAtlasRendering::update_dirty_quadrants(TileMap *p_tile_map, Se
 
 		// Sort the quadrants coords per world coordinates
 		Map<Vector2i, Vector2i, TileMapQuadrant::CoordsWorldComparator> world_to_map;
-		Map<Vector2i, TileMapQuadrant> quadrant_map = p_tile_map->get_quadrant_map();
-		for (Map<Vector2i, TileMapQuadrant>::Element *E = quadrant_map.front(); E; E = E->next()) {
-			world_to_map[p_tile_map->map_to_world(E->key())] = E->key();
+		HashMap<Vector2i, TileMapQuadrant, TileMapQuadrant::CoordsHasher> &quadrant_map = p_tile_map->get_quadrant_map();
+		for (const Vector2i *E = quadrant_map.next(nullptr); E; E = quadrant_map.next(E)) {
+			world_to_map[p_tile_map->map_to_world(*E)] = *E;
 		}
 
 		// Sort the quadrants
@@ -4058,8 +4106,9 @@ void TileSetPluginAtlasRendering::draw_quadrant_debug(TileMap *p_tile_map, TileM
 	// Draw a placeholder for scenes needing one.
 	RenderingServer *rs = RenderingServer::get_singleton();
 	Vector2 quadrant_pos = p_tile_map->map_to_world(p_quadrant->coords * p_tile_map->get_effective_quadrant_size());
-	for (Set<Vector2i>::Element *E_cell = p_quadrant->cells.front(); E_cell; E_cell = E_cell->next()) {
-		const TileMapCell &c = p_tile_map->get_cell(E_cell->get());
+	for (uint32_t cell_index = 0; cell_index < p_quadrant->cells.size(); cell_index++) {
+		const Vector2i &cell_coords = p_quadrant->cells[cell_index];
+		const TileMapCell &c = p_tile_map->get_cell(cell_coords);
 
 		TileSetSource *source;
 		if (tile_set->has_source(c.source_id)) {
@@ -4089,7 +4138,7 @@ void TileSetPluginAtlasRendering::draw_quadrant_debug(TileMap *p_tile_map, TileM
 
 					// Draw a placeholder tile.
 					Transform2D xform;
-					xform.set_origin(p_tile_map->map_to_world(E_cell->get()) - quadrant_pos);
+					xform.set_origin(p_tile_map->map_to_world(cell_coords) - quadrant_pos);
 					rs->canvas_item_add_set_transform(p_quadrant->debug_canvas_item, xform);
 					rs->canvas_item_add_circle(p_quadrant->debug_canvas_item, Vector2(), MIN(tile_set->get_tile_size().x, tile_set->get_tile_size().y) / 4.0, color);
 				}
@@ -4105,14 +4154,14 @@ void TileSetPluginAtlasPhysics::tilemap_notification(TileMap *p_tile_map, int p_
 		case CanvasItem::NOTIFICATION_TRANSFORM_CHANGED: {
 			// Update the bodies transforms.
 			if (p_tile_map->is_inside_tree()) {
-				Map<Vector2i, TileMapQuadrant> quadrant_map = p_tile_map->get_quadrant_map();
+				HashMap<Vector2i, TileMapQuadrant, TileMapQuadrant::CoordsHasher> &quadrant_map = p_tile_map->get_quadrant_map();
 				Transform2D global_transform = p_tile_map->get_global_transform();
 
-				for (Map<Vector2i, TileMapQuadrant>::Element *E = quadrant_map.front(); E; E = E->next()) {
-					TileMapQuadrant &q = E->get();
+				for (const Vector2i *E = quadrant_map.next(nullptr); E; E = quadrant_map.next(E)) {
+					TileMapQuadrant &q = quadrant_map[*E];
 
 					Transform2D xform;
-					xform.set_origin(p_tile_map->map_to_world(E->key() * p_tile_map->get_effective_quadrant_size()));
+					xform.set_origin(p_tile_map->map_to_world(*E * p_tile_map->get_effective_quadrant_size()));
 					xform = global_transform * xform;
 
 					for (int body_index = 0; body_index < q.bodies.size(); body_index++) {
@@ -4124,6 +4173,56 @@ void TileSetPluginAtlasPhysics::tilemap_notification(TileMap *p_tile_map, int p_
 	}
 }
 
+void TileSetPluginAtlasPhysics::prepare_dirty_quadrant(TileMap *p_tile_map, TileMapQuadrant *p_quadrant) {
+	Ref<TileSet> tile_set = p_tile_map->get_tileset();
+	ERR_FAIL_COND(!tile_set.is_valid());
+
+	TileMapQuadrant &q = *p_quadrant;
+	q.physics_shapes.clear();
+
+	Vector2 quadrant_pos = p_tile_map->map_to_world(q.coords * p_tile_map->get_effective_quadrant_size());
+
+	for (uint32_t cell_index = 0; cell_index < q.cells.size(); cell_index++) {
+		const Vector2i &cell_coords = q.cells[cell_index];
+		TileMapCell c = p_tile_map->get_cell(cell_coords);
+
+		if (!tile_set->has_source(c.source_id)) {
+			continue;
+		}
+		TileSetSource *source = *tile_set->get_source(c.source_id);
+		if (!source->has_tile(c.get_atlas_coords()) || !source->has_alternative_tile(c.get_atlas_coords(), c.alternative_tile)) {
+			continue;
+		}
+
+		TileSetAtlasSource *atlas_source = Object::cast_to<TileSetAtlasSource>(source);
+		if (!atlas_source) {
+			continue;
+		}
+
+		TileData *tile_data = Object::cast_to<TileData>(atlas_source->get_tile_data(c.get_atlas_coords(), c.alternative_tile));
+
+		for (int body_index = 0; body_index < tile_set->get_physics_layers_count(); body_index++) {
+			for (int polygon_index = 0; polygon_index < tile_data->get_collision_polygons_count(body_index); polygon_index++) {
+				bool one_way_collision = tile_data->is_collision_polygon_one_way(body_index, polygon_index);
+				float one_way_collision_margin = tile_data->get_collision_polygon_one_way_margin(body_index, polygon_index);
+
+				int shapes_count = tile_data->get_collision_polygon_shapes_count(body_index, polygon_index);
+				for (int shape_index = 0; shape_index < shapes_count; shape_index++) {
+					TileMapQuadrant::PhysicsShape shape;
+					shape.body_index = body_index;
+					shape.shape_index = shape_index;
+					shape.shape = tile_data->get_collision_polygon_shape(body_index, polygon_index, shape_index);
+					shape.xform.set_origin(p_tile_map->map_to_world(cell_coords) - quadrant_pos);
+					shape.coords = cell_coords;
+					shape.one_way_collision = one_way_collision;
+					shape.one_way_collision_margin = one_way_collision_margin;
+					q.physics_shapes.push_back(shape);
+				}
+			}
+		}
+	}
+}
+
 void TileSetPluginAtlasPhysics::update_dirty_quadrants(TileMap *p_tile_map, SelfList<TileMapQuadrant>::List &r_dirty_quadrant_list) {
 	ERR_FAIL_COND(!p_tile_map);
 	ERR_FAIL_COND(!p_tile_map->is_inside_tree());
@@ -4150,43 +4249,18 @@ void TileSetPluginAtlasPhysics::update_dirty_quadrants(TileMap *p_tile_map, Self
 			ps->body_set_state(q.bodies[body_index], PhysicsServer2D::BODY_STATE_TRANSFORM, xform);
 		}
 
-		for (Set<Vector2i>::Element *E_cell = q.cells.front(); E_cell; E_cell = E_cell->next()) {
-			TileMapCell c = p_tile_map->get_cell(E_cell->get());
-
-			TileSetSource *source;
-			if (tile_set->has_source(c.source_id)) {
-				source = *tile_set->get_source(c.source_id);
-
-				if (!source->has_tile(c.get_atlas_coords()) || !source->has_alternative_tile(c.get_atlas_coords(), c.alternative_tile)) {
-					continue;
-				}
-
-				TileSetAtlasSource *atlas_source = Object::cast_to<TileSetAtlasSource>(source);
-				if (atlas_source) {
-					TileData *tile_data = Object::cast_to<TileData>(atlas_source->get_tile_data(c.get_atlas_coords(), c.alternative_tile));
-
-					for (int body_index = 0; body_index < q.bodies.size(); body_index++) {
-						// Add the shapes again.
-						for (int polygon_index = 0; polygon_index < tile_data->get_collision_polygons_count(body_index); polygon_index++) {
-							bool one_way_collision = tile_data->is_collision_polygon_one_way(body_index, polygon_index);
-							float one_way_collision_margin = tile_data->get_collision_polygon_one_way_margin(body_index, polygon_index);
-
-							int shapes_count = tile_data->get_collision_polygon_shapes_count(body_index, polygon_index);
-							for (int shape_index = 0; shape_index < shapes_count; shape_index++) {
-								Transform2D xform = Transform2D();
-								xform.set_origin(p_tile_map->map_to_world(E_cell->get()) - quadrant_pos);
-
-								// Add decomposed convex shapes.
-								Ref<ConvexPolygonShape2D> shape = tile_data->get_collision_polygon_shape(body_index, polygon_index, shape_index);
-								ps->body_add_shape(q.bodies[body_index], shape->get_rid(), xform);
-								ps->body_set_shape_metadata(q.bodies[body_index], shape_index, E_cell->get());
-								ps->body_set_shape_as_one_way_collision(q.bodies[body_index], shape_index, one_way_collision, one_way_collision_margin);
-							}
-						}
-					}
-				}
+		// Add the shapes again.
+		for (uint32_t i = 0; i < q.physics_shapes.size(); i++) {
+			const TileMapQuadrant::PhysicsShape &shape = q.physics_shapes[i];
+			if (shape.body_index >= q.bodies.size() || shape.shape.is_null()) {
+				continue;
 			}
+			RID body = q.bodies[shape.body_index];
+			ps->body_add_shape(body, shape.shape->get_rid(), shape.xform);
+			ps->body_set_shape_metadata(body, shape.shape_index, shape.coords);
+			ps->body_set_shape_as_one_way_collision(body, shape.shape_index, shape.one_way_collision, shape.one_way_collision_margin);
 		}
+		q.physics_shapes.reset();
 
 		q_list_element = q_list_element->next();
 	}
@@ -4275,11 +4349,12 @@ void TileSetPluginAtlasPhysics::draw_quadrant_debug(TileMap *p_tile_map, TileMap
 	Vector2 quadrant_pos = p_tile_map->map_to_world(p_quadrant->coords * p_tile_map->get_effective_quadrant_size());
 
 	Color debug_collision_color = p_tile_map->get_tree()->get_debug_collisions_color();
-	for (Set<Vector2i>::Element *E_cell = p_quadrant->cells.front(); E_cell; E_cell = E_cell->next()) {
-		TileMapCell c = p_tile_map->get_cell(E_cell->get());
+	for (uint32_t cell_index = 0; cell_index < p_quadrant->cells.size(); cell_index++) {
+		const Vector2i &cell_coords = p_quadrant->cells[cell_index];
+		TileMapCell c = p_tile_map->get_cell(cell_coords);
 
 		Transform2D xform;
-		xform.set_origin(p_tile_map->map_to_world(E_cell->get()) - quadrant_pos);
+		xform.set_origin(p_tile_map->map_to_world(cell_coords) - quadrant_pos);
 		rs->canvas_item_add_set_transform(p_quadrant->debug_canvas_item, xform);
 
 		if (tile_set->has_source(c.source_id)) {
@@ -4316,10 +4391,10 @@ void TileSetPluginAtlasNavigation::tilemap_notification(TileMap *p_tile_map, int
 	switch (p_what) {
 		case CanvasItem::NOTIFICATION_TRANSFORM_CHANGED: {
 			if (p_tile_map->is_inside_tree()) {
-				Map<Vector2i, TileMapQuadrant> quadrant_map = p_tile_map->get_quadrant_map();
+				HashMap<Vector2i, TileMapQuadrant, TileMapQuadrant::CoordsHasher> &quadrant_map = p_tile_map->get_quadrant_map();
 				Transform2D tilemap_xform = p_tile_map->get_global_transform();
-				for (Map<Vector2i, TileMapQuadrant>::Element *E_quadrant = quadrant_map.front(); E_quadrant; E_quadrant = E_quadrant->next()) {
-					TileMapQuadrant &q = E_quadrant->get();
+				for (const Vector2i *E_quadrant = quadrant_map.next(nullptr); E_quadrant; E_quadrant = quadrant_map.next(E_quadrant)) {
+					TileMapQuadrant &q = quadrant_map[*E_quadrant];
 					for (Map<Vector2i, Vector<RID>>::Element *E_region = q.navigation_regions.front(); E_region; E_region = E_region->next()) {
 						for (int layer_index = 0; layer_index < E_region->get().size(); layer_index++) {
 							RID region = E_region->get()[layer_index];
@@ -4337,21 +4412,52 @@ void TileSetPluginAtlasNavigation::tilemap_notification(TileMap *p_tile_map, int
 	}
 }
 
+void TileSetPluginAtlasNavigation::prepare_dirty_quadrant(TileMap *p_tile_map, TileMapQuadrant *p_quadrant) {
+	Ref<TileSet> tile_set = p_tile_map->get_tileset();
+	ERR_FAIL_COND(!tile_set.is_valid());
+
+	TileMapQuadrant &q = *p_quadrant;
+	q.navigation_cells.clear();
+
+	// Get the navigation polygons of the cells.
+	for (uint32_t cell_index = 0; cell_index < q.cells.size(); cell_index++) {
+		const Vector2i &cell_coords = q.cells[cell_index];
+		TileMapCell c = p_tile_map->get_cell(cell_coords);
+
+		if (!tile_set->has_source(c.source_id)) {
+			continue;
+		}
+		TileSetSource *source = *tile_set->get_source(c.source_id);
+		if (!source->has_tile(c.get_atlas_coords()) || !source->has_alternative_tile(c.get_atlas_coords(), c.alternative_tile)) {
+			continue;
+		}
+
+		TileSetAtlasSource *atlas_source = Object::cast_to<TileSetAtlasSource>(source);
+		if (!atlas_source) {
+			continue;
+		}
+
+		TileData *tile_data = Object::cast_to<TileData>(atlas_source->get_tile_data(c.get_atlas_coords(), c.alternative_tile));
+
+		TileMapQuadrant::NavigationCell cell;
+		cell.coords = cell_coords;
+		cell.xform.set_origin(p_tile_map->map_to_world(cell_coords));
+		cell.polygons.resize(tile_set->get_navigation_layers_count());
+		for (int layer_index = 0; layer_index < tile_set->get_navigation_layers_count(); layer_index++) {
+			cell.polygons.write[layer_index] = tile_data->get_navigation_polygon(layer_index);
+		}
+		q.navigation_cells.push_back(cell);
+	}
+}
+
 void TileSetPluginAtlasNavigation::update_dirty_quadrants(TileMap *p_tile_map, SelfList<TileMapQuadrant>::List &r_dirty_quadrant_list) {
 	ERR_FAIL_COND(!p_tile_map);
 	ERR_FAIL_COND(!p_tile_map->is_inside_tree());
 	Ref<TileSet> tile_set = p_tile_map->get_tileset();
 	ERR_FAIL_COND(!tile_set.is_valid());
 
-	// Get colors for debug.
-	SceneTree *st = SceneTree::get_singleton();
-	Color debug_navigation_color;
-	bool debug_navigation = st && st->is_debugging_navigation_hint();
-	if (debug_navigation) {
-		debug_navigation_color = st->get_debug_navigation_color();
-	}
-
 	Transform2D tilemap_xform = p_tile_map->get_global_transform();
+	RID navigation_map = p_tile_map->get_world_2d()->get_navigation_map();
 	SelfList<TileMapQuadrant> *q_list_element = r_dirty_quadrant_list.first();
 	while (q_list_element) {
 		TileMapQuadrant &q = *q_list_element->self();
@@ -4368,41 +4474,23 @@ void TileSetPluginAtlasNavigation::update_dirty_quadrants(TileMap *p_tile_map, S
 		}
 		q.navigation_regions.clear();
 
-		// Get the navigation polygons and create regions.
-		for (Set<Vector2i>::Element *E_cell = q.cells.front(); E_cell; E_cell = E_cell->next()) {
-			TileMapCell c = p_tile_map->get_cell(E_cell->get());
-
-			TileSetSource *source;
-			if (tile_set->has_source(c.source_id)) {
-				source = *tile_set->get_source(c.source_id);
-
-				if (!source->has_tile(c.get_atlas_coords()) || !source->has_alternative_tile(c.get_atlas_coords(), c.alternative_tile)) {
-					continue;
-				}
-
-				TileSetAtlasSource *atlas_source = Object::cast_to<TileSetAtlasSource>(source);
-				if (atlas_source) {
-					TileData *tile_data = Object::cast_to<TileData>(atlas_source->get_tile_data(c.get_atlas_coords(), c.alternative_tile));
-					q.navigation_regions[E_cell->get()].resize(tile_set->get_navigation_layers_count());
-
-					for (int layer_index = 0; layer_index < tile_set->get_navigation_layers_count(); layer_index++) {
-						Ref<NavigationPolygon> navpoly;
-						navpoly = tile_data->get_navigation_polygon(layer_index);
-
-						if (navpoly.is_valid()) {
-							Transform2D tile_transform;
-							tile_transform.set_origin(p_tile_map->map_to_world(E_cell->get()));
-
-							RID region = NavigationServer2D::get_singleton()->region_create();
-							NavigationServer2D::get_singleton()->region_set_map(region, p_tile_map->get_world_2d()->get_navigation_map());
-							NavigationServer2D::get_singleton()->region_set_transform(region, tilemap_xform * tile_transform);
-							NavigationServer2D::get_singleton()->region_set_navpoly(region, navpoly);
-							q.navigation_regions[E_cell->get()].write[layer_index] = region;
-						}
-					}
+		// Create the regions.
+		for (uint32_t cell_index = 0; cell_index < q.navigation_cells.size(); cell_index++) {
+			const TileMapQuadrant::NavigationCell &cell = q.navigation_cells[cell_index];
+			Vector<RID> &regions = q.navigation_regions[cell.coords];
+			regions.resize(cell.polygons.size());
+
+			for (int layer_index = 0; layer_index < cell.polygons.size(); layer_index++) {
+				if (cell.polygons[layer_index].is_valid()) {
+					RID region = NavigationServer2D::get_singleton()->region_create();
+					NavigationServer2D::get_singleton()->region_set_map(region, navigation_map);
+					NavigationServer2D::get_singleton()->region_set_transform(region, tilemap_xform * cell.xform);
+					NavigationServer2D::get_singleton()->region_set_navpoly(region, cell.polygons[layer_index]);
+					regions.write[layer_index] = region;
 				}
 			}
 		}
+		q.navigation_cells.reset();
 
 		q_list_element = q_list_element->next();
 	}
@@ -4454,8 +4542,9 @@ void TileSetPluginAtlasNavigation::draw_quadrant_debug(TileMap *p_tile_map, Tile
 
 	Vector2 quadrant_pos = p_tile_map->map_to_world(p_quadrant->coords * p_tile_map->get_effective_quadrant_size());
 
-	for (Set<Vector2i>::Element *E_cell = p_quadrant->cells.front(); E_cell; E_cell = E_cell->next()) {
-		TileMapCell c = p_tile_map->get_cell(E_cell->get());
+	for (uint32_t cell_index = 0; cell_index < p_quadrant->cells.size(); cell_index++) {
+		const Vector2i &cell_coords = p_quadrant->cells[cell_index];
+		TileMapCell c = p_tile_map->get_cell(cell_coords);
 
 		TileSetSource *source;
 		if (tile_set->has_source(c.source_id)) {
@@ -4470,7 +4559,7 @@ void TileSetPluginAtlasNavigation::draw_quadrant_debug(TileMap *p_tile_map, Tile
 				TileData *tile_data = Object::cast_to<TileData>(atlas_source->get_tile_data(c.get_atlas_coords(), c.alternative_tile));
 
 				Transform2D xform;
-				xform.set_origin(p_tile_map->map_to_world(E_cell->get()) - quadrant_pos);
+				xform.set_origin(p_tile_map->map_to_world(cell_coords) - quadrant_pos);
 				rs->canvas_item_add_set_transform(p_quadrant->debug_canvas_item, xform);
 
 				for (int layer_index = 0; layer_index < tile_set->get_navigation_layers_count(); layer_index++) {
@@ -4525,8 +4614,9 @@ void TileSetPluginScenesCollections::update_dirty_quadrants(TileMap *p_tile_map,
 		q.scenes.clear();
 
 		// Recreate the scenes.
-		for (Set<Vector2i>::Element *E_cell = q.cells.front(); E_cell; E_cell = E_cell->next()) {
-			const TileMapCell &c = p_tile_map->get_cell(E_cell->get());
+		for (uint32_t cell_index = 0; cell_index < q.cells.size(); cell_index++) {
+			const Vector2i &cell_coords = q.cells[cell_index];
+			const TileMapCell &c = p_tile_map->get_cell(cell_coords);
 
 			TileSetSource *source;
 			if (tile_set->has_source(c.source_id)) {
@@ -4545,13 +4635,13 @@ void TileSetPluginScenesCollections::update_dirty_quadrants(TileMap *p_tile_map,
 						Control *scene_as_control = Object::cast_to<Control>(scene);
 						Node2D *scene_as_node2d = Object::cast_to<Node2D>(scene);
 						if (scene_as_control) {
-							scene_as_control->set_position(p_tile_map->map_to_world(E_cell->get()) + scene_as_control->get_position());
+							scene_as_control->set_position(p_tile_map->map_to_world(cell_coords) + scene_as_control->get_position());
 						} else if (scene_as_node2d) {
 							Transform2D xform;
-							xform.set_origin(p_tile_map->map_to_world(E_cell->get()));
+							xform.set_origin(p_tile_map->map_to_world(cell_coords));
 							scene_as_node2d->set_transform(xform * scene_as_node2d->get_transform());
 						}
-						q.scenes[E_cell->get()] = scene->get_name();
+						q.scenes[cell_coords] = scene->get_name();
 					}
 				}
 			}
@@ -4584,8 +4674,9 @@ void TileSetPluginScenesCollections::draw_quadrant_debug(TileMap *p_tile_map, Ti
 	// Draw a placeholder for scenes needing one.
 	RenderingServer *rs = RenderingServer::get_singleton();
 	Vector2 quadrant_pos = p_tile_map->map_to_world(p_quadrant->coords * p_tile_map->get_effective_quadrant_size());
-	for (Set<Vector2i>::Element *E_cell = p_quadrant->cells.front(); E_cell; E_cell = E_cell->next()) {
-		const TileMapCell &c = p_tile_map->get_cell(E_cell->get());
+	for (uint32_t cell_index = 0; cell_index < p_quadrant->cells.size(); cell_index++) {
+		const Vector2i &cell_coords = p_quadrant->cells[cell_index];
+		const TileMapCell &c = p_tile_map->get_cell(cell_coords);
 
 		TileSetSource *source;
 		if (tile_set->has_source(c.source_id)) {
@@ -4613,7 +4704,7 @@ void TileSetPluginScenesCollections::draw_quadrant_debug(TileMap *p_tile_map, Ti
 
 					// Draw a placeholder tile.
 					Transform2D xform;
-					xform.set_origin(p_tile_map->map_to_world(E_cell->get()) - quadrant_pos);
+					xform.set_origin(p_tile_map->map_to_world(cell_coords) - quadrant_pos);
 					rs->canvas_item_add_set_transform(p_quadrant->debug_canvas_item, xform);
 					rs->canvas_item_add_circle(p_quadrant->debug_canvas_item, Vector2(), MIN(tile_set->get_tile_size().x, tile_set->get_tile_size().y) / 4.0, color);
 				}
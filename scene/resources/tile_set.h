@@ -639,6 +639,7 @@ class TileSetPlugin : public Object {
 public:
 	// Tilemap updates.
 	virtual void tilemap_notification(TileMap *p_tile_map, int p_what){};
+	virtual void prepare_dirty_quadrant(TileMap *p_tile_map, TileMapQuadrant *p_quadrant){}; // Can run on a worker thread, must not talk to the servers.
 	virtual void update_dirty_quadrants(TileMap *p_tile_map, SelfList<TileMapQuadrant>::List &r_dirty_quadrant_list){};
 	virtual void create_quadrant(TileMap *p_tile_map, TileMapQuadrant *p_quadrant){};
 	virtual void cleanup_quadrant(TileMap *p_tile_map, TileMapQuadrant *p_quadrant){};
@@ -650,12 +651,12 @@ class TileSetPluginAtlasRendering : public TileSetPlugin {
 	GDCLASS(TileSetPluginAtlasRendering, TileSetPlugin);
 
 private:
-	static constexpr float fp_adjust = 0.00001;
 	bool quadrant_order_dirty = false;
 
 public:
 	// Tilemap updates
 	virtual void tilemap_notification(TileMap *p_tile_map, int p_what) override;
+	virtual void prepare_dirty_quadrant(TileMap *p_tile_map, TileMapQuadrant *p_quadrant) override;
 	virtual void update_dirty_quadrants(TileMap *p_tile_map, SelfList<TileMapQuadrant>::List &r_dirty_quadrant_list) override;
 	virtual void create_quadrant(TileMap *p_tile_map, TileMapQuadrant *p_quadrant) override;
 	virtual void cleanup_quadrant(TileMap *p_tile_map, TileMapQuadrant *p_quadrant) override;
@@ -671,6 +672,7 @@ class TileSetPluginAtlasPhysics : public TileSetPlugin {
 public:
 	// Tilemap updates
 	virtual void tilemap_notification(TileMap *p_tile_map, int p_what) override;
+	virtual void prepare_dirty_quadrant(TileMap *p_tile_map, TileMapQuadrant *p_quadrant) override;
 	virtual void update_dirty_quadrants(TileMap *p_tile_map, SelfList<TileMapQuadrant>::List &r_dirty_quadrant_list) override;
 	virtual void create_quadrant(TileMap *p_tile_map, TileMapQuadrant *p_quadrant) override;
 	virtual void cleanup_quadrant(TileMap *p_tile_map, TileMapQuadrant *p_quadrant) override;
@@ -683,6 +685,7 @@ class TileSetPluginAtlasNavigation : public TileSetPlugin {
 public:
 	// Tilemap updates
 	virtual void tilemap_notification(TileMap *p_tile_map, int p_what) override;
+	virtual void prepare_dirty_quadrant(TileMap *p_tile_map, TileMapQuadrant *p_quadrant) override;
 	virtual void update_dirty_quadrants(TileMap *p_tile_map, SelfList<TileMapQuadrant>::List &r_dirty_quadrant_list) override;
 	virtual void cleanup_quadrant(TileMap *p_tile_map, TileMapQuadrant *p_quadrant) override;
 	virtual void draw_quadrant_debug(TileMap *p_tile_map, TileMapQuadrant *p_quadrant) override;
@@ -33,6 +33,8 @@
 #include "core/config/project_settings.h"
 #include "core/os/os.h"
 
+AudioDriverDummy *AudioDriverDummy::singleton = nullptr;
+
 Error AudioDriverDummy::init() {
 	active = false;
 	thread_exited = false;
@@ -48,7 +50,9 @@ Error AudioDriverDummy::init() {
 
 	samples_in = memnew_arr(int32_t, buffer_frames * channels);
 
-	thread.start(AudioDriverDummy::thread_func, this);
+	if (use_threads) {
+		thread.start(AudioDriverDummy::thread_func, this);
+	}
 
 	return OK;
 };
@@ -93,11 +97,42 @@ void AudioDriverDummy::unlock() {
 	mutex.unlock();
 };
 
+void AudioDriverDummy::set_use_threads(bool p_use_threads) {
+	use_threads = p_use_threads;
+}
+
+void AudioDriverDummy::mix_audio(int p_frames, int32_t *p_buffer) {
+	ERR_FAIL_COND(!active); // If not active, should not mix.
+	ERR_FAIL_COND(use_threads); // The thread is already mixing.
+
+	int todo = p_frames;
+	while (todo) {
+		int to_mix = MIN((int)buffer_frames, todo);
+
+		lock();
+		audio_server_process(to_mix, samples_in);
+		unlock();
+
+		int total_samples = to_mix * channels;
+		for (int i = 0; i < total_samples; i++) {
+			p_buffer[i] = samples_in[i];
+		}
+
+		todo -= to_mix;
+		p_buffer += total_samples;
+	}
+}
+
 void AudioDriverDummy::finish() {
 	exit_thread = true;
 	thread.wait_to_finish();
 
 	if (samples_in) {
 		memdelete_arr(samples_in);
+		samples_in = nullptr;
 	};
 };
+
+AudioDriverDummy::AudioDriverDummy() {
+	singleton = this;
+}
@@ -54,6 +54,10 @@ class AudioDriverDummy : public AudioDriver {
 	bool thread_exited;
 	mutable bool exit_thread;
 
+	bool use_threads = true;
+
+	static AudioDriverDummy *singleton;
+
 public:
 	const char *get_name() const {
 		return "Dummy";
@@ -67,7 +71,14 @@ public:
 	virtual void unlock();
 	virtual void finish();
 
-	AudioDriverDummy() {}
+	// Without a thread, audio is only mixed when calling mix_audio(). Used to mix
+	// audio faster than real time in tests and benchmarks.
+	void set_use_threads(bool p_use_threads);
+	void mix_audio(int p_frames, int32_t *p_buffer);
+
+	static AudioDriverDummy *get_dummy_singleton() { return singleton; }
+
+	AudioDriverDummy();
 	~AudioDriverDummy() {}
 };
 
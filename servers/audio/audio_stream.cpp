@@ -35,6 +35,10 @@
 
 //////////////////////////////
 
+void AudioStreamPlayback::skip(float p_time) {
+	seek(get_playback_position() + p_time);
+}
+
 void AudioStreamPlaybackResampled::_begin_resample() {
 	//clear cubic interpolation history
 	internal_buffer[0] = AudioFrame(0.0, 0.0);
@@ -92,6 +96,224 @@ void AudioStreamPlaybackResampled::mix(AudioFrame *p_buffer, float p_rate_scale,
 
 ////////////////////////////////
 
+void AudioStreamPlaybackStreamed::_request_fill() {
+	if (decoder_thread && !fill_requested.is_set()) {
+		fill_requested.set();
+		AudioServer::get_singleton()->stream_decoder_wake();
+	}
+}
+
+bool AudioStreamPlaybackStreamed::_fill_stream_buffer() {
+	fill_requested.clear();
+
+	uint32_t generation = seek_generation.get();
+	if (generation != decoder_generation) {
+		decoder_generation = generation;
+		decoder_position = seek_position.get();
+		decoder_looped = false;
+		decoder_ended = false;
+		_decoder_seek(decoder_position);
+	}
+
+	int filled = 0;
+	while (!decoder_ended) {
+		uint32_t write = chunk_write.get();
+		if (write - chunk_read.get() >= chunk_count) {
+			break;
+		}
+
+		Chunk &chunk = chunks[write & (chunk_count - 1)];
+		chunk.generation = generation;
+		chunk.position = decoder_position;
+		chunk.looped = decoder_looped;
+		chunk.ended = false;
+		chunk.frame_count = _decode(chunk.frames, STREAM_CHUNK_FRAMES);
+
+		decoder_position += chunk.frame_count;
+		decoder_looped = false;
+
+		if (chunk.frame_count < STREAM_CHUNK_FRAMES) {
+			// End of the stream, chunks never span a loop so positions stay contiguous.
+			// Nothing decoded right after looping means there is nothing to loop.
+			bool is_not_empty = chunk.frame_count > 0 || !chunk.looped;
+			if (_has_loop() && is_not_empty) {
+				float loop_offset = _get_loop_offset();
+				decoder_position = loop_offset < _get_length() ? uint32_t(sampling_rate * loop_offset) : 0;
+				decoder_looped = true;
+				_decoder_seek(decoder_position);
+			} else {
+				chunk.ended = true;
+				decoder_ended = true;
+			}
+		}
+
+		chunk_write.set(write + 1);
+		filled++;
+	}
+
+	return filled > 0;
+}
+
+void AudioStreamPlaybackStreamed::_mix_internal(AudioFrame *p_buffer, int p_frames) {
+	ERR_FAIL_COND(!active);
+
+	uint32_t generation = seek_generation.get();
+	int mixed = 0;
+
+	while (mixed < p_frames && active) {
+		uint32_t read = chunk_read.get();
+		if (read == chunk_write.get()) {
+			if (!streaming && _fill_stream_buffer()) {
+				continue;
+			}
+			// Underrun, the decoder thread is behind; the rest is silence.
+			_request_fill();
+			break;
+		}
+
+		const Chunk &chunk = chunks[read & (chunk_count - 1)];
+		if (chunk.generation != generation) {
+			chunk_read.set(read + 1); // Decoded before the last seek.
+			chunk_offset = 0;
+			continue;
+		}
+
+		if (chunk_offset == 0) {
+			position = chunk.position;
+			if (chunk.looped) {
+				loops++;
+			}
+		}
+
+		int count = MIN(chunk.frame_count - chunk_offset, p_frames - mixed);
+		memcpy(p_buffer + mixed, chunk.frames + chunk_offset, count * sizeof(AudioFrame));
+		mixed += count;
+		chunk_offset += count;
+		position += count;
+
+		if (chunk_offset == chunk.frame_count) {
+			if (chunk.ended) {
+				active = false;
+				ended = true;
+			}
+			chunk_offset = 0;
+			chunk_read.set(read + 1);
+
+			if (chunk_write.get() - (read + 1) <= chunk_count / 2) {
+				_request_fill();
+			}
+		}
+	}
+
+	for (int i = mixed; i < p_frames; i++) {
+		p_buffer[i] = AudioFrame(0, 0);
+	}
+}
+
+void AudioStreamPlaybackStreamed::_stream_begin(bool p_streaming) {
+	ERR_FAIL_COND(chunks != nullptr);
+
+	streaming = p_streaming;
+	chunk_count = streaming ? STREAM_BUFFER_CHUNKS : MIX_BUFFER_CHUNKS;
+	chunks = memnew_arr(Chunk, chunk_count);
+	sampling_rate = get_stream_sampling_rate();
+
+	// The decoder starts at the beginning, so starting from there needs no seek
+	// and can use the chunks decoded ahead of time.
+	if (streaming && AudioServer::get_singleton()) {
+		decoder_thread = AudioServer::get_singleton()->stream_decoder_add(this);
+		// Without the thread, decode while mixing; the buffer is just larger than needed.
+		streaming = decoder_thread;
+		_request_fill();
+	}
+}
+
+void AudioStreamPlaybackStreamed::_stream_end() {
+	if (decoder_thread) {
+		AudioServer::get_singleton()->stream_decoder_remove(this);
+		decoder_thread = false;
+	}
+	streaming = false;
+}
+
+void AudioStreamPlaybackStreamed::start(float p_from_pos) {
+	active = true;
+	seek(p_from_pos);
+	loops = 0;
+	_begin_resample();
+}
+
+void AudioStreamPlaybackStreamed::stop() {
+	active = false;
+}
+
+bool AudioStreamPlaybackStreamed::is_playing() const {
+	return active;
+}
+
+int AudioStreamPlaybackStreamed::get_loop_count() const {
+	return loops;
+}
+
+float AudioStreamPlaybackStreamed::get_playback_position() const {
+	return float(position) / sampling_rate;
+}
+
+void AudioStreamPlaybackStreamed::seek(float p_time) {
+	if (!active) {
+		return;
+	}
+
+	if (p_time >= _get_length()) {
+		p_time = 0;
+	}
+
+	uint32_t frame = uint32_t(sampling_rate * p_time);
+	if (frame == position && !ended) {
+		return; // Already there, keep what was decoded ahead.
+	}
+
+	position = frame;
+	ended = false;
+	chunk_offset = 0;
+	seek_position.set(frame);
+	seek_generation.increment();
+	_request_fill();
+}
+
+void AudioStreamPlaybackStreamed::skip(float p_time) {
+	if (!active) {
+		return;
+	}
+
+	float length = _get_length();
+	float loop_offset = _get_loop_offset();
+	float pos = get_playback_position() + p_time;
+
+	if (pos >= length) {
+		float loop_length = length - loop_offset;
+		if (!_has_loop() || loop_length <= 0) {
+			active = false;
+			return;
+		}
+
+		float looped = pos - loop_offset;
+		loops += int(looped / loop_length);
+		pos = loop_offset + Math::fmod(looped, loop_length);
+	}
+
+	seek(pos);
+}
+
+AudioStreamPlaybackStreamed::~AudioStreamPlaybackStreamed() {
+	_stream_end();
+	if (chunks) {
+		memdelete_arr(chunks);
+	}
+}
+
+////////////////////////////////
+
 void AudioStream::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_length"), &AudioStream::get_length);
 }
@@ -48,6 +48,7 @@ public:
 
 	virtual float get_playback_position() const = 0;
 	virtual void seek(float p_time) = 0;
+	virtual void skip(float p_time); // Advances without mixing, used by virtual voices.
 
 	virtual void mix(AudioFrame *p_buffer, float p_rate_scale, int p_frames) = 0;
 };
@@ -77,6 +78,96 @@ public:
 	AudioStreamPlaybackResampled() { mix_offset = 0; }
 };
 
+// Base for playbacks of compressed streams. Decoding happens in chunks that are queued
+// in a lock-free ring buffer, either ahead of time on the AudioServer stream decoder
+// thread (when streaming) or on demand while mixing.
+class AudioStreamPlaybackStreamed : public AudioStreamPlaybackResampled {
+	GDCLASS(AudioStreamPlaybackStreamed, AudioStreamPlaybackResampled);
+
+public:
+	enum {
+		STREAM_CHUNK_FRAMES = 256,
+		// Chunk counts must be powers of two.
+		STREAM_BUFFER_CHUNKS = 32, // Decoded ahead by the decoder thread, ~186 ms at 44.1 kHz.
+		MIX_BUFFER_CHUNKS = 2, // Decoded while mixing.
+	};
+
+private:
+	struct Chunk {
+		AudioFrame frames[STREAM_CHUNK_FRAMES];
+		uint32_t position = 0; // Stream frame of the first frame.
+		uint32_t generation = 0; // Chunks from a generation older than the last seek are dropped.
+		int frame_count = 0;
+		bool looped = false; // The stream looped right before the first frame.
+		bool ended = false;
+	};
+
+	Chunk *chunks = nullptr;
+	uint32_t chunk_count = 0;
+	SafeNumeric<uint32_t> chunk_read;
+	SafeNumeric<uint32_t> chunk_write;
+	SafeNumeric<uint32_t> seek_generation;
+	SafeNumeric<uint32_t> seek_position;
+	SafeFlag fill_requested;
+	bool streaming = false;
+	bool decoder_thread = false;
+	float sampling_rate = 1.0;
+
+	// Mixer side.
+	bool active = false;
+	bool ended = false;
+	int loops = 0;
+	uint32_t position = 0;
+	int chunk_offset = 0;
+
+	// Decoder side.
+	uint32_t decoder_generation = 0;
+	uint32_t decoder_position = 0;
+	bool decoder_looped = false;
+	bool decoder_ended = false;
+
+	void _request_fill();
+
+	friend class AudioServer;
+
+protected:
+	// Decodes until the buffer is full, returns whether anything was decoded.
+	// Called while mixing, or by the AudioServer decoder thread when streaming.
+	bool _fill_stream_buffer();
+
+	// Decodes up to p_frames from the current position, fewer means the end was reached.
+	virtual int _decode(AudioFrame *p_buffer, int p_frames) = 0;
+	virtual void _decoder_seek(uint32_t p_frame) = 0;
+
+	// Also called by the decoder thread, so must be safe to call from any thread.
+	virtual float _get_length() const = 0;
+	virtual bool _has_loop() const = 0;
+	virtual float _get_loop_offset() const = 0;
+
+	virtual void _mix_internal(AudioFrame *p_buffer, int p_frames) override;
+
+	// Must be called by implementations once the decoder is ready, and from their
+	// destructor before it's freed. Without an AudioServer to decode on its thread,
+	// a streaming playback is only decoded by calling _fill_stream_buffer().
+	void _stream_begin(bool p_streaming);
+	void _stream_end();
+
+public:
+	virtual void start(float p_from_pos = 0.0) override;
+	virtual void stop() override;
+	virtual bool is_playing() const override;
+
+	virtual int get_loop_count() const override;
+
+	virtual float get_playback_position() const override;
+	virtual void seek(float p_time) override;
+	virtual void skip(float p_time) override;
+
+	bool is_streaming() const { return streaming; }
+
+	~AudioStreamPlaybackStreamed();
+};
+
 class AudioStream : public Resource {
 	GDCLASS(AudioStream, Resource);
 	OBJ_SAVE_TYPE(AudioStream); // Saves derived classes with common type so they can be interchanged.
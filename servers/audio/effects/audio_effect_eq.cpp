@@ -41,21 +41,28 @@ void AudioEffectEQInstance::process(const AudioFrame *p_src_frames, AudioFrame *
 	}
 
 	for (int i = 0; i < p_frame_count; i++) {
-		AudioFrame src = p_src_frames[i];
-		AudioFrame dst = AudioFrame(0, 0);
+		p_dst_frames[i] = AudioFrame(0, 0);
+	}
+
+	// Run each band over the whole buffer, so its state can stay in registers.
+	for (int j = 0; j < band_count; j++) {
+		EQ::BandProcess band_l = proc_l[j];
+		EQ::BandProcess band_r = proc_r[j];
+		float gain = bgain[j];
 
-		for (int j = 0; j < band_count; j++) {
-			float l = src.l;
-			float r = src.r;
+		for (int i = 0; i < p_frame_count; i++) {
+			float l = p_src_frames[i].l;
+			float r = p_src_frames[i].r;
 
-			proc_l[j].process_one(l);
-			proc_r[j].process_one(r);
+			band_l.process_one(l);
+			band_r.process_one(r);
 
-			dst.l += l * bgain[j];
-			dst.r += r * bgain[j];
+			p_dst_frames[i].l += l * gain;
+			p_dst_frames[i].r += r * gain;
 		}
 
-		p_dst_frames[i] = dst;
+		proc_l[j] = band_l;
+		proc_r[j] = band_r;
 	}
 }
 
@@ -33,36 +33,30 @@
 
 template <int S>
 void AudioEffectFilterInstance::_process_filter(const AudioFrame *p_src_frames, AudioFrame *p_dst_frames, int p_frame_count) {
-	for (int i = 0; i < p_frame_count; i++) {
-		float f = p_src_frames[i].l;
-		filter_process[0][0].process_one(f);
-		if (S > 1) {
-			filter_process[0][1].process_one(f);
-		}
-		if (S > 2) {
-			filter_process[0][2].process_one(f);
-		}
-		if (S > 3) {
-			filter_process[0][3].process_one(f);
-		}
-
-		p_dst_frames[i].l = f;
+	// Work on local copies of the processors, so their state can stay in registers.
+	// Both channels are independent and processed in the same loop.
+	AudioFilterSW::Processor proc_l[S];
+	AudioFilterSW::Processor proc_r[S];
+	for (int j = 0; j < S; j++) {
+		proc_l[j] = filter_process[0][j];
+		proc_r[j] = filter_process[1][j];
 	}
 
 	for (int i = 0; i < p_frame_count; i++) {
-		float f = p_src_frames[i].r;
-		filter_process[1][0].process_one(f);
-		if (S > 1) {
-			filter_process[1][1].process_one(f);
-		}
-		if (S > 2) {
-			filter_process[1][2].process_one(f);
-		}
-		if (S > 3) {
-			filter_process[1][3].process_one(f);
+		float l = p_src_frames[i].l;
+		float r = p_src_frames[i].r;
+
+		for (int j = 0; j < S; j++) {
+			proc_l[j].process_one(l);
+			proc_r[j].process_one(r);
 		}
 
-		p_dst_frames[i].r = f;
+		p_dst_frames[i] = AudioFrame(l, r);
+	}
+
+	for (int j = 0; j < S; j++) {
+		filter_process[0][j] = proc_l[j];
+		filter_process[1][j] = proc_r[j];
 	}
 }
 
@@ -108,18 +108,29 @@ void Reverb::process(float *p_src, float *p_dst, int p_frames) {
 		Comb &c = comb[i];
 
 		int size_limit = c.size - lrintf((float)c.extra_spread_frames * (1.0 - params.extra_spread));
+
+		// Keep the comb state in locals, writes to the buffers would otherwise force reloading it.
+		float *buffer = c.buffer;
+		int pos = c.pos;
+		float feedback = c.feedback;
+		float damp = c.damp;
+		float damp_h = c.damp_h;
+
 		for (int j = 0; j < p_frames; j++) {
-			if (c.pos >= size_limit) { //reset this now just in case
-				c.pos = 0;
+			if (pos >= size_limit) { //reset this now just in case
+				pos = 0;
 			}
 
-			float out = undenormalise(c.buffer[c.pos] * c.feedback);
-			out = out * (1.0 - c.damp) + c.damp_h * c.damp; //lowpass
-			c.damp_h = out;
-			c.buffer[c.pos] = input_buffer[j] + out;
+			float out = undenormalise(buffer[pos] * feedback);
+			out = out * (1.0 - damp) + damp_h * damp; //lowpass
+			damp_h = out;
+			buffer[pos] = input_buffer[j] + out;
 			p_dst[j] += out;
-			c.pos++;
+			pos++;
 		}
+
+		c.pos = pos;
+		c.damp_h = damp_h;
 	}
 
 	static const float allpass_feedback = 0.7;
@@ -159,16 +170,22 @@ void Reverb::process(float *p_src, float *p_dst, int p_frames) {
 		AllPass &a = allpass[i];
 		int size_limit = a.size - lrintf((float)a.extra_spread_frames * (1.0 - params.extra_spread));
 
+		float *buffer = a.buffer;
+		int pos = a.pos;
+
 		for (int j = 0; j < p_frames; j++) {
-			if (a.pos >= size_limit) {
-				a.pos = 0;
+			if (pos >= size_limit) {
+				pos = 0;
 			}
 
-			float aux = a.buffer[a.pos];
-			a.buffer[a.pos] = undenormalise(allpass_feedback * aux + p_dst[j]);
-			p_dst[j] = aux - allpass_feedback * a.buffer[a.pos];
-			a.pos++;
+			float aux = buffer[pos];
+			float in = undenormalise(allpass_feedback * aux + p_dst[j]);
+			buffer[pos] = in;
+			p_dst[j] = aux - allpass_feedback * in;
+			pos++;
 		}
+
+		a.pos = pos;
 	}
 
 	static const float wet_scale = 0.6;
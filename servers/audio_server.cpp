@@ -36,6 +36,7 @@
 #include "core/io/resource_loader.h"
 #include "core/os/os.h"
 #include "scene/resources/audio_stream_sample.h"
+#include "servers/audio/audio_stream.h"
 #include "servers/audio/audio_driver_dummy.h"
 #include "servers/audio/effects/audio_effect_compressor.h"
 
@@ -332,136 +333,234 @@ void AudioServer::_mix_step() {
 		}
 	}
 
+	_update_voices();
+
 	//make callbacks for mixing the audio
 	for (Set<CallbackItem>::Element *E = callbacks.front(); E; E = E->next()) {
 		E->get().callback(E->get().userdata);
 	}
 
-	for (int i = buses.size() - 1; i >= 0; i--) {
-		//go bus by bus
+	// Buses can only send to buses placed before them, and every chain ends at master.
+	// Group buses in levels, so that a bus is only processed once every bus sending
+	// to it has been. Buses in the same level don't depend on each other.
+	int bus_count = buses.size();
+	bus_send_cache.resize(bus_count);
+	bus_level_cache.resize(bus_count);
+
+	for (int i = 0; i < bus_count; i++) {
+		bus_level_cache[i] = 0;
+	}
+
+	bus_send_cache[0] = -1;
+	for (int i = bus_count - 1; i > 0; i--) {
+		//everything has a send save for master bus
 		Bus *bus = buses[i];
+		int send = 0;
+		Map<StringName, Bus *>::Element *E = bus_map.find(bus->send);
+		if (E && E->get()->index_cache < bus->index_cache) {
+			send = E->get()->index_cache;
+		}
+		bus_send_cache[i] = send;
+		bus_level_cache[send] = MAX(bus_level_cache[send], bus_level_cache[i] + 1);
+	}
 
-		for (int k = 0; k < bus->channels.size(); k++) {
-			if (bus->channels[k].active && !bus->channels[k].used) {
-				//buffer was not used, but it's still active, so it must be cleaned
-				AudioFrame *buf = bus->channels.write[k].buffer.ptrw();
+	for (int level = 0; level <= bus_level_cache[0]; level++) {
+		mix_level_buses.clear();
+		int buses_with_effects = 0;
 
-				for (uint32_t j = 0; j < buffer_size; j++) {
-					buf[j] = AudioFrame(0, 0);
-				}
+		for (int i = bus_count - 1; i >= 0; i--) {
+			if (bus_level_cache[i] != level) {
+				continue;
+			}
+			Bus *bus = buses[i];
+			mix_level_buses.push_back(bus);
+			if (!bus->bypass && bus->effects.size()) {
+				buses_with_effects++;
 			}
 		}
 
-		//process effects
-		if (!bus->bypass) {
-			for (int j = 0; j < bus->effects.size(); j++) {
-				if (!bus->effects[j].enabled) {
+		// Waking up threads is only worth it if several buses have effects to process.
+		if (threaded_bus_processing && buses_with_effects > 1) {
+			bus_thread_work_pool.do_work(mix_level_buses.size(), this, &AudioServer::_mix_step_bus_task, solo_mode);
+		} else {
+			for (uint32_t i = 0; i < mix_level_buses.size(); i++) {
+				_mix_step_bus(mix_level_buses[i], solo_mode);
+			}
+		}
+
+		//process sends, in bus order so the result doesn't depend on threading
+		for (uint32_t i = 0; i < mix_level_buses.size(); i++) {
+			Bus *bus = mix_level_buses[i];
+			int send = bus_send_cache[bus->index_cache];
+			if (send < 0) {
+				continue;
+			}
+
+			for (int k = 0; k < bus->channels.size(); k++) {
+				if (!bus->channels[k].active) {
 					continue;
 				}
 
-#ifdef DEBUG_ENABLED
-				uint64_t ticks = OS::get_singleton()->get_ticks_usec();
-#endif
+				const AudioFrame *buf = bus->channels[k].buffer.ptr();
+				AudioFrame *target_buf = thread_get_channel_mix_buffer(send, k);
 
-				for (int k = 0; k < bus->channels.size(); k++) {
-					if (!(bus->channels[k].active || bus->channels[k].effect_instances[j]->process_silence())) {
-						continue;
-					}
-					bus->channels.write[k].effect_instances.write[j]->process(bus->channels[k].buffer.ptr(), temp_buffer.write[k].ptrw(), buffer_size);
+				for (uint32_t j = 0; j < buffer_size; j++) {
+					target_buf[j] += buf[j];
 				}
+			}
+		}
+	}
 
-				//swap buffers, so internal buffer always has the right data
-				for (int k = 0; k < bus->channels.size(); k++) {
-					if (!(buses[i]->channels[k].active || bus->channels[k].effect_instances[j]->process_silence())) {
-						continue;
-					}
-					SWAP(bus->channels.write[k].buffer, temp_buffer.write[k]);
-				}
+	mix_frames += buffer_size;
+	to_mix = buffer_size;
+}
 
-#ifdef DEBUG_ENABLED
-				bus->effects.write[j].prof_time += OS::get_singleton()->get_ticks_usec() - ticks;
-#endif
-			}
+// Real voices must be this much quieter than virtual ones to be swapped, so voices
+// with similar volumes don't keep being virtualized and revived.
+#define VOICE_HYSTERESIS_DB 3.0
+
+bool AudioServer::VoiceSort::operator()(const Voice *p_a, const Voice *p_b) const {
+	int priority_a = p_a->priority.get();
+	int priority_b = p_b->priority.get();
+	if (priority_a != priority_b) {
+		return priority_a > priority_b;
+	}
+
+	float volume_a = p_a->volume_db.get() + (p_a->is_virtual ? 0.0 : VOICE_HYSTERESIS_DB);
+	float volume_b = p_b->volume_db.get() + (p_b->is_virtual ? 0.0 : VOICE_HYSTERESIS_DB);
+	return volume_a > volume_b;
+}
+
+void AudioServer::_update_voices() {
+	uint32_t virtual_count = 0;
+	audible_voices.clear();
+
+	for (uint32_t i = 0; i < voices.size(); i++) {
+		Voice *voice = voices[i];
+		if (!voice->playing) {
+			voice->is_virtual = false;
+			continue;
 		}
 
-		//process send
+		float threshold_db = voice->is_virtual ? voice_virtualize_db : voice_virtualize_db - VOICE_HYSTERESIS_DB;
+		if (voice->volume_db.get() < threshold_db) {
+			voice->is_virtual = true;
+			virtual_count++;
+			continue;
+		}
 
-		Bus *send = nullptr;
+		audible_voices.push_back(voice);
+	}
 
-		if (i > 0) {
-			//everything has a send save for master bus
-			if (!bus_map.has(bus->send)) {
-				send = buses[0];
-			} else {
-				send = bus_map[bus->send];
-				if (send->index_cache >= bus->index_cache) { //invalid, send to master
-					send = buses[0];
-				}
+	if (max_real_voices > 0 && audible_voices.size() > (uint32_t)max_real_voices) {
+		audible_voices.sort_custom<VoiceSort>();
+	}
+
+	uint32_t real_count = 0;
+	for (uint32_t i = 0; i < audible_voices.size(); i++) {
+		Voice *voice = audible_voices[i];
+		voice->is_virtual = max_real_voices > 0 && i >= (uint32_t)max_real_voices;
+		if (voice->is_virtual) {
+			virtual_count++;
+		} else {
+			real_count++;
+		}
+	}
+
+	real_voice_count.set(real_count);
+	virtual_voice_count.set(virtual_count);
+}
+
+void AudioServer::_mix_step_bus(Bus *p_bus, bool p_solo_mode) {
+	for (int k = 0; k < p_bus->channels.size(); k++) {
+		if (p_bus->channels[k].active && !p_bus->channels[k].used) {
+			//buffer was not used, but it's still active, so it must be cleaned
+			AudioFrame *buf = p_bus->channels.write[k].buffer.ptrw();
+
+			for (uint32_t j = 0; j < buffer_size; j++) {
+				buf[j] = AudioFrame(0, 0);
 			}
 		}
+	}
 
-		for (int k = 0; k < bus->channels.size(); k++) {
-			if (!bus->channels[k].active) {
-				bus->channels.write[k].peak_volume = AudioFrame(AUDIO_MIN_PEAK_DB, AUDIO_MIN_PEAK_DB);
+	//process effects
+	if (!p_bus->bypass) {
+		for (int j = 0; j < p_bus->effects.size(); j++) {
+			if (!p_bus->effects[j].enabled) {
 				continue;
 			}
 
-			AudioFrame *buf = bus->channels.write[k].buffer.ptrw();
-
-			AudioFrame peak = AudioFrame(0, 0);
-
-			float volume = Math::db2linear(bus->volume_db);
+#ifdef DEBUG_ENABLED
+			uint64_t ticks = OS::get_singleton()->get_ticks_usec();
+#endif
 
-			if (solo_mode) {
-				if (!bus->soloed) {
-					volume = 0.0;
-				}
-			} else {
-				if (bus->mute) {
-					volume = 0.0;
+			for (int k = 0; k < p_bus->channels.size(); k++) {
+				Bus::Channel &channel = p_bus->channels.write[k];
+				if (!(channel.active || channel.effect_instances[j]->process_silence())) {
+					continue;
 				}
+				channel.effect_instances.write[j]->process(channel.buffer.ptr(), channel.temp_buffer.ptrw(), buffer_size);
+
+				//swap buffers, so internal buffer always has the right data
+				SWAP(channel.buffer, channel.temp_buffer);
 			}
 
-			//apply volume and compute peak
-			for (uint32_t j = 0; j < buffer_size; j++) {
-				buf[j] *= volume;
+#ifdef DEBUG_ENABLED
+			p_bus->effects.write[j].prof_time += OS::get_singleton()->get_ticks_usec() - ticks;
+#endif
+		}
+	}
 
-				float l = ABS(buf[j].l);
-				if (l > peak.l) {
-					peak.l = l;
-				}
-				float r = ABS(buf[j].r);
-				if (r > peak.r) {
-					peak.r = r;
-				}
-			}
+	float volume = Math::db2linear(p_bus->volume_db);
 
-			bus->channels.write[k].peak_volume = AudioFrame(Math::linear2db(peak.l + AUDIO_PEAK_OFFSET), Math::linear2db(peak.r + AUDIO_PEAK_OFFSET));
+	if (p_solo_mode) {
+		if (!p_bus->soloed) {
+			volume = 0.0;
+		}
+	} else {
+		if (p_bus->mute) {
+			volume = 0.0;
+		}
+	}
 
-			if (!bus->channels[k].used) {
-				//see if any audio is contained, because channel was not used
+	for (int k = 0; k < p_bus->channels.size(); k++) {
+		if (!p_bus->channels[k].active) {
+			p_bus->channels.write[k].peak_volume = AudioFrame(AUDIO_MIN_PEAK_DB, AUDIO_MIN_PEAK_DB);
+			continue;
+		}
 
-				if (MAX(peak.r, peak.l) > Math::db2linear(channel_disable_threshold_db)) {
-					bus->channels.write[k].last_mix_with_audio = mix_frames;
-				} else if (mix_frames - bus->channels[k].last_mix_with_audio > channel_disable_frames) {
-					bus->channels.write[k].active = false;
-					continue; //went inactive, don't mix.
-				}
-			}
+		AudioFrame *buf = p_bus->channels.write[k].buffer.ptrw();
 
-			if (send) {
-				//if not master bus, send
-				AudioFrame *target_buf = thread_get_channel_mix_buffer(send->index_cache, k);
+		float peak_l = 0;
+		float peak_r = 0;
 
-				for (uint32_t j = 0; j < buffer_size; j++) {
-					target_buf[j] += buf[j];
-				}
+		//apply volume and compute peak
+		for (uint32_t j = 0; j < buffer_size; j++) {
+			float l = buf[j].l * volume;
+			float r = buf[j].r * volume;
+			buf[j].l = l;
+			buf[j].r = r;
+
+			peak_l = MAX(peak_l, ABS(l));
+			peak_r = MAX(peak_r, ABS(r));
+		}
+
+		p_bus->channels.write[k].peak_volume = AudioFrame(Math::linear2db(peak_l + AUDIO_PEAK_OFFSET), Math::linear2db(peak_r + AUDIO_PEAK_OFFSET));
+
+		if (!p_bus->channels[k].used) {
+			//see if any audio is contained, because channel was not used
+
+			if (MAX(peak_r, peak_l) > Math::db2linear(channel_disable_threshold_db)) {
+				p_bus->channels.write[k].last_mix_with_audio = mix_frames;
+			} else if (mix_frames - p_bus->channels[k].last_mix_with_audio > channel_disable_frames) {
+				p_bus->channels.write[k].active = false; //went inactive, don't send.
 			}
 		}
 	}
+}
 
-	mix_frames += buffer_size;
-	to_mix = buffer_size;
+void AudioServer::_mix_step_bus_task(uint32_t p_index, bool p_solo_mode) {
+	_mix_step_bus(mix_level_buses[p_index], p_solo_mode);
 }
 
 bool AudioServer::thread_has_channel_mix_buffer(int p_bus, int p_buffer) const {
@@ -546,6 +645,7 @@ void AudioServer::set_bus_count(int p_count) {
 		buses.write[i]->channels.resize(channel_count);
 		for (int j = 0; j < channel_count; j++) {
 			buses.write[i]->channels.write[j].buffer.resize(buffer_size);
+			buses.write[i]->channels.write[j].temp_buffer.resize(buffer_size);
 		}
 		buses[i]->name = attempt;
 		buses[i]->solo = false;
@@ -615,6 +715,7 @@ void AudioServer::add_bus(int p_at_pos) {
 	bus->channels.resize(channel_count);
 	for (int j = 0; j < channel_count; j++) {
 		bus->channels.write[j].buffer.resize(buffer_size);
+		bus->channels.write[j].temp_buffer.resize(buffer_size);
 	}
 	bus->name = attempt;
 	bus->solo = false;
@@ -925,16 +1026,12 @@ float AudioServer::get_global_rate_scale() const {
 
 void AudioServer::init_channels_and_buffers() {
 	channel_count = get_channel_count();
-	temp_buffer.resize(channel_count);
-
-	for (int i = 0; i < temp_buffer.size(); i++) {
-		temp_buffer.write[i].resize(buffer_size);
-	}
 
 	for (int i = 0; i < buses.size(); i++) {
 		buses[i]->channels.resize(channel_count);
 		for (int j = 0; j < channel_count; j++) {
 			buses.write[i]->channels.write[j].buffer.resize(buffer_size);
+			buses.write[i]->channels.write[j].temp_buffer.resize(buffer_size);
 		}
 	}
 }
@@ -947,6 +1044,19 @@ void AudioServer::init() {
 
 	init_channels_and_buffers();
 
+	threaded_bus_processing = GLOBAL_DEF_RST("audio/buses/threaded_processing", true);
+
+	max_real_voices = GLOBAL_DEF_RST("audio/voices/max_real_voices", 0);
+	ProjectSettings::get_singleton()->set_custom_property_info("audio/voices/max_real_voices", PropertyInfo(Variant::INT, "audio/voices/max_real_voices", PROPERTY_HINT_RANGE, "0,1024,1,or_greater"));
+	voice_virtualize_db = GLOBAL_DEF_RST("audio/voices/virtualize_below_db", -80.0);
+	ProjectSettings::get_singleton()->set_custom_property_info("audio/voices/virtualize_below_db", PropertyInfo(Variant::FLOAT, "audio/voices/virtualize_below_db", PROPERTY_HINT_RANGE, "-200,0,0.1"));
+	if (threaded_bus_processing) {
+		// The mix thread waits on these workers, so they run with real-time priority. Leave a core
+		// free so they can't starve the main and audio driver threads.
+		int processor_count = OS::get_singleton()->get_processor_count();
+		bus_thread_work_pool.init(MAX(processor_count - 1, 1), processor_count > 1);
+	}
+
 	mix_count = 0;
 	set_bus_count(1);
 	set_bus_name(0, "Master");
@@ -1051,6 +1161,14 @@ void AudioServer::finish() {
 		AudioDriverManager::get_driver(i)->finish();
 	}
 
+	bus_thread_work_pool.finish();
+
+	if (stream_decoder_thread.is_started()) {
+		stream_decoder_exit.set();
+		stream_decoder_semaphore.post();
+		stream_decoder_thread.wait_to_finish();
+	}
+
 	for (int i = 0; i < buses.size(); i++) {
 		memdelete(buses[i]);
 	}
@@ -1098,6 +1216,74 @@ double AudioServer::get_time_since_last_mix() const {
 
 AudioServer *AudioServer::singleton = nullptr;
 
+void AudioServer::voice_add(Voice *p_voice) {
+	lock();
+	const bool already_added = voices.find(p_voice) >= 0;
+	if (!already_added) {
+		voices.push_back(p_voice);
+	}
+	unlock();
+	ERR_FAIL_COND_MSG(already_added, "Voice already added.");
+}
+
+void AudioServer::voice_remove(Voice *p_voice) {
+	lock();
+	voices.erase(p_voice);
+	unlock();
+}
+
+int AudioServer::get_real_voice_count() const {
+	return real_voice_count.get();
+}
+
+int AudioServer::get_virtual_voice_count() const {
+	return virtual_voice_count.get();
+}
+
+void AudioServer::_stream_decoder_thread_func(void *p_udata) {
+	AudioServer *as = (AudioServer *)p_udata;
+
+	while (true) {
+		as->stream_decoder_semaphore.wait();
+		if (as->stream_decoder_exit.is_set()) {
+			break;
+		}
+
+		// Playbacks that didn't request anything are already full, filling them returns right away.
+		as->stream_decoder_mutex.lock();
+		for (uint32_t i = 0; i < as->stream_decoder_playbacks.size(); i++) {
+			as->stream_decoder_playbacks[i]->_fill_stream_buffer();
+		}
+		as->stream_decoder_mutex.unlock();
+	}
+}
+
+bool AudioServer::stream_decoder_add(AudioStreamPlaybackStreamed *p_playback) {
+	MutexLock lock(stream_decoder_mutex);
+
+	if (!stream_decoder_thread.is_started()) {
+		stream_decoder_exit.clear();
+		stream_decoder_thread.start(_stream_decoder_thread_func, this);
+		if (!stream_decoder_thread.is_started()) {
+			return false; // Built without threads, the playback decodes while mixing.
+		}
+	}
+
+	ERR_FAIL_COND_V_MSG(stream_decoder_playbacks.find(p_playback) >= 0, true, "Playback already added to the stream decoder.");
+	stream_decoder_playbacks.push_back(p_playback);
+	return true;
+}
+
+void AudioServer::stream_decoder_remove(AudioStreamPlaybackStreamed *p_playback) {
+	// Blocks until the decoder thread is done with this playback.
+	MutexLock lock(stream_decoder_mutex);
+	stream_decoder_playbacks.erase(p_playback);
+}
+
+void AudioServer::stream_decoder_wake() {
+	stream_decoder_semaphore.post();
+}
+
 void AudioServer::add_callback(AudioCallback p_callback, void *p_userdata) {
 	lock();
 	CallbackItem ci;
@@ -1177,6 +1363,7 @@ void AudioServer::set_bus_layout(const Ref<AudioBusLayout> &p_bus_layout) {
 		buses[i]->channels.resize(channel_count);
 		for (int j = 0; j < channel_count; j++) {
 			buses.write[i]->channels.write[j].buffer.resize(buffer_size);
+			buses.write[i]->channels.write[j].temp_buffer.resize(buffer_size);
 		}
 		_update_bus_effects(i);
 	}
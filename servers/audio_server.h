@@ -33,12 +33,19 @@
 
 #include "core/math/audio_frame.h"
 #include "core/object/class_db.h"
+#include "core/os/mutex.h"
 #include "core/os/os.h"
+#include "core/os/semaphore.h"
+#include "core/os/thread.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
+#include "core/templates/thread_work_pool.h"
 #include "core/variant/variant.h"
 #include "servers/audio/audio_effect.h"
 
 class AudioDriverDummy;
 class AudioStream;
+class AudioStreamPlaybackStreamed;
 class AudioStreamSample;
 
 class AudioDriver {
@@ -160,6 +167,19 @@ public:
 
 	typedef void (*AudioCallback)(void *p_userdata);
 
+	// Playbacks mixed from audio callbacks can be registered as voices, so the amount of
+	// playbacks actually mixed can be limited. Voices that are too quiet or less important
+	// than the real ones become virtual: their owner should only advance the playback
+	// position instead of mixing them.
+	struct Voice {
+		SafeNumeric<int> priority; // Higher is more important.
+		SafeNumeric<float> volume_db; // Estimated volume at the listener.
+
+		// Only accessed from the audio thread.
+		bool playing = false; // Set by the owner when mixing.
+		bool is_virtual = false; // Set by the server before mixing.
+	};
+
 private:
 	uint64_t mix_time;
 	int mix_size;
@@ -193,6 +213,7 @@ private:
 			bool active;
 			AudioFrame peak_volume;
 			Vector<AudioFrame> buffer;
+			Vector<AudioFrame> temp_buffer; // Effects output here, then it's swapped with buffer.
 			Vector<Ref<AudioEffectInstance>> effect_instances;
 			uint64_t last_mix_with_audio;
 			Channel() {
@@ -219,10 +240,40 @@ private:
 		int index_cache;
 	};
 
-	Vector<Vector<AudioFrame>> temp_buffer; //temp_buffer for each level
 	Vector<Bus *> buses;
 	Map<StringName, Bus *> bus_map;
 
+	// Scratch data used by _mix_step() to process buses in dependency order.
+	LocalVector<int> bus_send_cache;
+	LocalVector<int> bus_level_cache;
+	LocalVector<Bus *> mix_level_buses;
+
+	bool threaded_bus_processing = false;
+	ThreadWorkPool bus_thread_work_pool;
+
+	LocalVector<Voice *> voices;
+	LocalVector<Voice *> audible_voices;
+	int max_real_voices = 0;
+	float voice_virtualize_db = AUDIO_MIN_PEAK_DB;
+	SafeNumeric<uint32_t> real_voice_count;
+	SafeNumeric<uint32_t> virtual_voice_count;
+
+	struct VoiceSort {
+		bool operator()(const Voice *p_a, const Voice *p_b) const;
+	};
+
+	void _update_voices();
+
+	// Streamed playbacks are decoded ahead of the mix on this thread, started on demand.
+	// It sleeps until a playback requests more data.
+	Thread stream_decoder_thread;
+	Mutex stream_decoder_mutex;
+	Semaphore stream_decoder_semaphore;
+	LocalVector<AudioStreamPlaybackStreamed *> stream_decoder_playbacks;
+	SafeFlag stream_decoder_exit;
+
+	static void _stream_decoder_thread_func(void *p_udata);
+
 	void _update_bus_effects(int p_bus);
 
 	static AudioServer *singleton;
@@ -230,6 +281,8 @@ private:
 	void init_channels_and_buffers();
 
 	void _mix_step();
+	void _mix_step_bus(Bus *p_bus, bool p_solo_mode);
+	void _mix_step_bus_task(uint32_t p_index, bool p_solo_mode);
 
 	struct CallbackItem {
 		AudioCallback callback;
@@ -316,6 +369,15 @@ public:
 
 	bool is_bus_channel_active(int p_bus, int p_channel) const;
 
+	void voice_add(Voice *p_voice);
+	void voice_remove(Voice *p_voice);
+	int get_real_voice_count() const;
+	int get_virtual_voice_count() const;
+
+	bool stream_decoder_add(AudioStreamPlaybackStreamed *p_playback);
+	void stream_decoder_remove(AudioStreamPlaybackStreamed *p_playback);
+	void stream_decoder_wake();
+
 	void set_global_rate_scale(float p_scale);
 	float get_global_rate_scale() const;
 
@@ -374,6 +374,20 @@ void PhysicsServer3DSW::area_set_transform(RID p_area, const Transform3D &p_tran
 	area->set_transform(p_transform);
 };
 
+void PhysicsServer3DSW::area_set_transforms(const Vector<RID> &p_areas, const Vector<Transform3D> &p_transforms) {
+	ERR_FAIL_COND(p_areas.size() != p_transforms.size());
+
+	const RID *areas = p_areas.ptr();
+	const Transform3D *transforms = p_transforms.ptr();
+	for (int i = 0; i < p_areas.size(); i++) {
+		Area3DSW *area = area_owner.getornull(areas[i]);
+		if (!area) {
+			continue; // Freed after its transform was batched.
+		}
+		area->set_transform(transforms[i]);
+	}
+}
+
 Variant PhysicsServer3DSW::area_get_param(RID p_area, AreaParameter p_param) const {
 	if (space_owner.owns(p_area)) {
 		Space3DSW *space = space_owner.getornull(p_area);
@@ -663,6 +677,20 @@ void PhysicsServer3DSW::body_set_state(RID p_body, BodyState p_state, const Vari
 	body->set_state(p_state, p_variant);
 };
 
+void PhysicsServer3DSW::body_set_transforms(const Vector<RID> &p_bodies, const Vector<Transform3D> &p_transforms) {
+	ERR_FAIL_COND(p_bodies.size() != p_transforms.size());
+
+	const RID *bodies = p_bodies.ptr();
+	const Transform3D *transforms = p_transforms.ptr();
+	for (int i = 0; i < p_bodies.size(); i++) {
+		Body3DSW *body = body_owner.getornull(bodies[i]);
+		if (!body) {
+			continue; // Freed after its transform was batched.
+		}
+		body->set_state(BODY_STATE_TRANSFORM, transforms[i]);
+	}
+}
+
 Variant PhysicsServer3DSW::body_get_state(RID p_body, BodyState p_state) const {
 	Body3DSW *body = body_owner.getornull(p_body);
 	ERR_FAIL_COND_V(!body, Variant());
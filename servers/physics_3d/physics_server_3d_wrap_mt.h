@@ -158,6 +158,7 @@ public:
 
 	FUNC3(area_set_param, RID, AreaParameter, const Variant &);
 	FUNC2(area_set_transform, RID, const Transform3D &);
+	FUNC2(area_set_transforms, const Vector<RID> &, const Vector<Transform3D> &);
 
 	FUNC2RC(Variant, area_get_param, RID, AreaParameter);
 	FUNC1RC(Transform3D, area_get_transform, RID);
@@ -214,6 +215,7 @@ public:
 	FUNC2RC(real_t, body_get_param, RID, BodyParameter);
 
 	FUNC3(body_set_state, RID, BodyState, const Variant &);
+	FUNC2(body_set_transforms, const Vector<RID> &, const Vector<Transform3D> &);
 	FUNC2RC(Variant, body_get_state, RID, BodyState);
 
 	FUNC2(body_set_applied_force, RID, const Vector3 &);
@@ -353,6 +353,7 @@ public:
 
 	virtual void area_set_param(RID p_area, AreaParameter p_param, const Variant &p_value) = 0;
 	virtual void area_set_transform(RID p_area, const Transform3D &p_transform) = 0;
+	virtual void area_set_transforms(const Vector<RID> &p_areas, const Vector<Transform3D> &p_transforms) = 0;
 
 	virtual Variant area_get_param(RID p_parea, AreaParameter p_param) const = 0;
 	virtual Transform3D area_get_transform(RID p_area) const = 0;
@@ -438,6 +439,7 @@ public:
 	};
 
 	virtual void body_set_state(RID p_body, BodyState p_state, const Variant &p_variant) = 0;
+	virtual void body_set_transforms(const Vector<RID> &p_bodies, const Vector<Transform3D> &p_transforms) = 0;
 	virtual Variant body_get_state(RID p_body, BodyState p_state) const = 0;
 
 	//do something about it
@@ -143,6 +143,7 @@ void register_server_types() {
 	ClassDB::register_virtual_class<AudioStream>();
 	ClassDB::register_virtual_class<AudioStreamPlayback>();
 	ClassDB::register_virtual_class<AudioStreamPlaybackResampled>();
+	ClassDB::register_virtual_class<AudioStreamPlaybackStreamed>();
 	ClassDB::register_class<AudioStreamMicrophone>();
 	ClassDB::register_class<AudioStreamRandomPitch>();
 	ClassDB::register_virtual_class<AudioEffect>();
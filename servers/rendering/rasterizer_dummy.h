@@ -341,10 +341,30 @@ public:
 
 	/* MULTIMESH API */
 
-	RID multimesh_allocate() override { return RID(); }
+	// The buffers are kept, so MultiMesh resources keep their data when saved without a renderer.
+	struct DummyMultiMesh {
+		int instances = 0;
+		Vector<float> buffer;
+	};
+	mutable RID_PtrOwner<DummyMultiMesh> multimesh_owner;
+
+	RID multimesh_allocate() override {
+		DummyMultiMesh *multimesh = memnew(DummyMultiMesh);
+		ERR_FAIL_COND_V(!multimesh, RID());
+		return multimesh_owner.make_rid(multimesh);
+	}
 	void multimesh_initialize(RID p_rid) override {}
-	void multimesh_allocate_data(RID p_multimesh, int p_instances, RS::MultimeshTransformFormat p_transform_format, bool p_use_colors = false, bool p_use_custom_data = false) override {}
-	int multimesh_get_instance_count(RID p_multimesh) const override { return 0; }
+	void multimesh_allocate_data(RID p_multimesh, int p_instances, RS::MultimeshTransformFormat p_transform_format, bool p_use_colors = false, bool p_use_custom_data = false) override {
+		DummyMultiMesh *multimesh = multimesh_owner.getornull(p_multimesh);
+		ERR_FAIL_COND(!multimesh);
+		multimesh->instances = p_instances;
+		multimesh->buffer.clear();
+	}
+	int multimesh_get_instance_count(RID p_multimesh) const override {
+		DummyMultiMesh *multimesh = multimesh_owner.getornull(p_multimesh);
+		ERR_FAIL_COND_V(!multimesh, 0);
+		return multimesh->instances;
+	}
 
 	void multimesh_set_mesh(RID p_multimesh, RID p_mesh) override {}
 	void multimesh_instance_set_transform(RID p_multimesh, int p_index, const Transform3D &p_transform) override {}
@@ -359,8 +379,16 @@ public:
 	Transform2D multimesh_instance_get_transform_2d(RID p_multimesh, int p_index) const override { return Transform2D(); }
 	Color multimesh_instance_get_color(RID p_multimesh, int p_index) const override { return Color(); }
 	Color multimesh_instance_get_custom_data(RID p_multimesh, int p_index) const override { return Color(); }
-	void multimesh_set_buffer(RID p_multimesh, const Vector<float> &p_buffer) override {}
-	Vector<float> multimesh_get_buffer(RID p_multimesh) const override { return Vector<float>(); }
+	void multimesh_set_buffer(RID p_multimesh, const Vector<float> &p_buffer) override {
+		DummyMultiMesh *multimesh = multimesh_owner.getornull(p_multimesh);
+		ERR_FAIL_COND(!multimesh);
+		multimesh->buffer = p_buffer;
+	}
+	Vector<float> multimesh_get_buffer(RID p_multimesh) const override {
+		DummyMultiMesh *multimesh = multimesh_owner.getornull(p_multimesh);
+		ERR_FAIL_COND_V(!multimesh, Vector<float>());
+		return multimesh->buffer;
+	}
 
 	void multimesh_set_visible_instances(RID p_multimesh, int p_visible) override {}
 	int multimesh_get_visible_instances(RID p_multimesh) const override { return 0; }
@@ -393,6 +421,7 @@ public:
 	Transform3D skeleton_bone_get_transform(RID p_skeleton, int p_bone) const override { return Transform3D(); }
 	void skeleton_bone_set_transform_2d(RID p_skeleton, int p_bone, const Transform2D &p_transform) override {}
 	Transform2D skeleton_bone_get_transform_2d(RID p_skeleton, int p_bone) const override { return Transform2D(); }
+	void skeleton_set_buffer(RID p_skeleton, const Vector<float> &p_buffer) override {}
 
 	/* Light API */
 
@@ -675,13 +704,22 @@ public:
 	Rect2i render_target_get_sdf_rect(RID p_render_target) const override { return Rect2i(); }
 	void render_target_mark_sdf_enabled(RID p_render_target, bool p_enabled) override {}
 
-	RS::InstanceType get_base_type(RID p_rid) const override { return RS::INSTANCE_NONE; }
+	RS::InstanceType get_base_type(RID p_rid) const override {
+		if (multimesh_owner.owns(p_rid)) {
+			return RS::INSTANCE_MULTIMESH;
+		}
+		return RS::INSTANCE_NONE;
+	}
 	bool free(RID p_rid) override {
 		if (texture_owner.owns(p_rid)) {
 			// delete the texture
 			DummyTexture *texture = texture_owner.getornull(p_rid);
 			texture_owner.free(p_rid);
 			memdelete(texture);
+		} else if (multimesh_owner.owns(p_rid)) {
+			DummyMultiMesh *multimesh = multimesh_owner.getornull(p_rid);
+			multimesh_owner.free(p_rid);
+			memdelete(multimesh);
 		}
 		return true;
 	}
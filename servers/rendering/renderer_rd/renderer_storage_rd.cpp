@@ -5757,6 +5757,21 @@ void RendererStorageRD::skeleton_set_base_transform_2d(RID p_skeleton, const Tra
 	skeleton->base_transform_2d = p_base_transform;
 }
 
+void RendererStorageRD::skeleton_set_buffer(RID p_skeleton, const Vector<float> &p_buffer) {
+	Skeleton *skeleton = skeleton_owner.getornull(p_skeleton);
+
+	ERR_FAIL_COND(!skeleton);
+	ERR_FAIL_COND(p_buffer.size() != skeleton->data.size());
+
+	if (skeleton->size == 0) {
+		return;
+	}
+
+	memcpy(skeleton->data.ptrw(), p_buffer.ptr(), p_buffer.size() * sizeof(float));
+
+	_skeleton_make_dirty(skeleton);
+}
+
 void RendererStorageRD::_update_dirty_skeletons() {
 	while (skeleton_dirty_list) {
 		Skeleton *skeleton = skeleton_dirty_list;
@@ -1777,6 +1777,7 @@ public:
 	Transform3D skeleton_bone_get_transform(RID p_skeleton, int p_bone) const;
 	void skeleton_bone_set_transform_2d(RID p_skeleton, int p_bone, const Transform2D &p_transform);
 	Transform2D skeleton_bone_get_transform_2d(RID p_skeleton, int p_bone) const;
+	void skeleton_set_buffer(RID p_skeleton, const Vector<float> &p_buffer);
 
 	_FORCE_INLINE_ bool skeleton_is_valid(RID p_skeleton) {
 		return skeleton_owner.getornull(p_skeleton) != nullptr;
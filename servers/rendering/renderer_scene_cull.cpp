@@ -785,11 +785,8 @@ void RendererSceneCull::instance_set_layer_mask(RID p_instance, uint32_t p_mask)
 	}
 }
 
-void RendererSceneCull::instance_set_transform(RID p_instance, const Transform3D &p_transform) {
-	Instance *instance = instance_owner.getornull(p_instance);
-	ERR_FAIL_COND(!instance);
-
-	if (instance->transform == p_transform) {
+void RendererSceneCull::_instance_set_transform(Instance *p_instance, const Transform3D &p_transform) {
+	if (p_instance->transform == p_transform) {
 		return; //must be checked to avoid worst evil
 	}
 
@@ -806,8 +803,30 @@ void RendererSceneCull::instance_set_transform(RID p_instance, const Transform3D
 	}
 
 #endif
-	instance->transform = p_transform;
-	_instance_queue_update(instance, true);
+	p_instance->transform = p_transform;
+	_instance_queue_update(p_instance, true);
+}
+
+void RendererSceneCull::instance_set_transform(RID p_instance, const Transform3D &p_transform) {
+	Instance *instance = instance_owner.getornull(p_instance);
+	ERR_FAIL_COND(!instance);
+
+	_instance_set_transform(instance, p_transform);
+}
+
+void RendererSceneCull::instance_set_transforms(const Vector<RID> &p_instances, const Vector<Transform3D> &p_transforms) {
+	ERR_FAIL_COND(p_instances.size() != p_transforms.size());
+
+	const RID *instances = p_instances.ptr();
+	const Transform3D *transforms = p_transforms.ptr();
+	for (int i = 0; i < p_instances.size(); i++) {
+		Instance *instance = instance_owner.getornull(instances[i]);
+		if (!instance) {
+			continue; // Freed after its transform was batched.
+		}
+
+		_instance_set_transform(instance, transforms[i]);
+	}
 }
 
 void RendererSceneCull::instance_attach_object_instance_id(RID p_instance, ObjectID p_id) {
@@ -0,0 +1,268 @@
+/*************************************************************************/
+/*  test_animation_player.h                                              */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_ANIMATION_PLAYER_H
+#define TEST_ANIMATION_PLAYER_H
+
+#include "core/os/os.h"
+#include "scene/3d/node_3d.h"
+#include "scene/animation/animation_blend_tree.h"
+#include "scene/animation/animation_player.h"
+#include "scene/animation/animation_tree.h"
+
+#include "tests/test_macros.h"
+#include "tests/test_scene_tree.h"
+
+namespace TestAnimationPlayer {
+
+static Ref<Animation> create_move_animation(const NodePath &p_path, const Vector3 &p_from, const Vector3 &p_to) {
+	Ref<Animation> animation;
+	animation.instantiate();
+	animation->set_length(1.0);
+	int track = animation->add_track(Animation::TYPE_TRANSFORM3D);
+	animation->track_set_path(track, p_path);
+	animation->transform_track_insert_key(track, 0.0, p_from, Quaternion(), Vector3(1, 1, 1));
+	animation->transform_track_insert_key(track, 1.0, p_to, Quaternion(), Vector3(1, 1, 1));
+	return animation;
+}
+
+// A player animating a sibling, which moves along x in "a" and stays up in "b".
+static AnimationPlayer *create_player(Node *p_parent, bool p_threaded, Node3D *&r_target) {
+	Node *character = memnew(Node);
+	p_parent->add_child(character);
+
+	r_target = memnew(Node3D);
+	r_target->set_name("Target");
+	character->add_child(r_target);
+
+	AnimationPlayer *player = memnew(AnimationPlayer);
+	player->set_process_threaded(p_threaded);
+	player->add_animation("a", create_move_animation(NodePath("Target"), Vector3(), Vector3(4, 0, 0)));
+	player->add_animation("b", create_move_animation(NodePath("Target"), Vector3(0, 4, 0), Vector3(0, 4, 0)));
+	character->add_child(player);
+	return player;
+}
+
+TEST_CASE("[AnimationPlayer] Threaded processing blends like serial processing") {
+	TestSceneTree::HeadlessSceneTree headless;
+	SceneTree *tree = headless.tree;
+
+	Node3D *serial_target = nullptr;
+	Node3D *threaded_target = nullptr;
+	AnimationPlayer *serial = create_player(tree->get_root(), false, serial_target);
+	AnimationPlayer *threaded = create_player(tree->get_root(), true, threaded_target);
+
+	const Vector3 expected[] = {
+		Vector3(2, 0, 0), // Halfway through "a".
+		Vector3(3, 0, 0), // The blend starts with all of "a".
+		Vector3(2, 2, 0), // Half of "a" at its end and half of "b".
+		Vector3(0, 4, 0), // Only "b" once blended.
+	};
+
+	serial->play("a");
+	threaded->play("a");
+	for (int i = 0; i < 4; i++) {
+		if (i == 1) {
+			serial->play("b", 0.5);
+			threaded->play("b", 0.5);
+		}
+		tree->process(i == 0 ? 0.5 : 0.25);
+
+		CHECK_MESSAGE(serial_target->get_position().is_equal_approx(expected[i]), vformat("Frame %d: %s", i, serial_target->get_position()));
+		CHECK_MESSAGE(threaded_target->get_position().is_equal_approx(expected[i]), vformat("Frame %d: %s", i, threaded_target->get_position()));
+	}
+
+	// Caches are rebuilt before blending on the workers.
+	threaded->clear_caches();
+	threaded_target->set_position(Vector3());
+	tree->process(0.25);
+	CHECK(threaded_target->get_position().is_equal_approx(Vector3(0, 4, 0)));
+}
+
+// Blends "a" into "b" by the "parameters/blend/blend_amount" of each tree.
+static Ref<AnimationNodeBlendTree> create_blend_graph() {
+	Ref<AnimationNodeBlendTree> graph;
+	graph.instantiate();
+
+	Ref<AnimationNodeAnimation> a;
+	a.instantiate();
+	a->set_animation("a");
+	graph->add_node("a", a);
+
+	Ref<AnimationNodeAnimation> b;
+	b.instantiate();
+	b->set_animation("b");
+	graph->add_node("b", b);
+
+	Ref<AnimationNodeBlend2> blend;
+	blend.instantiate();
+	graph->add_node("blend", blend);
+
+	graph->connect_node("blend", 0, "a");
+	graph->connect_node("blend", 1, "b");
+	graph->connect_node("output", 0, "blend");
+	return graph;
+}
+
+static AnimationTree *create_animation_tree(Node *p_parent, const Ref<AnimationNode> &p_graph, bool p_threaded, float p_blend, Node3D *&r_target) {
+	AnimationPlayer *player = create_player(p_parent, false, r_target);
+	player->set_name("Player");
+
+	AnimationTree *animation_tree = memnew(AnimationTree);
+	animation_tree->set_tree_root(p_graph);
+	animation_tree->set_animation_player(NodePath("../Player"));
+	animation_tree->set_process_threaded(p_threaded);
+	player->get_parent()->add_child(animation_tree);
+	animation_tree->set("parameters/blend/blend_amount", p_blend);
+	animation_tree->set_active(true);
+	return animation_tree;
+}
+
+TEST_CASE("[AnimationTree] Threaded processing blends like serial processing, with shared graphs") {
+	TestSceneTree::HeadlessSceneTree headless;
+	SceneTree *tree = headless.tree;
+
+	// Trees instanced from the same scene share their graph resources, which hold evaluation data.
+	const int graph_count = 2;
+	const int trees_per_graph = 8;
+	Ref<AnimationNode> graphs[graph_count] = { create_blend_graph(), create_blend_graph() };
+
+	LocalVector<Node3D *> serial_targets;
+	LocalVector<Node3D *> threaded_targets;
+	LocalVector<float> blends;
+	for (int i = 0; i < graph_count * trees_per_graph; i++) {
+		const float blend = (i % trees_per_graph) / float(trees_per_graph - 1);
+		Node3D *target = nullptr;
+		create_animation_tree(tree->get_root(), graphs[i % graph_count], false, blend, target);
+		serial_targets.push_back(target);
+		create_animation_tree(tree->get_root(), graphs[i % graph_count], true, blend, target);
+		threaded_targets.push_back(target);
+		blends.push_back(blend);
+	}
+
+	tree->process(0.5);
+
+	for (uint32_t i = 0; i < blends.size(); i++) {
+		// Halfway through "a", blended with "b".
+		const Vector3 expected = Vector3(2, 0, 0) * (1.0 - blends[i]) + Vector3(0, 4, 0) * blends[i];
+		CHECK_MESSAGE(serial_targets[i]->get_position().is_equal_approx(expected), vformat("Tree %d: %s", i, serial_targets[i]->get_position()));
+		CHECK_MESSAGE(threaded_targets[i]->get_position().is_equal_approx(serial_targets[i]->get_position()), vformat("Tree %d: %s", i, threaded_targets[i]->get_position()));
+	}
+}
+
+TEST_CASE_BENCHMARK("[AnimationPlayer][Benchmark] Process 1000 players with 20 tracks") {
+	TestSceneTree::HeadlessSceneTree headless;
+	SceneTree *tree = headless.tree;
+
+	const int player_count = 1000;
+	const int track_count = 20;
+	const int frames = 100;
+
+	Ref<Animation> animation;
+	animation.instantiate();
+	animation->set_length(1.0);
+	animation->set_loop(true);
+	for (int i = 0; i < track_count; i++) {
+		int track = animation->add_track(Animation::TYPE_TRANSFORM3D);
+		animation->track_set_path(track, NodePath("Bone" + itos(i)));
+		for (int j = 0; j <= 10; j++) {
+			float time = j / 10.0;
+			Quaternion rotation(Vector3(0, 1, 0), time * Math_TAU);
+			animation->transform_track_insert_key(track, time, Vector3(i, time, 0), rotation, Vector3(1, 1, 1));
+		}
+	}
+
+	LocalVector<AnimationPlayer *> players;
+	for (int i = 0; i < player_count; i++) {
+		Node *character = memnew(Node);
+		tree->get_root()->add_child(character);
+		for (int j = 0; j < track_count; j++) {
+			Node3D *bone = memnew(Node3D);
+			bone->set_name("Bone" + itos(j));
+			character->add_child(bone);
+		}
+
+		AnimationPlayer *player = memnew(AnimationPlayer);
+		player->add_animation("loop", animation);
+		character->add_child(player);
+		player->play("loop");
+		players.push_back(player);
+	}
+
+	for (int threaded = 0; threaded < 2; threaded++) {
+		for (uint32_t i = 0; i < players.size(); i++) {
+			players[i]->set_process_threaded(threaded);
+		}
+
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < frames; i++) {
+			tree->process(1.0 / 60.0);
+		}
+		uint64_t usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+		MESSAGE((threaded ? "Threaded: " : "Serial: ") << (usec / 1000.0 / frames) << " ms per frame, on " << OS::get_singleton()->get_processor_count() << " cores");
+	}
+}
+
+TEST_CASE_BENCHMARK("[AnimationTree][Benchmark] Process 500 trees") {
+	const int tree_count = 500;
+	const int frames = 100;
+
+	// Trees sharing a graph are blended one after the other, trees with their own graph in parallel.
+	for (int shared = 0; shared < 2; shared++) {
+		TestSceneTree::HeadlessSceneTree headless;
+		SceneTree *tree = headless.tree;
+
+		Ref<AnimationNode> shared_graph = create_blend_graph();
+		LocalVector<AnimationTree *> animation_trees;
+		for (int i = 0; i < tree_count; i++) {
+			Node3D *target = nullptr;
+			animation_trees.push_back(create_animation_tree(tree->get_root(), shared ? shared_graph : Ref<AnimationNode>(create_blend_graph()), false, 0.5, target));
+		}
+
+		for (int threaded = 0; threaded < 2; threaded++) {
+			for (uint32_t i = 0; i < animation_trees.size(); i++) {
+				animation_trees[i]->set_process_threaded(threaded);
+			}
+
+			uint64_t begin = OS::get_singleton()->get_ticks_usec();
+			for (int i = 0; i < frames; i++) {
+				tree->process(1.0 / 60.0);
+			}
+			uint64_t usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+			MESSAGE((shared ? "Shared graph, " : "Own graphs, ") << (threaded ? "threaded: " : "serial: ") << (usec / 1000.0 / frames) << " ms per frame, on " << OS::get_singleton()->get_processor_count() << " cores");
+		}
+	}
+}
+
+} // namespace TestAnimationPlayer
+
+#endif // TEST_ANIMATION_PLAYER_H
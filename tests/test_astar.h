@@ -32,8 +32,11 @@
 #define TEST_ASTAR_H
 
 #include "core/math/a_star.h"
+#include "core/math/a_star_grid_2d.h"
 #include "core/math/math_funcs.h"
+#include "core/math/random_pcg.h"
 #include "core/os/os.h"
+#include "core/templates/thread_work_pool.h"
 
 #include <math.h>
 #include <stdio.h>
@@ -362,6 +365,465 @@ TEST_CASE("[Stress][AStar] Find paths") {
 		CHECK_MESSAGE(match, "Found all paths.");
 	}
 }
+
+TEST_CASE("[AStar] Graph changes between queries") {
+	AStar a;
+	a.add_point(1, Vector3(0, 0, 0));
+	a.add_point(2, Vector3(1, 0, 0));
+	a.add_point(3, Vector3(2, 0, 0));
+	a.add_point(4, Vector3(1, 1, 0));
+	a.connect_points(1, 2);
+	a.connect_points(2, 3);
+	a.connect_points(1, 4);
+	a.connect_points(4, 3);
+
+	CHECK(a.get_id_path(1, 3).size() == 3);
+	CHECK(a.get_id_path(1, 3)[1] == 2);
+
+	a.set_point_disabled(2);
+	CHECK(a.get_id_path(1, 3)[1] == 4);
+	a.set_point_disabled(2, false);
+	CHECK(a.get_id_path(1, 3)[1] == 2);
+
+	a.set_point_weight_scale(2, 10);
+	CHECK(a.get_id_path(1, 3)[1] == 4);
+	a.set_point_weight_scale(4, 20);
+	CHECK(a.get_id_path(1, 3)[1] == 2);
+	a.set_point_weight_scale(2, 1);
+	a.set_point_weight_scale(4, 1);
+
+	a.set_point_disabled(3);
+	CHECK(a.get_id_path(1, 3).is_empty());
+	CHECK(a.get_id_path(3, 1).size() == 3);
+	a.set_point_disabled(3, false);
+	CHECK(a.get_id_path(1, 3).size() == 3);
+
+	a.set_point_position(4, Vector3(1, 0, 0));
+	a.set_point_position(2, Vector3(1, 5, 0));
+	CHECK(a.get_point_path(1, 3)[1] == Vector3(1, 0, 0));
+
+	a.remove_point(4);
+	CHECK(a.get_id_path(1, 3)[1] == 2);
+	a.disconnect_points(2, 3);
+	CHECK(a.get_id_path(1, 3).is_empty());
+	a.set_point_disabled(3);
+	a.connect_points(2, 3);
+	CHECK(a.get_id_path(1, 3).is_empty());
+}
+
+struct ConcurrentQueries {
+	AStar2D *astar = nullptr;
+	LocalVector<int> from;
+	LocalVector<int> to;
+	LocalVector<Vector<Vector2>> paths;
+
+	void find_path(uint32_t p_index, void *p_userdata) {
+		paths[p_index] = astar->get_point_path(from[p_index], to[p_index]);
+	}
+};
+
+static void build_grid_graph(AStar2D &r_astar, int p_size, int p_solid_percent) {
+	r_astar.reserve_space(p_size * p_size);
+	for (int y = 0; y < p_size; y++) {
+		for (int x = 0; x < p_size; x++) {
+			r_astar.add_point(y * p_size + x, Vector2(x, y));
+			if (Math::rand() % 100 < (uint32_t)p_solid_percent) {
+				r_astar.set_point_disabled(y * p_size + x);
+			}
+			if (x > 0) {
+				r_astar.connect_points(y * p_size + x, y * p_size + x - 1);
+			}
+			if (y > 0) {
+				r_astar.connect_points(y * p_size + x, (y - 1) * p_size + x);
+			}
+		}
+	}
+}
+
+TEST_CASE("[AStar] Concurrent queries") {
+	const int size = 48;
+	Math::seed(1);
+	AStar2D astar;
+	build_grid_graph(astar, size, 20);
+
+	ConcurrentQueries queries;
+	queries.astar = &astar;
+	for (int i = 0; i < 64; i++) {
+		queries.from.push_back(Math::rand() % (size * size));
+		queries.to.push_back(Math::rand() % (size * size));
+	}
+	queries.paths.resize(queries.from.size());
+
+	ThreadWorkPool work_pool;
+	work_pool.init(4);
+	work_pool.do_work(queries.from.size(), &queries, &ConcurrentQueries::find_path, (void *)nullptr);
+	work_pool.finish();
+
+	for (uint32_t i = 0; i < queries.from.size(); i++) {
+		CHECK(queries.paths[i] == astar.get_point_path(queries.from[i], queries.to[i]));
+	}
+}
+
+TEST_CASE_BENCHMARK("[AStar][Benchmark] Find paths on a large graph") {
+	const int size = 512;
+	Math::seed(2);
+	AStar2D astar;
+	build_grid_graph(astar, size, 20);
+
+	ConcurrentQueries queries;
+	queries.astar = &astar;
+	for (int i = 0; i < 128; i++) {
+		queries.from.push_back(Math::rand() % (size * size));
+		queries.to.push_back(Math::rand() % (size * size));
+	}
+	queries.paths.resize(queries.from.size());
+
+	// The first query builds the compact graph.
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	astar.get_point_path(0, 1);
+	MESSAGE("Graph snapshot: ", ((OS::get_singleton()->get_ticks_usec() - begin) / 1000), " ms.");
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (uint32_t i = 0; i < queries.from.size(); i++) {
+		queries.find_path(i, nullptr);
+	}
+	MESSAGE("128 paths on one thread: ", ((OS::get_singleton()->get_ticks_usec() - begin) / 1000), " ms.");
+
+	ThreadWorkPool work_pool;
+	work_pool.init();
+	begin = OS::get_singleton()->get_ticks_usec();
+	work_pool.do_work(queries.from.size(), &queries, &ConcurrentQueries::find_path, (void *)nullptr);
+	MESSAGE("128 paths on ", work_pool.get_thread_count(), " threads: ", ((OS::get_singleton()->get_ticks_usec() - begin) / 1000), " ms.");
+	work_pool.finish();
+}
+
+static real_t get_path_length(const Vector<Vector2> &p_path) {
+	real_t length = 0;
+	for (int i = 1; i < p_path.size(); i++) {
+		length += p_path[i - 1].distance_to(p_path[i]);
+	}
+	return length;
+}
+
+TEST_CASE("[AStarGrid2D] Diagonal modes") {
+	Ref<AStarGrid2D> a;
+	a.instantiate();
+	a->set_size(Vector2i(5, 5));
+
+	CHECK(a->get_id_path(Vector2i(0, 0), Vector2i(4, 4)).size() == 5);
+	CHECK(a->get_id_path(Vector2i(2, 2), Vector2i(2, 2)).size() == 1);
+
+	a->set_diagonal_mode(AStarGrid2D::DIAGONAL_MODE_NEVER);
+	TypedArray<Vector2i> path = a->get_id_path(Vector2i(0, 0), Vector2i(4, 4));
+	CHECK(path.size() == 9);
+	for (int i = 1; i < path.size(); i++) {
+		const Vector2i step = Vector2i(path[i]) - Vector2i(path[i - 1]);
+		CHECK(ABS(step.x) + ABS(step.y) == 1);
+	}
+
+	// Corner cutting around a single solid cell.
+	a->set_size(Vector2i(2, 2));
+	a->set_point_solid(Vector2i(1, 0));
+	a->set_diagonal_mode(AStarGrid2D::DIAGONAL_MODE_ALWAYS);
+	CHECK(a->get_id_path(Vector2i(0, 0), Vector2i(1, 1)).size() == 2);
+	a->set_diagonal_mode(AStarGrid2D::DIAGONAL_MODE_AT_LEAST_ONE_WALKABLE);
+	CHECK(a->get_id_path(Vector2i(0, 0), Vector2i(1, 1)).size() == 2);
+	a->set_diagonal_mode(AStarGrid2D::DIAGONAL_MODE_ONLY_IF_NO_OBSTACLES);
+	CHECK(a->get_id_path(Vector2i(0, 0), Vector2i(1, 1)).size() == 3);
+}
+
+TEST_CASE("[AStarGrid2D] Solid cells and weights") {
+	Ref<AStarGrid2D> a;
+	a.instantiate();
+	a->set_size(Vector2i(10, 10));
+	a->set_offset(Vector2(5, 5));
+	a->set_cell_size(Vector2(2, 2));
+	a->set_diagonal_mode(AStarGrid2D::DIAGONAL_MODE_NEVER);
+
+	CHECK(a->get_point_position(Vector2i(3, 4)).is_equal_approx(Vector2(11, 13)));
+
+	// A wall with a single gap at the bottom.
+	a->fill_solid_region(Rect2i(5, 0, 1, 9));
+	CHECK(a->is_point_solid(Vector2i(5, 8)));
+	CHECK_FALSE(a->is_point_solid(Vector2i(5, 9)));
+
+	Vector<Vector2> path = a->get_point_path(Vector2i(0, 0), Vector2i(9, 0));
+	CHECK(path.size() == 28);
+	CHECK(path[0].is_equal_approx(Vector2(5, 5)));
+	CHECK(path[path.size() - 1].is_equal_approx(Vector2(23, 5)));
+
+	// Blocking the gap or an endpoint leaves no path.
+	a->set_point_solid(Vector2i(5, 9));
+	CHECK(a->get_point_path(Vector2i(0, 0), Vector2i(9, 0)).is_empty());
+	a->set_point_solid(Vector2i(5, 9), false);
+	a->set_point_solid(Vector2i(9, 0));
+	CHECK(a->get_point_path(Vector2i(0, 0), Vector2i(9, 0)).is_empty());
+	a->set_point_solid(Vector2i(9, 0), false);
+
+	// An expensive row is walked around.
+	a->fill_solid_region(Rect2i(5, 0, 1, 10), false);
+	a->fill_weight_scale_region(Rect2i(1, 0, 8, 1), 10);
+	CHECK(a->get_point_weight_scale(Vector2i(4, 0)) == 10);
+	CHECK(a->get_id_path(Vector2i(0, 0), Vector2i(9, 0)).size() == 12);
+
+	ERR_PRINT_OFF;
+	CHECK(a->get_id_path(Vector2i(0, 0), Vector2i(10, 0)).is_empty());
+	a->set_point_weight_scale(Vector2i(0, 0), 0.5);
+	ERR_PRINT_ON;
+	CHECK(a->get_point_weight_scale(Vector2i(0, 0)) == 1);
+}
+
+TEST_CASE("[AStarGrid2D] Jumping finds paths as short as A*") {
+	Ref<AStarGrid2D> a;
+	a.instantiate();
+	a->set_cell_size(Vector2(1, 2));
+	RandomPCG rng(1234);
+
+	for (int mode = 0; mode < AStarGrid2D::DIAGONAL_MODE_MAX; mode++) {
+		a->set_diagonal_mode((AStarGrid2D::DiagonalMode)mode);
+		bool match = true;
+		for (int test = 0; test < 200 && match; test++) {
+			const Vector2i size = Vector2i(2 + rng.rand() % 30, 2 + rng.rand() % 30);
+			a->set_size(size);
+			const uint32_t density = rng.rand() % 50;
+			for (int y = 0; y < size.y; y++) {
+				for (int x = 0; x < size.x; x++) {
+					a->set_point_solid(Vector2i(x, y), rng.rand() % 100 < density);
+				}
+			}
+			const Vector2i from = Vector2i(rng.rand() % size.x, rng.rand() % size.y);
+			const Vector2i to = Vector2i(rng.rand() % size.x, rng.rand() % size.y);
+
+			a->set_jumping_enabled(false);
+			const Vector<Vector2> astar_path = a->get_point_path(from, to);
+			a->set_jumping_enabled(true);
+			const Vector<Vector2> jump_path = a->get_point_path(from, to);
+
+			if (astar_path.size() == 0 || jump_path.size() == 0) {
+				match = astar_path.size() == jump_path.size();
+			} else {
+				match = Math::is_equal_approx(get_path_length(astar_path), get_path_length(jump_path));
+				// Jump points are expanded, so consecutive points must be neighbors.
+				for (int i = 1; i < jump_path.size() && match; i++) {
+					const Vector2 step = (jump_path[i] - jump_path[i - 1]) / a->get_cell_size();
+					match = MAX(Math::abs(step.x), Math::abs(step.y)) == 1;
+				}
+			}
+			CHECK_MESSAGE(match, vformat("Paths match with diagonal mode %d.", mode));
+		}
+	}
+}
+
+TEST_CASE("[AStarGrid2D] Batched paths") {
+	Ref<AStarGrid2D> a;
+	a.instantiate();
+	a->set_size(Vector2i(64, 64));
+	a->set_jumping_enabled(true);
+	a->fill_solid_region(Rect2i(10, 0, 1, 60));
+	a->fill_solid_region(Rect2i(20, 4, 1, 60));
+
+	TypedArray<Vector2i> from;
+	TypedArray<Vector2i> to;
+	for (int i = 0; i < 16; i++) {
+		from.push_back(Vector2i(i, i));
+		to.push_back(Vector2i(63 - i, 63 - i * 2));
+	}
+	from.push_back(Vector2i(10, 10)); // Solid.
+	to.push_back(Vector2i(0, 0));
+
+	Array paths = a->get_point_paths(from, to);
+	REQUIRE(paths.size() == from.size());
+	for (int i = 0; i < from.size(); i++) {
+		CHECK(PackedVector2Array(paths[i]) == a->get_point_path(from[i], to[i]));
+	}
+	CHECK(PackedVector2Array(paths[16]).is_empty());
+
+	// Later batches run on the same workers.
+	a->set_point_solid(Vector2i(15, 15));
+	Array more_paths = a->get_point_paths(from, to);
+	REQUIRE(more_paths.size() == from.size());
+	for (int i = 0; i < from.size(); i++) {
+		CHECK(PackedVector2Array(more_paths[i]) == a->get_point_path(from[i], to[i]));
+	}
+	CHECK(PackedVector2Array(more_paths[15]).is_empty());
+
+	ERR_PRINT_OFF;
+	to.push_back(Vector2i(0, 0));
+	CHECK(a->get_point_paths(from, to).is_empty());
+	ERR_PRINT_ON;
+}
+
+TEST_CASE("[AStarGrid2D] Hierarchical paths on a large grid") {
+	const int grid_size = 1024;
+	Ref<AStarGrid2D> grid;
+	Ref<AStarGrid2D> hierarchical;
+	grid.instantiate();
+	hierarchical.instantiate();
+	hierarchical->set_cluster_size(32);
+	CHECK(hierarchical->get_cluster_size() == 32);
+
+	// Rooms separated by walls with a few doors.
+	Ref<AStarGrid2D> grids[2] = { grid, hierarchical };
+	for (int i = 0; i < 2; i++) {
+		grids[i]->set_size(Vector2i(grid_size, grid_size));
+		grids[i]->set_diagonal_mode(AStarGrid2D::DIAGONAL_MODE_ONLY_IF_NO_OBSTACLES);
+		for (int wall = 128; wall < grid_size; wall += 128) {
+			grids[i]->fill_solid_region(Rect2i(wall, 0, 1, grid_size));
+			grids[i]->fill_solid_region(Rect2i(0, wall, grid_size, 1));
+			for (int door = (wall * 7) % 64; door < grid_size; door += 64) {
+				grids[i]->fill_solid_region(Rect2i(wall, door, 1, 4), false);
+				grids[i]->fill_solid_region(Rect2i(door, wall, 4, 1), false);
+			}
+		}
+	}
+
+	TypedArray<Vector2i> from;
+	TypedArray<Vector2i> to;
+	from.push_back(Vector2i(0, 0));
+	to.push_back(Vector2i(grid_size - 1, grid_size - 1));
+	from.push_back(Vector2i(1000, 10));
+	to.push_back(Vector2i(20, 1000));
+	from.push_back(Vector2i(500, 500));
+	to.push_back(Vector2i(510, 900));
+	from.push_back(Vector2i(300, 700));
+	to.push_back(Vector2i(310, 705)); // In the same cluster, solved without the hierarchy.
+
+	for (int i = 0; i < from.size(); i++) {
+		const TypedArray<Vector2i> path = hierarchical->get_id_path(from[i], to[i]);
+		REQUIRE(path.size() > 1);
+		CHECK(Vector2i(path[0]) == Vector2i(from[i]));
+		CHECK(Vector2i(path[path.size() - 1]) == Vector2i(to[i]));
+
+		bool valid = true;
+		for (int j = 1; j < path.size(); j++) {
+			const Vector2i prev = path[j - 1];
+			const Vector2i step = Vector2i(path[j]) - prev;
+			valid = valid && MAX(ABS(step.x), ABS(step.y)) == 1 && !hierarchical->is_point_solid(path[j]);
+			if (step.x && step.y) {
+				valid = valid && !hierarchical->is_point_solid(prev + Vector2i(step.x, 0)) && !hierarchical->is_point_solid(prev + Vector2i(0, step.y));
+			}
+		}
+		CHECK(valid);
+
+		// Paths through the cluster entrances are close to the shortest one.
+		const real_t shortest = get_path_length(grid->get_point_path(from[i], to[i]));
+		const real_t length = get_path_length(hierarchical->get_point_path(from[i], to[i]));
+		CHECK(length >= shortest - CMP_EPSILON);
+		CHECK(length <= shortest * 1.25);
+	}
+
+	// Batched queries find the same paths.
+	const Array paths = hierarchical->get_point_paths(from, to);
+	REQUIRE(paths.size() == from.size());
+	for (int i = 0; i < from.size(); i++) {
+		CHECK(Vector<Vector2>(paths[i]) == hierarchical->get_point_path(from[i], to[i]));
+	}
+
+	// The entrances are found again after the grid changed.
+	const Vector2i target = Vector2i(900, 900);
+	hierarchical->fill_solid_region(Rect2i(890, 890, 21, 21));
+	hierarchical->fill_solid_region(Rect2i(891, 891, 19, 19), false);
+	CHECK(hierarchical->get_id_path(Vector2i(0, 0), target).is_empty());
+	hierarchical->set_point_solid(Vector2i(890, 900), false);
+	const TypedArray<Vector2i> path = hierarchical->get_id_path(Vector2i(0, 0), target);
+	CHECK(Vector2i(path[path.size() - 1]) == target);
+	CHECK(path.has(Vector2i(890, 900)));
+}
+
+TEST_CASE_BENCHMARK("[AStarGrid2D][Benchmark] Find a path on a large grid") {
+	const int grid_size = 1024;
+	RandomPCG rng(4321);
+	Ref<AStarGrid2D> grid;
+	grid.instantiate();
+	grid->set_size(Vector2i(grid_size, grid_size));
+	grid->set_diagonal_mode(AStarGrid2D::DIAGONAL_MODE_ONLY_IF_NO_OBSTACLES);
+	for (int y = 0; y < grid_size; y++) {
+		for (int x = 0; x < grid_size; x++) {
+			grid->set_point_solid(Vector2i(x, y), rng.rand() % 100 < 20);
+		}
+	}
+	const Vector2i from = Vector2i(0, 0);
+	const Vector2i to = Vector2i(grid_size - 1, grid_size - 1);
+	grid->set_point_solid(from, false);
+	grid->set_point_solid(to, false);
+
+	// The same grid as a graph, connecting the cells the same way AStarGrid2D does.
+	AStar2D graph;
+	graph.reserve_space(grid_size * grid_size);
+	for (int y = 0; y < grid_size; y++) {
+		for (int x = 0; x < grid_size; x++) {
+			graph.add_point(y * grid_size + x, Vector2(x, y));
+		}
+	}
+	for (int y = 0; y < grid_size; y++) {
+		for (int x = 0; x < grid_size; x++) {
+			if (grid->is_point_solid(Vector2i(x, y))) {
+				continue;
+			}
+			const bool right = x + 1 < grid_size && !grid->is_point_solid(Vector2i(x + 1, y));
+			const bool down = y + 1 < grid_size && !grid->is_point_solid(Vector2i(x, y + 1));
+			if (right) {
+				graph.connect_points(y * grid_size + x, y * grid_size + x + 1);
+			}
+			if (down) {
+				graph.connect_points(y * grid_size + x, (y + 1) * grid_size + x);
+			}
+			if (right && down && !grid->is_point_solid(Vector2i(x + 1, y + 1))) {
+				graph.connect_points(y * grid_size + x, (y + 1) * grid_size + x + 1);
+			}
+			if (x > 0 && down && !grid->is_point_solid(Vector2i(x - 1, y)) && !grid->is_point_solid(Vector2i(x - 1, y + 1))) {
+				graph.connect_points(y * grid_size + x, (y + 1) * grid_size + x - 1);
+			}
+		}
+	}
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	const Vector<Vector2> graph_path = graph.get_point_path(0, grid_size * grid_size - 1);
+	const uint64_t graph_time = OS::get_singleton()->get_ticks_usec() - begin;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	const Vector<Vector2> grid_path = grid->get_point_path(from, to);
+	const uint64_t grid_time = OS::get_singleton()->get_ticks_usec() - begin;
+
+	grid->set_jumping_enabled(true);
+	begin = OS::get_singleton()->get_ticks_usec();
+	const Vector<Vector2> jump_path = grid->get_point_path(from, to);
+	const uint64_t jump_time = OS::get_singleton()->get_ticks_usec() - begin;
+
+	MESSAGE("AStar2D: ", (graph_time / 1000), " ms, AStarGrid2D: ", (grid_time / 1000), " ms, AStarGrid2D with jumping: ", (jump_time / 1000), " ms.");
+	CHECK(Math::is_equal_approx(get_path_length(graph_path), get_path_length(grid_path)));
+	CHECK(Math::is_equal_approx(get_path_length(graph_path), get_path_length(jump_path)));
+
+	grid->set_jumping_enabled(false);
+	grid->set_cluster_size(32);
+	begin = OS::get_singleton()->get_ticks_usec();
+	const Vector<Vector2> hierarchical_path = grid->get_point_path(from, to);
+	const uint64_t build_time = OS::get_singleton()->get_ticks_usec() - begin;
+	begin = OS::get_singleton()->get_ticks_usec();
+	grid->get_point_path(from, to);
+	const uint64_t hierarchical_time = OS::get_singleton()->get_ticks_usec() - begin;
+	MESSAGE("AStarGrid2D with clusters: ", (hierarchical_time / 1000), " ms, plus ", (build_time / 1000), " ms to find the entrances.");
+	CHECK(get_path_length(hierarchical_path) <= get_path_length(grid_path) * 1.25);
+	grid->set_cluster_size(0);
+	grid->set_jumping_enabled(true);
+
+	// Many agents at once.
+	TypedArray<Vector2i> batch_from;
+	TypedArray<Vector2i> batch_to;
+	for (int i = 0; i < 64; i++) {
+		batch_from.push_back(Vector2i(rng.rand() % grid_size, rng.rand() % grid_size));
+		batch_to.push_back(Vector2i(rng.rand() % grid_size, rng.rand() % grid_size));
+	}
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < batch_from.size(); i++) {
+		grid->get_point_path(batch_from[i], batch_to[i]);
+	}
+	const uint64_t serial_time = OS::get_singleton()->get_ticks_usec() - begin;
+	begin = OS::get_singleton()->get_ticks_usec();
+	grid->get_point_paths(batch_from, batch_to);
+	const uint64_t batch_time = OS::get_singleton()->get_ticks_usec() - begin;
+	MESSAGE("64 paths one by one: ", (serial_time / 1000), " ms, batched: ", (batch_time / 1000), " ms.");
+}
 } // namespace TestAStar
 
 #endif // TEST_ASTAR_H
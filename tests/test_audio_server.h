@@ -0,0 +1,390 @@
+/*************************************************************************/
+/*  test_audio_server.h                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_AUDIO_SERVER_H
+#define TEST_AUDIO_SERVER_H
+
+#include "core/config/project_settings.h"
+#include "core/os/os.h"
+#include "servers/audio/audio_driver_dummy.h"
+#include "servers/audio/audio_stream.h"
+#include "servers/audio/effects/audio_effect_amplify.h"
+#include "servers/audio/effects/audio_effect_eq.h"
+#include "servers/audio/effects/audio_effect_reverb.h"
+#include "servers/audio_server.h"
+
+#include "tests/test_macros.h"
+
+namespace TestAudioServer {
+
+// Mixes audio without a thread through the dummy driver.
+static AudioServer *create_audio_server(bool p_threaded) {
+	GLOBAL_DEF("audio/driver/mix_rate", 44100);
+	GLOBAL_DEF("audio/driver/output_latency", 15);
+	ProjectSettings::get_singleton()->set_setting("audio/buses/threaded_processing", p_threaded);
+
+	AudioDriverDummy *driver = AudioDriverDummy::get_dummy_singleton();
+	driver->set_use_threads(false);
+	driver->init();
+	driver->set_singleton();
+
+	AudioServer *audio_server = memnew(AudioServer);
+	audio_server->init();
+	return audio_server;
+}
+
+static void destroy_audio_server(AudioServer *p_audio_server) {
+	p_audio_server->finish();
+	memdelete(p_audio_server);
+	AudioDriverDummy::get_dummy_singleton()->set_use_threads(true);
+}
+
+static void add_bus(AudioServer *p_audio_server, const String &p_name, const String &p_send) {
+	p_audio_server->add_bus();
+	int bus = p_audio_server->get_bus_count() - 1;
+	p_audio_server->set_bus_name(bus, p_name);
+	p_audio_server->set_bus_send(bus, p_send);
+}
+
+struct ConstantSource {
+	int bus = 0;
+	float value = 0;
+};
+
+static void mix_constant(void *p_userdata) {
+	ConstantSource *source = (ConstantSource *)p_userdata;
+	AudioServer *audio_server = AudioServer::get_singleton();
+	AudioFrame *buffer = audio_server->thread_get_channel_mix_buffer(source->bus, 0);
+	for (int i = 0; i < audio_server->thread_get_mix_buffer_size(); i++) {
+		buffer[i] += AudioFrame(source->value, source->value);
+	}
+}
+
+static float get_output_sample(int32_t p_sample) {
+	return p_sample / float(1u << 31);
+}
+
+TEST_CASE("[AudioServer] Buses are mixed following their sends") {
+	for (int threaded = 0; threaded < 2; threaded++) {
+		AudioServer *audio_server = create_audio_server(threaded);
+
+		// "Chained" sends to "Effects", so it must be processed first.
+		// "Chained" and "Other" both have effects and are processed together.
+		add_bus(audio_server, "Effects", "Master");
+		add_bus(audio_server, "Chained", "Effects");
+		add_bus(audio_server, "Other", "Master");
+		audio_server->set_bus_volume_db(1, Math::linear2db(0.5));
+		for (int i = 2; i < 4; i++) {
+			Ref<AudioEffectAmplify> amplify;
+			amplify.instantiate();
+			audio_server->add_bus_effect(i, amplify);
+		}
+
+		ConstantSource chained;
+		chained.bus = 2;
+		chained.value = 0.25;
+		ConstantSource other;
+		other.bus = 3;
+		other.value = 0.1;
+		audio_server->add_callback(mix_constant, &chained);
+		audio_server->add_callback(mix_constant, &other);
+
+		int32_t output[64 * 2];
+		AudioDriverDummy::get_dummy_singleton()->mix_audio(64, output);
+
+		CHECK_MESSAGE(
+				Math::is_equal_approx(get_output_sample(output[0]), 0.225f, 0.0001f),
+				"Sends should be applied after the sending bus has been processed.");
+		CHECK(Math::is_equal_approx(get_output_sample(output[63 * 2 + 1]), 0.225f, 0.0001f));
+
+		audio_server->remove_callback(mix_constant, &chained);
+		audio_server->remove_callback(mix_constant, &other);
+		destroy_audio_server(audio_server);
+	}
+}
+
+static void mix_step() {
+	Vector<int32_t> output;
+	output.resize(AudioServer::get_singleton()->thread_get_mix_buffer_size() * 2);
+	AudioDriverDummy::get_dummy_singleton()->mix_audio(output.size() / 2, output.ptrw());
+}
+
+// Records the memory in use while the pool is busy, to see whether dispatching allocated.
+struct BusWorkMemoryProbe {
+	uint64_t usage_during_work = 0;
+
+	void mix_bus(uint32_t p_index, bool p_solo_mode) {
+		usage_during_work = Memory::get_mem_usage();
+	}
+};
+
+TEST_CASE("[AudioServer] Bus work is dispatched without allocating on the mix thread") {
+	ThreadWorkPool pool;
+	pool.init(1);
+
+	// Same work signature as the bus mixing.
+	BusWorkMemoryProbe probe;
+	const uint64_t usage_before = Memory::get_mem_usage();
+	pool.do_work(1, &probe, &BusWorkMemoryProbe::mix_bus, false);
+	CHECK(probe.usage_during_work == usage_before);
+	CHECK(Memory::get_mem_usage() == usage_before);
+	CHECK_FALSE(pool.is_working());
+
+	pool.finish();
+}
+
+TEST_CASE("[AudioServer] Voices over the limit become virtual") {
+	ProjectSettings::get_singleton()->set_setting("audio/voices/max_real_voices", 2);
+	AudioServer *audio_server = create_audio_server(false);
+
+	AudioServer::Voice voices[4];
+	for (int i = 0; i < 4; i++) {
+		voices[i].playing = true;
+		voices[i].volume_db.set(-10.0 * i);
+		audio_server->voice_add(&voices[i]);
+	}
+	voices[3].priority.set(1);
+
+	mix_step();
+	CHECK_MESSAGE(!voices[3].is_virtual, "Voices with a higher priority should be real.");
+	CHECK_MESSAGE(!voices[0].is_virtual, "The loudest voices should be real.");
+	CHECK(voices[1].is_virtual);
+	CHECK(voices[2].is_virtual);
+	CHECK(audio_server->get_real_voice_count() == 2);
+	CHECK(audio_server->get_virtual_voice_count() == 2);
+
+	voices[1].volume_db.set(1.0);
+	mix_step();
+	CHECK_MESSAGE(!voices[0].is_virtual, "Voices with similar volumes should not be swapped.");
+	CHECK(voices[1].is_virtual);
+
+	voices[1].volume_db.set(10.0);
+	mix_step();
+	CHECK(voices[0].is_virtual);
+	CHECK(!voices[1].is_virtual);
+
+	voices[3].volume_db.set(-100.0);
+	mix_step();
+	CHECK_MESSAGE(voices[3].is_virtual, "Inaudible voices should be virtual.");
+	CHECK_MESSAGE(!voices[0].is_virtual, "Virtual voices should be revived when a real voice becomes inaudible.");
+	CHECK(audio_server->get_real_voice_count() == 2);
+
+	voices[1].playing = false;
+	mix_step();
+	CHECK_MESSAGE(!voices[2].is_virtual, "Voices that stopped playing should not count.");
+	CHECK(audio_server->get_real_voice_count() == 2);
+	CHECK(audio_server->get_virtual_voice_count() == 1);
+
+	for (int i = 0; i < 4; i++) {
+		audio_server->voice_remove(&voices[i]);
+	}
+	destroy_audio_server(audio_server);
+	ProjectSettings::get_singleton()->set_setting("audio/voices/max_real_voices", 0);
+}
+
+struct SineVoices {
+	int bus_count = 0;
+	LocalVector<float> phases;
+};
+
+static void mix_sine_voices(void *p_userdata) {
+	SineVoices *voices = (SineVoices *)p_userdata;
+	AudioServer *audio_server = AudioServer::get_singleton();
+	int frames = audio_server->thread_get_mix_buffer_size();
+
+	for (uint32_t v = 0; v < voices->phases.size(); v++) {
+		AudioFrame *buffer = audio_server->thread_get_channel_mix_buffer(1 + v % voices->bus_count, 0);
+		float phase = voices->phases[v];
+		float increment = (110.0 + v) / audio_server->get_mix_rate();
+
+		for (int i = 0; i < frames; i++) {
+			float sample = Math::sin(phase * Math_TAU) * 0.005;
+			buffer[i] += AudioFrame(sample, sample);
+			phase += increment;
+			if (phase >= 1.0) {
+				phase -= 1.0;
+			}
+		}
+
+		voices->phases[v] = phase;
+	}
+}
+
+// Decodes a ramp where each sample is its own frame index, at 1000 Hz.
+class AudioStreamPlaybackRamp : public AudioStreamPlaybackStreamed {
+	uint32_t frame = 0;
+
+protected:
+	virtual int _decode(AudioFrame *p_buffer, int p_frames) override {
+		int count = MIN(p_frames, int(length - frame));
+		for (int i = 0; i < count; i++) {
+			p_buffer[i] = AudioFrame(frame + i, frame + i);
+		}
+		frame += count;
+		return count;
+	}
+	virtual void _decoder_seek(uint32_t p_frame) override { frame = p_frame; }
+
+	virtual float _get_length() const override { return length / 1000.0; }
+	virtual bool _has_loop() const override { return loop; }
+	virtual float _get_loop_offset() const override { return loop_offset; }
+
+	virtual float get_stream_sampling_rate() override { return 1000; }
+
+public:
+	uint32_t length = 1000;
+	bool loop = false;
+	float loop_offset = 0;
+
+	void begin(bool p_streaming) { _stream_begin(p_streaming); }
+	// Decodes like the AudioServer decoder thread would, when there is none.
+	bool pump() { return _fill_stream_buffer(); }
+	float read() {
+		AudioFrame frame;
+		_mix_internal(&frame, 1);
+		return frame.l;
+	}
+
+	~AudioStreamPlaybackRamp() { _stream_end(); }
+};
+
+TEST_CASE("[AudioStreamPlaybackStreamed] Decoding while mixing") {
+	Ref<AudioStreamPlaybackRamp> playback = memnew(AudioStreamPlaybackRamp);
+	playback->begin(false);
+	CHECK_FALSE(playback->is_streaming());
+
+	// Starting fills the resampler with the first 256 frames.
+	playback->start(0.5);
+	CHECK(playback->read() == 756);
+	CHECK(Math::is_equal_approx(playback->get_playback_position(), 0.757f));
+
+	playback->start(0.875);
+	CHECK_MESSAGE(!playback->is_playing(), "Playback should stop at the end of the stream.");
+
+	playback->loop = true;
+	playback->loop_offset = 0.25;
+	playback->start(0.875);
+	CHECK(playback->is_playing());
+	CHECK(playback->get_loop_count() == 1);
+	CHECK_MESSAGE(playback->read() == 381, "Playback should continue from the loop offset.");
+}
+
+TEST_CASE("[AudioStreamPlaybackStreamed] Decoding ahead of the mix") {
+	// Without an AudioServer there is no decoder thread, the test decodes instead.
+	Ref<AudioStreamPlaybackRamp> playback = memnew(AudioStreamPlaybackRamp);
+	playback->length = 100000;
+	playback->begin(true);
+	CHECK(playback->is_streaming());
+
+	// The beginning is decoded ahead of time, until the buffer is full.
+	CHECK(playback->pump());
+	CHECK_FALSE_MESSAGE(playback->pump(), "Nothing should be decoded while the buffer is full.");
+	playback->start(0);
+	CHECK(playback->read() == 256);
+
+	// Seeking drops what was decoded, the mixer outputs silence until the decoder catches up.
+	playback->seek(50);
+	CHECK(playback->read() == 0);
+	CHECK(playback->pump());
+	CHECK_MESSAGE(playback->read() == 50000, "The first frame after a seek should be the one seeked to.");
+	CHECK(playback->read() == 50001);
+
+	// The decoder loops on its own, the mixer only counts the loops.
+	playback->loop = true;
+	playback->loop_offset = 10;
+	playback->seek(99.5);
+	CHECK(playback->pump());
+	float value = 0;
+	for (int i = 0; i < 500; i++) {
+		value = playback->read();
+	}
+	CHECK(value == 99999);
+	CHECK(playback->get_loop_count() == 0);
+	CHECK_MESSAGE(playback->read() == 10000, "Playback should continue from the loop offset.");
+	CHECK(playback->get_loop_count() == 1);
+}
+
+TEST_CASE("[AudioStreamPlaybackStreamed] Streaming playbacks use the stream decoder thread") {
+	AudioServer *audio_server = create_audio_server(false);
+
+	Ref<AudioStreamPlaybackRamp> streamed = memnew(AudioStreamPlaybackRamp);
+	streamed->begin(true);
+	CHECK(streamed->is_streaming());
+
+	Ref<AudioStreamPlaybackRamp> mixed = memnew(AudioStreamPlaybackRamp);
+	mixed->begin(false);
+	CHECK_FALSE(mixed->is_streaming());
+
+	// Removed from the decoder thread when freed, before the server finishes.
+	streamed.unref();
+	mixed.unref();
+	destroy_audio_server(audio_server);
+}
+
+TEST_CASE_BENCHMARK("[AudioServer][Benchmark] Mix 200 voices on 8 buses with reverb and EQ") {
+	const int bus_count = 8;
+	const int voice_count = 200;
+	const float seconds = 10.0;
+
+	for (int threaded = 0; threaded < 2; threaded++) {
+		AudioServer *audio_server = create_audio_server(threaded);
+
+		for (int i = 0; i < bus_count; i++) {
+			add_bus(audio_server, vformat("Bus%d", i), "Master");
+			audio_server->add_bus_effect(i + 1, memnew(AudioEffectReverb));
+			audio_server->add_bus_effect(i + 1, memnew(AudioEffectEQ10));
+		}
+
+		SineVoices voices;
+		voices.bus_count = bus_count;
+		voices.phases.resize(voice_count);
+		for (int i = 0; i < voice_count; i++) {
+			voices.phases[i] = 0;
+		}
+		audio_server->add_callback(mix_sine_voices, &voices);
+
+		int frames = audio_server->get_mix_rate() * seconds;
+		Vector<int32_t> output;
+		output.resize(frames * 2);
+
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		AudioDriverDummy::get_dummy_singleton()->mix_audio(frames, output.ptrw());
+		double elapsed = (OS::get_singleton()->get_ticks_usec() - begin) / 1000000.0;
+
+		MESSAGE((threaded ? "Threaded" : "Single-threaded") << " bus processing: " << (seconds / elapsed) << "x real time");
+
+		audio_server->remove_callback(mix_sine_voices, &voices);
+		destroy_audio_server(audio_server);
+	}
+}
+
+} // namespace TestAudioServer
+
+#endif // TEST_AUDIO_SERVER_H
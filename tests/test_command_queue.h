@@ -38,6 +38,7 @@
 #include "core/os/semaphore.h"
 #include "core/os/thread.h"
 #include "core/templates/command_queue_mt.h"
+#include "core/templates/safe_refcount.h"
 #include "test_macros.h"
 
 #if !defined(NO_THREADS)
@@ -426,6 +427,63 @@ TEST_CASE("[Stress][CommandQueue] Stress test command queue") {
 	ProjectSettings::get_singleton()->set_setting(COMMAND_QUEUE_SETTING,
 			ProjectSettings::get_singleton()->property_get_revert(COMMAND_QUEUE_SETTING));
 }
+
+class ContentionState {
+public:
+	CommandQueueMT command_queue = CommandQueueMT(true);
+	SafeNumeric<uint32_t> executed;
+	SafeFlag exit;
+	uint32_t commands_per_thread = 0;
+
+	void set_transform(Transform3D t) {
+		executed.increment();
+	}
+
+	static void reader_thread_loop(void *p_state) {
+		ContentionState *state = static_cast<ContentionState *>(p_state);
+		while (!state->exit.is_set()) {
+			state->command_queue.wait_and_flush();
+		}
+		state->command_queue.flush_all();
+	}
+
+	static void writer_thread_loop(void *p_state) {
+		ContentionState *state = static_cast<ContentionState *>(p_state);
+		Transform3D tr;
+		for (uint32_t i = 0; i < state->commands_per_thread; i++) {
+			state->command_queue.push(state, &ContentionState::set_transform, tr);
+		}
+	}
+};
+
+TEST_CASE_BENCHMARK("[CommandQueue][Benchmark] Push from contending threads") {
+	const uint32_t command_count = 1 << 20;
+
+	for (int writer_count = 1; writer_count <= 8; writer_count *= 2) {
+		ContentionState state;
+		state.commands_per_thread = command_count / writer_count;
+
+		Thread reader;
+		reader.start(&ContentionState::reader_thread_loop, &state);
+
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		Thread writers[8];
+		for (int i = 0; i < writer_count; i++) {
+			writers[i].start(&ContentionState::writer_thread_loop, &state);
+		}
+		for (int i = 0; i < writer_count; i++) {
+			writers[i].wait_to_finish();
+		}
+		uint64_t push_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+		state.exit.set();
+		state.command_queue.push(&state, &ContentionState::set_transform, Transform3D()); // Wake the reader up.
+		reader.wait_to_finish();
+
+		CHECK(state.executed.get() == command_count + 1);
+		MESSAGE(writer_count << " writer threads: " << (command_count / double(MAX(push_usec, uint64_t(1)))) << " million pushes/s");
+	}
+}
 } // namespace TestCommandQueue
 
 #endif // !defined(NO_THREADS)
@@ -0,0 +1,209 @@
+/*************************************************************************/
+/*  test_cpu_particles.h                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_CPU_PARTICLES_H
+#define TEST_CPU_PARTICLES_H
+
+#include "core/os/os.h"
+#include "scene/2d/cpu_particles_2d.h"
+#include "scene/3d/cpu_particles_3d.h"
+
+#include "tests/test_macros.h"
+#include "tests/test_scene_tree.h"
+
+namespace TestCPUParticles {
+
+TEST_CASE("[CPUParticles3D] One shot emitter stops after its lifetime") {
+	TestSceneTree::HeadlessSceneTree headless;
+	CPUParticles3D *particles = memnew(CPUParticles3D);
+	// Enough particles to be split in several chunks.
+	particles->set_amount(2000);
+	particles->set_lifetime(0.5);
+	particles->set_one_shot(true);
+	particles->set_emission_shape(CPUParticles3D::EMISSION_SHAPE_BOX);
+	particles->set_emitting(true);
+	headless.tree->get_root()->add_child(particles);
+
+	for (int i = 0; i < 4; i++) {
+		headless.tree->process(0.1);
+	}
+	CHECK(particles->is_emitting());
+	for (int i = 0; i < 4; i++) {
+		headless.tree->process(0.1);
+	}
+	CHECK_FALSE(particles->is_emitting());
+}
+
+TEST_CASE("[CPUParticles2D] One shot emitter stops after its lifetime") {
+	TestSceneTree::HeadlessSceneTree headless;
+	CPUParticles2D *particles = memnew(CPUParticles2D);
+	particles->set_amount(2000);
+	particles->set_lifetime(0.5);
+	particles->set_one_shot(true);
+	particles->set_emission_shape(CPUParticles2D::EMISSION_SHAPE_RECTANGLE);
+	particles->set_emitting(true);
+	headless.tree->get_root()->add_child(particles);
+
+	for (int i = 0; i < 4; i++) {
+		headless.tree->process(0.1);
+	}
+	CHECK(particles->is_emitting());
+	for (int i = 0; i < 4; i++) {
+		headless.tree->process(0.1);
+	}
+	CHECK_FALSE(particles->is_emitting());
+}
+
+// Particles that only spawn, so they stay where the emission shape placed them.
+static Vector<float> simulate_box_3d(bool p_use_thread_work_pool, const Vector3 &p_extents) {
+	TestSceneTree::HeadlessSceneTree headless;
+	headless.tree->set_thread_work_pool_enabled(p_use_thread_work_pool);
+	CPUParticles3D *particles = memnew(CPUParticles3D);
+	particles->set_amount(2000);
+	particles->set_lifetime(0.5);
+	particles->set_lifetime_randomness(0.5);
+	particles->set_param_randomness(CPUParticles3D::PARAM_SCALE, 1.0);
+	particles->set_param(CPUParticles3D::PARAM_INITIAL_LINEAR_VELOCITY, 0.0);
+	particles->set_gravity(Vector3());
+	particles->set_emission_shape(CPUParticles3D::EMISSION_SHAPE_BOX);
+	particles->set_emission_box_extents(p_extents);
+	particles->set_emitting(true);
+	headless.tree->get_root()->add_child(particles);
+
+	Math::seed(42);
+	for (int i = 0; i < 8; i++) {
+		headless.tree->process(0.1);
+	}
+	return particles->get_particle_data();
+}
+
+static Vector<float> simulate_rect_2d(bool p_use_thread_work_pool, const Vector2 &p_extents) {
+	TestSceneTree::HeadlessSceneTree headless;
+	headless.tree->set_thread_work_pool_enabled(p_use_thread_work_pool);
+	CPUParticles2D *particles = memnew(CPUParticles2D);
+	particles->set_amount(2000);
+	particles->set_lifetime(0.5);
+	particles->set_lifetime_randomness(0.5);
+	particles->set_param_randomness(CPUParticles2D::PARAM_SCALE, 1.0);
+	particles->set_param(CPUParticles2D::PARAM_INITIAL_LINEAR_VELOCITY, 0.0);
+	particles->set_gravity(Vector2());
+	particles->set_emission_shape(CPUParticles2D::EMISSION_SHAPE_RECTANGLE);
+	particles->set_emission_rect_extents(p_extents);
+	particles->set_emitting(true);
+	headless.tree->get_root()->add_child(particles);
+
+	Math::seed(42);
+	for (int i = 0; i < 8; i++) {
+		headless.tree->process(0.1);
+	}
+	return particles->get_particle_data();
+}
+
+TEST_CASE("[CPUParticles3D] Chunks give the same particles on the worker threads and serially") {
+	const Vector3 extents(1, 2, 3);
+	const Vector<float> threaded = simulate_box_3d(true, extents);
+	const Vector<float> serial = simulate_box_3d(false, extents);
+	REQUIRE(threaded.size() == 2000 * 20);
+	CHECK(threaded == serial);
+
+	// The origin is in the last column of the 3x4 transform of each instance.
+	int active = 0;
+	int outside = 0;
+	for (int i = 0; i < 2000; i++) {
+		const Vector3 origin(threaded[i * 20 + 3], threaded[i * 20 + 7], threaded[i * 20 + 11]);
+		active += origin != Vector3();
+		outside += Math::abs(origin.x) > extents.x || Math::abs(origin.y) > extents.y || Math::abs(origin.z) > extents.z;
+	}
+	CHECK(active > 1000);
+	CHECK(outside == 0);
+}
+
+TEST_CASE("[CPUParticles2D] Chunks give the same particles on the worker threads and serially") {
+	const Vector2 extents(3, 2);
+	const Vector<float> threaded = simulate_rect_2d(true, extents);
+	const Vector<float> serial = simulate_rect_2d(false, extents);
+	REQUIRE(threaded.size() == 2000 * 16);
+	CHECK(threaded == serial);
+
+	// The origin is in the last column of the two rows of each instance.
+	int active = 0;
+	int outside = 0;
+	for (int i = 0; i < 2000; i++) {
+		const Vector2 origin(threaded[i * 16 + 3], threaded[i * 16 + 7]);
+		active += origin != Vector2();
+		outside += Math::abs(origin.x) > extents.x || Math::abs(origin.y) > extents.y;
+	}
+	CHECK(active > 1000);
+	CHECK(outside == 0);
+}
+
+TEST_CASE_BENCHMARK("[CPUParticles][Benchmark] Simulate 100000 particles") {
+	TestSceneTree::HeadlessSceneTree headless;
+
+	const int amount = 100000;
+	const int frames = 100;
+
+	CPUParticles3D *particles_3d = memnew(CPUParticles3D);
+	particles_3d->set_amount(amount);
+	particles_3d->set_emission_shape(CPUParticles3D::EMISSION_SHAPE_SPHERE);
+	particles_3d->set_param(CPUParticles3D::PARAM_DAMPING, 1.0);
+	particles_3d->set_draw_order(CPUParticles3D::DRAW_ORDER_LIFETIME);
+	particles_3d->set_emitting(true);
+	headless.tree->get_root()->add_child(particles_3d);
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int f = 0; f < frames; f++) {
+		headless.tree->process(0.016);
+	}
+	uint64_t usec = MAX(OS::get_singleton()->get_ticks_usec() - begin, uint64_t(1));
+	MESSAGE("CPUParticles3D: ", (uint64_t(amount) * frames * 1000 / usec), " particles per ms");
+	CHECK(particles_3d->is_emitting());
+	particles_3d->set_emitting(false);
+
+	CPUParticles2D *particles_2d = memnew(CPUParticles2D);
+	particles_2d->set_amount(amount);
+	particles_2d->set_emission_shape(CPUParticles2D::EMISSION_SHAPE_SPHERE);
+	particles_2d->set_param(CPUParticles2D::PARAM_DAMPING, 1.0);
+	particles_2d->set_draw_order(CPUParticles2D::DRAW_ORDER_LIFETIME);
+	particles_2d->set_emitting(true);
+	headless.tree->get_root()->add_child(particles_2d);
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int f = 0; f < frames; f++) {
+		headless.tree->process(0.016);
+	}
+	usec = MAX(OS::get_singleton()->get_ticks_usec() - begin, uint64_t(1));
+	MESSAGE("CPUParticles2D: ", (uint64_t(amount) * frames * 1000 / usec), " particles per ms");
+	CHECK(particles_2d->is_emitting());
+}
+
+} // namespace TestCPUParticles
+
+#endif // TEST_CPU_PARTICLES_H
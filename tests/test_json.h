@@ -32,8 +32,9 @@
 #define TEST_JSON_H
 
 #include "core/io/json.h"
+#include "core/os/os.h"
 
-#include "thirdparty/doctest/doctest.h"
+#include "tests/test_macros.h"
 
 namespace TestJSON {
 
@@ -146,6 +147,184 @@ TEST_CASE("[JSON] Parsing objects (dictionaries)") {
 			dictionary["empty_object"].hash() == Dictionary().hash(),
 			"The parsed JSON should contain the expected values.");
 }
+
+TEST_CASE("[JSON] Parsing strings and numbers") {
+	JSON json;
+
+	json.parse(R"(["plain", "escaped \"quotes\" and \\", "line\nbreak\ttab", "\u00e9t\u00E9", "\ud83d\ude00", "Ünïcödé", -12, 1.5e3, 123456789012345678])");
+	CHECK(json.get_error_line() == 0);
+	const Array array = json.get_data();
+	REQUIRE(array.size() == 9);
+	CHECK(array[0] == "plain");
+	CHECK(array[1] == "escaped \"quotes\" and \\");
+	CHECK(array[2] == "line\nbreak\ttab");
+	CHECK(array[3] == String::utf8("été"));
+	CHECK(String(array[4]) == String::chr(0x1f600));
+	CHECK(array[5] == String::utf8("Ünïcödé"));
+	CHECK(double(array[6]) == -12);
+	CHECK(double(array[7]) == 1500);
+	CHECK(double(array[8]) == 123456789012345678.0);
+
+	CHECK(json.parse(R"(["unterminated)") == ERR_PARSE_ERROR);
+	CHECK(json.parse(R"("\ud83d")") == ERR_PARSE_ERROR);
+	CHECK(json.parse(R"({"a": 1} 2)") == ERR_PARSE_ERROR);
+
+	CHECK(json.parse("[\n1,\n\"two\",\nthree\n]") == ERR_PARSE_ERROR);
+	CHECK(json.get_error_line() == 3);
+}
+
+TEST_CASE("[JSON] Parsing UTF-8 bytes") {
+	JSON json;
+
+	// A byte order mark is skipped.
+	CharString text = String::utf8("\xEF\xBB\xBF{\"name\": \"Montréal\", \"values\": [1, 2, 3]}").utf8();
+	PackedByteArray bytes;
+	bytes.resize(text.length());
+	memcpy(bytes.ptrw(), text.get_data(), text.length());
+
+	REQUIRE(json.parse_utf8(bytes) == OK);
+	const Dictionary dictionary = json.get_data();
+	CHECK(dictionary["name"] == String::utf8("Montréal"));
+	CHECK(Array(dictionary["values"]).size() == 3);
+
+	// Invalid UTF-8 in a string.
+	bytes = PackedByteArray();
+	bytes.push_back('"');
+	bytes.push_back(0xff);
+	bytes.push_back('"');
+	CHECK(json.parse_utf8(bytes) == ERR_PARSE_ERROR);
+}
+
+TEST_CASE("[JSON] Stringify round trip") {
+	Dictionary dictionary;
+	dictionary["name"] = String::utf8("Ünïcödé \"quoted\"\n");
+	dictionary["int"] = int64_t(-9000000000);
+	dictionary["float"] = 0.25;
+	dictionary["null"] = Variant();
+	Array array;
+	array.push_back(true);
+	array.push_back(Array());
+	array.push_back(Dictionary());
+	dictionary["array"] = array;
+
+	JSON json;
+	CHECK(json.stringify(array) == "[true,[],{}]");
+	CHECK(json.stringify(array, "\t") == "[\n\ttrue,\n\t[\n\n\t],\n\t{\n\n\t}\n]");
+
+	const String text = json.stringify(dictionary, "  ");
+	REQUIRE(json.parse(text) == OK);
+	const Dictionary parsed = json.get_data();
+	CHECK(parsed["name"] == dictionary["name"]);
+	CHECK(double(parsed["int"]) == -9000000000.0);
+	CHECK(double(parsed["float"]) == 0.25);
+	CHECK(parsed["null"] == Variant());
+	CHECK(Array(parsed["array"]).size() == 3);
+
+	const PackedByteArray bytes = json.stringify_utf8(dictionary);
+	CHECK(bytes.size() == json.stringify(dictionary).utf8().length());
+	REQUIRE(json.parse_utf8(bytes) == OK);
+	CHECK(Dictionary(json.get_data())["name"] == dictionary["name"]);
+}
+
+TEST_CASE("[JSON] Streaming values") {
+	const String stream = String::utf8("{\"id\": 1, \"text\": \"a \\\"}\\\" b\"}\n[1, [2, 3]]\n\"naïve\"\n42\n{\"id\": 2}\n");
+	CharString text = stream.utf8();
+
+	// Every chunk size splits values (and multibyte characters) at different places.
+	for (int chunk_size = 1; chunk_size <= text.length(); chunk_size++) {
+		JSON json;
+		Array values;
+		for (int from = 0; from < text.length(); from += chunk_size) {
+			PackedByteArray chunk;
+			chunk.resize(MIN(chunk_size, text.length() - from));
+			memcpy(chunk.ptrw(), text.get_data() + from, chunk.size());
+			REQUIRE(json.feed(chunk) == OK);
+			while (json.has_value()) {
+				values.push_back(json.take_value());
+			}
+		}
+
+		REQUIRE(values.size() == 5);
+		CHECK(Dictionary(values[0])["text"] == "a \"}\" b");
+		CHECK(Array(Array(values[1])[1]).size() == 2);
+		CHECK(values[2] == String::utf8("naïve"));
+		CHECK(double(values[3]) == 42);
+		CHECK(double(Dictionary(values[4])["id"]) == 2);
+	}
+
+	JSON json;
+	PackedByteArray bad;
+	bad.push_back('{');
+	bad.push_back('1');
+	bad.push_back('}');
+	CHECK(json.feed(bad) == ERR_PARSE_ERROR);
+	CHECK(!json.has_value());
+}
+
+TEST_CASE_BENCHMARK("[JSON][Benchmark] Parse and stringify throughput") {
+	// About 4 MB of records, similar to what tools exchange.
+	Array records;
+	for (int i = 0; i < 20000; i++) {
+		Dictionary record;
+		record["id"] = i;
+		record["name"] = "entity_" + itos(i);
+		record["description"] = String::utf8("Une entité placée à Montréal, with a \"quoted\" part");
+		Array position;
+		position.push_back(i * 0.5);
+		position.push_back(-i * 0.25);
+		position.push_back(100.125);
+		record["position"] = position;
+		record["visible"] = (i % 2) == 0;
+		record["parent"] = Variant();
+		records.push_back(record);
+	}
+
+	JSON json;
+	const int iterations = 3;
+
+	PackedByteArray bytes;
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < iterations; i++) {
+		bytes = json.stringify_utf8(records);
+	}
+	uint64_t stringify_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	const double mb = bytes.size() / (1024.0 * 1024.0);
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < iterations; i++) {
+		CHECK(json.parse_utf8(bytes) == OK);
+	}
+	uint64_t parse_utf8_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	String text;
+	text.parse_utf8((const char *)bytes.ptr(), bytes.size());
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < iterations; i++) {
+		CHECK(json.parse(text) == OK);
+	}
+	uint64_t parse_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < iterations; i++) {
+		PackedByteArray chunk;
+		for (int from = 0; from < bytes.size(); from += 64 * 1024) {
+			chunk.resize(MIN(64 * 1024, bytes.size() - from));
+			memcpy(chunk.ptrw(), bytes.ptr() + from, chunk.size());
+			CHECK(json.feed(chunk) == OK);
+		}
+		CHECK(Array(json.take_value()).size() == records.size());
+	}
+	uint64_t feed_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	CHECK(Array(json.get_data()).size() == records.size());
+
+	MESSAGE("JSON size: " << mb << " MB");
+	MESSAGE("stringify_utf8(): " << (mb * iterations * 1000000.0 / MAX(stringify_usec, (uint64_t)1)) << " MB/s");
+	MESSAGE("parse_utf8(): " << (mb * iterations * 1000000.0 / MAX(parse_utf8_usec, (uint64_t)1)) << " MB/s");
+	MESSAGE("parse(): " << (mb * iterations * 1000000.0 / MAX(parse_usec, (uint64_t)1)) << " MB/s");
+	MESSAGE("feed() in 64 KB chunks: " << (mb * iterations * 1000000.0 / MAX(feed_usec, (uint64_t)1)) << " MB/s");
+}
 } // namespace TestJSON
 
 #endif // TEST_JSON_H
@@ -33,13 +33,16 @@
 #include "core/templates/list.h"
 
 #include "test_aabb.h"
+#include "test_animation_player.h"
 #include "test_array.h"
 #include "test_astar.h"
+#include "test_audio_server.h"
 #include "test_basis.h"
 #include "test_class_db.h"
 #include "test_color.h"
 #include "test_command_queue.h"
 #include "test_config_file.h"
+#include "test_cpu_particles.h"
 #include "test_crypto.h"
 #include "test_curve.h"
 #include "test_dictionary.h"
@@ -57,7 +60,10 @@
 #include "test_lru.h"
 #include "test_marshalls.h"
 #include "test_math.h"
+#include "test_memory.h"
+#include "test_message_queue.h"
 #include "test_method_bind.h"
+#include "test_node.h"
 #include "test_node_path.h"
 #include "test_oa_hash_map.h"
 #include "test_object.h"
@@ -71,9 +77,12 @@
 #include "test_rect2.h"
 #include "test_render.h"
 #include "test_resource.h"
+#include "test_scene_tree.h"
 #include "test_shader_lang.h"
+#include "test_skeleton_3d.h"
 #include "test_string.h"
 #include "test_text_server.h"
+#include "test_tile_map.h"
 #include "test_time.h"
 #include "test_translation.h"
 #include "test_validate_testing.h"
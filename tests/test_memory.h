@@ -0,0 +1,191 @@
+/*************************************************************************/
+/*  test_memory.h                                                        */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_MEMORY_H
+#define TEST_MEMORY_H
+
+#include "core/os/memory.h"
+#include "core/os/os.h"
+#include "core/os/size_class_allocator.h"
+#include "core/os/thread.h"
+#include "core/variant/array.h"
+#include "core/variant/dictionary.h"
+#include "scene/main/node.h"
+
+#include "tests/test_macros.h"
+
+#include <stdlib.h>
+
+namespace TestMemory {
+
+TEST_CASE("[Memory] Reallocating across the small block sizes keeps contents") {
+	uint8_t *mem = (uint8_t *)memalloc(1);
+	mem[0] = 0;
+	size_t size = 1;
+	for (size_t new_size : { 16, 17, 100, 129, 1000, 4096, 4097, 10000, 3000, 64 }) {
+		mem = (uint8_t *)memrealloc(mem, new_size);
+		bool kept = true;
+		for (size_t i = 0; i < MIN(size, new_size); i++) {
+			kept = kept && mem[i] == uint8_t(i * 7);
+		}
+		CHECK_MESSAGE(kept, "Contents must be kept when reallocating to " << new_size << " bytes.");
+		for (size_t i = 0; i < new_size; i++) {
+			mem[i] = uint8_t(i * 7);
+		}
+		size = new_size;
+	}
+	memfree(mem);
+}
+
+TEST_CASE("[Memory] Small blocks come from the size class allocator") {
+	void *probe = SizeClassAllocator::alloc(16);
+	if (!probe) {
+		return; // Disabled in sanitizer builds.
+	}
+	SizeClassAllocator::free(probe);
+
+	void *small = memalloc(48);
+	void *large = memalloc(SizeClassAllocator::MAX_SIZE * 2);
+
+	// Debug builds prepend the allocation size to each block.
+#ifdef DEBUG_ENABLED
+	const uint8_t *small_block = (const uint8_t *)small - PAD_ALIGN;
+	const uint8_t *large_block = (const uint8_t *)large - PAD_ALIGN;
+#else
+	const uint8_t *small_block = (const uint8_t *)small;
+	const uint8_t *large_block = (const uint8_t *)large;
+#endif
+	CHECK(SizeClassAllocator::get_block_size(small_block) >= 48);
+	CHECK(SizeClassAllocator::get_block_size(large_block) == 0);
+	CHECK(Memory::get_small_alloc_usage() > 0);
+	CHECK(Memory::get_small_alloc_reserved() >= Memory::get_small_alloc_usage());
+
+	memfree(small);
+	memfree(large);
+}
+
+#if !defined(NO_THREADS)
+static void alloc_thread_func(void *p_data) {
+	void **blocks = static_cast<void **>(p_data);
+	for (int i = 0; i < 1000; i++) {
+		blocks[i] = memalloc(16 + i % 200);
+		memset(blocks[i], 0xAB, 16 + i % 200);
+	}
+}
+
+TEST_CASE("[Memory] Blocks allocated by a thread are freed after it exits") {
+	void *blocks[1000];
+	Thread thread;
+	thread.start(alloc_thread_func, blocks);
+	thread.wait_to_finish();
+
+	for (int i = 0; i < 1000; i++) {
+		memfree(blocks[i]);
+	}
+	// Blocks can be reused right away.
+	void *block = memalloc(16);
+	CHECK(block != nullptr);
+	memfree(block);
+}
+#endif
+
+TEST_CASE_BENCHMARK("[Memory][Benchmark] Small allocations") {
+	const int count = 100000;
+	const int rounds = 20;
+	LocalVector<void *> blocks;
+	blocks.resize(count);
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int r = 0; r < rounds; r++) {
+		for (int i = 0; i < count; i++) {
+			blocks[i] = malloc(16 + (i * 37) % 600);
+		}
+		for (int i = 0; i < count; i++) {
+			free(blocks[i]);
+		}
+	}
+	uint64_t malloc_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int r = 0; r < rounds; r++) {
+		for (int i = 0; i < count; i++) {
+			blocks[i] = memalloc(16 + (i * 37) % 600);
+		}
+		for (int i = 0; i < count; i++) {
+			memfree(blocks[i]);
+		}
+	}
+	uint64_t memalloc_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	LocalVector<Node *> nodes;
+	nodes.resize(count);
+	for (int r = 0; r < rounds / 4; r++) {
+		for (int i = 0; i < count; i++) {
+			nodes[i] = memnew(Node);
+		}
+		for (int i = 0; i < count; i++) {
+			memdelete(nodes[i]);
+		}
+	}
+	uint64_t node_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int r = 0; r < rounds; r++) {
+		Array array;
+		for (int i = 0; i < count / 10; i++) {
+			Dictionary dictionary;
+			dictionary["index"] = i;
+			dictionary["values"] = Array();
+			array.push_back(dictionary);
+		}
+	}
+	uint64_t variant_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int r = 0; r < rounds; r++) {
+		Vector<String> strings;
+		for (int i = 0; i < count / 10; i++) {
+			strings.push_back("node_" + itos(i) + "/" + String::num(i * 0.5));
+		}
+	}
+	uint64_t string_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	MESSAGE((count * rounds) << " system allocations and frees: " << (malloc_usec / 1000.0) << " ms");
+	MESSAGE((count * rounds) << " memalloc() and memfree(): " << (memalloc_usec / 1000.0) << " ms");
+	MESSAGE((count * rounds / 4) << " Nodes created and deleted: " << (node_usec / 1000.0) << " ms");
+	MESSAGE((count * rounds / 10) << " Dictionaries added to Arrays: " << (variant_usec / 1000.0) << " ms");
+	MESSAGE((count * rounds / 10) << " Strings built: " << (string_usec / 1000.0) << " ms");
+	MESSAGE("Small block memory reserved: " << (Memory::get_small_alloc_reserved() / 1024) << " KiB, used: " << (Memory::get_small_alloc_usage() / 1024) << " KiB");
+}
+
+} // namespace TestMemory
+
+#endif // TEST_MEMORY_H
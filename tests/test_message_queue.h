@@ -0,0 +1,263 @@
+/*************************************************************************/
+/*  test_message_queue.h                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_MESSAGE_QUEUE_H
+#define TEST_MESSAGE_QUEUE_H
+
+#include "core/object/message_queue.h"
+#include "core/os/os.h"
+#include "core/os/thread.h"
+
+#include "tests/test_macros.h"
+
+// Declared in global namespace because of GDCLASS macro warning (Windows).
+class _TestMessageQueueTarget : public Object {
+	GDCLASS(_TestMessageQueueTarget, Object);
+
+protected:
+	static void _bind_methods() {
+		ClassDB::bind_method(D_METHOD("record", "value"), &_TestMessageQueueTarget::record);
+	}
+
+	void _notification(int p_what) {
+		if (p_what == NOTIFICATION_COUNTED) {
+			notifications++;
+		}
+	}
+
+public:
+	enum {
+		NOTIFICATION_COUNTED = 4242
+	};
+
+	LocalVector<int> values;
+	LocalVector<String> names;
+	int notifications = 0;
+
+	void record(int p_value) { values.push_back(p_value); }
+	void record_name(const String &p_name, int p_value) {
+		names.push_back(p_name);
+		values.push_back(p_value);
+	}
+};
+
+namespace TestMessageQueue {
+
+struct PushThreadData {
+	ObjectID target;
+	int first_value = 0;
+	int count = 0;
+};
+
+static void push_thread_func(void *p_data) {
+	PushThreadData *data = static_cast<PushThreadData *>(p_data);
+	for (int i = 0; i < data->count; i++) {
+		MessageQueue::get_singleton()->push_call(data->target, "record", data->first_value + i);
+	}
+}
+
+TEST_CASE("[MessageQueue] Messages run in order, past the first page and the configured size") {
+	// Tests run without the main loop, so there is no queue yet.
+	MessageQueue *queue = memnew(MessageQueue);
+	_TestMessageQueueTarget *target = memnew(_TestMessageQueueTarget);
+
+	// Well over the 4 MiB the queue used to be limited to.
+	const int call_count = 100000;
+	for (int i = 0; i < call_count; i++) {
+		queue->push_call(target, "record", i);
+		if (i % 10 == 0) {
+			queue->push_notification(target, _TestMessageQueueTarget::NOTIFICATION_COUNTED);
+		}
+	}
+	CHECK(target->values.size() == 0);
+
+	queue->flush();
+
+	CHECK(target->values.size() == uint32_t(call_count));
+	CHECK(target->notifications == call_count / 10);
+	int in_order = 0;
+	for (int i = 0; i < int(target->values.size()); i++) {
+		in_order += target->values[i] == i;
+	}
+	CHECK(in_order == call_count);
+
+	target->values.clear();
+	queue->flush();
+	CHECK_MESSAGE(target->values.size() == 0, "Flushed messages should not run again.");
+
+	memdelete(target);
+	memdelete(queue);
+}
+
+TEST_CASE("[MessageQueue] Typed calls") {
+	MessageQueue *queue = memnew(MessageQueue);
+	_TestMessageQueueTarget *target = memnew(_TestMessageQueueTarget);
+
+	{
+		// The argument is copied into the queue, so it can go away before the flush.
+		String name = "first";
+		queue->push_call(target, &_TestMessageQueueTarget::record_name, name, 1);
+	}
+	queue->push_call(target, "record", 2);
+	queue->push_call(target, &_TestMessageQueueTarget::record, 3);
+	// Enough to span several pages.
+	for (int i = 4; i < 10000; i++) {
+		queue->push_call(target, &_TestMessageQueueTarget::record, i);
+	}
+
+	queue->flush();
+
+	REQUIRE(target->values.size() == 9999);
+	int in_order = 0;
+	for (int i = 0; i < int(target->values.size()); i++) {
+		in_order += target->values[i] == i + 1;
+	}
+	CHECK_MESSAGE(in_order == 9999, "Typed calls should keep their order with the other messages.");
+	REQUIRE(target->names.size() == 1);
+	CHECK(target->names[0] == "first");
+
+	// Calls to a freed object are dropped.
+	queue->push_call(target, &_TestMessageQueueTarget::record_name, String("freed"), 0);
+	memdelete(target);
+	queue->flush();
+
+	memdelete(queue);
+}
+
+#if !defined(NO_THREADS)
+TEST_CASE("[MessageQueue] Messages pushed from other threads") {
+	MessageQueue *queue = memnew(MessageQueue);
+	_TestMessageQueueTarget *target = memnew(_TestMessageQueueTarget);
+
+	const int thread_count = 4;
+	const int call_count = 10000;
+	Thread threads[thread_count];
+	PushThreadData data[thread_count];
+	for (int i = 0; i < thread_count; i++) {
+		data[i].target = target->get_instance_id();
+		data[i].first_value = i * call_count;
+		data[i].count = call_count;
+		threads[i].start(push_thread_func, &data[i]);
+	}
+	for (int i = 0; i < thread_count; i++) {
+		threads[i].wait_to_finish();
+	}
+
+	queue->flush();
+
+	CHECK(target->values.size() == uint32_t(thread_count * call_count));
+	// Messages from one thread keep their order.
+	int last_values[thread_count] = { -1, -1, -1, -1 };
+	int out_of_order = 0;
+	for (uint32_t i = 0; i < target->values.size(); i++) {
+		int thread = target->values[i] / call_count;
+		out_of_order += target->values[i] <= last_values[thread];
+		last_values[thread] = target->values[i];
+	}
+	CHECK(out_of_order == 0);
+
+	memdelete(target);
+	memdelete(queue);
+}
+#endif // !defined(NO_THREADS)
+
+TEST_CASE_BENCHMARK("[MessageQueue][Benchmark] Push and flush deferred calls") {
+	MessageQueue *queue = memnew(MessageQueue);
+	_TestMessageQueueTarget *target = memnew(_TestMessageQueueTarget);
+
+	const int call_count = 1000000;
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < call_count; i++) {
+		queue->push_call(target, "record", i);
+	}
+	uint64_t push_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	queue->flush();
+	uint64_t flush_usec = OS::get_singleton()->get_ticks_usec() - begin;
+	CHECK(target->values.size() == uint32_t(call_count));
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < call_count; i++) {
+		queue->push_notification(target, _TestMessageQueueTarget::NOTIFICATION_COUNTED);
+	}
+	queue->flush();
+	uint64_t notification_usec = OS::get_singleton()->get_ticks_usec() - begin;
+	CHECK(target->notifications == call_count);
+
+	target->values.clear();
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < call_count; i++) {
+		queue->push_call(target, &_TestMessageQueueTarget::record, i);
+	}
+	uint64_t typed_push_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	queue->flush();
+	uint64_t typed_flush_usec = OS::get_singleton()->get_ticks_usec() - begin;
+	CHECK(target->values.size() == uint32_t(call_count));
+
+	MESSAGE("Pushing " << call_count << " deferred calls: " << (push_usec / 1000.0) << " ms");
+	MESSAGE("Flushing them: " << (flush_usec / 1000.0) << " ms");
+	MESSAGE("Pushing " << call_count << " typed deferred calls: " << (typed_push_usec / 1000.0) << " ms");
+	MESSAGE("Flushing them: " << (typed_flush_usec / 1000.0) << " ms");
+	MESSAGE("Pushing and flushing " << call_count << " notifications: " << (notification_usec / 1000.0) << " ms");
+
+#if !defined(NO_THREADS)
+	target->values.clear();
+
+	const int thread_count = 8;
+	Thread threads[thread_count];
+	PushThreadData data[thread_count];
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < thread_count; i++) {
+		data[i].target = target->get_instance_id();
+		data[i].first_value = i * (call_count / thread_count);
+		data[i].count = call_count / thread_count;
+		threads[i].start(push_thread_func, &data[i]);
+	}
+	for (int i = 0; i < thread_count; i++) {
+		threads[i].wait_to_finish();
+	}
+	uint64_t threaded_push_usec = OS::get_singleton()->get_ticks_usec() - begin;
+	queue->flush();
+	CHECK(target->values.size() == uint32_t(call_count));
+
+	MESSAGE("Pushing " << call_count << " deferred calls from " << thread_count << " threads: " << (threaded_push_usec / 1000.0) << " ms");
+#endif
+
+	memdelete(target);
+	memdelete(queue);
+}
+
+} // namespace TestMessageQueue
+
+#endif // TEST_MESSAGE_QUEUE_H
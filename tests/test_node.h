@@ -0,0 +1,266 @@
+/*************************************************************************/
+/*  test_node.h                                                          */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_NODE_H
+#define TEST_NODE_H
+
+#include "core/object/message_queue.h"
+#include "core/os/os.h"
+#include "scene/main/node.h"
+
+#include "tests/test_macros.h"
+
+namespace TestNode {
+
+static Node *add_named_child(Node *p_parent, const String &p_name) {
+	Node *child = memnew(Node);
+	child->set_name(p_name);
+	p_parent->add_child(child);
+	return child;
+}
+
+TEST_CASE("[Node] Children are found by name") {
+	Node *parent = memnew(Node);
+	Node *a = add_named_child(parent, "A");
+	Node *b = add_named_child(parent, "B");
+
+	CHECK(parent->get_node_or_null(NodePath("A")) == a);
+	CHECK(parent->get_node_or_null(NodePath("B")) == b);
+	CHECK(parent->get_node_or_null(NodePath("C")) == nullptr);
+
+	b->set_name("C");
+	CHECK_MESSAGE(parent->get_node_or_null(NodePath("B")) == nullptr, "Renamed children should not be found by their old name.");
+	CHECK(parent->get_node_or_null(NodePath("C")) == b);
+
+	Node *duplicate = add_named_child(parent, "A");
+	CHECK_MESSAGE(duplicate->get_name() != StringName("A"), "Children with an existing name should be renamed.");
+	CHECK(parent->get_node_or_null(NodePath("A")) == a);
+	CHECK(parent->get_node_or_null(NodePath(duplicate->get_name())) == duplicate);
+
+	parent->remove_child(a);
+	CHECK(parent->get_node_or_null(NodePath("A")) == nullptr);
+
+	memdelete(a);
+	memdelete(parent);
+}
+
+TEST_CASE("[Node] Child indices stay in order after removals") {
+	Node *parent = memnew(Node);
+	Vector<Node *> children;
+	for (int i = 0; i < 6; i++) {
+		children.push_back(add_named_child(parent, itos(i)));
+	}
+
+	parent->remove_child(children[1]);
+	parent->remove_child(children[0]);
+	parent->remove_child(children[4]);
+
+	CHECK(parent->get_child_count() == 3);
+	CHECK(parent->get_child(0) == children[2]);
+	CHECK(children[2]->get_index() == 0);
+	CHECK(children[3]->get_index() == 1);
+	CHECK(children[5]->get_index() == 2);
+
+	parent->move_child(children[5], 0);
+	CHECK(children[5]->get_index() == 0);
+	CHECK(children[2]->get_index() == 1);
+	CHECK(children[3]->get_index() == 2);
+
+	parent->remove_child(children[2]);
+	CHECK(children[3]->get_index() == 1);
+
+	for (int i = 0; i < children.size(); i++) {
+		if (children[i]->get_parent()) {
+			parent->remove_child(children[i]);
+		}
+		memdelete(children[i]);
+	}
+	memdelete(parent);
+}
+
+class _TestSiblingNode : public Node {
+	GDCLASS(_TestSiblingNode, Node);
+
+protected:
+	void _notification(int p_what) {
+		if (p_what == NOTIFICATION_MOVED_IN_PARENT) {
+			moved_count++;
+		}
+	}
+
+public:
+	int moved_count = 0;
+
+	// Like SceneState does when instancing, names aren't made unique.
+	void set_name_unchecked(const StringName &p_name) { _set_name_nocheck(p_name); }
+};
+
+TEST_CASE("[Node] Following siblings are notified when a child is removed") {
+	Node *parent = memnew(Node);
+	Vector<_TestSiblingNode *> children;
+	for (int i = 0; i < 4; i++) {
+		children.push_back(memnew(_TestSiblingNode));
+		parent->add_child(children[i]);
+	}
+
+	parent->remove_child(children[1]);
+	CHECK(children[0]->moved_count == 0);
+	CHECK(children[2]->moved_count == 1);
+	CHECK(children[3]->moved_count == 1);
+	CHECK(children[2]->get_index() == 1);
+	CHECK(children[3]->get_index() == 2);
+
+	for (int i = 0; i < children.size(); i++) {
+		if (children[i]->get_parent()) {
+			parent->remove_child(children[i]);
+		}
+		memdelete(children[i]);
+	}
+	memdelete(parent);
+}
+
+TEST_CASE("[Node] Children with duplicated names are found in order") {
+	Node *parent = memnew(Node);
+	Vector<_TestSiblingNode *> children;
+	for (int i = 0; i < 3; i++) {
+		children.push_back(memnew(_TestSiblingNode));
+		children[i]->set_name(itos(i));
+		parent->add_child(children[i]);
+	}
+
+	// The first child with a name is found, as when looking through the children.
+	children[2]->set_name_unchecked("1");
+	CHECK(parent->get_node_or_null(NodePath("1")) == children[1]);
+	CHECK(parent->get_node_or_null(NodePath("2")) == nullptr);
+	children[0]->set_name_unchecked("1");
+	CHECK(parent->get_node_or_null(NodePath("1")) == children[0]);
+
+	children[0]->set_name("0");
+	CHECK(parent->get_node_or_null(NodePath("0")) == children[0]);
+	CHECK(parent->get_node_or_null(NodePath("1")) == children[1]);
+
+	parent->remove_child(children[1]);
+	CHECK_MESSAGE(parent->get_node_or_null(NodePath("1")) == children[2], "The remaining child with the name should be found.");
+
+	children[1]->set_name("1");
+	parent->add_child(children[1]);
+	CHECK_MESSAGE(children[1]->get_name() != StringName("1"), "Added children should still get a unique name.");
+
+	children[2]->set_name("2");
+	CHECK(parent->get_node_or_null(NodePath("1")) == nullptr);
+	CHECK(parent->get_node_or_null(NodePath("2")) == children[2]);
+	CHECK(parent->get_node_or_null(NodePath(children[1]->get_name())) == children[1]);
+
+	for (int i = 0; i < children.size(); i++) {
+		parent->remove_child(children[i]);
+		memdelete(children[i]);
+	}
+	memdelete(parent);
+}
+
+TEST_CASE("[Node] Tree changes and signals are deferred while processing on a worker thread") {
+	// Tests run without the main loop, so there is no queue yet.
+	MessageQueue *queue = memnew(MessageQueue);
+
+	Node *parent = memnew(Node);
+	Node *child = memnew(Node);
+	Node *receiver = memnew(Node);
+	receiver->set_name("Receiver");
+	parent->add_user_signal(MethodInfo("name_requested", PropertyInfo(Variant::STRING_NAME, "name")));
+	parent->connect("name_requested", Callable(receiver, "set_name"));
+
+	MessageQueue::set_thread_deferring(true);
+	parent->add_child(child);
+	parent->add_to_group("deferred");
+	parent->emit_signal("name_requested", StringName("Received"));
+	MessageQueue::set_thread_deferring(false);
+
+	CHECK(parent->get_child_count() == 0);
+	CHECK_FALSE(parent->is_in_group("deferred"));
+	CHECK(receiver->get_name() == StringName("Receiver"));
+
+	queue->flush();
+
+	CHECK(parent->get_child_count() == 1);
+	CHECK(parent->is_in_group("deferred"));
+	CHECK(receiver->get_name() == StringName("Received"));
+
+	memdelete(receiver);
+	memdelete(parent);
+	memdelete(queue);
+}
+
+TEST_CASE_BENCHMARK("[Node][Benchmark] Add, find and remove 10000 children") {
+	const int child_count = 10000;
+
+	Node *parent = memnew(Node);
+	Vector<Node *> children;
+	Vector<NodePath> paths;
+	for (int i = 0; i < child_count; i++) {
+		Node *child = memnew(Node);
+		child->set_name(vformat("Child%d", i));
+		children.push_back(child);
+		paths.push_back(NodePath(child->get_name()));
+	}
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < child_count; i++) {
+		parent->add_child(children[i]);
+	}
+	uint64_t add_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	int found = 0;
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < child_count; i++) {
+		found += parent->get_node_or_null(paths[i]) == children[i];
+	}
+	uint64_t find_usec = OS::get_singleton()->get_ticks_usec() - begin;
+	CHECK(found == child_count);
+
+	// Removing from the front is the worst case, every removal moves all the following children.
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < child_count; i++) {
+		parent->remove_child(children[i]);
+	}
+	uint64_t remove_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	MESSAGE("add_child(): " << (add_usec / 1000.0) << " ms");
+	MESSAGE("get_node_or_null(): " << (find_usec / 1000.0) << " ms");
+	MESSAGE("remove_child() from the front: " << (remove_usec / 1000.0) << " ms");
+
+	for (int i = 0; i < child_count; i++) {
+		memdelete(children[i]);
+	}
+	memdelete(parent);
+}
+
+} // namespace TestNode
+
+#endif // TEST_NODE_H
@@ -0,0 +1,506 @@
+/*************************************************************************/
+/*  test_scene_tree.h                                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_SCENE_TREE_H
+#define TEST_SCENE_TREE_H
+
+#include "core/object/message_queue.h"
+#include "core/os/os.h"
+#include "scene/2d/node_2d.h"
+#include "scene/3d/area_3d.h"
+#include "scene/3d/mesh_instance_3d.h"
+#include "scene/3d/physics_body_3d.h"
+#include "scene/main/scene_tree.h"
+#include "scene/main/window.h"
+#include "servers/display_server_headless.h"
+#include "servers/navigation_server_2d.h"
+#include "servers/navigation_server_3d.h"
+#include "servers/physics_server_2d.h"
+#include "servers/physics_server_3d.h"
+#include "servers/rendering/rendering_server_default.h"
+
+#include "tests/test_macros.h"
+
+// Declared in global namespace because of GDCLASS macro warning (Windows).
+// Records the order nodes are processed in.
+class _TestProcessOrderNode : public Node {
+	GDCLASS(_TestProcessOrderNode, Node);
+
+protected:
+	void _notification(int p_what) {
+		if (p_what == NOTIFICATION_PROCESS && order) {
+			order->push_back(this);
+		}
+	}
+
+public:
+	LocalVector<Node *> *order = nullptr;
+};
+
+// Integrates a small particle system every frame, only touching its own state.
+class _TestSimulationNode : public Node {
+	GDCLASS(_TestSimulationNode, Node);
+
+protected:
+	void _notification(int p_what) {
+		if (p_what == NOTIFICATION_PROCESS) {
+			float delta = get_process_delta_time();
+			for (int i = 0; i < PARTICLE_COUNT; i++) {
+				Vector3 to_center = -positions[i];
+				velocities[i] += to_center.normalized() * delta + Vector3(Math::sin(positions[i].y), Math::cos(positions[i].x), 0) * 0.1 * delta;
+				positions[i] += velocities[i] * delta;
+			}
+			processed++;
+		}
+	}
+
+public:
+	enum {
+		PARTICLE_COUNT = 64
+	};
+
+	Vector3 positions[PARTICLE_COUNT];
+	Vector3 velocities[PARTICLE_COUNT];
+	int processed = 0;
+
+	_TestSimulationNode() {
+		for (int i = 0; i < PARTICLE_COUNT; i++) {
+			positions[i] = Vector3(i % 4 + 1, i / 4 % 4 + 1, i / 16 + 1);
+		}
+	}
+};
+
+// Records the order transform notifications arrive in.
+class _TestTransformOrderNode : public Node3D {
+	GDCLASS(_TestTransformOrderNode, Node3D);
+
+protected:
+	void _notification(int p_what) {
+		if (p_what == NOTIFICATION_TRANSFORM_CHANGED && order) {
+			order->push_back(this);
+		}
+	}
+
+public:
+	LocalVector<Node *> *order = nullptr;
+
+	_TestTransformOrderNode() {
+		set_notify_transform(true);
+	}
+};
+
+// Moves itself when processed and counts the transform notifications it gets.
+class _TestMovingNode3D : public Node3D {
+	GDCLASS(_TestMovingNode3D, Node3D);
+
+protected:
+	void _notification(int p_what) {
+		if (p_what == NOTIFICATION_PROCESS) {
+			set_position(get_position() + Vector3(1, 0, 0));
+		} else if (p_what == NOTIFICATION_TRANSFORM_CHANGED) {
+			transform_changes++;
+		}
+	}
+
+public:
+	int transform_changes = 0;
+
+	_TestMovingNode3D() {
+		set_notify_transform(true);
+	}
+};
+
+class _TestMovingNode2D : public Node2D {
+	GDCLASS(_TestMovingNode2D, Node2D);
+
+protected:
+	void _notification(int p_what) {
+		if (p_what == NOTIFICATION_PROCESS) {
+			set_position(get_position() + Vector2(1, 0));
+		} else if (p_what == NOTIFICATION_TRANSFORM_CHANGED) {
+			transform_changes++;
+		}
+	}
+
+public:
+	int transform_changes = 0;
+
+	_TestMovingNode2D() {
+		set_notify_transform(true);
+	}
+};
+
+namespace TestSceneTree {
+
+// Runs a SceneTree on the headless display server and the dummy renderer, like
+// `--display-driver headless` does.
+struct HeadlessSceneTree {
+	MessageQueue *message_queue = nullptr;
+	DisplayServer *display_server = nullptr;
+	RenderingServer *rendering_server = nullptr;
+	PhysicsServer3D *physics_server = nullptr;
+	PhysicsServer2D *physics_2d_server = nullptr;
+	NavigationServer3D *navigation_server = nullptr;
+	NavigationServer2D *navigation_2d_server = nullptr;
+	SceneTree *tree = nullptr;
+
+	HeadlessSceneTree() {
+		// Tests run without the main loop, which owns the queue the tree flushes every frame.
+		message_queue = memnew(MessageQueue);
+
+		RasterizerDummy::make_current();
+		display_server = memnew(DisplayServerHeadless);
+		rendering_server = memnew(RenderingServerDefault);
+		rendering_server->init();
+
+		physics_server = PhysicsServer3DManager::new_default_server();
+		physics_server->init();
+		physics_2d_server = PhysicsServer2DManager::new_default_server();
+		physics_2d_server->init();
+
+		navigation_server = NavigationServer3DManager::new_default_server();
+		navigation_2d_server = memnew(NavigationServer2D);
+
+		tree = memnew(SceneTree);
+		tree->initialize();
+	}
+
+	~HeadlessSceneTree() {
+		tree->finalize();
+		memdelete(tree);
+
+		memdelete(navigation_2d_server);
+		memdelete(navigation_server);
+
+		physics_2d_server->finish();
+		memdelete(physics_2d_server);
+		physics_server->finish();
+		memdelete(physics_server);
+
+		rendering_server->finish();
+		memdelete(rendering_server);
+		memdelete(display_server);
+		memdelete(message_queue);
+	}
+};
+
+TEST_CASE_BENCHMARK("[SceneTree][Benchmark] Process 50000 nodes") {
+	HeadlessSceneTree headless;
+	SceneTree *tree = headless.tree;
+
+	const int node_count = 50000;
+	const int frames = 100;
+
+	// Containers are added first, so nodes are not only added at the end of the tree.
+	Node *containers[10];
+	for (int i = 0; i < 10; i++) {
+		containers[i] = memnew(Node);
+		tree->get_root()->add_child(containers[i]);
+	}
+
+	LocalVector<Node *> order;
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < node_count; i++) {
+		_TestProcessOrderNode *node = memnew(_TestProcessOrderNode);
+		node->set_process(true);
+		containers[i % 10]->add_child(node);
+	}
+	tree->process(0.016);
+	uint64_t add_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int f = 0; f < frames; f++) {
+		tree->process(0.016);
+	}
+	uint64_t frame_usec = (OS::get_singleton()->get_ticks_usec() - begin) / frames;
+
+	// Spawning and freeing some nodes every frame, like bullets.
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int f = 0; f < frames; f++) {
+		for (int i = 0; i < 100; i++) {
+			_TestProcessOrderNode *node = memnew(_TestProcessOrderNode);
+			node->set_process(true);
+			containers[(f + i) % 10]->add_child(node);
+		}
+		for (int i = 0; i < 100; i++) {
+			Node *container = containers[(f + i + 5) % 10];
+			container->get_child(i)->queue_delete();
+		}
+		tree->process(0.016);
+	}
+	uint64_t spawn_frame_usec = (OS::get_singleton()->get_ticks_usec() - begin) / frames;
+
+	// Processing must still follow the tree order.
+	for (int i = 0; i < 10; i++) {
+		for (int j = 0; j < containers[i]->get_child_count(); j++) {
+			Object::cast_to<_TestProcessOrderNode>(containers[i]->get_child(j))->order = &order;
+		}
+	}
+	tree->process(0.016);
+	int in_order = 0;
+	for (uint32_t i = 1; i < order.size(); i++) {
+		in_order += order[i]->is_greater_than(order[i - 1]);
+	}
+	CHECK(order.size() == uint32_t(node_count));
+	CHECK(in_order == node_count - 1);
+
+	MESSAGE("Adding " << node_count << " processing nodes: " << (add_usec / 1000.0) << " ms");
+	MESSAGE("Processing " << node_count << " nodes: " << (frame_usec / 1000.0) << " ms/frame");
+	MESSAGE("Processing while adding and freeing 100 nodes: " << (spawn_frame_usec / 1000.0) << " ms/frame");
+}
+
+TEST_CASE_BENCHMARK("[SceneTree][Benchmark] Process 4000 simulation nodes in sub thread groups") {
+	HeadlessSceneTree headless;
+	SceneTree *tree = headless.tree;
+
+	const int node_count = 4000;
+	const int group_count = 64;
+	const int frames = 60;
+
+	Node *groups[group_count];
+	for (int i = 0; i < group_count; i++) {
+		groups[i] = memnew(Node);
+		tree->get_root()->add_child(groups[i]);
+	}
+
+	Vector<_TestSimulationNode *> nodes;
+	for (int i = 0; i < node_count; i++) {
+		_TestSimulationNode *node = memnew(_TestSimulationNode);
+		node->set_process(true);
+		groups[i % group_count]->add_child(node);
+		nodes.push_back(node);
+	}
+	tree->process(0.016);
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int f = 0; f < frames; f++) {
+		tree->process(0.016);
+	}
+	uint64_t main_thread_usec = (OS::get_singleton()->get_ticks_usec() - begin) / frames;
+
+	for (int i = 0; i < group_count; i++) {
+		groups[i]->set_process_thread_group(Node::PROCESS_THREAD_GROUP_SUB_THREAD);
+	}
+	CHECK(nodes[0]->is_process_threaded());
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int f = 0; f < frames; f++) {
+		tree->process(0.016);
+	}
+	uint64_t sub_thread_usec = (OS::get_singleton()->get_ticks_usec() - begin) / frames;
+
+	int processed = 0;
+	for (int i = 0; i < node_count; i++) {
+		processed += nodes[i]->processed == frames * 2 + 1;
+	}
+	CHECK(processed == node_count);
+	CHECK(nodes[node_count - 1]->positions[0].is_equal_approx(nodes[0]->positions[0]));
+
+	MESSAGE("Processing on the main thread: " << (main_thread_usec / 1000.0) << " ms/frame");
+	MESSAGE("Processing in " << group_count << " sub thread groups: " << (sub_thread_usec / 1000.0) << " ms/frame");
+	MESSAGE("Speedup: " << (double(main_thread_usec) / MAX(sub_thread_usec, uint64_t(1))) << "x");
+}
+
+TEST_CASE("[SceneTree] Transform notifications are sent parents first") {
+	HeadlessSceneTree headless;
+	SceneTree *tree = headless.tree;
+
+	LocalVector<Node *> order;
+
+	// Two chains, so nodes changed from different origins are queued interleaved.
+	_TestTransformOrderNode *roots[2];
+	_TestTransformOrderNode *leaves[2];
+	for (int i = 0; i < 2; i++) {
+		roots[i] = memnew(_TestTransformOrderNode);
+		tree->get_root()->add_child(roots[i]);
+		Node3D *parent = roots[i];
+		for (int j = 0; j < 5; j++) {
+			_TestTransformOrderNode *node = memnew(_TestTransformOrderNode);
+			node->set_position(Vector3(1, 0, 0));
+			parent->add_child(node);
+			parent = node;
+		}
+		leaves[i] = Object::cast_to<_TestTransformOrderNode>(parent);
+	}
+	tree->flush_transform_notifications();
+
+	for (int i = 0; i < 2; i++) {
+		for (Node *node = leaves[i]; node != tree->get_root(); node = node->get_parent()) {
+			Object::cast_to<_TestTransformOrderNode>(node)->order = &order;
+		}
+	}
+
+	roots[0]->set_position(Vector3(0, 0, 1));
+	Object::cast_to<Node3D>(leaves[1]->get_parent()->get_parent())->set_position(Vector3(0, 1, 0));
+	tree->flush_transform_notifications();
+
+	CHECK(order.size() == 9);
+	int in_order = 0;
+	for (uint32_t i = 1; i < order.size(); i++) {
+		in_order += order[i]->get_path().get_name_count() >= order[i - 1]->get_path().get_name_count();
+	}
+	CHECK(in_order == 8);
+	CHECK(leaves[0]->get_global_transform().origin.is_equal_approx(Vector3(5, 0, 1)));
+	CHECK(leaves[1]->get_global_transform().origin.is_equal_approx(Vector3(4, 1, 0)));
+}
+
+TEST_CASE("[SceneTree] Moved collision objects reach the physics server after the flush") {
+	HeadlessSceneTree headless;
+	SceneTree *tree = headless.tree;
+
+	Node3D *parent = memnew(Node3D);
+	tree->get_root()->add_child(parent);
+	StaticBody3D *body = memnew(StaticBody3D);
+	body->set_position(Vector3(1, 0, 0));
+	parent->add_child(body);
+	Area3D *area = memnew(Area3D);
+	area->set_position(Vector3(0, 1, 0));
+	parent->add_child(area);
+	tree->flush_transform_notifications();
+
+	parent->set_position(Vector3(0, 0, 2));
+	tree->flush_transform_notifications();
+
+	const Transform3D body_transform = PhysicsServer3D::get_singleton()->body_get_state(body->get_rid(), PhysicsServer3D::BODY_STATE_TRANSFORM);
+	CHECK(body_transform.origin.is_equal_approx(Vector3(1, 0, 2)));
+	CHECK(PhysicsServer3D::get_singleton()->area_get_transform(area->get_rid()).origin.is_equal_approx(Vector3(0, 1, 2)));
+}
+
+TEST_CASE("[SceneTree] Moving nodes from sub thread groups") {
+	HeadlessSceneTree headless;
+	SceneTree *tree = headless.tree;
+
+	const int group_count = 64;
+	const int frames = 20;
+
+	// Every group moves a 3D and a 2D node with a child, all queuing transform notifications at once.
+	LocalVector<_TestMovingNode3D *> nodes_3d;
+	LocalVector<_TestMovingNode2D *> nodes_2d;
+	for (int i = 0; i < group_count; i++) {
+		Node *group = memnew(Node);
+		group->set_process_thread_group(Node::PROCESS_THREAD_GROUP_SUB_THREAD);
+		tree->get_root()->add_child(group);
+
+		_TestMovingNode3D *node_3d = memnew(_TestMovingNode3D);
+		node_3d->set_process(true);
+		group->add_child(node_3d);
+		_TestMovingNode3D *child_3d = memnew(_TestMovingNode3D);
+		node_3d->add_child(child_3d);
+		nodes_3d.push_back(node_3d);
+		nodes_3d.push_back(child_3d);
+
+		_TestMovingNode2D *node_2d = memnew(_TestMovingNode2D);
+		node_2d->set_process(true);
+		group->add_child(node_2d);
+		_TestMovingNode2D *child_2d = memnew(_TestMovingNode2D);
+		node_2d->add_child(child_2d);
+		nodes_2d.push_back(node_2d);
+		nodes_2d.push_back(child_2d);
+	}
+	CHECK(nodes_3d[0]->is_process_threaded());
+	tree->flush_transform_notifications();
+
+	for (uint32_t i = 0; i < nodes_3d.size(); i++) {
+		nodes_3d[i]->transform_changes = 0;
+		nodes_2d[i]->transform_changes = 0;
+	}
+
+	for (int f = 0; f < frames; f++) {
+		tree->process(0.016);
+	}
+
+	int notified = 0;
+	int moved = 0;
+	for (uint32_t i = 0; i < nodes_3d.size(); i++) {
+		notified += nodes_3d[i]->transform_changes == frames;
+		notified += nodes_2d[i]->transform_changes == frames;
+		moved += nodes_3d[i]->get_global_transform().origin.is_equal_approx(Vector3(frames, 0, 0));
+		moved += nodes_2d[i]->get_global_position().is_equal_approx(Vector2(frames, 0));
+	}
+	CHECK(notified == group_count * 4);
+	CHECK(moved == group_count * 4);
+}
+
+TEST_CASE_BENCHMARK("[SceneTree][Benchmark] Move a 50000 node hierarchy") {
+	HeadlessSceneTree headless;
+	SceneTree *tree = headless.tree;
+
+	const int node_count = 50000;
+	const int frames = 100;
+
+	// A wide hierarchy, like a building prefab, and a deep one, like rigs or vehicle attachments.
+	Node3D *wide = memnew(Node3D);
+	tree->get_root()->add_child(wide);
+	LocalVector<Node3D *> nodes;
+	nodes.push_back(wide);
+	for (int i = 1; i < node_count; i++) {
+		MeshInstance3D *node = memnew(MeshInstance3D);
+		node->set_position(Vector3(i % 7, i % 5, i % 3));
+		nodes[(i - 1) / 8]->add_child(node);
+		nodes.push_back(node);
+	}
+
+	Node3D *deep = memnew(Node3D);
+	tree->get_root()->add_child(deep);
+	for (int i = 0; i < node_count / 100; i++) {
+		Node3D *parent = deep;
+		for (int j = 0; j < 100; j++) {
+			MeshInstance3D *node = memnew(MeshInstance3D);
+			node->set_position(Vector3(0, 0.1, 0));
+			parent->add_child(node);
+			parent = node;
+		}
+	}
+	tree->flush_transform_notifications();
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int f = 0; f < frames; f++) {
+		wide->set_position(Vector3(f, 0, 0));
+		tree->flush_transform_notifications();
+	}
+	uint64_t wide_usec = (OS::get_singleton()->get_ticks_usec() - begin) / frames;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int f = 0; f < frames; f++) {
+		deep->set_position(Vector3(f, 0, 0));
+		tree->flush_transform_notifications();
+	}
+	uint64_t deep_usec = (OS::get_singleton()->get_ticks_usec() - begin) / frames;
+
+	CHECK(nodes[node_count - 1]->get_global_transform().origin.x > frames - 1);
+
+	MESSAGE("Moving a " << node_count << " node hierarchy 8 children wide: " << (wide_usec / 1000.0) << " ms/frame");
+	MESSAGE("Moving " << node_count / 100 << " chains of 100 nodes: " << (deep_usec / 1000.0) << " ms/frame");
+}
+
+} // namespace TestSceneTree
+
+#endif // TEST_SCENE_TREE_H
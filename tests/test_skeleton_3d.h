@@ -0,0 +1,239 @@
+/*************************************************************************/
+/*  test_skeleton_3d.h                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_SKELETON_3D_H
+#define TEST_SKELETON_3D_H
+
+#include "core/os/os.h"
+#include "scene/3d/skeleton_3d.h"
+
+#include "tests/test_macros.h"
+#include "tests/test_scene_tree.h"
+
+namespace TestSkeleton3D {
+
+static Skeleton3D *create_chain(int p_bone_count) {
+	Skeleton3D *skeleton = memnew(Skeleton3D);
+	for (int i = 0; i < p_bone_count; i++) {
+		skeleton->add_bone(vformat("bone_%d", i));
+		skeleton->set_bone_parent(i, i - 1);
+		skeleton->set_bone_rest(i, Transform3D(Basis(), Vector3(0, 1, 0)));
+	}
+	skeleton->notification(Skeleton3D::NOTIFICATION_UPDATE_SKELETON);
+	return skeleton;
+}
+
+TEST_CASE("[Skeleton3D] Global poses are composed along the parent chain") {
+	Skeleton3D *skeleton = create_chain(3);
+
+	CHECK(skeleton->get_bone_global_pose(2).origin.is_equal_approx(Vector3(0, 3, 0)));
+
+	skeleton->set_bone_pose(0, Transform3D(Basis(Vector3(0, 0, 1), Math_PI * 0.5), Vector3()));
+	skeleton->notification(Skeleton3D::NOTIFICATION_UPDATE_SKELETON);
+
+	CHECK_MESSAGE(
+			skeleton->get_bone_global_pose(0).origin.is_equal_approx(Vector3(0, 1, 0)),
+			"The root bone should only be affected by its rest.");
+	CHECK_MESSAGE(
+			skeleton->get_bone_global_pose(2).origin.is_equal_approx(Vector3(-2, 1, 0)),
+			"Changing a parent pose should be propagated to all of its descendants.");
+
+	skeleton->set_bone_pose(1, Transform3D(Basis(), Vector3(0, 0, 1)));
+	skeleton->notification(Skeleton3D::NOTIFICATION_UPDATE_SKELETON);
+
+	CHECK(skeleton->get_bone_global_pose(0).origin.is_equal_approx(Vector3(0, 1, 0)));
+	CHECK(skeleton->get_bone_global_pose(1).origin.is_equal_approx(Vector3(-1, 1, 1)));
+	CHECK(skeleton->get_bone_global_pose(2).origin.is_equal_approx(Vector3(-2, 1, 1)));
+
+	memdelete(skeleton);
+}
+
+TEST_CASE("[Skeleton3D] Bone pose buffer") {
+	Skeleton3D *skeleton = create_chain(4);
+
+	Vector<float> buffer = skeleton->get_bone_pose_buffer();
+	CHECK(buffer.size() == 4 * 12);
+
+	const Transform3D pose = Transform3D(Basis(Vector3(1, 0, 0), 0.25), Vector3(1, 2, 3));
+	float *w = buffer.ptrw();
+	w[12 * 2 + 0] = pose.basis.elements[0][0];
+	w[12 * 2 + 1] = pose.basis.elements[0][1];
+	w[12 * 2 + 2] = pose.basis.elements[0][2];
+	w[12 * 2 + 3] = pose.origin.x;
+	w[12 * 2 + 4] = pose.basis.elements[1][0];
+	w[12 * 2 + 5] = pose.basis.elements[1][1];
+	w[12 * 2 + 6] = pose.basis.elements[1][2];
+	w[12 * 2 + 7] = pose.origin.y;
+	w[12 * 2 + 8] = pose.basis.elements[2][0];
+	w[12 * 2 + 9] = pose.basis.elements[2][1];
+	w[12 * 2 + 10] = pose.basis.elements[2][2];
+	w[12 * 2 + 11] = pose.origin.z;
+
+	skeleton->set_bone_pose_buffer(buffer);
+	skeleton->notification(Skeleton3D::NOTIFICATION_UPDATE_SKELETON);
+
+	CHECK(skeleton->get_bone_pose(2).is_equal_approx(pose));
+	CHECK(skeleton->get_bone_pose(3).is_equal_approx(Transform3D()));
+	CHECK(skeleton->get_bone_global_pose(3).is_equal_approx(skeleton->get_bone_global_pose(2) * skeleton->get_bone_rest(3)));
+	CHECK_MESSAGE(
+			skeleton->get_bone_pose_buffer() == buffer,
+			"The pose buffer should round-trip.");
+
+	ERR_PRINT_OFF;
+	skeleton->set_bone_pose_buffer(Vector<float>());
+	ERR_PRINT_ON;
+	CHECK_MESSAGE(
+			skeleton->get_bone_pose(2).is_equal_approx(pose),
+			"A buffer of the wrong size should be rejected.");
+
+	memdelete(skeleton);
+}
+
+static void check_bone_buffer(Skeleton3D *p_skeleton, const Ref<SkinReference> &p_skin_ref) {
+	const Ref<Skin> skin = p_skin_ref->get_skin();
+	const Vector<float> buffer = p_skin_ref->get_bone_buffer();
+	REQUIRE(buffer.size() == skin->get_bind_count() * 12);
+
+	for (int i = 0; i < skin->get_bind_count(); i++) {
+		const Transform3D expected = p_skeleton->get_bone_global_pose(skin->get_bind_bone(i)) * skin->get_bind_pose(i);
+		const float *dataptr = buffer.ptr() + i * 12;
+		Transform3D uploaded;
+		for (int j = 0; j < 3; j++) {
+			uploaded.basis.elements[j] = Vector3(dataptr[j * 4 + 0], dataptr[j * 4 + 1], dataptr[j * 4 + 2]);
+			uploaded.origin[j] = dataptr[j * 4 + 3];
+		}
+		CHECK_MESSAGE(uploaded.is_equal_approx(expected), vformat("Bind %d should hold its global pose times its bind pose.", i));
+	}
+}
+
+static bool binds_equal(const Vector<float> &p_a, const Vector<float> &p_b, int p_from, int p_to) {
+	for (int i = p_from * 12; i < p_to * 12; i++) {
+		if (p_a[i] != p_b[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+TEST_CASE("[Skeleton3D] Skin bind transforms are uploaded as one buffer") {
+	// Skins need a rendering server to create their skeleton on.
+	TestSceneTree::HeadlessSceneTree headless;
+	Skeleton3D *skeleton = create_chain(4);
+
+	Ref<Skin> skin;
+	skin.instantiate();
+	skin->set_bind_count(4);
+	for (int i = 0; i < 4; i++) {
+		// Binds in reverse order, so the bind and bone indices differ.
+		skin->set_bind_bone(i, 3 - i);
+		skin->set_bind_pose(i, Transform3D(Basis(Vector3(1, 0, 0), i * 0.3), Vector3(0, -1.0 - i, 0.5)));
+	}
+
+	Ref<SkinReference> skin_ref = skeleton->register_skin(skin);
+	skeleton->notification(Skeleton3D::NOTIFICATION_UPDATE_SKELETON);
+	check_bone_buffer(skeleton, skin_ref);
+
+	// Only bone 2 and its child move; the binds of bones 0 and 1 must keep their data.
+	const Vector<float> before = skin_ref->get_bone_buffer();
+	skeleton->set_bone_pose(2, Transform3D(Basis(Vector3(0, 1, 0), 0.7), Vector3(2, 0, 0)));
+	skeleton->notification(Skeleton3D::NOTIFICATION_UPDATE_SKELETON);
+	check_bone_buffer(skeleton, skin_ref);
+
+	const Vector<float> after = skin_ref->get_bone_buffer();
+	CHECK(binds_equal(after, before, 2, 4));
+	CHECK_FALSE(binds_equal(after, before, 0, 2));
+
+	// A changed bind pose is picked up without any bone moving.
+	skin->set_bind_pose(3, Transform3D(Basis(), Vector3(0, 0, -3)));
+	skeleton->notification(Skeleton3D::NOTIFICATION_UPDATE_SKELETON);
+	check_bone_buffer(skeleton, skin_ref);
+
+	skin_ref.unref();
+	memdelete(skeleton);
+}
+
+TEST_CASE_BENCHMARK("[Skeleton3D][Benchmark] Pose update of 200 skeletons with 100 bones") {
+	const int skeleton_count = 200;
+	const int bone_count = 100;
+	const int frames = 60;
+
+	Vector<Skeleton3D *> skeletons;
+	for (int i = 0; i < skeleton_count; i++) {
+		skeletons.push_back(create_chain(bone_count));
+	}
+
+	Vector<float> buffer = skeletons[0]->get_bone_pose_buffer();
+
+	uint64_t per_bone_usec = 0;
+	uint64_t buffer_usec = 0;
+
+	for (int f = 0; f < frames; f++) {
+		const Transform3D pose = Transform3D(Basis(Vector3(0, 1, 0), f * 0.01), Vector3());
+
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < skeleton_count; i++) {
+			for (int j = 0; j < bone_count; j++) {
+				skeletons[i]->set_bone_pose(j, pose);
+			}
+			skeletons[i]->notification(Skeleton3D::NOTIFICATION_UPDATE_SKELETON);
+		}
+		per_bone_usec += OS::get_singleton()->get_ticks_usec() - begin;
+
+		const Transform3D buffer_pose = Transform3D(Basis(Vector3(0, 0, 1), f * 0.01), Vector3());
+		float *w = buffer.ptrw();
+		for (int j = 0; j < bone_count; j++) {
+			float *dataptr = w + j * 12;
+			for (int k = 0; k < 3; k++) {
+				dataptr[k * 4 + 0] = buffer_pose.basis.elements[k][0];
+				dataptr[k * 4 + 1] = buffer_pose.basis.elements[k][1];
+				dataptr[k * 4 + 2] = buffer_pose.basis.elements[k][2];
+				dataptr[k * 4 + 3] = buffer_pose.origin[k];
+			}
+		}
+
+		begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < skeleton_count; i++) {
+			skeletons[i]->set_bone_pose_buffer(buffer);
+			skeletons[i]->notification(Skeleton3D::NOTIFICATION_UPDATE_SKELETON);
+		}
+		buffer_usec += OS::get_singleton()->get_ticks_usec() - begin;
+	}
+
+	MESSAGE("set_bone_pose(): " << (per_bone_usec / frames) << " usec/frame");
+	MESSAGE("set_bone_pose_buffer(): " << (buffer_usec / frames) << " usec/frame");
+
+	for (int i = 0; i < skeleton_count; i++) {
+		memdelete(skeletons[i]);
+	}
+}
+
+} // namespace TestSkeleton3D
+
+#endif // TEST_SKELETON_3D_H
@@ -39,6 +39,7 @@
 #include "core/os/main_loop.h"
 #include "core/os/os.h"
 #include "core/string/ustring.h"
+#include "core/variant/dictionary.h"
 
 #include "tests/test_macros.h"
 
@@ -1346,6 +1347,213 @@ TEST_CASE("[String] validate_node_name") {
 	String name_with_invalid_chars = "Name with invalid characters :.@removed!";
 	CHECK(name_with_invalid_chars.validate_node_name() == "Name with invalid characters removed!");
 }
+
+TEST_CASE("[String] Cached hash follows changes") {
+	String s = "hello";
+	String copy = s;
+	uint32_t hash = s.hash();
+	CHECK(copy.hash() == hash);
+	CHECK(s == copy);
+
+	s[0] = 'j';
+	CHECK(s.hash() == String("jello").hash());
+	CHECK(copy.hash() == hash);
+	CHECK(s != copy);
+
+	s += "!";
+	CHECK(s.hash() == String("jello!").hash());
+
+	s.ptrw()[1] = 'a';
+	CHECK(s.hash() == String("jallo!").hash());
+
+	// Strings with different cached hashes are different, the same hash doesn't make them equal.
+	String other = "jello";
+	other.hash();
+	CHECK(other != s);
+	CHECK(other == String("jello"));
+}
+
+TEST_CASE("[String] Search and conversion across block boundaries") {
+	// The bulk routines work on blocks, every position and length must give the same results.
+	for (int len = 1; len <= 40; len++) {
+		String s;
+		for (int i = 0; i < len; i++) {
+			s += "a";
+		}
+		for (int i = 0; i < len; i++) {
+			String t = s;
+			t[i] = 'b';
+			CHECK(t.find("b") == i);
+			CHECK(t.find(String("b")) == i);
+			CHECK(t.find_char('b') == i);
+			CHECK(t.findn("B") == i);
+			CHECK(t.find("b", i + 1) == -1);
+			if (i + 1 < len) {
+				t[i + 1] = 'c';
+				CHECK(t.find("bc") == i);
+				CHECK(t.find(String("bc")) == i);
+				CHECK(t.findn("BC") == i);
+			}
+
+			t[i] = U'é';
+			CharString utf8 = t.utf8();
+			CHECK(utf8.length() == len + 1);
+			String parsed;
+			CHECK(!parsed.parse_utf8(utf8.get_data()));
+			CHECK(parsed == t);
+			CHECK(String::utf8(utf8.get_data(), utf8.length()) == t);
+		}
+	}
+
+	String s = "abc";
+	CHECK(s.find("") == 0);
+	CHECK(s.find_char(0) == 3);
+	CHECK(s.find_char('a', -1) == -1);
+}
+
+TEST_CASE("[String] Case conversion") {
+	String s = U"Ünïcödé Text With ASCII";
+	CHECK(s.to_lower() == U"ünïcödé text with ascii");
+	CHECK(s.to_upper() == U"ÜNÏCÖDÉ TEXT WITH ASCII");
+
+	// Unchanged strings are returned as they are.
+	String lower = "already lower case";
+	String same = lower.to_lower();
+	CHECK(same == lower);
+	CHECK(same.ptr() == lower.ptr());
+	CHECK(String().to_upper().is_empty());
+}
+
+TEST_CASE_BENCHMARK("[String][Benchmark] Search and conversion throughput") {
+	// About 1 MB of mostly ASCII text, with a few multibyte characters.
+	String text;
+	{
+		String line = "entity_name,position_x,position_y,rotation,description\n";
+		String accented = U"Ville de Montréal,12.5,-3.25,90,Übersicht\n";
+		String parts;
+		for (int i = 0; i < 64; i++) {
+			parts += (i % 8 == 7) ? accented : line;
+		}
+		while (text.length() < 256 * 1024) {
+			text += parts;
+		}
+	}
+	text += "needle";
+	const double mb = text.length() * sizeof(char32_t) / (1024.0 * 1024.0);
+	const int iterations = 20;
+
+	int found = 0;
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < iterations; i++) {
+		found += text.find("needle");
+	}
+	uint64_t find_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < iterations; i++) {
+		found += text.findn("NEEDLE");
+	}
+	uint64_t findn_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < iterations; i++) {
+		found += text.replace("rotation", "angle").length();
+	}
+	uint64_t replace_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < iterations; i++) {
+		found += text.split("\n").size();
+	}
+	uint64_t split_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < iterations; i++) {
+		found += text.to_lower().length();
+	}
+	uint64_t lower_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	CharString utf8;
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < iterations; i++) {
+		utf8 = text.utf8();
+	}
+	uint64_t utf8_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	String parsed;
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < iterations; i++) {
+		parsed.parse_utf8(utf8.get_data(), utf8.length());
+	}
+	uint64_t parse_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	CHECK(parsed == text);
+	CHECK(found != 0);
+
+	MESSAGE("find(): " << (mb * iterations * 1000000.0 / MAX(find_usec, (uint64_t)1)) << " MB/s");
+	MESSAGE("findn(): " << (mb * iterations * 1000000.0 / MAX(findn_usec, (uint64_t)1)) << " MB/s");
+	MESSAGE("replace(): " << (mb * iterations * 1000000.0 / MAX(replace_usec, (uint64_t)1)) << " MB/s");
+	MESSAGE("split(): " << (mb * iterations * 1000000.0 / MAX(split_usec, (uint64_t)1)) << " MB/s");
+	MESSAGE("to_lower(): " << (mb * iterations * 1000000.0 / MAX(lower_usec, (uint64_t)1)) << " MB/s");
+	MESSAGE("utf8(): " << (mb * iterations * 1000000.0 / MAX(utf8_usec, (uint64_t)1)) << " MB/s");
+	MESSAGE("parse_utf8(): " << (mb * iterations * 1000000.0 / MAX(parse_usec, (uint64_t)1)) << " MB/s");
+}
+
+TEST_CASE_BENCHMARK("[String][Benchmark] Short strings") {
+	const int count = 200000;
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < count; i++) {
+		String name = "Node" + itos(i % 1000);
+		name += "_";
+		name += "Body";
+	}
+	uint64_t concat_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < count / 10; i++) {
+		String formatted = vformat("%s_%d (%.2f)", "Enemy", i, i * 0.5);
+	}
+	uint64_t format_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	String path = "root/level/enemies/group/enemy/body/collision/shape";
+	begin = OS::get_singleton()->get_ticks_usec();
+	int parts = 0;
+	for (int i = 0; i < count / 10; i++) {
+		parts += path.split("/").size();
+	}
+	uint64_t split_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	Vector<String> keys;
+	for (int i = 0; i < 1000; i++) {
+		keys.push_back("property_name_" + itos(i));
+	}
+	begin = OS::get_singleton()->get_ticks_usec();
+	uint32_t hashes = 0;
+	for (int i = 0; i < count * 5; i++) {
+		hashes += keys[i % 1000].hash();
+	}
+	uint64_t hash_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	Dictionary dictionary;
+	for (int i = 0; i < 1000; i++) {
+		dictionary[keys[i]] = i;
+	}
+	begin = OS::get_singleton()->get_ticks_usec();
+	int64_t sum = 0;
+	for (int i = 0; i < count * 5; i++) {
+		sum += int64_t(dictionary[keys[i % 1000]]);
+	}
+	uint64_t dictionary_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	CHECK(parts == count / 10 * 8);
+	CHECK(sum == int64_t(count) * 5 / 1000 * 999 * 1000 / 2);
+
+	MESSAGE(count << " concatenations: " << (concat_usec / 1000.0) << " ms");
+	MESSAGE((count / 10) << " vformat() calls: " << (format_usec / 1000.0) << " ms");
+	MESSAGE((count / 10) << " split() calls: " << (split_usec / 1000.0) << " ms");
+	MESSAGE((count * 5) << " hash() calls: " << (hash_usec / 1000.0) << " ms (" << hashes << ")");
+	MESSAGE((count * 5) << " Dictionary lookups by String key: " << (dictionary_usec / 1000.0) << " ms");
+}
 } // namespace TestString
 
 #endif // TEST_STRING_H
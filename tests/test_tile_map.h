@@ -0,0 +1,330 @@
+/*************************************************************************/
+/*  test_tile_map.h                                                      */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_TILE_MAP_H
+#define TEST_TILE_MAP_H
+
+#include "core/os/memory.h"
+#include "core/os/os.h"
+#include "scene/2d/tile_map.h"
+#include "scene/resources/texture.h"
+
+#include "tests/test_macros.h"
+#include "tests/test_scene_tree.h"
+
+namespace TestTileMap {
+
+TEST_CASE("[TileMap] Set and get cells") {
+	TestSceneTree::HeadlessSceneTree headless;
+	TileMap *tile_map = memnew(TileMap);
+
+	// Cover both sides of the chunk boundaries, including negative coords.
+	const Vector2i coords[] = { Vector2i(0, 0), Vector2i(31, 31), Vector2i(32, 0), Vector2i(-1, -1), Vector2i(-32, -33), Vector2i(1000, -1000) };
+	for (int i = 0; i < 6; i++) {
+		tile_map->set_cell(coords[i], 1, Vector2i(i, 2), 3);
+	}
+	for (int i = 0; i < 6; i++) {
+		CHECK(tile_map->get_cell_source_id(coords[i]) == 1);
+		CHECK(tile_map->get_cell_atlas_coords(coords[i]) == Vector2i(i, 2));
+		CHECK(tile_map->get_cell_alternative_tile(coords[i]) == 3);
+	}
+	CHECK(tile_map->get_cell_source_id(Vector2i(1, 0)) == -1);
+	CHECK(tile_map->get_cell_atlas_coords(Vector2i(-2, -1)) == TileSetSource::INVALID_ATLAS_COORDS);
+	CHECK(tile_map->get_used_cells().size() == 6);
+	CHECK(tile_map->get_used_rect() == Rect2(-32, -1000, 1033, 1032));
+
+	tile_map->set_cell(Vector2i(1000, -1000));
+	tile_map->set_cell(Vector2i(-32, -33));
+	CHECK(tile_map->get_cell_source_id(Vector2i(1000, -1000)) == -1);
+	CHECK(tile_map->get_used_cells().size() == 4);
+	CHECK(tile_map->get_used_rect() == Rect2(-1, -1, 34, 33));
+
+	tile_map->clear();
+	CHECK(tile_map->get_used_cells().size() == 0);
+	CHECK(tile_map->get_cell_source_id(Vector2i(0, 0)) == -1);
+
+	memdelete(tile_map);
+}
+
+TEST_CASE("[TileMap] Bulk cell operations") {
+	TestSceneTree::HeadlessSceneTree headless;
+	TileMap *tile_map = memnew(TileMap);
+
+	tile_map->fill_rect(Rect2i(-40, -5, 80, 10), 2, Vector2i(1, 1), 0);
+	CHECK(tile_map->get_used_cells().size() == 800);
+	CHECK(tile_map->get_used_rect() == Rect2(-40, -5, 80, 10));
+
+	// Erase the middle part.
+	tile_map->fill_rect(Rect2i(-30, -5, 60, 10));
+	CHECK(tile_map->get_used_cells().size() == 200);
+	CHECK(tile_map->get_cell_source_id(Vector2i(-31, 0)) == 2);
+	CHECK(tile_map->get_cell_source_id(Vector2i(-30, 0)) == -1);
+	CHECK(tile_map->get_cell_source_id(Vector2i(30, 4)) == 2);
+
+	PackedInt32Array block = tile_map->get_cell_block(Rect2i(-32, -1, 4, 2));
+	REQUIRE(block.size() == 32);
+	CHECK(block[0] == 2);
+	CHECK(block[1] == 1);
+	CHECK(block[2] == 1);
+	CHECK(block[3] == 0);
+	CHECK(block[8] == -1);
+	CHECK(block[9] == -1);
+
+	// Copy the block somewhere else and read it back.
+	tile_map->set_cell_block(Rect2i(100, 100, 4, 2), block);
+	CHECK(tile_map->get_cell_block(Rect2i(100, 100, 4, 2)) == block);
+	CHECK(tile_map->get_used_cells().size() == 204);
+
+	ERR_PRINT_OFF;
+	tile_map->set_cell_block(Rect2i(0, 0, 2, 2), block);
+	ERR_PRINT_ON;
+	CHECK(tile_map->get_cell_source_id(Vector2i(0, 0)) == -1);
+
+	memdelete(tile_map);
+}
+
+TEST_CASE("[TileMap] Quadrants follow the cells inside the tree") {
+	TestSceneTree::HeadlessSceneTree headless;
+	TileMap *tile_map = memnew(TileMap);
+	Ref<TileSet> tile_set;
+	tile_set.instantiate();
+	tile_map->set_tileset(tile_set);
+
+	// Cells set before entering the tree get their quadrants when it enters.
+	tile_map->fill_rect(Rect2i(-16, 0, 32, 16), 0, Vector2i(0, 0), 0);
+	CHECK(tile_map->get_quadrant_map().size() == 0);
+
+	headless.tree->get_root()->add_child(tile_map);
+	tile_map->update_dirty_quadrants();
+	REQUIRE(tile_map->get_quadrant_map().size() == 2);
+	TileMapQuadrant *q = tile_map->get_quadrant_map().getptr(Vector2i(-1, 0));
+	REQUIRE(q);
+	CHECK(q->cells.size() == 256);
+	// Cells are sorted by world coords for rendering: top to bottom, then right to left.
+	CHECK(q->cells[0] == Vector2i(-1, 0));
+	CHECK(q->cells[1] == Vector2i(-2, 0));
+	CHECK(q->cells[255] == Vector2i(-16, 15));
+
+	tile_map->set_cell(Vector2i(40, 40), 0, Vector2i(0, 0), 0);
+	tile_map->fill_rect(Rect2i(0, 0, 16, 16));
+	tile_map->update_dirty_quadrants();
+	CHECK(tile_map->get_quadrant_map().size() == 2);
+	CHECK(tile_map->get_quadrant_map().has(Vector2i(2, 2)));
+	CHECK(!tile_map->get_quadrant_map().has(Vector2i(0, 0)));
+
+	headless.tree->get_root()->remove_child(tile_map);
+	CHECK(tile_map->get_quadrant_map().size() == 0);
+	memdelete(tile_map);
+}
+
+static int count_dirty_quadrants(TileMap *p_tile_map) {
+	HashMap<Vector2i, TileMapQuadrant, TileMapQuadrant::CoordsHasher> &quadrant_map = p_tile_map->get_quadrant_map();
+	int count = 0;
+	for (const Vector2i *E = quadrant_map.next(nullptr); E; E = quadrant_map.next(E)) {
+		count += quadrant_map[*E].dirty_list_element.in_list();
+	}
+	return count;
+}
+
+static Ref<TileSet> create_tile_set() {
+	Ref<Image> image;
+	image.instantiate();
+	image->create(64, 64, false, Image::FORMAT_RGBA8);
+	Ref<ImageTexture> texture;
+	texture.instantiate();
+	texture->create_from_image(image);
+
+	Ref<TileSetAtlasSource> atlas_source;
+	atlas_source.instantiate();
+	atlas_source->set_texture(texture);
+	atlas_source->create_tile(Vector2i(0, 0));
+	atlas_source->create_tile(Vector2i(1, 0));
+
+	Ref<TileSet> tile_set;
+	tile_set.instantiate();
+	tile_set->add_source(atlas_source, 0);
+	return tile_set;
+}
+
+TEST_CASE("[TileMap] Quadrant updates follow the time budget") {
+	TestSceneTree::HeadlessSceneTree headless;
+	TileMap *tile_map = memnew(TileMap);
+	tile_map->set_tileset(create_tile_set());
+	headless.tree->get_root()->add_child(tile_map);
+
+	// 16 quadrants of 16x16 cells.
+	tile_map->fill_rect(Rect2i(0, 0, 64, 64), 0, Vector2i(0, 0), 0);
+	CHECK(tile_map->get_quadrant_map().size() == 16);
+	CHECK(count_dirty_quadrants(tile_map) == 16);
+
+	// A budget this small lets a single batch through per update.
+	tile_map->set_update_time_budget(0.001);
+	tile_map->update_dirty_quadrants();
+	int dirty = count_dirty_quadrants(tile_map);
+	CHECK(dirty > 0);
+	CHECK(dirty < 16);
+	CHECK(tile_map->is_processing_internal());
+
+	for (int i = 0; i < 16 && count_dirty_quadrants(tile_map) > 0; i++) {
+		tile_map->update_dirty_quadrants();
+	}
+	CHECK(count_dirty_quadrants(tile_map) == 0);
+	CHECK(!tile_map->is_processing_internal());
+	CHECK(tile_map->get_quadrant_map()[Vector2i(3, 3)].cells.size() == 256);
+
+	// Without a budget, everything is updated at once.
+	tile_map->set_update_time_budget(0.0);
+	tile_map->fill_rect(Rect2i(0, 0, 64, 64), 0, Vector2i(1, 0), 0);
+	tile_map->update_dirty_quadrants();
+	CHECK(count_dirty_quadrants(tile_map) == 0);
+	CHECK(!tile_map->is_processing_internal());
+
+	ERR_PRINT_OFF;
+	tile_map->set_update_time_budget(-1.0);
+	ERR_PRINT_ON;
+	CHECK(tile_map->get_update_time_budget() == 0.0);
+}
+
+TEST_CASE("[TileMap] Quadrants are prepared in parallel and drawn by group") {
+	TestSceneTree::HeadlessSceneTree headless;
+	Ref<TileSet> tile_set = create_tile_set();
+	Ref<TileSetAtlasSource> atlas_source = tile_set->get_source(0);
+	TileData *tile_data = Object::cast_to<TileData>(atlas_source->get_tile_data(Vector2i(1, 0), 0));
+	REQUIRE(tile_data);
+	tile_data->set_z_index(1);
+
+	TileMap *tile_map = memnew(TileMap);
+	tile_map->set_tileset(tile_set);
+	headless.tree->get_root()->add_child(tile_map);
+
+	// 16 quadrants, the first one has a row of tiles drawn with another z_index.
+	tile_map->fill_rect(Rect2i(0, 0, 64, 64), 0, Vector2i(0, 0), 0);
+	tile_map->fill_rect(Rect2i(0, 0, 16, 1), 0, Vector2i(1, 0), 0);
+	tile_map->update_dirty_quadrants();
+	CHECK(count_dirty_quadrants(tile_map) == 0);
+
+	HashMap<Vector2i, TileMapQuadrant, TileMapQuadrant::CoordsHasher> &quadrant_map = tile_map->get_quadrant_map();
+	CHECK(quadrant_map[Vector2i(0, 0)].canvas_items.size() == 2);
+	for (const Vector2i *E = quadrant_map.next(nullptr); E; E = quadrant_map.next(E)) {
+		TileMapQuadrant &q = quadrant_map[*E];
+		CHECK(q.cells.size() == 256);
+		if (*E != Vector2i(0, 0)) {
+			CHECK(q.canvas_items.size() == 1);
+		}
+		// What was built for the servers is released once it has been sent.
+		CHECK(q.rendering_groups.is_empty());
+		CHECK(q.physics_shapes.is_empty());
+		CHECK(q.navigation_cells.is_empty());
+	}
+
+	memdelete(tile_map);
+}
+
+TEST_CASE_BENCHMARK("[TileMap][Benchmark] Fill and read a 2000x2000 map") {
+	TestSceneTree::HeadlessSceneTree headless;
+	TileMap *tile_map = memnew(TileMap);
+
+	const int size = 2000;
+	uint64_t mem_before = Memory::get_mem_usage();
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int y = 0; y < size; y++) {
+		for (int x = 0; x < size; x++) {
+			tile_map->set_cell(Vector2i(x, y), 0, Vector2i(x & 7, y & 7), 0);
+		}
+	}
+	uint64_t set_usec = OS::get_singleton()->get_ticks_usec() - begin;
+	uint64_t mem_used = Memory::get_mem_usage() - mem_before;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	int64_t sum = 0;
+	for (int y = 0; y < size; y++) {
+		for (int x = 0; x < size; x++) {
+			sum += tile_map->get_cell_atlas_coords(Vector2i(x, y)).x;
+		}
+	}
+	uint64_t get_usec = OS::get_singleton()->get_ticks_usec() - begin;
+	CHECK(sum == int64_t(size) * size / 8 * 28);
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	tile_map->fill_rect(Rect2i(0, 0, size, size));
+	tile_map->fill_rect(Rect2i(0, 0, size, size), 0, Vector2i(1, 1), 0);
+	uint64_t fill_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	PackedInt32Array block = tile_map->get_cell_block(Rect2i(0, 0, size, size));
+	tile_map->set_cell_block(Rect2i(0, 0, size, size), block);
+	uint64_t block_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	MESSAGE("set_cell: ", set_usec / 1000, " ms, get_cell_atlas_coords: ", get_usec / 1000, " ms");
+	MESSAGE("fill_rect (erase and fill): ", fill_usec / 1000, " ms, cell block round trip: ", block_usec / 1000, " ms");
+	MESSAGE("Cell storage: ", (mem_used / size / size), " bytes per cell");
+
+	memdelete(tile_map);
+}
+
+TEST_CASE_BENCHMARK("[TileMap][Benchmark] Stream a large map in chunks") {
+	TestSceneTree::HeadlessSceneTree headless;
+	Ref<TileSet> tile_set = create_tile_set();
+
+	// Streams 64 chunks of 128x128 cells, one per frame, like a game loading
+	// the map around the player, then lets the updates finish.
+	const int chunk_size = 128;
+	const int chunk_count = 64;
+	const float budgets[] = { 0.0, 4.0 };
+	for (int b = 0; b < 2; b++) {
+		TileMap *tile_map = memnew(TileMap);
+		tile_map->set_tileset(tile_set);
+		tile_map->set_update_time_budget(budgets[b]);
+		headless.tree->get_root()->add_child(tile_map);
+
+		uint64_t total_usec = 0;
+		uint64_t worst_frame_usec = 0;
+		int frames = 0;
+		while (frames < chunk_count || count_dirty_quadrants(tile_map) > 0) {
+			uint64_t begin = OS::get_singleton()->get_ticks_usec();
+			if (frames < chunk_count) {
+				Vector2i chunk_coords(frames % 8, frames / 8);
+				tile_map->fill_rect(Rect2i(chunk_coords * chunk_size, Vector2i(chunk_size, chunk_size)), 0, Vector2i(frames & 1, 0), 0);
+			}
+			tile_map->update_dirty_quadrants();
+			uint64_t frame_usec = OS::get_singleton()->get_ticks_usec() - begin;
+			total_usec += frame_usec;
+			worst_frame_usec = MAX(worst_frame_usec, frame_usec);
+			frames++;
+		}
+
+		MESSAGE("Update time budget ", budgets[b], " ms: ", frames, " frames, ", (total_usec / 1000), " ms total, worst frame ", (worst_frame_usec / 1000), " ms");
+		memdelete(tile_map);
+	}
+}
+
+} // namespace TestTileMap
+
+#endif // TEST_TILE_MAP_H
@@ -261,6 +261,21 @@ extern stb_vorbis * stb_vorbis_open_memory(const unsigned char *data, int len,
 // create an ogg vorbis decoder from an ogg vorbis stream in memory (note
 // this must be the entire stream!). on failure, returns NULL and sets *error
 
+// Godot: callbacks to read the stream from any source, e.g. a file in a pack.
+typedef struct
+{
+   int (*read)(void *user, unsigned char *data, int size); // returns the bytes read
+   int (*seek)(void *user, unsigned int offset); // from the stream start, returns 0 on failure
+   unsigned int (*tell)(void *user);
+   void *user;
+} stb_vorbis_io;
+
+extern stb_vorbis * stb_vorbis_open_io(const stb_vorbis_io *io, unsigned int len,
+                                  int *error, const stb_vorbis_alloc *alloc_buffer);
+// create an ogg vorbis decoder reading a stream of length 'len' bytes through
+// the 'io' callbacks, seeking to offset 0 first. on failure, returns NULL and
+// sets *error. the callbacks are only called from the stb_vorbis_* functions.
+
 #ifndef STB_VORBIS_NO_STDIO
 extern stb_vorbis * stb_vorbis_open_filename(const char *filename,
                                   int *error, const stb_vorbis_alloc *alloc_buffer);
@@ -788,6 +803,9 @@ struct stb_vorbis
    int close_on_free;
 #endif
 
+   stb_vorbis_io io;
+   int use_io;
+
    uint8 *stream;
    uint8 *stream_start;
    uint8 *stream_end;
@@ -1326,6 +1344,12 @@ static uint8 get8(vorb *z)
       return *z->stream++;
    }
 
+   if (z->use_io) {
+      uint8 c;
+      if (z->io.read(z->io.user, &c, 1) != 1) { z->eof = TRUE; return 0; }
+      return c;
+   }
+
    #ifndef STB_VORBIS_NO_STDIO
    {
    int c = fgetc(z->f);
@@ -1354,6 +1378,13 @@ static int getn(vorb *z, uint8 *data, int n)
       return 1;
    }
 
+   if (z->use_io) {
+      if (z->io.read(z->io.user, data, n) == n)
+         return 1;
+      z->eof = 1;
+      return 0;
+   }
+
    #ifndef STB_VORBIS_NO_STDIO
    if (fread(data, n, 1, z->f) == 1)
       return 1;
@@ -1371,6 +1402,10 @@ static void skip(vorb *z, int n)
       if (z->stream >= z->stream_end) z->eof = 1;
       return;
    }
+   if (z->use_io) {
+      z->io.seek(z->io.user, z->io.tell(z->io.user) + n);
+      return;
+   }
    #ifndef STB_VORBIS_NO_STDIO
    {
       long x = ftell(z->f);
@@ -1395,6 +1430,12 @@ static int set_file_offset(stb_vorbis *f, unsigned int loc)
          return 1;
       }
    }
+   if (f->use_io) {
+      if (loc < f->stream_len && f->io.seek(f->io.user, loc))
+         return 1;
+      f->eof = 1;
+      return 0;
+   }
    #ifndef STB_VORBIS_NO_STDIO
    if (loc + f->f_start < loc || loc >= 0x80000000) {
       loc = 0x7fffffff;
@@ -4528,6 +4569,7 @@ unsigned int stb_vorbis_get_file_offset(stb_vorbis *f)
    if (f->push_mode) return 0;
    #endif
    if (USE_MEMORY(f)) return (unsigned int) (f->stream - f->stream_start);
+   if (f->use_io) return f->io.tell(f->io.user);
    #ifndef STB_VORBIS_NO_STDIO
    return (unsigned int) (ftell(f->f) - f->f_start);
    #endif
@@ -5027,6 +5069,30 @@ int stb_vorbis_get_frame_float(stb_vorbis *f, int *channels, float ***output)
    return len;
 }
 
+stb_vorbis * stb_vorbis_open_io(const stb_vorbis_io *io, unsigned int length, int *error, const stb_vorbis_alloc *alloc)
+{
+   stb_vorbis *f, p;
+   vorbis_init(&p, alloc);
+   p.io = *io;
+   p.use_io = TRUE;
+   p.stream_len = length;
+   if (!p.io.seek(p.io.user, 0)) {
+      if (error) *error = VORBIS_file_open_failure;
+      return NULL;
+   }
+   if (start_decoder(&p)) {
+      f = vorbis_alloc(&p);
+      if (f) {
+         *f = p;
+         vorbis_pump_first_frame(f);
+         return f;
+      }
+   }
+   if (error) *error = p.error;
+   vorbis_deinit(&p);
+   return NULL;
+}
+
 #ifndef STB_VORBIS_NO_STDIO
 
 stb_vorbis * stb_vorbis_open_file_section(FILE *file, int close_on_free, int *error, const stb_vorbis_alloc *alloc, unsigned int length)